@@ -0,0 +1,93 @@
+#pragma once
+
+/**
+ * CancellationToken — 请求截止时间 + 协作式取消
+ *
+ * 长查询（向量检索、K-hop 扩展、GraphRAG）在分块或每跳的边界调用
+ * cancelled() 检查，返回 true 后停止继续计算，带着已有的部分结果返回；
+ * 调用方再用 cancelled() 判断结果是否完整。
+ *
+ * 设计要点：
+ *   1. 默认构造的 token 不限时也不会被取消，cancelled() 只判一次空指针，
+ *      不传 token 的调用路径没有额外开销
+ *   2. 拷贝共享同一份状态：交给线程池各个任务的拷贝都能看到 cancel()
+ *   3. 过期一次后置位取消标志，之后的检查不再读时钟
+ *
+ * 典型用法：
+ *   using namespace std::chrono_literals;
+ *   auto token = CancellationToken::with_timeout(50ms);
+ *   auto keys = kv->vectorSearch(query, 10, token);
+ *   if (token.cancelled()) { ... 部分结果 ... }
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+namespace minkv {
+namespace base {
+
+class CancellationToken {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /** 不限时、不可取消 */
+  CancellationToken() = default;
+
+  /** 到 deadline 时刻自动取消 */
+  static CancellationToken with_deadline(Clock::time_point deadline) {
+    CancellationToken token;
+    token.state_ = std::make_shared<State>();
+    token.state_->deadline = deadline;
+    return token;
+  }
+
+  static CancellationToken with_timeout(Clock::duration timeout) {
+    return with_deadline(Clock::now() + timeout);
+  }
+
+  /** 可以手动取消、不限时的 token */
+  static CancellationToken manual() {
+    return with_deadline(Clock::time_point::max());
+  }
+
+  /** 立即取消；对默认构造的 token 无效 */
+  void cancel() const {
+    if (state_)
+      state_->cancelled.store(true, std::memory_order_relaxed);
+  }
+
+  /** 已被取消或已过截止时间 */
+  bool cancelled() const {
+    if (!state_)
+      return false;
+    if (state_->cancelled.load(std::memory_order_relaxed))
+      return true;
+    if (state_->deadline == Clock::time_point::max() ||
+        Clock::now() < state_->deadline)
+      return false;
+    state_->cancelled.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+  /** 是否设置了截止时间 */
+  bool has_deadline() const {
+    return state_ && state_->deadline != Clock::time_point::max();
+  }
+
+  /** 截止时间；没有时为 time_point::max() */
+  Clock::time_point deadline() const {
+    return state_ ? state_->deadline : Clock::time_point::max();
+  }
+
+private:
+  struct State {
+    Clock::time_point deadline = Clock::time_point::max();
+    std::atomic<bool> cancelled{false};
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+} // namespace base
+} // namespace minkv
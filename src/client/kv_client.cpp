@@ -0,0 +1,379 @@
+#include "kv_client.h"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace minkv {
+namespace client {
+
+namespace {
+
+std::unique_ptr<RespConnection> Connect(const KvClientOptions &options) {
+  return std::make_unique<RespConnection>(options.host, options.port,
+                                          options.unix_path,
+                                          options.timeout_ms);
+}
+
+void AppendBulk(std::string &out, const std::string &arg) {
+  out += '$';
+  out += std::to_string(arg.size());
+  out += "\r\n";
+  out += arg;
+  out += "\r\n";
+}
+
+bool IsCommand(const std::string &arg, const char *name) {
+  size_t i = 0;
+  for (; i < arg.size() && name[i] != '\0'; ++i)
+    if (std::toupper(static_cast<unsigned char>(arg[i])) != name[i])
+      return false;
+  return i == arg.size() && name[i] == '\0';
+}
+
+// 不修改数据的命令，发出时不用使近端缓存失效
+bool IsReadOnly(const std::string &cmd) {
+  static const char *const kReadOnly[] = {
+      "GET",  "MGET", "EXISTS", "TTL",     "PTTL",   "VGET",
+      "PING", "ECHO", "DBSIZE", "VSEARCH", "COMMAND"};
+  for (const char *name : kReadOnly)
+    if (IsCommand(cmd, name))
+      return true;
+  return false;
+}
+
+std::exception_ptr ReplyError(const RespReply &reply) {
+  return std::make_exception_ptr(std::runtime_error(reply.str));
+}
+
+} // namespace
+
+KvClient::KvClient(const KvClientOptions &options) : options_(options) {
+  if (options_.connections == 0 || options_.max_pipeline == 0)
+    throw std::invalid_argument(
+        "KvClient: connections and max_pipeline must be positive");
+  if (options_.near_cache_capacity > 0)
+    near_cache_ = std::make_unique<db::LruCache<std::string, std::string>>(
+        options_.near_cache_capacity);
+
+  // 先建好全部连接再启动 I/O 线程，连接失败时构造函数直接抛出
+  for (size_t i = 0; i < options_.connections; ++i) {
+    conns_.push_back(std::make_unique<Connection>());
+    conns_.back()->sock = Connect(options_);
+  }
+  for (auto &conn : conns_) {
+    Connection *c = conn.get();
+    c->io = std::thread([this, c] { IoLoop(*c); });
+  }
+}
+
+KvClient::~KvClient() {
+  stopping_ = true;
+  for (auto &conn : conns_) {
+    { std::lock_guard<std::mutex> lock(conn->mu); }
+    conn->cv.notify_all();
+  }
+  for (auto &conn : conns_)
+    if (conn->io.joinable())
+      conn->io.join();
+}
+
+// ==========================================
+// 请求分发与 pipeline
+// ==========================================
+
+void KvClient::Submit(const std::string &route_key, Request req) {
+  size_t n = conns_.size();
+  size_t idx = route_key.empty()
+                   ? next_conn_.fetch_add(1, std::memory_order_relaxed) % n
+                   : std::hash<std::string>{}(route_key) % n;
+  Connection &conn = *conns_[idx];
+  {
+    std::lock_guard<std::mutex> lock(conn.mu);
+    conn.queue.push_back(std::move(req));
+  }
+  conn.cv.notify_one();
+}
+
+void KvClient::IoLoop(Connection &conn) {
+  std::vector<Request> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(conn.mu);
+      conn.cv.wait(lock, [&] { return !conn.queue.empty() || stopping_; });
+      if (conn.queue.empty())
+        return; // 停止，且已入队的请求都处理完了
+      // 上一轮往返期间积攒的请求一次取走（自动 pipeline）
+      size_t n = std::min(conn.queue.size(), options_.max_pipeline);
+      batch.clear();
+      for (size_t i = 0; i < n; ++i) {
+        batch.push_back(std::move(conn.queue.front()));
+        conn.queue.pop_front();
+      }
+    }
+    RoundTrip(conn, batch);
+  }
+}
+
+void KvClient::RoundTrip(Connection &conn, std::vector<Request> &batch) {
+  // 一条线路命令对应 batch 中 [first, first + count) 的请求；
+  // merged 表示这些相邻的 GET 合并成了一条 MGET
+  struct Slot {
+    size_t first;
+    size_t count;
+    bool merged;
+  };
+  std::vector<Slot> slots;
+  std::string wire;
+  for (size_t i = 0; i < batch.size();) {
+    size_t j = i + 1;
+    if (options_.batch_gets && batch[i].is_get)
+      while (j < batch.size() && batch[j].is_get)
+        ++j;
+    if (j - i >= 2) {
+      wire += '*';
+      wire += std::to_string(j - i + 1);
+      wire += "\r\n$4\r\nMGET\r\n";
+      for (size_t k = i; k < j; ++k)
+        AppendBulk(wire, batch[k].args[1]);
+      slots.push_back({i, j - i, true});
+      merged_gets_.fetch_add(j - i, std::memory_order_relaxed);
+    } else {
+      EncodeCommand(wire, batch[i].args);
+      slots.push_back({i, 1, false});
+    }
+    i = j;
+  }
+  round_trips_.fetch_add(1, std::memory_order_relaxed);
+  commands_.fetch_add(slots.size(), std::memory_order_relaxed);
+
+  size_t done = 0; // 已拿到回复的 slot 数
+  try {
+    if (!conn.sock) {
+      conn.sock = Connect(options_);
+      reconnects_.fetch_add(1, std::memory_order_relaxed);
+    }
+    conn.sock->Send(wire);
+    for (; done < slots.size(); ++done) {
+      RespReply reply = conn.sock->Receive();
+      const Slot &slot = slots[done];
+      if (!slot.merged) {
+        batch[slot.first].done(&reply, nullptr);
+        continue;
+      }
+      // MGET 的回复数组按位置拆回各个 GET；错误回复每个 GET 各拿一份
+      bool split = reply.type == RespReply::Type::Array &&
+                   reply.elements.size() == slot.count;
+      for (size_t k = 0; k < slot.count; ++k) {
+        RespReply copy;
+        if (!split)
+          copy = reply;
+        batch[slot.first + k].done(split ? &reply.elements[k] : &copy,
+                                   nullptr);
+      }
+    }
+  } catch (const std::exception &) {
+    // 回复可能已经错位，丢弃连接，下一轮重连；写命令不重试
+    conn.sock.reset();
+    std::exception_ptr err = std::current_exception();
+    for (; done < slots.size(); ++done) {
+      const Slot &slot = slots[done];
+      for (size_t k = 0; k < slot.count; ++k)
+        batch[slot.first + k].done(nullptr, err);
+      failures_.fetch_add(slot.count, std::memory_order_relaxed);
+    }
+  }
+  batch.clear();
+}
+
+// ==========================================
+// 近端缓存
+// ==========================================
+
+void KvClient::InvalidateWrites(const std::vector<std::string> &args) {
+  if (!near_cache_ || args.size() < 2 || IsReadOnly(args[0]))
+    return;
+  std::lock_guard<std::mutex> lock(near_mu_);
+  ++near_epoch_;
+  if (IsCommand(args[0], "DEL")) {
+    for (size_t i = 1; i < args.size(); ++i)
+      near_cache_->remove(args[i]);
+  } else if (IsCommand(args[0], "MSET")) {
+    for (size_t i = 1; i < args.size(); i += 2)
+      near_cache_->remove(args[i]);
+  } else {
+    near_cache_->remove(args[1]);
+  }
+}
+
+void KvClient::Invalidate(const std::string &key) {
+  if (!near_cache_)
+    return;
+  std::lock_guard<std::mutex> lock(near_mu_);
+  ++near_epoch_;
+  near_cache_->remove(key);
+}
+
+// ==========================================
+// 异步接口
+// ==========================================
+
+std::future<RespReply> KvClient::ExecuteAsync(std::vector<std::string> args) {
+  if (args.empty())
+    throw std::invalid_argument("KvClient: empty command");
+  requests_.fetch_add(1, std::memory_order_relaxed);
+  InvalidateWrites(args);
+
+  auto promise = std::make_shared<std::promise<RespReply>>();
+  std::future<RespReply> future = promise->get_future();
+  Request req;
+  req.is_get = args.size() == 2 && IsCommand(args[0], "GET");
+  req.args = std::move(args);
+  req.done = [promise](RespReply *reply, std::exception_ptr err) {
+    if (err)
+      promise->set_exception(err);
+    else
+      promise->set_value(std::move(*reply));
+  };
+  std::string route = req.args.size() >= 2 ? req.args[1] : std::string();
+  Submit(route, std::move(req));
+  return future;
+}
+
+std::future<std::optional<std::string>>
+KvClient::GetAsync(const std::string &key) {
+  requests_.fetch_add(1, std::memory_order_relaxed);
+  auto promise = std::make_shared<std::promise<std::optional<std::string>>>();
+  std::future<std::optional<std::string>> future = promise->get_future();
+
+  uint64_t epoch = 0;
+  if (near_cache_) {
+    if (std::optional<std::string> cached = near_cache_->get(key)) {
+      near_hits_.fetch_add(1, std::memory_order_relaxed);
+      promise->set_value(std::move(cached));
+      return future;
+    }
+    near_misses_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(near_mu_);
+    epoch = near_epoch_;
+  }
+
+  Request req;
+  req.is_get = true;
+  req.args = {"GET", key};
+  req.done = [this, promise, epoch, key](RespReply *reply,
+                                        std::exception_ptr err) {
+    if (err)
+      return promise->set_exception(err);
+    if (reply->is_error())
+      return promise->set_exception(ReplyError(*reply));
+    if (reply->is_nil())
+      return promise->set_value(std::nullopt);
+    if (reply->type != RespReply::Type::Bulk)
+      return promise->set_exception(std::make_exception_ptr(
+          std::runtime_error("KvClient: unexpected reply to GET")));
+    if (near_cache_) {
+      // 发出之后有过失效（可能是本客户端对这个 key 的写），不回填
+      std::lock_guard<std::mutex> lock(near_mu_);
+      if (near_epoch_ == epoch)
+        near_cache_->put(key, reply->str, options_.near_cache_ttl_ms);
+    }
+    promise->set_value(std::move(reply->str));
+  };
+  Submit(key, std::move(req));
+  return future;
+}
+
+std::future<void> KvClient::SetAsync(const std::string &key,
+                                     const std::string &value,
+                                     int64_t ttl_ms) {
+  std::vector<std::string> args = {"SET", key, value};
+  if (ttl_ms > 0) {
+    args.push_back("PX");
+    args.push_back(std::to_string(ttl_ms));
+  }
+  requests_.fetch_add(1, std::memory_order_relaxed);
+  InvalidateWrites(args);
+
+  auto promise = std::make_shared<std::promise<void>>();
+  std::future<void> future = promise->get_future();
+  Request req;
+  req.args = std::move(args);
+  req.done = [promise](RespReply *reply, std::exception_ptr err) {
+    if (err)
+      return promise->set_exception(err);
+    if (reply->is_error())
+      return promise->set_exception(ReplyError(*reply));
+    promise->set_value();
+  };
+  Submit(key, std::move(req));
+  return future;
+}
+
+std::future<bool> KvClient::DelAsync(const std::string &key) {
+  std::vector<std::string> args = {"DEL", key};
+  requests_.fetch_add(1, std::memory_order_relaxed);
+  InvalidateWrites(args);
+
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  Request req;
+  req.args = std::move(args);
+  req.done = [promise](RespReply *reply, std::exception_ptr err) {
+    if (err)
+      return promise->set_exception(err);
+    if (reply->is_error())
+      return promise->set_exception(ReplyError(*reply));
+    promise->set_value(reply->integer > 0);
+  };
+  Submit(key, std::move(req));
+  return future;
+}
+
+// ==========================================
+// 同步接口
+// ==========================================
+
+RespReply KvClient::Execute(std::vector<std::string> args) {
+  return ExecuteAsync(std::move(args)).get();
+}
+
+std::optional<std::string> KvClient::Get(const std::string &key) {
+  return GetAsync(key).get();
+}
+
+std::vector<std::optional<std::string>>
+KvClient::MGet(const std::vector<std::string> &keys) {
+  std::vector<std::future<std::optional<std::string>>> futures;
+  futures.reserve(keys.size());
+  for (const auto &key : keys)
+    futures.push_back(GetAsync(key));
+  std::vector<std::optional<std::string>> values;
+  values.reserve(keys.size());
+  for (auto &f : futures)
+    values.push_back(f.get());
+  return values;
+}
+
+void KvClient::Set(const std::string &key, const std::string &value,
+                   int64_t ttl_ms) {
+  SetAsync(key, value, ttl_ms).get();
+}
+
+bool KvClient::Del(const std::string &key) { return DelAsync(key).get(); }
+
+KvClientStats KvClient::Stats() const {
+  KvClientStats s;
+  s.requests = requests_.load(std::memory_order_relaxed);
+  s.round_trips = round_trips_.load(std::memory_order_relaxed);
+  s.commands = commands_.load(std::memory_order_relaxed);
+  s.merged_gets = merged_gets_.load(std::memory_order_relaxed);
+  s.near_hits = near_hits_.load(std::memory_order_relaxed);
+  s.near_misses = near_misses_.load(std::memory_order_relaxed);
+  s.reconnects = reconnects_.load(std::memory_order_relaxed);
+  s.failures = failures_.load(std::memory_order_relaxed);
+  return s;
+}
+
+} // namespace client
+} // namespace minkv
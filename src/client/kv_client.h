@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../core/lru_cache.h"
+#include "resp_connection.h"
+
+namespace minkv {
+namespace client {
+
+/** KvClient 配置 */
+struct KvClientOptions {
+  std::string host = "127.0.0.1"; // RESP 服务器（minkv_resp_server）
+  uint16_t port = 6379;           // 同一台机器上也可以用 unix_path
+  std::string unix_path;          // 非空时改走 Unix domain socket
+  size_t connections = 2;         // 连接池大小，每个连接一个 I/O 线程
+  size_t max_pipeline = 256;      // 一次写出的最多请求数
+  bool batch_gets = true;         // 同一轮中相邻的 GET 合并为一条 MGET
+  int timeout_ms = 5000;          // 单次收发超时，<= 0 表示不限
+  // 近端缓存：0 表示关闭。条目最多存活 near_cache_ttl_ms，
+  // 也就是其他客户端写入后本地最多读到这么久的旧值
+  size_t near_cache_capacity = 0;
+  int64_t near_cache_ttl_ms = 100;
+};
+
+/** KvClient 运行统计 */
+struct KvClientStats {
+  uint64_t requests = 0;    // 调用方发起的请求数（含近端缓存命中）
+  uint64_t round_trips = 0; // 一次写出 + 读回的批次数（pipeline）
+  uint64_t commands = 0;    // 实际发给服务器的命令数（合并之后）
+  uint64_t merged_gets = 0; // 合并进 MGET 的 GET 数
+  uint64_t near_hits = 0;   // 近端缓存命中
+  uint64_t near_misses = 0; // 近端缓存未命中
+  uint64_t reconnects = 0;  // 断线后重新建立的连接数
+  uint64_t failures = 0;    // 因连接错误失败的请求数
+};
+
+/**
+ * KvClient — MinKV 的 C++ 客户端（RESP 协议，同步 + 异步接口）
+ *
+ * [连接池] 启动时建立 connections 条长连接，每条连接一个 I/O 线程和一个
+ * 请求队列。带 key 的请求按 key 的哈希固定发往同一条连接，所以同一个
+ * key 上的请求按发起顺序执行（先 Set 后 Get 一定读到新值）；不带 key
+ * 的请求轮流分配。
+ *
+ * [自动 pipeline] I/O 线程每一轮取走队列里积攒的全部请求（最多
+ * max_pipeline 条），编码后一次写出，再按顺序读回回复。并发调用方
+ * 的请求在上一轮往返期间自然攒成一批，不需要调用方显式 pipeline。
+ *
+ * [GET 合并] 同一轮中相邻的 GET 合并为一条 MGET，回复数组再拆给各个
+ * 调用方；中间隔着写命令的 GET 不跨过它合并，保证顺序语义不变。
+ *
+ * [近端缓存] near_cache_capacity > 0 时，GET 的结果在本地 LRU 中保留
+ * near_cache_ttl_ms。本客户端的写命令在发出时就使对应 key 失效，
+ * 失效之前已发出的 GET 回来后不回填（按失效纪元判断），所以本客户端
+ * 总能读到自己的写；其他客户端的写入最多延迟一个 TTL 才可见，收到
+ * 外部失效通知时可以调用 Invalidate。
+ *
+ * 连接出错时这一轮的请求全部以 std::runtime_error 失败（写命令不自动
+ * 重试，避免重复执行），下一轮重新连接。析构时先处理完已入队的请求。
+ *
+ * 线程安全：所有接口都可以被多个线程同时调用。
+ *
+ * 用法：
+ *   KvClientOptions options;
+ *   options.port = 6379;
+ *   KvClient kv(options);
+ *   kv.Set("user:1", "alice");
+ *   auto a = kv.GetAsync("user:1");
+ *   auto b = kv.GetAsync("user:2"); // 与 a 合并为一条 MGET
+ *   std::optional<std::string> v = a.get();
+ */
+class KvClient {
+public:
+  /**
+   * 建立连接池
+   * @throws std::invalid_argument 配置不合法
+   * @throws std::runtime_error 连接失败
+   */
+  explicit KvClient(const KvClientOptions &options = KvClientOptions());
+  ~KvClient();
+
+  KvClient(const KvClient &) = delete;
+  KvClient &operator=(const KvClient &) = delete;
+
+  // ── 异步接口：future 在回复到达后就绪，连接错误时 get() 抛异常 ─────
+
+  /** 执行任意命令，错误回复（"-ERR ..."）作为 Type::Error 返回 */
+  std::future<RespReply> ExecuteAsync(std::vector<std::string> args);
+  std::future<std::optional<std::string>> GetAsync(const std::string &key);
+  /** ttl_ms > 0 时带 PX；服务器返回错误时 get() 抛 std::runtime_error */
+  std::future<void> SetAsync(const std::string &key, const std::string &value,
+                             int64_t ttl_ms = 0);
+  std::future<bool> DelAsync(const std::string &key);
+
+  // ── 同步接口 ─────────────────────────────────────────────────────
+
+  RespReply Execute(std::vector<std::string> args);
+  std::optional<std::string> Get(const std::string &key);
+  /** 多个 key 同时发起，同一连接上的自动合并为 MGET */
+  std::vector<std::optional<std::string>>
+  MGet(const std::vector<std::string> &keys);
+  void Set(const std::string &key, const std::string &value,
+           int64_t ttl_ms = 0);
+  bool Del(const std::string &key);
+
+  /** 使一个 key 的近端缓存失效（收到外部写入通知时调用） */
+  void Invalidate(const std::string &key);
+
+  KvClientStats Stats() const;
+
+private:
+  using Callback = std::function<void(RespReply *reply, std::exception_ptr)>;
+
+  struct Request {
+    bool is_get = false;
+    std::vector<std::string> args;
+    Callback done;
+  };
+
+  struct Connection {
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<Request> queue;
+    std::unique_ptr<RespConnection> sock; // 只由 io 线程访问
+    std::thread io;
+  };
+
+  /** 把请求放进对应连接的队列；route_key 为空时轮流分配 */
+  void Submit(const std::string &route_key, Request req);
+  void IoLoop(Connection &conn);
+  /** 一轮 pipeline：编码、写出、读回并分发；出错时让整批失败 */
+  void RoundTrip(Connection &conn, std::vector<Request> &batch);
+  /** 写命令发出前使其涉及的 key 在近端缓存中失效 */
+  void InvalidateWrites(const std::vector<std::string> &args);
+
+  KvClientOptions options_;
+  std::vector<std::unique_ptr<Connection>> conns_;
+  std::atomic<bool> stopping_{false};
+  std::atomic<size_t> next_conn_{0};
+
+  std::unique_ptr<db::LruCache<std::string, std::string>> near_cache_;
+  // 失效（纪元 +1 并删除）与 GET 回填（检查纪元后写入）互斥，避免
+  // 检查通过之后、写入之前插进来的失效被旧值覆盖
+  std::mutex near_mu_;
+  uint64_t near_epoch_ = 0; // 每次失效 +1，GET 据此决定是否回填
+
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> round_trips_{0};
+  std::atomic<uint64_t> commands_{0};
+  std::atomic<uint64_t> merged_gets_{0};
+  std::atomic<uint64_t> near_hits_{0};
+  std::atomic<uint64_t> near_misses_{0};
+  std::atomic<uint64_t> reconnects_{0};
+  std::atomic<uint64_t> failures_{0};
+};
+
+} // namespace client
+} // namespace minkv
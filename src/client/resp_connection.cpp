@@ -0,0 +1,212 @@
+#include "resp_connection.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include "../server/unix_socket.h"
+
+namespace minkv {
+namespace client {
+
+namespace {
+
+constexpr int kMaxDepth = 32; // 嵌套数组的最大层数
+constexpr size_t kReadChunk = 64 * 1024;
+
+[[noreturn]] void Malformed() {
+  throw std::runtime_error("RespConnection: malformed reply");
+}
+
+[[noreturn]] void FailIo(const char *op) {
+  throw std::runtime_error(std::string("RespConnection: ") + op +
+                           " failed: " + std::strerror(errno));
+}
+
+// 取一行（不含 CRLF），pos 前进到下一行开头；不完整返回 false
+bool ReadLine(std::string_view data, size_t &pos, std::string_view &line) {
+  size_t end = data.find("\r\n", pos);
+  if (end == std::string_view::npos)
+    return false;
+  line = data.substr(pos, end - pos);
+  pos = end + 2;
+  return true;
+}
+
+int64_t ParseInt(std::string_view s) {
+  int64_t v = 0;
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size())
+    Malformed();
+  return v;
+}
+
+// 从 pos 解析一条回复；不完整返回 false（pos 不可再用）
+bool Parse(std::string_view data, size_t &pos, RespReply &out, int depth) {
+  if (depth > kMaxDepth)
+    Malformed();
+  if (pos >= data.size())
+    return false;
+  char type = data[pos++];
+  std::string_view line;
+  if (!ReadLine(data, pos, line))
+    return false;
+
+  switch (type) {
+  case '+':
+    out.type = RespReply::Type::Status;
+    out.str.assign(line);
+    return true;
+  case '-':
+    out.type = RespReply::Type::Error;
+    out.str.assign(line);
+    return true;
+  case ':':
+    out.type = RespReply::Type::Integer;
+    out.integer = ParseInt(line);
+    return true;
+  case '$': {
+    int64_t len = ParseInt(line);
+    if (len < 0) {
+      out.type = RespReply::Type::Nil;
+      return true;
+    }
+    if (data.size() - pos < static_cast<size_t>(len) + 2)
+      return false;
+    if (data.compare(pos + len, 2, "\r\n") != 0)
+      Malformed();
+    out.type = RespReply::Type::Bulk;
+    out.str.assign(data.substr(pos, len));
+    pos += len + 2;
+    return true;
+  }
+  case '*': {
+    int64_t count = ParseInt(line);
+    if (count < 0) {
+      out.type = RespReply::Type::Nil;
+      return true;
+    }
+    out.type = RespReply::Type::Array;
+    out.elements.clear();
+    // 每个元素至少 3 字节，按剩余数据量限制预分配，防止恶意长度
+    out.elements.reserve(
+        std::min<size_t>(count, (data.size() - pos) / 3 + 1));
+    for (int64_t i = 0; i < count; ++i) {
+      out.elements.emplace_back();
+      if (!Parse(data, pos, out.elements.back(), depth + 1))
+        return false;
+    }
+    return true;
+  }
+  default:
+    Malformed();
+  }
+}
+
+} // namespace
+
+size_t ParseReply(std::string_view data, RespReply &out) {
+  size_t pos = 0;
+  return Parse(data, pos, out, 0) ? pos : 0;
+}
+
+void EncodeCommand(std::string &out, const std::vector<std::string> &args) {
+  out += '*';
+  out += std::to_string(args.size());
+  out += "\r\n";
+  for (const auto &arg : args) {
+    out += '$';
+    out += std::to_string(arg.size());
+    out += "\r\n";
+    out += arg;
+    out += "\r\n";
+  }
+}
+
+RespConnection::RespConnection(const std::string &host, uint16_t port,
+                               const std::string &unix_path, int timeout_ms) {
+  if (!unix_path.empty()) {
+    fd_ = server::ConnectUnix(unix_path);
+  } else {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+      throw std::invalid_argument("RespConnection: bad IPv4 address " + host);
+    fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0)
+      FailIo("socket");
+    if (::connect(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+        0) {
+      int saved = errno;
+      ::close(fd_);
+      errno = saved;
+      FailIo("connect");
+    }
+    int one = 1;
+    ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  if (timeout_ms > 0) {
+    timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  }
+}
+
+RespConnection::~RespConnection() {
+  if (fd_ >= 0)
+    ::close(fd_);
+}
+
+void RespConnection::Send(std::string_view data) {
+  while (!data.empty()) {
+    ssize_t n = ::send(fd_, data.data(), data.size(), MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      FailIo("send");
+    }
+    data.remove_prefix(static_cast<size_t>(n));
+  }
+}
+
+RespReply RespConnection::Receive() {
+  RespReply reply;
+  while (true) {
+    size_t used = ParseReply(std::string_view(buf_).substr(offset_), reply);
+    if (used != 0) {
+      offset_ += used;
+      if (offset_ == buf_.size()) {
+        buf_.clear();
+        offset_ = 0;
+      }
+      return reply;
+    }
+    // 半包：先把已解析部分挪走，再接着读
+    if (offset_ != 0) {
+      buf_.erase(0, offset_);
+      offset_ = 0;
+    }
+    size_t old = buf_.size();
+    buf_.resize(old + kReadChunk);
+    ssize_t n = ::recv(fd_, &buf_[old], kReadChunk, 0);
+    int saved = errno;
+    buf_.resize(old + (n > 0 ? static_cast<size_t>(n) : 0));
+    if (n == 0)
+      throw std::runtime_error("RespConnection: server closed connection");
+    errno = saved;
+    if (n < 0 && errno != EINTR)
+      FailIo("recv");
+  }
+}
+
+} // namespace client
+} // namespace minkv
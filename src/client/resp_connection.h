@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace minkv {
+namespace client {
+
+/** 一条 RESP2 回复 */
+struct RespReply {
+  enum class Type { Status, Error, Integer, Bulk, Nil, Array };
+
+  Type type = Type::Nil;
+  std::string str;                 // Status / Error / Bulk 的内容
+  int64_t integer = 0;             // Integer
+  std::vector<RespReply> elements; // Array
+
+  bool is_error() const { return type == Type::Error; }
+  bool is_nil() const { return type == Type::Nil; }
+};
+
+/**
+ * 从 data 开头解析一条完整回复
+ * @return 消耗的字节数；数据不完整（半包）返回 0
+ * @throws std::runtime_error 格式错误（连接只能丢弃）
+ */
+size_t ParseReply(std::string_view data, RespReply &out);
+
+/** 把一条命令按 RESP 数组编码追加到 out */
+void EncodeCommand(std::string &out, const std::vector<std::string> &args);
+
+/**
+ * RespConnection — 到 RESP 服务器的一条阻塞连接
+ *
+ * 只负责收发：Send 写出一批编码好的命令（pipeline），Receive 按顺序
+ * 逐条取回复，读缓冲区里多收的数据留给下一次 Receive。收发超时由
+ * SO_RCVTIMEO / SO_SNDTIMEO 控制，超时和对端关闭都抛异常，之后这条
+ * 连接不能再用（请求和回复可能已经错位）。
+ */
+class RespConnection {
+public:
+  /**
+   * 连接 host:port（IPv4 字面地址）；unix_path 非空时改连 Unix domain
+   * socket
+   * @throws std::runtime_error 连接失败
+   */
+  RespConnection(const std::string &host, uint16_t port,
+                 const std::string &unix_path, int timeout_ms);
+  ~RespConnection();
+
+  RespConnection(const RespConnection &) = delete;
+  RespConnection &operator=(const RespConnection &) = delete;
+
+  /** @throws std::runtime_error 写失败 / 超时 */
+  void Send(std::string_view data);
+
+  /** @throws std::runtime_error 读失败 / 超时 / 对端关闭 / 格式错误 */
+  RespReply Receive();
+
+private:
+  int fd_ = -1;
+  std::string buf_; // 已收到、未解析的数据从 offset_ 开始
+  size_t offset_ = 0;
+};
+
+} // namespace client
+} // namespace minkv
@@ -0,0 +1,204 @@
+#include "shm_client.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <iterator>
+#include <stdexcept>
+
+#include "../server/unix_socket.h"
+
+namespace minkv {
+namespace client {
+
+namespace {
+
+size_t DecimalLength(size_t n) {
+  size_t len = 1;
+  while (n >= 10) {
+    n /= 10;
+    ++len;
+  }
+  return len;
+}
+
+char *WriteHeader(char *p, char type, size_t n) {
+  *p++ = type;
+  p = std::to_chars(p, p + 20, n).ptr;
+  *p++ = '\r';
+  *p++ = '\n';
+  return p;
+}
+
+[[noreturn]] void Fail(const std::string &what) {
+  throw std::runtime_error("ShmClient: " + what);
+}
+
+// 错误回复 "-ERR ...\r\n" 抛出 std::runtime_error
+void ThrowIfError(std::string_view reply) {
+  if (!reply.empty() && reply[0] == '-')
+    throw std::runtime_error(std::string(reply.substr(1, reply.size() - 3)));
+}
+
+// 解析 bulk string 回复；nil 返回 false，value 指向 reply 内部
+bool ParseBulk(std::string_view reply, std::string_view &value) {
+  ThrowIfError(reply);
+  if (reply.size() < 5 || reply[0] != '$')
+    Fail("unexpected reply to GET");
+  if (reply.substr(0, 5) == "$-1\r\n")
+    return false;
+  size_t len = 0;
+  auto [end, ec] =
+      std::from_chars(reply.data() + 1, reply.data() + reply.size(), len);
+  size_t header = static_cast<size_t>(end - reply.data()) + 2;
+  if (ec != std::errc() || header + len + 2 != reply.size())
+    Fail("malformed bulk reply");
+  value = reply.substr(header, len);
+  return true;
+}
+
+// 连上控制 socket 并映射服务端发来的共享内存；失败时关闭 sock
+server::ShmSegment AttachSegment(int sock) {
+  int fd = server::RecvFd(sock);
+  if (fd < 0) {
+    ::close(sock);
+    Fail("server did not send a segment");
+  }
+  try {
+    return server::ShmSegment::Attach(fd);
+  } catch (...) {
+    ::close(sock);
+    throw;
+  }
+}
+
+} // namespace
+
+ShmClient::ShmClient(const std::string &path, const ShmClientOptions &options)
+    : options_(options), sock_(server::ConnectUnix(path)),
+      segment_(AttachSegment(sock_)), requests_(segment_.requests()),
+      responses_(segment_.responses()) {}
+
+ShmClient::~ShmClient() {
+  if (sock_ >= 0)
+    ::close(sock_); // 服务端据此回收服务线程
+}
+
+std::string_view
+ShmClient::Execute(const std::vector<std::string_view> &args) {
+  return Call(args.begin(), args.end());
+}
+
+std::string_view
+ShmClient::Execute(std::initializer_list<std::string_view> args) {
+  return Call(args.begin(), args.end());
+}
+
+template <typename It> std::string_view ShmClient::Call(It begin, It end) {
+  if (broken_)
+    Fail("connection is broken by an earlier timeout or server shutdown");
+  if (begin == end)
+    throw std::invalid_argument("ShmClient: empty command");
+  ReleaseReply();
+
+  size_t count = static_cast<size_t>(std::distance(begin, end));
+  size_t len = 3 + DecimalLength(count);
+  for (It it = begin; it != end; ++it)
+    len += 5 + DecimalLength(it->size()) + it->size();
+
+  // 请求 / 回复严格交替，服务端处理完才释放请求，这里通常一次就能预留到
+  char *p;
+  while ((p = requests_.reserve(len)) == nullptr) {
+    if (!requests_.wait_space(len, options_.spin_us, options_.poll_ms) &&
+        server::PeerClosed(sock_)) {
+      broken_ = true;
+      Fail("server disconnected");
+    }
+  }
+  // 直接编码进共享内存，不经过中间缓冲
+  p = WriteHeader(p, '*', count);
+  for (It it = begin; it != end; ++it) {
+    p = WriteHeader(p, '$', it->size());
+    std::copy(it->begin(), it->end(), p);
+    p += it->size();
+    *p++ = '\r';
+    *p++ = '\n';
+  }
+  requests_.commit();
+  return AwaitReply();
+}
+
+std::string_view ShmClient::AwaitReply() {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point deadline =
+      Clock::now() + std::chrono::milliseconds(options_.timeout_ms);
+  std::string_view reply;
+  while (!responses_.peek(reply)) {
+    if (segment_.header()->closed.load(std::memory_order_acquire) != 0) {
+      broken_ = true;
+      Fail("server stopped");
+    }
+    int wait_ms = options_.poll_ms;
+    if (options_.timeout_ms > 0) {
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - Clock::now());
+      if (left.count() <= 0) {
+        broken_ = true; // 迟到的回复会和下一条请求错位
+        Fail("timed out waiting for reply");
+      }
+      wait_ms = std::min<int>(wait_ms, static_cast<int>(left.count()));
+    }
+    if (!responses_.wait_data(options_.spin_us, wait_ms) &&
+        server::PeerClosed(sock_)) {
+      broken_ = true;
+      Fail("server disconnected");
+    }
+  }
+  holding_reply_ = true;
+  return reply;
+}
+
+void ShmClient::ReleaseReply() {
+  if (holding_reply_) {
+    responses_.release();
+    holding_reply_ = false;
+  }
+}
+
+void ShmClient::Set(std::string_view key, std::string_view value,
+                    int64_t ttl_ms) {
+  std::string_view reply;
+  if (ttl_ms > 0) {
+    std::string ttl = std::to_string(ttl_ms);
+    reply = Execute({"SET", key, value, "PX", ttl});
+  } else {
+    reply = Execute({"SET", key, value});
+  }
+  ThrowIfError(reply);
+  if (reply != "+OK\r\n")
+    Fail("unexpected reply to SET");
+}
+
+std::optional<std::string> ShmClient::Get(std::string_view key) {
+  std::string_view value;
+  if (!GetView(key, value))
+    return std::nullopt;
+  return std::string(value);
+}
+
+bool ShmClient::GetView(std::string_view key, std::string_view &value) {
+  return ParseBulk(Execute({"GET", key}), value);
+}
+
+bool ShmClient::Del(std::string_view key) {
+  std::string_view reply = Execute({"DEL", key});
+  ThrowIfError(reply);
+  if (reply.size() < 4 || reply[0] != ':')
+    Fail("unexpected reply to DEL");
+  return reply[1] != '0';
+}
+
+} // namespace client
+} // namespace minkv
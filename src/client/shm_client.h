@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../server/shm_ring.h"
+
+namespace minkv {
+namespace client {
+
+/** 共享内存客户端配置 */
+struct ShmClientOptions {
+  int spin_us = 50;      // 等回复时在 futex 上睡眠之前忙等的时间
+  int timeout_ms = 5000; // 单条命令的超时，<= 0 表示一直等
+  int poll_ms = 100;     // 睡眠超时，超时后检查服务端是否还在
+};
+
+/**
+ * ShmClient — 同机客户端，走 ShmServer 的共享内存传输
+ *
+ * 构造时连上控制 socket，收到服务端创建的 memfd 并映射；之后每条命令
+ * 直接按 RESP 编码写进请求环，回复从响应环读出。Execute 返回的回复和
+ * GetView 返回的值都直接指向共享内存（零拷贝），在同一个客户端的下一次
+ * 调用之前有效。
+ *
+ * 不是线程安全的：一个线程一个客户端（请求环是单生产者的）。
+ *
+ * 用法：
+ *   minkv::client::ShmClient kv("/tmp/minkv.shm");
+ *   kv.Set("user:1", "alice");
+ *   std::string_view v;
+ *   if (kv.GetView("user:1", v)) { ... }
+ */
+class ShmClient {
+public:
+  /**
+   * 连接服务端并映射共享内存
+   * @throws std::runtime_error 连接失败或收到的段不合法
+   */
+  explicit ShmClient(const std::string &path,
+                     const ShmClientOptions &options = ShmClientOptions());
+  ~ShmClient();
+
+  ShmClient(const ShmClient &) = delete;
+  ShmClient &operator=(const ShmClient &) = delete;
+
+  /**
+   * 执行一条命令，返回原始 RESP 回复（含错误回复 "-ERR ..."）
+   * @throws std::runtime_error 服务端已停止 / 断开、超时
+   * @throws std::length_error 请求超过环的单条消息上限
+   */
+  std::string_view Execute(const std::vector<std::string_view> &args);
+  std::string_view Execute(std::initializer_list<std::string_view> args);
+
+  /** SET；ttl_ms > 0 时带 PX。服务端返回错误时抛 std::runtime_error */
+  void Set(std::string_view key, std::string_view value, int64_t ttl_ms = 0);
+
+  /** GET，拷贝出值；不存在返回 std::nullopt */
+  std::optional<std::string> Get(std::string_view key);
+
+  /** GET，value 指向共享内存（下一次调用前有效）；不存在返回 false */
+  bool GetView(std::string_view key, std::string_view &value);
+
+  /** DEL，返回 key 是否存在 */
+  bool Del(std::string_view key);
+
+private:
+  template <typename It> std::string_view Call(It begin, It end);
+  /** 等待并 peek 下一条回复 */
+  std::string_view AwaitReply();
+  /** 释放上一条回复占用的响应环空间 */
+  void ReleaseReply();
+
+  ShmClientOptions options_;
+  int sock_ = -1;
+  server::ShmSegment segment_;
+  server::ShmRing requests_;
+  server::ShmRing responses_;
+  bool holding_reply_ = false;
+  bool broken_ = false; // 超时后请求和回复可能错位，不再可用
+};
+
+} // namespace client
+} // namespace minkv
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <functional>
@@ -127,6 +128,14 @@ public:
    */
   std::optional<V> get(const K &key);
 
+  /**
+   * @brief 与 get 语义相同，但返回指向内部值的指针而不拷贝
+   *
+   * 仅用于 ThreadSafe=false（外层已持锁）：指针在外层锁释放、
+   * 或下一次修改该缓存之前有效。未命中或已过期时返回 nullptr。
+   */
+  const V *get_ptr(const K &key);
+
   /**
    * @brief 插入或更新数据
    * 1. 如果 key 存在：更新 value，移动到头部。
@@ -145,6 +154,19 @@ public:
    */
   bool remove(const K &key);
 
+  /**
+   * @brief 查询剩余存活时间
+   * @return 剩余毫秒数；永不过期返回 -1，不存在或已过期返回 -2
+   */
+  int64_t ttl(const K &key);
+
+  /**
+   * @brief 重新设置过期时间，不改变 value 和 LRU 位置
+   * @param ttl_ms 从现在起的存活时间（毫秒），0 表示永不过期
+   * @return key 不存在或已过期返回 false
+   */
+  bool expire(const K &key, int64_t ttl_ms);
+
   // 获取当前缓存大小
   size_t size() const;
 
@@ -207,6 +229,34 @@ public:
    */
   std::map<K, V> get_all() const;
 
+  /**
+   * @brief 按哈希桶遍历一段未过期条目（游标遍历使用）
+   *
+   * 从第 bucket 个桶开始，对整桶的条目调用 visitor(key, value)，
+   * 访问到至少 count 条后停在桶边界，不改变 LRU 顺序和统计。
+   * 仅用于 ThreadSafe=false（外层已持锁）。
+   * @return 下一次的起始桶；不小于 bucket_count() 表示已遍历完
+   */
+  template <typename F>
+  size_t scan_buckets(size_t bucket, size_t count, F &&visitor) const {
+    static_assert(!ThreadSafe,
+                  "scan_buckets requires an externally locked cache");
+    const size_t buckets = map_.bucket_count();
+    size_t visited = 0;
+    for (; bucket < buckets && visited < count; ++bucket) {
+      for (auto it = map_.begin(bucket); it != map_.end(bucket); ++it) {
+        if (is_expired(*it->second))
+          continue;
+        visitor(it->second->key, it->second->value);
+        ++visited;
+      }
+    }
+    return bucket;
+  }
+
+  /** @brief 当前哈希桶数；变化说明发生过 rehash，桶下标不再有效 */
+  size_t bucket_count() const { return map_.bucket_count(); }
+
 private:
   size_t capacity_; // 最大容量
 
@@ -393,29 +443,41 @@ std::optional<V> LruCache<K, V, ThreadSafe>::get(const K &key) {
     return it->second->value;
   } else {
     // ThreadSafe=false：无锁单路径，外层 Shard 已持锁
-    auto it = map_.find(key);
-    if (it == map_.end()) {
-      ++stats_misses_;
-      last_miss_time_ms_.store(now, std::memory_order_relaxed);
-      return std::nullopt;
-    }
-    if (is_expired(*it->second)) {
-      auto list_it = it->second;
-      map_.erase(it);
-      cache_list_.erase(list_it);
-      ++stats_expired_;
-      ++stats_misses_;
+    const V *value = get_ptr(key);
+    if (!value)
       return std::nullopt;
-    }
-    uint64_t last = it->second->last_promote_ms.load(std::memory_order_relaxed);
-    if (now >= last && (now - last) > 1000) {
-      cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
-      it->second->last_promote_ms.store(now, std::memory_order_relaxed);
-    }
-    ++stats_hits_;
-    last_hit_time_ms_.store(now, std::memory_order_relaxed);
-    return it->second->value;
+    return *value;
+  }
+}
+
+template <typename K, typename V, bool ThreadSafe>
+const V *LruCache<K, V, ThreadSafe>::get_ptr(const K &key) {
+  static_assert(!ThreadSafe, "get_ptr requires an externally locked cache");
+  uint64_t now = static_cast<uint64_t>(current_time_ms());
+  last_access_time_ms_.store(now, std::memory_order_relaxed);
+
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    ++stats_misses_;
+    last_miss_time_ms_.store(now, std::memory_order_relaxed);
+    return nullptr;
+  }
+  if (is_expired(*it->second)) {
+    auto list_it = it->second;
+    map_.erase(it);
+    cache_list_.erase(list_it);
+    ++stats_expired_;
+    ++stats_misses_;
+    return nullptr;
+  }
+  uint64_t last = it->second->last_promote_ms.load(std::memory_order_relaxed);
+  if (now >= last && (now - last) > 1000) {
+    cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
+    it->second->last_promote_ms.store(now, std::memory_order_relaxed);
   }
+  ++stats_hits_;
+  last_hit_time_ms_.store(now, std::memory_order_relaxed);
+  return &it->second->value;
 }
 
 template <typename K, typename V, bool ThreadSafe>
@@ -481,6 +543,46 @@ bool LruCache<K, V, ThreadSafe>::remove(const K &key) {
   return true;
 }
 
+template <typename K, typename V, bool ThreadSafe>
+int64_t LruCache<K, V, ThreadSafe>::ttl(const K &key) {
+  std::lock_guard<MutexType> lock(mutex_);
+
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    return -2;
+  }
+  if (is_expired(*it->second)) {
+    auto list_it = it->second;
+    map_.erase(it);
+    cache_list_.erase(list_it);
+    ++stats_expired_;
+    return -2;
+  }
+  if (it->second->expiry_time_ms == 0) {
+    return -1;
+  }
+  return std::max<int64_t>(it->second->expiry_time_ms - current_time_ms(), 0);
+}
+
+template <typename K, typename V, bool ThreadSafe>
+bool LruCache<K, V, ThreadSafe>::expire(const K &key, int64_t ttl_ms) {
+  std::lock_guard<MutexType> lock(mutex_);
+
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    return false;
+  }
+  if (is_expired(*it->second)) {
+    auto list_it = it->second;
+    map_.erase(it);
+    cache_list_.erase(list_it);
+    ++stats_expired_;
+    return false;
+  }
+  it->second->expiry_time_ms = ttl_ms > 0 ? current_time_ms() + ttl_ms : 0;
+  return true;
+}
+
 template <typename K, typename V, bool ThreadSafe>
 size_t LruCache<K, V, ThreadSafe>::size() const {
   std::lock_guard<MutexType> lock(mutex_);
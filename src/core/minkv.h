@@ -79,6 +79,58 @@ public:
    */
   bool remove(const K &key) { return cache_->remove(key); }
 
+  /**
+   * @brief 批量获取，按分片分组加锁
+   */
+  std::vector<std::optional<V>> multiGet(const std::vector<K> &keys) {
+    return cache_->multi_get(keys);
+  }
+
+  /**
+   * @brief 批量写入，按分片分组加锁，WAL 一次加锁追加
+   */
+  void multiPut(const std::vector<std::pair<K, V>> &entries,
+                int64_t ttl_ms = 0) {
+    cache_->multi_put(entries, ttl_ms);
+  }
+
+  /**
+   * @brief 批量删除，返回每个 key 是否存在
+   */
+  std::vector<bool> multiRemove(const std::vector<K> &keys) {
+    return cache_->multi_remove(keys);
+  }
+
+  /**
+   * @brief 游标遍历，语义同 Redis SCAN（见 ShardedCache::scan）
+   * @param visitor 对每个条目调用 visitor(key, value)，在分片锁内执行
+   */
+  template <typename F>
+  db::ScanCursor scan(const db::ScanCursor &cursor, size_t count,
+                      F &&visitor) {
+    return cache_->scan(cursor, count, std::forward<F>(visitor));
+  }
+
+  /**
+   * @brief 原子 read-modify-write（计数器等），保留原有 TTL
+   * @param updater 接收旧值（不存在为 nullopt），返回新值
+   */
+  template <typename F> V updateInPlace(const K &key, F &&updater) {
+    return cache_->update_in_place(key, std::forward<F>(updater));
+  }
+
+  /**
+   * @brief 剩余存活时间（毫秒），永不过期返回 -1，不存在返回 -2
+   */
+  int64_t ttl(const K &key) { return cache_->ttl(key); }
+
+  /**
+   * @brief 重新设置过期时间，ttl_ms 为 0 表示永不过期；key 不存在返回 false
+   */
+  bool expire(const K &key, int64_t ttl_ms) {
+    return cache_->expire(key, ttl_ms);
+  }
+
   /**
    * @brief 获取存储大小
    */
@@ -163,13 +215,40 @@ public:
    */
   std::vector<float> vectorGet(const K &key) { return cache_->vectorGet(key); }
 
+  /**
+   * @brief 写入 fp32 原始字节形式的向量（二进制传输，不经过 vector<float>）
+   * @throws std::invalid_argument 字节数不是 sizeof(float) 的正整数倍
+   */
+  void vectorPutRaw(const K &key, const V &raw, int64_t ttl_ms = 0) {
+    cache_->vectorPutRaw(key, raw, ttl_ms);
+  }
+
   /**
    * @brief 向量相似度搜索
    * @param query 查询向量
    * @param k 返回最相似的k个结果
+   * @param cancel 取消令牌，取消后返回已扫描部分的结果
+   */
+  std::vector<K> vectorSearch(const std::vector<float> &query, int k,
+                              const base::CancellationToken &cancel = {}) {
+    return cache_->vectorSearch(query, k, cancel);
+  }
+
+  /**
+   * @brief 向量相似度搜索，查询向量以指针 + 维度给出
+   */
+  std::vector<K> vectorSearch(const float *query, size_t dim, int k,
+                              const base::CancellationToken &cancel = {}) {
+    return cache_->vectorSearch(query, dim, k, cancel);
+  }
+
+  /**
+   * @brief 批量向量搜索，各分片只扫描一次
    */
-  std::vector<K> vectorSearch(const std::vector<float> &query, int k) {
-    return cache_->vectorSearch(query, k);
+  std::vector<std::vector<K>>
+  vectorSearchBatch(const std::vector<std::vector<float>> &queries, int k,
+                    const base::CancellationToken &cancel = {}) {
+    return cache_->vectorSearchBatch(queries, k, cancel);
   }
 
   // ==========================================
@@ -1,15 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <future>
 #include <memory>
 #include <queue>
 #include <random>
+#include <stdexcept>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "../base/cancellation.h"
 #include "../base/expiration_manager.h"
 #include "../base/serializer.h"
 #include "../persistence/wal.h"
@@ -19,6 +22,20 @@
 namespace minkv {
 namespace db {
 
+/**
+ * @brief 游标遍历的位置（ShardedCache::scan 使用）
+ *
+ * 默认值表示从头开始；done 为 true 表示遍历完成。
+ * bucket_count 记录上次遍历时该分片的哈希桶数，分片在两次调用之间
+ * 扩容重排（rehash）后桶下标失效，此时该分片从 0 号桶重新开始。
+ */
+struct ScanCursor {
+  size_t shard = 0;
+  size_t bucket = 0;
+  size_t bucket_count = 0;
+  bool done = false;
+};
+
 /**
  * @brief 工业级分片缓存系统 - 集大成者
  *
@@ -73,6 +90,40 @@ public:
    */
   std::optional<V> get(const K &key);
 
+  /**
+   * @brief 批量查询：按分片分组，每个分片只加一次锁
+   * @param keys 要查询的键（可重复）
+   * @return 与 keys 一一对应的结果，未命中或分片禁用时为 std::nullopt
+   * @note 与逐个 get 的语义相同（命中会刷新 LRU 位置），
+   *       但 N 个 key 只需 min(N, 分片数) 次加锁
+   */
+  std::vector<std::optional<V>> multi_get(const std::vector<K> &keys);
+
+  /**
+   * @brief 批量访问：与 multi_get 相同的分组方式，但不拷贝值
+   * @param keys    要查询的键（可重复）
+   * @param visitor 对每个命中的键调用 visitor(i, const V &value)，
+   *                i 为 keys 中的下标；未命中的键不调用
+   * @note visitor 在分片锁内执行，value 只在回调期间有效；
+   *       回调中不能再访问本缓存（分片锁不可重入）；
+   *       visitor 抛出的异常直接传给调用方
+   */
+  template <typename F>
+  void multi_visit(const std::vector<K> &keys, F &&visitor);
+
+  /**
+   * @brief 游标遍历（语义同 Redis SCAN）：按分片、分片内按哈希桶推进
+   * @param cursor  上次返回的游标，首次传 ScanCursor{}
+   * @param count   本次期望访问的条目数（按整桶返回，可能略多）
+   * @param visitor 对每个未过期条目调用 visitor(key, value)
+   * @return 下一次的游标，done 为 true 时遍历完成
+   * @note 遍历期间一直存在的 key 至少返回一次，rehash 后可能重复返回；
+   *       期间新写入或删除的 key 不保证。每次调用最多持 count 条的分片锁，
+   *       visitor 的限制同 multi_visit；不命中 LRU、不计入统计
+   */
+  template <typename F>
+  ScanCursor scan(const ScanCursor &cursor, size_t count, F &&visitor);
+
   /**
    * @brief 写入一个键值对
    * @param key   键
@@ -91,6 +142,39 @@ public:
    */
   bool remove(const K &key);
 
+  /**
+   * @brief 批量写入：按分片分组，每个分片只加一次锁
+   * @param entries 要写入的键值对；同一个 key 出现多次时后者生效
+   * @param ttl_ms  统一的过期时间（毫秒），0 表示永不过期
+   * @note 启用持久化时先在一次 WAL 加锁内追加全部 PUT 记录，再写内存；
+   *       与逐个 put 的语义相同：WAL 追加失败的记录不写内存并记分片错误，
+   *       被禁用的分片上的记录被跳过
+   */
+  void multi_put(const std::vector<std::pair<K, V>> &entries,
+                 int64_t ttl_ms = 0);
+
+  /**
+   * @brief 批量删除：分组方式与 multi_put 相同
+   * @return 与 keys 一一对应，true 表示该 key 存在并已删除
+   * @note 同一个 key 出现多次时只有第一次返回 true；
+   *       WAL 追加失败的 key 不删内存、返回 false，与 remove() 相同
+   */
+  std::vector<bool> multi_remove(const std::vector<K> &keys);
+
+  /**
+   * @brief 查询剩余存活时间
+   * @return 剩余毫秒数；永不过期返回 -1，不存在、已过期或分片被禁用返回 -2
+   */
+  int64_t ttl(const K &key);
+
+  /**
+   * @brief 重新设置过期时间（EXPIRE / PERSIST）
+   * @param ttl_ms 从现在起的存活时间（毫秒），0 表示永不过期
+   * @return key 不存在或已过期返回 false
+   * @note 与 put 的 ttl_ms 一样只作用于内存，不写 WAL
+   */
+  bool expire(const K &key, int64_t ttl_ms);
+
   /**
    * @brief 返回当前缓存中存活的条目总数
    * @return 所有健康分片的 size() 之和
@@ -204,6 +288,14 @@ public:
   void vectorPut(const K &key, const std::vector<float> &vec,
                  int64_t ttl_ms = 0);
 
+  /**
+   * @brief 写入已是存储格式的向量（fp32 原始字节，与 Serialize 结果相同）
+   * @param raw 字节数必须是 sizeof(float) 的正整数倍
+   * @throws std::invalid_argument raw 为空或长度不对
+   * @note 用于二进制传输，请求体不经过 vector<float> 直接写入
+   */
+  void vectorPutRaw(const K &key, const V &raw, int64_t ttl_ms = 0);
+
   /**
    * @brief 读取一个向量（自动反序列化）
    * @param key 键
@@ -213,13 +305,34 @@ public:
 
   /**
    * @brief Top-K 近似最近邻搜索（L2 距离）
-   * @param query 查询向量
-   * @param k     返回最近的 k 个结果
+   * @param query  查询向量
+   * @param k      返回最近的 k 个结果
+   * @param cancel 取消令牌：各分片每扫描 kCancelCheckInterval 条检查一次，
+   *               取消后停止扫描，返回已扫描部分的 Top-K（调用方用
+   *               cancel.cancelled() 判断结果是否完整）
    * @return 按距离从近到远排列的 key 列表（最多 k 个）
    * @note 并行搜索所有分片（std::async），每个分片维护局部 Top-K 堆，
    *       最后合并为全局 Top-K。维度不匹配的条目会被跳过。
    */
-  std::vector<K> vectorSearch(const std::vector<float> &query, int k);
+  std::vector<K> vectorSearch(const std::vector<float> &query, int k,
+                              const base::CancellationToken &cancel = {});
+
+  /**
+   * @brief 同上，查询向量以指针给出（可直接指向请求体）
+   */
+  std::vector<K> vectorSearch(const float *query, size_t dim, int k,
+                              const base::CancellationToken &cancel = {});
+
+  /**
+   * @brief 批量 Top-K 搜索：每个分片只做一次快照，所有查询共用
+   * @param queries 查询向量，维度可以各不相同
+   * @return 与 queries 一一对应的结果，含义同 vectorSearch
+   * @note 逐个调用 vectorSearch 时每个查询都要拷贝一遍全部分片；
+   *       这里每个分片只 get_all 一次，再对每个查询各维护一个局部堆
+   */
+  std::vector<std::vector<K>>
+  vectorSearchBatch(const std::vector<std::vector<float>> &queries, int k,
+                    const base::CancellationToken &cancel = {});
 
   // ==========================================
   // 定期删除接口 (Expiration API)
@@ -354,6 +467,18 @@ public:
     shards_[shard_idx]->remove(key);
   }
 
+  /**
+   * @brief 批量导入专用写入：按分片分组，每个分片只加一次锁，不触发 WAL
+   *
+   * 用于图批量导入等离线加载场景。逐条 put 时每条记录都要写 WAL、
+   * 抢一次分片锁；这里先按分片分桶，再对每个分片一次性写完。
+   * 持久化由调用方在导入结束后通过 create_snapshot() 或 Checkpoint 完成。
+   *
+   * 持全局一致性锁（shared），与 export_all_data / create_snapshot 互斥；
+   * 可以从多个线程并发调用（各自持有不同的 entries）。
+   */
+  void bulk_load(const std::vector<std::pair<K, V>> &entries);
+
 private:
   // ==========================================
   // 核心数据结构
@@ -368,8 +493,43 @@ private:
 
     // 基础接口
     std::optional<V> get(const K &key);
+    /** @brief 在一次加锁内查询 keys[idx[i]]，结果写入 out[idx[i]] */
+    void get_batch(const std::vector<K> &keys, const std::vector<size_t> &idx,
+                   std::vector<std::optional<V>> &out);
+    /** @brief 在一次加锁内对命中的键调用 visitor(i, value)，不拷贝值 */
+    template <typename F>
+    void visit_batch(const std::vector<K> &keys,
+                     const std::vector<size_t> &idx, F &visitor) {
+      std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
+      for (size_t i : idx) {
+        if (const V *value = cache_->get_ptr(keys[i]))
+          visitor(i, *value);
+      }
+    }
+    /**
+     * @brief 在一次加锁内从 pos 继续按桶遍历，更新 pos
+     * @return 访问的条目数；pos.bucket >= pos.bucket_count 表示分片遍历完
+     */
+    template <typename F>
+    size_t scan_batch(ScanCursor &pos, size_t count, F &visitor) {
+      std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
+      const size_t buckets = cache_->bucket_count();
+      if (pos.bucket_count != buckets) { // 首次进入或发生过 rehash
+        pos.bucket = 0;
+        pos.bucket_count = buckets;
+      }
+      size_t visited = 0;
+      pos.bucket = cache_->scan_buckets(
+          pos.bucket, count, [&](const K &key, const V &value) {
+            visitor(key, value);
+            ++visited;
+          });
+      return visited;
+    }
     void put(const K &key, const V &value, int64_t ttl_ms = 0);
     bool remove(const K &key);
+    int64_t ttl(const K &key);
+    bool expire(const K &key, int64_t ttl_ms);
     /** @brief 返回该分片当前存活的条目数（加锁读取） */
     size_t size() const;
     /** @brief 返回该分片的最大容量（无锁，构造后不变） */
@@ -379,6 +539,12 @@ private:
     void clear();
     /** @brief 返回该分片所有键值对的快照（加锁，用于导出/快照） */
     std::map<K, V> get_all() const;
+    /** @brief 在一次加锁内写入多条记录（bulk_load / multi_put 使用） */
+    void put_batch(const std::vector<const std::pair<K, V> *> &items,
+                   int64_t ttl_ms = 0);
+    /** @brief 在一次加锁内删除 keys[idx[i]]，结果写入 out[idx[i]] */
+    void remove_batch(const std::vector<K> &keys,
+                      const std::vector<size_t> &idx, std::vector<bool> &out);
 
     // 定期删除接口
     /** @brief 非阻塞尝试加锁，成功返回 true（供 ExpirationManager 使用） */
@@ -411,12 +577,15 @@ private:
      * @param key      要更新的键
      * @param updater  回调函数，接收旧值的 optional，返回新值
      * @return 更新后的新值
+     * @note 旧值带 TTL 时保留剩余的存活时间（与 Redis INCR 语义一致）
      */
     template <typename F> V update_in_place(const K &key, F &&updater) {
       std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
       auto old_val = cache_->get(key);
       auto new_val = updater(old_val);
-      cache_->put(key, new_val, 0);
+      int64_t remaining = old_val ? cache_->ttl(key) : -1;
+      cache_->put(key, new_val,
+                  remaining >= 0 ? std::max<int64_t>(remaining, 1) : 0);
       return new_val;
     }
 
@@ -480,6 +649,19 @@ private:
   void recordShardError(size_t shard_id);
   void recordShardSuccess(size_t shard_id);
   bool isShardDisabled(size_t shard_id) const;
+
+  /** @brief 一个查询向量（指向调用方的数据，不拷贝） */
+  struct VectorQuery {
+    const float *data;
+    size_t dim;
+  };
+  /** @brief 向量检索每扫描这么多条检查一次取消令牌 */
+  static constexpr size_t kCancelCheckInterval = 1024;
+
+  /** @brief vectorSearch / vectorSearchBatch 的共同实现 */
+  std::vector<std::vector<K>>
+  searchVectors(const std::vector<VectorQuery> &queries, int k,
+                const base::CancellationToken &cancel);
 };
 
 // ============ 实现部分 ============
@@ -531,6 +713,80 @@ std::optional<V> ShardedCache<K, V, EnableCacheAlign>::get(const K &key) {
   }
 }
 
+template <typename K, typename V, bool EnableCacheAlign>
+std::vector<std::optional<V>>
+ShardedCache<K, V, EnableCacheAlign>::multi_get(const std::vector<K> &keys) {
+  std::vector<std::optional<V>> out(keys.size());
+
+  // 按分片分桶，桶内只存下标
+  std::vector<std::vector<size_t>> by_shard(shards_.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    by_shard[get_shard_index(keys[i])].push_back(i);
+  }
+
+  for (size_t s = 0; s < shards_.size(); ++s) {
+    if (by_shard[s].empty() || isShardDisabled(s))
+      continue;
+    try {
+      shards_[s]->get_batch(keys, by_shard[s], out);
+      recordShardSuccess(s);
+    } catch (const std::exception &e) {
+      recordShardError(s);
+    }
+  }
+  return out;
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+template <typename F>
+void ShardedCache<K, V, EnableCacheAlign>::multi_visit(
+    const std::vector<K> &keys, F &&visitor) {
+  std::vector<std::vector<size_t>> by_shard(shards_.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    by_shard[get_shard_index(keys[i])].push_back(i);
+  }
+
+  for (size_t s = 0; s < shards_.size(); ++s) {
+    if (by_shard[s].empty() || isShardDisabled(s))
+      continue;
+    // 不吞掉异常：visitor 抛出的异常（如记录损坏）应由调用方处理，
+    // 不能算作分片故障
+    shards_[s]->visit_batch(keys, by_shard[s], visitor);
+    recordShardSuccess(s);
+  }
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+template <typename F>
+ScanCursor ShardedCache<K, V, EnableCacheAlign>::scan(const ScanCursor &cursor,
+                                                      size_t count,
+                                                      F &&visitor) {
+  ScanCursor next = cursor;
+  size_t visited = 0;
+  while (!next.done && visited < count) {
+    if (next.shard >= shards_.size()) {
+      next = ScanCursor{};
+      next.done = true;
+      break;
+    }
+    if (!isShardDisabled(next.shard)) {
+      visited +=
+          shards_[next.shard]->scan_batch(next, count - visited, visitor);
+      recordShardSuccess(next.shard);
+      if (next.bucket < next.bucket_count)
+        continue; // 本分片还有桶，说明已访问够 count 条
+    }
+    ++next.shard;
+    next.bucket = 0;
+    next.bucket_count = 0;
+  }
+  if (next.shard >= shards_.size()) {
+    next = ScanCursor{};
+    next.done = true;
+  }
+  return next;
+}
+
 template <typename K, typename V, bool EnableCacheAlign>
 void ShardedCache<K, V, EnableCacheAlign>::put(const K &key, const V &value,
                                                int64_t ttl_ms) {
@@ -580,6 +836,188 @@ void ShardedCache<K, V, EnableCacheAlign>::put(const K &key, const V &value,
   }
 }
 
+// ==========================================
+// bulk_load 实现
+// ==========================================
+
+template <typename K, typename V, bool EnableCacheAlign>
+void ShardedCache<K, V, EnableCacheAlign>::bulk_load(
+    const std::vector<std::pair<K, V>> &entries) {
+  std::shared_lock<std::shared_mutex> consistency_lock(
+      global_consistency_lock_);
+
+  // 先按分片分桶（只存指针，不拷贝 value），再逐分片一次性写入
+  std::vector<std::vector<const std::pair<K, V> *>> by_shard(shards_.size());
+  for (const auto &entry : entries) {
+    by_shard[get_shard_index(entry.first)].push_back(&entry);
+  }
+
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (by_shard[i].empty() || isShardDisabled(i))
+      continue;
+    try {
+      shards_[i]->put_batch(by_shard[i]);
+      recordShardSuccess(i);
+    } catch (const std::exception &e) {
+      recordShardError(i);
+    }
+  }
+}
+
+// ==========================================
+// multi_put / multi_remove 实现
+// ==========================================
+
+template <typename K, typename V, bool EnableCacheAlign>
+void ShardedCache<K, V, EnableCacheAlign>::multi_put(
+    const std::vector<std::pair<K, V>> &entries, int64_t ttl_ms) {
+  std::shared_lock<std::shared_mutex> consistency_lock(
+      global_consistency_lock_);
+
+  std::vector<std::vector<const std::pair<K, V> *>> by_shard(shards_.size());
+  for (const auto &entry : entries) {
+    by_shard[get_shard_index(entry.first)].push_back(&entry);
+  }
+
+  // 先写WAL：按分片顺序追加，与随后的内存写入顺序一致，
+  // 同一个 key 的多条记录恢复时同样是后者生效
+  if (persistence_enabled_ && wal_) {
+    const int64_t now_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch())
+            .count();
+    std::vector<LogEntry> wal_entries;
+    // 每条记录对应的 (分片, 在 by_shard 中的下标)，追加失败时据此截断
+    std::vector<std::pair<size_t, size_t>> wal_origin;
+    wal_entries.reserve(entries.size());
+    wal_origin.reserve(entries.size());
+    for (size_t i = 0; i < shards_.size(); ++i) {
+      if (by_shard[i].empty() || isShardDisabled(i))
+        continue;
+      for (size_t pos = 0; pos < by_shard[i].size(); ++pos) {
+        const auto *item = by_shard[i][pos];
+        try {
+          LogEntry wal_entry;
+          wal_entry.op = LogEntry::PUT;
+          wal_entry.key = Serializer<K>::serialize(item->first);
+          wal_entry.value = Serializer<V>::serialize(item->second);
+          wal_entry.timestamp_ms = now_ms;
+          wal_entry.lsn = next_lsn();
+          wal_entries.push_back(std::move(wal_entry));
+          wal_origin.emplace_back(i, pos);
+        } catch (const std::exception &e) {
+          // 与 put() 相同：序列化失败的记录只写内存
+        }
+      }
+    }
+    size_t appended = 0;
+    try {
+      std::lock_guard<std::mutex> wal_lock(persistence_mutex_);
+      for (; appended < wal_entries.size(); ++appended) {
+        wal_->append(wal_entries[appended]);
+      }
+    } catch (const std::exception &e) {
+      std::cerr << "[WAL] multi_put WAL append failed: " << e.what()
+                << std::endl;
+      // 与 put() 相同：没写进 WAL 的记录不写内存，所在分片记错误。
+      // 记录按分片顺序追加，失败点之后的分片整个跳过
+      auto [failed_shard, failed_pos] = wal_origin[appended];
+      by_shard[failed_shard].resize(failed_pos);
+      recordShardError(failed_shard);
+      for (size_t i = failed_shard + 1; i < shards_.size(); ++i) {
+        if (by_shard[i].empty() || isShardDisabled(i))
+          continue;
+        by_shard[i].clear();
+        recordShardError(i);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (by_shard[i].empty() || isShardDisabled(i))
+      continue;
+    try {
+      shards_[i]->put_batch(by_shard[i], ttl_ms);
+      recordShardSuccess(i);
+    } catch (const std::exception &e) {
+      recordShardError(i);
+    }
+  }
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+std::vector<bool>
+ShardedCache<K, V, EnableCacheAlign>::multi_remove(const std::vector<K> &keys) {
+  std::shared_lock<std::shared_mutex> consistency_lock(
+      global_consistency_lock_);
+
+  std::vector<bool> out(keys.size(), false);
+  std::vector<std::vector<size_t>> by_shard(shards_.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    by_shard[get_shard_index(keys[i])].push_back(i);
+  }
+
+  if (persistence_enabled_ && wal_) {
+    const int64_t now_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch())
+            .count();
+    std::vector<LogEntry> wal_entries;
+    std::vector<std::pair<size_t, size_t>> wal_origin; // 同 multi_put
+    wal_entries.reserve(keys.size());
+    wal_origin.reserve(keys.size());
+    for (size_t s = 0; s < shards_.size(); ++s) {
+      if (by_shard[s].empty() || isShardDisabled(s))
+        continue;
+      for (size_t pos = 0; pos < by_shard[s].size(); ++pos) {
+        try {
+          LogEntry wal_entry;
+          wal_entry.op = LogEntry::DELETE;
+          wal_entry.key = Serializer<K>::serialize(keys[by_shard[s][pos]]);
+          wal_entry.timestamp_ms = now_ms;
+          wal_entry.lsn = next_lsn();
+          wal_entries.push_back(std::move(wal_entry));
+          wal_origin.emplace_back(s, pos);
+        } catch (const std::exception &e) {
+          // 与 remove() 相同：序列化失败的记录只删内存
+        }
+      }
+    }
+    size_t appended = 0;
+    try {
+      std::lock_guard<std::mutex> wal_lock(persistence_mutex_);
+      for (; appended < wal_entries.size(); ++appended) {
+        wal_->append(wal_entries[appended]);
+      }
+    } catch (const std::exception &e) {
+      std::cerr << "[WAL] multi_remove WAL append failed: " << e.what()
+                << std::endl;
+      // 与 remove() 相同：没写进 WAL 的 key 不删内存（结果为 false）
+      auto [failed_shard, failed_pos] = wal_origin[appended];
+      by_shard[failed_shard].resize(failed_pos);
+      recordShardError(failed_shard);
+      for (size_t s = failed_shard + 1; s < shards_.size(); ++s) {
+        if (by_shard[s].empty() || isShardDisabled(s))
+          continue;
+        by_shard[s].clear();
+        recordShardError(s);
+      }
+    }
+  }
+
+  for (size_t s = 0; s < shards_.size(); ++s) {
+    if (by_shard[s].empty() || isShardDisabled(s))
+      continue;
+    try {
+      shards_[s]->remove_batch(keys, by_shard[s], out);
+      recordShardSuccess(s);
+    } catch (const std::exception &e) {
+      recordShardError(s);
+    }
+  }
+  return out;
+}
+
 // ==========================================
 // update_in_place 实现
 // ==========================================
@@ -640,6 +1078,46 @@ V ShardedCache<K, V, EnableCacheAlign>::update_in_place(const K &key,
   return new_val;
 }
 
+template <typename K, typename V, bool EnableCacheAlign>
+int64_t ShardedCache<K, V, EnableCacheAlign>::ttl(const K &key) {
+  size_t shard_idx = get_shard_index(key);
+
+  if (isShardDisabled(shard_idx)) {
+    return -2; // 分片被禁用
+  }
+
+  try {
+    int64_t result = shards_[shard_idx]->ttl(key);
+    recordShardSuccess(shard_idx);
+    return result;
+  } catch (const std::exception &e) {
+    recordShardError(shard_idx);
+    return -2;
+  }
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+bool ShardedCache<K, V, EnableCacheAlign>::expire(const K &key,
+                                                  int64_t ttl_ms) {
+  std::shared_lock<std::shared_mutex> consistency_lock(
+      global_consistency_lock_);
+
+  size_t shard_idx = get_shard_index(key);
+
+  if (isShardDisabled(shard_idx)) {
+    return false; // 分片被禁用
+  }
+
+  try {
+    bool result = shards_[shard_idx]->expire(key, ttl_ms);
+    recordShardSuccess(shard_idx);
+    return result;
+  } catch (const std::exception &e) {
+    recordShardError(shard_idx);
+    return false;
+  }
+}
+
 template <typename K, typename V, bool EnableCacheAlign>
 bool ShardedCache<K, V, EnableCacheAlign>::remove(const K &key) {
   std::shared_lock<std::shared_mutex> consistency_lock(
@@ -906,6 +1384,17 @@ void ShardedCache<K, V, EnableCacheAlign>::vectorPut(
   put(key, serialized_vec, ttl_ms);
 }
 
+template <typename K, typename V, bool EnableCacheAlign>
+void ShardedCache<K, V, EnableCacheAlign>::vectorPutRaw(const K &key,
+                                                        const V &raw,
+                                                        int64_t ttl_ms) {
+  if (raw.empty() || raw.size() % sizeof(float) != 0) {
+    throw std::invalid_argument("vectorPutRaw: size must be a positive "
+                                "multiple of sizeof(float)");
+  }
+  put(key, raw, ttl_ms);
+}
+
 template <typename K, typename V, bool EnableCacheAlign>
 std::vector<float>
 ShardedCache<K, V, EnableCacheAlign>::vectorGet(const K &key) {
@@ -920,7 +1409,37 @@ ShardedCache<K, V, EnableCacheAlign>::vectorGet(const K &key) {
 
 template <typename K, typename V, bool EnableCacheAlign>
 std::vector<K> ShardedCache<K, V, EnableCacheAlign>::vectorSearch(
-    const std::vector<float> &query, int k) {
+    const std::vector<float> &query, int k,
+    const base::CancellationToken &cancel) {
+  return vectorSearch(query.data(), query.size(), k, cancel);
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+std::vector<K> ShardedCache<K, V, EnableCacheAlign>::vectorSearch(
+    const float *query, size_t dim, int k,
+    const base::CancellationToken &cancel) {
+  return std::move(
+      searchVectors({VectorQuery{query, dim}}, k, cancel).front());
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+std::vector<std::vector<K>>
+ShardedCache<K, V, EnableCacheAlign>::vectorSearchBatch(
+    const std::vector<std::vector<float>> &queries, int k,
+    const base::CancellationToken &cancel) {
+  std::vector<VectorQuery> views;
+  views.reserve(queries.size());
+  for (const auto &q : queries) {
+    views.push_back(VectorQuery{q.data(), q.size()});
+  }
+  return searchVectors(views, k, cancel);
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+std::vector<std::vector<K>>
+ShardedCache<K, V, EnableCacheAlign>::searchVectors(
+    const std::vector<VectorQuery> &queries, int k,
+    const base::CancellationToken &cancel) {
   struct SearchResult {
     K key;
     float distance;
@@ -931,64 +1450,84 @@ std::vector<K> ShardedCache<K, V, EnableCacheAlign>::vectorSearch(
       return distance < other.distance; // 大顶堆
     }
   };
+  using Heap = std::priority_queue<SearchResult>;
+  const size_t nq = queries.size();
 
-  // 并行搜索所有分片
-  std::vector<std::future<std::vector<SearchResult>>> futures;
+  // 并行搜索所有分片：每个分片快照一次，逐条记录对所有查询计算距离
+  std::vector<std::future<std::vector<std::vector<SearchResult>>>> futures;
 
   for (size_t shard_idx = 0; shard_idx < shards_.size(); ++shard_idx) {
     if (isShardDisabled(shard_idx)) {
       continue; // 跳过被禁用的分片
     }
 
-    futures.push_back(
-        std::async(std::launch::async, [this, shard_idx, &query, k]() {
-          std::vector<SearchResult> local_results;
-          std::priority_queue<SearchResult> heap;
-
-          try {
-            auto all_data = shards_[shard_idx]->get_all();
-
-            for (const auto &[key, raw_data] : all_data) {
-              auto vec_data = VectorOps::DeserializeCopy(raw_data);
+    futures.push_back(std::async(std::launch::async, [this, shard_idx,
+                                                      &queries, nq, k,
+                                                      &cancel]() {
+      std::vector<std::vector<SearchResult>> local_results(nq);
+      std::vector<Heap> heaps(nq);
 
-              if (vec_data.empty() || vec_data.size() != query.size()) {
-                continue; // 维度不匹配
-              }
+      try {
+        if (cancel.cancelled()) {
+          return local_results; // 还没轮到这个分片就已取消，连快照都不做
+        }
+        auto all_data = shards_[shard_idx]->get_all();
 
-              float distance = VectorOps::L2DistanceSquare(
-                  query.data(), vec_data.data(), vec_data.size());
+        size_t scanned = 0;
+        for (const auto &[key, raw_data] : all_data) {
+          // 取消后保留已扫描部分的局部 Top-K
+          if (++scanned % kCancelCheckInterval == 0 && cancel.cancelled()) {
+            break;
+          }
+          // get_all 已拷贝出数据，这里直接按 float 视图计算
+          size_t vec_dim = 0;
+          const float *vec_data = VectorOps::DeserializeView(raw_data, vec_dim);
+          if (!vec_data || vec_dim == 0) {
+            continue;
+          }
 
-              heap.push(SearchResult(key, distance));
-              if ((int)heap.size() > k) {
-                heap.pop();
-              }
+          for (size_t q = 0; q < nq; ++q) {
+            if (vec_dim != queries[q].dim) {
+              continue; // 维度不匹配
             }
-
-            while (!heap.empty()) {
-              local_results.push_back(heap.top());
-              heap.pop();
+            float distance =
+                VectorOps::L2DistanceSquare(queries[q].data, vec_data, vec_dim);
+            heaps[q].push(SearchResult(key, distance));
+            if ((int)heaps[q].size() > k) {
+              heaps[q].pop();
             }
+          }
+        }
 
-          } catch (const std::exception &e) {
-            // 单个分片错误不影响整体搜索
-            std::cerr << "[VectorSearch] Shard " << shard_idx
-                      << " error: " << e.what() << std::endl;
+        for (size_t q = 0; q < nq; ++q) {
+          while (!heaps[q].empty()) {
+            local_results[q].push_back(heaps[q].top());
+            heaps[q].pop();
           }
+        }
+
+      } catch (const std::exception &e) {
+        // 单个分片错误不影响整体搜索
+        std::cerr << "[VectorSearch] Shard " << shard_idx
+                  << " error: " << e.what() << std::endl;
+      }
 
-          return local_results;
-        }));
+      return local_results;
+    }));
   }
 
   // 收集所有分片结果
-  std::priority_queue<SearchResult> global_heap;
+  std::vector<Heap> global_heaps(nq);
 
   for (auto &f : futures) {
     try {
       auto shard_results = f.get();
-      for (const auto &res : shard_results) {
-        global_heap.push(res);
-        if ((int)global_heap.size() > k) {
-          global_heap.pop();
+      for (size_t q = 0; q < nq; ++q) {
+        for (const auto &res : shard_results[q]) {
+          global_heaps[q].push(res);
+          if ((int)global_heaps[q].size() > k) {
+            global_heaps[q].pop();
+          }
         }
       }
     } catch (const std::exception &e) {
@@ -997,12 +1536,15 @@ std::vector<K> ShardedCache<K, V, EnableCacheAlign>::vectorSearch(
   }
 
   // 整理最终结果
-  std::vector<K> final_results;
-  while (!global_heap.empty()) {
-    final_results.push_back(global_heap.top().key);
-    global_heap.pop();
+  std::vector<std::vector<K>> final_results(nq);
+  for (size_t q = 0; q < nq; ++q) {
+    auto &heap = global_heaps[q];
+    while (!heap.empty()) {
+      final_results[q].push_back(heap.top().key);
+      heap.pop();
+    }
+    std::reverse(final_results[q].begin(), final_results[q].end());
   }
-  std::reverse(final_results.begin(), final_results.end());
 
   return final_results;
 }
@@ -1215,6 +1757,16 @@ ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::get(const K &key) {
   return cache_->get(key);
 }
 
+template <typename K, typename V, bool EnableCacheAlign>
+void ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::get_batch(
+    const std::vector<K> &keys, const std::vector<size_t> &idx,
+    std::vector<std::optional<V>> &out) {
+  std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
+  for (size_t i : idx) {
+    out[i] = cache_->get(keys[i]);
+  }
+}
+
 template <typename K, typename V, bool EnableCacheAlign>
 void ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::put(
     const K &key, const V &value, int64_t ttl_ms) {
@@ -1222,6 +1774,25 @@ void ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::put(
   cache_->put(key, value, ttl_ms);
 }
 
+template <typename K, typename V, bool EnableCacheAlign>
+void ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::put_batch(
+    const std::vector<const std::pair<K, V> *> &items, int64_t ttl_ms) {
+  std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
+  for (const auto *item : items) {
+    cache_->put(item->first, item->second, ttl_ms);
+  }
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+void ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::remove_batch(
+    const std::vector<K> &keys, const std::vector<size_t> &idx,
+    std::vector<bool> &out) {
+  std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
+  for (size_t i : idx) {
+    out[i] = cache_->remove(keys[i]);
+  }
+}
+
 template <typename K, typename V, bool EnableCacheAlign>
 bool ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::remove(
     const K &key) {
@@ -1229,6 +1800,20 @@ bool ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::remove(
   return cache_->remove(key);
 }
 
+template <typename K, typename V, bool EnableCacheAlign>
+int64_t
+ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::ttl(const K &key) {
+  std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
+  return cache_->ttl(key);
+}
+
+template <typename K, typename V, bool EnableCacheAlign>
+bool ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::expire(
+    const K &key, int64_t ttl_ms) {
+  std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
+  return cache_->expire(key, ttl_ms);
+}
+
 template <typename K, typename V, bool EnableCacheAlign>
 size_t ShardedCache<K, V, EnableCacheAlign>::EnhancedLruShard::size() const {
   std::lock_guard<std::mutex> lock(mutex_wrapper_.mutex);
@@ -0,0 +1,86 @@
+#include "degree_stats.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace minkv {
+namespace graph {
+
+namespace {
+
+/** 度数所在的桶：0 → 0，[2^(i-1), 2^i) → i */
+size_t BucketOf(uint64_t degree) {
+  size_t bucket = 0;
+  while (degree > 0) {
+    degree >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void AddToBucket(std::vector<uint64_t> &buckets, uint64_t degree) {
+  size_t b = BucketOf(degree);
+  if (buckets.size() <= b)
+    buckets.resize(b + 1, 0);
+  ++buckets[b];
+}
+
+} // namespace
+
+DegreeTracker::Stripe &DegreeTracker::StripeOf(const std::string &node_id) {
+  return stripes_[std::hash<std::string>{}(node_id) % STRIPES];
+}
+
+const DegreeTracker::Stripe &
+DegreeTracker::StripeOf(const std::string &node_id) const {
+  return stripes_[std::hash<std::string>{}(node_id) % STRIPES];
+}
+
+void DegreeTracker::Set(const std::string &node_id, bool outgoing,
+                        uint64_t degree) {
+  Stripe &s = StripeOf(node_id);
+  std::lock_guard<std::mutex> lock(s.mu);
+  auto it = s.degrees.find(node_id);
+  if (it == s.degrees.end()) {
+    if (degree == 0)
+      return;
+    it = s.degrees.emplace(node_id, NodeDegree{}).first;
+  }
+  (outgoing ? it->second.out : it->second.in) = degree;
+  // 出入度都归零的节点不再占用内存
+  if (it->second.total() == 0)
+    s.degrees.erase(it);
+}
+
+NodeDegree DegreeTracker::Get(const std::string &node_id) const {
+  const Stripe &s = StripeOf(node_id);
+  std::lock_guard<std::mutex> lock(s.mu);
+  auto it = s.degrees.find(node_id);
+  return it == s.degrees.end() ? NodeDegree{} : it->second;
+}
+
+DegreeHistogram DegreeTracker::Histogram() const {
+  DegreeHistogram h;
+  for (const auto &s : stripes_) {
+    std::lock_guard<std::mutex> lock(s.mu);
+    for (const auto &[id, d] : s.degrees) {
+      AddToBucket(h.out, d.out);
+      AddToBucket(h.in, d.in);
+      ++h.nodes;
+      h.edges += d.out;
+      h.max_out = std::max(h.max_out, d.out);
+      h.max_in = std::max(h.max_in, d.in);
+    }
+  }
+  return h;
+}
+
+void DegreeTracker::Clear() {
+  for (auto &s : stripes_) {
+    std::lock_guard<std::mutex> lock(s.mu);
+    s.degrees.clear();
+  }
+}
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace minkv {
+namespace graph {
+
+/** 节点度数（多重边按条数计） */
+struct NodeDegree {
+  uint64_t out = 0;
+  uint64_t in = 0;
+
+  uint64_t total() const { return out + in; }
+};
+
+/**
+ * 度数直方图（按 2 的幂分桶）
+ *
+ * buckets[0] 为度数 0，buckets[i]（i ≥ 1）为度数 [2^(i-1), 2^i)。
+ * 只统计至少有一条边的节点：孤立节点不出现在任何桶中。
+ */
+struct DegreeHistogram {
+  std::vector<uint64_t> out;
+  std::vector<uint64_t> in;
+  uint64_t nodes = 0;       // 至少有一条边的节点数
+  uint64_t edges = 0;       // 出边条目总数（= 边数）
+  uint64_t max_out = 0;
+  uint64_t max_in = 0;
+  uint64_t paged_lists = 0; // 已转为分页存储的邻接表数
+};
+
+/**
+ * DegreeTracker — 每个节点的出度 / 入度
+ *
+ * 邻接表写操作完成后直接写入新的条目数（而不是 ±1 增量），
+ * 即使某次写入没有改变条目数（覆盖权重）也是幂等的。
+ * 按 node_id 哈希分成 STRIPES 段，每段一把互斥锁，查询 O(1)。
+ */
+class DegreeTracker {
+public:
+  static constexpr size_t STRIPES = 64;
+
+  /** 记录 node_id 的出度（outgoing=true）或入度 */
+  void Set(const std::string &node_id, bool outgoing, uint64_t degree);
+
+  NodeDegree Get(const std::string &node_id) const;
+
+  /** 遍历全部节点生成直方图，O(节点数) */
+  DegreeHistogram Histogram() const;
+
+  void Clear();
+
+private:
+  struct Stripe {
+    mutable std::mutex mu;
+    std::unordered_map<std::string, NodeDegree> degrees;
+  };
+  std::array<Stripe, STRIPES> stripes_;
+
+  Stripe &StripeOf(const std::string &node_id);
+  const Stripe &StripeOf(const std::string &node_id) const;
+};
+
+} // namespace graph
+} // namespace minkv
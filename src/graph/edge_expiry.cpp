@@ -0,0 +1,48 @@
+#include "edge_expiry.h"
+
+namespace minkv {
+namespace graph {
+
+void EdgeExpiryQueue::Add(const std::string &src_id, const std::string &dst_id,
+                          const std::string &label, int64_t valid_to) {
+  Stripe &s = stripes_[std::hash<std::string>{}(src_id) % STRIPES];
+  std::lock_guard<std::mutex> lock(s.mu);
+  s.heap.push({valid_to, src_id, dst_id, label});
+}
+
+bool EdgeExpiryQueue::PopExpired(size_t stripe, int64_t cutoff, size_t max,
+                                 bool blocking,
+                                 std::vector<ExpiringEdge> &out) {
+  Stripe &s = stripes_[stripe % STRIPES];
+  std::unique_lock<std::mutex> lock(s.mu, std::defer_lock);
+  if (blocking)
+    lock.lock();
+  else if (!lock.try_lock())
+    return false;
+  for (size_t n = 0; n < max && !s.heap.empty(); ++n) {
+    if (s.heap.top().valid_to > cutoff)
+      break;
+    out.push_back(s.heap.top());
+    s.heap.pop();
+  }
+  return true;
+}
+
+size_t EdgeExpiryQueue::Size() const {
+  size_t n = 0;
+  for (const auto &s : stripes_) {
+    std::lock_guard<std::mutex> lock(s.mu);
+    n += s.heap.size();
+  }
+  return n;
+}
+
+void EdgeExpiryQueue::Clear() {
+  for (auto &s : stripes_) {
+    std::lock_guard<std::mutex> lock(s.mu);
+    s.heap = {};
+  }
+}
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace minkv {
+namespace graph {
+
+/** 边过期清理配置 */
+struct EdgeExpirationOptions {
+  std::chrono::milliseconds check_interval{100}; // 后台检查间隔
+  size_t sample_size = 20; // 每个分片每轮最多下线的边数
+  // valid_to 之后再保留多久才下线；保留期内 as_of 查询仍能看到这些边
+  int64_t retention_ms = 0;
+  // 当前时刻，与有效期同一单位；为空时取 Unix 毫秒
+  std::function<int64_t()> now;
+};
+
+/** 边过期清理统计 */
+struct EdgeExpirationStats {
+  size_t pending = 0;   // 队列中等待到期的边（含已失效的过时条目）
+  uint64_t retired = 0; // 已下线的边
+};
+
+/** 一条待下线的边 */
+struct ExpiringEdge {
+  int64_t valid_to = 0;
+  std::string src_id;
+  std::string dst_id;
+  std::string label;
+};
+
+/**
+ * EdgeExpiryQueue — 按 valid_to 排序的待下线边
+ *
+ * 按起点哈希分成 STRIPES 个分片，每片一个最小堆，与 ExpirationManager
+ * 的分片回调一一对应；只记录 valid_to 有限的边。边被覆盖或删除时不在
+ * 队列里查找清理，出队后由调用方核对 e: 记录，过时的条目直接丢弃。
+ */
+class EdgeExpiryQueue {
+public:
+  static constexpr size_t STRIPES = 16;
+
+  void Add(const std::string &src_id, const std::string &dst_id,
+           const std::string &label, int64_t valid_to);
+
+  /**
+   * 从分片 stripe 取出 valid_to <= cutoff 的条目，最多 max 条，追加到 out
+   * blocking 为 false 时只 try_lock，锁被占用时返回 false
+   */
+  bool PopExpired(size_t stripe, int64_t cutoff, size_t max, bool blocking,
+                  std::vector<ExpiringEdge> &out);
+
+  size_t Size() const;
+
+  void Clear();
+
+private:
+  struct Later {
+    bool operator()(const ExpiringEdge &a, const ExpiringEdge &b) const {
+      return a.valid_to > b.valid_to;
+    }
+  };
+
+  struct Stripe {
+    mutable std::mutex mu;
+    std::priority_queue<ExpiringEdge, std::vector<ExpiringEdge>, Later> heap;
+  };
+
+  std::array<Stripe, STRIPES> stripes_;
+};
+
+} // namespace graph
+} // namespace minkv
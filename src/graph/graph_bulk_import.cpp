@@ -0,0 +1,406 @@
+#include "graph_bulk_import.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "graph_serializer.h"
+
+namespace minkv {
+namespace graph {
+
+namespace {
+
+constexpr char BINARY_MAGIC[4] = {'M', 'K', 'V', 'E'};
+constexpr uint32_t BINARY_VERSION = 1;
+
+[[noreturn]] void Fail(const char *format, size_t line,
+                       const std::string &what) {
+  throw std::runtime_error(std::string("GraphEdgeReader: ") + format +
+                           " line " + std::to_string(line) + ": " + what);
+}
+
+// ── JSONL：扁平对象解析 ──────────────────────────────────────────────────────
+//
+// 只需要支持边记录这一种形状：顶层对象，值为字符串 / 数字 / 内嵌对象。
+// 内嵌对象和数组不展开，原样截取其文本（properties_json 直接存这段文本）。
+
+class FlatJsonParser {
+public:
+  FlatJsonParser(const std::string &text, size_t line)
+      : s_(text), line_(line) {}
+
+  Edge ParseEdge() {
+    Edge edge;
+    bool has_src = false, has_dst = false, has_label = false;
+
+    SkipWs();
+    Expect('{');
+    SkipWs();
+    if (Peek() == '}') {
+      Fail("JSONL", line_, "empty object");
+    }
+    while (true) {
+      SkipWs();
+      std::string key = ParseString();
+      SkipWs();
+      Expect(':');
+      SkipWs();
+
+      if (key == "src_id") {
+        edge.src_id = ParseString();
+        has_src = true;
+      } else if (key == "dst_id") {
+        edge.dst_id = ParseString();
+        has_dst = true;
+      } else if (key == "label") {
+        edge.label = ParseString();
+        has_label = true;
+      } else if (key == "weight") {
+        edge.weight = ParseNumber();
+      } else if (key == "properties_json") {
+        edge.properties_json = Peek() == '"' ? ParseString() : ParseRaw();
+      } else if (key == "valid_from") {
+        edge.valid_from = ParseInt64();
+      } else if (key == "valid_to") {
+        edge.valid_to = ParseInt64();
+      } else {
+        ParseRaw(); // 未知字段：跳过
+      }
+
+      SkipWs();
+      char c = Next();
+      if (c == '}')
+        break;
+      if (c != ',')
+        Fail("JSONL", line_, "expected ',' or '}'");
+    }
+
+    if (!has_src || !has_dst || !has_label) {
+      Fail("JSONL", line_, "missing src_id/dst_id/label");
+    }
+    if (edge.valid_from >= edge.valid_to) {
+      Fail("JSONL", line_, "valid_from must be < valid_to");
+    }
+    return edge;
+  }
+
+private:
+  const std::string &s_;
+  size_t pos_ = 0;
+  size_t line_;
+
+  char Peek() const { return pos_ < s_.size() ? s_[pos_] : '\0'; }
+
+  char Next() {
+    if (pos_ >= s_.size())
+      Fail("JSONL", line_, "unexpected end of line");
+    return s_[pos_++];
+  }
+
+  void Expect(char c) {
+    if (Next() != c)
+      Fail("JSONL", line_, std::string("expected '") + c + "'");
+  }
+
+  void SkipWs() {
+    while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\t' ||
+                                s_[pos_] == '\r' || s_[pos_] == '\n')) {
+      ++pos_;
+    }
+  }
+
+  static void AppendUtf8(std::string &out, uint32_t cp) {
+    if (cp < 0x80) {
+      out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      out += static_cast<char>(0xC0 | (cp >> 6));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+      out += static_cast<char>(0xE0 | (cp >> 12));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (cp >> 18));
+      out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+  }
+
+  uint32_t ParseHex4() {
+    if (pos_ + 4 > s_.size())
+      Fail("JSONL", line_, "truncated \\u escape");
+    uint32_t cp = 0;
+    for (int i = 0; i < 4; ++i) {
+      char c = s_[pos_++];
+      cp <<= 4;
+      if (c >= '0' && c <= '9')
+        cp |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+        cp |= c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+        cp |= c - 'A' + 10;
+      else
+        Fail("JSONL", line_, "bad \\u escape");
+    }
+    return cp;
+  }
+
+  std::string ParseString() {
+    Expect('"');
+    std::string out;
+    while (true) {
+      char c = Next();
+      if (c == '"')
+        return out;
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      char esc = Next();
+      switch (esc) {
+      case '"':
+      case '\\':
+      case '/':
+        out += esc;
+        break;
+      case 'b':
+        out += '\b';
+        break;
+      case 'f':
+        out += '\f';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u': {
+        uint32_t cp = ParseHex4();
+        // UTF-16 代理对
+        if (cp >= 0xD800 && cp <= 0xDBFF && pos_ + 1 < s_.size() &&
+            s_[pos_] == '\\' && s_[pos_ + 1] == 'u') {
+          pos_ += 2;
+          uint32_t low = ParseHex4();
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        AppendUtf8(out, cp);
+        break;
+      }
+      default:
+        Fail("JSONL", line_, "bad escape");
+      }
+    }
+  }
+
+  std::string ScanNumber() {
+    size_t start = pos_;
+    while (pos_ < s_.size() && s_[pos_] != ',' && s_[pos_] != '}' &&
+           s_[pos_] != ' ' && s_[pos_] != '\t') {
+      ++pos_;
+    }
+    return s_.substr(start, pos_ - start);
+  }
+
+  float ParseNumber() {
+    try {
+      return std::stof(ScanNumber());
+    } catch (const std::exception &) {
+      Fail("JSONL", line_, "bad number");
+    }
+  }
+
+  int64_t ParseInt64() {
+    std::string text = ScanNumber();
+    try {
+      size_t used = 0;
+      long long v = std::stoll(text, &used);
+      if (used == text.size())
+        return v;
+    } catch (const std::exception &) {
+    }
+    Fail("JSONL", line_, "bad integer '" + text + "'");
+  }
+
+  /** 截取一个任意 JSON 值的原始文本（对象/数组按括号配对，跳过字符串） */
+  std::string ParseRaw() {
+    size_t start = pos_;
+    if (Peek() == '"') {
+      ParseString();
+      return s_.substr(start, pos_ - start);
+    }
+    if (Peek() != '{' && Peek() != '[') {
+      // 数字 / true / false / null
+      while (pos_ < s_.size() && s_[pos_] != ',' && s_[pos_] != '}')
+        ++pos_;
+      size_t end = pos_;
+      while (end > start && (s_[end - 1] == ' ' || s_[end - 1] == '\t'))
+        --end;
+      return s_.substr(start, end - start);
+    }
+
+    int depth = 0;
+    bool in_string = false;
+    while (pos_ < s_.size()) {
+      char c = s_[pos_++];
+      if (in_string) {
+        if (c == '\\')
+          ++pos_;
+        else if (c == '"')
+          in_string = false;
+      } else if (c == '"') {
+        in_string = true;
+      } else if (c == '{' || c == '[') {
+        ++depth;
+      } else if (c == '}' || c == ']') {
+        if (--depth == 0)
+          return s_.substr(start, pos_ - start);
+      }
+    }
+    Fail("JSONL", line_, "unterminated object");
+  }
+};
+
+} // namespace
+
+// ══════════════════════════════════════════════════════════════════════════════
+// CSV
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::vector<Edge> GraphEdgeReader::ReadCsv(std::istream &in) {
+  std::vector<Edge> edges;
+  std::string line;
+  size_t line_no = 0;
+
+  while (std::getline(in, line)) {
+    ++line_no;
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (line_no == 1 && line.compare(0, 7, "src_id,") == 0)
+      continue; // 表头
+
+    // 前三个字段必填，第四个字段可选，之后的全部内容都是 properties_json
+    size_t c1 = line.find(',');
+    size_t c2 = c1 == std::string::npos ? c1 : line.find(',', c1 + 1);
+    if (c2 == std::string::npos)
+      Fail("CSV", line_no, "expected src_id,dst_id,label");
+    size_t c3 = line.find(',', c2 + 1);
+
+    Edge edge;
+    edge.src_id = line.substr(0, c1);
+    edge.dst_id = line.substr(c1 + 1, c2 - c1 - 1);
+    if (c3 == std::string::npos) {
+      edge.label = line.substr(c2 + 1);
+    } else {
+      edge.label = line.substr(c2 + 1, c3 - c2 - 1);
+      size_t c4 = line.find(',', c3 + 1);
+      std::string weight = line.substr(
+          c3 + 1, c4 == std::string::npos ? std::string::npos : c4 - c3 - 1);
+      if (!weight.empty()) {
+        try {
+          edge.weight = std::stof(weight);
+        } catch (const std::exception &) {
+          Fail("CSV", line_no, "bad weight '" + weight + "'");
+        }
+      }
+      if (c4 != std::string::npos)
+        edge.properties_json = line.substr(c4 + 1);
+    }
+    edges.push_back(std::move(edge));
+  }
+  return edges;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// JSONL
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::vector<Edge> GraphEdgeReader::ReadJsonl(std::istream &in) {
+  std::vector<Edge> edges;
+  std::string line;
+  size_t line_no = 0;
+
+  while (std::getline(in, line)) {
+    ++line_no;
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    edges.push_back(FlatJsonParser(line, line_no).ParseEdge());
+  }
+  return edges;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// BINARY
+//
+// 记录体直接复用 GraphSerializer::SerializeEdge 的布局，
+// 外层加 4 字节记录长度，读取时无需逐字段解析边界。
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::vector<Edge> GraphEdgeReader::ReadBinary(std::istream &in) {
+  char magic[4];
+  uint32_t version = 0;
+  uint64_t count = 0;
+  in.read(magic, 4);
+  in.read(reinterpret_cast<char *>(&version), sizeof(version));
+  in.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!in || std::memcmp(magic, BINARY_MAGIC, 4) != 0)
+    Fail("BINARY", 0, "bad header");
+  if (version != BINARY_VERSION)
+    Fail("BINARY", 0, "unsupported version " + std::to_string(version));
+
+  std::vector<Edge> edges;
+  edges.reserve(count);
+  std::string record;
+  for (uint64_t i = 0; i < count; ++i) {
+    uint32_t len = 0;
+    in.read(reinterpret_cast<char *>(&len), sizeof(len));
+    record.resize(len);
+    in.read(record.data(), len);
+    if (!in)
+      Fail("BINARY", i + 1, "truncated record");
+    edges.push_back(GraphSerializer::DeserializeEdge(record));
+  }
+  return edges;
+}
+
+void GraphEdgeReader::WriteBinary(std::ostream &out,
+                                  const std::vector<Edge> &edges) {
+  uint64_t count = edges.size();
+  out.write(BINARY_MAGIC, 4);
+  out.write(reinterpret_cast<const char *>(&BINARY_VERSION),
+            sizeof(BINARY_VERSION));
+  out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  for (const auto &edge : edges) {
+    std::string record = GraphSerializer::SerializeEdge(edge);
+    uint32_t len = static_cast<uint32_t>(record.size());
+    out.write(reinterpret_cast<const char *>(&len), sizeof(len));
+    out.write(record.data(), record.size());
+  }
+}
+
+std::vector<Edge> GraphEdgeReader::ReadFile(const std::string &path,
+                                            EdgeFileFormat format) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    throw std::runtime_error("GraphEdgeReader: cannot open " + path);
+  switch (format) {
+  case EdgeFileFormat::CSV:
+    return ReadCsv(in);
+  case EdgeFileFormat::JSONL:
+    return ReadJsonl(in);
+  case EdgeFileFormat::BINARY:
+    return ReadBinary(in);
+  }
+  throw std::runtime_error("GraphEdgeReader: unknown format");
+}
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "graph_types.h"
+
+namespace minkv {
+namespace graph {
+
+/**
+ * 批量导入支持的边文件格式
+ *
+ *   CSV    — 每行 src_id,dst_id,label[,weight[,properties_json]]
+ *            properties_json 取第 4 个逗号之后的全部内容（可含逗号）；
+ *            空行、'#' 开头的注释行、以 "src_id," 开头的表头行会被跳过
+ *   JSONL  — 每行一个 JSON 对象：
+ *            {"src_id":"a","dst_id":"b","label":"L","weight":1.0,
+ *             "properties_json":{...},"valid_from":0,"valid_to":100}
+ *            properties_json 可以是字符串，也可以是内嵌对象（原样保留其文本）；
+ *            valid_from / valid_to 是可选的整数有效期
+ *   BINARY — [4B magic "MKVE"][4B version=1][8B edge_count]
+ *            之后每条边 [4B record_len][GraphSerializer::SerializeEdge 字节]
+ */
+enum class EdgeFileFormat { CSV, JSONL, BINARY };
+
+/** 批量导入统计 */
+struct BulkImportStats {
+  size_t edges_read = 0;        // 输入的边数
+  size_t edges_written = 0;     // 去重后写入的边数（同一三元组后者覆盖前者）
+  size_t adj_lists_written = 0; // 写入的 adj:out / adj:in Key 数
+  double parse_ms = 0.0;        // 解析文件耗时（BulkImportEdges 为 0）
+  double sort_ms = 0.0;         // 并行排序耗时
+  double write_ms = 0.0;        // 构建邻接表 + 写 KV 耗时
+  double snapshot_ms = 0.0;     // 结束时快照耗时
+};
+
+/**
+ * GraphEdgeReader — 批量导入的边文件解析器
+ *
+ * 只负责"文件 -> std::vector<Edge>"，不接触 KV；
+ * 格式错误时抛出 std::runtime_error，消息中带行号（二进制格式带记录序号）。
+ * 与 GraphSerializer 一样不依赖第三方 JSON 库，JSONL 只解析扁平对象。
+ */
+class GraphEdgeReader {
+public:
+  static std::vector<Edge> ReadCsv(std::istream &in);
+
+  static std::vector<Edge> ReadJsonl(std::istream &in);
+
+  static std::vector<Edge> ReadBinary(std::istream &in);
+
+  /** 按 format 打开并解析文件；文件无法打开时抛异常 */
+  static std::vector<Edge> ReadFile(const std::string &path,
+                                    EdgeFileFormat format);
+
+  /** 写出 BINARY 格式的边文件（导出工具 / 测试数据生成用） */
+  static void WriteBinary(std::ostream &out, const std::vector<Edge> &edges);
+};
+
+} // namespace graph
+} // namespace minkv
@@ -1,7 +1,9 @@
 #include "graph_serializer.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <tuple>
 
 namespace minkv {
 namespace graph {
@@ -29,7 +31,7 @@ void GraphSerializer::AppendUint32LE(std::string &buf, uint32_t val) {
  * 从 buf 的 offset 位置读取 4 字节，按小端序还原为 uint32_t。
  * 如果剩余字节不足 4 个，抛出 runtime_error。
  */
-uint32_t GraphSerializer::ReadUint32LE(const std::string &buf, size_t offset) {
+uint32_t GraphSerializer::ReadUint32LE(std::string_view buf, size_t offset) {
   if (offset + 4 > buf.size()) {
     throw std::runtime_error(
         "GraphSerializer: buffer too short reading uint32");
@@ -42,6 +44,18 @@ uint32_t GraphSerializer::ReadUint32LE(const std::string &buf, size_t offset) {
          (static_cast<uint32_t>(p[3]) << 24);
 }
 
+void GraphSerializer::AppendInt64LE(std::string &buf, int64_t val) {
+  uint64_t u = static_cast<uint64_t>(val);
+  AppendUint32LE(buf, static_cast<uint32_t>(u & 0xFFFFFFFFu));
+  AppendUint32LE(buf, static_cast<uint32_t>(u >> 32));
+}
+
+int64_t GraphSerializer::ReadInt64LE(std::string_view buf, size_t offset) {
+  uint64_t lo = ReadUint32LE(buf, offset);
+  uint64_t hi = ReadUint32LE(buf, offset + 4);
+  return static_cast<int64_t>(lo | (hi << 32));
+}
+
 /**
  * 从 buf 的 offset 位置读取一个"长度前缀字符串"：
  *   先读 4 字节得到字符串长度 len，再读 len 字节得到字符串内容。
@@ -60,6 +74,19 @@ std::string GraphSerializer::ReadString(const std::string &buf,
   return s;
 }
 
+std::string_view GraphSerializer::ReadStringView(std::string_view buf,
+                                                 size_t &offset) {
+  uint32_t len = ReadUint32LE(buf, offset);
+  offset += 4;
+  if (offset + len > buf.size()) {
+    throw std::runtime_error(
+        "GraphSerializer: buffer too short reading string");
+  }
+  std::string_view s = buf.substr(offset, len);
+  offset += len;
+  return s;
+}
+
 // ══════════════════════════════════════════════════════════════════════════════
 // Node 序列化 / 反序列化
 //
@@ -89,6 +116,14 @@ Node GraphSerializer::DeserializeNode(const std::string &data) {
   return node;
 }
 
+NodeView GraphSerializer::ViewNode(std::string_view data) {
+  size_t offset = 0;
+  NodeView view;
+  view.node_id = ReadStringView(data, offset);
+  view.properties_json = ReadStringView(data, offset);
+  return view;
+}
+
 // ══════════════════════════════════════════════════════════════════════════════
 // Edge 序列化 / 反序列化
 //
@@ -121,6 +156,11 @@ std::string GraphSerializer::SerializeEdge(const Edge &edge) {
   AppendUint32LE(buf, static_cast<uint32_t>(edge.properties_json.size()));
   buf.append(edge.properties_json);
 
+  // 有效期只在设置时追加，普通边的记录与旧格式完全相同
+  if (edge.IsTemporal()) {
+    AppendInt64LE(buf, edge.valid_from);
+    AppendInt64LE(buf, edge.valid_to);
+  }
   return buf;
 }
 
@@ -141,9 +181,33 @@ Edge GraphSerializer::DeserializeEdge(const std::string &data) {
   offset += 4;
 
   edge.properties_json = ReadString(data, offset);
+  if (data.size() - offset >= 16) {
+    edge.valid_from = ReadInt64LE(data, offset);
+    edge.valid_to = ReadInt64LE(data, offset + 8);
+  }
   return edge;
 }
 
+EdgeView GraphSerializer::ViewEdge(std::string_view data) {
+  size_t offset = 0;
+  EdgeView view;
+  view.src_id = ReadStringView(data, offset);
+  view.dst_id = ReadStringView(data, offset);
+  view.label = ReadStringView(data, offset);
+  if (offset + 4 > data.size()) {
+    throw std::runtime_error(
+        "GraphSerializer: buffer too short reading weight");
+  }
+  std::memcpy(&view.weight, data.data() + offset, 4);
+  offset += 4;
+  view.properties_json = ReadStringView(data, offset);
+  if (data.size() - offset >= 16) {
+    view.valid_from = ReadInt64LE(data, offset);
+    view.valid_to = ReadInt64LE(data, offset + 8);
+  }
+  return view;
+}
+
 // ══════════════════════════════════════════════════════════════════════════════
 // 邻接表序列化 / 反序列化
 //
@@ -204,5 +268,178 @@ GraphSerializer::DeserializeAdjList(const std::string &data) {
   return result;
 }
 
+// ══════════════════════════════════════════════════════════════════════════════
+// 带标签/权重的邻接表（adj:out / adj:in 的实际存储格式）
+//
+// 二进制布局：
+//   [4B count]
+//   对每个条目：
+//     [4B len][neighbor_id][4B len][label][4B float weight]
+//
+// 与纯 ID 列表相比，每条边多存 label 和 weight：
+//   - DeleteEdge 可精确删除 (neighbor, label) 条目，无需边计数器
+//   - 带权最短路径直接从邻接表拿到权重，不必逐条读取 e: Key
+//
+// 带有效期的条目：count 最高位置 1，条目之前插入按 valid_from 排序的
+// 有效期索引 [4B n]{[8B valid_from][8B valid_to][4B 条目下标]}*。
+// 边过期只是 as_of 过滤的结果，不需要改写邻接表；没有有效期的条目
+// 不进索引，普通图的格式和解析开销都不变。
+// ══════════════════════════════════════════════════════════════════════════════
+
+namespace {
+
+constexpr uint32_t TEMPORAL_FLAG = 0x80000000u;
+constexpr size_t TEMPORAL_RECORD_SIZE = 20; // [8B from][8B to][4B 下标]
+constexpr uint32_t NO_INTERVAL = UINT32_MAX;    // 条目没有有效期
+constexpr uint32_t NOT_VALID = UINT32_MAX - 1; // 条目在 as_of 时无效
+
+} // namespace
+
+std::string
+GraphSerializer::SerializeAdjEntries(const std::vector<AdjEntry> &entries) {
+  std::vector<uint32_t> temporal;
+  for (uint32_t i = 0; i < entries.size(); ++i) {
+    if (entries[i].IsTemporal())
+      temporal.push_back(i);
+  }
+
+  // 总大小 = 4（count）+ 有效期索引 + sum(12 + len(neighbor) + len(label))
+  size_t total = 4;
+  if (!temporal.empty())
+    total += 4 + TEMPORAL_RECORD_SIZE * temporal.size();
+  for (const auto &e : entries)
+    total += 12 + e.neighbor_id.size() + e.label.size();
+
+  std::string buf;
+  buf.reserve(total);
+
+  uint32_t count = static_cast<uint32_t>(entries.size());
+  if (temporal.empty()) {
+    AppendUint32LE(buf, count);
+  } else {
+    AppendUint32LE(buf, count | TEMPORAL_FLAG);
+    std::sort(temporal.begin(), temporal.end(), [&](uint32_t a, uint32_t b) {
+      return std::tie(entries[a].valid_from, entries[a].valid_to, a) <
+             std::tie(entries[b].valid_from, entries[b].valid_to, b);
+    });
+    AppendUint32LE(buf, static_cast<uint32_t>(temporal.size()));
+    for (uint32_t i : temporal) {
+      AppendInt64LE(buf, entries[i].valid_from);
+      AppendInt64LE(buf, entries[i].valid_to);
+      AppendUint32LE(buf, i);
+    }
+  }
+  for (const auto &e : entries) {
+    AppendUint32LE(buf, static_cast<uint32_t>(e.neighbor_id.size()));
+    buf.append(e.neighbor_id);
+    AppendUint32LE(buf, static_cast<uint32_t>(e.label.size()));
+    buf.append(e.label);
+    char wbytes[4];
+    std::memcpy(wbytes, &e.weight, 4);
+    buf.append(wbytes, 4);
+  }
+  return buf;
+}
+
+std::vector<AdjEntry>
+GraphSerializer::DeserializeAdjEntries(const std::string &data) {
+  return DeserializeAdjEntries(data, {});
+}
+
+/**
+ * 按标签 / 时刻过滤的反序列化
+ *
+ * 标签过滤遍历（例如只沿 WORKS_AT 走）时，大部分条目会被丢弃；
+ * 先用 string_view 比较 label，命中后才拷贝 neighbor_id / label。
+ * 时刻过滤先在有效期索引上判定：索引按 valid_from 升序，
+ * valid_from > as_of 的条目是一段后缀，二分定位后整段排除，
+ * 其余只比较 valid_to；被排除的条目同样不分配字符串。
+ */
+std::vector<AdjEntry>
+GraphSerializer::DeserializeAdjEntries(const std::string &data,
+                                       const std::vector<std::string> &labels,
+                                       std::optional<int64_t> as_of) {
+  if (data.empty())
+    return {};
+
+  size_t offset = 0;
+  const uint32_t word = ReadUint32LE(data, offset);
+  offset += 4;
+  const uint32_t count = word & ~TEMPORAL_FLAG;
+
+  // slot[i]：条目 i 在有效期索引中的位置，或 NO_INTERVAL / NOT_VALID
+  std::vector<uint32_t> slot;
+  size_t index_at = 0;
+  if (word & TEMPORAL_FLAG) {
+    const uint32_t n = ReadUint32LE(data, offset);
+    offset += 4;
+    if (n > count || (data.size() - offset) / TEMPORAL_RECORD_SIZE < n) {
+      throw std::runtime_error(
+          "GraphSerializer: bad adjacency validity index");
+    }
+    index_at = offset;
+    offset += TEMPORAL_RECORD_SIZE * n;
+    auto from_at = [&](uint32_t k) {
+      return ReadInt64LE(data, index_at + k * TEMPORAL_RECORD_SIZE);
+    };
+
+    uint32_t live_end = n; // [live_end, n) 在 as_of 时尚未生效
+    if (as_of) {
+      uint32_t lo = 0;
+      while (lo < live_end) {
+        uint32_t mid = lo + (live_end - lo) / 2;
+        if (from_at(mid) <= *as_of)
+          lo = mid + 1;
+        else
+          live_end = mid;
+      }
+    }
+    slot.assign(count, NO_INTERVAL);
+    for (uint32_t k = 0; k < n; ++k) {
+      size_t at = index_at + k * TEMPORAL_RECORD_SIZE;
+      uint32_t i = ReadUint32LE(data, at + 16);
+      if (i >= count) {
+        throw std::runtime_error(
+            "GraphSerializer: bad adjacency validity index");
+      }
+      bool valid =
+          !as_of || (k < live_end && ReadInt64LE(data, at + 8) > *as_of);
+      slot[i] = valid ? k : NOT_VALID;
+    }
+  }
+
+  std::vector<AdjEntry> result;
+  if (labels.empty() && !as_of)
+    result.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string_view neighbor = ReadStringView(data, offset);
+    std::string_view label = ReadStringView(data, offset);
+    if (offset + 4 > data.size()) {
+      throw std::runtime_error(
+          "GraphSerializer: buffer too short reading adjacency weight");
+    }
+    const size_t weight_at = offset;
+    offset += 4;
+
+    const uint32_t k = slot.empty() ? NO_INTERVAL : slot[i];
+    if (k == NOT_VALID)
+      continue;
+    if (!labels.empty() &&
+        std::find(labels.begin(), labels.end(), label) == labels.end())
+      continue;
+    AdjEntry e;
+    e.neighbor_id.assign(neighbor);
+    e.label.assign(label);
+    std::memcpy(&e.weight, data.data() + weight_at, 4);
+    if (k != NO_INTERVAL) {
+      size_t at = index_at + k * TEMPORAL_RECORD_SIZE;
+      e.valid_from = ReadInt64LE(data, at);
+      e.valid_to = ReadInt64LE(data, at + 8);
+    }
+    result.push_back(std::move(e));
+  }
+  return result;
+}
+
 } // namespace graph
 } // namespace minkv
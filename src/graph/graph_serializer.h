@@ -4,9 +4,11 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "graph_types.h"
+#include "graph_view.h"
 
 namespace minkv {
 namespace graph {
@@ -22,7 +24,12 @@ namespace graph {
  * 二进制格式（小端序）：
  *   Node:  [4B 长度][node_id 字节][4B 长度][properties_json 字节]
  *   Edge:  [4B][src][4B][dst][4B][label][4B float weight][4B][props]
- *   AdjList: JSON 数组字符串，例如 ["id1","id2"]
+ *          带有效期的边追加 [8B valid_from][8B valid_to]
+ *   AdjList: [4B count]{[4B len][id]}*
+ *   AdjEntries: [4B count]{[4B][neighbor][4B][label][4B float weight]}*
+ *          含带有效期的条目时 count 最高位置 1，条目之前插入有效期索引
+ *          [4B n]{[8B valid_from][8B valid_to][4B 条目下标]}*，按 valid_from
+ *          升序；没有有效期的图格式不变
  */
 class GraphSerializer {
 public:
@@ -34,6 +41,9 @@ public:
   /** 从二进制字符串还原 Node 结构体，读取 KV 后使用；数据损坏时抛异常 */
   static Node DeserializeNode(const std::string &data);
 
+  /** 不拷贝地解析节点记录，视图指向 data 内部；数据损坏时抛异常 */
+  static NodeView ViewNode(std::string_view data);
+
   // ── Edge ──────────────────────────────────────────────────────────────────
 
   /** 将 Edge 结构体序列化为二进制字符串 */
@@ -42,6 +52,9 @@ public:
   /** 从二进制字符串还原 Edge 结构体；数据损坏时抛异常 */
   static Edge DeserializeEdge(const std::string &data);
 
+  /** 不拷贝地解析边记录，视图指向 data 内部；数据损坏时抛异常 */
+  static EdgeView ViewEdge(std::string_view data);
+
   // ── Adjacency List ────────────────────────────────────────────────────────
 
   /**
@@ -74,6 +87,34 @@ public:
     return DeserializeAdjList(*old_val);
   }
 
+  /**
+   * 将带标签/权重的邻接表条目序列化为二进制字符串
+   * adj:out / adj:in 实际使用这种格式，每条边一个条目
+   */
+  static std::string SerializeAdjEntries(const std::vector<AdjEntry> &entries);
+
+  /** 还原邻接表条目；数据损坏时抛出 std::runtime_error */
+  static std::vector<AdjEntry> DeserializeAdjEntries(const std::string &data);
+
+  /**
+   * 只还原 label 属于 labels 的条目（labels 为空时等价于全部还原）
+   * 不匹配的条目只在原缓冲区上比较 label，不分配字符串。
+   * 给定 as_of 时只还原在该时刻有效的条目：有效期索引按 valid_from
+   * 排序，二分找到尚未生效的后缀，只需逐个检查其余区间的 valid_to
+   */
+  static std::vector<AdjEntry>
+  DeserializeAdjEntries(const std::string &data,
+                        const std::vector<std::string> &labels,
+                        std::optional<int64_t> as_of = std::nullopt);
+
+  /** update_in_place 回调专用：nullopt 或空串返回空列表 */
+  static std::vector<AdjEntry>
+  DeserializeAdjEntries(const std::optional<std::string> &old_val) {
+    if (!old_val.has_value() || old_val->empty())
+      return {};
+    return DeserializeAdjEntries(*old_val);
+  }
+
 private:
   // ── 内部工具函数 ──────────────────────────────────────────────────────────
 
@@ -81,7 +122,11 @@ private:
   static void AppendUint32LE(std::string &buf, uint32_t val);
 
   /** 从 buf 的 offset 位置读取一个 uint32_t（小端序） */
-  static uint32_t ReadUint32LE(const std::string &buf, size_t offset);
+  static uint32_t ReadUint32LE(std::string_view buf, size_t offset);
+
+  /** int64_t 版本（有效期时间戳） */
+  static void AppendInt64LE(std::string &buf, int64_t val);
+  static int64_t ReadInt64LE(std::string_view buf, size_t offset);
 
   /**
    * 从 buf 的 offset 位置读取一个"长度前缀字符串"
@@ -89,6 +134,10 @@ private:
    * 读完后 offset 会自动向后移动
    */
   static std::string ReadString(const std::string &buf, size_t &offset);
+
+  /** 同 ReadString，但返回指向 buf 内部的视图，不拷贝 */
+  static std::string_view ReadStringView(std::string_view buf,
+                                         size_t &offset);
 };
 
 } // namespace graph
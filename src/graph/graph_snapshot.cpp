@@ -0,0 +1,309 @@
+#include "graph_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+namespace minkv {
+namespace graph {
+
+namespace {
+
+constexpr char kMagic[4] = {'M', 'K', 'G', 'S'};
+constexpr uint32_t kVersion = 2; // 2: 增加 TEMPORAL_EDGES 段
+constexpr size_t kSections = static_cast<size_t>(GraphSnapshotSection::COUNT);
+constexpr size_t kBlockSize = 4 << 20; // 每攒满 4MB 写一次
+
+// 映射区被直接按 uint64_t / uint32_t / float 数组访问，按宿主字节序写出；
+// 目前支持的平台都是小端，与 GraphSerializer 的约定一致
+struct Header {
+  char magic[4];
+  uint32_t version;
+  uint64_t node_count;
+  uint64_t edge_count;
+  uint64_t label_count;
+  uint64_t file_size;
+  uint64_t checksum;
+  uint64_t sections[kSections];
+};
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t Fnv1a(uint64_t h, const char *p, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    h ^= static_cast<uint8_t>(p[i]);
+    h *= kFnvPrime;
+  }
+  return h;
+}
+
+[[noreturn]] void Fail(const std::string &path, const std::string &what) {
+  throw std::runtime_error("GraphSnapshot: " + path + ": " + what);
+}
+
+[[noreturn]] void FailErrno(const std::string &path, const char *op) {
+  Fail(path, std::string(op) + " failed: " + std::strerror(errno));
+}
+
+} // namespace
+
+// ══════════════════════════════════════════════════════════════════════════════
+// GraphSnapshotReader
+// ══════════════════════════════════════════════════════════════════════════════
+
+GraphSnapshotReader::GraphSnapshotReader(const std::string &path)
+    : path_(path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    FailErrno(path, "open");
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    FailErrno(path, "fstat");
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ < sizeof(Header)) {
+    ::close(fd);
+    Fail(path, "file too small");
+  }
+  void *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // 映射建立后不再需要文件描述符
+  if (addr == MAP_FAILED)
+    FailErrno(path, "mmap");
+  data_ = static_cast<const char *>(addr);
+  ::madvise(addr, size_, MADV_SEQUENTIAL);
+
+  try {
+    Header h;
+    std::memcpy(&h, data_, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, 4) != 0)
+      Fail(path, "bad magic");
+    if (h.version != kVersion)
+      Fail(path, "unsupported version " + std::to_string(h.version));
+    if (h.file_size != size_)
+      Fail(path, "truncated (expected " + std::to_string(h.file_size) +
+                     " bytes, got " + std::to_string(size_) + ")");
+    if (Fnv1a(kFnvOffset, data_ + sizeof(Header), size_ - sizeof(Header)) !=
+        h.checksum)
+      Fail(path, "checksum mismatch");
+
+    node_count_ = h.node_count;
+    edge_count_ = h.edge_count;
+    label_count_ = h.label_count;
+    auto bounds = [&](GraphSnapshotSection s) {
+      size_t i = static_cast<size_t>(s);
+      uint64_t end = i + 1 < kSections ? h.sections[i + 1] : size_;
+      if (h.sections[i] < sizeof(Header) || h.sections[i] > end ||
+          end > size_ || h.sections[i] % 8 != 0)
+        Fail(path, "bad section offset");
+      return std::make_pair(h.sections[i], end);
+    };
+    auto [ids_b, ids_e] = bounds(GraphSnapshotSection::NODE_IDS);
+    node_ids_ = ParseTable(ids_b, ids_e, node_count_);
+    auto [rec_b, rec_e] = bounds(GraphSnapshotSection::NODE_RECORDS);
+    node_records_ = ParseTable(rec_b, rec_e, node_count_);
+    auto [emb_b, emb_e] = bounds(GraphSnapshotSection::EMBEDDINGS);
+    embeddings_ = ParseTable(emb_b, emb_e, node_count_);
+    auto [lab_b, lab_e] = bounds(GraphSnapshotSection::LABELS);
+    labels_ = ParseTable(lab_b, lab_e, label_count_);
+    auto [out_b, out_e] = bounds(GraphSnapshotSection::OUT_CSR);
+    out_ = ParseCsr(out_b, out_e);
+    auto [in_b, in_e] = bounds(GraphSnapshotSection::IN_CSR);
+    in_ = ParseCsr(in_b, in_e);
+    auto [edge_b, edge_e] = bounds(GraphSnapshotSection::EDGE_RECORDS);
+    edge_records_ = ParseTable(edge_b, edge_e, edge_count_);
+    auto [tmp_b, tmp_e] = bounds(GraphSnapshotSection::TEMPORAL_EDGES);
+    ParseTemporal(tmp_b, tmp_e);
+  } catch (...) {
+    ::munmap(const_cast<char *>(data_), size_);
+    throw;
+  }
+}
+
+GraphSnapshotReader::~GraphSnapshotReader() {
+  if (data_)
+    ::munmap(const_cast<char *>(data_), size_);
+}
+
+GraphSnapshotReader::StringTable
+GraphSnapshotReader::ParseTable(uint64_t begin, uint64_t end,
+                                size_t count) const {
+  // 先确认 count 和 offset 数组本身在段内，再检查 offset 单调且不越界
+  if (end - begin < 8)
+    Fail(path_, "string table too small");
+  uint64_t stored;
+  std::memcpy(&stored, data_ + begin, 8);
+  if (stored != count || (end - begin - 8) / 8 < count + 1)
+    Fail(path_, "string table count mismatch");
+
+  StringTable t;
+  t.offsets = reinterpret_cast<const uint64_t *>(data_ + begin + 8);
+  t.bytes = data_ + begin + 8 + 8 * (count + 1);
+  uint64_t limit = end - (begin + 8 + 8 * (count + 1));
+  if (t.offsets[0] != 0)
+    Fail(path_, "bad string table offset");
+  for (size_t i = 0; i < count; ++i) {
+    if (t.offsets[i + 1] < t.offsets[i] || t.offsets[i + 1] > limit)
+      Fail(path_, "bad string table offset");
+  }
+  return t;
+}
+
+GraphSnapshotReader::Csr GraphSnapshotReader::ParseCsr(uint64_t begin,
+                                                       uint64_t end) const {
+  uint64_t n, m;
+  if (end - begin < 8)
+    Fail(path_, "CSR too small");
+  std::memcpy(&n, data_ + begin, 8);
+  if (n != node_count_ || (end - begin - 8) / 8 < n + 2)
+    Fail(path_, "CSR node count mismatch");
+  uint64_t pos = begin + 8 + 8 * (n + 1);
+  std::memcpy(&m, data_ + pos, 8);
+  pos += 8;
+  if (m != edge_count_ || (end - pos) / 12 < m)
+    Fail(path_, "CSR edge count mismatch");
+
+  Csr c;
+  c.row = reinterpret_cast<const uint64_t *>(data_ + begin + 8);
+  c.neighbor = reinterpret_cast<const uint32_t *>(data_ + pos);
+  c.label = c.neighbor + m;
+  c.weight = reinterpret_cast<const float *>(c.label + m);
+  if (c.row[0] != 0 || c.row[n] != m)
+    Fail(path_, "bad CSR row offsets");
+  for (size_t i = 0; i < n; ++i) {
+    if (c.row[i + 1] < c.row[i])
+      Fail(path_, "bad CSR row offsets");
+  }
+  for (size_t k = 0; k < m; ++k) {
+    if (c.neighbor[k] >= n || c.label[k] >= label_count_)
+      Fail(path_, "CSR entry out of range");
+  }
+  return c;
+}
+
+void GraphSnapshotReader::ParseTemporal(uint64_t begin, uint64_t end) {
+  static_assert(sizeof(TemporalEdge) == 32, "TemporalEdge layout");
+  uint64_t count;
+  if (end - begin < 8)
+    Fail(path_, "temporal section too small");
+  std::memcpy(&count, data_ + begin, 8);
+  if (count > edge_count_ || (end - begin - 8) / sizeof(TemporalEdge) < count)
+    Fail(path_, "temporal edge count mismatch");
+  temporal_ = reinterpret_cast<const TemporalEdge *>(data_ + begin + 8);
+  temporal_count_ = count;
+  auto key = [](const TemporalEdge &t) {
+    return std::make_tuple(t.src, t.dst, t.label);
+  };
+  for (size_t i = 0; i < count; ++i) {
+    const TemporalEdge &t = temporal_[i];
+    if (t.src >= node_count_ || t.dst >= node_count_ ||
+        t.label >= label_count_ || (i > 0 && key(temporal_[i - 1]) >= key(t)))
+      Fail(path_, "bad temporal edge");
+  }
+}
+
+std::pair<int64_t, int64_t>
+GraphSnapshotReader::Validity(uint32_t src, uint32_t dst,
+                              uint32_t label) const {
+  const TemporalEdge *end = temporal_ + temporal_count_;
+  auto key = std::make_tuple(src, dst, label);
+  const TemporalEdge *it = std::lower_bound(
+      temporal_, end, key, [](const TemporalEdge &t, const auto &k) {
+        return std::make_tuple(t.src, t.dst, t.label) < k;
+      });
+  if (it != end && std::make_tuple(it->src, it->dst, it->label) == key)
+    return {it->valid_from, it->valid_to};
+  return {VALID_FROM_ALWAYS, VALID_TO_FOREVER};
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// GraphSnapshotWriter
+// ══════════════════════════════════════════════════════════════════════════════
+
+GraphSnapshotWriter::GraphSnapshotWriter(const std::string &path)
+    : path_(path), tmp_path_(path + ".tmp"), checksum_(kFnvOffset) {
+  fd_ = ::open(tmp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+               0644);
+  if (fd_ < 0)
+    FailErrno(tmp_path_, "open");
+  buf_.reserve(kBlockSize);
+  // 头部占位，Finish 时回填；不计入校验和
+  buf_.assign(sizeof(Header), '\0');
+  written_ = sizeof(Header);
+}
+
+GraphSnapshotWriter::~GraphSnapshotWriter() {
+  // 未调用 Finish（中途抛异常）时丢弃临时文件
+  if (fd_ >= 0) {
+    ::close(fd_);
+    ::unlink(tmp_path_.c_str());
+  }
+}
+
+void GraphSnapshotWriter::BeginSection(GraphSnapshotSection section) {
+  static const char kZeros[8] = {};
+  if (written_ % 8 != 0)
+    Append(kZeros, 8 - written_ % 8);
+  sections_[static_cast<size_t>(section)] = written_;
+}
+
+void GraphSnapshotWriter::Append(const void *data, size_t n) {
+  const char *p = static_cast<const char *>(data);
+  checksum_ = Fnv1a(checksum_, p, n);
+  written_ += n;
+  buf_.append(p, n);
+  if (buf_.size() >= kBlockSize)
+    Flush();
+}
+
+void GraphSnapshotWriter::Flush() {
+  size_t done = 0;
+  while (done < buf_.size()) {
+    ssize_t n = ::write(fd_, buf_.data() + done, buf_.size() - done);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      FailErrno(tmp_path_, "write");
+    }
+    done += static_cast<size_t>(n);
+  }
+  buf_.clear();
+}
+
+size_t GraphSnapshotWriter::Finish(uint64_t node_count, uint64_t edge_count,
+                                   uint64_t label_count) {
+  Flush();
+
+  Header h;
+  std::memcpy(h.magic, kMagic, 4);
+  h.version = kVersion;
+  h.node_count = node_count;
+  h.edge_count = edge_count;
+  h.label_count = label_count;
+  h.file_size = written_;
+  h.checksum = checksum_;
+  std::memcpy(h.sections, sections_, sizeof(h.sections));
+  if (::pwrite(fd_, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h)))
+    FailErrno(tmp_path_, "pwrite");
+  if (::fsync(fd_) != 0)
+    FailErrno(tmp_path_, "fsync");
+  ::close(fd_);
+  fd_ = -1;
+  if (std::rename(tmp_path_.c_str(), path_.c_str()) != 0) {
+    ::unlink(tmp_path_.c_str());
+    FailErrno(path_, "rename");
+  }
+  return written_;
+}
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "graph_types.h"
+
+namespace minkv {
+namespace graph {
+
+/** 图快照写入 / 加载统计 */
+struct GraphSnapshotStats {
+  size_t nodes = 0;        // 节点字典大小（含只作为边端点出现的节点）
+  size_t node_records = 0; // 有 n: 记录的节点数
+  size_t edges = 0;        // 边数
+  size_t embeddings = 0;   // 有 embedding 的节点数
+  size_t labels = 0;       // 不同边标签数
+  size_t bytes = 0;        // 快照文件大小
+  double elapsed_ms = 0.0; // 写入或加载耗时
+};
+
+/**
+ * 图快照文件格式（小端序，各段 8 字节对齐）
+ *
+ *   Header  [4B "MKGS"][4B version][8B node_count][8B edge_count]
+ *           [8B label_count][8B file_size][8B checksum][8B × 8 段偏移]
+ *   NODE_IDS      字符串表，节点 ID 按字典序排列，下标即节点编号
+ *   NODE_RECORDS  字符串表，第 i 项是节点 i 的 n: 值，长度 0 表示没有记录
+ *   EMBEDDINGS    字符串表，第 i 项是节点 i 的 vec: 值，长度 0 表示没有
+ *   LABELS        字符串表，边标签字典
+ *   OUT_CSR       [8B n][8B row × (n+1)][8B m][4B 邻居 × m][4B 标签 × m]
+ *                 [4B float 权重 × m]，行内按 KV 中 e: Key 的顺序排列
+ *   IN_CSR        同上，按终点分行
+ *   EDGE_RECORDS  字符串表，第 k 项是 OUT_CSR 第 k 条边的 e: 值
+ *   TEMPORAL_EDGES [8B count]{[4B 起点][4B 终点][4B 标签][4B 0]
+ *                 [8B valid_from][8B valid_to]} × count，只含有有效期的边，
+ *                 按 (起点, 终点, 标签) 排序，加载时二分查找
+ *
+ * 字符串表：[8B count][8B offset × (count+1)][字节]，offset 相对字节区起点。
+ * checksum 是 Header 之后全部字节的 FNV-1a 64。
+ */
+enum class GraphSnapshotSection : uint32_t {
+  NODE_IDS = 0,
+  NODE_RECORDS,
+  EMBEDDINGS,
+  LABELS,
+  OUT_CSR,
+  IN_CSR,
+  EDGE_RECORDS,
+  TEMPORAL_EDGES,
+  COUNT
+};
+
+/**
+ * GraphSnapshotReader — 只读映射一个图快照文件
+ *
+ * 构造时 mmap 整个文件并校验头部、长度、校验和以及各段边界，
+ * 之后的访问都是对映射区的直接寻址，返回的 string_view 指向映射区，
+ * 生命周期不超过 reader 本身。
+ * 文件不存在、被截断、校验和不符或结构越界时抛出 std::runtime_error。
+ */
+class GraphSnapshotReader {
+public:
+  explicit GraphSnapshotReader(const std::string &path);
+  ~GraphSnapshotReader();
+
+  GraphSnapshotReader(const GraphSnapshotReader &) = delete;
+  GraphSnapshotReader &operator=(const GraphSnapshotReader &) = delete;
+
+  /** CSR 的一个方向：row[i]..row[i+1] 是节点 i 的条目 */
+  struct Csr {
+    const uint64_t *row = nullptr;
+    const uint32_t *neighbor = nullptr;
+    const uint32_t *label = nullptr;
+    const float *weight = nullptr;
+  };
+
+  size_t node_count() const { return node_count_; }
+  size_t edge_count() const { return edge_count_; }
+  size_t label_count() const { return label_count_; }
+  size_t file_size() const { return size_; }
+
+  std::string_view NodeId(size_t i) const { return Get(node_ids_, i); }
+  std::string_view NodeRecord(size_t i) const {
+    return Get(node_records_, i);
+  }
+  std::string_view Embedding(size_t i) const { return Get(embeddings_, i); }
+  std::string_view Label(size_t i) const { return Get(labels_, i); }
+  std::string_view EdgeRecord(size_t k) const {
+    return Get(edge_records_, k);
+  }
+
+  const Csr &Out() const { return out_; }
+  const Csr &In() const { return in_; }
+
+  /** 有有效期的边数 */
+  size_t temporal_count() const { return temporal_count_; }
+  /**
+   * 查找边 (src, dst, label) 的有效期，三者都是编号；
+   * 没有有效期的边返回 [VALID_FROM_ALWAYS, VALID_TO_FOREVER)
+   */
+  std::pair<int64_t, int64_t> Validity(uint32_t src, uint32_t dst,
+                                       uint32_t label) const;
+
+  /** TEMPORAL_EDGES 段的一条记录 */
+  struct TemporalEdge {
+    uint32_t src;
+    uint32_t dst;
+    uint32_t label;
+    uint32_t pad;
+    int64_t valid_from;
+    int64_t valid_to;
+  };
+
+private:
+  struct StringTable {
+    const uint64_t *offsets = nullptr;
+    const char *bytes = nullptr;
+  };
+
+  static std::string_view Get(const StringTable &t, size_t i) {
+    return {t.bytes + t.offsets[i], t.offsets[i + 1] - t.offsets[i]};
+  }
+
+  /** 解析并校验 [begin, end) 处的字符串表，条目数必须为 count */
+  StringTable ParseTable(uint64_t begin, uint64_t end, size_t count) const;
+  /** 解析并校验 [begin, end) 处的 CSR */
+  Csr ParseCsr(uint64_t begin, uint64_t end) const;
+  /** 解析并校验 [begin, end) 处的 TEMPORAL_EDGES 段 */
+  void ParseTemporal(uint64_t begin, uint64_t end);
+
+  std::string path_;
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+  size_t node_count_ = 0;
+  size_t edge_count_ = 0;
+  size_t label_count_ = 0;
+  StringTable node_ids_, node_records_, embeddings_, labels_, edge_records_;
+  Csr out_, in_;
+  const TemporalEdge *temporal_ = nullptr;
+  size_t temporal_count_ = 0;
+};
+
+/**
+ * GraphSnapshotWriter — 顺序写出图快照
+ *
+ * 调用方按段的顺序依次写入；数据先攒进大块缓冲区，满了才 write 一次，
+ * 同时累计校验和。写到 path.tmp，Finish 时回填头部、fsync 后 rename，
+ * 中途失败不会破坏已有的快照。I/O 错误抛出 std::runtime_error。
+ */
+class GraphSnapshotWriter {
+public:
+  explicit GraphSnapshotWriter(const std::string &path);
+  ~GraphSnapshotWriter();
+
+  GraphSnapshotWriter(const GraphSnapshotWriter &) = delete;
+  GraphSnapshotWriter &operator=(const GraphSnapshotWriter &) = delete;
+
+  /** 开始一个新段：补齐到 8 字节边界并记录偏移 */
+  void BeginSection(GraphSnapshotSection section);
+
+  void Append(const void *data, size_t n);
+  void AppendU64(uint64_t v) { Append(&v, sizeof(v)); }
+
+  /** 回填头部并原子替换目标文件，返回文件大小 */
+  size_t Finish(uint64_t node_count, uint64_t edge_count,
+                uint64_t label_count);
+
+private:
+  void Flush();
+
+  std::string path_;
+  std::string tmp_path_;
+  int fd_ = -1;
+  std::string buf_;
+  uint64_t written_ = 0; // 已写出（含缓冲区）的字节数
+  uint64_t checksum_;
+  uint64_t sections_[static_cast<size_t>(GraphSnapshotSection::COUNT)] = {};
+};
+
+} // namespace graph
+} // namespace minkv
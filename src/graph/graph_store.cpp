@@ -1,14 +1,24 @@
 #include "graph_store.h"
 
 #include <algorithm> // std::find, std::reverse
+#include <chrono>
+#include <cmath> // std::isnan
+#include <deque>
 #include <cstring>   // std::memcpy
+#include <functional> // std::hash
 #include <future>    // std::future（线程池 submit 返回值）
+#include <limits>
 #include <mutex>
-#include <queue> // std::queue（BFS 用）
+#include <numeric> // std::iota
+#include <queue> // std::priority_queue（top-k 最小堆）
+#include <random> // std::mt19937_64（蓄水池采样）
+#include <set>
+#include <stdexcept>
 #include <unordered_set>
 
 #include "../base/thread_pool.h"
 #include "graph_serializer.h"
+#include "pairing_heap.h"
 
 namespace minkv {
 namespace graph {
@@ -18,13 +28,99 @@ namespace graph {
 // ══════════════════════════════════════════════════════════════════════════════
 
 GraphStore::GraphStore(std::shared_ptr<GraphKVStore> kv_store, size_t n_threads)
-    : kv_(std::move(kv_store)) {
+    : kv_(std::move(kv_store)),
+      paged_adj_(std::make_unique<PagedAdjacency>(*kv_)) {
   // n_threads > 1 时创建线程池，否则串行（避免单核机器上的无谓开销）
   if (n_threads > 1) {
     thread_pool_ = std::make_unique<minkv::base::ThreadPool>(n_threads);
   }
 }
 
+void GraphStore::EnableQueryCache(const GraphRAGCacheOptions &options) {
+  query_cache_ = std::make_unique<GraphRAGQueryCache>(options, versions_);
+}
+
+GraphRAGCacheStats GraphStore::QueryCacheStats() const {
+  return query_cache_ ? query_cache_->Stats() : GraphRAGCacheStats{};
+}
+
+void GraphStore::ConfigureSupernodes(const SupernodeOptions &options) {
+  paged_adj_->set_options(options);
+}
+
+NodeDegree GraphStore::GetDegree(const std::string &node_id) const {
+  return degrees_.Get(node_id);
+}
+
+DegreeHistogram GraphStore::DegreeStats() const {
+  DegreeHistogram h = degrees_.Histogram();
+  h.paged_lists = paged_adj_->Count();
+  return h;
+}
+
+void GraphStore::EnableKeywordIndex(const KeywordIndexOptions &options) {
+  auto index = std::make_unique<KeywordIndex>(options);
+  for (const auto &[k, v] : kv_->export_all_data()) {
+    if (k.compare(0, 2, "n:") != 0)
+      continue;
+    try {
+      NodeView node = GraphSerializer::ViewNode(v);
+      index->Upsert(std::string(node.node_id), node.properties_json);
+    } catch (const std::exception &) {
+      // 跳过损坏的节点数据
+    }
+  }
+  keyword_index_ = std::move(index);
+}
+
+std::vector<std::pair<std::string, double>>
+GraphStore::SearchKeyword(const std::string &query, int top_k) const {
+  if (!keyword_index_)
+    return {};
+  return keyword_index_->Search(query, top_k);
+}
+
+KeywordIndexStats GraphStore::KeywordStats() const {
+  return keyword_index_ ? keyword_index_->Stats() : KeywordIndexStats{};
+}
+
+void GraphStore::CreatePropertyIndex(const std::string &field,
+                                     PropertyIndexType type) {
+  property_index_.Create(field, type, [this](const auto &add) {
+    for (const auto &[k, v] : kv_->export_all_data()) {
+      if (k.compare(0, 2, "n:") != 0)
+        continue;
+      try {
+        NodeView node = GraphSerializer::ViewNode(v);
+        add(node.node_id, node.properties_json);
+      } catch (const std::exception &) {
+        // 跳过损坏的节点数据
+      }
+    }
+  });
+}
+
+bool GraphStore::DropPropertyIndex(const std::string &field) {
+  return property_index_.Drop(field);
+}
+
+std::vector<PropertyIndexInfo> GraphStore::ListPropertyIndexes() const {
+  return property_index_.List();
+}
+
+std::vector<std::string> GraphStore::FindNodeIdsByProperties(
+    const std::vector<PropertyPredicate> &predicates) const {
+  auto lock = property_index_.ReadLock();
+  return property_index_.FindLocked(predicates);
+}
+
+std::vector<Node> GraphStore::FindNodesByProperties(
+    const std::vector<PropertyPredicate> &predicates,
+    const Projection &projection) const {
+  auto lock = property_index_.ReadLock();
+  return LoadExistingNodes(property_index_.FindLocked(predicates), projection);
+}
+
 // ══════════════════════════════════════════════════════════════════════════════
 // Key 构造辅助函数
 //
@@ -57,6 +153,17 @@ std::string GraphStore::EscapeId(const std::string &id) {
   return out;
 }
 
+std::string GraphStore::UnescapeId(std::string_view escaped) {
+  std::string out;
+  out.reserve(escaped.size());
+  for (size_t i = 0; i < escaped.size(); ++i) {
+    if (escaped[i] == '\\' && i + 1 < escaped.size())
+      ++i; // '\:' -> ':'，'\\' -> '\'
+    out += escaped[i];
+  }
+  return out;
+}
+
 std::string GraphStore::NodeKey(const std::string &node_id) {
   return "n:" + EscapeId(node_id);
 }
@@ -80,131 +187,288 @@ std::string GraphStore::VecKey(const std::string &node_id) {
   return "vec:" + EscapeId(node_id);
 }
 
-std::string GraphStore::EdgeCountKey(const std::string &src,
-                                     const std::string &dst) {
-  // 格式：ec:{src}:{dst}
-  // 与 e:{src}:{dst}:{label} 共享相同的 src/dst 转义规则
-  return "ec:" + EscapeId(src) + ":" + EscapeId(dst);
-}
-
 // ══════════════════════════════════════════════════════════════════════════════
 // 邻接表内部辅助函数
 //
-// 邻接表存储格式：JSON 数组字符串，例如 ["alice","bob"]
-// 每次修改都是"读 -> 改 -> 写"三步（read-modify-write）。
+// 邻接表存储格式：AdjEntry 列表的紧凑二进制（见 GraphSerializer），
+// 每条边一个条目 (neighbor_id, label, weight)。
+// 每次修改都是"读 -> 改 -> 写"三步（read-modify-write），
+// 通过 update_in_place 在分片锁内原子完成。
 // ══════════════════════════════════════════════════════════════════════════════
 
-/** 从 KV 读取邻接表；Key 不存在时返回空列表，不报错 */
-std::vector<std::string>
-GraphStore::LoadAdjList(const std::string &kv_key) const {
+/** 从 KV 读取邻接表条目；Key 不存在时返回空列表，不报错 */
+std::vector<AdjEntry>
+GraphStore::LoadAdjEntries(const std::string &kv_key,
+                           const std::vector<std::string> &labels,
+                           std::optional<int64_t> as_of) const {
   auto val = kv_->get(kv_key);
   if (!val)
     return {}; // Key 不存在 -> 空邻接表
-  return GraphSerializer::DeserializeAdjList(*val);
-}
-
-/** 将邻接表序列化后写回 KV */
-void GraphStore::SaveAdjList(const std::string &kv_key,
-                             const std::vector<std::string> &list) {
-  kv_->put(kv_key, GraphSerializer::SerializeAdjList(list));
+  if (PagedAdjacency::IsHeader(*val))
+    return paged_adj_->Load(kv_key, labels, as_of);
+  return GraphSerializer::DeserializeAdjEntries(*val, labels, as_of);
 }
 
 /**
- * 向邻接表追加一个 id（自动去重）
+ * 按方向 + 标签 + 节点谓词读取条目
  *
- * 使用 ShardedCache::update_in_place 实现原子 read-modify-write，
- * 在分片锁内完成"读取 → 反序列化 → 去重追加 → 序列化 → 写入"整个流程，
- * 消除并发写覆盖问题。
+ * 标签过滤直接作用在邻接表条目上：label 已冗余在条目里，
+ * 不匹配的条目在反序列化时就被跳过，不需要逐条 GetEdge 核对。
  */
-void GraphStore::AdjListAdd(const std::string &kv_key, const std::string &id) {
-  kv_->update_in_place(kv_key, [&](const std::optional<std::string> &old_val) {
-    auto list = GraphSerializer::DeserializeAdjList(old_val);
-    if (std::find(list.begin(), list.end(), id) == list.end()) {
-      list.push_back(id);
-    }
-    return GraphSerializer::SerializeAdjList(list);
-  });
+std::vector<AdjEntry>
+GraphStore::LoadFilteredEntries(const std::string &node_id,
+                                const TraversalFilter &filter) const {
+  std::vector<AdjEntry> entries;
+  if (filter.direction == Direction::OUT) {
+    entries = LoadAdjEntries(AdjOutKey(node_id), filter.labels, filter.as_of);
+  } else if (filter.direction == Direction::IN) {
+    entries = LoadAdjEntries(AdjInKey(node_id), filter.labels, filter.as_of);
+  } else {
+    entries = LoadAdjEntries(AdjOutKey(node_id), filter.labels, filter.as_of);
+    auto in = LoadAdjEntries(AdjInKey(node_id), filter.labels, filter.as_of);
+    entries.insert(entries.end(), std::make_move_iterator(in.begin()),
+                   std::make_move_iterator(in.end()));
+  }
+  // 节点谓词：在二级索引的反向表上判定邻居，同样不读取 n: 节点数据
+  if (!filter.node_predicates.empty())
+    property_index_.RetainMatching(entries, filter.node_predicates);
+  return entries;
 }
 
 /**
- * 从邻接表移除一个 id
- *
- * 同样使用 update_in_place 保证原子性。
- * 如果移除后列表变空，返回空字符串作为"空列表"标记；
- * 调用方（AdjListRemove 的调用者）在外部通过 kv_->remove() 删除 Key。
+ * 提取邻居 ID 列表
  *
- * 注意：这里不直接在回调内调用 kv_->remove()，因为 remove 会持另一把锁，
- * 在分片锁内调用 remove 会导致死锁。改为返回空序列化结果，
- * 由调用方在 update_in_place 返回后判断是否需要 remove。
+ * 多重边（同一邻居、不同 label）在条目中出现多次，这里按首次出现顺序去重，
+ * 保持 GetOutNeighbors / BFS 看到的是"邻居集合"。
+ * 绝大多数节点对之间只有一条边，先线性查重，条目多时才建哈希集合。
  */
-void GraphStore::AdjListRemove(const std::string &kv_key,
-                               const std::string &id) {
-  bool became_empty = false;
-  kv_->update_in_place(kv_key, [&](const std::optional<std::string> &old_val) {
-    auto list = GraphSerializer::DeserializeAdjList(old_val);
-    auto it = std::find(list.begin(), list.end(), id);
-    if (it == list.end()) {
-      // id 不在列表里，返回原值（不做任何修改）
-      became_empty = false;
-      return old_val.value_or("");
-    }
-    list.erase(it);
-    became_empty = list.empty();
-    return GraphSerializer::SerializeAdjList(list);
-  });
-
-  // 在 update_in_place 返回后（分片锁已释放），如果列表变空则删除 Key
-  // 这是安全的，因为 update_in_place 已经原子地移除了 id，
-  // 后续的 remove 只是清理空 Key，不会导致数据不一致
-  if (became_empty) {
-    kv_->remove(kv_key);
+std::vector<std::string>
+GraphStore::UniqueNeighbors(std::vector<AdjEntry> entries) {
+  std::vector<std::string> ids;
+  ids.reserve(entries.size());
+  if (entries.size() <= 16) {
+    for (auto &e : entries) {
+      if (std::find(ids.begin(), ids.end(), e.neighbor_id) == ids.end())
+        ids.push_back(std::move(e.neighbor_id));
+    }
+    return ids;
   }
+  std::unordered_set<std::string> seen;
+  seen.reserve(entries.size());
+  for (auto &e : entries) {
+    if (seen.insert(e.neighbor_id).second)
+      ids.push_back(std::move(e.neighbor_id));
+  }
+  return ids;
 }
 
-// ══════════════════════════════════════════════════════════════════════════════
-// 边计数器辅助函数
-//
-// 边计数器 Key 格式：ec:{src}:{dst}
-// Value 是 uint64_t 的十进制字符串。
-//
-// 使用 update_in_place 保证原子性，与 AdjListAdd/AdjListRemove 一致。
-// ══════════════════════════════════════════════════════════════════════════════
+std::vector<std::string>
+GraphStore::LoadAdjList(const std::string &kv_key) const {
+  return UniqueNeighbors(LoadAdjEntries(kv_key));
+}
+
+std::mutex &GraphStore::AdjStripe(const std::string &kv_key) const {
+  return adj_stripes_[std::hash<std::string>{}(kv_key) % adj_stripes_.size()];
+}
+
+std::mutex &GraphStore::EdgeStripe(const std::string &edge_key) const {
+  return edge_stripes_[std::hash<std::string>{}(edge_key) %
+                       edge_stripes_.size()];
+}
 
 /**
- * 原子递增边计数器
+ * 写入 (neighbor, label) 条目
  *
- * 在 AddEdge 和 RebuildAdjacencyList 中调用。
- * 使用 update_in_place 在分片锁内完成"读 → 增 1 → 写"的 RMW 周期，
+ * 使用 ShardedCache::update_in_place 实现原子 read-modify-write，
+ * 在分片锁内完成"读取 → 反序列化 → 更新/追加 → 序列化 → 写入"整个流程，
  * 消除并发写覆盖问题。
+ *
+ * 超级节点：回调里看到页头时不修改原值，释放锁后改走 PagedAdjacency；
+ * 条目数超过阈值时同样保留原值，在 stripe 锁内整体转为分页存储。
+ * 分页表在等锁期间被删除 / 替换时重新判断存储形式。
  */
-void GraphStore::IncrementEdgeCount(const std::string &src,
-                                    const std::string &dst) {
-  kv_->update_in_place(EdgeCountKey(src, dst),
-                       [&](const std::optional<std::string> &old_val) {
-                         uint64_t count = old_val ? std::stoull(*old_val) : 0;
-                         return std::to_string(count + 1);
-                       });
+void GraphStore::AdjEntryUpsert(const std::string &node_id, bool outgoing,
+                                const AdjEntry &entry) {
+  AdjEntriesUpsert(node_id, outgoing, {entry});
 }
 
 /**
- * 原子递减边计数器，返回递减后的值
+ * 批量写入同一个邻接表的多个条目：整个列表只做一次 read-modify-write
  *
- * 在 DeleteEdge 中调用。
- * 返回 0 表示 (src, dst) 间已无其他边，调用方应清理邻接表。
+ * 语义与按顺序逐条 AdjEntryUpsert 相同（同一 (neighbor, label) 后者覆盖）。
+ * 表在中途转为分页存储时，已写入分页表的条目不会重复写。
+ */
+void GraphStore::AdjEntriesUpsert(const std::string &node_id, bool outgoing,
+                                  const std::vector<AdjEntry> &batch) {
+  const std::string kv_key = outgoing ? AdjOutKey(node_id) : AdjInKey(node_id);
+  const size_t threshold = paged_adj_->options().promote_threshold;
+  auto set_degree = [&](size_t n) { degrees_.Set(node_id, outgoing, n); };
+  size_t paged_done = 0; // 已经通过 PagedAdjacency 写入的条目数
+  for (;;) {
+    bool paged = false;
+    {
+      std::lock_guard<std::mutex> stripe(AdjStripe(kv_key));
+      std::vector<AdjEntry> promote;
+      size_t size = 0;
+      kv_->update_in_place(
+          kv_key, [&](const std::optional<std::string> &old_val) {
+            if (old_val && PagedAdjacency::IsHeader(*old_val)) {
+              paged = true;
+              return *old_val;
+            }
+            auto entries = GraphSerializer::DeserializeAdjEntries(old_val);
+            for (size_t i = paged_done; i < batch.size(); ++i) {
+              const AdjEntry &entry = batch[i];
+              auto it = std::find_if(entries.begin(), entries.end(),
+                                     [&](const AdjEntry &e) {
+                                       return e.neighbor_id ==
+                                                  entry.neighbor_id &&
+                                              e.label == entry.label;
+                                     });
+              if (it != entries.end()) {
+                *it = entry; // 重复添加同一条边：覆盖权重和有效期
+              } else {
+                entries.push_back(entry);
+              }
+            }
+            size = entries.size();
+            if (threshold > 0 && size > threshold) {
+              // 批量写入时一次就可能超过阈值，原值可能不存在；
+              // 空串即空表，随后的 Store 会写入页头
+              promote = std::move(entries);
+              return old_val.value_or(std::string());
+            }
+            return GraphSerializer::SerializeAdjEntries(entries);
+          });
+      if (!paged) {
+        // 先记度数再写页头：页头可见后的分页写入总是在它之后更新度数
+        set_degree(size);
+        if (!promote.empty())
+          paged_adj_->Store(kv_key, promote);
+        return;
+      }
+    }
+    while (paged_done < batch.size() &&
+           paged_adj_->Upsert(kv_key, batch[paged_done], set_degree))
+      ++paged_done;
+    if (paged_done == batch.size())
+      return;
+  }
+}
+
+/**
+ * 删除 (neighbor, label) 条目
  *
- * 注意：update_in_place 的回调在分片锁内执行，
- * 返回值的捕获通过引用完成，保证线程安全。
+ * 同样使用 update_in_place 保证原子性。
+ * 注意：这里不直接在回调内调用 kv_->remove()，因为 remove 会持另一把锁，
+ * 在分片锁内调用 remove 会导致死锁。改为记录 became_empty，
+ * 在 update_in_place 返回后再删除空 Key。
  */
-uint64_t GraphStore::DecrementEdgeCount(const std::string &src,
-                                        const std::string &dst) {
-  uint64_t new_count = 0;
-  kv_->update_in_place(EdgeCountKey(src, dst),
-                       [&](const std::optional<std::string> &old_val) {
-                         uint64_t count = old_val ? std::stoull(*old_val) : 0;
-                         new_count = (count > 0) ? (count - 1) : 0;
-                         return std::to_string(new_count);
-                       });
-  return new_count;
+void GraphStore::AdjEntryRemove(const std::string &node_id, bool outgoing,
+                                const std::string &neighbor,
+                                const std::string &label) {
+  const std::string kv_key = outgoing ? AdjOutKey(node_id) : AdjInKey(node_id);
+  bool became_empty = false;
+  auto set_degree = [&](size_t n) {
+    degrees_.Set(node_id, outgoing, n);
+    became_empty = n == 0;
+  };
+  for (;;) {
+    bool paged = false;
+    {
+      std::lock_guard<std::mutex> stripe(AdjStripe(kv_key));
+      kv_->update_in_place(
+          kv_key, [&](const std::optional<std::string> &old_val) {
+            if (old_val && PagedAdjacency::IsHeader(*old_val)) {
+              paged = true;
+              return *old_val;
+            }
+            auto entries = GraphSerializer::DeserializeAdjEntries(old_val);
+            auto it = std::find_if(entries.begin(), entries.end(),
+                                   [&](const AdjEntry &e) {
+                                     return e.neighbor_id == neighbor &&
+                                            e.label == label;
+                                   });
+            if (it == entries.end()) {
+              // 条目不存在，返回原值（不做任何修改）
+              return old_val.value_or("");
+            }
+            entries.erase(it);
+            set_degree(entries.size());
+            return GraphSerializer::SerializeAdjEntries(entries);
+          });
+      if (!paged) {
+        // update_in_place 返回后（分片锁已释放），如果列表变空则删除 Key
+        if (became_empty)
+          kv_->remove(kv_key);
+        return;
+      }
+    }
+    if (paged_adj_->Remove(kv_key, neighbor, label, set_degree))
+      break;
+  }
+  if (became_empty)
+    paged_adj_->Drop(kv_key, /*only_if_empty=*/true);
+}
+
+/** 删除与 neighbor 相关的全部条目（DeleteNode 级联清理用） */
+void GraphStore::AdjEntryRemoveNeighbor(const std::string &node_id,
+                                        bool outgoing,
+                                        const std::string &neighbor) {
+  const std::string kv_key = outgoing ? AdjOutKey(node_id) : AdjInKey(node_id);
+  bool became_empty = false;
+  auto set_degree = [&](size_t n) {
+    degrees_.Set(node_id, outgoing, n);
+    became_empty = n == 0;
+  };
+  for (;;) {
+    bool paged = false;
+    {
+      std::lock_guard<std::mutex> stripe(AdjStripe(kv_key));
+      kv_->update_in_place(
+          kv_key, [&](const std::optional<std::string> &old_val) {
+            if (old_val && PagedAdjacency::IsHeader(*old_val)) {
+              paged = true;
+              return *old_val;
+            }
+            auto entries = GraphSerializer::DeserializeAdjEntries(old_val);
+            auto new_end = std::remove_if(
+                entries.begin(), entries.end(),
+                [&](const AdjEntry &e) { return e.neighbor_id == neighbor; });
+            if (new_end == entries.end()) {
+              return old_val.value_or("");
+            }
+            entries.erase(new_end, entries.end());
+            set_degree(entries.size());
+            return GraphSerializer::SerializeAdjEntries(entries);
+          });
+      if (!paged) {
+        if (became_empty)
+          kv_->remove(kv_key);
+        return;
+      }
+    }
+    if (paged_adj_->RemoveNeighbor(kv_key, neighbor, set_degree))
+      break;
+  }
+  if (became_empty)
+    paged_adj_->Drop(kv_key, /*only_if_empty=*/true);
+}
+
+void GraphStore::AdjListRemove(const std::string &node_id, bool outgoing) {
+  const std::string kv_key = outgoing ? AdjOutKey(node_id) : AdjInKey(node_id);
+  std::lock_guard<std::mutex> stripe(AdjStripe(kv_key));
+  auto val = kv_->get(kv_key);
+  if (val && PagedAdjacency::IsHeader(*val))
+    paged_adj_->Drop(kv_key);
+  else
+    kv_->remove(kv_key);
+  degrees_.Set(node_id, outgoing, 0);
+}
+
+AdjEntry GraphStore::ToAdjEntry(const Edge &edge, bool outgoing) {
+  return {outgoing ? edge.dst_id : edge.src_id, edge.label, edge.weight,
+          edge.valid_from, edge.valid_to};
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -213,7 +477,27 @@ uint64_t GraphStore::DecrementEdgeCount(const std::string &src,
 
 /** 添加节点：序列化后写入 n:{node_id} */
 void GraphStore::AddNode(const Node &node) {
-  kv_->put(NodeKey(node.node_id), GraphSerializer::SerializeNode(node));
+  property_index_.Commit(node.node_id, &node.properties_json, [&] {
+    kv_->put(NodeKey(node.node_id), GraphSerializer::SerializeNode(node));
+  });
+  if (keyword_index_)
+    keyword_index_->Upsert(node.node_id, node.properties_json);
+  versions_.TouchNode(node.node_id);
+}
+
+/** 批量添加节点：序列化后一次 multi_put */
+void GraphStore::AddNodes(const std::vector<Node> &nodes) {
+  std::vector<std::pair<std::string, std::string>> records;
+  records.reserve(nodes.size());
+  for (const auto &node : nodes)
+    records.emplace_back(NodeKey(node.node_id),
+                         GraphSerializer::SerializeNode(node));
+  property_index_.CommitNodes(nodes, [&] { kv_->multi_put(records); });
+  for (const auto &node : nodes) {
+    if (keyword_index_)
+      keyword_index_->Upsert(node.node_id, node.properties_json);
+    versions_.TouchNode(node.node_id);
+  }
 }
 
 /** 查询节点：读取 n:{node_id} 后反序列化；不存在返回 nullopt */
@@ -224,13 +508,60 @@ std::optional<Node> GraphStore::GetNode(const std::string &node_id) const {
   return GraphSerializer::DeserializeNode(*val);
 }
 
+/**
+ * 批量查询节点
+ *
+ * GraphRAG 的最后一步要加载成百上千个节点，逐个 get 每次都要加一次分片锁，
+ * 还要把整条记录拷贝出来再反序列化一遍；multi_visit 按分片分组加锁，
+ * 在锁内直接从存储的记录上按 projection 构造 Node，只拷贝要返回的部分。
+ */
+std::vector<std::optional<Node>>
+GraphStore::GetNodes(const std::vector<std::string> &node_ids,
+                     const Projection &projection) const {
+  std::vector<std::optional<Node>> nodes(node_ids.size());
+  VisitNodes(node_ids, [&](size_t i, const NodeView &view) {
+    nodes[i] = view.ToNode(projection);
+  });
+  return nodes;
+}
+
+void GraphStore::VisitNodes(
+    const std::vector<std::string> &node_ids,
+    const std::function<void(size_t, const NodeView &)> &visitor) const {
+  std::vector<std::string> keys;
+  keys.reserve(node_ids.size());
+  for (const auto &id : node_ids)
+    keys.push_back(NodeKey(id));
+
+  kv_->multi_visit(keys, [&](size_t i, const std::string &record) {
+    visitor(i, GraphSerializer::ViewNode(record));
+  });
+}
+
+std::vector<Node>
+GraphStore::LoadExistingNodes(const std::vector<std::string> &node_ids,
+                              const Projection &projection) const {
+  std::vector<Node> result;
+  result.reserve(node_ids.size());
+  for (auto &node : GetNodes(node_ids, projection)) {
+    if (node)
+      result.push_back(std::move(*node));
+  }
+  return result;
+}
+
 /**
  * 更新节点属性
  * 只覆盖 n: Key，不碰 adj:out/adj:in（邻接表）和 vec:（embedding）。
  * 这样更新属性不会破坏图的拓扑结构。
  */
 void GraphStore::UpdateNode(const Node &node) {
-  kv_->put(NodeKey(node.node_id), GraphSerializer::SerializeNode(node));
+  property_index_.Commit(node.node_id, &node.properties_json, [&] {
+    kv_->put(NodeKey(node.node_id), GraphSerializer::SerializeNode(node));
+  });
+  if (keyword_index_)
+    keyword_index_->Upsert(node.node_id, node.properties_json);
+  versions_.TouchNode(node.node_id);
 }
 
 /**
@@ -249,24 +580,27 @@ void GraphStore::UpdateNode(const Node &node) {
  *   - 步骤 5 代价 O(total_keys)，仅在删除节点时触发
  */
 void GraphStore::DeleteNode(const std::string &node_id) {
-  kv_->remove(NodeKey(node_id));
-  kv_->remove(VecKey(node_id));
+  property_index_.Commit(node_id, nullptr,
+                         [&] { kv_->remove(NodeKey(node_id)); });
+  const bool had_embedding = kv_->remove(VecKey(node_id));
+  if (keyword_index_)
+    keyword_index_->Remove(node_id);
 
   // 从所有出边邻居的入边邻接表中移除本节点
   auto out_neighbors = LoadAdjList(AdjOutKey(node_id));
   for (const auto &nb : out_neighbors) {
-    AdjListRemove(AdjInKey(nb), node_id);
+    AdjEntryRemoveNeighbor(nb, /*outgoing=*/false, node_id);
   }
 
   // 从所有入边前驱的出边邻接表中移除本节点
   auto in_predecessors = LoadAdjList(AdjInKey(node_id));
   for (const auto &pred : in_predecessors) {
-    AdjListRemove(AdjOutKey(pred), node_id);
+    AdjEntryRemoveNeighbor(pred, /*outgoing=*/true, node_id);
   }
 
   // 删除本节点自己的邻接表
-  kv_->remove(AdjOutKey(node_id));
-  kv_->remove(AdjInKey(node_id));
+  AdjListRemove(node_id, /*outgoing=*/true);
+  AdjListRemove(node_id, /*outgoing=*/false);
 
   // 删除以本节点为端点的所有边数据（e: Key）
   // 扫描所有 KV 数据，过滤出 src 或 dst 等于 node_id 的边并删除
@@ -297,6 +631,16 @@ void GraphStore::DeleteNode(const std::string &node_id) {
       }
     }
   }
+
+  // 写入全部完成后再递增版本号（见 GraphVersionTracker）
+  // 删除 embedding 会改变向量检索的入口节点，影响范围无法按区域界定
+  if (had_embedding)
+    versions_.TouchAll();
+  versions_.TouchNode(node_id);
+  for (const auto &nb : out_neighbors)
+    versions_.TouchNode(nb);
+  for (const auto &pred : in_predecessors)
+    versions_.TouchNode(pred);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -306,27 +650,79 @@ void GraphStore::DeleteNode(const std::string &node_id) {
 /**
  * 添加有向边
  *
- * 写入顺序设计：先写边数据，再写邻接表，最后递增边计数器。
+ * 写入顺序设计：先写边数据，再写邻接表。
  * 这样即使进程在中间步骤崩溃，边数据是完整的，
  * 邻接表只是缺了条目（可以用 RebuildAdjacencyList 修复），
  * 不会出现"邻接表有记录但边不存在"的更危险情况。
  *
- * 边计数器（ec:{src}:{dst}）用于 O(1) 判断 (src,dst) 间是否还有边，
- * 避免 DeleteEdge 全表扫描。计数器在邻接表之后递增，
- * 这样崩溃后计数器可能偏低（而非偏高），不会导致邻接表条目被误删。
+ * 邻接表按 (neighbor, label) 记录条目并带上权重，
+ * 同一条边重复添加只会更新权重和有效期，不会产生重复条目。
  */
 void GraphStore::AddEdge(const Edge &edge) {
+  if (edge.valid_from >= edge.valid_to)
+    throw std::invalid_argument("edge valid_from must be < valid_to");
+  const std::string key = EdgeKey(edge.src_id, edge.dst_id, edge.label);
+  std::lock_guard<std::mutex> lock(EdgeStripe(key));
   // Step 1: 写边数据（先写边，再写邻接表，保证崩溃后边数据完整）
-  kv_->put(EdgeKey(edge.src_id, edge.dst_id, edge.label),
-           GraphSerializer::SerializeEdge(edge));
-  // Step 2: 更新出边邻接表（AdjListAdd 内部去重，多条不同 label 的边只记录一次
-  // dst）
-  AdjListAdd(AdjOutKey(edge.src_id), edge.dst_id);
+  kv_->put(key, GraphSerializer::SerializeEdge(edge));
+  // Step 2: 更新出边邻接表
+  AdjEntryUpsert(edge.src_id, /*outgoing=*/true, ToAdjEntry(edge, true));
   // Step 3: 更新入边邻接表
-  AdjListAdd(AdjInKey(edge.dst_id), edge.src_id);
-  // Step 4: 递增边计数器（原子操作，update_in_place 保证并发安全）
-  // 放在最后一步：崩溃后计数器偏低，不会导致邻接表误删
-  IncrementEdgeCount(edge.src_id, edge.dst_id);
+  AdjEntryUpsert(edge.dst_id, /*outgoing=*/false, ToAdjEntry(edge, false));
+  if (edge.valid_to != VALID_TO_FOREVER &&
+      expiry_enabled_.load(std::memory_order_acquire))
+    edge_expiry_.Add(edge.src_id, edge.dst_id, edge.label, edge.valid_to);
+  versions_.TouchNode(edge.src_id);
+  versions_.TouchNode(edge.dst_id);
+}
+
+/**
+ * 批量添加有向边
+ *
+ * 写入顺序与 AddEdge 相同：先写全部边数据，再写邻接表。
+ * 邻接表条目按节点分组，组内保持边的原始顺序，
+ * 同一批中重复的边仍是后者覆盖前者。
+ * 涉及的边锁按地址顺序一次性取得，避免与其他批次互相等待。
+ */
+void GraphStore::AddEdges(const std::vector<Edge> &edges) {
+  for (const auto &edge : edges) {
+    if (edge.valid_from >= edge.valid_to)
+      throw std::invalid_argument("edge valid_from must be < valid_to");
+  }
+  std::vector<std::pair<std::string, std::string>> records;
+  records.reserve(edges.size());
+  std::set<std::mutex *> stripes;
+  for (const auto &edge : edges) {
+    records.emplace_back(EdgeKey(edge.src_id, edge.dst_id, edge.label),
+                         GraphSerializer::SerializeEdge(edge));
+    stripes.insert(&EdgeStripe(records.back().first));
+  }
+  std::vector<std::unique_lock<std::mutex>> locks;
+  locks.reserve(stripes.size());
+  for (auto *m : stripes)
+    locks.emplace_back(*m);
+  kv_->multi_put(records);
+
+  std::unordered_map<std::string, std::vector<AdjEntry>> out_entries;
+  std::unordered_map<std::string, std::vector<AdjEntry>> in_entries;
+  for (const auto &edge : edges) {
+    out_entries[edge.src_id].push_back(ToAdjEntry(edge, true));
+    in_entries[edge.dst_id].push_back(ToAdjEntry(edge, false));
+  }
+  for (const auto &[node_id, entries] : out_entries)
+    AdjEntriesUpsert(node_id, /*outgoing=*/true, entries);
+  for (const auto &[node_id, entries] : in_entries)
+    AdjEntriesUpsert(node_id, /*outgoing=*/false, entries);
+
+  const bool expiry = expiry_enabled_.load(std::memory_order_acquire);
+  for (const auto &edge : edges) {
+    if (expiry && edge.valid_to != VALID_TO_FOREVER)
+      edge_expiry_.Add(edge.src_id, edge.dst_id, edge.label, edge.valid_to);
+  }
+  for (const auto &[node_id, entries] : out_entries)
+    versions_.TouchNode(node_id);
+  for (const auto &[node_id, entries] : in_entries)
+    versions_.TouchNode(node_id);
 }
 
 /** 查询边：按三元组 Key 查找；不存在返回 nullopt */
@@ -342,26 +738,29 @@ std::optional<Edge> GraphStore::GetEdge(const std::string &src_id,
 /**
  * 删除边
  *
- * 利用边计数器（ec:{src}:{dst}）O(1) 判断 (src, dst) 间是否还有其他 label
- * 的边。 计数器减到 0 时才清理邻接表，避免全表扫描。
+ * 邻接表条目带 label，直接删除 (dst, label) / (src, label) 对应的条目即可；
+ * (src, dst) 间其他 label 的边各有自己的条目，不受影响。
  *
- * 复杂度：从 O(total_keys) 降为 O(1)。
+ * 复杂度：O(degree)，只涉及两个邻接表 Key，无需全表扫描。
  */
 void GraphStore::DeleteEdge(const std::string &src_id,
                             const std::string &dst_id,
                             const std::string &label) {
+  std::lock_guard<std::mutex> lock(EdgeStripe(EdgeKey(src_id, dst_id, label)));
+  DeleteEdgeLocked(src_id, dst_id, label);
+}
+
+void GraphStore::DeleteEdgeLocked(const std::string &src_id,
+                                  const std::string &dst_id,
+                                  const std::string &label) {
   // Step 1: 删除边数据
   kv_->remove(EdgeKey(src_id, dst_id, label));
 
-  // Step 2: 原子递减边计数器，返回递减后的值
-  // 为 0 表示 (src, dst) 间已无其他边，清理邻接表
-  if (DecrementEdgeCount(src_id, dst_id) == 0) {
-    // (src, dst) 间无其他边，从邻接表中移除
-    AdjListRemove(AdjOutKey(src_id), dst_id);
-    AdjListRemove(AdjInKey(dst_id), src_id);
-    // 清理空计数器 Key（可选，LRU 淘汰也会处理）
-    kv_->remove(EdgeCountKey(src_id, dst_id));
-  }
+  // Step 2: 从两侧邻接表中移除该边的条目
+  AdjEntryRemove(src_id, /*outgoing=*/true, dst_id, label);
+  AdjEntryRemove(dst_id, /*outgoing=*/false, src_id, label);
+  versions_.TouchNode(src_id);
+  versions_.TouchNode(dst_id);
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -380,12 +779,107 @@ GraphStore::GetInNeighbors(const std::string &node_id) const {
   return LoadAdjList(AdjInKey(node_id));
 }
 
+/** 按方向 / 标签过滤的邻居；BOTH 时出边、入边邻居合并去重 */
+std::vector<std::string>
+GraphStore::GetNeighbors(const std::string &node_id,
+                         const TraversalFilter &filter) const {
+  return UniqueNeighbors(LoadFilteredEntries(node_id, filter));
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 边有效期：过期清理
+//
+// 查询按 as_of 过滤，边到期这一刻不需要任何写操作；这里只负责事后
+// 把过了保留期的边真正删除，回收 e: 记录和邻接表条目。
+// ══════════════════════════════════════════════════════════════════════════════
+
+void GraphStore::EnableEdgeExpiration(const EdgeExpirationOptions &options) {
+  if (options.retention_ms < 0)
+    throw std::invalid_argument("retention_ms must be >= 0");
+  edge_expiration_.reset(); // 先停止旧的后台线程
+  expiration_options_ = options;
+  if (!expiration_options_.now) {
+    expiration_options_.now = [] {
+      return static_cast<int64_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch())
+              .count());
+    };
+  }
+
+  // 先打开开关再扫描：扫描期间新增的边可能入队两次，出队时核对记录即可
+  edge_expiry_.Clear();
+  expiry_enabled_.store(true, std::memory_order_release);
+  for (const auto &[k, v] : kv_->export_all_data()) {
+    if (k.compare(0, 2, "e:") != 0)
+      continue;
+    try {
+      EdgeView edge = GraphSerializer::ViewEdge(v);
+      if (edge.valid_to != VALID_TO_FOREVER) {
+        edge_expiry_.Add(std::string(edge.src_id), std::string(edge.dst_id),
+                         std::string(edge.label), edge.valid_to);
+      }
+    } catch (const std::exception &) {
+      // 跳过损坏的边数据
+    }
+  }
+
+  edge_expiration_ = std::make_unique<minkv::base::ExpirationManager>(
+      [this](size_t stripe, size_t sample_size) {
+        return RetireStripe(stripe, expiration_options_.now(), sample_size,
+                            /*blocking=*/false);
+      },
+      EdgeExpiryQueue::STRIPES, options.check_interval, options.sample_size);
+}
+
+size_t GraphStore::RetireExpiredEdges(int64_t now) {
+  size_t retired = 0;
+  for (size_t s = 0; s < EdgeExpiryQueue::STRIPES; ++s)
+    retired += RetireStripe(s, now, SIZE_MAX, /*blocking=*/true);
+  return retired;
+}
+
+size_t GraphStore::RetireStripe(size_t stripe, int64_t now, size_t max,
+                                bool blocking) {
+  // valid_to + retention <= now，改写成减法避免溢出
+  const int64_t retention = expiration_options_.retention_ms;
+  const int64_t cutoff =
+      now < VALID_FROM_ALWAYS + retention ? VALID_FROM_ALWAYS : now - retention;
+  std::vector<ExpiringEdge> due;
+  if (!edge_expiry_.PopExpired(stripe, cutoff, max, blocking, due))
+    return SIZE_MAX;
+
+  size_t retired = 0;
+  for (const auto &e : due) {
+    // 核对和删除在同一把边锁内完成，并发的 AddEdge 要么在核对之前
+    // 写入新有效期（条目过时），要么等删除结束后再写入
+    std::lock_guard<std::mutex> lock(
+        EdgeStripe(EdgeKey(e.src_id, e.dst_id, e.label)));
+    // 边已被删除，或被重新添加为新的有效期：条目过时，丢弃
+    auto edge = GetEdge(e.src_id, e.dst_id, e.label);
+    if (!edge || edge->valid_to != e.valid_to)
+      continue;
+    DeleteEdgeLocked(e.src_id, e.dst_id, e.label);
+    ++retired;
+  }
+  edges_retired_.fetch_add(retired, std::memory_order_relaxed);
+  return retired;
+}
+
+EdgeExpirationStats GraphStore::EdgeExpiration() const {
+  EdgeExpirationStats stats;
+  stats.pending = edge_expiry_.Size();
+  stats.retired = edges_retired_.load(std::memory_order_relaxed);
+  return stats;
+}
+
 void GraphStore::RebuildAdjacencyList() {
   // Step 1: 导出所有 KV 数据，过滤出边数据（e: 前缀）、邻接表 Key（adj: 前缀）
-  // 和边计数器 Key（ec: 前缀）
+  // 和旧版本遗留的边计数器 Key（ec: 前缀）
   auto all_data = kv_->export_all_data();
 
   // Step 2: 清空所有现有邻接表（adj:out:* 和 adj:in:*）和边计数器（ec:*）
+  // 邻接表改为带 label 的条目后不再使用边计数器，这里顺带清理旧数据
   // 注意：不能直接在持有 export_all_data 的 unique_lock 时调用 kv_->remove，
   // 因为 remove 内部会尝试获取 shared_lock，导致死锁（shared_mutex 不允许
   // 同一线程同时持有 unique_lock 和 shared_lock）。
@@ -395,10 +889,11 @@ void GraphStore::RebuildAdjacencyList() {
   std::vector<std::string> keys_to_remove;
   std::vector<std::pair<std::string, std::string>> edge_entries;
   for (const auto &[k, v] : all_data) {
-    if (k.size() > 4 && k.substr(0, 4) == "adj:") {
+    if ((k.size() > 4 && k.substr(0, 4) == "adj:") ||
+        (k.size() > 5 && k.substr(0, 5) == "adjp:")) {
       keys_to_remove.push_back(k);
     } else if (k.size() > 3 && k.substr(0, 3) == "ec:") {
-      // 边计数器在重建时会被重新计算，先清空
+      // 旧版本的边计数器，已不再使用
       keys_to_remove.push_back(k);
     } else if (k.size() > 2 && k.substr(0, 2) == "e:") {
       edge_entries.push_back({k, v});
@@ -409,116 +904,1039 @@ void GraphStore::RebuildAdjacencyList() {
   // 此时可以安全地调用 kv_->remove（它内部获取 shared_lock）
   all_data.clear();
 
-  // 清空邻接表和边计数器
+  // 清空邻接表和遗留的边计数器；分页目录和度数随之作废
   for (const auto &k : keys_to_remove) {
     kv_->remove(k);
   }
+  paged_adj_->Clear();
+  degrees_.Clear();
 
-  // Step 3: 遍历所有边，重新构建邻接表和边计数器
+  // Step 3: 遍历所有边，重新构建邻接表
   // 边 Key 格式：e:{src}:{dst}:{label}，Value 是序列化的 Edge 结构体
   for (const auto &[k, v] : edge_entries) {
     try {
-      Edge edge = GraphSerializer::DeserializeEdge(v);
-      AdjListAdd(AdjOutKey(edge.src_id), edge.dst_id);
-      AdjListAdd(AdjInKey(edge.dst_id), edge.src_id);
-      // 重建边计数器：每条边递增一次
-      IncrementEdgeCount(edge.src_id, edge.dst_id);
+      // 只需要端点、标签、权重和有效期，不拷贝边属性
+      EdgeView edge = GraphSerializer::ViewEdge(v);
+      std::string src(edge.src_id), dst(edge.dst_id);
+      AdjEntry entry{dst, std::string(edge.label), edge.weight,
+                     edge.valid_from, edge.valid_to};
+      AdjEntryUpsert(src, /*outgoing=*/true, entry);
+      entry.neighbor_id = src;
+      AdjEntryUpsert(dst, /*outgoing=*/false, entry);
     } catch (const std::exception &) {
       // 跳过损坏的边数据，继续处理其他边
     }
   }
+  versions_.TouchAll();
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
-// Phase 3: K-hop BFS 遍历
+// 批量导入
 //
-// 算法：标准 BFS，用 visited 集合防止重复访问和死循环（处理有环图）。
-// 返回 {node_id -> hop_distance}，不含起始节点。
+// 排序后同一节点的边在下标数组里连续排列（一个 run），
+// 每个 run 对应一个完整的邻接表 blob，只需构建、序列化、写入一次。
+// 排序对象是下标而不是 Edge 本身，交换时不搬动字符串。
 // ══════════════════════════════════════════════════════════════════════════════
 
-std::unordered_map<std::string, int>
-GraphStore::KHopNeighbors(const std::string &start_id, int k) const {
-  std::unordered_map<std::string, int> result;
-  if (k <= 0)
-    return result; // k=0 直接返回空
+namespace {
 
-  std::unordered_set<std::string> visited;
-  // queue 存 {节点ID, 当前跳数}
-  std::queue<std::pair<std::string, int>> q;
+/**
+ * 并行排序：切块后在线程池上分别 std::sort，再逐轮两两 inplace_merge
+ * 同一轮内各段互不重叠，可以并行归并。
+ * pool 为 nullptr 或数据量太小时直接 std::sort。
+ */
+template <typename Cmp>
+void ParallelSort(std::vector<size_t> &idx, Cmp cmp,
+                  minkv::base::ThreadPool *pool) {
+  constexpr size_t kMinChunk = 1 << 14; // 每块至少 16K 个元素才值得拆分
+  size_t n_chunks =
+      pool ? std::min(pool->size() + 1, idx.size() / kMinChunk) : 1;
+  if (n_chunks <= 1) {
+    std::sort(idx.begin(), idx.end(), cmp);
+    return;
+  }
 
-  visited.insert(start_id);
-  q.push({start_id, 0});
+  size_t chunk = (idx.size() + n_chunks - 1) / n_chunks;
+  std::vector<size_t> bounds; // 各段起点，末尾补 idx.size()
+  for (size_t b = 0; b < idx.size(); b += chunk)
+    bounds.push_back(b);
+  bounds.push_back(idx.size());
+  size_t n_segments = bounds.size() - 1;
+
+  std::vector<std::future<void>> futures;
+  for (size_t i = 1; i < n_segments; ++i) {
+    futures.push_back(pool->submit([&idx, &bounds, cmp, i]() {
+      std::sort(idx.begin() + bounds[i], idx.begin() + bounds[i + 1], cmp);
+    }));
+  }
+  // 第一段由调用线程自己排
+  std::sort(idx.begin(), idx.begin() + bounds[1], cmp);
+  for (auto &fut : futures)
+    fut.get();
+
+  for (size_t width = 1; width < n_segments; width *= 2) {
+    futures.clear();
+    for (size_t i = 0; i + width < n_segments; i += 2 * width) {
+      size_t lo = bounds[i];
+      size_t mid = bounds[i + width];
+      size_t hi = bounds[std::min(i + 2 * width, n_segments)];
+      futures.push_back(pool->submit([&idx, cmp, lo, mid, hi]() {
+        std::inplace_merge(idx.begin() + lo, idx.begin() + mid,
+                           idx.begin() + hi, cmp);
+      }));
+    }
+    for (auto &fut : futures)
+      fut.get();
+  }
+}
 
-  while (!q.empty()) {
-    auto [node, depth] = q.front();
-    q.pop();
+} // namespace
+
+BulkImportStats GraphStore::BulkImportEdges(std::vector<Edge> edges,
+                                            bool snapshot_at_end) {
+  using Clock = std::chrono::steady_clock;
+  auto ms_since = [](Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0)
+        .count();
+  };
+
+  BulkImportStats stats;
+  stats.edges_read = edges.size();
+  if (edges.empty())
+    return stats;
+  for (const Edge &edge : edges) {
+    if (edge.valid_from >= edge.valid_to)
+      throw std::invalid_argument("edge valid_from must be < valid_to");
+  }
 
-    if (depth >= k)
-      continue; // 已达到最大跳数，不再扩展
+  // Step 1: 按 (src, dst, label) 排序；同一三元组按输入顺序排列
+  auto t0 = Clock::now();
+  std::vector<size_t> out_order(edges.size());
+  std::iota(out_order.begin(), out_order.end(), 0);
+  ParallelSort(
+      out_order,
+      [&edges](size_t a, size_t b) {
+        const Edge &x = edges[a];
+        const Edge &y = edges[b];
+        if (int c = x.src_id.compare(y.src_id))
+          return c < 0;
+        if (int c = x.dst_id.compare(y.dst_id))
+          return c < 0;
+        if (int c = x.label.compare(y.label))
+          return c < 0;
+        return a < b;
+      },
+      thread_pool_.get());
+
+  // Step 2: 去重，同一三元组只保留最后一次出现（后写覆盖先写）
+  auto same_triple = [&edges](size_t a, size_t b) {
+    return edges[a].src_id == edges[b].src_id &&
+           edges[a].dst_id == edges[b].dst_id &&
+           edges[a].label == edges[b].label;
+  };
+  size_t kept = 0;
+  for (size_t i = 0; i < out_order.size(); ++i) {
+    if (i + 1 < out_order.size() &&
+        same_triple(out_order[i], out_order[i + 1]))
+      continue;
+    out_order[kept++] = out_order[i];
+  }
+  out_order.resize(kept);
+  stats.edges_written = kept;
+
+  // Step 3: 入边方向按 (dst, src, label) 排序（去重后三元组已唯一）
+  std::vector<size_t> in_order = out_order;
+  ParallelSort(
+      in_order,
+      [&edges](size_t a, size_t b) {
+        const Edge &x = edges[a];
+        const Edge &y = edges[b];
+        if (int c = x.dst_id.compare(y.dst_id))
+          return c < 0;
+        if (int c = x.src_id.compare(y.src_id))
+          return c < 0;
+        return x.label < y.label;
+      },
+      thread_pool_.get());
+  stats.sort_ms = ms_since(t0);
+
+  // Step 4: 逐 run 构建邻接表 blob（出边方向顺带写 e: 记录），分批 bulk_load
+  t0 = Clock::now();
+  constexpr size_t kBatchSize = 4096;
+  const size_t threshold = paged_adj_->options().promote_threshold;
+  const bool track_expiry = expiry_enabled_.load(std::memory_order_acquire);
+  auto write_runs = [&](const std::vector<size_t> &order, bool outgoing) {
+    auto owner = [&](size_t i) -> const std::string & {
+      return outgoing ? edges[order[i]].src_id : edges[order[i]].dst_id;
+    };
+    std::vector<size_t> run_starts;
+    for (size_t i = 0; i < order.size(); ++i) {
+      if (i == 0 || owner(i) != owner(i - 1))
+        run_starts.push_back(i);
+    }
+    size_t n_runs = run_starts.size();
+    run_starts.push_back(order.size());
+
+    // 处理 [run_begin, run_end) 这些 run；不同任务的 run 互不重叠
+    auto process = [&, outgoing](size_t run_begin, size_t run_end) {
+      std::vector<std::pair<std::string, std::string>> batch;
+      batch.reserve(kBatchSize + 64);
+      for (size_t r = run_begin; r < run_end; ++r) {
+        const std::string &node = owner(run_starts[r]);
+        std::string key = outgoing ? AdjOutKey(node) : AdjInKey(node);
+
+        // 与已有邻接表合并：(neighbor, label) 已存在时覆盖权重
+        auto current = kv_->get(key);
+        const bool was_paged =
+            current && PagedAdjacency::IsHeader(*current);
+        std::vector<AdjEntry> entries =
+            !current    ? std::vector<AdjEntry>{}
+            : was_paged ? paged_adj_->Load(key, {})
+                        : GraphSerializer::DeserializeAdjEntries(*current);
+        current.reset();
+        std::unordered_map<std::string, size_t> existing;
+        existing.reserve(entries.size());
+        for (size_t j = 0; j < entries.size(); ++j) {
+          existing.emplace(entries[j].neighbor_id + '\0' + entries[j].label,
+                           j);
+        }
+        entries.reserve(entries.size() + run_starts[r + 1] - run_starts[r]);
+
+        for (size_t i = run_starts[r]; i < run_starts[r + 1]; ++i) {
+          const Edge &edge = edges[order[i]];
+          const std::string &neighbor = outgoing ? edge.dst_id : edge.src_id;
+          auto it = existing.empty()
+                        ? existing.end()
+                        : existing.find(neighbor + '\0' + edge.label);
+          if (it != existing.end()) {
+            entries[it->second] = ToAdjEntry(edge, outgoing);
+          } else {
+            entries.push_back(ToAdjEntry(edge, outgoing));
+          }
+          if (outgoing) {
+            if (track_expiry && edge.valid_to != VALID_TO_FOREVER) {
+              edge_expiry_.Add(edge.src_id, edge.dst_id, edge.label,
+                               edge.valid_to);
+            }
+            batch.emplace_back(EdgeKey(edge.src_id, edge.dst_id, edge.label),
+                               GraphSerializer::SerializeEdge(edge));
+          }
+        }
+        degrees_.Set(node, outgoing, entries.size());
+        if (was_paged || (threshold > 0 && entries.size() > threshold)) {
+          // 超级节点直接以分页形式写入；已分页的表不退回单值存储
+          std::lock_guard<std::mutex> stripe(AdjStripe(key));
+          paged_adj_->Store(key, entries);
+        } else {
+          batch.emplace_back(std::move(key),
+                             GraphSerializer::SerializeAdjEntries(entries));
+        }
+
+        if (batch.size() >= kBatchSize) {
+          kv_->bulk_load(batch);
+          batch.clear();
+        }
+      }
+      if (!batch.empty())
+        kv_->bulk_load(batch);
+    };
+
+    size_t n_parts = thread_pool_ && n_runs >= 1024 ? thread_pool_->size() : 1;
+    if (n_parts <= 1) {
+      process(0, n_runs);
+    } else {
+      size_t part = (n_runs + n_parts - 1) / n_parts;
+      std::vector<std::future<void>> futures;
+      for (size_t begin = part; begin < n_runs; begin += part) {
+        futures.push_back(thread_pool_->submit(
+            process, begin, std::min(begin + part, n_runs)));
+      }
+      process(0, std::min(part, n_runs));
+      for (auto &fut : futures)
+        fut.get();
+    }
+    return n_runs;
+  };
+  stats.adj_lists_written = write_runs(out_order, true);
+  stats.adj_lists_written += write_runs(in_order, false);
+  stats.write_ms = ms_since(t0);
+  versions_.TouchAll();
+
+  // Step 5: 导入期间没有写 WAL，结束时整体做一次快照
+  if (snapshot_at_end) {
+    t0 = Clock::now();
+    kv_->create_snapshot();
+    stats.snapshot_ms = ms_since(t0);
+  }
+  return stats;
+}
+
+BulkImportStats GraphStore::BulkImportFile(const std::string &path,
+                                           EdgeFileFormat format,
+                                           bool snapshot_at_end) {
+  auto t0 = std::chrono::steady_clock::now();
+  // 先完整解析再写入：格式错误时抛异常，KV 保持不变
+  std::vector<Edge> edges = GraphEdgeReader::ReadFile(path, format);
+  double parse_ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - t0)
+                        .count();
+
+  BulkImportStats stats = BulkImportEdges(std::move(edges), snapshot_at_end);
+  stats.parse_ms = parse_ms;
+  return stats;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 图快照
+//
+// 节点按 ID 字典序编号，邻接关系用编号存成 CSR。加载时节点 i 的
+// n: / vec: / adj:out / adj:in / 出边 e: 记录都按编号直接定位，
+// 不需要查找、排序或反序列化边记录。
+// ══════════════════════════════════════════════════════════════════════════════
 
-    for (const auto &nb : GetOutNeighbors(node)) {
-      // visited.insert 返回 {iterator, bool}，bool=true 表示是新节点
-      if (visited.insert(nb).second) {
-        result[nb] = depth + 1;
-        q.push({nb, depth + 1});
+GraphSnapshotStats GraphStore::SaveSnapshot(const std::string &path) const {
+  auto t0 = std::chrono::steady_clock::now();
+
+  // Step 1: 在全局锁下取得一致视图；下面只保存指向 all_data 的视图
+  auto all_data = kv_->export_all_data();
+  std::vector<std::pair<std::string, const std::string *>> records, vectors;
+  std::vector<std::pair<EdgeView, const std::string *>> edges;
+  for (const auto &[k, v] : all_data) {
+    try {
+      if (k.compare(0, 2, "n:") == 0) {
+        records.emplace_back(GraphSerializer::ViewNode(v).node_id, &v);
+      } else if (k.compare(0, 2, "e:") == 0) {
+        edges.emplace_back(GraphSerializer::ViewEdge(v), &v);
+      } else if (k.compare(0, 4, "vec:") == 0) {
+        vectors.emplace_back(UnescapeId(std::string_view(k).substr(4)), &v);
       }
+    } catch (const std::exception &) {
+      // 跳过损坏的记录
     }
   }
+
+  // Step 2: 节点字典和标签字典（排序去重，下标即编号）
+  std::vector<std::string> ids, labels;
+  ids.reserve(records.size() + vectors.size() + 2 * edges.size());
+  for (const auto &[id, v] : records)
+    ids.push_back(id);
+  for (const auto &[id, v] : vectors)
+    ids.push_back(id);
+  for (const auto &[e, v] : edges) {
+    ids.emplace_back(e.src_id);
+    ids.emplace_back(e.dst_id);
+    labels.emplace_back(e.label);
+  }
+  auto sort_unique = [](std::vector<std::string> &xs) {
+    std::sort(xs.begin(), xs.end());
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+  };
+  sort_unique(ids);
+  sort_unique(labels);
+  auto index_in = [](const std::vector<std::string> &dict,
+                     std::string_view s) {
+    return static_cast<uint32_t>(
+        std::lower_bound(dict.begin(), dict.end(), s) - dict.begin());
+  };
+
+  const size_t n = ids.size();
+  const size_t m = edges.size();
+  std::vector<const std::string *> node_record(n, nullptr), embedding(n);
+  for (const auto &[id, v] : records)
+    node_record[index_in(ids, id)] = v;
+  for (const auto &[id, v] : vectors)
+    embedding[index_in(ids, id)] = v;
+
+  // Step 3: 按起点 / 终点计数排序得到两个方向的 CSR
+  std::vector<uint32_t> src(m), dst(m), label(m);
+  for (size_t k = 0; k < m; ++k) {
+    src[k] = index_in(ids, edges[k].first.src_id);
+    dst[k] = index_in(ids, edges[k].first.dst_id);
+    label[k] = index_in(labels, edges[k].first.label);
+  }
+  auto build_csr = [n, m](const std::vector<uint32_t> &owner,
+                          std::vector<uint64_t> &row) {
+    row.assign(n + 1, 0);
+    for (uint32_t o : owner)
+      ++row[o + 1];
+    for (size_t i = 0; i < n; ++i)
+      row[i + 1] += row[i];
+    std::vector<size_t> order(m);
+    std::vector<uint64_t> next(row.begin(), row.end() - 1);
+    for (size_t k = 0; k < m; ++k)
+      order[next[owner[k]]++] = k;
+    return order;
+  };
+  std::vector<uint64_t> out_row, in_row;
+  std::vector<size_t> out_order = build_csr(src, out_row);
+  std::vector<size_t> in_order = build_csr(dst, in_row);
+
+  // Step 4: 按段顺序写出
+  GraphSnapshotWriter w(path);
+  auto write_table = [&w](size_t count, const auto &get) {
+    w.AppendU64(count);
+    uint64_t offset = 0;
+    w.AppendU64(offset);
+    for (size_t i = 0; i < count; ++i) {
+      offset += get(i).size();
+      w.AppendU64(offset);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      std::string_view s = get(i);
+      w.Append(s.data(), s.size());
+    }
+  };
+  auto optional_record = [](const std::string *v) {
+    return v ? std::string_view(*v) : std::string_view();
+  };
+  auto write_csr = [&](const std::vector<uint64_t> &row,
+                       const std::vector<size_t> &order,
+                       const std::vector<uint32_t> &neighbor) {
+    w.AppendU64(n);
+    w.Append(row.data(), row.size() * sizeof(uint64_t));
+    w.AppendU64(m);
+    std::vector<uint32_t> column(m);
+    std::vector<float> weight(m);
+    for (size_t k = 0; k < m; ++k)
+      column[k] = neighbor[order[k]];
+    w.Append(column.data(), m * sizeof(uint32_t));
+    for (size_t k = 0; k < m; ++k)
+      column[k] = label[order[k]];
+    w.Append(column.data(), m * sizeof(uint32_t));
+    for (size_t k = 0; k < m; ++k)
+      weight[k] = edges[order[k]].first.weight;
+    w.Append(weight.data(), m * sizeof(float));
+  };
+
+  w.BeginSection(GraphSnapshotSection::NODE_IDS);
+  write_table(n, [&](size_t i) { return std::string_view(ids[i]); });
+  w.BeginSection(GraphSnapshotSection::NODE_RECORDS);
+  write_table(n, [&](size_t i) { return optional_record(node_record[i]); });
+  w.BeginSection(GraphSnapshotSection::EMBEDDINGS);
+  write_table(n, [&](size_t i) { return optional_record(embedding[i]); });
+  w.BeginSection(GraphSnapshotSection::LABELS);
+  write_table(labels.size(),
+              [&](size_t i) { return std::string_view(labels[i]); });
+  w.BeginSection(GraphSnapshotSection::OUT_CSR);
+  write_csr(out_row, out_order, dst);
+  w.BeginSection(GraphSnapshotSection::IN_CSR);
+  write_csr(in_row, in_order, src);
+  w.BeginSection(GraphSnapshotSection::EDGE_RECORDS);
+  write_table(m, [&](size_t k) {
+    return std::string_view(*edges[out_order[k]].second);
+  });
+  std::vector<GraphSnapshotReader::TemporalEdge> temporal;
+  for (size_t k = 0; k < m; ++k) {
+    const EdgeView &e = edges[k].first;
+    if (e.valid_from != VALID_FROM_ALWAYS || e.valid_to != VALID_TO_FOREVER)
+      temporal.push_back({src[k], dst[k], label[k], 0, e.valid_from,
+                          e.valid_to});
+  }
+  std::sort(temporal.begin(), temporal.end(), [](const auto &a, const auto &b) {
+    return std::tie(a.src, a.dst, a.label) < std::tie(b.src, b.dst, b.label);
+  });
+  w.BeginSection(GraphSnapshotSection::TEMPORAL_EDGES);
+  w.AppendU64(temporal.size());
+  w.Append(temporal.data(), temporal.size() * sizeof(temporal[0]));
+
+  GraphSnapshotStats stats;
+  stats.bytes = w.Finish(n, m, labels.size());
+  stats.nodes = n;
+  stats.node_records = records.size();
+  stats.edges = m;
+  stats.embeddings = vectors.size();
+  stats.labels = labels.size();
+  stats.elapsed_ms = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - t0)
+                         .count();
+  return stats;
+}
+
+GraphSnapshotStats GraphStore::LoadSnapshot(const std::string &path) {
+  auto t0 = std::chrono::steady_clock::now();
+  // 校验失败在这里抛出，此时还没有写入任何数据
+  GraphSnapshotReader snap(path);
+  const size_t n = snap.node_count();
+
+  std::vector<std::string> labels;
+  labels.reserve(snap.label_count());
+  for (size_t j = 0; j < snap.label_count(); ++j)
+    labels.emplace_back(snap.Label(j));
+
+  // 处理节点 [begin, end)；不同任务的节点互不重叠，写入的 Key 也互不重叠
+  constexpr size_t kBatchSize = 4096;
+  const size_t threshold = paged_adj_->options().promote_threshold;
+  const bool has_temporal = snap.temporal_count() > 0;
+  const bool track_expiry = expiry_enabled_.load(std::memory_order_acquire);
+  auto process = [&](size_t begin, size_t end) {
+    std::vector<std::pair<std::string, std::string>> batch;
+    batch.reserve(kBatchSize + 64);
+    std::vector<AdjEntry> entries;
+    for (size_t i = begin; i < end; ++i) {
+      const std::string id(snap.NodeId(i));
+      if (std::string_view rec = snap.NodeRecord(i); !rec.empty())
+        batch.emplace_back(NodeKey(id), std::string(rec));
+      if (std::string_view vec = snap.Embedding(i); !vec.empty())
+        batch.emplace_back(VecKey(id), std::string(vec));
+
+      for (bool outgoing : {true, false}) {
+        const auto &csr = outgoing ? snap.Out() : snap.In();
+        entries.clear();
+        for (uint64_t k = csr.row[i]; k < csr.row[i + 1]; ++k) {
+          entries.push_back({std::string(snap.NodeId(csr.neighbor[k])),
+                             labels[csr.label[k]], csr.weight[k]});
+          if (has_temporal) {
+            uint32_t self = static_cast<uint32_t>(i);
+            auto [from, to] =
+                outgoing
+                    ? snap.Validity(self, csr.neighbor[k], csr.label[k])
+                    : snap.Validity(csr.neighbor[k], self, csr.label[k]);
+            entries.back().valid_from = from;
+            entries.back().valid_to = to;
+            if (outgoing && track_expiry && to != VALID_TO_FOREVER) {
+              edge_expiry_.Add(id, entries.back().neighbor_id,
+                               entries.back().label, to);
+            }
+          }
+          if (outgoing) {
+            batch.emplace_back(
+                EdgeKey(id, entries.back().neighbor_id, entries.back().label),
+                std::string(snap.EdgeRecord(k)));
+          }
+        }
+        if (entries.empty())
+          continue;
+        std::string key = outgoing ? AdjOutKey(id) : AdjInKey(id);
+        degrees_.Set(id, outgoing, entries.size());
+        if (threshold > 0 && entries.size() > threshold) {
+          std::lock_guard<std::mutex> stripe(AdjStripe(key));
+          paged_adj_->Store(key, entries);
+        } else {
+          batch.emplace_back(std::move(key),
+                             GraphSerializer::SerializeAdjEntries(entries));
+        }
+      }
+
+      if (batch.size() >= kBatchSize) {
+        kv_->bulk_load(batch);
+        batch.clear();
+      }
+    }
+    if (!batch.empty())
+      kv_->bulk_load(batch);
+  };
+
+  size_t n_parts = thread_pool_ && n >= 1024 ? thread_pool_->size() : 1;
+  if (n_parts <= 1) {
+    process(0, n);
+  } else {
+    size_t part = (n + n_parts - 1) / n_parts;
+    std::vector<std::future<void>> futures;
+    for (size_t begin = part; begin < n; begin += part) {
+      futures.push_back(
+          thread_pool_->submit(process, begin, std::min(begin + part, n)));
+    }
+    process(0, std::min(part, n));
+    for (auto &fut : futures)
+      fut.get();
+  }
+
+  GraphSnapshotStats stats;
+  stats.nodes = n;
+  stats.edges = snap.edge_count();
+  stats.labels = snap.label_count();
+  stats.bytes = snap.file_size();
+  // 已启用的索引同步更新；启动时通常尚未启用，此时只是计数
+  const bool index = keyword_index_ || property_index_.Enabled();
+  for (size_t i = 0; i < n; ++i) {
+    if (!snap.Embedding(i).empty())
+      ++stats.embeddings;
+    std::string_view rec = snap.NodeRecord(i);
+    if (rec.empty())
+      continue;
+    ++stats.node_records;
+    if (!index)
+      continue;
+    try {
+      NodeView node = GraphSerializer::ViewNode(rec);
+      std::string id(node.node_id), props(node.properties_json);
+      property_index_.Commit(id, &props, [] {});
+      if (keyword_index_)
+        keyword_index_->Upsert(id, props);
+    } catch (const std::exception &) {
+      // 跳过损坏的节点数据
+    }
+  }
+  versions_.TouchAll();
+
+  stats.elapsed_ms = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - t0)
+                         .count();
+  return stats;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// Phase 3: 按层扩展 frontier
+//
+// BFS 每一层的主要开销是"逐个节点读邻接表 + 反序列化"，各节点之间互不依赖，
+// 适合并行；而 visited 去重与结果合并依赖全局状态，保持串行即可。
+// 因此采用 level-synchronous 模型：并行读取一整层的邻接表，再由调用线程合并。
+//
+// frontier 较小时提交任务的开销（入队 + 唤醒 + future 等待，约 10μs 量级）
+// 会超过收益，所以低于阈值时直接在调用线程串行读取。
+// ══════════════════════════════════════════════════════════════════════════════
+
+// frontier 节点数达到该值才并行扩展；同时也是每个并行任务的最小块大小
+static constexpr size_t PARALLEL_FRONTIER_THRESHOLD = 256;
+
+// 每读取这么多个节点的邻接表检查一次取消令牌
+static constexpr size_t EXPAND_CANCEL_INTERVAL = 64;
+
+std::vector<std::vector<std::string>>
+GraphStore::ExpandFrontier(const std::vector<std::string> &frontier,
+                           const TraversalFilter &filter, bool allow_parallel,
+                           const base::CancellationToken &cancel) const {
+  std::vector<std::vector<std::string>> lists(frontier.size());
+  auto load_range = [this, &frontier, &lists, &filter, &cancel](size_t begin,
+                                                                size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      if ((i - begin) % EXPAND_CANCEL_INTERVAL == 0 && cancel.cancelled())
+        return; // 其余节点的邻居列表留空
+      lists[i] = GetNeighbors(frontier[i], filter);
+    }
+  };
+
+  if (!allow_parallel || !thread_pool_ ||
+      frontier.size() < PARALLEL_FRONTIER_THRESHOLD) {
+    load_range(0, frontier.size());
+    return lists;
+  }
+
+  // 块数不超过线程数，每块至少 PARALLEL_FRONTIER_THRESHOLD 个节点
+  size_t n_chunks = std::min(thread_pool_->size(),
+                             frontier.size() / PARALLEL_FRONTIER_THRESHOLD);
+  size_t chunk = (frontier.size() + n_chunks - 1) / n_chunks;
+
+  // 每个任务只写 lists 中属于自己的下标区间，无需加锁
+  std::vector<std::future<void>> futures;
+  futures.reserve(n_chunks);
+  for (size_t begin = chunk; begin < frontier.size(); begin += chunk) {
+    size_t end = std::min(begin + chunk, frontier.size());
+    futures.push_back(thread_pool_->submit(load_range, begin, end));
+  }
+  // 第一块由调用线程自己处理，少一次任务切换
+  load_range(0, std::min(chunk, frontier.size()));
+  for (auto &fut : futures) {
+    fut.get();
+  }
+  return lists;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// Phase 3: K-hop BFS 遍历
+//
+// 算法：按层 BFS，用 visited 集合防止重复访问和死循环（处理有环图）。
+// 单源 KHopNeighbors 是多源 BFS 只有一个起点的特例。
+//
+// 多源 BFS：所有起点一起作为第 0 层，距离表 dist 兼作共享的 visited 集合。
+// 与"每个起点各跑一次 BFS 再合并"相比：
+//   - 邻域重叠的节点只扩展一次，不会被每个起点重复读取邻接表
+//   - 只维护一张哈希表，而不是每个起点一张
+//   - 各层 frontier 合并后更大，更容易达到 ExpandFrontier 的并行阈值
+// 一个节点最早在第 d 层被发现，d 就是它到最近起点的跳数。
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::unordered_map<std::string, int>
+GraphStore::KHopNeighbors(const std::string &start_id, int k,
+                          const TraversalFilter &filter,
+                          const base::CancellationToken &cancel) const {
+  if (k <= 0)
+    return {}; // k=0 直接返回空
+
+  auto result = MultiSourceKHop({start_id}, k, filter, cancel);
+  result.erase(start_id); // 结果不含起始节点自身
   return result;
 }
 
+std::unordered_map<std::string, int>
+GraphStore::MultiSourceKHop(const std::vector<std::string> &sources, int k,
+                            const TraversalFilter &filter,
+                            const base::CancellationToken &cancel) const {
+  std::unordered_map<std::string, int> dist;
+  std::vector<std::string> frontier;
+  for (const auto &src : sources) {
+    if (dist.emplace(src, 0).second)
+      frontier.push_back(src);
+  }
+
+  // 取消后已读到的部分邻居照常合并，下一层不再开始
+  for (int depth = 1; depth <= k && !frontier.empty() && !cancel.cancelled();
+       ++depth) {
+    auto lists =
+        ExpandFrontier(frontier, filter, /*allow_parallel=*/true, cancel);
+
+    std::vector<std::string> next;
+    for (auto &list : lists) {
+      for (auto &nb : list) {
+        // emplace 返回 {iterator, bool}，bool=true 表示是新节点
+        if (dist.emplace(nb, depth).second) {
+          next.push_back(std::move(nb));
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+  return dist;
+}
+
 // ══════════════════════════════════════════════════════════════════════════════
-// Phase 3: 最短路径查询（BFS）
+// Phase 3: 最短路径查询（双向 BFS）
 //
-// 用 parent map 记录每个节点的前驱，找到终点后回溯还原路径。
+// 正向从 src 沿 adj:out 扩展，反向从 dst 沿 adj:in 扩展，
+// 两侧各用一个 parent map 记录前驱（兼作 visited 集合）。
+//
+// 每轮只扩展 frontier 较小的一侧的一整层。正确性：
+//   设此前正向已探索到深度 df、反向到深度 db 且两侧未相遇，
+//   则最短路径长度 L >= df + db + 1。本层若发现相遇节点 v，
+//   路径长度为 df + 1 + depth_b(v) <= df + db + 1，因此等于 L，即为最短路径。
+//
+// 在平均出度为 d 的图上，单向 BFS 要探索约 d^L 个节点，
+// 双向只需约 2 * d^(L/2) 个。
 // ══════════════════════════════════════════════════════════════════════════════
 
-std::vector<std::string> GraphStore::FindPath(const std::string &src_id,
-                                              const std::string &dst_id,
-                                              int max_hops) const {
+std::vector<std::string> GraphStore::FindPath(
+    const std::string &src_id, const std::string &dst_id, int max_hops,
+    const TraversalFilter &filter) const {
   // 特殊情况：起点等于终点
   if (src_id == dst_id)
     return {src_id};
+  if (max_hops <= 0)
+    return {};
 
-  // parent[node] = 到达 node 的前驱节点，用于路径回溯
-  std::unordered_map<std::string, std::string> parent;
-  std::queue<std::string> q;
-  std::unordered_set<std::string> visited;
-
-  visited.insert(src_id);
-  q.push(src_id);
-  int hops = 0;
+  // parent_fwd[node] = 正向到达 node 的前驱；parent_bwd[node] = 反向的后继
+  // 起点/终点的 parent 指向自身，作为回溯终止标记
+  std::unordered_map<std::string, std::string> parent_fwd{{src_id, src_id}};
+  std::unordered_map<std::string, std::string> parent_bwd{{dst_id, dst_id}};
+  std::vector<std::string> frontier_fwd{src_id};
+  std::vector<std::string> frontier_bwd{dst_id};
+  int hops = 0; // 两侧已扩展的层数之和
+
+  // 反向一侧沿相反方向扩展：OUT <-> IN，BOTH 不变
+  TraversalFilter reverse_filter = filter;
+  if (filter.direction == Direction::OUT)
+    reverse_filter.direction = Direction::IN;
+  else if (filter.direction == Direction::IN)
+    reverse_filter.direction = Direction::OUT;
+
+  // 拼接路径：src -> ... -> meet（正向回溯）+ meet -> ... -> dst（反向回溯）
+  auto build_path = [&](const std::string &meet) {
+    std::vector<std::string> path;
+    for (std::string n = meet; n != src_id; n = parent_fwd[n]) {
+      path.push_back(n);
+    }
+    path.push_back(src_id);
+    // 正向回溯得到的是逆序，翻转后得到 src -> meet
+    std::reverse(path.begin(), path.end());
+    for (std::string n = meet; n != dst_id;) {
+      n = parent_bwd[n];
+      path.push_back(n);
+    }
+    return path;
+  };
 
-  while (!q.empty() && hops < max_hops) {
-    // 按层处理，每层代表一跳
-    int level_size = static_cast<int>(q.size());
+  while (!frontier_fwd.empty() && !frontier_bwd.empty() && hops < max_hops) {
     ++hops;
+    // 扩展较小的一侧，使两侧探索量保持平衡
+    const bool forward = frontier_fwd.size() <= frontier_bwd.size();
+    auto &frontier = forward ? frontier_fwd : frontier_bwd;
+    auto &parent = forward ? parent_fwd : parent_bwd;
+    const auto &other = forward ? parent_bwd : parent_fwd;
+
+    auto lists = ExpandFrontier(frontier, forward ? filter : reverse_filter,
+                                /*allow_parallel=*/true);
+
+    std::vector<std::string> next;
+    for (size_t i = 0; i < frontier.size(); ++i) {
+      for (auto &nb : lists[i]) {
+        if (!parent.emplace(nb, frontier[i]).second)
+          continue; // 本侧已访问
+        if (other.count(nb)) {
+          return build_path(nb); // 两侧相遇
+        }
+        next.push_back(std::move(nb));
+      }
+    }
+    frontier.swap(next);
+  }
+  return {}; // 无路径或超出 max_hops
+}
 
-    for (int i = 0; i < level_size; ++i) {
-      std::string cur = q.front();
-      q.pop();
+// ══════════════════════════════════════════════════════════════════════════════
+// Phase 3: 带权最短路径（Dijkstra / A*）
+//
+// 节点 ID 整数化：搜索过程中第一次见到的节点分配连续整数 ID，
+// g 值、前驱、堆句柄、状态都按整数 ID 存在数组里。
+// 字符串只在"读邻接表"和"interning 查表"时出现一次，
+// 松弛与出入堆全部是整数/数组操作，比 unordered_map<string, ...> 快得多。
+//
+// open 集合使用配对堆（decrease-key 摊还 o(log n)，见 pairing_heap.h）：
+//   每个节点在堆中最多一个元素，g 值变小时原地 decrease_key。
+//   优先级是浮点数（A* 的 f = g + h 也不单调），因此没有选用只支持
+//   单调整数键的 radix heap。
+//
+// A* 的启发值 h(v) 在节点首次被发现时计算一次（一次 vec: 读取 + L2 距离），
+// 之后复用；heuristic_scale == 0 时跳过 embedding 读取，即纯 Dijkstra。
+// ══════════════════════════════════════════════════════════════════════════════
 
-      for (const auto &nb : GetOutNeighbors(cur)) {
-        if (visited.insert(nb).second) {
-          parent[nb] = cur; // 记录前驱
+WeightedPath GraphStore::FindWeightedPath(const std::string &src_id,
+                                          const std::string &dst_id) const {
+  return WeightedSearch(src_id, dst_id, /*heuristic_scale=*/0.0f);
+}
 
-          if (nb == dst_id) {
-            // 找到终点，从 parent map 回溯路径
-            std::vector<std::string> path;
-            for (std::string n = dst_id; n != src_id; n = parent[n]) {
-              path.push_back(n);
-            }
-            path.push_back(src_id);
-            // 回溯得到的是逆序，翻转后得到正向路径
-            std::reverse(path.begin(), path.end());
-            return path;
+WeightedPath GraphStore::FindWeightedPathAStar(const std::string &src_id,
+                                               const std::string &dst_id,
+                                               float heuristic_scale) const {
+  return WeightedSearch(src_id, dst_id, heuristic_scale);
+}
+
+WeightedPath GraphStore::WeightedSearch(const std::string &src_id,
+                                        const std::string &dst_id,
+                                        float heuristic_scale) const {
+  WeightedPath result;
+  if (src_id == dst_id) {
+    result.path = {src_id};
+    return result;
+  }
+
+  // 目标节点 embedding：为空时 h 恒为 0（退化为 Dijkstra）
+  std::vector<float> dst_emb;
+  if (heuristic_scale > 0.0f)
+    dst_emb = GetNodeEmbedding(dst_id);
+
+  enum : uint8_t { UNSEEN = 0, OPEN = 1, CLOSED = 2 };
+  constexpr double INF = std::numeric_limits<double>::infinity();
+  constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+  // 整数 ID 映射及按 ID 索引的搜索状态
+  std::unordered_map<std::string, uint32_t> id_of;
+  std::vector<std::string> names;
+  std::vector<double> g;
+  std::vector<float> h;
+  std::vector<uint32_t> parent;
+  std::vector<PairingHeap<double>::Handle> handle;
+  std::vector<uint8_t> state;
+
+  auto intern = [&](const std::string &name) -> uint32_t {
+    auto [it, inserted] =
+        id_of.emplace(name, static_cast<uint32_t>(names.size()));
+    if (!inserted)
+      return it->second;
+    names.push_back(name);
+    g.push_back(INF);
+    parent.push_back(NO_PARENT);
+    handle.push_back(0);
+    state.push_back(UNSEEN);
+    float hv = 0.0f;
+    if (!dst_emb.empty()) {
+      auto emb = GetNodeEmbedding(name);
+      if (emb.size() == dst_emb.size()) {
+        hv = heuristic_scale *
+             VectorOps::L2Distance(emb.data(), dst_emb.data(), emb.size());
+      }
+    }
+    h.push_back(hv);
+    return it->second;
+  };
+
+  const uint32_t src = intern(src_id);
+  const uint32_t dst = intern(dst_id);
+  g[src] = 0.0;
+
+  PairingHeap<double> open;
+  handle[src] = open.push(src, h[src]);
+  state[src] = OPEN;
+
+  while (!open.empty()) {
+    const uint32_t u = open.top();
+    open.pop();
+    state[u] = CLOSED;
+
+    if (u == dst) {
+      for (uint32_t n = dst; n != NO_PARENT; n = parent[n]) {
+        result.path.push_back(names[n]);
+      }
+      std::reverse(result.path.begin(), result.path.end());
+      result.cost = g[dst];
+      return result;
+    }
+
+    ++result.expanded;
+    // names 会在 intern 时扩容，先拷出 Key 再遍历
+    auto entries = LoadAdjEntries(AdjOutKey(names[u]));
+    for (const auto &e : entries) {
+      if (std::isnan(e.weight) || e.weight < 0.0f) {
+        throw std::domain_error("FindWeightedPath: negative or NaN weight on "
+                                "edge " +
+                                names[u] + " -> " + e.neighbor_id);
+      }
+      const uint32_t v = intern(e.neighbor_id);
+      const double ng = g[u] + e.weight;
+      if (ng >= g[v])
+        continue; // 多重边或更差的路径
+
+      g[v] = ng;
+      parent[v] = u;
+      const double f = ng + h[v];
+      if (state[v] == OPEN) {
+        open.decrease_key(handle[v], f);
+      } else {
+        // UNSEEN：首次入堆；CLOSED：启发函数不一致时重新打开
+        handle[v] = open.push(v, f);
+        state[v] = OPEN;
+      }
+    }
+  }
+  return result; // 不可达
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// Phase 3: 遍历管道
+//
+// 推式（push）流水线：每一步接收上游的一批节点 ID，处理后把输出分批
+// 推给下一步；返回 false 表示下游已饱和（LIMIT 满足），上游立即停止，
+// 剩余的起点和邻接表都不再读取。
+//
+// 规划只做一件事：EXPAND 后面紧跟的 FILTER 若能完全由二级索引判定，
+// 就并入 EXPAND 的 node_predicates，在读邻接表时直接剪掉不满足的邻居
+// （LoadFilteredEntries → RetainMatching），省掉一次节点记录读取。
+// ══════════════════════════════════════════════════════════════════════════════
+
+TraversalResult GraphStore::Traverse(const TraversalPipeline &pipeline) const {
+  TraversalResult result;
+  TraversalStats &stats = result.stats;
+
+  std::vector<std::string> start;
+  if (!pipeline.start.empty()) {
+    std::unordered_set<std::string> seen;
+    for (const auto &id : pipeline.start) {
+      if (seen.insert(id).second)
+        start.push_back(id);
+    }
+  } else if (!pipeline.start_where.empty()) {
+    start = FindNodeIdsByProperties(pipeline.start_where);
+  } else {
+    throw std::invalid_argument("traversal needs start or start_where");
+  }
+
+  struct Stage {
+    TraversalStep step;
+    std::unordered_set<std::string> seen; // EXPAND：本步已输出的节点
+    size_t emitted = 0;                   // LIMIT：已放行的节点数
+  };
+  std::vector<Stage> stages;
+  for (const auto &step : pipeline.steps) {
+    if (step.kind == TraversalStepKind::FILTER && !stages.empty() &&
+        stages.back().step.kind == TraversalStepKind::EXPAND &&
+        property_index_.CanServe(step.predicates)) {
+      auto &pushed = stages.back().step.filter.node_predicates;
+      pushed.insert(pushed.end(), step.predicates.begin(),
+                    step.predicates.end());
+      ++stats.filters_pushed_down;
+      continue;
+    }
+    stages.push_back({step, {}, 0});
+    auto &filter = stages.back().step.filter;
+    if (step.kind == TraversalStepKind::EXPAND && !filter.as_of)
+      filter.as_of = pipeline.as_of;
+  }
+
+  const size_t batch = std::max<size_t>(pipeline.batch_size, 1);
+  std::vector<std::string> output;
+  std::function<bool(size_t, std::vector<std::string>)> push =
+      [&](size_t s, std::vector<std::string> ids) -> bool {
+    if (ids.empty())
+      return true;
+    if (s == stages.size()) {
+      output.insert(output.end(), std::make_move_iterator(ids.begin()),
+                    std::make_move_iterator(ids.end()));
+      return true;
+    }
+
+    Stage &stage = stages[s];
+    switch (stage.step.kind) {
+    case TraversalStepKind::EXPAND: {
+      // 上游一批可能很大（超级节点的全部邻居），这里再按 batch 切分
+      for (size_t begin = 0; begin < ids.size(); begin += batch) {
+        std::vector<std::string> chunk(
+            ids.begin() + begin,
+            ids.begin() + std::min(begin + batch, ids.size()));
+        auto lists = ExpandFrontier(chunk, stage.step.filter,
+                                    /*allow_parallel=*/true);
+        ++stats.batches;
+        stats.nodes_expanded += chunk.size();
+
+        std::vector<std::string> out;
+        for (auto &list : lists) {
+          stats.neighbors_scanned += list.size();
+          for (auto &nb : list) {
+            if (stage.seen.insert(nb).second)
+              out.push_back(std::move(nb));
+          }
+          if (out.size() >= batch) {
+            if (!push(s + 1, std::move(out)))
+              return false;
+            out.clear();
           }
-          q.push(nb);
         }
+        if (!push(s + 1, std::move(out)))
+          return false;
+      }
+      return true;
+    }
+    case TraversalStepKind::FILTER: {
+      // 节点记录按分片批量读取，在视图上判定谓词，不物化 Node
+      std::vector<char> keep(ids.size(), 0);
+      VisitNodes(ids, [&](size_t i, const NodeView &view) {
+        keep[i] = MatchesPredicates(view.properties_json,
+                                    stage.step.predicates);
+      });
+      stats.nodes_filtered += ids.size();
+      std::vector<std::string> out;
+      for (size_t i = 0; i < ids.size(); ++i) {
+        if (keep[i])
+          out.push_back(std::move(ids[i]));
       }
+      return push(s + 1, std::move(out));
     }
+    case TraversalStepKind::LIMIT: {
+      size_t room = stage.step.limit - stage.emitted;
+      if (ids.size() > room)
+        ids.resize(room);
+      stage.emitted += ids.size();
+      if (!push(s + 1, std::move(ids)))
+        return false;
+      return stage.emitted < stage.step.limit;
+    }
+    }
+    return true;
+  };
+
+  // LIMIT 0：一个节点都不放行，不需要读取任何数据
+  stats.limit_reached =
+      std::any_of(stages.begin(), stages.end(), [](const Stage &stage) {
+        return stage.step.kind == TraversalStepKind::LIMIT &&
+               stage.step.limit == 0;
+      });
+  for (size_t begin = 0; begin < start.size() && !stats.limit_reached;
+       begin += batch) {
+    std::vector<std::string> chunk(
+        start.begin() + begin,
+        start.begin() + std::min(begin + batch, start.size()));
+    stats.limit_reached = !push(0, std::move(chunk));
   }
-  return {}; // 无路径或超出 max_hops
+
+  result.nodes = LoadExistingNodes(output, pipeline.projection);
+  return result;
 }
 
 // ══════════════════════════════════════════════════════════════════════════════
@@ -536,6 +1954,7 @@ void GraphStore::SetNodeEmbedding(const std::string &node_id,
   std::string raw(reinterpret_cast<const char *>(embedding.data()),
                   embedding.size() * sizeof(float));
   kv_->put(VecKey(node_id), raw);
+  versions_.TouchAll(); // 可能改变任意查询的入口节点
 }
 
 /**
@@ -565,8 +1984,9 @@ GraphStore::GetNodeEmbedding(const std::string &node_id) const {
  */
 std::vector<std::pair<std::string, float>>
 GraphStore::SearchSimilarNodes(const std::vector<float> &query_embedding,
-                               int top_k) const {
-  if (query_embedding.empty() || top_k <= 0)
+                               int top_k,
+                               const base::CancellationToken &cancel) const {
+  if (query_embedding.empty() || top_k <= 0 || cancel.cancelled())
     return {};
 
   const size_t query_dim = query_embedding.size();
@@ -579,8 +1999,13 @@ GraphStore::SearchSimilarNodes(const std::vector<float> &query_embedding,
 
   auto all_data = kv_->export_all_data();
   static const std::string VEC_PREFIX = "vec:";
+  // 每扫描这么多条检查一次取消令牌，取消后保留已扫描部分的 top-k
+  static constexpr size_t CANCEL_INTERVAL = 1024;
 
+  size_t scanned = 0;
   for (const auto &[k, v] : all_data) {
+    if (++scanned % CANCEL_INTERVAL == 0 && cancel.cancelled())
+      break;
     // 只处理 vec: 前缀的 Key
     if (k.size() <= VEC_PREFIX.size() ||
         k.substr(0, VEC_PREFIX.size()) != VEC_PREFIX) {
@@ -647,67 +2072,425 @@ GraphStore::SearchSimilarNodes(const std::vector<float> &query_embedding,
  * GraphRAG 两阶段查询（Phase 4）
  *
  * Phase 1：SearchSimilarNodes 找到 vector_top_k 个入口节点
- * Phase 2：对每个入口节点并发做 KHopNeighbors(hop_depth) 扩展，合并去重
- *   - 每个入口节点的 BFS 用 std::async 独立启动
- *   - BFS 是纯读操作，ShardedCache 的 shared_lock 支持并发读，无锁竞争
- *   - 结果合并用 mutex 保护，合并开销远小于 BFS 本身
- * Phase 3：加载所有节点的完整属性，跳过不存在的节点
+ * Phase 2：所有入口节点一起做多源 BFS（MultiSourceKHop），
+ *          语义相近的入口节点邻域往往重叠，重叠部分只扩展一次；
+ *          每层 frontier 足够大时由 ExpandFrontier 并行读取邻接表
+ * Phase 3：按 projection 加载节点属性，跳过不存在的节点
  *
- * 并发收益：top_k 个入口节点的 BFS 从串行变并行，
- * 在多核机器上延迟接近单次 BFS，而非 top_k 倍。
+ * 启用查询缓存时，条目按遍历到的全部节点 ID（含不存在的节点，
+ * 它们被 AddNode 后结果会变化）记录区域掩码。
+ * projection 是 Key 的一部分，缓存的是裁剪后的结果。
  */
 std::vector<Node>
 GraphStore::GraphRAGQuery(const std::vector<float> &query_embedding,
-                          int vector_top_k, int hop_depth) const {
+                          int vector_top_k, int hop_depth,
+                          const TraversalFilter &filter,
+                          const Projection &projection,
+                          const base::CancellationToken &cancel) const {
+  // 查询缓存：先查有效条目；未命中时在计算前取版本快照。
+  // 带节点谓词时不缓存：被谓词剪掉的邻居不在结果里，区域掩码覆盖不到它们
+  std::string cache_key;
+  GraphVersionTracker::Snapshot snap;
+  const bool use_cache = query_cache_ && filter.node_predicates.empty();
+  if (use_cache) {
+    cache_key = query_cache_->MakeKey(query_embedding, vector_top_k,
+                                      hop_depth, filter, projection);
+    if (auto hit = query_cache_->Lookup(cache_key))
+      return std::move(*hit);
+    snap = versions_.Take();
+  }
+
   // Phase 1: 向量检索入口节点
-  auto entries = SearchSimilarNodes(query_embedding, vector_top_k);
-  if (entries.empty())
-    return {};
+  auto entries = SearchSimilarNodes(query_embedding, vector_top_k, cancel);
 
-  // Phase 2: 并发 K-hop 扩展
-  // 策略：有线程池 且 入口节点 > 1 且 hop_depth >= 2 时并发，否则串行
-  // 线程池预创建线程，消除 std::async 每次创建线程的 50~200μs 开销
-  const bool use_parallel = thread_pool_ &&
-                            (static_cast<int>(entries.size()) > 1) &&
-                            (hop_depth >= 2);
+  // Phase 2: 多源 K-hop 扩展（结果包含入口节点自身）
+  std::vector<std::string> ids;
+  if (!entries.empty()) {
+    std::vector<std::string> sources;
+    sources.reserve(entries.size());
+    for (const auto &[entry_id, score] : entries) {
+      sources.push_back(entry_id);
+    }
+    auto reached = MultiSourceKHop(sources, hop_depth, filter, cancel);
+    ids.reserve(reached.size());
+    for (const auto &[node_id, dist] : reached)
+      ids.push_back(node_id);
+  }
 
-  std::unordered_set<std::string> all_node_ids;
-  for (const auto &[entry_id, score] : entries) {
-    all_node_ids.insert(entry_id);
+  // Phase 3: 按投影批量加载节点属性，跳过不存在的节点
+  auto nodes = LoadExistingNodes(ids, projection);
+  if (use_cache && !cancel.cancelled()) // 部分结果不缓存
+    query_cache_->Insert(cache_key, snap, ids, nodes);
+  return nodes;
+}
+
+/**
+ * 混合 GraphRAG：向量检索与 BM25 关键词检索各取 candidate_k 个候选，
+ * 用倒数排名融合（RRF）合并。RRF 只看名次，不需要把余弦相似度和 BM25
+ * 得分归一化到同一量纲。得分相同按 node_id 排序，保证结果确定。
+ *
+ * 不经过查询缓存：Key 需要包含查询文本，且关键词一路受节点属性变更
+ * 影响，区域掩码无法覆盖所有候选。
+ */
+HybridGraphRAGResult
+GraphStore::GraphRAGQueryHybrid(const std::vector<float> &query_embedding,
+                                const std::string &query_text, int hop_depth,
+                                const HybridSearchOptions &options,
+                                const TraversalFilter &filter,
+                                const Projection &projection,
+                                const base::CancellationToken &cancel) const {
+  // 名次从 1 开始，rrf_k >= 0 保证 1 / (rrf_k + rank) 的分母为正
+  if (options.candidate_k <= 0)
+    throw std::invalid_argument("candidate_k must be > 0");
+  if (options.rrf_k < 0)
+    throw std::invalid_argument("rrf_k must be >= 0");
+  HybridGraphRAGResult result;
+
+  // Phase 1: 两路候选
+  std::vector<std::pair<std::string, float>> vector_hits;
+  if (!query_embedding.empty())
+    vector_hits =
+        SearchSimilarNodes(query_embedding, options.candidate_k, cancel);
+  auto keyword_hits = SearchKeyword(query_text, options.candidate_k);
+
+  // Phase 2: 倒数排名融合
+  std::unordered_map<std::string, FusedEntry> fused;
+  auto add = [&](const std::string &id, int rank, bool is_vector) {
+    FusedEntry &e = fused[id];
+    e.node_id = id;
+    e.score += 1.0 / (options.rrf_k + rank);
+    (is_vector ? e.vector_rank : e.keyword_rank) = rank;
+  };
+  for (size_t i = 0; i < vector_hits.size(); ++i)
+    add(vector_hits[i].first, static_cast<int>(i + 1), true);
+  for (size_t i = 0; i < keyword_hits.size(); ++i)
+    add(keyword_hits[i].first, static_cast<int>(i + 1), false);
+
+  result.entries.reserve(fused.size());
+  for (auto &[id, entry] : fused)
+    result.entries.push_back(std::move(entry));
+  std::sort(result.entries.begin(), result.entries.end(),
+            [](const FusedEntry &a, const FusedEntry &b) {
+              return a.score != b.score ? a.score > b.score
+                                        : a.node_id < b.node_id;
+            });
+  if (result.entries.size() > static_cast<size_t>(options.entry_top_k))
+    result.entries.resize(std::max(options.entry_top_k, 0));
+  if (result.entries.empty())
+    return result;
+
+  // Phase 3: 多源 K-hop 扩展 + 按投影加载
+  std::vector<std::string> sources;
+  sources.reserve(result.entries.size());
+  for (const auto &e : result.entries)
+    sources.push_back(e.node_id);
+  auto reached = MultiSourceKHop(sources, hop_depth, filter, cancel);
+  std::vector<std::string> ids;
+  ids.reserve(reached.size());
+  for (const auto &[node_id, dist] : reached)
+    ids.push_back(node_id);
+  result.nodes = LoadExistingNodes(ids, projection);
+  return result;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// Phase 4: 有界 GraphRAG（扇出采样 + 结果上限 + 截止时间）
+//
+// 普通 GraphRAGQuery 在遇到超级节点时会把它的全部邻居拉进下一层，
+// 两跳之后结果就可能上万个节点，延迟随之失控。这里逐节点扩展并随时检查预算：
+//   - 扇出：邻居条目超过 max_fanout 时先采样再入队，超级节点只贡献有限个邻居
+//   - 结果数：已发现节点数达到 max_results 立即停止
+//   - 时间：每扩展一个节点检查一次 deadline
+// ══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * 把 entries 缩减到 max_fanout 条
+ *
+ * TOP_WEIGHT：partial_sort 取权重最大的前 k 条，O(n log k)
+ * RESERVOIR ：Algorithm R，前 k 条先入池，第 i 条以 k/(i+1) 的概率替换池中一条
+ */
+static void SampleFanout(std::vector<AdjEntry> &entries, size_t max_fanout,
+                         FanoutSampling sampling, std::mt19937_64 &rng) {
+  if (sampling == FanoutSampling::TOP_WEIGHT) {
+    std::partial_sort(entries.begin(), entries.begin() + max_fanout,
+                      entries.end(), [](const AdjEntry &a, const AdjEntry &b) {
+                        return a.weight > b.weight;
+                      });
+  } else {
+    for (size_t i = max_fanout; i < entries.size(); ++i) {
+      size_t j = std::uniform_int_distribution<size_t>(0, i)(rng);
+      if (j < max_fanout)
+        std::swap(entries[j], entries[i]);
+    }
   }
+  entries.resize(max_fanout);
+}
 
-  if (use_parallel) {
-    // 并发路径：通过线程池提交 BFS 任务
-    // BFS 是纯读操作，ShardedCache 的 shared_lock 支持并发读，无锁竞争
-    std::vector<std::future<std::unordered_map<std::string, int>>> futures;
-    futures.reserve(entries.size());
-    for (const auto &[entry_id, score] : entries) {
-      futures.push_back(thread_pool_->submit([this, entry_id, hop_depth]() {
-        return KHopNeighbors(entry_id, hop_depth);
-      }));
+BoundedGraphRAGResult
+GraphStore::GraphRAGQueryBounded(const std::vector<float> &query_embedding,
+                                 int vector_top_k, int hop_depth,
+                                 const GraphRAGBudget &budget,
+                                 const TraversalFilter &filter,
+                                 const Projection &projection) const {
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  auto deadline_passed = [&]() {
+    return budget.deadline.count() > 0 &&
+           Clock::now() - start >= budget.deadline;
+  };
+
+  BoundedGraphRAGResult result;
+
+  // Phase 1: 向量检索入口节点
+  auto entries = SearchSimilarNodes(query_embedding, vector_top_k);
+
+  // discovered 按发现顺序记录节点（入口在前，之后按层），visited 去重
+  std::vector<std::string> discovered;
+  std::unordered_set<std::string> visited;
+  auto full = [&]() {
+    return budget.max_results > 0 && discovered.size() >= budget.max_results;
+  };
+  for (const auto &[entry_id, score] : entries) {
+    if (full()) {
+      result.result_truncated = true;
+      break;
     }
-    for (auto &fut : futures) {
-      for (const auto &[nb_id, dist] : fut.get()) {
-        all_node_ids.insert(nb_id);
+    if (visited.insert(entry_id).second)
+      discovered.push_back(entry_id);
+  }
+
+  // Phase 2: 逐层、逐节点扩展，每一步都检查预算
+  std::mt19937_64 rng(budget.seed);
+  std::vector<std::string> frontier = discovered;
+  bool stop = result.result_truncated;
+  for (int depth = 1; depth <= hop_depth && !frontier.empty() && !stop;
+       ++depth) {
+    std::vector<std::string> next;
+    for (const auto &u : frontier) {
+      if (deadline_passed()) {
+        result.deadline_exceeded = true;
+        stop = true;
+        break;
       }
-    }
-  } else {
-    // 串行路径：单入口、浅 hop 或无线程池时使用
-    for (const auto &[entry_id, score] : entries) {
-      for (const auto &[nb_id, dist] : KHopNeighbors(entry_id, hop_depth)) {
-        all_node_ids.insert(nb_id);
+
+      auto adj = LoadFilteredEntries(u, filter);
+      if (budget.max_fanout > 0 && adj.size() > budget.max_fanout) {
+        ++result.fanout_sampled_nodes;
+        result.fanout_dropped_edges += adj.size() - budget.max_fanout;
+        SampleFanout(adj, budget.max_fanout, budget.sampling, rng);
       }
+
+      for (auto &e : adj) {
+        if (!visited.insert(e.neighbor_id).second)
+          continue;
+        discovered.push_back(e.neighbor_id);
+        next.push_back(std::move(e.neighbor_id));
+        if (full()) {
+          result.result_truncated = true;
+          stop = true;
+          break;
+        }
+      }
+      if (stop)
+        break;
     }
+    if (!stop)
+      result.hops_completed = depth;
+    frontier.swap(next);
   }
 
-  // Phase 3: 加载完整节点属性，跳过不存在的节点
-  std::vector<Node> result;
-  result.reserve(all_node_ids.size());
-  for (const auto &node_id : all_node_ids) {
-    auto node = GetNode(node_id);
-    if (node) {
-      result.push_back(std::move(*node));
+  // Phase 3: 批量加载节点属性
+  result.nodes = LoadExistingNodes(discovered, projection);
+  return result;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// Phase 4: GraphRAG 排序（个性化 PageRank，forward push）
+//
+// PPR 定义：π = α·s + (1-α)·π·P，s 是种子分布，P 是按出边权重归一化的转移矩阵，
+// 没有出边的悬挂节点以概率 1 跳回种子分布（否则悬挂节点会吸收全部质量）。
+// forward push（Andersen-Chung-Lang）维护估计值 p 与残差 r，初始 r = s：
+//   push(u)：p(u) += α·r(u)；(1-α)·r(u) 按边权比例加到出边邻居的 r 上；r(u) = 0
+// 只要 r(u) >= ε·deg(u) 就继续 push，结束时每个节点的误差不超过 ε·deg(u)。
+// 总 push 次数上界为 O(1 / (α·ε))，与全图规模无关，因此适合在线查询。
+//
+// 与 GraphRAGQuery 的 hop_depth 语义保持一致：距最近种子 hop_depth 跳的节点
+// 只接收质量、不再向外 push。最终得分取 p(u) + α·r(u)，
+// 即把剩余残差按"再 push 一次"计入，边界节点因此也能参与排序。
+//
+// 节点 ID 与带权最短路径一样整数化，p / r / hop / 邻接表缓存都是数组。
+// ══════════════════════════════════════════════════════════════════════════════
+
+GraphRAGResult
+GraphStore::GraphRAGQueryRanked(const std::vector<float> &query_embedding,
+                                const GraphRAGOptions &options) const {
+  // alpha 不在 (0, 1) 时质量不被吸收，阈值非正时 pushable 恒为真，
+  // 两者都会让有环图或悬挂种子上的 push 永不结束
+  if (!(options.alpha > 0.0 && options.alpha < 1.0))
+    throw std::invalid_argument("alpha must be in (0, 1)");
+  if (!(options.residual_tolerance > 0.0))
+    throw std::invalid_argument("residual_tolerance must be > 0");
+
+  GraphRAGResult result;
+  if (options.top_n <= 0)
+    return result;
+
+  // Phase 1: 向量检索入口节点
+  auto entries = SearchSimilarNodes(query_embedding, options.vector_top_k);
+  if (entries.empty())
+    return result;
+
+  // 整数 ID 映射及按 ID 索引的 push 状态
+  std::unordered_map<std::string, uint32_t> id_of;
+  std::vector<std::string> names;
+  std::vector<double> p;
+  std::vector<double> r;
+  std::vector<int> hop;
+  std::vector<uint8_t> queued;
+  std::vector<uint8_t> adj_loaded;
+  // 出边缓存：{邻居整数 ID, 权重}；同一节点可能被 push 多次，只读一次 KV
+  std::vector<std::vector<std::pair<uint32_t, double>>> adj;
+  std::vector<double> out_weight;
+
+  auto intern = [&](const std::string &name) -> uint32_t {
+    auto [it, inserted] =
+        id_of.emplace(name, static_cast<uint32_t>(names.size()));
+    if (inserted) {
+      names.push_back(name);
+      p.push_back(0.0);
+      r.push_back(0.0);
+      hop.push_back(INT_MAX);
+      queued.push_back(0);
+      adj_loaded.push_back(0);
+      adj.emplace_back();
+      out_weight.push_back(0.0);
+    }
+    return it->second;
+  };
+
+  auto load_adj = [&](uint32_t u) {
+    if (adj_loaded[u])
+      return;
+    adj_loaded[u] = 1;
+    std::vector<std::pair<uint32_t, double>> list;
+    double total = 0.0;
+    for (const auto &e : LoadFilteredEntries(names[u], options.filter)) {
+      // 非正权重或 NaN 的边不参与质量传播
+      if (!(e.weight > 0.0f))
+        continue;
+      list.push_back({intern(e.neighbor_id), e.weight});
+      total += e.weight;
     }
+    // intern 可能使 adj 扩容，最后再写入
+    adj[u] = std::move(list);
+    out_weight[u] = total;
+  };
+
+  auto pushable = [&](uint32_t u) {
+    if (hop[u] >= options.hop_depth)
+      return false; // 边界节点只接收质量
+    load_adj(u);
+    double degree = std::max<double>(1.0, adj[u].size());
+    return r[u] >= options.residual_tolerance * degree;
+  };
+
+  // 种子分布：按 max(similarity, 0) 归一化；全部非正时均分
+  double sim_total = 0.0;
+  for (const auto &[id, sim] : entries)
+    sim_total += std::max(sim, 0.0f);
+
+  std::deque<uint32_t> queue;
+  std::vector<std::pair<uint32_t, double>> seeds; // {节点, 种子概率}
+  for (const auto &[id, sim] : entries) {
+    uint32_t u = intern(id);
+    double mass = sim_total > 0.0 ? std::max(sim, 0.0f) / sim_total
+                                  : 1.0 / entries.size();
+    hop[u] = 0;
+    r[u] += mass;
+    seeds.push_back({u, mass});
+  }
+  for (uint32_t u = 0; u < names.size(); ++u) {
+    if (pushable(u)) {
+      queued[u] = 1;
+      queue.push_back(u);
+    }
+  }
+
+  // Phase 2: forward push
+  const bool has_budget = options.time_budget.count() > 0;
+  const auto deadline = std::chrono::steady_clock::now() + options.time_budget;
+  const double alpha = options.alpha;
+
+  // 累加残差；超过阈值且未在队列中时入队
+  auto add_residual = [&](uint32_t v, double mass) {
+    r[v] += mass;
+    if (!queued[v] && pushable(v)) {
+      queued[v] = 1;
+      queue.push_back(v);
+    }
+  };
+
+  while (!queue.empty()) {
+    // 每 64 次 push 检查一次时间，避免频繁读时钟
+    if (has_budget && (result.pushes & 63) == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      result.converged = false;
+      break;
+    }
+
+    const uint32_t u = queue.front();
+    queue.pop_front();
+    queued[u] = 0;
+
+    const double ru = r[u];
+    r[u] = 0.0;
+    p[u] += alpha * ru;
+    ++result.pushes;
+
+    if (adj[u].empty()) {
+      // 悬挂节点：剩余质量按种子分布跳回入口节点
+      for (const auto &[seed, mass] : seeds)
+        add_residual(seed, (1.0 - alpha) * ru * mass);
+      continue;
+    }
+
+    const double spread = (1.0 - alpha) * ru / out_weight[u];
+    const int next_hop = hop[u] + 1;
+    // pushable 会 intern 新节点使 adj 扩容，按下标遍历
+    for (size_t i = 0; i < adj[u].size(); ++i) {
+      const auto [v, w] = adj[u][i];
+      hop[v] = std::min(hop[v], next_hop);
+      add_residual(v, spread * w);
+    }
+  }
+
+  // Phase 3: 按 p + α·r 排序，取 top_n 加载节点属性
+  std::vector<std::pair<double, uint32_t>> ranked;
+  ranked.reserve(names.size());
+  for (uint32_t u = 0; u < names.size(); ++u) {
+    double score = p[u] + alpha * r[u];
+    if (score > 0.0)
+      ranked.push_back({score, u});
+  }
+  std::sort(ranked.begin(), ranked.end(),
+            [](const auto &a, const auto &b) { return a.first > b.first; });
+
+  result.touched = ranked.size();
+  // 按得分顺序分批加载；批内有不存在的节点时再取下一批补足 top_n
+  const size_t top_n = static_cast<size_t>(std::max(options.top_n, 0));
+  size_t next = 0;
+  while (result.nodes.size() < top_n && next < ranked.size()) {
+    size_t end = std::min(ranked.size(), next + top_n - result.nodes.size());
+    std::vector<std::string> ids;
+    ids.reserve(end - next);
+    for (size_t i = next; i < end; ++i)
+      ids.push_back(names[ranked[i].second]);
+    auto nodes = GetNodes(ids, options.projection);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (nodes[i])
+        result.nodes.push_back({std::move(*nodes[i]), ranked[next + i].first});
+    }
+    next = end;
   }
   return result;
 }
@@ -722,11 +2505,13 @@ namespace graph {
  * 核心流程:
  *  1. 并发向量检索: 对每个 query_embedding 并发调用 SearchSimilarNodes
  *  2. 结果合并: 使用 std::unordered_set 去重所有入口节点
- *  3. 并发图遍历: 对所有入口节点并发执行 KHopNeighbors
+ *  3. 多源图遍历: 所有入口节点作为同一次 BFS 的起点（MultiSourceKHop），
+ *     不同查询的入口邻域重叠时只扩展一次
  */
 std::vector<Node> GraphStore::GraphRAGQuery(
     const std::vector<std::vector<float>> &query_embeddings, int vector_top_k,
-    int hop_depth) const {
+    int hop_depth, const TraversalFilter &filter, const Projection &projection,
+    const base::CancellationToken &cancel) const {
   if (query_embeddings.empty()) {
     return {};
   }
@@ -743,8 +2528,8 @@ std::vector<Node> GraphStore::GraphRAGQuery(
 
     for (const auto &embedding : query_embeddings) {
       search_futures.push_back(
-          thread_pool_->submit([this, embedding, vector_top_k]() {
-            return SearchSimilarNodes(embedding, vector_top_k);
+          thread_pool_->submit([this, embedding, vector_top_k, cancel]() {
+            return SearchSimilarNodes(embedding, vector_top_k, cancel);
           }));
     }
 
@@ -756,7 +2541,7 @@ std::vector<Node> GraphStore::GraphRAGQuery(
   } else {
     // 串行路径
     for (const auto &embedding : query_embeddings) {
-      auto entries = SearchSimilarNodes(embedding, vector_top_k);
+      auto entries = SearchSimilarNodes(embedding, vector_top_k, cancel);
       for (const auto &[node_id, score] : entries) {
         all_entry_node_ids.insert(node_id);
       }
@@ -767,47 +2552,18 @@ std::vector<Node> GraphStore::GraphRAGQuery(
     return {};
   }
 
-  // Phase 2: 并发 K-hop 扩展
-  std::unordered_set<std::string> all_node_ids =
-      all_entry_node_ids; // 包含所有入口节点
-  const bool use_parallel_bfs =
-      thread_pool_ && (all_entry_node_ids.size() > 1) && (hop_depth >= 1);
-
-  if (use_parallel_bfs) {
-    std::vector<std::future<std::unordered_map<std::string, int>>> bfs_futures;
-    bfs_futures.reserve(all_entry_node_ids.size());
-    for (const auto &entry_id : all_entry_node_ids) {
-      bfs_futures.push_back(thread_pool_->submit([this, entry_id, hop_depth]() {
-        return KHopNeighbors(entry_id, hop_depth);
-      }));
-    }
-
-    for (auto &fut : bfs_futures) {
-      for (const auto &[nb_id, dist] : fut.get()) {
-        all_node_ids.insert(nb_id);
-      }
-    }
-  } else {
-    // 串行路径
-    if (hop_depth >= 1) {
-      for (const auto &entry_id : all_entry_node_ids) {
-        for (const auto &[nb_id, dist] : KHopNeighbors(entry_id, hop_depth)) {
-          all_node_ids.insert(nb_id);
-        }
-      }
-    }
-  }
-
-  // Phase 3: 加载完整节点属性
-  std::vector<Node> result;
-  result.reserve(all_node_ids.size());
-  for (const auto &node_id : all_node_ids) {
-    auto node = GetNode(node_id);
-    if (node) {
-      result.push_back(std::move(*node));
-    }
-  }
-  return result;
+  // Phase 2: 多源 K-hop 扩展（共享 visited，结果包含所有入口节点）
+  // 分层扩展本身会在 frontier 较大时使用线程池，这里不再按入口拆任务
+  std::vector<std::string> sources(all_entry_node_ids.begin(),
+                                   all_entry_node_ids.end());
+  auto reached = MultiSourceKHop(sources, hop_depth, filter, cancel);
+
+  // Phase 3: 按投影批量加载节点属性
+  std::vector<std::string> ids;
+  ids.reserve(reached.size());
+  for (const auto &[node_id, dist] : reached)
+    ids.push_back(node_id);
+  return LoadExistingNodes(ids, projection);
 }
 } // namespace graph
 } // namespace minkv
@@ -1,16 +1,33 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <climits>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
+#include "../base/cancellation.h"
+#include "../base/expiration_manager.h"
 #include "../base/thread_pool.h"
 #include "../core/sharded_cache.h"
+#include "degree_stats.h"
+#include "edge_expiry.h"
+#include "graph_bulk_import.h"
+#include "graph_snapshot.h"
 #include "graph_types.h"
+#include "graph_view.h"
+#include "graphrag_cache.h"
+#include "keyword_index.h"
+#include "paged_adjacency.h"
+#include "property_index.h"
 
 namespace minkv {
 namespace graph {
@@ -23,16 +40,230 @@ namespace graph {
  *
  *   n:{node_id}              -> Node 二进制序列化
  *   e:{src}:{dst}:{label}    -> Edge 二进制序列化
- *   adj:out:{node_id}        -> 出边邻接表 JSON 数组
- *   adj:in:{node_id}         -> 入边邻接表 JSON 数组
+ *   adj:out:{node_id}        -> 出边邻接表（AdjEntry 列表，每条边一项）
+ *   adj:in:{node_id}         -> 入边邻接表（AdjEntry 列表，每条边一项）
+ *   adjp:{out|in}:{id}:{n}   -> 超级节点分页邻接表第 n 页（见 PagedAdjacency）
  *   vec:{node_id}            -> embedding raw bytes (float[])
- *   ec:{src}:{dst}           -> 边计数器（uint64_t 十进制字符串）
- *                              记录 (src, dst) 之间的边数量，
- *                              用于 DeleteEdge O(1)
- * 判断是否还有同对节点的其他边
+ *
+ * 邻接表条目携带 label 和 weight：DeleteEdge 精确删除对应条目，
+ * 带权最短路径直接从邻接表读取权重。
  */
 using GraphKVStore = minkv::db::ShardedCache<std::string, std::string>;
 
+/** 遍历方向 */
+enum class Direction {
+  OUT, // 沿出边（adj:out）
+  IN,  // 沿入边（adj:in）
+  BOTH // 出边 + 入边，把图当作无向图遍历
+};
+
+/**
+ * 遍历过滤条件
+ *
+ * 邻接表条目自带 label，过滤在读取邻接表时完成，不读取 e: 边数据。
+ * 默认值（OUT、不限标签）与不带过滤条件的接口行为一致。
+ *
+ * node_predicates 限定经过的节点：邻居必须满足全部谓词才会被访问和
+ * 继续扩展（起点不受限制）。谓词由二级索引的反向表判定，同样不读取
+ * n: 节点数据；谓词字段必须已调用 CreatePropertyIndex。
+ *
+ * as_of 只经过在该时刻有效的边（valid_from <= as_of < valid_to），
+ * 在邻接表的有效期索引上判定；为空时不按时间过滤，已失效但尚未被
+ * 过期清理下线的边同样可见。
+ */
+struct TraversalFilter {
+  std::vector<std::string> labels;      // 只沿这些标签的边走；空表示不限
+  Direction direction = Direction::OUT; // 遍历方向
+  std::vector<PropertyPredicate> node_predicates; // 邻居节点需满足的谓词
+  std::optional<int64_t> as_of;                   // 时间旅行查询的时刻
+};
+
+/**
+ * 带权最短路径查询结果
+ */
+struct WeightedPath {
+  std::vector<std::string> path; // src -> dst 的节点序列；不可达时为空
+  double cost = 0.0;             // 路径上各边权重之和
+  size_t expanded = 0;           // 出堆并扩展邻接表的节点数（搜索代价）
+};
+
+/**
+ * GraphRAG 排序查询参数
+ *
+ * 排序使用个性化 PageRank（PPR）：以向量检索命中的入口节点为种子，
+ * 按相似度分配初始概率质量，再用 forward push 做局部近似。
+ */
+struct GraphRAGOptions {
+  int vector_top_k = 3; // 向量检索入口节点数
+  int hop_depth = 2;    // push 传播的最大跳数（距最近入口节点）
+  int top_n = 20;       // 返回得分最高的节点数
+
+  double alpha = 0.15; // 每次 push 留在当前节点的比例（teleport 概率），(0, 1)
+  // 残差阈值：r(u) < residual_tolerance * max(out_degree(u), 1) 时不再 push，
+  // 必须为正
+  double residual_tolerance = 1e-4;
+  // push 阶段的时间预算，0 表示不限时；超时后以当前估计值返回
+  std::chrono::microseconds time_budget{0};
+  // 质量只沿满足条件的边传播（方向为 BOTH 时出边、入边都参与分配）
+  TraversalFilter filter;
+  Projection projection; // 返回节点保留的属性
+};
+
+/** 带相关性得分的节点 */
+struct ScoredNode {
+  Node node;
+  double score = 0.0; // PPR 估计值，越大越相关
+};
+
+/** GraphRAG 排序查询结果 */
+struct GraphRAGResult {
+  std::vector<ScoredNode> nodes; // 按 score 降序，最多 top_n 个
+  size_t pushes = 0;             // 执行的 push 次数
+  size_t touched = 0;            // 获得非零质量的节点数
+  bool converged = true; // false 表示因时间预算提前结束（残差仍高于阈值）
+};
+
+/** 邻居采样策略（单个节点的邻居条目数超过 max_fanout 时使用） */
+enum class FanoutSampling {
+  TOP_WEIGHT, // 保留权重最大的 max_fanout 条边，结果确定
+  RESERVOIR   // 蓄水池采样，均匀随机保留 max_fanout 条边
+};
+
+/**
+ * GraphRAG 有界扩展参数
+ *
+ * 超级节点（度数上万）会让 K-hop 扩展的结果爆炸，
+ * 这里从每个节点的扇出、结果节点总数、墙钟时间三个维度限制代价。
+ * 各项为 0 表示不限制。
+ */
+struct GraphRAGBudget {
+  size_t max_fanout = 0;  // 每个节点每跳最多扩展的邻居条目数
+  FanoutSampling sampling = FanoutSampling::TOP_WEIGHT;
+  size_t max_results = 0; // 返回节点数上限（含入口节点）
+  // 从查询开始计时，超过后停止扩展，以已发现的节点返回
+  std::chrono::microseconds deadline{0};
+  uint64_t seed = 0; // RESERVOIR 的随机种子，相同种子结果可复现
+};
+
+/** 有界 GraphRAG 查询结果及截断统计 */
+struct BoundedGraphRAGResult {
+  std::vector<Node> nodes;          // 入口节点在前，其余按发现顺序（层序）
+  int hops_completed = 0;           // 完整扩展的层数
+  size_t fanout_sampled_nodes = 0;  // 因 max_fanout 被采样的节点数
+  size_t fanout_dropped_edges = 0;  // 采样丢弃的邻接条目数
+  bool result_truncated = false;    // 达到 max_results 后提前停止
+  bool deadline_exceeded = false;   // 超过 deadline 后提前停止
+};
+
+/**
+ * 混合检索参数（向量 + 关键词，倒数排名融合）
+ *
+ * 两路各取 candidate_k 个候选，融合得分 = Σ 1 / (rrf_k + rank)，
+ * rank 从 1 开始；只在一路出现的节点只累加该路的分量。
+ */
+struct HybridSearchOptions {
+  int candidate_k = 20; // 每一路检索的候选数，必须为正
+  int rrf_k = 60; // RRF 平滑常数（>= 0），越大排名靠后的候选权重越接近
+  int entry_top_k = 3;  // 融合后取作 GraphRAG 入口的节点数
+};
+
+/** 融合后的入口节点 */
+struct FusedEntry {
+  std::string node_id;
+  double score = 0.0;   // RRF 融合得分
+  int vector_rank = 0;  // 向量检索中的名次，0 表示未命中
+  int keyword_rank = 0; // 关键词检索中的名次，0 表示未命中
+};
+
+/** 混合 GraphRAG 查询结果 */
+struct HybridGraphRAGResult {
+  std::vector<FusedEntry> entries; // 按融合得分降序
+  std::vector<Node> nodes;         // 入口节点的 hop_depth 跳邻域
+};
+
+/** 遍历管道的步骤类型 */
+enum class TraversalStepKind {
+  EXPAND, // 沿边扩展到邻居（按方向、标签）
+  FILTER, // 保留满足属性谓词的节点
+  LIMIT   // 最多保留前 limit 个节点，之后停止拉取上游
+};
+
+/** 遍历管道中的一步，按 kind 只使用对应字段 */
+struct TraversalStep {
+  TraversalStepKind kind = TraversalStepKind::EXPAND;
+  TraversalFilter filter;                    // EXPAND：方向、标签
+  std::vector<PropertyPredicate> predicates; // FILTER：节点需满足的谓词
+  size_t limit = 0;                          // LIMIT：保留的节点数
+};
+
+/**
+ * 服务端遍历管道：起点集合 → 若干步 → 投影
+ *
+ * 每一步的输出按首次出现顺序去重。求值是流式、分批的：每批最多
+ * batch_size 个节点从上游流向下游，LIMIT 满足后不再读取上游剩余的
+ * 邻接表。紧跟在 EXPAND 之后、谓词字段都有合适索引的 FILTER 会下推到
+ * 邻接表扫描（在索引反向表上判定邻居，不读取 n: 节点数据）；其余 FILTER
+ * 按批读取节点记录判定，不要求索引。
+ *
+ * 例：alice 的朋友中在 acme 工作的人，最多 10 个
+ *   TraversalPipeline q;
+ *   q.start = {"alice"};
+ *   q.Expand(Direction::OUT, {"KNOWS"})
+ *       .Where({PropertyPredicate::Eq("company", "\"acme\"")})
+ *       .Limit(10);
+ */
+struct TraversalPipeline {
+  std::vector<std::string> start; // 起点 ID；为空时使用 start_where
+  // 起点谓词（走二级索引，字段必须已建立索引）
+  std::vector<PropertyPredicate> start_where;
+  std::vector<TraversalStep> steps;
+  Projection projection;   // 返回节点保留的属性
+  size_t batch_size = 256; // 每批流经管道的节点数
+  // 自身未指定 as_of 的 EXPAND 步使用这个时刻
+  std::optional<int64_t> as_of;
+
+  TraversalPipeline &Expand(Direction direction,
+                            std::vector<std::string> labels = {}) {
+    TraversalStep step;
+    step.filter.direction = direction;
+    step.filter.labels = std::move(labels);
+    steps.push_back(std::move(step));
+    return *this;
+  }
+
+  TraversalPipeline &Where(std::vector<PropertyPredicate> predicates) {
+    TraversalStep step;
+    step.kind = TraversalStepKind::FILTER;
+    step.predicates = std::move(predicates);
+    steps.push_back(std::move(step));
+    return *this;
+  }
+
+  TraversalPipeline &Limit(size_t n) {
+    TraversalStep step;
+    step.kind = TraversalStepKind::LIMIT;
+    step.limit = n;
+    steps.push_back(std::move(step));
+    return *this;
+  }
+};
+
+/** 遍历管道的执行统计 */
+struct TraversalStats {
+  size_t batches = 0;             // EXPAND 处理的批次数
+  size_t nodes_expanded = 0;      // 读取了邻接表的节点数
+  size_t neighbors_scanned = 0;   // 扩展得到的邻居数（去重前）
+  size_t nodes_filtered = 0;      // 读取节点记录判定谓词的节点数
+  size_t filters_pushed_down = 0; // 下推到邻接表扫描的 FILTER 步数
+  bool limit_reached = false;     // LIMIT 已满足，提前停止拉取上游
+};
+
+/** 遍历管道结果 */
+struct TraversalResult {
+  std::vector<Node> nodes; // 最后一步的输出，按流经管道的顺序
+  TraversalStats stats;
+};
+
 /**
  * GraphStore — 图数据库的顶层接口
  *
@@ -65,9 +296,35 @@ public:
   /** 添加节点；若 node_id 已存在则覆盖 */
   void AddNode(const Node &node);
 
+  /**
+   * 批量添加节点，语义同逐个 AddNode（同一 node_id 后者覆盖）
+   * n: 记录经 multi_put 按分片批量写入，属性索引只加一次锁
+   */
+  void AddNodes(const std::vector<Node> &nodes);
+
   /** 查询节点；不存在返回 std::nullopt */
   std::optional<Node> GetNode(const std::string &node_id) const;
 
+  /**
+   * 批量查询节点，结果与 node_ids 一一对应
+   * 底层走 ShardedCache::multi_visit，每个分片只加一次锁；
+   * 记录在分片锁内按 projection 裁剪，只拷贝需要返回的部分
+   */
+  std::vector<std::optional<Node>>
+  GetNodes(const std::vector<std::string> &node_ids,
+           const Projection &projection = {}) const;
+
+  /**
+   * 零拷贝批量访问节点：对每个存在的节点调用 visitor(i, view)
+   *
+   * i 为 node_ids 中的下标，view 直接指向 KV 中存储的记录，
+   * 只在回调期间有效。回调在分片锁内执行，不能再调用本 GraphStore
+   * 的任何方法（会死锁），应尽快返回。
+   */
+  void VisitNodes(
+      const std::vector<std::string> &node_ids,
+      const std::function<void(size_t, const NodeView &)> &visitor) const;
+
   /**
    * 更新节点属性
    * 只覆盖 n:{node_id} 这个 Key，不会动邻接表（adj:）和 embedding（vec:）
@@ -85,9 +342,21 @@ public:
   /**
    * 添加有向边
    * Phase 1 只写边数据；Phase 2 补全邻接表更新（adj:out / adj:in）
+   * @throws std::invalid_argument valid_from >= valid_to
    */
   void AddEdge(const Edge &edge);
 
+  /**
+   * 批量添加有向边，语义同按顺序逐个 AddEdge
+   *
+   * e: 记录经 multi_put 按分片批量写入；邻接表按节点分组，
+   * 每个节点的 adj:out / adj:in 只做一次 read-modify-write，
+   * 而不是每条边各做一次。与 BulkImportEdges 不同，写 WAL，
+   * 可以与其他图写操作并发。
+   * @throws std::invalid_argument 有边 valid_from >= valid_to（不写入任何数据）
+   */
+  void AddEdges(const std::vector<Edge> &edges);
+
   /** 查询边；不存在返回 std::nullopt */
   std::optional<Edge> GetEdge(const std::string &src_id,
                               const std::string &dst_id,
@@ -108,6 +377,14 @@ public:
   /** 返回 node_id 的所有入边前驱（直接读 adj:in:{node_id}） */
   std::vector<std::string> GetInNeighbors(const std::string &node_id) const;
 
+  /**
+   * 按方向和标签过滤的邻居（去重）
+   * 例如 {labels={"WORKS_AT"}} 只返回经 WORKS_AT 出边可达的邻居，
+   * 只读一到两个邻接表 Key，不需要逐个邻居 GetEdge。
+   */
+  std::vector<std::string> GetNeighbors(const std::string &node_id,
+                                        const TraversalFilter &filter) const;
+
   // ── Phase 3: Graph Query ──────────────────────────────────────────────────
 
   /**
@@ -116,20 +393,92 @@ public:
    * 从 start_id 出发，沿有向边最多走 k 步，返回所有可达节点及其跳数。
    * 返回值：{node_id -> hop_distance}，不含起始节点自身。
    * k=0 时返回空 map。
+   *
+   * 按层同步（level-synchronous）扩展：当前层 frontier 足够大且有线程池时，
+   * 把 frontier 切块交给 thread_pool_ 并发读取邻接表，再串行合并去重。
+   *
+   * filter 限定只沿指定方向、指定标签的边扩展。
+   *
+   * cancel 在每层开始和读取邻接表的过程中检查，取消后不再扩展，
+   * 返回已发现的节点（最后一层可能不完整）。
+   */
+  std::unordered_map<std::string, int>
+  KHopNeighbors(const std::string &start_id, int k,
+                const TraversalFilter &filter = {},
+                const base::CancellationToken &cancel = {}) const;
+
+  /**
+   * 多源 K-hop BFS
+   *
+   * 所有起点同时作为第 0 层，共享同一个 visited 集合逐层扩展：
+   * 多个起点的邻域重叠时，重叠部分只读取一次邻接表。
+   * 返回值：{node_id -> 到最近起点的跳数}，起点自身为 0（重复起点只算一次）。
+   * 只记录到最近起点的距离；需要"每个起点各自的距离"时
+   * 仍应对该起点单独调用 KHopNeighbors。取消语义同 KHopNeighbors。
    */
   std::unordered_map<std::string, int>
-  KHopNeighbors(const std::string &start_id, int k) const;
+  MultiSourceKHop(const std::vector<std::string> &sources, int k,
+                  const TraversalFilter &filter = {},
+                  const base::CancellationToken &cancel = {}) const;
 
   /**
-   * 最短路径查询（BFS）
+   * 最短路径查询（双向 BFS）
+   *
+   * 从 src_id 沿 adj:out 正向扩展、从 dst_id 沿 adj:in 反向扩展，
+   * 每次扩展较小的一侧，两侧相遇即得到最短路径。
+   * 探索节点数约为单向 BFS 的平方根量级（高扇出图上差异最明显）。
    *
    * 返回从 src_id 到 dst_id 的节点序列（含首尾）。
    * src_id == dst_id 时返回 {src_id}。
    * 无路径或超出 max_hops 时返回空列表。
+   *
+   * filter.direction 是路径上每条边的方向（IN 表示沿边逆向走），
+   * 反向一侧自动取相反方向；标签过滤对两侧都生效。
    */
   std::vector<std::string> FindPath(const std::string &src_id,
                                     const std::string &dst_id,
-                                    int max_hops = INT_MAX) const;
+                                    int max_hops = INT_MAX,
+                                    const TraversalFilter &filter = {}) const;
+
+  /**
+   * 带权最短路径（Dijkstra）
+   *
+   * 以 Edge::weight 为边长，同一对节点间有多条边时取权重最小的一条。
+   * 搜索内部把节点 ID 映射为连续整数，距离/前驱用数组存储，
+   * open 集合使用支持 decrease-key 的配对堆（见 pairing_heap.h）。
+   *
+   * src_id == dst_id 时返回 {path={src_id}, cost=0}。
+   * 不可达时 path 为空。
+   *
+   * @throws std::domain_error 搜索经过负权或 NaN 权重的边
+   */
+  WeightedPath FindWeightedPath(const std::string &src_id,
+                                const std::string &dst_id) const;
+
+  /**
+   * 带权最短路径（A*，embedding 距离作为启发函数）
+   *
+   * h(v) = heuristic_scale * ||emb(v) - emb(dst)||_2，
+   * 节点没有 embedding 或维度与 dst 不一致时 h(v) = 0；
+   * dst 没有 embedding 时退化为 Dijkstra。
+   *
+   * 只有当 h 不高估剩余路径代价时结果才保证最优，调用方需根据
+   * 业务中"embedding 距离与边权的换算关系"选择 heuristic_scale。
+   * 启发函数不一致（inconsistent）时已关闭的节点会被重新打开，结果仍然正确。
+   */
+  WeightedPath FindWeightedPathAStar(const std::string &src_id,
+                                     const std::string &dst_id,
+                                     float heuristic_scale = 1.0f) const;
+
+  /**
+   * 执行遍历管道（见 TraversalPipeline）
+   *
+   * 最后一步输出的节点中，n: 记录不存在的（例如只有边、没有 AddNode 的
+   * 端点）不出现在结果里。
+   * @throws std::invalid_argument start 与 start_where 都为空，
+   *         或 start_where 的字段没有索引
+   */
+  TraversalResult Traverse(const TraversalPipeline &pipeline) const;
 
   // ── Phase 4: Embedding & Vector Search ───────────────────────────────────
 
@@ -152,10 +501,11 @@ public:
    * 遍历所有 vec: 前缀的 Key，找出与 query_embedding 最相似的 top_k 个节点。
    * 返回值：{node_id, cosine_similarity}，按相似度降序排列。
    * 维度不匹配的节点会被跳过。
+   * 每扫描 1024 条检查一次 cancel，取消后返回已扫描部分的 top_k。
    */
   std::vector<std::pair<std::string, float>>
-  SearchSimilarNodes(const std::vector<float> &query_embedding,
-                     int top_k) const;
+  SearchSimilarNodes(const std::vector<float> &query_embedding, int top_k,
+                     const base::CancellationToken &cancel = {}) const;
 
   // ── Phase 4: GraphRAG ─────────────────────────────────────────────────────
 
@@ -163,13 +513,23 @@ public:
    * GraphRAG 两阶段查询
    *
    * Phase 1：SearchSimilarNodes 找到 vector_top_k 个入口节点
-   * Phase 2：对每个入口节点做 KHopNeighbors(hop_depth) 扩展上下文
+   * Phase 2：以全部入口节点为起点做一次 MultiSourceKHop(hop_depth)
    * Phase 3：加载所有涉及节点的完整属性，去重后返回
    *
    * 用途：把图结构知识注入 LLM 的 prompt，提升回答质量
+   * filter 限定 Phase 2 的扩展方向和边标签
+   * EnableQueryCache 之后，重复（或量化后相同）的查询直接返回缓存结果
+   * projection 决定返回节点保留哪些属性（默认完整 properties_json）
+   *
+   * cancel 传给 Phase 1 / Phase 2，取消后跳过剩余的检索和扩展，
+   * 只加载已发现的节点返回（部分结果不写入查询缓存）；调用方用
+   * cancel.cancelled() 判断结果是否完整。
    */
-  std::vector<Node> GraphRAGQuery(const std::vector<float> &query_embedding,
-                                  int vector_top_k, int hop_depth) const;
+  std::vector<Node>
+  GraphRAGQuery(const std::vector<float> &query_embedding, int vector_top_k,
+                int hop_depth, const TraversalFilter &filter = {},
+                const Projection &projection = {},
+                const base::CancellationToken &cancel = {}) const;
 
   /**
    * GraphRAG 两阶段查询 (批量并发版)
@@ -177,16 +537,262 @@ public:
    * @param query_embeddings  批量查询向量，每个向量代表一个待检索的实体
    * @param vector_top_k      每个向量检索的入口节点数
    * @param hop_depth         图遍历深度
+   * @param filter            图遍历的方向和边标签过滤
+   * @param projection        返回节点保留的属性
+   * @param cancel            取消令牌，语义同单向量版本
    * @return                  合并去重后的节点列表
    *
    * 核心流程:
    *  1. 并发向量检索: 对每个 query_embedding 并发调用 SearchSimilarNodes
    *  2. 结果合并: 使用 std::unordered_set 去重所有入口节点
-   *  3. 并发图遍历: 对所有入口节点并发执行 KHopNeighbors
+   *  3. 多源图遍历: 所有入口节点共享一次 MultiSourceKHop，
+   *     各层 frontier 较大时由 ExpandFrontier 并行读取邻接表
    */
   std::vector<Node>
   GraphRAGQuery(const std::vector<std::vector<float>> &query_embeddings,
-                int vector_top_k, int hop_depth) const;
+                int vector_top_k, int hop_depth,
+                const TraversalFilter &filter = {},
+                const Projection &projection = {},
+                const base::CancellationToken &cancel = {}) const;
+
+  /**
+   * GraphRAG 排序查询（个性化 PageRank）
+   *
+   * Phase 1：SearchSimilarNodes 找到 vector_top_k 个入口节点，
+   *          按 max(similarity, 0) 归一化作为 PPR 的种子分布
+   * Phase 2：forward push 局部近似 PPR，只在 hop_depth 跳范围内传播，
+   *          质量按出边 weight 比例分配给邻居
+   * Phase 3：取得分最高的 top_n 个节点，按 projection 加载属性后按得分降序返回
+   *
+   * 代价只与被 push 到的局部区域有关，与全图规模无关；
+   * residual_tolerance 越小越精确，time_budget 限制最坏延迟。
+   *
+   * @throws std::invalid_argument alpha 不在 (0, 1) 内或 residual_tolerance <= 0
+   */
+  GraphRAGResult GraphRAGQueryRanked(const std::vector<float> &query_embedding,
+                                     const GraphRAGOptions &options) const;
+
+  /**
+   * GraphRAG 有界查询（延迟可控）
+   *
+   * 与 GraphRAGQuery 相同的两阶段流程，但扩展受 budget 约束：
+   *   - 节点的邻居条目数超过 max_fanout 时，按 sampling 策略只保留
+   *     max_fanout 条（TOP_WEIGHT 取权重最大者，RESERVOIR 均匀随机）
+   *   - 已发现节点数达到 max_results 时立即停止
+   *   - 超过 deadline 时停止扩展（逐节点检查），已发现的节点照常返回
+   * 最后通过 GetNodes 按 projection 批量加载节点属性。
+   * 扩展为单线程逐节点进行，以便精确执行预算。
+   */
+  BoundedGraphRAGResult
+  GraphRAGQueryBounded(const std::vector<float> &query_embedding,
+                       int vector_top_k, int hop_depth,
+                       const GraphRAGBudget &budget,
+                       const TraversalFilter &filter = {},
+                       const Projection &projection = {}) const;
+
+  /**
+   * 混合 GraphRAG 查询：向量检索 + 关键词检索，RRF 融合后取入口节点
+   *
+   * Phase 1：SearchSimilarNodes 与 SearchKeyword 各取 candidate_k 个候选
+   * Phase 2：倒数排名融合，取 entry_top_k 个入口节点
+   * Phase 3：与 GraphRAGQuery 相同的多源 K-hop 扩展和节点加载
+   *
+   * 精确实体名（人名、产品型号）在 embedding 空间里往往不够近，
+   * 关键词一路保证这类节点能成为入口。query_embedding 或 query_text
+   * 为空时退化为单路检索；未启用关键词索引时只有向量一路。
+   * cancel 的语义同 GraphRAGQuery。
+   *
+   * @throws std::invalid_argument candidate_k <= 0 或 rrf_k < 0
+   */
+  HybridGraphRAGResult
+  GraphRAGQueryHybrid(const std::vector<float> &query_embedding,
+                      const std::string &query_text, int hop_depth,
+                      const HybridSearchOptions &options = {},
+                      const TraversalFilter &filter = {},
+                      const Projection &projection = {},
+                      const base::CancellationToken &cancel = {}) const;
+
+  // ── 关键词索引 ────────────────────────────────────────────────────────────
+
+  /**
+   * 启用属性关键词索引（重复启用会按新配置重建）
+   *
+   * 扫描现有节点建立索引，之后由 AddNode / UpdateNode / DeleteNode 维护。
+   * 应在开始处理查询之前调用。
+   */
+  void EnableKeywordIndex(const KeywordIndexOptions &options = {});
+
+  /** 是否已启用关键词索引 */
+  bool KeywordIndexEnabled() const { return keyword_index_ != nullptr; }
+
+  /**
+   * BM25 关键词检索
+   * @return {node_id, score}，按得分降序；未启用索引时返回空列表
+   */
+  std::vector<std::pair<std::string, double>>
+  SearchKeyword(const std::string &query, int top_k) const;
+
+  /** 关键词索引规模统计；未启用时全为 0 */
+  KeywordIndexStats KeywordStats() const;
+
+  // ── 属性二级索引 ──────────────────────────────────────────────────────────
+
+  /**
+   * 为 properties_json 的顶层字段 field 建立二级索引
+   *
+   * HASH 只支持等值查询；ORDERED 还支持 LT / LE / GT / GE 范围查询。
+   * 扫描现有节点建立索引，之后 AddNode / UpdateNode / DeleteNode 在同一个
+   * 临界区内写 KV 和更新索引。field 已有索引时按新类型重建。
+   * 不与并发写操作同步，应在没有并发写入时调用。
+   */
+  void CreatePropertyIndex(const std::string &field,
+                           PropertyIndexType type = PropertyIndexType::HASH);
+
+  /** 删除 field 上的索引；不存在时返回 false */
+  bool DropPropertyIndex(const std::string &field);
+
+  /** 已建立的索引，按字段名排序 */
+  std::vector<PropertyIndexInfo> ListPropertyIndexes() const;
+
+  /**
+   * 按属性谓词查找节点 ID（全部谓词取交集），按 ID 升序
+   * @throws std::invalid_argument 谓词为空、字段没有索引，
+   *         或在 HASH 索引上使用范围运算
+   */
+  std::vector<std::string> FindNodeIdsByProperties(
+      const std::vector<PropertyPredicate> &predicates) const;
+
+  /**
+   * 按属性谓词查找并加载节点
+   *
+   * 索引查找与节点加载在同一个共享锁内完成，返回的节点与索引一致
+   * （不会出现索引命中、但属性已被改成不满足谓词的节点）。
+   */
+  std::vector<Node>
+  FindNodesByProperties(const std::vector<PropertyPredicate> &predicates,
+                        const Projection &projection = {}) const;
+
+  // ── GraphRAG 查询缓存 ─────────────────────────────────────────────────────
+
+  /**
+   * 为单向量 GraphRAGQuery 启用结果缓存（重复启用会清空旧缓存）
+   *
+   * 条目以写操作维护的版本号校验，不需要手动失效；
+   * 但绕过 GraphStore 直接修改底层 KV 的写入不会被感知。
+   * 应在开始处理查询之前调用，与并发查询之间没有同步。
+   */
+  void EnableQueryCache(const GraphRAGCacheOptions &options = {});
+
+  /** 缓存命中率等统计；未启用缓存时全为 0 */
+  GraphRAGCacheStats QueryCacheStats() const;
+
+  // ── 度数统计与超级节点 ────────────────────────────────────────────────────
+
+  /**
+   * 配置超级节点分页阈值（默认 SupernodeOptions{}）
+   *
+   * 邻接表条目数超过 promote_threshold 时，下一次写入把它转为分页存储，
+   * 之后该节点的加边 / 删边只读写一页，并由它自己的锁串行化，
+   * 不再长时间占用分片锁。应在写入数据之前调用，与并发写之间没有同步。
+   */
+  void ConfigureSupernodes(const SupernodeOptions &options);
+
+  /**
+   * 节点的出度 / 入度（多重边按条数计），O(1)
+   *
+   * 度数在每次邻接表写入时维护；底层 KV 中已有的数据（例如从快照恢复）
+   * 需要先调用 RebuildAdjacencyList 才会被统计。
+   */
+  NodeDegree GetDegree(const std::string &node_id) const;
+
+  /** 全图度数直方图，O(有边的节点数) */
+  DegreeHistogram DegreeStats() const;
+
+  // ── 批量导入 ──────────────────────────────────────────────────────────────
+
+  /**
+   * 批量导入边（离线加载）
+   *
+   * 逐条 AddEdge 每条边要做 3 次写（e: + 两侧邻接表 RMW），
+   * 而每次邻接表 RMW 都要反序列化/序列化整个列表，
+   * 高度数节点的导入代价是度数的平方。这里改为：
+   *   1. 按 (src, dst, label) / (dst, src, label) 并行排序边的下标
+   *   2. 同一三元组只保留最后一次出现（与重复 AddEdge 的覆盖语义一致）
+   *   3. 每个节点的 adj:out / adj:in 一次性构建完整 blob，
+   *      与已有邻接表合并后连同 e: 记录通过 bulk_load 按分片批量写入
+   *   4. 导入期间不写 WAL；snapshot_at_end 为 true 时结束后调用
+   *      create_snapshot() 落盘（未启用持久化时只是跳过）
+   *
+   * 注意：导入期间不能有并发的图写操作（AddEdge / DeleteEdge 等），
+   * 否则同一邻接表的更新可能被覆盖。
+   * 使用 SimpleCheckpointManager 的部署应传 snapshot_at_end = false，
+   * 导入后调用 checkpoint_now()，由它写快照并截断 WAL。
+   * @throws std::invalid_argument 有边 valid_from >= valid_to（不写入任何数据）
+   */
+  BulkImportStats BulkImportEdges(std::vector<Edge> edges,
+                                  bool snapshot_at_end = true);
+
+  /**
+   * 从文件批量导入边，格式见 EdgeFileFormat
+   * 文件解析失败时抛出 std::runtime_error，此时不会写入任何数据
+   */
+  BulkImportStats BulkImportFile(const std::string &path,
+                                 EdgeFileFormat format,
+                                 bool snapshot_at_end = true);
+
+  // ── 图快照 ────────────────────────────────────────────────────────────────
+
+  /**
+   * 写出图快照（格式见 GraphSnapshotSection）
+   *
+   * KV 快照把图拆成成千上万条小记录，重启时逐条 put_for_recovery，
+   * 邻接表损坏还得 export 全量数据重建。图快照按节点编号组织：
+   * 节点字典、出入两个方向的 CSR、边记录和 embedding 各占一段，
+   * 以大块顺序写入，写到 path.tmp 后 rename 替换。
+   * 邻接关系取自 e: 记录（与 RebuildAdjacencyList 相同），不读 adj: Key。
+   * 与 create_snapshot 一样在 export_all_data 的全局锁下取得一致视图。
+   * @throws std::runtime_error 写文件失败
+   */
+  GraphSnapshotStats SaveSnapshot(const std::string &path) const;
+
+  /**
+   * 从图快照加载（启动时调用）
+   *
+   * mmap 整个文件，校验通过后按节点编号分块（有线程池时并行）直接从 CSR
+   * 生成 adj:out / adj:in blob，连同 n: / e: / vec: 记录通过 bulk_load
+   * 按分片批量写入；不经过 WAL，不需要 RebuildAdjacencyList。
+   * 度数统计随之建立，超过阈值的邻接表直接以分页形式写入；
+   * 已启用的关键词索引和属性索引同步更新。
+   *
+   * 应在空的 GraphStore 上调用：同名 Key 被覆盖，邻接表不与已有数据合并。
+   * 需要持久化的部署在加载后调用 checkpoint_now() / create_snapshot()。
+   * @throws std::runtime_error 文件缺失、被截断或校验失败，此时 KV 不变
+   */
+  GraphSnapshotStats LoadSnapshot(const std::string &path);
+
+  // ── 边有效期 ──────────────────────────────────────────────────────────────
+
+  /**
+   * 启动边过期清理
+   *
+   * 带 valid_to 的边到期后 as_of 查询已经看不到它，不需要立即改写邻接表；
+   * 这里由 base::ExpirationManager 在后台按分片把
+   * valid_to + retention_ms <= now 的边下线（DeleteEdge），回收存储。
+   * 启用时扫描一遍现有的 e: 记录，之后 AddEdge / 批量导入 / 快照加载
+   * 的带 valid_to 的边自动入队。重复调用会以新配置重启后台线程。
+   * @throws std::invalid_argument retention_ms < 0、check_interval 或
+   *         sample_size 为 0
+   */
+  void EnableEdgeExpiration(const EdgeExpirationOptions &options = {});
+
+  /**
+   * 立即下线 valid_to + retention_ms <= now 的边，返回下线条数
+   * （测试和手动清理用；需先 EnableEdgeExpiration）
+   */
+  size_t RetireExpiredEdges(int64_t now);
+
+  /** 过期清理统计；未启用时全为 0 */
+  EdgeExpirationStats EdgeExpiration() const;
 
   // ── 一致性修复 ────────────────────────────────────────────────────────────
 
@@ -205,6 +811,33 @@ private:
   // n_threads <= 1 时为 nullptr，退化为串行
   std::unique_ptr<minkv::base::ThreadPool> thread_pool_;
 
+  // 写操作递增的版本号；查询缓存据此判断条目是否过期
+  GraphVersionTracker versions_;
+  // GraphRAGQuery 结果缓存，EnableQueryCache 之前为 nullptr
+  std::unique_ptr<GraphRAGQueryCache> query_cache_;
+  // 属性关键词索引，EnableKeywordIndex 之前为 nullptr
+  std::unique_ptr<KeywordIndex> keyword_index_;
+  // 属性二级索引，未建立任何索引时写路径不加锁
+  PropertyIndex property_index_;
+  // 每个节点的出度 / 入度
+  DegreeTracker degrees_;
+  // 超级节点的分页邻接表
+  std::unique_ptr<PagedAdjacency> paged_adj_;
+  // 普通邻接表写操作按 Key 哈希串行化：升级为分页存储时，
+  // 同一 Key 上的其他写操作不能在"读出旧表"和"写入页头"之间插入
+  mutable std::array<std::mutex, 64> adj_stripes_;
+  // 边写操作按 e: Key 哈希串行化：过期清理的"核对有效期 → 删除"
+  // 不能和同一条边的重新添加交错，否则 e: 与 adj: 会不一致。
+  // 加锁顺序：先边锁，后邻接表锁
+  mutable std::array<std::mutex, 64> edge_stripes_;
+  // 带 valid_to 的边，EnableEdgeExpiration 之后才入队
+  EdgeExpiryQueue edge_expiry_;
+  EdgeExpirationOptions expiration_options_;
+  std::atomic<bool> expiry_enabled_{false};
+  std::atomic<uint64_t> edges_retired_{0};
+  // 必须是最后一个成员：析构时最先停止后台线程，它的回调访问上面的成员
+  std::unique_ptr<minkv::base::ExpirationManager> edge_expiration_;
+
   // ── Key 构造辅助函数 ──────────────────────────────────────────────────────
   //
   // 规则：node_id / label 中的 ':' 需要转义为 '\:'，防止 Key 解析歧义。
@@ -213,6 +846,9 @@ private:
   /** 对 id 中的 ':' 和 '\' 做转义 */
   static std::string EscapeId(const std::string &id);
 
+  /** EscapeId 的逆变换，用于从 Key 还原 node_id */
+  static std::string UnescapeId(std::string_view escaped);
+
   /** 节点数据 Key：n:{node_id} */
   static std::string NodeKey(const std::string &node_id);
 
@@ -229,44 +865,105 @@ private:
   /** Embedding Key：vec:{node_id} */
   static std::string VecKey(const std::string &node_id);
 
+  // ── 邻接表内部辅助 ────────────────────────────────────────────────────────
+
   /**
-   * 边计数器 Key：ec:{src}:{dst}
-   *
-   * 用于 O(1) 判断 (src, dst) 之间是否还有其他 label 的边，
-   * 避免 DeleteEdge 全表扫描。
-   * Value 是 uint64_t 的十进制字符串，通过 update_in_place 原子增减。
+   * 从 KV 读取邻接表条目；Key 不存在时返回空列表
+   * labels 非空时只返回这些标签的条目，给定 as_of 时只返回当时有效的条目
    */
-  static std::string EdgeCountKey(const std::string &src,
-                                  const std::string &dst);
+  std::vector<AdjEntry>
+  LoadAdjEntries(const std::string &kv_key,
+                 const std::vector<std::string> &labels = {},
+                 std::optional<int64_t> as_of = std::nullopt) const;
 
-  // ── 邻接表内部辅助 ────────────────────────────────────────────────────────
+  /**
+   * 按 filter 读取 node_id 的邻接表条目
+   * BOTH 方向时依次拼接出边、入边条目（同一邻居可能出现多次）
+   */
+  std::vector<AdjEntry>
+  LoadFilteredEntries(const std::string &node_id,
+                      const TraversalFilter &filter) const;
+
+  /**
+   * 提取条目中的邻居 ID（按首次出现顺序去重）
+   * 同一邻居的多条不同 label 的边只返回一次
+   */
+  static std::vector<std::string>
+  UniqueNeighbors(std::vector<AdjEntry> entries);
 
-  /** 从 KV 读取邻接表并反序列化；Key 不存在时返回空列表 */
+  /** 读取邻接表中的邻居 ID，等价于 UniqueNeighbors(LoadAdjEntries(key)) */
   std::vector<std::string> LoadAdjList(const std::string &kv_key) const;
 
-  /** 将邻接表序列化后写入 KV */
-  void SaveAdjList(const std::string &kv_key,
-                   const std::vector<std::string> &list);
+  /**
+   * 批量读取 frontier 中每个节点的邻接表（BFS 的一层扩展）
+   *
+   * @param frontier        当前层节点
+   * @param filter          扩展方向与标签过滤
+   * @param allow_parallel  是否允许提交到 thread_pool_；已运行在线程池任务
+   *                        内的调用方必须传 false，避免嵌套等待导致死锁
+   * @param cancel          每读取 64 个节点检查一次，取消后其余节点的
+   *                        邻居列表留空
+   * @return 与 frontier 一一对应的邻居列表
+   */
+  std::vector<std::vector<std::string>>
+  ExpandFrontier(const std::vector<std::string> &frontier,
+                 const TraversalFilter &filter, bool allow_parallel,
+                 const base::CancellationToken &cancel = {}) const;
+
+  /** 邻接表 Key 对应的写锁 */
+  std::mutex &AdjStripe(const std::string &kv_key) const;
+
+  /** 边 Key（e:）对应的写锁 */
+  std::mutex &EdgeStripe(const std::string &edge_key) const;
 
-  /** 向邻接表追加一个 id（自动去重） */
-  void AdjListAdd(const std::string &kv_key, const std::string &id);
+  /** DeleteEdge 的实现，调用方须持有该边的 EdgeStripe 锁 */
+  void DeleteEdgeLocked(const std::string &src_id, const std::string &dst_id,
+                        const std::string &label);
+
+  /**
+   * 写入一条邻接表条目：(neighbor, label) 已存在时更新权重和有效期，
+   * 否则追加。重复 AddEdge 同一条边是幂等的（与 e: Key 的覆盖语义一致）
+   * outgoing 为 true 时写 node_id 的出边表，否则写入边表；同时更新度数
+   */
+  void AdjEntryUpsert(const std::string &node_id, bool outgoing,
+                      const AdjEntry &entry);
 
-  /** 从邻接表移除一个 id；列表变空时删除整个 Key */
-  void AdjListRemove(const std::string &kv_key, const std::string &id);
+  /** 同 AdjEntryUpsert，一次 read-modify-write 写入 batch 中的全部条目 */
+  void AdjEntriesUpsert(const std::string &node_id, bool outgoing,
+                        const std::vector<AdjEntry> &batch);
 
-  // ── 边计数器辅助 ──────────────────────────────────────────────────────────
+  /** 边在 src（outgoing）或 dst 一侧邻接表中的条目 */
+  static AdjEntry ToAdjEntry(const Edge &edge, bool outgoing);
 
   /**
-   * 原子递增边计数器（update_in_place 保证并发安全）
-   * 在 AddEdge 时调用。
+   * 下线分片 stripe 中已过保留期的边，最多 max 条
+   * blocking 为 false 且分片锁被占用时返回 SIZE_MAX（ExpirationManager 约定）
    */
-  void IncrementEdgeCount(const std::string &src, const std::string &dst);
+  size_t RetireStripe(size_t stripe, int64_t now, size_t max, bool blocking);
+
+  /** 删除 (neighbor, label) 条目；列表变空时删除整个 Key */
+  void AdjEntryRemove(const std::string &node_id, bool outgoing,
+                      const std::string &neighbor, const std::string &label);
+
+  /** 删除与 neighbor 相关的全部条目（所有 label）；列表变空时删除 Key */
+  void AdjEntryRemoveNeighbor(const std::string &node_id, bool outgoing,
+                              const std::string &neighbor);
+
+  /** 删除 node_id 的整个出边表或入边表（普通或分页存储） */
+  void AdjListRemove(const std::string &node_id, bool outgoing);
+
+  /** 批量加载节点属性（GetNodes），跳过不存在的节点，保持 node_ids 顺序 */
+  std::vector<Node>
+  LoadExistingNodes(const std::vector<std::string> &node_ids,
+                    const Projection &projection = {}) const;
 
   /**
-   * 原子递减边计数器，返回递减后的值
-   * 在 DeleteEdge 时调用，返回 0 表示 (src,dst) 间已无其他边。
+   * 带权最短路径的公共实现
+   * heuristic_scale == 0 时即 Dijkstra；> 0 时按 embedding 距离做 A*
    */
-  uint64_t DecrementEdgeCount(const std::string &src, const std::string &dst);
+  WeightedPath WeightedSearch(const std::string &src_id,
+                              const std::string &dst_id,
+                              float heuristic_scale) const;
 };
 
 } // namespace graph
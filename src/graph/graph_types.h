@@ -1,10 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <string>
 
 namespace minkv {
 namespace graph {
 
+/**
+ * 边有效期的边界（时间戳单位由调用方约定，内置的过期清理使用 Unix 毫秒）
+ * valid_from 取 VALID_FROM_ALWAYS、valid_to 取 VALID_TO_FOREVER 表示不限
+ */
+constexpr int64_t VALID_FROM_ALWAYS = std::numeric_limits<int64_t>::min();
+constexpr int64_t VALID_TO_FOREVER = std::numeric_limits<int64_t>::max();
+
 /**
  * 图节点
  *
@@ -30,6 +39,9 @@ struct Node {
  *
  * 存储在 KV 中的 Key 格式：e:{src_id}:{dst_id}:{label}
  * 注意：如果 id 或 label 本身含有 ':'，GraphStore 会先做转义再拼 Key。
+ *
+ * 可选的有效期 [valid_from, valid_to)：带 as_of 的遍历只经过在该时刻
+ * 有效的边；不带 as_of 时有效期不影响遍历。
  */
 struct Edge {
   std::string src_id;  // 起点节点 ID
@@ -37,12 +49,49 @@ struct Edge {
   std::string label;   // 边的类型/标签，例如 "KNOWS"、"WORKS_AT"
   float weight = 1.0f; // 边的权重，默认 1.0
   std::string properties_json; // 边的附加属性，JSON 格式字符串
+  int64_t valid_from = VALID_FROM_ALWAYS; // 生效时刻（含）
+  int64_t valid_to = VALID_TO_FOREVER;    // 失效时刻（不含）
+
+  /** 是否设置了有效期 */
+  bool IsTemporal() const {
+    return valid_from != VALID_FROM_ALWAYS || valid_to != VALID_TO_FOREVER;
+  }
+
+  bool ValidAt(int64_t t) const { return valid_from <= t && t < valid_to; }
 
   // 用于测试断言：所有字段完全相等才算相等
   bool operator==(const Edge &other) const {
     return src_id == other.src_id && dst_id == other.dst_id &&
            label == other.label && weight == other.weight &&
-           properties_json == other.properties_json;
+           properties_json == other.properties_json &&
+           valid_from == other.valid_from && valid_to == other.valid_to;
+  }
+};
+
+/**
+ * 邻接表条目
+ *
+ * adj:out:{id} / adj:in:{id} 中的每个元素对应一条边：
+ *   - 出边表里 neighbor_id 是 dst，入边表里是 src
+ *   - (neighbor_id, label) 唯一确定一条边，多重边各占一个条目
+ *   - weight 冗余自 Edge::weight，带权遍历时无需再读 e: Key
+ *   - 有效期同样冗余自 Edge，按 as_of 过滤时不读 e: Key
+ */
+struct AdjEntry {
+  std::string neighbor_id; // 邻居节点 ID
+  std::string label;       // 边标签
+  float weight = 1.0f;     // 边权重
+  int64_t valid_from = VALID_FROM_ALWAYS;
+  int64_t valid_to = VALID_TO_FOREVER;
+
+  bool IsTemporal() const {
+    return valid_from != VALID_FROM_ALWAYS || valid_to != VALID_TO_FOREVER;
+  }
+
+  bool operator==(const AdjEntry &other) const {
+    return neighbor_id == other.neighbor_id && label == other.label &&
+           weight == other.weight && valid_from == other.valid_from &&
+           valid_to == other.valid_to;
   }
 };
 
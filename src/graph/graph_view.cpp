@@ -0,0 +1,172 @@
+#include "graph_view.h"
+
+namespace minkv {
+namespace graph {
+
+namespace {
+
+bool IsWs(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+void SkipWs(std::string_view s, size_t &pos) {
+  while (pos < s.size() && IsWs(s[pos]))
+    ++pos;
+}
+
+/** pos 指向开引号；成功时 pos 移到闭引号之后 */
+bool SkipString(std::string_view s, size_t &pos) {
+  for (++pos; pos < s.size(); ++pos) {
+    if (s[pos] == '\\')
+      ++pos;
+    else if (s[pos] == '"') {
+      ++pos;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * 跳过一个任意 JSON 值，pos 移到值之后
+ * 对象/数组按括号配对（跳过字符串内的括号）；标量读到 ',' / '}' / ']' 为止
+ */
+bool SkipValue(std::string_view s, size_t &pos) {
+  if (pos >= s.size())
+    return false;
+  if (s[pos] == '"')
+    return SkipString(s, pos);
+  if (s[pos] != '{' && s[pos] != '[') {
+    while (pos < s.size() && s[pos] != ',' && s[pos] != '}' &&
+           s[pos] != ']' && !IsWs(s[pos]))
+      ++pos;
+    return true;
+  }
+
+  int depth = 0;
+  while (pos < s.size()) {
+    char c = s[pos];
+    if (c == '"') {
+      if (!SkipString(s, pos))
+        return false;
+      continue;
+    }
+    ++pos;
+    if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      if (--depth == 0)
+        return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+bool ForEachJsonField(
+    std::string_view json,
+    const std::function<bool(std::string_view, std::string_view)> &fn) {
+  size_t pos = 0;
+  SkipWs(json, pos);
+  if (pos >= json.size() || json[pos] != '{')
+    return false;
+  ++pos;
+  SkipWs(json, pos);
+  if (pos < json.size() && json[pos] == '}')
+    return true; // 空对象
+
+  while (true) {
+    SkipWs(json, pos);
+    if (pos >= json.size() || json[pos] != '"')
+      return false;
+    size_t key_begin = pos + 1;
+    if (!SkipString(json, pos))
+      return false;
+    std::string_view key = json.substr(key_begin, pos - 1 - key_begin);
+
+    SkipWs(json, pos);
+    if (pos >= json.size() || json[pos] != ':')
+      return false;
+    ++pos;
+    SkipWs(json, pos);
+
+    size_t value_begin = pos;
+    if (!SkipValue(json, pos))
+      return false;
+    if (!fn(key, json.substr(value_begin, pos - value_begin)))
+      return true;
+
+    SkipWs(json, pos);
+    if (pos < json.size() && json[pos] == '}')
+      return true;
+    if (pos >= json.size() || json[pos] != ',')
+      return false;
+    ++pos;
+  }
+}
+
+std::optional<std::string_view> ExtractJsonField(std::string_view json,
+                                                 std::string_view name) {
+  std::optional<std::string_view> found;
+  ForEachJsonField(json, [&](std::string_view key, std::string_view value) {
+    if (key != name)
+      return true;
+    found = value;
+    return false;
+  });
+  return found;
+}
+
+std::string ProjectProperties(std::string_view json,
+                              const Projection &projection) {
+  if (!projection.properties)
+    return {};
+  if (projection.fields.empty())
+    return std::string(json);
+
+  std::string out = "{";
+  for (const auto &field : projection.fields) {
+    auto value = ExtractJsonField(json, field);
+    if (!value)
+      continue;
+    if (out.size() > 1)
+      out += ',';
+    out += '"';
+    out += field;
+    out += "\":";
+    out += *value;
+  }
+  out += '}';
+  return out;
+}
+
+std::optional<std::string_view>
+NodeView::Property(std::string_view name) const {
+  return ExtractJsonField(properties_json, name);
+}
+
+Node NodeView::ToNode(const Projection &projection) const {
+  Node node;
+  node.node_id = std::string(node_id);
+  node.properties_json = ProjectProperties(properties_json, projection);
+  return node;
+}
+
+std::optional<std::string_view>
+EdgeView::Property(std::string_view name) const {
+  return ExtractJsonField(properties_json, name);
+}
+
+Edge EdgeView::ToEdge() const {
+  Edge edge;
+  edge.src_id = std::string(src_id);
+  edge.dst_id = std::string(dst_id);
+  edge.label = std::string(label);
+  edge.weight = weight;
+  edge.properties_json = std::string(properties_json);
+  edge.valid_from = valid_from;
+  edge.valid_to = valid_to;
+  return edge;
+}
+
+} // namespace graph
+} // namespace minkv
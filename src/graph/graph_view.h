@@ -0,0 +1,100 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "graph_types.h"
+
+namespace minkv {
+namespace graph {
+
+/**
+ * 属性投影：查询接口返回节点时保留哪些属性
+ *
+ * 默认返回完整 properties_json；GraphRAG 的调用方经常只需要 ID
+ * 或少数几个字段，大属性 blob 的拷贝会主导查询代价。
+ */
+struct Projection {
+  bool properties = true; // false：只返回 node_id，properties_json 为空串
+  // 非空时 properties_json 只保留这些顶层字段（缺失的字段省略），
+  // 重新拼成一个 JSON 对象，例如 {"name":"Alice","age":30}
+  std::vector<std::string> fields;
+
+  /** 是否原样返回完整属性（无需任何裁剪） */
+  bool IsFull() const { return properties && fields.empty(); }
+
+  static Projection IdsOnly() {
+    Projection p;
+    p.properties = false;
+    return p;
+  }
+
+  static Projection Fields(std::vector<std::string> fields) {
+    Projection p;
+    p.fields = std::move(fields);
+    return p;
+  }
+};
+
+/**
+ * NodeView — 指向序列化节点记录内部的只读视图
+ *
+ * 由 GraphSerializer::ViewNode 创建，字段都是 string_view，不拷贝数据。
+ * 视图不持有缓冲区，只在底层记录有效期间可用
+ * （例如 GraphStore::VisitNodes 的回调内部）。
+ */
+struct NodeView {
+  std::string_view node_id;
+  std::string_view properties_json;
+
+  /**
+   * 按需提取 properties_json 的一个顶层字段，返回其原始 JSON 文本
+   * （字符串值包含引号，对象/数组为完整的括号内容）；字段不存在时返回 nullopt
+   */
+  std::optional<std::string_view> Property(std::string_view name) const;
+
+  /** 按投影物化为 Node */
+  Node ToNode(const Projection &projection = {}) const;
+};
+
+/** EdgeView — 指向序列化边记录内部的只读视图，约定同 NodeView */
+struct EdgeView {
+  std::string_view src_id;
+  std::string_view dst_id;
+  std::string_view label;
+  float weight = 1.0f;
+  std::string_view properties_json;
+  int64_t valid_from = VALID_FROM_ALWAYS;
+  int64_t valid_to = VALID_TO_FOREVER;
+
+  std::optional<std::string_view> Property(std::string_view name) const;
+
+  Edge ToEdge() const;
+};
+
+/**
+ * 在 JSON 对象文本中查找顶层字段 name，返回其值的原始文本
+ *
+ * 只扫描到目标字段为止，不建立 DOM；嵌套对象/数组按括号配对整体跳过。
+ * 字段名按原始文本比较（不解码转义）。不是对象或格式不完整时返回 nullopt。
+ */
+std::optional<std::string_view> ExtractJsonField(std::string_view json,
+                                                 std::string_view name);
+
+/**
+ * 依次对 JSON 对象的每个顶层字段调用 fn(name, raw_value)，
+ * fn 返回 false 时提前停止；不是对象或格式不完整时返回 false
+ */
+bool ForEachJsonField(
+    std::string_view json,
+    const std::function<bool(std::string_view, std::string_view)> &fn);
+
+/** 按 projection 裁剪属性 JSON；IsFull() 时原样拷贝 */
+std::string ProjectProperties(std::string_view json,
+                              const Projection &projection);
+
+} // namespace graph
+} // namespace minkv
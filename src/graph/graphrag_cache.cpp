@@ -0,0 +1,156 @@
+#include "graphrag_cache.h"
+
+#include <cmath>
+#include <functional>
+
+#include "graph_store.h"
+
+namespace minkv {
+namespace graph {
+
+// ══════════════════════════════════════════════════════════════════════════════
+// GraphVersionTracker
+// ══════════════════════════════════════════════════════════════════════════════
+
+size_t GraphVersionTracker::RegionOf(const std::string &node_id) {
+  return std::hash<std::string>{}(node_id) % REGIONS;
+}
+
+void GraphVersionTracker::TouchNode(const std::string &node_id) {
+  regions_[RegionOf(node_id)].fetch_add(1);
+  global_.fetch_add(1);
+}
+
+void GraphVersionTracker::TouchAll() {
+  epoch_.fetch_add(1);
+  global_.fetch_add(1);
+}
+
+GraphVersionTracker::Snapshot GraphVersionTracker::Take() const {
+  // 先读 global：若读取各区域期间有写入，global 已落后，
+  // GRAPH_WIDE 校验必然失败；PER_REGION 下区域值偏新只会让条目偏保守
+  Snapshot snap;
+  snap.global = global_.load();
+  snap.epoch = epoch_.load();
+  for (size_t i = 0; i < REGIONS; ++i)
+    snap.regions[i] = regions_[i].load();
+  return snap;
+}
+
+bool GraphVersionTracker::RegionsUnchanged(const Snapshot &snap,
+                                           uint64_t region_mask) const {
+  if (epoch_.load() != snap.epoch)
+    return false;
+  for (size_t i = 0; i < REGIONS; ++i) {
+    if ((region_mask >> i & 1) && regions_[i].load() != snap.regions[i])
+      return false;
+  }
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// GraphRAGQueryCache
+// ══════════════════════════════════════════════════════════════════════════════
+
+GraphRAGQueryCache::GraphRAGQueryCache(const GraphRAGCacheOptions &options,
+                                       const GraphVersionTracker &versions)
+    : options_(options), versions_(versions), lru_(options.capacity) {}
+
+/**
+ * Key 布局（二进制）：
+ *   [4B top_k][4B hop_depth][1B direction][4B n_labels]{[4B len][label]}
+ *   [1B properties][4B n_fields]{[4B len][field]}
+ *   [1B has_as_of][8B as_of]（has_as_of 为 0 时没有后面 8 字节）
+ *   [4B dim]{[4B round(x / step)]}
+ */
+std::string
+GraphRAGQueryCache::MakeKey(const std::vector<float> &query_embedding,
+                            int vector_top_k, int hop_depth,
+                            const TraversalFilter &filter,
+                            const Projection &projection) const {
+  std::string key;
+  key.reserve(17 + query_embedding.size() * sizeof(int32_t));
+  auto append_u32 = [&key](uint32_t v) {
+    key.append(reinterpret_cast<const char *>(&v), sizeof(v));
+  };
+
+  append_u32(static_cast<uint32_t>(vector_top_k));
+  append_u32(static_cast<uint32_t>(hop_depth));
+  key += static_cast<char>(filter.direction);
+  append_u32(static_cast<uint32_t>(filter.labels.size()));
+  for (const auto &label : filter.labels) {
+    append_u32(static_cast<uint32_t>(label.size()));
+    key += label;
+  }
+  key += static_cast<char>(projection.properties);
+  append_u32(static_cast<uint32_t>(projection.fields.size()));
+  for (const auto &field : projection.fields) {
+    append_u32(static_cast<uint32_t>(field.size()));
+    key += field;
+  }
+  key += static_cast<char>(filter.as_of.has_value());
+  if (filter.as_of) {
+    int64_t as_of = *filter.as_of;
+    key.append(reinterpret_cast<const char *>(&as_of), sizeof(as_of));
+  }
+
+  append_u32(static_cast<uint32_t>(query_embedding.size()));
+  const float step = options_.quantization_step;
+  for (float x : query_embedding) {
+    append_u32(static_cast<uint32_t>(
+        static_cast<int32_t>(std::lround(x / step))));
+  }
+  return key;
+}
+
+std::optional<std::vector<Node>>
+GraphRAGQueryCache::Lookup(const std::string &key) {
+  auto entry = lru_.get(key);
+  if (!entry) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  const Entry &e = **entry;
+  bool valid = options_.invalidation == CacheInvalidation::GRAPH_WIDE
+                   ? versions_.global() == e.snap.global
+                   : versions_.RegionsUnchanged(e.snap, e.region_mask);
+  if (!valid) {
+    lru_.remove(key);
+    stale_.fetch_add(1, std::memory_order_relaxed);
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  return e.nodes;
+}
+
+void GraphRAGQueryCache::Insert(const std::string &key,
+                                const GraphVersionTracker::Snapshot &snap,
+                                const std::vector<std::string> &node_ids,
+                                std::vector<Node> nodes) {
+  auto entry = std::make_shared<Entry>();
+  entry->snap = snap;
+  for (const auto &id : node_ids)
+    entry->region_mask |= uint64_t{1} << GraphVersionTracker::RegionOf(id);
+  entry->nodes = std::move(nodes);
+  lru_.put(key, std::move(entry));
+  inserts_.fetch_add(1, std::memory_order_relaxed);
+}
+
+GraphRAGCacheStats GraphRAGQueryCache::Stats() const {
+  GraphRAGCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.stale = stale_.load(std::memory_order_relaxed);
+  stats.inserts = inserts_.load(std::memory_order_relaxed);
+  auto lru_stats = lru_.getStats();
+  stats.evictions = lru_stats.evictions;
+  stats.entries = lru_stats.current_size;
+  return stats;
+}
+
+void GraphRAGQueryCache::Clear() { lru_.clear(); }
+
+} // namespace graph
+} // namespace minkv
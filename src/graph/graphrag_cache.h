@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../core/lru_cache.h"
+#include "graph_types.h"
+
+namespace minkv {
+namespace graph {
+
+struct TraversalFilter;
+struct Projection;
+
+/**
+ * GraphVersionTracker — 图变更版本号
+ *
+ * 每次写操作完成后递增，供查询缓存判断条目是否过期。维护三类计数器：
+ *   global  — 任何写操作都会递增（整图粒度）
+ *   epoch   — 影响面无法按节点界定的操作递增：embedding 变化（改变向量检索
+ *             的入口节点）、批量导入、重建邻接表
+ *   region  — 节点 ID 哈希到 REGIONS 个区域之一，触及该节点的写操作
+ *             （节点增删改、以它为端点的边增删）递增对应区域
+ *
+ * 写操作必须在 KV 写入完成"之后"递增版本号；查询在计算"之前"取快照。
+ * 这样计算期间发生的写入一定会让快照落后，结果不会以新版本号被缓存。
+ */
+class GraphVersionTracker {
+public:
+  static constexpr size_t REGIONS = 64;
+
+  struct Snapshot {
+    uint64_t global = 0;
+    uint64_t epoch = 0;
+    std::array<uint64_t, REGIONS> regions{};
+  };
+
+  static size_t RegionOf(const std::string &node_id);
+
+  /** 节点 node_id 所在区域发生了变更 */
+  void TouchNode(const std::string &node_id);
+
+  /** 发生了无法按节点界定影响范围的变更 */
+  void TouchAll();
+
+  uint64_t global() const { return global_.load(); }
+
+  Snapshot Take() const;
+
+  /** snap 之后 regions 掩码中的区域以及 epoch 是否都未变化 */
+  bool RegionsUnchanged(const Snapshot &snap, uint64_t region_mask) const;
+
+private:
+  std::atomic<uint64_t> global_{0};
+  std::atomic<uint64_t> epoch_{0};
+  std::array<std::atomic<uint64_t>, REGIONS> regions_{};
+};
+
+/** 缓存条目的失效粒度 */
+enum class CacheInvalidation {
+  GRAPH_WIDE, // 任何写操作都使全部条目失效；校验只比较一个计数器
+  PER_REGION  // 只有触及结果所涉及区域的写操作才使条目失效
+};
+
+/** GraphRAG 查询缓存配置 */
+struct GraphRAGCacheOptions {
+  size_t capacity = 4096; // 最多缓存的查询数，超出后按 LRU 淘汰
+  // embedding 每一维按 round(x / quantization_step) 量化后参与 Key，
+  // 差异小于量化步长的"几乎相同"的查询共享同一条目
+  float quantization_step = 1e-3f;
+  CacheInvalidation invalidation = CacheInvalidation::PER_REGION;
+};
+
+/** GraphRAG 查询缓存统计 */
+struct GraphRAGCacheStats {
+  uint64_t hits = 0;      // 命中且版本有效
+  uint64_t misses = 0;    // 未命中（含下面的 stale）
+  uint64_t stale = 0;     // 命中但版本已过期，条目被丢弃
+  uint64_t inserts = 0;   // 写入条目数
+  uint64_t evictions = 0; // 因容量满被 LRU 淘汰的条目数
+  size_t entries = 0;     // 当前条目数
+
+  double hit_rate() const {
+    uint64_t total = hits + misses;
+    return total > 0 ? static_cast<double>(hits) / total : 0.0;
+  }
+};
+
+/**
+ * GraphRAGQueryCache — GraphRAGQuery 结果缓存
+ *
+ * Key = 量化后的 embedding + vector_top_k + hop_depth + 遍历过滤条件
+ *       + 属性投影。
+ * 条目保存计算前的版本快照；查找时与 GraphVersionTracker 比较，
+ * 版本变化的条目视为未命中并被删除，因此不需要写路径主动清理缓存。
+ *
+ * 内部使用线程安全的 LruCache，值为共享指针，命中时不复制 Key 之外的数据。
+ */
+class GraphRAGQueryCache {
+public:
+  GraphRAGQueryCache(const GraphRAGCacheOptions &options,
+                     const GraphVersionTracker &versions);
+
+  std::string MakeKey(const std::vector<float> &query_embedding,
+                      int vector_top_k, int hop_depth,
+                      const TraversalFilter &filter,
+                      const Projection &projection) const;
+
+  /** 查找有效条目；过期条目会被删除并计入 stale */
+  std::optional<std::vector<Node>> Lookup(const std::string &key);
+
+  /**
+   * 写入条目
+   * @param snap      计算结果之前取的版本快照
+   * @param node_ids  结果涉及的全部节点（含遍历到但不存在的节点）
+   */
+  void Insert(const std::string &key, const GraphVersionTracker::Snapshot &snap,
+              const std::vector<std::string> &node_ids,
+              std::vector<Node> nodes);
+
+  GraphRAGCacheStats Stats() const;
+
+  void Clear();
+
+private:
+  struct Entry {
+    GraphVersionTracker::Snapshot snap;
+    uint64_t region_mask = 0;
+    std::vector<Node> nodes;
+  };
+
+  GraphRAGCacheOptions options_;
+  const GraphVersionTracker &versions_;
+  minkv::db::LruCache<std::string, std::shared_ptr<const Entry>> lru_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> stale_{0};
+  std::atomic<uint64_t> inserts_{0};
+};
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,258 @@
+#include "keyword_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <mutex>
+
+#include "graph_view.h"
+
+namespace minkv {
+namespace graph {
+
+namespace {
+
+void AppendVarint(std::string &buf, uint32_t v) {
+  while (v >= 0x80) {
+    buf += static_cast<char>((v & 0x7F) | 0x80);
+    v >>= 7;
+  }
+  buf += static_cast<char>(v);
+}
+
+uint32_t ReadVarint(const std::string &buf, size_t &pos) {
+  uint32_t v = 0;
+  for (int shift = 0; pos < buf.size(); shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(buf[pos++]);
+    v |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      break;
+  }
+  return v;
+}
+
+/** UTF-8 首字节对应的字符长度；续字节或非法字节按 1 处理 */
+size_t Utf8Length(unsigned char lead) {
+  if (lead >= 0xF0)
+    return 4;
+  if (lead >= 0xE0)
+    return 3;
+  if (lead >= 0xC0)
+    return 2;
+  return 1;
+}
+
+} // namespace
+
+KeywordIndex::KeywordIndex(KeywordIndexOptions options)
+    : options_(std::move(options)) {}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 分词
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::vector<std::string> KeywordIndex::Tokenize(std::string_view text) {
+  std::vector<std::string> tokens;
+  std::string current;
+  auto flush = [&]() {
+    if (!current.empty()) {
+      tokens.push_back(std::move(current));
+      current.clear();
+    }
+  };
+
+  for (size_t i = 0; i < text.size();) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    if (c == '\\') {
+      // JSON 转义：\n、\" 等当作分隔符，\uXXXX 整体跳过
+      flush();
+      i += (i + 1 < text.size() && text[i + 1] == 'u') ? 6 : 2;
+    } else if (c < 0x80) {
+      if (std::isalnum(c)) {
+        current += static_cast<char>(std::tolower(c));
+      } else {
+        flush();
+      }
+      ++i;
+    } else {
+      // 非 ASCII：每个 UTF-8 字符单独成词（中文按字切分）
+      flush();
+      size_t len = std::min(Utf8Length(c), text.size() - i);
+      tokens.emplace_back(text.substr(i, len));
+      i += len;
+    }
+  }
+  flush();
+  return tokens;
+}
+
+std::vector<std::string>
+KeywordIndex::ExtractTokens(std::string_view properties_json) const {
+  std::vector<std::string> tokens;
+  auto append = [&tokens](std::string_view value) {
+    for (auto &t : Tokenize(value))
+      tokens.push_back(std::move(t));
+  };
+
+  if (!options_.fields.empty()) {
+    for (const auto &field : options_.fields) {
+      if (auto value = ExtractJsonField(properties_json, field))
+        append(*value);
+    }
+  } else if (!ForEachJsonField(properties_json,
+                               [&](std::string_view, std::string_view value) {
+                                 append(value);
+                                 return true;
+                               })) {
+    // 不是 JSON 对象：整段文本都参与索引
+    tokens.clear();
+    append(properties_json);
+  }
+  return tokens;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 写入
+// ══════════════════════════════════════════════════════════════════════════════
+
+void KeywordIndex::Upsert(const std::string &node_id,
+                          std::string_view properties_json) {
+  // 分词不需要持锁
+  auto tokens = ExtractTokens(properties_json);
+  std::unordered_map<std::string, uint32_t> tf;
+  for (auto &t : tokens)
+    ++tf[std::move(t)];
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  RemoveLocked(node_id);
+  if (tf.empty())
+    return;
+
+  const uint32_t doc = next_doc_++;
+  Document &d = docs_[doc];
+  d.node_id = node_id;
+  d.length = static_cast<uint32_t>(tokens.size());
+  d.term_ids.reserve(tf.size());
+  for (const auto &[term, count] : tf) {
+    auto [it, inserted] =
+        term_ids_.try_emplace(term, static_cast<uint32_t>(postings_.size()));
+    if (inserted)
+      postings_.emplace_back();
+    Posting &p = postings_[it->second];
+    // 文档号单调递增，直接追加到 posting 末尾
+    AppendVarint(p.blob, doc - p.last_doc);
+    AppendVarint(p.blob, count);
+    p.last_doc = doc;
+    ++p.df;
+    d.term_ids.push_back(it->second);
+  }
+  doc_of_node_[node_id] = doc;
+  total_length_ += d.length;
+}
+
+void KeywordIndex::Remove(const std::string &node_id) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  RemoveLocked(node_id);
+}
+
+void KeywordIndex::RemoveLocked(const std::string &node_id) {
+  auto it = doc_of_node_.find(node_id);
+  if (it == doc_of_node_.end())
+    return;
+  const uint32_t doc = it->second;
+  doc_of_node_.erase(it);
+
+  auto dit = docs_.find(doc);
+  for (uint32_t term_id : dit->second.term_ids) {
+    // 重写 posting：解码后跳过 doc，其余条目重新做增量编码
+    Posting &p = postings_[term_id];
+    std::string rebuilt;
+    rebuilt.reserve(p.blob.size());
+    uint32_t cur = 0, last = 0;
+    for (size_t pos = 0; pos < p.blob.size();) {
+      cur += ReadVarint(p.blob, pos);
+      uint32_t count = ReadVarint(p.blob, pos);
+      if (cur == doc)
+        continue;
+      AppendVarint(rebuilt, cur - last);
+      AppendVarint(rebuilt, count);
+      last = cur;
+    }
+    p.blob = std::move(rebuilt);
+    p.last_doc = last;
+    --p.df;
+  }
+  total_length_ -= dit->second.length;
+  docs_.erase(dit);
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 检索
+//
+// BM25：score(D, Q) = Σ idf(t) · tf·(k1+1) / (tf + k1·(1 − b + b·|D|/avgdl))
+//       idf(t)     = ln(1 + (N − df + 0.5) / (df + 0.5))
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::vector<std::pair<std::string, double>>
+KeywordIndex::Search(std::string_view query, int top_k) const {
+  auto terms = Tokenize(query);
+  std::sort(terms.begin(), terms.end());
+  terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+  if (terms.empty() || top_k <= 0)
+    return {};
+
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (docs_.empty())
+    return {};
+  const double n = static_cast<double>(docs_.size());
+  const double avgdl = static_cast<double>(total_length_) / n;
+  const double k1 = options_.k1, b = options_.b;
+
+  std::unordered_map<uint32_t, double> scores;
+  for (const auto &term : terms) {
+    auto it = term_ids_.find(term);
+    if (it == term_ids_.end())
+      continue;
+    const Posting &p = postings_[it->second];
+    if (p.df == 0)
+      continue;
+    const double idf = std::log(1.0 + (n - p.df + 0.5) / (p.df + 0.5));
+
+    uint32_t doc = 0;
+    for (size_t pos = 0; pos < p.blob.size();) {
+      doc += ReadVarint(p.blob, pos);
+      const double tf = ReadVarint(p.blob, pos);
+      const double dl = docs_.at(doc).length;
+      scores[doc] +=
+          idf * tf * (k1 + 1.0) / (tf + k1 * (1.0 - b + b * dl / avgdl));
+    }
+  }
+
+  std::vector<std::pair<std::string, double>> result;
+  result.reserve(scores.size());
+  for (const auto &[doc, score] : scores)
+    result.push_back({docs_.at(doc).node_id, score});
+  // 得分相同按 node_id 排序，保证结果确定
+  auto better = [](const auto &x, const auto &y) {
+    return x.second != y.second ? x.second > y.second : x.first < y.first;
+  };
+  size_t k = std::min(result.size(), static_cast<size_t>(top_k));
+  std::partial_sort(result.begin(), result.begin() + k, result.end(), better);
+  result.resize(k);
+  return result;
+}
+
+KeywordIndexStats KeywordIndex::Stats() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  KeywordIndexStats stats;
+  stats.documents = docs_.size();
+  stats.terms = term_ids_.size();
+  for (const auto &p : postings_) {
+    stats.postings += p.df;
+    stats.posting_bytes += p.blob.size();
+  }
+  return stats;
+}
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace minkv {
+namespace graph {
+
+/** 关键词索引配置 */
+struct KeywordIndexOptions {
+  // 参与索引的 properties_json 顶层字段；为空时索引全部顶层字段
+  std::vector<std::string> fields;
+  double k1 = 1.2; // BM25 词频饱和参数
+  double b = 0.75; // BM25 文档长度归一化参数
+};
+
+/** 关键词索引统计 */
+struct KeywordIndexStats {
+  size_t documents = 0;     // 已索引的节点数
+  size_t terms = 0;         // 词项数
+  size_t postings = 0;      // 倒排条目总数
+  size_t posting_bytes = 0; // 压缩后倒排表字节数
+};
+
+/**
+ * KeywordIndex — 节点属性的内存倒排索引（BM25 打分）
+ *
+ * 分词：ASCII 字母数字连续段转小写作为一个词；非 ASCII 字符
+ * （如中文）每个 UTF-8 字符单独成词；JSON 转义序列按分隔符处理。
+ *
+ * 倒排表压缩：每个词项的 posting 按内部文档号升序存放，
+ *   {varint(doc_id - prev_doc_id), varint(tf)}*
+ * 文档号单调分配，新增文档只需在末尾追加；节点被覆盖或删除时
+ * 只重写它包含的词项的 posting（O(df)）。
+ *
+ * 线程安全：写操作持独占锁，检索持共享锁。
+ */
+class KeywordIndex {
+public:
+  explicit KeywordIndex(KeywordIndexOptions options = {});
+
+  /** 索引（或重新索引）节点；node_id 已存在时先移除旧文档 */
+  void Upsert(const std::string &node_id, std::string_view properties_json);
+
+  /** 移除节点；不存在时忽略 */
+  void Remove(const std::string &node_id);
+
+  /**
+   * BM25 检索
+   * @return {node_id, score}，按得分降序，最多 top_k 个
+   */
+  std::vector<std::pair<std::string, double>> Search(std::string_view query,
+                                                     int top_k) const;
+
+  KeywordIndexStats Stats() const;
+
+  /** 分词（检索和建索引共用），返回小写词序列 */
+  static std::vector<std::string> Tokenize(std::string_view text);
+
+private:
+  struct Posting {
+    std::string blob;      // 压缩后的 {doc 增量, tf} 序列
+    uint32_t last_doc = 0; // 末尾文档号，追加时计算增量
+    uint32_t df = 0;       // 包含该词的文档数
+  };
+
+  struct Document {
+    std::string node_id;
+    uint32_t length = 0;           // 词数（BM25 长度归一化）
+    std::vector<uint32_t> term_ids; // 去重后的词项，删除时定位 posting
+  };
+
+  KeywordIndexOptions options_;
+  mutable std::shared_mutex mutex_;
+
+  std::unordered_map<std::string, uint32_t> term_ids_;
+  std::vector<Posting> postings_; // 下标为词项 ID
+
+  std::unordered_map<std::string, uint32_t> doc_of_node_; // 仅含存活文档
+  std::unordered_map<uint32_t, Document> docs_;           // 存活文档
+  uint32_t next_doc_ = 1; // 0 保留给 Posting::last_doc 的初值
+  uint64_t total_length_ = 0;
+
+  /** 提取需要索引的文本并分词 */
+  std::vector<std::string>
+  ExtractTokens(std::string_view properties_json) const;
+
+  /** 从所有相关 posting 中删除文档；调用方持独占锁 */
+  void RemoveLocked(const std::string &node_id);
+};
+
+} // namespace graph
+} // namespace minkv
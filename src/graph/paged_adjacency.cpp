@@ -0,0 +1,330 @@
+#include "paged_adjacency.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "graph_serializer.h"
+
+namespace minkv {
+namespace graph {
+
+namespace {
+
+constexpr uint32_t kHeaderMagic = 0xFFFFFFFFu;
+constexpr size_t kHeaderSize = 8;
+
+uint32_t HeaderPages(const std::string &header) {
+  uint32_t pages = 0;
+  for (int i = 3; i >= 0; --i)
+    pages = (pages << 8) | static_cast<uint8_t>(header[4 + i]);
+  return pages;
+}
+
+} // namespace
+
+PagedAdjacency::PagedAdjacency(KVStore &kv, SupernodeOptions options)
+    : kv_(kv), options_(options) {}
+
+bool PagedAdjacency::IsHeader(const std::string &value) {
+  // 普通邻接表以 4 字节条目数开头，不可能达到 0xFFFFFFFF
+  //（带有效期索引时最高位为 1，但长度远不止 8 字节）
+  if (value.size() != kHeaderSize)
+    return false;
+  uint32_t magic;
+  std::memcpy(&magic, value.data(), 4);
+  return magic == kHeaderMagic;
+}
+
+std::string PagedAdjacency::PageKey(const std::string &kv_key, uint32_t page) {
+  // kv_key 形如 "adj:out:{escaped_id}"，id 中的 ':' 已转义，
+  // 末尾追加的 ":{page}" 不会与 id 混淆
+  return "adjp" + kv_key.substr(3) + ":" + std::to_string(page);
+}
+
+void PagedAdjacency::WriteHeader(const std::string &kv_key, uint32_t pages) {
+  std::string header(kHeaderSize, '\0');
+  uint32_t magic = kHeaderMagic;
+  std::memcpy(&header[0], &magic, 4);
+  for (int i = 0; i < 4; ++i)
+    header[4 + i] = static_cast<char>((pages >> (8 * i)) & 0xFF);
+  kv_.put(kv_key, header);
+}
+
+std::vector<AdjEntry> PagedAdjacency::ReadPage(const std::string &kv_key,
+                                               uint32_t page) const {
+  auto val = kv_.get(PageKey(kv_key, page));
+  if (!val)
+    return {};
+  return GraphSerializer::DeserializeAdjEntries(*val);
+}
+
+void PagedAdjacency::WritePage(const std::string &kv_key, uint32_t page,
+                               const std::vector<AdjEntry> &entries) {
+  if (entries.empty())
+    kv_.remove(PageKey(kv_key, page));
+  else
+    kv_.put(PageKey(kv_key, page),
+            GraphSerializer::SerializeAdjEntries(entries));
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 目录
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::shared_ptr<PagedAdjacency::List>
+PagedAdjacency::Get(const std::string &kv_key) const {
+  {
+    std::shared_lock<std::shared_mutex> lock(registry_mutex_);
+    auto it = lists_.find(kv_key);
+    if (it != lists_.end())
+      return it->second;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(registry_mutex_);
+  auto it = lists_.find(kv_key);
+  if (it != lists_.end())
+    return it->second;
+
+  // 目录不在内存中：从页头和页数据重建
+  auto header = kv_.get(kv_key);
+  if (!header || !IsHeader(*header))
+    return nullptr;
+  auto list = std::make_shared<List>();
+  list->page_counts.resize(HeaderPages(*header), 0);
+  for (uint32_t p = 0; p < list->page_counts.size(); ++p) {
+    for (auto &e : ReadPage(kv_key, p)) {
+      list->where[e.neighbor_id][e.label] = p;
+      ++list->page_counts[p];
+      ++list->size;
+    }
+  }
+  lists_.emplace(kv_key, list);
+  return list;
+}
+
+void PagedAdjacency::Store(const std::string &kv_key,
+                           const std::vector<AdjEntry> &entries) {
+  const size_t page_size = std::max<size_t>(options_.page_size, 1);
+  std::unique_lock<std::shared_mutex> lock(registry_mutex_);
+
+  // 旧表（若有）作废，记下旧页数以便清理多余的页
+  uint32_t old_pages = 0;
+  auto it = lists_.find(kv_key);
+  if (it != lists_.end()) {
+    std::lock_guard<std::mutex> old_lock(it->second->mu);
+    it->second->dropped = true;
+    old_pages = static_cast<uint32_t>(it->second->page_counts.size());
+  } else if (auto header = kv_.get(kv_key); header && IsHeader(*header)) {
+    old_pages = HeaderPages(*header);
+  }
+
+  auto list = std::make_shared<List>();
+  for (size_t begin = 0; begin < entries.size(); begin += page_size) {
+    size_t end = std::min(begin + page_size, entries.size());
+    uint32_t page = static_cast<uint32_t>(list->page_counts.size());
+    std::vector<AdjEntry> chunk(entries.begin() + begin, entries.begin() + end);
+    for (const auto &e : chunk)
+      list->where[e.neighbor_id][e.label] = page;
+    WritePage(kv_key, page, chunk);
+    list->page_counts.push_back(static_cast<uint32_t>(chunk.size()));
+  }
+  list->size = entries.size();
+  for (uint32_t p = static_cast<uint32_t>(list->page_counts.size());
+       p < old_pages; ++p)
+    kv_.remove(PageKey(kv_key, p));
+
+  lists_[kv_key] = list;
+  WriteHeader(kv_key, static_cast<uint32_t>(list->page_counts.size()));
+}
+
+void PagedAdjacency::Drop(const std::string &kv_key, bool only_if_empty) {
+  auto list = Get(kv_key);
+  if (!list)
+    return;
+  std::unique_lock<std::shared_mutex> lock(registry_mutex_);
+  std::lock_guard<std::mutex> list_lock(list->mu);
+  if (list->dropped || (only_if_empty && list->size > 0))
+    return;
+  list->dropped = true;
+  for (uint32_t p = 0; p < list->page_counts.size(); ++p)
+    kv_.remove(PageKey(kv_key, p));
+  kv_.remove(kv_key);
+  lists_.erase(kv_key);
+}
+
+void PagedAdjacency::Clear() {
+  std::unique_lock<std::shared_mutex> lock(registry_mutex_);
+  for (auto &[key, list] : lists_) {
+    std::lock_guard<std::mutex> list_lock(list->mu);
+    list->dropped = true;
+  }
+  lists_.clear();
+}
+
+size_t PagedAdjacency::Count() const {
+  std::shared_lock<std::shared_mutex> lock(registry_mutex_);
+  return lists_.size();
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 单条目读写：只读写一页
+// ══════════════════════════════════════════════════════════════════════════════
+
+bool PagedAdjacency::Upsert(const std::string &kv_key, const AdjEntry &entry,
+                            const SizeCallback &on_size) {
+  const std::string &neighbor = entry.neighbor_id;
+  const std::string &label = entry.label;
+  auto list = Get(kv_key);
+  if (!list)
+    return false;
+  std::lock_guard<std::mutex> lock(list->mu);
+  if (list->dropped)
+    return false;
+
+  auto &labels = list->where[neighbor];
+  auto found = labels.find(label);
+  if (found != labels.end()) {
+    // 重复添加同一条边：覆盖权重和有效期
+    auto entries = ReadPage(kv_key, found->second);
+    for (auto &e : entries) {
+      if (e.neighbor_id == neighbor && e.label == label)
+        e = entry;
+    }
+    WritePage(kv_key, found->second, entries);
+    on_size(list->size);
+    return true;
+  }
+
+  // 优先追加到最后一页，其次填入删除留下的空位，都满时开新页
+  const size_t page_size = std::max<size_t>(options_.page_size, 1);
+  auto &counts = list->page_counts;
+  uint32_t page = static_cast<uint32_t>(counts.size());
+  if (!counts.empty() && counts.back() < page_size) {
+    page = static_cast<uint32_t>(counts.size() - 1);
+  } else {
+    auto hole = std::find_if(counts.begin(), counts.end(),
+                             [page_size](uint32_t c) { return c < page_size; });
+    page = static_cast<uint32_t>(hole - counts.begin());
+  }
+
+  auto entries = ReadPage(kv_key, page);
+  entries.push_back(entry);
+  WritePage(kv_key, page, entries);
+  if (page == counts.size()) {
+    counts.push_back(0);
+    WriteHeader(kv_key, static_cast<uint32_t>(counts.size()));
+  }
+  ++counts[page];
+  labels.emplace(label, page);
+  on_size(++list->size);
+  return true;
+}
+
+bool PagedAdjacency::Remove(const std::string &kv_key,
+                            const std::string &neighbor,
+                            const std::string &label,
+                            const SizeCallback &on_size) {
+  auto list = Get(kv_key);
+  if (!list)
+    return false;
+  std::lock_guard<std::mutex> lock(list->mu);
+  if (list->dropped)
+    return false;
+
+  auto nit = list->where.find(neighbor);
+  if (nit == list->where.end() || !nit->second.count(label)) {
+    on_size(list->size); // 条目不存在，不做修改
+    return true;
+  }
+
+  uint32_t page = nit->second.at(label);
+  auto entries = ReadPage(kv_key, page);
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [&](const AdjEntry &e) {
+                                 return e.neighbor_id == neighbor &&
+                                        e.label == label;
+                               }),
+                entries.end());
+  WritePage(kv_key, page, entries);
+  --list->page_counts[page];
+  nit->second.erase(label);
+  if (nit->second.empty())
+    list->where.erase(nit);
+  on_size(--list->size);
+  return true;
+}
+
+bool PagedAdjacency::RemoveNeighbor(const std::string &kv_key,
+                                    const std::string &neighbor,
+                                    const SizeCallback &on_size) {
+  auto list = Get(kv_key);
+  if (!list)
+    return false;
+  std::lock_guard<std::mutex> lock(list->mu);
+  if (list->dropped)
+    return false;
+
+  auto nit = list->where.find(neighbor);
+  if (nit == list->where.end()) {
+    on_size(list->size);
+    return true;
+  }
+  std::vector<uint32_t> pages;
+  for (const auto &[label, page] : nit->second)
+    pages.push_back(page);
+  std::sort(pages.begin(), pages.end());
+  pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+  for (uint32_t page : pages) {
+    auto entries = ReadPage(kv_key, page);
+    size_t before = entries.size();
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&](const AdjEntry &e) {
+                                   return e.neighbor_id == neighbor;
+                                 }),
+                  entries.end());
+    WritePage(kv_key, page, entries);
+    list->page_counts[page] -= static_cast<uint32_t>(before - entries.size());
+    list->size -= before - entries.size();
+  }
+  list->where.erase(nit);
+  on_size(list->size);
+  return true;
+}
+
+std::vector<AdjEntry>
+PagedAdjacency::Load(const std::string &kv_key,
+                     const std::vector<std::string> &labels,
+                     std::optional<int64_t> as_of) const {
+  // 表在等锁期间被 Store 替换时重新取目录；被 Drop 后 Get 返回空
+  std::vector<std::string> keys;
+  for (bool done = false; !done;) {
+    auto list = Get(kv_key);
+    if (!list)
+      return {};
+    std::lock_guard<std::mutex> lock(list->mu);
+    if (list->dropped)
+      continue;
+    done = true;
+    for (uint32_t p = 0; p < list->page_counts.size(); ++p) {
+      if (list->page_counts[p] > 0)
+        keys.push_back(PageKey(kv_key, p));
+    }
+  }
+
+  // 页按分片分组批量读取；读取期间不持有表锁，写操作不会被长时间读阻塞。
+  // 每页本身由一次 put 整体替换，读到的总是某个完整版本
+  std::vector<std::vector<AdjEntry>> pages(keys.size());
+  kv_.multi_visit(keys, [&](size_t i, const std::string &record) {
+    pages[i] = GraphSerializer::DeserializeAdjEntries(record, labels, as_of);
+  });
+  std::vector<AdjEntry> entries;
+  for (auto &page : pages) {
+    entries.insert(entries.end(), std::make_move_iterator(page.begin()),
+                   std::make_move_iterator(page.end()));
+  }
+  return entries;
+}
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/sharded_cache.h"
+#include "graph_types.h"
+
+namespace minkv {
+namespace graph {
+
+/** 超级节点分页存储配置 */
+struct SupernodeOptions {
+  // 邻接表条目数超过该值时转为分页存储；0 表示从不分页
+  size_t promote_threshold = 4096;
+  size_t page_size = 1024; // 每页最多条目数
+};
+
+/**
+ * PagedAdjacency — 超级节点的分页邻接表
+ *
+ * 普通邻接表是一个 KV 值，每次加边都要在分片锁内反序列化、修改、序列化
+ * 整张表。度数达到百万的枢纽节点会把这个值变成几十 MB，同一分片上的
+ * 所有 Key 都要等它。分页后：
+ *
+ *   adj:out:{id}          -> 页头：[4B 0xFFFFFFFF][4B 页数]
+ *   adjp:out:{id}:{page}  -> 第 page 页，AdjEntries 格式，最多 page_size 条
+ *
+ * 内存目录记录每个 (neighbor, label) 所在的页，写操作只读写一页，
+ * 分片锁只持有一页的读写时间；同一张表的写操作由它自己的互斥锁串行化，
+ * 不占用分片锁。页头是持久的：目录丢失（例如进程重启）后，
+ * 第一次访问时从页数据重建。
+ *
+ * 页删空后保留槽位，之后的插入优先填入有空位的页；整张表删空时删除
+ * 页头和全部页。分页后不会自动退回单值存储。
+ */
+class PagedAdjacency {
+public:
+  using KVStore = minkv::db::ShardedCache<std::string, std::string>;
+
+  PagedAdjacency(KVStore &kv, SupernodeOptions options = {});
+
+  const SupernodeOptions &options() const { return options_; }
+  void set_options(const SupernodeOptions &options) { options_ = options; }
+
+  /** value 是否为分页邻接表的页头 */
+  static bool IsHeader(const std::string &value);
+
+  /**
+   * 用 entries 整体替换 kv_key 的邻接表并以分页形式存储
+   * （普通邻接表升级、批量导入时调用）；写入顺序为 页 → 目录 → 页头，
+   * 读者看到页头时目录一定已就绪
+   */
+  void Store(const std::string &kv_key, const std::vector<AdjEntry> &entries);
+
+  /** 写操作完成后以新条目数回调，调用时仍持有该表的锁 */
+  using SizeCallback = std::function<void(size_t)>;
+
+  // 以下写操作只作用于已分页的表：kv_key 不是分页表，或表在等锁期间被
+  // Drop / Store 替换时返回 false，调用方应重新判断存储形式后重试
+
+  /** (neighbor, label) 已存在时更新权重和有效期，否则插入 */
+  bool Upsert(const std::string &kv_key, const AdjEntry &entry,
+              const SizeCallback &on_size);
+
+  bool Remove(const std::string &kv_key, const std::string &neighbor,
+              const std::string &label, const SizeCallback &on_size);
+
+  bool RemoveNeighbor(const std::string &kv_key, const std::string &neighbor,
+                      const SizeCallback &on_size);
+
+  /**
+   * 读取全部页；labels 非空时只返回这些标签的条目，
+   * 给定 as_of 时只返回在该时刻有效的条目
+   */
+  std::vector<AdjEntry> Load(const std::string &kv_key,
+                             const std::vector<std::string> &labels,
+                             std::optional<int64_t> as_of = std::nullopt) const;
+
+  /** 删除页头和全部页；only_if_empty 时表中还有条目则不删除 */
+  void Drop(const std::string &kv_key, bool only_if_empty = false);
+
+  /** 只清空内存目录（RebuildAdjacencyList 已自行删除全部 adj Key） */
+  void Clear();
+
+  /** 当前已知的分页邻接表数 */
+  size_t Count() const;
+
+  /** 分页 Key：adjp:{out|in}:{id}:{page} */
+  static std::string PageKey(const std::string &kv_key, uint32_t page);
+
+private:
+  struct List {
+    std::mutex mu;
+    bool dropped = false;
+    size_t size = 0;
+    std::vector<uint32_t> page_counts; // 每页当前条目数
+    // neighbor -> label -> 所在页
+    std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>
+        where;
+  };
+
+  KVStore &kv_;
+  SupernodeOptions options_;
+
+  mutable std::shared_mutex registry_mutex_;
+  mutable std::unordered_map<std::string, std::shared_ptr<List>> lists_;
+
+  /** 查找目录，不存在时从页头和页数据重建；kv_key 不是分页表时返回空 */
+  std::shared_ptr<List> Get(const std::string &kv_key) const;
+
+  /** 读取一页；页不存在时返回空列表 */
+  std::vector<AdjEntry> ReadPage(const std::string &kv_key,
+                                 uint32_t page) const;
+
+  void WritePage(const std::string &kv_key, uint32_t page,
+                 const std::vector<AdjEntry> &entries);
+
+  void WriteHeader(const std::string &kv_key, uint32_t pages);
+};
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility> // std::swap
+#include <vector>
+
+namespace minkv {
+namespace graph {
+
+/**
+ * PairingHeap — 支持 decrease-key 的最小配对堆
+ *
+ * 用于 Dijkstra / A* 的 open 集合。元素值是搜索内部的整数节点 ID，
+ * 所有堆节点放在一块连续的 vector 里，用下标代替指针：
+ *   - 没有逐节点 new/delete，整个堆随搜索结束一次性释放
+ *   - push 返回的 Handle 即下标，decrease_key 直接定位，无需查找
+ *
+ * 复杂度（摊还）：push O(1)，decrease_key o(log n)（实测接近常数），
+ * pop O(log n)。
+ * 相比 std::priority_queue 的"重复入堆 + 懒删除"，堆大小不会随
+ * 松弛次数膨胀，高扇出图上出堆的无效元素也更少。
+ *
+ * 节点之间的链接（左孩子-右兄弟表示）：
+ *   child   — 最左孩子
+ *   sibling — 右兄弟
+ *   prev    — 最左孩子指向父节点，其余指向左兄弟（decrease_key 摘链用）
+ *
+ * 非线程安全，每次搜索使用独立实例。
+ */
+template <typename Priority> class PairingHeap {
+public:
+  using Handle = uint32_t;
+
+  bool empty() const { return root_ == NIL; }
+  size_t size() const { return size_; }
+
+  /** 插入元素，返回可用于 decrease_key 的句柄 */
+  Handle push(uint32_t value, Priority priority) {
+    Handle h = static_cast<Handle>(nodes_.size());
+    nodes_.push_back({priority, value, NIL, NIL, NIL});
+    root_ = Meld(root_, h);
+    ++size_;
+    return h;
+  }
+
+  /** 堆顶元素值（优先级最小）；空堆时抛异常 */
+  uint32_t top() const {
+    if (empty())
+      throw std::runtime_error("PairingHeap: top on empty heap");
+    return nodes_[root_].value;
+  }
+
+  /** 堆顶优先级 */
+  Priority top_priority() const {
+    if (empty())
+      throw std::runtime_error("PairingHeap: top on empty heap");
+    return nodes_[root_].priority;
+  }
+
+  /** 弹出堆顶；弹出后该元素的句柄失效 */
+  void pop() {
+    if (empty())
+      throw std::runtime_error("PairingHeap: pop on empty heap");
+    root_ = MergePairs(nodes_[root_].child);
+    if (root_ != NIL)
+      nodes_[root_].prev = NIL;
+    --size_;
+  }
+
+  /**
+   * 把句柄 h 的优先级降低到 priority
+   * priority 必须不大于当前值，且 h 仍在堆中（未被 pop）
+   */
+  void decrease_key(Handle h, Priority priority) {
+    nodes_[h].priority = priority;
+    if (h == root_)
+      return;
+
+    // 把 h 所在子树从原位置摘下，再与根合并
+    HeapNode &node = nodes_[h];
+    HeapNode &prev = nodes_[node.prev];
+    if (prev.child == h) {
+      prev.child = node.sibling; // h 是最左孩子
+    } else {
+      prev.sibling = node.sibling;
+    }
+    if (node.sibling != NIL)
+      nodes_[node.sibling].prev = node.prev;
+    node.sibling = NIL;
+    node.prev = NIL;
+    root_ = Meld(root_, h);
+  }
+
+private:
+  static constexpr Handle NIL = UINT32_MAX;
+
+  struct HeapNode {
+    Priority priority;
+    uint32_t value;
+    Handle child;
+    Handle sibling;
+    Handle prev;
+  };
+
+  std::vector<HeapNode> nodes_;
+  std::vector<Handle> scratch_; // MergePairs 复用的临时缓冲
+  Handle root_ = NIL;
+  size_t size_ = 0;
+
+  /** 合并两棵独立的树（a、b 都必须是根），返回新根 */
+  Handle Meld(Handle a, Handle b) {
+    if (a == NIL)
+      return b;
+    if (b == NIL)
+      return a;
+    if (nodes_[b].priority < nodes_[a].priority)
+      std::swap(a, b);
+    // b 成为 a 的最左孩子
+    HeapNode &na = nodes_[a];
+    HeapNode &nb = nodes_[b];
+    nb.prev = a;
+    nb.sibling = na.child;
+    if (na.child != NIL)
+      nodes_[na.child].prev = b;
+    na.child = b;
+    return a;
+  }
+
+  /**
+   * 经典两趟合并：第一趟从左到右两两合并，第二趟从右到左依次并入。
+   * 用迭代代替递归，避免长兄弟链（高扇出节点）导致栈溢出。
+   */
+  Handle MergePairs(Handle first) {
+    if (first == NIL)
+      return NIL;
+
+    scratch_.clear();
+    for (Handle h = first; h != NIL;) {
+      Handle next = nodes_[h].sibling;
+      nodes_[h].sibling = NIL;
+      nodes_[h].prev = NIL;
+      scratch_.push_back(h);
+      h = next;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i + 1 < scratch_.size(); i += 2) {
+      scratch_[n++] = Meld(scratch_[i], scratch_[i + 1]);
+    }
+    if (scratch_.size() % 2 == 1)
+      scratch_[n++] = scratch_.back();
+
+    Handle root = scratch_[n - 1];
+    for (size_t i = n - 1; i > 0; --i) {
+      root = Meld(scratch_[i - 1], root);
+    }
+    return root;
+  }
+};
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,307 @@
+#include "property_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#include "graph_view.h"
+
+namespace minkv {
+namespace graph {
+
+namespace {
+
+std::string_view Trim(std::string_view s) {
+  const char *ws = " \t\r\n";
+  size_t begin = s.find_first_not_of(ws);
+  if (begin == std::string_view::npos)
+    return {};
+  size_t end = s.find_last_not_of(ws);
+  return s.substr(begin, end - begin + 1);
+}
+
+/** value 与 key 同类型时判断 value op key 是否成立 */
+bool Compare(const PropertyKey &value, PropertyOp op, const PropertyKey &key) {
+  switch (op) {
+  case PropertyOp::EQ:
+    return value == key;
+  case PropertyOp::LT:
+    return value < key;
+  case PropertyOp::LE:
+    return !(key < value);
+  case PropertyOp::GT:
+    return key < value;
+  case PropertyOp::GE:
+    return !(value < key);
+  }
+  return false;
+}
+
+/** 同类型中最小的键，作为 LT / LE 范围扫描的起点 */
+PropertyKey KindMin(PropertyKey::Kind kind) {
+  PropertyKey key;
+  key.kind = kind;
+  key.number = -std::numeric_limits<double>::infinity();
+  return key;
+}
+
+} // namespace
+
+// ══════════════════════════════════════════════════════════════════════════════
+// PropertyKey
+// ══════════════════════════════════════════════════════════════════════════════
+
+PropertyKey PropertyKey::Parse(std::string_view raw) {
+  raw = Trim(raw);
+  PropertyKey key;
+  if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+    key.kind = Kind::STRING;
+    key.text = std::string(raw.substr(1, raw.size() - 2));
+    return key;
+  }
+  if (!raw.empty() && (raw[0] == '-' || (raw[0] >= '0' && raw[0] <= '9'))) {
+    std::string buf(raw);
+    char *end = nullptr;
+    double v = std::strtod(buf.c_str(), &end);
+    if (end == buf.c_str() + buf.size() && std::isfinite(v)) {
+      key.kind = Kind::NUMBER;
+      key.number = v == 0.0 ? 0.0 : v; // -0 与 0 视为同一个值
+      return key;
+    }
+  }
+  key.kind = Kind::OTHER;
+  key.text = std::string(raw);
+  return key;
+}
+
+std::string PropertyKey::Canonical() const {
+  if (kind == Kind::NUMBER) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "n%.17g", number);
+    return buf;
+  }
+  return (kind == Kind::STRING ? "s" : "o") + text;
+}
+
+bool PropertyKey::operator<(const PropertyKey &other) const {
+  if (kind != other.kind)
+    return kind < other.kind;
+  if (kind == Kind::NUMBER)
+    return number < other.number;
+  return text < other.text;
+}
+
+bool PropertyKey::operator==(const PropertyKey &other) const {
+  if (kind != other.kind)
+    return false;
+  return kind == Kind::NUMBER ? number == other.number : text == other.text;
+}
+
+bool MatchesPredicates(std::string_view properties_json,
+                       const std::vector<PropertyPredicate> &predicates) {
+  for (const auto &p : predicates) {
+    auto raw = ExtractJsonField(properties_json, p.field);
+    if (!raw)
+      return false;
+    PropertyKey value = PropertyKey::Parse(*raw);
+    PropertyKey key = PropertyKey::Parse(p.value);
+    if (value.kind != key.kind || !Compare(value, p.op, key))
+      return false;
+  }
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 索引维护
+// ══════════════════════════════════════════════════════════════════════════════
+
+void PropertyIndex::FieldIndex::Insert(const std::string &node_id,
+                                       PropertyKey key) {
+  if (type == PropertyIndexType::HASH)
+    hash[key.Canonical()].insert(node_id);
+  else
+    ordered.emplace(key, node_id);
+  value_of[node_id] = std::move(key);
+}
+
+void PropertyIndex::FieldIndex::Erase(const std::string &node_id) {
+  auto it = value_of.find(node_id);
+  if (it == value_of.end())
+    return;
+  if (type == PropertyIndexType::HASH) {
+    auto bucket = hash.find(it->second.Canonical());
+    if (bucket != hash.end()) {
+      bucket->second.erase(node_id);
+      if (bucket->second.empty())
+        hash.erase(bucket);
+    }
+  } else {
+    ordered.erase({it->second, node_id});
+  }
+  value_of.erase(it);
+}
+
+void PropertyIndex::Create(
+    const std::string &field, PropertyIndexType type,
+    const std::function<void(
+        const std::function<void(std::string_view, std::string_view)> &)>
+        &scan) {
+  FieldIndex index;
+  index.type = type;
+
+  // 建索引期间持独占锁，与 Commit 的加锁顺序一致（先索引锁、后 KV 锁）
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  scan([&](std::string_view node_id, std::string_view properties_json) {
+    if (auto value = ExtractJsonField(properties_json, field))
+      index.Insert(std::string(node_id), PropertyKey::Parse(*value));
+  });
+  fields_[field] = std::move(index);
+  enabled_.store(true, std::memory_order_release);
+}
+
+bool PropertyIndex::Drop(const std::string &field) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  bool erased = fields_.erase(field) > 0;
+  enabled_.store(!fields_.empty(), std::memory_order_release);
+  return erased;
+}
+
+std::vector<PropertyIndexInfo> PropertyIndex::List() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::vector<PropertyIndexInfo> result;
+  result.reserve(fields_.size());
+  for (const auto &[field, index] : fields_)
+    result.push_back({field, index.type, index.value_of.size()});
+  std::sort(result.begin(), result.end(),
+            [](const PropertyIndexInfo &a, const PropertyIndexInfo &b) {
+              return a.field < b.field;
+            });
+  return result;
+}
+
+void PropertyIndex::UpdateLocked(const std::string &node_id,
+                                 const std::string *properties_json) {
+  for (auto &[field, index] : fields_) {
+    index.Erase(node_id);
+    if (!properties_json)
+      continue;
+    if (auto value = ExtractJsonField(*properties_json, field))
+      index.Insert(node_id, PropertyKey::Parse(*value));
+  }
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 查询
+// ══════════════════════════════════════════════════════════════════════════════
+
+std::vector<PropertyIndex::BoundPredicate>
+PropertyIndex::Bind(const std::vector<PropertyPredicate> &predicates) const {
+  std::vector<BoundPredicate> bound;
+  bound.reserve(predicates.size());
+  for (const auto &p : predicates) {
+    auto it = fields_.find(p.field);
+    if (it == fields_.end())
+      throw std::invalid_argument("no property index on field: " + p.field);
+    if (p.op != PropertyOp::EQ && it->second.type == PropertyIndexType::HASH)
+      throw std::invalid_argument("range predicate on field '" + p.field +
+                                  "' requires an ORDERED index");
+    bound.push_back({&it->second, p.op, PropertyKey::Parse(p.value)});
+  }
+  return bound;
+}
+
+bool PropertyIndex::Matches(const BoundPredicate &p,
+                            const std::string &node_id) {
+  auto it = p.index->value_of.find(node_id);
+  if (it == p.index->value_of.end() || it->second.kind != p.key.kind)
+    return false;
+  return Compare(it->second, p.op, p.key);
+}
+
+std::vector<std::string> PropertyIndex::FindLocked(
+    const std::vector<PropertyPredicate> &predicates) const {
+  if (predicates.empty())
+    throw std::invalid_argument("at least one property predicate is required");
+  auto bound = Bind(predicates);
+
+  // 等值谓词通常选择性最好，优先用它驱动索引查找
+  auto driver_it =
+      std::find_if(bound.begin(), bound.end(), [](const BoundPredicate &p) {
+        return p.op == PropertyOp::EQ;
+      });
+  if (driver_it == bound.end())
+    driver_it = bound.begin();
+  const BoundPredicate driver = *driver_it;
+  bound.erase(driver_it);
+
+  std::vector<std::string> candidates;
+  const FieldIndex &index = *driver.index;
+  if (index.type == PropertyIndexType::HASH) {
+    auto bucket = index.hash.find(driver.key.Canonical());
+    if (bucket != index.hash.end())
+      candidates.assign(bucket->second.begin(), bucket->second.end());
+  } else {
+    // 只扫描与谓词值同类型的区间：LT / LE 从该类型最小值开始，
+    // 其余从谓词值开始；GT 跳过开头等于谓词值的条目
+    const bool below =
+        driver.op == PropertyOp::LT || driver.op == PropertyOp::LE;
+    auto it = index.ordered.lower_bound(
+        {below ? KindMin(driver.key.kind) : driver.key, std::string()});
+    for (; it != index.ordered.end() && it->first.kind == driver.key.kind;
+         ++it) {
+      if (Compare(it->first, driver.op, driver.key))
+        candidates.push_back(it->second);
+      else if (driver.op != PropertyOp::GT)
+        break;
+    }
+  }
+
+  std::vector<std::string> result;
+  result.reserve(candidates.size());
+  for (auto &id : candidates) {
+    bool ok = std::all_of(bound.begin(), bound.end(),
+                          [&id](const BoundPredicate &p) {
+                            return Matches(p, id);
+                          });
+    if (ok)
+      result.push_back(std::move(id));
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+bool PropertyIndex::CanServe(
+    const std::vector<PropertyPredicate> &predicates) const {
+  if (!Enabled())
+    return false;
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return std::all_of(
+      predicates.begin(), predicates.end(), [this](const PropertyPredicate &p) {
+        auto it = fields_.find(p.field);
+        return it != fields_.end() &&
+               (p.op == PropertyOp::EQ ||
+                it->second.type == PropertyIndexType::ORDERED);
+      });
+}
+
+void PropertyIndex::RetainMatching(
+    std::vector<AdjEntry> &entries,
+    const std::vector<PropertyPredicate> &predicates) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto bound = Bind(predicates);
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [&bound](const AdjEntry &e) {
+                                 for (const auto &p : bound) {
+                                   if (!Matches(p, e.neighbor_id))
+                                     return true;
+                                 }
+                                 return false;
+                               }),
+                entries.end());
+}
+
+} // namespace graph
+} // namespace minkv
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "graph_types.h"
+
+namespace minkv {
+namespace graph {
+
+/** 二级索引类型 */
+enum class PropertyIndexType {
+  HASH,   // 哈希索引：只支持等值查询
+  ORDERED // 有序索引：支持等值和范围查询
+};
+
+/** 属性谓词的比较运算 */
+enum class PropertyOp { EQ, LT, LE, GT, GE };
+
+/**
+ * 属性谓词：properties_json 顶层字段 field 与 value 比较
+ *
+ * value 是 JSON 字面量：字符串带引号（"\"Person\""），数字不带（"30"）。
+ * 只有同类型的值才可能满足谓词——"30" 与 "\"30\"" 互不相等，
+ * age > 30 也不会命中字符串类型的 age。缺少该字段的节点不满足任何谓词。
+ */
+struct PropertyPredicate {
+  std::string field;
+  PropertyOp op = PropertyOp::EQ;
+  std::string value;
+
+  static PropertyPredicate Eq(std::string field, std::string value) {
+    return {std::move(field), PropertyOp::EQ, std::move(value)};
+  }
+};
+
+/**
+ * 索引键：解析后的属性值
+ *
+ * 排序规则：先按类型（数字 < 字符串 < 其他），同类型内数字按数值、
+ * 字符串按原始文本（不解码转义）、其他（true/false/null/对象/数组）
+ * 按去掉首尾空白的原始文本比较。
+ */
+struct PropertyKey {
+  enum class Kind : uint8_t { NUMBER, STRING, OTHER };
+
+  Kind kind = Kind::OTHER;
+  double number = 0.0;
+  std::string text; // STRING 为引号内的文本，OTHER 为原始文本
+
+  /** 从 JSON 值的原始文本解析 */
+  static PropertyKey Parse(std::string_view raw);
+
+  /** 哈希索引使用的规范化形式，数值相等的 30 与 30.0 结果相同 */
+  std::string Canonical() const;
+
+  bool operator<(const PropertyKey &other) const;
+  bool operator==(const PropertyKey &other) const;
+};
+
+/**
+ * 直接在 properties_json 上判定全部谓词（没有索引时的回退路径）
+ * 语义与索引查询一致：缺少字段或类型不同的值不满足谓词
+ */
+bool MatchesPredicates(std::string_view properties_json,
+                       const std::vector<PropertyPredicate> &predicates);
+
+/** 单个二级索引的概况 */
+struct PropertyIndexInfo {
+  std::string field;
+  PropertyIndexType type = PropertyIndexType::HASH;
+  size_t entries = 0; // 含该字段的已索引节点数
+};
+
+/**
+ * PropertyIndex — 节点属性二级索引集合
+ *
+ * 每个被索引的字段维护一份 node_id → 值 的反向表（更新时定位旧值、
+ * 遍历时逐节点判定谓词），以及哈希表（值 → 节点集合）或有序集合
+ * （(值, node_id) 有序）之一。
+ *
+ * 写入与 KV 保持一致：Commit 在独占锁内执行 KV 写入，写入成功后再
+ * 更新索引；查询持共享锁，看到的索引与节点数据总是同一个版本。
+ * 没有任何索引时 Commit 直接执行写入，不加锁。
+ *
+ * Create / Drop 与写操作之间不做同步，应在没有并发写入时调用。
+ */
+class PropertyIndex {
+public:
+  /**
+   * 为 field 建立索引（已存在时按新类型重建）
+   * @param scan 对每个现有节点调用 add(node_id, properties_json)
+   */
+  void Create(const std::string &field, PropertyIndexType type,
+              const std::function<void(
+                  const std::function<void(std::string_view,
+                                           std::string_view)> &add)> &scan);
+
+  /** 删除 field 上的索引；不存在时返回 false */
+  bool Drop(const std::string &field);
+
+  std::vector<PropertyIndexInfo> List() const;
+
+  /** 是否建立了任何索引 */
+  bool Enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+  /**
+   * 在独占锁内执行 kv_write，成功后把 node_id 的索引项更新为
+   * properties_json（nullptr 表示节点被删除）；kv_write 抛异常时索引不变
+   */
+  template <typename Write>
+  void Commit(const std::string &node_id, const std::string *properties_json,
+              Write &&kv_write) {
+    if (!Enabled()) {
+      kv_write();
+      return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    kv_write();
+    UpdateLocked(node_id, properties_json);
+  }
+
+  /** 同 Commit，一次加锁内写入 nodes 并更新它们的索引项（批量写入用） */
+  template <typename Write>
+  void CommitNodes(const std::vector<Node> &nodes, Write &&kv_write) {
+    if (!Enabled()) {
+      kv_write();
+      return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    kv_write();
+    for (const auto &node : nodes)
+      UpdateLocked(node.node_id, &node.properties_json);
+  }
+
+  /** 共享锁：持有期间索引和节点数据不会被 Commit 修改 */
+  std::shared_lock<std::shared_mutex> ReadLock() const {
+    return std::shared_lock<std::shared_mutex>(mutex_);
+  }
+
+  /**
+   * 满足全部谓词的节点 ID，按 ID 升序；调用方持 ReadLock
+   *
+   * 先用一个谓词（优先等值谓词）走索引得到候选，其余谓词在反向表上逐个核对。
+   * @throws std::invalid_argument 谓词为空、字段没有索引，
+   *         或在哈希索引上使用范围运算
+   */
+  std::vector<std::string>
+  FindLocked(const std::vector<PropertyPredicate> &predicates) const;
+
+  /** 全部谓词都能由现有索引判定（字段有索引，范围运算落在有序索引上） */
+  bool CanServe(const std::vector<PropertyPredicate> &predicates) const;
+
+  /**
+   * 从邻接表条目中删去邻居不满足全部谓词的条目
+   * @throws std::invalid_argument 同 FindLocked
+   */
+  void RetainMatching(std::vector<AdjEntry> &entries,
+                      const std::vector<PropertyPredicate> &predicates) const;
+
+private:
+  struct FieldIndex {
+    PropertyIndexType type = PropertyIndexType::HASH;
+    std::unordered_map<std::string, PropertyKey> value_of; // node_id → 值
+    // HASH：规范化值 → 节点集合
+    std::unordered_map<std::string, std::unordered_set<std::string>> hash;
+    // ORDERED：(值, node_id)
+    std::set<std::pair<PropertyKey, std::string>> ordered;
+
+    void Insert(const std::string &node_id, PropertyKey key);
+    void Erase(const std::string &node_id);
+  };
+
+  /** 预先解析过的谓词 */
+  struct BoundPredicate {
+    const FieldIndex *index = nullptr;
+    PropertyOp op = PropertyOp::EQ;
+    PropertyKey key;
+  };
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, FieldIndex> fields_;
+  std::atomic<bool> enabled_{false};
+
+  void UpdateLocked(const std::string &node_id,
+                    const std::string *properties_json);
+
+  std::vector<BoundPredicate>
+  Bind(const std::vector<PropertyPredicate> &predicates) const;
+
+  static bool Matches(const BoundPredicate &p, const std::string &node_id);
+};
+
+} // namespace graph
+} // namespace minkv
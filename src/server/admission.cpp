@@ -0,0 +1,101 @@
+#include "admission.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace minkv {
+namespace server {
+
+namespace {
+
+constexpr double kDecreaseFactor = 0.9;
+constexpr double kEwmaAlpha = 0.1; // 滑动平均中新样本的权重
+
+void Ewma(double &avg, double sample) {
+  avg = avg == 0 ? sample : avg + kEwmaAlpha * (sample - avg);
+}
+
+} // namespace
+
+AdmissionLimiter::AdmissionLimiter(const AdmissionLimits &limits)
+    : limits_(limits), limit_(static_cast<double>(limits.initial_limit)) {
+  if (limits.min_limit == 0 || limits.min_limit > limits.initial_limit ||
+      limits.initial_limit > limits.max_limit)
+    throw std::invalid_argument(
+        "AdmissionLimiter: need 0 < min_limit <= initial_limit <= max_limit");
+  if (limits.queue_timeout_ms < 0 || limits.target_latency_ms < 0)
+    throw std::invalid_argument(
+        "AdmissionLimiter: negative queue_timeout_ms or target_latency_ms");
+}
+
+AdmissionLimiter::Result AdmissionLimiter::Acquire() {
+  std::unique_lock<std::mutex> lock(mu_);
+  // 已有请求在排队时不插队，名额留给先来的
+  if (queued_ == 0 && in_flight_ < current_limit()) {
+    ++in_flight_;
+    ++stats_.admitted;
+    return Result::Admitted;
+  }
+  if (queued_ >= limits_.max_queue) {
+    ++stats_.rejected_queue_full;
+    return Result::QueueFull;
+  }
+
+  ++queued_;
+  auto start = std::chrono::steady_clock::now();
+  bool ok = cv_.wait_until(
+      lock, start + std::chrono::milliseconds(limits_.queue_timeout_ms),
+      [this] { return in_flight_ < current_limit(); });
+  --queued_;
+  if (!ok) {
+    ++stats_.rejected_timeout;
+    return Result::Timeout;
+  }
+  ++in_flight_;
+  ++stats_.admitted;
+  if (queued_ > 0 && in_flight_ < current_limit())
+    cv_.notify_one(); // 上限刚增大时空出的名额不止一个，接力唤醒下一个
+  Ewma(stats_.avg_queue_ms,
+       std::chrono::duration<double, std::milli>(
+           std::chrono::steady_clock::now() - start)
+           .count());
+  return Result::Admitted;
+}
+
+void AdmissionLimiter::Release(double latency_ms) {
+  std::lock_guard<std::mutex> lock(mu_);
+  bool saturated = in_flight_ >= current_limit() || queued_ > 0;
+  --in_flight_;
+  Ewma(stats_.avg_latency_ms, latency_ms);
+
+  if (limits_.target_latency_ms > 0) {
+    ++since_decrease_;
+    double lo = static_cast<double>(limits_.min_limit);
+    double hi = static_cast<double>(limits_.max_limit);
+    if (latency_ms > limits_.target_latency_ms) {
+      if (since_decrease_ >= current_limit() && limit_ > lo) {
+        limit_ = std::max(lo, std::floor(limit_ * kDecreaseFactor));
+        since_decrease_ = 0;
+        ++stats_.limit_decreases;
+      }
+    } else if (saturated) {
+      limit_ = std::min(hi, limit_ + 1.0 / limit_);
+    }
+  }
+
+  if (queued_ > 0 && in_flight_ < current_limit())
+    cv_.notify_one();
+}
+
+AdmissionStats AdmissionLimiter::Stats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  AdmissionStats s = stats_;
+  s.limit = current_limit();
+  s.in_flight = in_flight_;
+  s.queued = queued_;
+  return s;
+}
+
+} // namespace server
+} // namespace minkv
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace minkv {
+namespace server {
+
+/** 一个端点的准入限制（AdmissionLimiter 配置） */
+struct AdmissionLimits {
+  size_t initial_limit = 64;  // 初始并发上限
+  size_t min_limit = 1;       // 自适应调整的下界
+  size_t max_limit = 256;     // 自适应调整的上界
+  size_t max_queue = 128;     // 等待名额的请求数上限，超过立即拒绝
+  int queue_timeout_ms = 100; // 排队超过这么久仍未轮到也拒绝
+  // 处理耗时目标：超过时乘性减小并发上限，上限被用满且未超时加性增大；
+  // 0 表示不自适应，并发上限固定为 initial_limit
+  double target_latency_ms = 0;
+};
+
+/** AdmissionLimiter 运行统计 */
+struct AdmissionStats {
+  size_t limit = 0;                 // 当前并发上限
+  size_t in_flight = 0;             // 正在处理的请求数
+  size_t queued = 0;                // 正在排队的请求数
+  uint64_t admitted = 0;            // 放行的请求数
+  uint64_t rejected_queue_full = 0; // 队列已满被拒绝
+  uint64_t rejected_timeout = 0;    // 排队超时被拒绝
+  uint64_t limit_decreases = 0;     // 因超时而减小上限的次数
+  double avg_latency_ms = 0;        // 处理耗时（指数滑动平均）
+  double avg_queue_ms = 0;          // 排队等待时间（指数滑动平均）
+};
+
+/**
+ * AdmissionLimiter — 并发上限 + 有界等待队列 + AIMD 自适应
+ *
+ * Acquire 在正在处理的请求数低于上限时立即放行，否则进入等待队列；
+ * 队列已满或等待超过 queue_timeout_ms 时返回拒绝，调用方据此快速
+ * 返回 503，而不是让请求在线程池里无限堆积、全部超时。
+ *
+ * [自适应] target_latency_ms > 0 时按每个请求的处理耗时调整上限：
+ * - 耗时超过目标：上限 ×0.9。每个窗口（上次减小之后又完成上限个请求）
+ *   至多减一次，一波慢请求不会把上限连续打到底
+ * - 耗时未超过目标且上限已用满：每完成一个请求上限 +1/上限，
+ *   即每个窗口 +1
+ * 上限始终在 [min_limit, max_limit] 内。
+ *
+ * 线程安全：所有接口都可以被多个线程同时调用。
+ *
+ * 用法：
+ *   AdmissionLimiter limiter(limits);
+ *   AdmissionLimiter::Permit permit(limiter);
+ *   if (!permit) return reject(permit.result());
+ *   handle(); // permit 析构时归还名额并记录耗时
+ */
+class AdmissionLimiter {
+public:
+  enum class Result { Admitted, QueueFull, Timeout };
+
+  /** @throws std::invalid_argument 配置不合法 */
+  explicit AdmissionLimiter(const AdmissionLimits &limits);
+
+  AdmissionLimiter(const AdmissionLimiter &) = delete;
+  AdmissionLimiter &operator=(const AdmissionLimiter &) = delete;
+
+  /** 申请一个名额，必要时排队等待 */
+  Result Acquire();
+
+  /** 归还名额；latency_ms 为这次处理的耗时 */
+  void Release(double latency_ms);
+
+  AdmissionStats Stats() const;
+
+  const AdmissionLimits &limits() const { return limits_; }
+
+  /** RAII 名额：构造时 Acquire，析构时按经过的时间 Release */
+  class Permit {
+  public:
+    explicit Permit(AdmissionLimiter &limiter)
+        : limiter_(limiter), result_(limiter.Acquire()),
+          start_(std::chrono::steady_clock::now()) {}
+    ~Permit() {
+      if (result_ != Result::Admitted)
+        return;
+      limiter_.Release(std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start_)
+                           .count());
+    }
+
+    Permit(const Permit &) = delete;
+    Permit &operator=(const Permit &) = delete;
+
+    explicit operator bool() const { return result_ == Result::Admitted; }
+    Result result() const { return result_; }
+
+  private:
+    AdmissionLimiter &limiter_;
+    Result result_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+private:
+  size_t current_limit() const { return static_cast<size_t>(limit_); }
+
+  const AdmissionLimits limits_;
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  double limit_;              // 小数部分是加性增长攒下的量
+  size_t in_flight_ = 0;
+  size_t queued_ = 0;
+  size_t since_decrease_ = 0; // 上次减小上限之后完成的请求数
+  AdmissionStats stats_;      // 计数和滑动平均，limit 等字段在 Stats() 中填
+};
+
+} // namespace server
+} // namespace minkv
@@ -8,18 +8,53 @@
  *   POST /graph/add_node
  * {"node_id":"...","properties_json":"...","embedding":[...]} POST
  * /graph/add_edge    {"src_id":"...","dst_id":"...","label":"...","weight":1.0}
+ *   （可选 "valid_from" / "valid_to" 整数有效期 [from, to)）
+ *   POST /graph/add_nodes {"nodes":[{...}, ...]}  每项同 add_node
+ *   POST /graph/add_edges {"edges":[{...}, ...]}  每项同 add_edge
+ *   （批量写入，results 与请求数组一一对应，单项出错只让该项失败）
  *   POST /graph/rag_query
- * {"query_embedding":[...],"vector_top_k":3,"hop_depth":2} GET  /health
+ * {"query_embedding":[...],"vector_top_k":3,"hop_depth":2}
+ *   （"ranked":true 时按个性化 PageRank 排序，附加 top_n /
+ *    residual_tolerance（> 0）/ time_budget_ms，返回带 score 的节点；
+ *    "labels":[...] / "direction":"out|in|both" 限定扩展的边，
+ *    "as_of":t 只经过在时刻 t 有效的边；
+ *    带 max_fanout / max_results / deadline_ms 时按预算有界扩展，
+ *    "sampling":"top_weight|reservoir"，响应附带 truncation 统计；
+ *    "fields":[...] 只返回这些顶层属性字段，"ids_only":true 不返回属性；
+ *    带 "query_text" 时向量 + 关键词 BM25 混合检索，RRF 融合入口节点，
+ *    附加 candidate_k（> 0）/ rrf_k（>= 0）；
+ *    "where":[{"field":"type","op":"eq","value":"Person"}] 只经过满足
+ *    谓词的节点，谓词字段需先建立索引；
+ *    "timeout_ms":n 或请求头 X-Timeout-Ms 设截止时间，超时返回 504，
+ *    "allow_partial":true 时返回已收集的节点并带 "partial":true）
+ *   POST /graph/shortest_path
+ * {"src_id":"...","dst_id":"...","algorithm":"dijkstra|astar",
+ *  "heuristic_scale":1.0}
+ *   GET  /graph/cache_stats   GraphRAG 查询缓存命中率
+ *   GET  /graph/degree_stats  度数直方图（?node_id=... 附带该节点的度数）
+ *   POST /graph/property_index {"field":"age","type":"hash|ordered"}
+ *   POST /graph/find_nodes     {"where":[{"field":"age","op":"gt","value":30}]}
+ *   POST /graph/traverse
+ * {"start":["alice"],"steps":[{"expand":"out","labels":["KNOWS"]},
+ *  {"where":[...]},{"limit":10}],"fields":[...],"as_of":t}
+ *   POST /graph/snapshot       把图写成快照文件（启动时指定了快照路径）
+ *   POST /graph/edge_expiration {"retention_ms":0,"check_interval_ms":100}
+ *                              启动后台下线过期边（有效期单位为 Unix 毫秒）
+ *   GET  /graph/edge_expiration 待下线 / 已下线的边数
+ *   GET  /health
  *
  * 编译：
  *   cmake --build MinKV/build --target graph_http_server
  *
  * 运行：
- *   ./MinKV/build/bin/graph_http_server [port]   默认 8081
+ *   ./MinKV/build/bin/graph_http_server [port] [snapshot_path]   默认 8081
+ *   指定 snapshot_path 时启动时从该文件加载图（文件存在时），
+ *   POST /graph/snapshot 写回同一个文件
  */
 
 #include <signal.h>
 
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <nlohmann/json.hpp>
@@ -27,12 +62,16 @@
 #include "../core/sharded_cache.h"
 #include "../graph/graph_store.h"
 #include "httplib.h"
+#include "request_deadline.h"
 
 using namespace minkv::graph;
+using minkv::server::parse_request_deadline;
+using minkv::server::RequestDeadline;
 using GraphKVStore = minkv::db::ShardedCache<std::string, std::string>;
 using json = nlohmann::json;
 
 static std::shared_ptr<GraphStore> g_gs;
+static std::string g_snapshot_path; // 为空时不启用图快照
 
 // ── 辅助函数
 // ──────────────────────────────────────────────────────────────────
@@ -48,6 +87,124 @@ static void send_err(httplib::Response &res, int code, const std::string &msg) {
                   "application/json");
 }
 
+// 解析 "where":[{"field":"age","op":"gt","value":30}, ...]；
+// value 转成 JSON 字面量（字符串带引号），格式非法时抛 std::invalid_argument
+static std::vector<PropertyPredicate> parse_predicates(const json &where) {
+  if (!where.is_array())
+    throw std::invalid_argument("where must be an array of predicates");
+  std::vector<PropertyPredicate> predicates;
+  for (const auto &item : where) {
+    if (!item.is_object() || !item.contains("field") ||
+        !item.contains("value"))
+      throw std::invalid_argument("predicate needs field and value");
+    PropertyPredicate p;
+    p.field = item["field"].get<std::string>();
+    p.value = item["value"].dump();
+    std::string op = item.value("op", "eq");
+    if (op == "eq")
+      p.op = PropertyOp::EQ;
+    else if (op == "lt")
+      p.op = PropertyOp::LT;
+    else if (op == "le")
+      p.op = PropertyOp::LE;
+    else if (op == "gt")
+      p.op = PropertyOp::GT;
+    else if (op == "ge")
+      p.op = PropertyOp::GE;
+    else
+      throw std::invalid_argument("op must be eq / lt / le / gt / ge");
+    predicates.push_back(std::move(p));
+  }
+  return predicates;
+}
+
+// 解析 "labels" / "direction" / "where" / "as_of"；
+// 非法时抛 std::invalid_argument
+static TraversalFilter parse_filter(const json &body) {
+  TraversalFilter filter;
+  if (body.contains("labels"))
+    filter.labels = body["labels"].get<std::vector<std::string>>();
+  std::string direction = body.value("direction", "out");
+  if (direction == "out")
+    filter.direction = Direction::OUT;
+  else if (direction == "in")
+    filter.direction = Direction::IN;
+  else if (direction == "both")
+    filter.direction = Direction::BOTH;
+  else
+    throw std::invalid_argument("direction must be out / in / both");
+  if (body.contains("where"))
+    filter.node_predicates = parse_predicates(body["where"]);
+  if (body.contains("as_of"))
+    filter.as_of = body["as_of"].get<int64_t>();
+  return filter;
+}
+
+// 解析有界扩展参数；未提供任何预算字段时返回 false
+static bool parse_budget(const json &body, GraphRAGBudget &budget) {
+  if (!body.contains("max_fanout") && !body.contains("max_results") &&
+      !body.contains("deadline_ms"))
+    return false;
+  budget.max_fanout = body.value("max_fanout", 0);
+  budget.max_results = body.value("max_results", 0);
+  budget.deadline = std::chrono::milliseconds(body.value("deadline_ms", 0));
+  budget.seed = body.value("seed", 0);
+  std::string sampling = body.value("sampling", "top_weight");
+  if (sampling == "top_weight")
+    budget.sampling = FanoutSampling::TOP_WEIGHT;
+  else if (sampling == "reservoir")
+    budget.sampling = FanoutSampling::RESERVOIR;
+  else
+    throw std::invalid_argument("sampling must be top_weight / reservoir");
+  return true;
+}
+
+// 解析 "ids_only" / "fields"；都未提供时返回完整属性
+static Projection parse_projection(const json &body) {
+  if (body.value("ids_only", false))
+    return Projection::IdsOnly();
+  if (body.contains("fields"))
+    return Projection::Fields(body["fields"].get<std::vector<std::string>>());
+  return {};
+}
+
+// 解析遍历管道："start" 或 "start_where"，"steps" 中每一项是
+// {"expand":"out|in|both","labels":[...]}、{"where":[...]} 或 {"limit":n}
+static TraversalPipeline parse_pipeline(const json &body) {
+  TraversalPipeline pipeline;
+  if (body.contains("start"))
+    pipeline.start = body["start"].get<std::vector<std::string>>();
+  if (body.contains("start_where"))
+    pipeline.start_where = parse_predicates(body["start_where"]);
+  if (body.contains("steps")) {
+    if (!body["steps"].is_array())
+      throw std::invalid_argument("steps must be an array");
+    for (const auto &step : body["steps"]) {
+      if (!step.is_object())
+        throw std::invalid_argument("each step must be an object");
+      if (step.contains("expand")) {
+        json filter = {{"direction", step["expand"]}};
+        if (step.contains("labels"))
+          filter["labels"] = step["labels"];
+        TraversalStep expand;
+        expand.filter = parse_filter(filter);
+        pipeline.steps.push_back(std::move(expand));
+      } else if (step.contains("where")) {
+        pipeline.Where(parse_predicates(step["where"]));
+      } else if (step.contains("limit")) {
+        pipeline.Limit(step["limit"].get<size_t>());
+      } else {
+        throw std::invalid_argument("step must be expand / where / limit");
+      }
+    }
+  }
+  if (body.contains("as_of"))
+    pipeline.as_of = body["as_of"].get<int64_t>();
+  pipeline.projection = parse_projection(body);
+  pipeline.batch_size = body.value("batch_size", pipeline.batch_size);
+  return pipeline;
+}
+
 // ── 路由处理
 // ──────────────────────────────────────────────────────────────────
 
@@ -92,12 +249,130 @@ static void handle_add_edge(const httplib::Request &req,
     e.label = body["label"];
     e.weight = body.value("weight", 1.0f);
     e.properties_json = body.value("properties_json", "{}");
+    e.valid_from = body.value("valid_from", VALID_FROM_ALWAYS);
+    e.valid_to = body.value("valid_to", VALID_TO_FOREVER);
     g_gs->AddEdge(e);
 
     send_ok(res, {{"success", true},
                   {"src_id", e.src_id},
                   {"dst_id", e.dst_id},
                   {"label", e.label}});
+  } catch (const std::invalid_argument &e) {
+    send_err(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+// 批量请求最多携带的操作数
+static constexpr size_t kMaxBatchSize = 10000;
+
+static const json &batch_array(const json &body, const char *field) {
+  auto it = body.find(field);
+  if (it == body.end() || !it->is_array())
+    throw std::invalid_argument(std::string("missing array field ") + field);
+  if (it->size() > kMaxBatchSize)
+    throw std::invalid_argument(std::string(field) + " exceeds batch limit " +
+                                std::to_string(kMaxBatchSize));
+  return *it;
+}
+
+static json batch_ok(size_t index, const json &extra) {
+  json item = {{"index", index}, {"success", true}};
+  item.update(extra);
+  return item;
+}
+
+static json batch_err(size_t index, const std::string &msg) {
+  return {{"index", index}, {"success", false}, {"error", msg}};
+}
+
+static void handle_add_nodes(const httplib::Request &req,
+                             httplib::Response &res) {
+  try {
+    auto body = json::parse(req.body);
+    const json &items = batch_array(body, "nodes");
+
+    std::vector<Node> nodes;
+    std::vector<std::pair<std::string, std::vector<float>>> embeddings;
+    json results = json::array();
+    size_t failed = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      try {
+        Node n;
+        n.node_id = items[i].at("node_id");
+        n.properties_json = items[i].value("properties_json", "{}");
+        if (items[i].contains("embedding"))
+          embeddings.emplace_back(
+              n.node_id, items[i]["embedding"].get<std::vector<float>>());
+        results.push_back(batch_ok(i, {{"node_id", n.node_id}}));
+        nodes.push_back(std::move(n));
+      } catch (const json::exception &e) {
+        results.push_back(batch_err(i, e.what()));
+        ++failed;
+      }
+    }
+    g_gs->AddNodes(nodes);
+    for (const auto &[node_id, emb] : embeddings)
+      g_gs->SetNodeEmbedding(node_id, emb);
+
+    send_ok(res, {{"success", true},
+                  {"count", items.size()},
+                  {"failed", failed},
+                  {"results", std::move(results)}});
+  } catch (const json::exception &e) {
+    send_err(res, 400, e.what());
+  } catch (const std::invalid_argument &e) {
+    send_err(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+static void handle_add_edges(const httplib::Request &req,
+                             httplib::Response &res) {
+  try {
+    auto body = json::parse(req.body);
+    const json &items = batch_array(body, "edges");
+
+    std::vector<Edge> edges;
+    json results = json::array();
+    size_t failed = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      try {
+        const json &item = items[i];
+        Edge e;
+        e.src_id = item.at("src_id");
+        e.dst_id = item.at("dst_id");
+        e.label = item.at("label");
+        e.weight = item.value("weight", 1.0f);
+        e.properties_json = item.value("properties_json", "{}");
+        e.valid_from = item.value("valid_from", VALID_FROM_ALWAYS);
+        e.valid_to = item.value("valid_to", VALID_TO_FOREVER);
+        if (e.valid_from >= e.valid_to) {
+          results.push_back(batch_err(i, "edge valid_from must be < valid_to"));
+          ++failed;
+          continue;
+        }
+        results.push_back(batch_ok(i, {{"src_id", e.src_id},
+                                       {"dst_id", e.dst_id},
+                                       {"label", e.label}}));
+        edges.push_back(std::move(e));
+      } catch (const json::exception &e) {
+        results.push_back(batch_err(i, e.what()));
+        ++failed;
+      }
+    }
+    g_gs->AddEdges(edges);
+
+    send_ok(res, {{"success", true},
+                  {"count", items.size()},
+                  {"failed", failed},
+                  {"results", std::move(results)}});
+  } catch (const json::exception &e) {
+    send_err(res, 400, e.what());
+  } catch (const std::invalid_argument &e) {
+    send_err(res, 400, e.what());
   } catch (const std::exception &e) {
     send_err(res, 500, e.what());
   }
@@ -109,6 +384,130 @@ static void handle_rag_query(const httplib::Request &req,
     auto body = json::parse(req.body);
     int vector_top_k = body.value("vector_top_k", 3);
     int hop_depth = body.value("hop_depth", 2);
+    TraversalFilter filter = parse_filter(body);
+    Projection projection = parse_projection(body);
+    // 截止时间：X-Timeout-Ms 或 "timeout_ms"，超时默认 504，
+    // allow_partial 时返回已收集的节点并带 "partial": true
+    RequestDeadline deadline = parse_request_deadline(req, &body);
+    auto timed_out = [&] {
+      if (!deadline.expired() || deadline.allow_partial)
+        return false;
+      send_err(res, 504, "request deadline exceeded");
+      return true;
+    };
+    auto reply = [&](json out) {
+      if (deadline.expired())
+        out["partial"] = true;
+      send_ok(res, out);
+    };
+    if (timed_out())
+      return;
+
+    // 排序模式：个性化 PageRank，返回带得分的 top_n 节点
+    if (body.value("ranked", false)) {
+      if (!body.contains("query_embedding")) {
+        send_err(res, 400, "ranked mode requires query_embedding");
+        return;
+      }
+      GraphRAGOptions opts;
+      opts.vector_top_k = vector_top_k;
+      opts.hop_depth = hop_depth;
+      opts.top_n = body.value("top_n", opts.top_n);
+      opts.residual_tolerance =
+          body.value("residual_tolerance", opts.residual_tolerance);
+      opts.time_budget = deadline.clamp(
+          std::chrono::milliseconds(body.value("time_budget_ms", 0)));
+      opts.filter = filter;
+      opts.projection = projection;
+      auto ranked = g_gs->GraphRAGQueryRanked(
+          body["query_embedding"].get<std::vector<float>>(), opts);
+      if (timed_out())
+        return;
+
+      json nodes_json = json::array();
+      for (const auto &sn : ranked.nodes) {
+        nodes_json.push_back({{"node_id", sn.node.node_id},
+                              {"properties_json", sn.node.properties_json},
+                              {"score", sn.score}});
+      }
+      reply({{"success", true},
+             {"node_count", (int)ranked.nodes.size()},
+             {"vector_top_k", vector_top_k},
+             {"hop_depth", hop_depth},
+             {"pushes", ranked.pushes},
+             {"converged", ranked.converged},
+             {"nodes", nodes_json}});
+      return;
+    }
+
+    // 有界模式：扇出采样 + 结果上限 + 截止时间，附带截断统计
+    GraphRAGBudget budget;
+    if (parse_budget(body, budget)) {
+      if (!body.contains("query_embedding")) {
+        send_err(res, 400, "bounded mode requires query_embedding");
+        return;
+      }
+      budget.deadline = deadline.clamp(budget.deadline);
+      auto bounded = g_gs->GraphRAGQueryBounded(
+          body["query_embedding"].get<std::vector<float>>(), vector_top_k,
+          hop_depth, budget, filter, projection);
+      if (timed_out())
+        return;
+
+      json nodes_json = json::array();
+      for (const auto &n : bounded.nodes) {
+        nodes_json.push_back(
+            {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
+      }
+      reply({{"success", true},
+             {"node_count", (int)bounded.nodes.size()},
+             {"vector_top_k", vector_top_k},
+             {"hop_depth", hop_depth},
+             {"truncation",
+              {{"hops_completed", bounded.hops_completed},
+               {"fanout_sampled_nodes", bounded.fanout_sampled_nodes},
+               {"fanout_dropped_edges", bounded.fanout_dropped_edges},
+               {"result_truncated", bounded.result_truncated},
+               {"deadline_exceeded", bounded.deadline_exceeded}}},
+             {"nodes", nodes_json}});
+      return;
+    }
+
+    // 混合模式：向量 + 关键词检索，RRF 融合入口节点
+    if (body.contains("query_text")) {
+      HybridSearchOptions opts;
+      opts.entry_top_k = vector_top_k;
+      opts.candidate_k = body.value("candidate_k", opts.candidate_k);
+      opts.rrf_k = body.value("rrf_k", opts.rrf_k);
+      std::vector<float> embedding;
+      if (body.contains("query_embedding"))
+        embedding = body["query_embedding"].get<std::vector<float>>();
+      auto hybrid = g_gs->GraphRAGQueryHybrid(
+          embedding, body["query_text"].get<std::string>(), hop_depth, opts,
+          filter, projection, deadline.token);
+      if (timed_out())
+        return;
+
+      json entries_json = json::array();
+      for (const auto &e : hybrid.entries) {
+        entries_json.push_back({{"node_id", e.node_id},
+                                {"score", e.score},
+                                {"vector_rank", e.vector_rank},
+                                {"keyword_rank", e.keyword_rank}});
+      }
+      json nodes_json = json::array();
+      for (const auto &n : hybrid.nodes) {
+        nodes_json.push_back(
+            {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
+      }
+      reply({{"success", true},
+             {"node_count", (int)hybrid.nodes.size()},
+             {"vector_top_k", vector_top_k},
+             {"hop_depth", hop_depth},
+             {"entries", entries_json},
+             {"nodes", nodes_json}});
+      return;
+    }
 
     std::vector<Node> nodes;
 
@@ -117,16 +516,20 @@ static void handle_rag_query(const httplib::Request &req,
       // 批量模式
       auto query_embs =
           body["query_embeddings"].get<std::vector<std::vector<float>>>();
-      nodes = g_gs->GraphRAGQuery(query_embs, vector_top_k, hop_depth);
+      nodes = g_gs->GraphRAGQuery(query_embs, vector_top_k, hop_depth, filter,
+                                  projection, deadline.token);
     } else if (body.contains("query_embedding")) {
       // 单向量模式 (兼容旧版)
       std::vector<float> query_emb =
           body["query_embedding"].get<std::vector<float>>();
-      nodes = g_gs->GraphRAGQuery(query_emb, vector_top_k, hop_depth);
+      nodes = g_gs->GraphRAGQuery(query_emb, vector_top_k, hop_depth, filter,
+                                  projection, deadline.token);
     } else {
       send_err(res, 400, "missing query_embedding or query_embeddings");
       return;
     }
+    if (timed_out())
+      return;
 
     json nodes_json = json::array();
     for (const auto &n : nodes) {
@@ -134,11 +537,211 @@ static void handle_rag_query(const httplib::Request &req,
           {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
     }
 
+    reply({{"success", true},
+           {"node_count", (int)nodes.size()},
+           {"vector_top_k", vector_top_k},
+           {"hop_depth", hop_depth},
+           {"nodes", nodes_json}});
+  } catch (const std::invalid_argument &e) {
+    send_err(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+static void handle_shortest_path(const httplib::Request &req,
+                                 httplib::Response &res) {
+  try {
+    auto body = json::parse(req.body);
+    if (!body.contains("src_id") || !body.contains("dst_id")) {
+      send_err(res, 400, "missing src_id/dst_id");
+      return;
+    }
+
+    std::string src = body["src_id"];
+    std::string dst = body["dst_id"];
+    std::string algorithm = body.value("algorithm", "dijkstra");
+
+    WeightedPath wp;
+    if (algorithm == "dijkstra") {
+      wp = g_gs->FindWeightedPath(src, dst);
+    } else if (algorithm == "astar") {
+      wp = g_gs->FindWeightedPathAStar(src, dst,
+                                       body.value("heuristic_scale", 1.0f));
+    } else {
+      send_err(res, 400, "unknown algorithm: " + algorithm);
+      return;
+    }
+
+    send_ok(res, {{"success", true},
+                  {"reachable", !wp.path.empty()},
+                  {"path", wp.path},
+                  {"cost", wp.cost},
+                  {"expanded", wp.expanded},
+                  {"algorithm", algorithm}});
+  } catch (const std::domain_error &e) {
+    send_err(res, 422, e.what()); // 图中有负权 / NaN 边
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+static void handle_cache_stats(const httplib::Request &,
+                               httplib::Response &res) {
+  auto stats = g_gs->QueryCacheStats();
+  send_ok(res, {{"success", true},
+                {"hits", stats.hits},
+                {"misses", stats.misses},
+                {"stale", stats.stale},
+                {"inserts", stats.inserts},
+                {"evictions", stats.evictions},
+                {"entries", stats.entries},
+                {"hit_rate", stats.hit_rate()}});
+}
+
+static void handle_degree_stats(const httplib::Request &req,
+                                httplib::Response &res) {
+  auto h = g_gs->DegreeStats();
+  json body = {{"success", true},
+               {"nodes", h.nodes},
+               {"edges", h.edges},
+               {"max_out", h.max_out},
+               {"max_in", h.max_in},
+               {"paged_lists", h.paged_lists},
+               {"out_buckets", h.out},
+               {"in_buckets", h.in}};
+  if (req.has_param("node_id")) {
+    auto d = g_gs->GetDegree(req.get_param_value("node_id"));
+    body["node"] = {{"out", d.out}, {"in", d.in}};
+  }
+  send_ok(res, body);
+}
+
+static json snapshot_stats_json(const GraphSnapshotStats &s) {
+  return {{"nodes", s.nodes},         {"node_records", s.node_records},
+          {"edges", s.edges},         {"embeddings", s.embeddings},
+          {"labels", s.labels},       {"bytes", s.bytes},
+          {"elapsed_ms", s.elapsed_ms}};
+}
+
+static void handle_snapshot(const httplib::Request &, httplib::Response &res) {
+  if (g_snapshot_path.empty()) {
+    send_err(res, 400, "server started without a snapshot path");
+    return;
+  }
+  try {
+    auto stats = g_gs->SaveSnapshot(g_snapshot_path);
+    send_ok(res, {{"success", true},
+                  {"path", g_snapshot_path},
+                  {"stats", snapshot_stats_json(stats)}});
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+static void handle_edge_expiration(const httplib::Request &req,
+                                   httplib::Response &res) {
+  try {
+    if (req.method == "POST") {
+      auto body = json::parse(req.body.empty() ? "{}" : req.body);
+      EdgeExpirationOptions options;
+      options.retention_ms = body.value("retention_ms", int64_t{0});
+      options.check_interval = std::chrono::milliseconds(
+          body.value("check_interval_ms", int64_t{100}));
+      options.sample_size = body.value("sample_size", options.sample_size);
+      g_gs->EnableEdgeExpiration(options);
+    }
+    auto stats = g_gs->EdgeExpiration();
+    send_ok(res, {{"success", true},
+                  {"pending", stats.pending},
+                  {"retired", stats.retired}});
+  } catch (const std::invalid_argument &e) {
+    send_err(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+static void handle_property_index(const httplib::Request &req,
+                                  httplib::Response &res) {
+  try {
+    auto body = json::parse(req.body);
+    if (!body.contains("field")) {
+      send_err(res, 400, "missing field");
+      return;
+    }
+    std::string type = body.value("type", "hash");
+    if (type != "hash" && type != "ordered") {
+      send_err(res, 400, "type must be hash / ordered");
+      return;
+    }
+    g_gs->CreatePropertyIndex(body["field"].get<std::string>(),
+                              type == "hash" ? PropertyIndexType::HASH
+                                             : PropertyIndexType::ORDERED);
+
+    json indexes = json::array();
+    for (const auto &info : g_gs->ListPropertyIndexes()) {
+      indexes.push_back(
+          {{"field", info.field},
+           {"type", info.type == PropertyIndexType::HASH ? "hash" : "ordered"},
+           {"entries", info.entries}});
+    }
+    send_ok(res, {{"success", true}, {"indexes", indexes}});
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+static void handle_find_nodes(const httplib::Request &req,
+                              httplib::Response &res) {
+  try {
+    auto body = json::parse(req.body);
+    if (!body.contains("where")) {
+      send_err(res, 400, "missing where");
+      return;
+    }
+    auto nodes = g_gs->FindNodesByProperties(parse_predicates(body["where"]),
+                                             parse_projection(body));
+
+    json nodes_json = json::array();
+    for (const auto &n : nodes) {
+      nodes_json.push_back(
+          {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
+    }
     send_ok(res, {{"success", true},
                   {"node_count", (int)nodes.size()},
-                  {"vector_top_k", vector_top_k},
-                  {"hop_depth", hop_depth},
                   {"nodes", nodes_json}});
+  } catch (const std::invalid_argument &e) {
+    send_err(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_err(res, 500, e.what());
+  }
+}
+
+static void handle_traverse(const httplib::Request &req,
+                            httplib::Response &res) {
+  try {
+    auto body = json::parse(req.body);
+    auto result = g_gs->Traverse(parse_pipeline(body));
+
+    json nodes_json = json::array();
+    for (const auto &n : result.nodes) {
+      nodes_json.push_back(
+          {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
+    }
+    const auto &st = result.stats;
+    send_ok(res, {{"success", true},
+                  {"node_count", (int)result.nodes.size()},
+                  {"nodes", nodes_json},
+                  {"stats",
+                   {{"batches", st.batches},
+                    {"nodes_expanded", st.nodes_expanded},
+                    {"neighbors_scanned", st.neighbors_scanned},
+                    {"nodes_filtered", st.nodes_filtered},
+                    {"filters_pushed_down", st.filters_pushed_down},
+                    {"limit_reached", st.limit_reached}}}});
+  } catch (const std::invalid_argument &e) {
+    send_err(res, 400, e.what());
   } catch (const std::exception &e) {
     send_err(res, 500, e.what());
   }
@@ -155,12 +758,40 @@ int main(int argc, char *argv[]) {
   // 初始化 GraphStore
   auto kv = std::make_shared<GraphKVStore>(65536, 16);
   g_gs = std::make_shared<GraphStore>(kv);
+  if (argc >= 3) {
+    g_snapshot_path = argv[2];
+    // 先加载再建索引：索引构建只扫描一遍已加载的数据
+    if (std::ifstream(g_snapshot_path).good()) {
+      try {
+        auto stats = g_gs->LoadSnapshot(g_snapshot_path);
+        std::cout << "[GraphHTTPServer] loaded snapshot " << g_snapshot_path
+                  << ": " << stats.nodes << " nodes, " << stats.edges
+                  << " edges in " << stats.elapsed_ms << " ms\n";
+      } catch (const std::exception &e) {
+        std::cerr << "[GraphHTTPServer] " << e.what() << "\n";
+        return 1;
+      }
+    }
+  }
+  g_gs->EnableQueryCache();
+  g_gs->EnableKeywordIndex();
 
   httplib::Server svr;
 
   svr.Post("/graph/add_node", handle_add_node);
   svr.Post("/graph/add_edge", handle_add_edge);
+  svr.Post("/graph/add_nodes", handle_add_nodes);
+  svr.Post("/graph/add_edges", handle_add_edges);
   svr.Post("/graph/rag_query", handle_rag_query);
+  svr.Post("/graph/shortest_path", handle_shortest_path);
+  svr.Get("/graph/cache_stats", handle_cache_stats);
+  svr.Get("/graph/degree_stats", handle_degree_stats);
+  svr.Post("/graph/property_index", handle_property_index);
+  svr.Post("/graph/find_nodes", handle_find_nodes);
+  svr.Post("/graph/traverse", handle_traverse);
+  svr.Post("/graph/snapshot", handle_snapshot);
+  svr.Post("/graph/edge_expiration", handle_edge_expiration);
+  svr.Get("/graph/edge_expiration", handle_edge_expiration);
   svr.Get("/health", [](const httplib::Request &, httplib::Response &res) {
     res.set_content(R"({"status":"ok","service":"MinKV Graph HTTP Server"})",
                     "application/json");
@@ -172,7 +803,18 @@ int main(int argc, char *argv[]) {
   std::cout << "[GraphHTTPServer] listening on 0.0.0.0:" << port << "\n";
   std::cout << "  POST /graph/add_node\n";
   std::cout << "  POST /graph/add_edge\n";
+  std::cout << "  POST /graph/add_nodes\n";
+  std::cout << "  POST /graph/add_edges\n";
   std::cout << "  POST /graph/rag_query\n";
+  std::cout << "  POST /graph/shortest_path\n";
+  std::cout << "  GET  /graph/cache_stats\n";
+  std::cout << "  GET  /graph/degree_stats\n";
+  std::cout << "  POST /graph/property_index\n";
+  std::cout << "  POST /graph/find_nodes\n";
+  std::cout << "  POST /graph/traverse\n";
+  std::cout << "  POST /graph/snapshot\n";
+  std::cout << "  POST /graph/edge_expiration\n";
+  std::cout << "  GET  /graph/edge_expiration\n";
   std::cout << "  GET  /health\n\n";
 
   svr.listen("0.0.0.0", port);
@@ -1,17 +1,154 @@
 #include "http_server.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <sstream>
 
+#include "json_writer.h"
+
 namespace minkv {
 namespace server {
 
+// 二进制向量传输的 Content-Type
+static const char *const kOctetStream = "application/octet-stream";
+// 流式响应的 Content-Type（每行一个 JSON 对象）和每块的目标字节数
+static const char *const kNdjson = "application/x-ndjson";
+static constexpr size_t kStreamChunkBytes = 64 * 1024;
+
+/**
+ * 以 chunked NDJSON 发送：首行为 header（已编码好的一行，含换行符），
+ * 之后 items 每个元素一行
+ *
+ * items 移交给 content provider，元素在发送时才经 write_item 编码，
+ * 攒够 kStreamChunkBytes 写出一块；内存中不会同时存在完整的 JSON 文档
+ * 和完整的响应字符串。
+ */
+template <typename T, typename F>
+static void send_ndjson(httplib::Response &res, std::string header,
+                        std::vector<T> items, F write_item) {
+  struct State {
+    std::string header;
+    std::vector<T> items;
+    size_t next = 0;
+  };
+  auto state = std::make_shared<State>();
+  state->header = std::move(header);
+  state->items = std::move(items);
+  res.status = 200;
+  res.set_chunked_content_provider(
+      kNdjson, [state, write_item](size_t, httplib::DataSink &sink) {
+        std::string chunk = std::move(state->header); // 只在第一块非空
+        state->header.clear();
+        chunk.reserve(kStreamChunkBytes + 4096);
+        JsonWriter w(chunk);
+        while (state->next < state->items.size() &&
+               chunk.size() < kStreamChunkBytes) {
+          write_item(w, state->items[state->next++]);
+          chunk += '\n';
+        }
+        if (!chunk.empty() && !sink.write(chunk.data(), chunk.size()))
+          return false; // 客户端断开
+        if (state->next == state->items.size())
+          sink.done();
+        return true;
+      });
+}
+
+// HttpAdmissionOptions 中 0 表示默认值的几个线程数
+static size_t worker_threads(const HttpAdmissionOptions &o) {
+  return o.worker_threads != 0 ? o.worker_threads
+                               : CPPHTTPLIB_THREAD_POOL_COUNT;
+}
+
+static size_t max_worker_threads(const HttpAdmissionOptions &o) {
+  size_t base = worker_threads(o);
+  return o.max_worker_threads != 0 ? std::max(o.max_worker_threads, base)
+                                   : base * 4;
+}
+
+static size_t expensive_threads(const HttpAdmissionOptions &o) {
+  return o.expensive_threads != 0
+             ? o.expensive_threads
+             : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * httplib 连接队列的计数包装：统计等待工作线程的连接数和因队列满被
+ * 关闭的连接数（httplib::ThreadPool 自己不暴露这些）
+ */
+class CountingTaskQueue : public httplib::TaskQueue {
+public:
+  CountingTaskQueue(size_t threads, size_t max_threads, size_t max_queued,
+                    std::atomic<size_t> &queued,
+                    std::atomic<uint64_t> &rejected)
+      : pool_(threads, max_threads, max_queued), queued_(queued),
+        rejected_(rejected) {}
+
+  bool enqueue(std::function<void()> fn) override {
+    ++queued_;
+    bool ok = pool_.enqueue([this, fn = std::move(fn)] {
+      --queued_;
+      fn();
+    });
+    if (!ok) {
+      --queued_;
+      ++rejected_; // httplib 随后直接关闭这个连接
+    }
+    return ok;
+  }
+
+  void shutdown() override { pool_.shutdown(); }
+
+private:
+  httplib::ThreadPool pool_;
+  std::atomic<size_t> &queued_;
+  std::atomic<uint64_t> &rejected_;
+};
+
 HttpServer::HttpServer(std::shared_ptr<MinKV<std::string, std::string>> kv,
                        std::shared_ptr<graph::GraphStore> graph_store,
                        const std::string &host, int port)
     : kv_(kv), graph_store_(graph_store), host_(host), port_(port),
       running_(false), server_(std::make_unique<httplib::Server>()) {
+  if (!unix_path().empty())
+    server_->set_address_family(AF_UNIX); // host 为 "unix:<路径>"
+  // 连接处理线程池在每次 listen 时按当时的 admission_ 创建
+  server_->new_task_queue = [this]() -> httplib::TaskQueue * {
+    return new CountingTaskQueue(worker_threads(admission_),
+                                 max_worker_threads(admission_),
+                                 admission_.max_queued_connections,
+                                 queued_connections_, rejected_connections_);
+  };
   setup_routes(); // 构造时完成路由注册，start() 前不发起监听
+  apply_admission();
+}
+
+std::string HttpServer::unix_path() const {
+  static const std::string kPrefix = "unix:";
+  if (host_.compare(0, kPrefix.size(), kPrefix) != 0)
+    return "";
+  return host_.substr(kPrefix.size());
+}
+
+std::string HttpServer::endpoint() const {
+  return unix_path().empty() ? host_ + ":" + std::to_string(port_) : host_;
+}
+
+bool HttpServer::listen() {
+  std::string path = unix_path();
+  if (path.empty())
+    return server_->listen(host_.c_str(), port_);
+  ::unlink(path.c_str()); // 上次未正常退出留下的 socket 文件
+  bool ok = server_->listen(path, port_);
+  ::unlink(path.c_str());
+  return ok;
 }
 
 HttpServer::~HttpServer() {
@@ -23,61 +160,110 @@ HttpServer::~HttpServer() {
 // ==========================================
 
 void HttpServer::setup_routes() {
+  constexpr Cost kCheap = Cost::Cheap;
+  constexpr Cost kExpensive = Cost::Expensive;
+
   // [KV 基础接口] 工作记忆的快速读写
-  server_->Post("/kv/set",
-                [this](const httplib::Request &req, httplib::Response &res) {
-                  handle_kv_set(req, res);
-                });
-  server_->Get("/kv/get",
-               [this](const httplib::Request &req, httplib::Response &res) {
-                 handle_kv_get(req, res);
-               });
-  server_->Delete("/kv/del",
-                  [this](const httplib::Request &req, httplib::Response &res) {
-                    handle_kv_delete(req, res);
-                  });
+  route("POST", "/kv/set", kCheap, &HttpServer::handle_kv_set);
+  route("GET", "/kv/get", kCheap, &HttpServer::handle_kv_get);
+  route("DELETE", "/kv/del", kCheap, &HttpServer::handle_kv_delete);
+  route("POST", "/kv/mget", kCheap, &HttpServer::handle_kv_mget);
+  route("POST", "/kv/mset", kCheap, &HttpServer::handle_kv_mset);
+  route("POST", "/kv/mdel", kCheap, &HttpServer::handle_kv_mdel);
+  route("GET", "/kv/scan", kCheap, &HttpServer::handle_kv_scan);
 
   // [向量接口] 情景记忆的语义存取与相似度检索
-  server_->Post("/vector/put",
-                [this](const httplib::Request &req, httplib::Response &res) {
-                  handle_vector_put(req, res);
-                });
-  server_->Post("/vector/search",
-                [this](const httplib::Request &req, httplib::Response &res) {
-                  handle_vector_search(req, res);
-                });
-  server_->Get("/vector/get",
-               [this](const httplib::Request &req, httplib::Response &res) {
-                 handle_vector_get(req, res);
-               });
-  server_->Delete("/vector/delete",
-                  [this](const httplib::Request &req, httplib::Response &res) {
-                    handle_vector_delete(req, res);
-                  });
+  route("POST", "/vector/put", kCheap, &HttpServer::handle_vector_put);
+  route("POST", "/vector/search", kExpensive,
+        &HttpServer::handle_vector_search);
+  route("GET", "/vector/get", kCheap, &HttpServer::handle_vector_get);
+  route("DELETE", "/vector/delete", kCheap,
+        &HttpServer::handle_vector_delete);
+  route("POST", "/vector/mput", kCheap, &HttpServer::handle_vector_mput);
+  route("POST", "/vector/msearch", kExpensive,
+        &HttpServer::handle_vector_msearch);
 
-  // [健康检查] 供负载均衡器或监控系统探活
+  // [健康检查] 供负载均衡器或监控系统探活，不限流
   server_->Get("/health", [](const httplib::Request &, httplib::Response &res) {
     json response = {{"status", "ok"}, {"service", "MinKV Vector Database"}};
     res.set_content(response.dump(), "application/json");
   });
 
+  // [准入统计] 过载时也要能查，不限流
+  server_->Get("/stats/admission",
+               [this](const httplib::Request &req, httplib::Response &res) {
+                 handle_admission_stats(req, res);
+               });
+
   // [图接口] 仅在传入 graph_store_ 时注册，避免空指针访问
   if (graph_store_) {
-    server_->Post("/graph/add_node",
-                  [this](const httplib::Request &req, httplib::Response &res) {
-                    handle_graph_add_node(req, res);
-                  });
-    server_->Post("/graph/add_edge",
-                  [this](const httplib::Request &req, httplib::Response &res) {
-                    handle_graph_add_edge(req, res);
-                  });
-    server_->Post("/graph/rag_query",
-                  [this](const httplib::Request &req, httplib::Response &res) {
-                    handle_graph_rag_query(req, res);
-                  });
+    route("POST", "/graph/add_node", kCheap,
+          &HttpServer::handle_graph_add_node);
+    route("POST", "/graph/add_edge", kCheap,
+          &HttpServer::handle_graph_add_edge);
+    route("POST", "/graph/add_nodes", kCheap,
+          &HttpServer::handle_graph_add_nodes);
+    route("POST", "/graph/add_edges", kCheap,
+          &HttpServer::handle_graph_add_edges);
+    route("POST", "/graph/rag_query", kExpensive,
+          &HttpServer::handle_graph_rag_query);
+    route("POST", "/graph/shortest_path", kExpensive,
+          &HttpServer::handle_graph_shortest_path);
+    route("GET", "/graph/cache_stats", kCheap,
+          &HttpServer::handle_graph_cache_stats);
+    route("GET", "/graph/degree_stats", kCheap,
+          &HttpServer::handle_graph_degree_stats);
+    // 建索引要扫描全部节点
+    route("POST", "/graph/property_index", kExpensive,
+          &HttpServer::handle_graph_property_index);
+    route("POST", "/graph/find_nodes", kExpensive,
+          &HttpServer::handle_graph_find_nodes);
+    route("POST", "/graph/traverse", kExpensive,
+          &HttpServer::handle_graph_traverse);
   }
 }
 
+void HttpServer::route(const std::string &method, const std::string &path,
+                       Cost cost, Handler handler) {
+  endpoint_cost_[path] = cost;
+  auto guarded = [this, path, cost, handler](const httplib::Request &req,
+                                             httplib::Response &res) {
+    auto it = limiters_.find(path);
+    if (it == limiters_.end()) { // 未启用准入控制
+      (this->*handler)(req, res);
+      return;
+    }
+    auto permit = std::make_shared<AdmissionLimiter::Permit>(*it->second);
+    if (!*permit) {
+      send_overloaded(res, path, permit->result());
+      return;
+    }
+    if (cost == Cost::Cheap || !expensive_pool_) {
+      (this->*handler)(req, res);
+    } else {
+      // 当前线程等到 handler 执行完才返回，req / res 的引用一直有效；
+      // handler 抛出的异常经 future 传回，由 httplib 统一处理
+      expensive_pool_->submit([&] { (this->*handler)(req, res); }).get();
+    }
+    if (res.content_provider_) {
+      // 流式响应（/kv/scan）在 provider 里边算边发，名额交给释放回调，
+      // Response 析构（发送结束或连接断开）时才归还
+      auto release = std::move(res.content_provider_resource_releaser_);
+      res.content_provider_resource_releaser_ = [permit,
+                                                 release](bool success) {
+        if (release)
+          release(success);
+      };
+    }
+  };
+  if (method == "GET")
+    server_->Get(path, guarded);
+  else if (method == "POST")
+    server_->Post(path, guarded);
+  else
+    server_->Delete(path, guarded);
+}
+
 // ==========================================
 // 服务器生命周期管理
 // ==========================================
@@ -87,11 +273,9 @@ bool HttpServer::start() {
     std::cerr << "[HttpServer] 服务器已在运行中" << std::endl;
     return false;
   }
-  std::cout << "[HttpServer] 启动服务器：" << host_ << ":" << port_
-            << std::endl;
+  std::cout << "[HttpServer] 启动服务器：" << endpoint() << std::endl;
   running_.store(true);
-  bool success =
-      server_->listen(host_.c_str(), port_); // 阻塞，直到 stop() 被调用
+  bool success = listen(); // 阻塞，直到 stop() 被调用
   running_.store(false);
   return success;
 }
@@ -104,9 +288,8 @@ bool HttpServer::start_async() {
   running_.store(true);
   // [后台线程] 在独立线程中进入事件循环，调用方立即返回
   server_thread_ = std::make_unique<std::thread>([this]() {
-    std::cout << "[HttpServer] 启动服务器（异步）：" << host_ << ":" << port_
-              << std::endl;
-    server_->listen(host_.c_str(), port_);
+    std::cout << "[HttpServer] 启动服务器（异步）：" << endpoint() << std::endl;
+    listen();
     running_.store(false);
   });
   // 等待 100ms 确保 httplib 完成端口绑定，避免调用方立即发请求时连接被拒
@@ -127,6 +310,109 @@ void HttpServer::stop() {
   std::cout << "[HttpServer] 服务器已停止" << std::endl;
 }
 
+// ==========================================
+// 准入控制
+// ==========================================
+
+bool HttpServer::set_admission_options(const HttpAdmissionOptions &options) {
+  if (running_.load()) {
+    std::cerr << "[HttpServer] 运行中不能修改准入控制配置" << std::endl;
+    return false;
+  }
+  HttpAdmissionOptions old = std::move(admission_);
+  admission_ = options;
+  try {
+    apply_admission();
+  } catch (...) {
+    admission_ = std::move(old);
+    apply_admission();
+    throw;
+  }
+  return true;
+}
+
+void HttpServer::apply_admission() {
+  // 先全部构造好再替换，某个端点的限制不合法时原有限流器不受影响
+  std::unordered_map<std::string, std::unique_ptr<AdmissionLimiter>> limiters;
+  if (admission_.enabled) {
+    for (const auto &[path, cost] : endpoint_cost_) {
+      auto it = admission_.endpoints.find(path);
+      const AdmissionLimits &limits =
+          it != admission_.endpoints.end() ? it->second
+          : cost == Cost::Expensive        ? admission_.expensive
+                                           : admission_.cheap;
+      limiters[path] = std::make_unique<AdmissionLimiter>(limits);
+    }
+  }
+  limiters_ = std::move(limiters);
+  expensive_pool_.reset();
+  if (admission_.enabled)
+    expensive_pool_ =
+        std::make_unique<base::ThreadPool>(expensive_threads(admission_));
+}
+
+std::map<std::string, AdmissionStats> HttpServer::admission_stats() const {
+  std::map<std::string, AdmissionStats> stats;
+  for (const auto &[path, limiter] : limiters_)
+    stats[path] = limiter->Stats();
+  return stats;
+}
+
+void HttpServer::send_overloaded(httplib::Response &res,
+                                 const std::string &path,
+                                 AdmissionLimiter::Result result) {
+  res.set_header("Retry-After", std::to_string(admission_.retry_after_s));
+  send_error(res, 503,
+             "服务繁忙：" + path +
+                 (result == AdmissionLimiter::Result::QueueFull
+                      ? " 等待队列已满"
+                      : " 排队超时") +
+                 "，请稍后重试");
+}
+
+bool HttpServer::reject_expired(httplib::Response &res,
+                                const RequestDeadline &deadline) {
+  if (!deadline.expired() || deadline.allow_partial)
+    return false;
+  send_error(res, 504,
+             "请求超时：已超过 X-Timeout-Ms / timeout_ms 指定的截止时间");
+  return true;
+}
+
+void HttpServer::handle_admission_stats(const httplib::Request &,
+                                        httplib::Response &res) {
+  json endpoints = json::object();
+  for (const auto &[path, s] : admission_stats()) {
+    const AdmissionLimiter &limiter = *limiters_.at(path);
+    endpoints[path] = {
+        {"cost", endpoint_cost_.at(path) == Cost::Expensive ? "expensive"
+                                                            : "cheap"},
+        {"limit", s.limit},
+        {"in_flight", s.in_flight},
+        {"queued", s.queued},
+        {"max_queue", limiter.limits().max_queue},
+        {"admitted", s.admitted},
+        {"rejected_queue_full", s.rejected_queue_full},
+        {"rejected_timeout", s.rejected_timeout},
+        {"limit_decreases", s.limit_decreases},
+        {"avg_latency_ms", s.avg_latency_ms},
+        {"avg_queue_ms", s.avg_queue_ms}};
+  }
+  json response = {
+      {"success", true},
+      {"enabled", admission_.enabled},
+      {"connections",
+       {{"worker_threads", worker_threads(admission_)},
+        {"max_worker_threads", max_worker_threads(admission_)},
+        {"queued", queued_connections_.load()},
+        {"max_queued", admission_.max_queued_connections},
+        {"rejected", rejected_connections_.load()}}},
+      {"expensive_threads",
+       admission_.enabled ? expensive_threads(admission_) : 0},
+      {"endpoints", std::move(endpoints)}};
+  send_success(res, response);
+}
+
 // ==========================================
 // KV 基础接口处理器
 // ==========================================
@@ -143,7 +429,14 @@ void HttpServer::handle_kv_set(const httplib::Request &req,
     std::string value = body["value"];
     int64_t ttl_ms = body.value("ttl_ms", (int64_t)0); // 0 表示永不过期
     kv_->put(key, value, ttl_ms);
-    send_success(res, {{"success", true}, {"key", key}});
+
+    std::string out;
+    JsonWriter(out)
+        .begin_object()
+        .field("success", true)
+        .field("key", key)
+        .end_object();
+    send_json(res, std::move(out));
   } catch (const json::exception &e) {
     send_error(res, 400, std::string("JSON 解析错误：") + e.what());
   } catch (const std::exception &e) {
@@ -164,7 +457,15 @@ void HttpServer::handle_kv_get(const httplib::Request &req,
       send_error(res, 404, "Key 不存在");
       return;
     }
-    send_success(res, {{"success", true}, {"key", key}, {"value", *result}});
+    std::string out;
+    out.reserve(key.size() + result->size() + 48);
+    JsonWriter(out)
+        .begin_object()
+        .field("success", true)
+        .field("key", key)
+        .field("value", *result)
+        .end_object();
+    send_json(res, std::move(out));
   } catch (const std::exception &e) {
     send_error(res, 500, std::string("内部错误：") + e.what());
   }
@@ -180,7 +481,13 @@ void HttpServer::handle_kv_delete(const httplib::Request &req,
     std::string key = req.get_param_value("key");
     bool ok = kv_->remove(key); // key 不存在时返回 false
     if (ok) {
-      send_success(res, {{"success", true}, {"key", key}});
+      std::string out;
+      JsonWriter(out)
+          .begin_object()
+          .field("success", true)
+          .field("key", key)
+          .end_object();
+      send_json(res, std::move(out));
     } else {
       send_error(res, 404, "Key 不存在");
     }
@@ -189,6 +496,192 @@ void HttpServer::handle_kv_delete(const httplib::Request &req,
   }
 }
 
+// 批量写入的单项结果：成功项由调用方接着写其余字段并 end_object，
+// 失败项只有错误信息
+static JsonWriter &begin_batch_item(JsonWriter &w, size_t index) {
+  return w.begin_object().field("index", index).field("success", true);
+}
+
+static void batch_error(JsonWriter &w, size_t index, std::string_view error) {
+  w.begin_object()
+      .field("index", index)
+      .field("success", false)
+      .field("error", error)
+      .end_object();
+}
+
+void HttpServer::handle_kv_mget(const httplib::Request &req,
+                                httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    std::vector<std::string> keys = batch_array(body, "keys");
+    auto values = kv_->multiGet(keys);
+
+    std::string out;
+    JsonWriter w(out);
+    w.begin_object().field("success", true).field("count", keys.size());
+    w.key("results").begin_array();
+    for (size_t i = 0; i < keys.size(); ++i) {
+      w.begin_object().field("key", keys[i]).field("found", bool(values[i]));
+      if (values[i])
+        w.field("value", *values[i]);
+      w.end_object();
+    }
+    w.end_array().end_object();
+    send_json(res, std::move(out));
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_kv_mset(const httplib::Request &req,
+                                httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    const json &items = batch_array(body, "items");
+    int64_t default_ttl = body.value("ttl_ms", (int64_t)0);
+
+    // 按 ttl_ms 分组，每组一次 multiPut
+    std::map<int64_t, std::vector<std::pair<std::string, std::string>>>
+        by_ttl;
+    std::string out;
+    JsonWriter w(out);
+    w.begin_object().field("success", true).field("count", items.size());
+    w.key("results").begin_array();
+    size_t failed = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      try {
+        const json &item = items[i];
+        std::string key = item.at("key");
+        std::string value = item.at("value");
+        int64_t ttl_ms = item.value("ttl_ms", default_ttl);
+        begin_batch_item(w, i).field("key", key).end_object();
+        by_ttl[ttl_ms].emplace_back(std::move(key), std::move(value));
+      } catch (const json::exception &e) {
+        batch_error(w, i, e.what());
+        ++failed;
+      }
+    }
+    for (const auto &[ttl_ms, entries] : by_ttl)
+      kv_->multiPut(entries, ttl_ms);
+
+    w.end_array().field("failed", failed).end_object();
+    send_json(res, std::move(out));
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_kv_mdel(const httplib::Request &req,
+                                httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    std::vector<std::string> keys = batch_array(body, "keys");
+    auto deleted = kv_->multiRemove(keys);
+
+    std::string out;
+    JsonWriter w(out);
+    w.begin_object().field("success", true).field("count", keys.size());
+    w.key("results").begin_array();
+    for (size_t i = 0; i < keys.size(); ++i) {
+      w.begin_object()
+          .field("key", keys[i])
+          .field("deleted", bool(deleted[i]))
+          .end_object();
+    }
+    w.end_array().end_object();
+    send_json(res, std::move(out));
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_kv_scan(const httplib::Request &req,
+                                httplib::Response &res) {
+  try {
+    db::ScanCursor cursor = parse_scan_cursor(
+        req.has_param("cursor") ? req.get_param_value("cursor") : "0");
+    int64_t count = int_param(req, "count", 1000);
+    int64_t limit = int_param(req, "limit", 0);
+    if (count <= 0 || limit < 0) {
+      send_error(res, 400, "count 必须为正数，limit 不能为负数");
+      return;
+    }
+    std::string prefix = req.get_param_value("prefix");
+    std::string keys_only_param = req.get_param_value("keys_only");
+    bool keys_only = keys_only_param == "true" || keys_only_param == "1";
+
+    struct State {
+      db::ScanCursor cursor;
+      size_t sent = 0;
+      std::vector<std::pair<std::string, std::string>> page;
+    };
+    auto state = std::make_shared<State>();
+    state->cursor = cursor;
+    auto kv = kv_; // provider 可能在处理器返回后才被调用
+    res.status = 200;
+    res.set_chunked_content_provider(
+        kNdjson, [state, kv, prefix, keys_only, count,
+                  limit](size_t, httplib::DataSink &sink) {
+          // 每次回调遍历一页：锁内只拷贝匹配的条目，序列化在锁外；
+          // 有 limit 时页大小不超过剩余额度，scan 按整桶返回，可能略多几条
+          size_t page_size = static_cast<size_t>(count);
+          if (limit > 0)
+            page_size = std::min(page_size, (size_t)limit - state->sent);
+          state->page.clear();
+          state->cursor = kv->scan(
+              state->cursor, page_size,
+              [&](const std::string &key, const std::string &value) {
+                if (key.compare(0, prefix.size(), prefix) != 0)
+                  return;
+                state->page.emplace_back(key,
+                                         keys_only ? std::string() : value);
+              });
+          std::string chunk;
+          JsonWriter w(chunk);
+          for (const auto &[key, value] : state->page) {
+            w.begin_object().field("key", key);
+            if (!keys_only)
+              w.field("value", value);
+            w.end_object();
+            chunk += '\n';
+          }
+          state->sent += state->page.size();
+
+          bool finished = state->cursor.done ||
+                          (limit > 0 && state->sent >= (size_t)limit);
+          if (finished) {
+            w.begin_object()
+                .field("cursor", format_scan_cursor(state->cursor))
+                .field("count", state->sent)
+                .end_object();
+            chunk += '\n';
+          }
+          if (!chunk.empty() && !sink.write(chunk.data(), chunk.size()))
+            return false;
+          if (finished)
+            sink.done();
+          return true;
+        });
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
 // ==========================================
 // 向量接口处理器
 // ==========================================
@@ -196,6 +689,27 @@ void HttpServer::handle_kv_delete(const httplib::Request &req,
 void HttpServer::handle_vector_put(const httplib::Request &req,
                                    httplib::Response &res) {
   try {
+    if (is_binary_vector(req)) {
+      // [二进制传输] 请求体即向量字节，key / ttl_ms 走查询参数
+      if (!req.has_param("key")) {
+        send_error(res, 400, "缺少必填查询参数：key");
+        return;
+      }
+      VectorDtype dtype = parse_vector_dtype(req);
+      size_t dimension = parse_binary_vector(req, dtype);
+      std::string key = req.get_param_value("key");
+      int64_t ttl_ms = int_param(req, "ttl_ms", 0);
+      if (dtype == VectorDtype::FP32) {
+        kv_->vectorPutRaw(key, req.body, ttl_ms); // 字节即存储格式
+      } else {
+        kv_->vectorPutRaw(
+            key, VectorOps::SerializeFromHalf(req.body.data(), dimension),
+            ttl_ms);
+      }
+      send_vector_put(res, key, dimension);
+      return;
+    }
+
     json request_body = json::parse(req.body);
 
     // 校验必填字段
@@ -222,12 +736,11 @@ void HttpServer::handle_vector_put(const httplib::Request &req,
     // [核心写入] 调用 MinKV 向量存储接口
     kv_->vectorPut(key, embedding, ttl_ms);
 
-    send_success(res, {{"success", true},
-                       {"message", "向量写入成功"},
-                       {"key", key},
-                       {"dimension", embedding.size()}});
+    send_vector_put(res, key, embedding.size());
   } catch (const json::exception &e) {
     send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
   } catch (const std::exception &e) {
     send_error(res, 500, std::string("内部错误：") + e.what());
   }
@@ -236,7 +749,37 @@ void HttpServer::handle_vector_put(const httplib::Request &req,
 void HttpServer::handle_vector_search(const httplib::Request &req,
                                       httplib::Response &res) {
   try {
+    if (is_binary_vector(req)) {
+      // [二进制传输] fp32 查询向量直接指向请求体，fp16 先解码
+      int64_t top_k = int_param(req, "top_k", 0);
+      if (top_k <= 0 || top_k > INT32_MAX) {
+        send_error(res, 400, "缺少或非法的查询参数：top_k");
+        return;
+      }
+      VectorDtype dtype = parse_vector_dtype(req);
+      size_t dimension = parse_binary_vector(req, dtype);
+      std::string decoded;
+      const char *bytes = req.body.data();
+      if (dtype == VectorDtype::FP16) {
+        decoded = VectorOps::SerializeFromHalf(req.body.data(), dimension);
+        bytes = decoded.data();
+      }
+      RequestDeadline deadline = parse_request_deadline(req, nullptr);
+      if (reject_expired(res, deadline))
+        return; // 排队等待期间已经超时，不再计算
+      auto results = kv_->vectorSearch(reinterpret_cast<const float *>(bytes),
+                                       dimension, static_cast<int>(top_k),
+                                       deadline.token);
+      if (reject_expired(res, deadline))
+        return;
+      send_vector_search(res, dimension, top_k, results, deadline.expired());
+      return;
+    }
+
     json request_body = json::parse(req.body);
+    RequestDeadline deadline = parse_request_deadline(req, &request_body);
+    if (reject_expired(res, deadline))
+      return;
 
     // 校验必填字段
     if (!request_body.contains("query") || !request_body.contains("top_k")) {
@@ -254,21 +797,17 @@ void HttpServer::handle_vector_search(const httplib::Request &req,
     }
 
     // [核心检索] 调用 MinKV L2 距离 Top-K 搜索（SIMD AVX2 加速）
-    auto results = kv_->vectorSearch(query, static_cast<int>(top_k));
+    auto results =
+        kv_->vectorSearch(query, static_cast<int>(top_k), deadline.token);
+    if (reject_expired(res, deadline))
+      return;
 
     // 构建响应：结果仅为 key 列表
-    json results_json = json::array();
-    for (const auto &key : results) {
-      results_json.push_back(key);
-    }
-
-    send_success(res, {{"success", true},
-                       {"query_dimension", query.size()},
-                       {"top_k", top_k},
-                       {"results_count", results.size()},
-                       {"results", results_json}});
+    send_vector_search(res, query.size(), top_k, results, deadline.expired());
   } catch (const json::exception &e) {
     send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
   } catch (const std::exception &e) {
     send_error(res, 500, std::string("内部错误：") + e.what());
   }
@@ -284,6 +823,29 @@ void HttpServer::handle_vector_get(const httplib::Request &req,
 
     std::string key = req.get_param_value("key");
 
+    if (req.get_header_value("Accept").find(kOctetStream) !=
+        std::string::npos) {
+      // [二进制响应] 存储中的 fp32 字节直接作为响应体，fp16 逐个编码
+      VectorDtype dtype = parse_vector_dtype(req);
+      auto raw = kv_->get(key);
+      if (!raw || raw->empty() || raw->size() % sizeof(float) != 0) {
+        send_error(res, 404, "向量不存在");
+        return;
+      }
+      size_t dimension = raw->size() / sizeof(float);
+      std::string body = std::move(*raw);
+      if (dtype == VectorDtype::FP16) {
+        body = VectorOps::EncodeHalf(
+            reinterpret_cast<const float *>(body.data()), dimension);
+      }
+      res.status = 200;
+      res.set_header("X-Vector-Dimension", std::to_string(dimension));
+      res.set_header("X-Vector-Dtype",
+                     dtype == VectorDtype::FP16 ? "fp16" : "fp32");
+      res.set_content(std::move(body), kOctetStream);
+      return;
+    }
+
     // [核心读取] 调用 MinKV 向量读取接口
     auto embedding = kv_->vectorGet(key);
 
@@ -292,12 +854,18 @@ void HttpServer::handle_vector_get(const httplib::Request &req,
       return;
     }
 
-    json response = {{"success", true},
-                     {"key", key},
-                     {"embedding", embedding},
-                     {"dimension", embedding.size()}};
-
-    send_success(res, response);
+    std::string out;
+    out.reserve(key.size() + embedding.size() * 16 + 80);
+    JsonWriter(out)
+        .begin_object()
+        .field("success", true)
+        .field("key", key)
+        .field("embedding", embedding)
+        .field("dimension", embedding.size())
+        .end_object();
+    send_json(res, std::move(out));
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
   } catch (const std::exception &e) {
     send_error(res, 500, std::string("内部错误：") + e.what());
   }
@@ -317,8 +885,14 @@ void HttpServer::handle_vector_delete(const httplib::Request &req,
     bool success = kv_->remove(key);
 
     if (success) {
-      send_success(
-          res, {{"success", true}, {"message", "向量删除成功"}, {"key", key}});
+      std::string out;
+      JsonWriter(out)
+          .begin_object()
+          .field("success", true)
+          .field("message", "向量删除成功")
+          .field("key", key)
+          .end_object();
+      send_json(res, std::move(out));
     } else {
       send_error(res, 404, "向量不存在");
     }
@@ -327,6 +901,122 @@ void HttpServer::handle_vector_delete(const httplib::Request &req,
   }
 }
 
+void HttpServer::handle_vector_mput(const httplib::Request &req,
+                                    httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    const json &items = batch_array(body, "items");
+    int64_t default_ttl = body.value("ttl_ms", (int64_t)0);
+
+    std::map<int64_t, std::vector<std::pair<std::string, std::string>>>
+        by_ttl;
+    std::string out;
+    JsonWriter w(out);
+    w.begin_object().field("success", true).field("count", items.size());
+    w.key("results").begin_array();
+    size_t failed = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      try {
+        const json &item = items[i];
+        std::string key = item.at("key");
+        std::vector<float> embedding = item.at("embedding");
+        if (embedding.empty()) {
+          batch_error(w, i, "向量不能为空");
+          ++failed;
+          continue;
+        }
+        int64_t ttl_ms = item.value("ttl_ms", default_ttl);
+        begin_batch_item(w, i)
+            .field("key", key)
+            .field("dimension", embedding.size())
+            .end_object();
+        by_ttl[ttl_ms].emplace_back(std::move(key),
+                                    VectorOps::Serialize(embedding));
+      } catch (const json::exception &e) {
+        batch_error(w, i, e.what());
+        ++failed;
+      }
+    }
+    for (const auto &[ttl_ms, entries] : by_ttl)
+      kv_->multiPut(entries, ttl_ms);
+
+    w.end_array().field("failed", failed).end_object();
+    send_json(res, std::move(out));
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_vector_msearch(const httplib::Request &req,
+                                       httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    const json &queries_json = batch_array(body, "queries");
+    RequestDeadline deadline = parse_request_deadline(req, &body);
+    if (reject_expired(res, deadline))
+      return;
+    if (!body.contains("top_k")) {
+      send_error(res, 400, "缺少必填字段：top_k");
+      return;
+    }
+    int64_t top_k = body["top_k"];
+    if (top_k <= 0 || top_k > INT32_MAX) {
+      send_error(res, 400, "非法的 top_k");
+      return;
+    }
+
+    // 只把合法的查询交给 vectorSearchBatch，slot[i] 为第 i 项在其中的位置
+    std::vector<std::vector<float>> queries;
+    std::vector<std::string> errors(queries_json.size());
+    std::vector<size_t> slot(queries_json.size(), SIZE_MAX);
+    for (size_t i = 0; i < queries_json.size(); ++i) {
+      try {
+        std::vector<float> query = queries_json[i];
+        if (query.empty()) {
+          errors[i] = "查询向量不能为空";
+          continue;
+        }
+        slot[i] = queries.size();
+        queries.push_back(std::move(query));
+      } catch (const json::exception &e) {
+        errors[i] = e.what();
+      }
+    }
+    auto found = kv_->vectorSearchBatch(queries, static_cast<int>(top_k),
+                                        deadline.token);
+    if (reject_expired(res, deadline))
+      return;
+
+    std::string out;
+    JsonWriter w(out);
+    w.begin_object().field("success", true);
+    if (deadline.expired())
+      w.field("partial", true);
+    w.field("count", queries_json.size()).field("top_k", top_k);
+    w.key("results").begin_array();
+    for (size_t i = 0; i < queries_json.size(); ++i) {
+      w.begin_object().field("success", slot[i] != SIZE_MAX);
+      if (slot[i] == SIZE_MAX)
+        w.field("error", errors[i]);
+      else
+        w.field("results", found[slot[i]]);
+      w.end_object();
+    }
+    w.end_array().end_object();
+    send_json(res, std::move(out));
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
 // ==========================================
 // 辅助方法
 // ==========================================
@@ -343,12 +1033,235 @@ DistanceMetric HttpServer::parse_metric(const std::string &metric_str) {
   }
 }
 
+graph::TraversalFilter HttpServer::parse_traversal_filter(const json &body) {
+  graph::TraversalFilter filter;
+  if (body.contains("labels")) {
+    filter.labels = body["labels"].get<std::vector<std::string>>();
+  }
+  std::string direction = body.value("direction", "out");
+  if (direction == "out") {
+    filter.direction = graph::Direction::OUT;
+  } else if (direction == "in") {
+    filter.direction = graph::Direction::IN;
+  } else if (direction == "both") {
+    filter.direction = graph::Direction::BOTH;
+  } else {
+    throw std::invalid_argument("direction 必须是 out / in / both");
+  }
+  if (body.contains("where")) {
+    filter.node_predicates = parse_property_predicates(body["where"]);
+  }
+  if (body.contains("as_of")) {
+    filter.as_of = body["as_of"].get<int64_t>();
+  }
+  return filter;
+}
+
+std::vector<graph::PropertyPredicate>
+HttpServer::parse_property_predicates(const json &where) {
+  if (!where.is_array()) {
+    throw std::invalid_argument("where 必须是谓词数组");
+  }
+  std::vector<graph::PropertyPredicate> predicates;
+  for (const auto &item : where) {
+    if (!item.is_object() || !item.contains("field") ||
+        !item.contains("value")) {
+      throw std::invalid_argument("谓词需要 field 和 value 字段");
+    }
+    graph::PropertyPredicate p;
+    p.field = item["field"].get<std::string>();
+    // value 保持 JSON 字面量形式：字符串带引号，数字不带
+    p.value = item["value"].dump();
+    std::string op = item.value("op", "eq");
+    if (op == "eq") {
+      p.op = graph::PropertyOp::EQ;
+    } else if (op == "lt") {
+      p.op = graph::PropertyOp::LT;
+    } else if (op == "le") {
+      p.op = graph::PropertyOp::LE;
+    } else if (op == "gt") {
+      p.op = graph::PropertyOp::GT;
+    } else if (op == "ge") {
+      p.op = graph::PropertyOp::GE;
+    } else {
+      throw std::invalid_argument("op 必须是 eq / lt / le / gt / ge");
+    }
+    predicates.push_back(std::move(p));
+  }
+  return predicates;
+}
+
+bool HttpServer::parse_graphrag_budget(const json &body,
+                                       graph::GraphRAGBudget &budget) {
+  if (!body.contains("max_fanout") && !body.contains("max_results") &&
+      !body.contains("deadline_ms")) {
+    return false;
+  }
+  budget.max_fanout = body.value("max_fanout", 0);
+  budget.max_results = body.value("max_results", 0);
+  budget.deadline = std::chrono::milliseconds(body.value("deadline_ms", 0));
+  budget.seed = body.value("seed", 0);
+  std::string sampling = body.value("sampling", "top_weight");
+  if (sampling == "top_weight") {
+    budget.sampling = graph::FanoutSampling::TOP_WEIGHT;
+  } else if (sampling == "reservoir") {
+    budget.sampling = graph::FanoutSampling::RESERVOIR;
+  } else {
+    throw std::invalid_argument("sampling 必须是 top_weight / reservoir");
+  }
+  return true;
+}
+
+graph::TraversalPipeline
+HttpServer::parse_traversal_pipeline(const json &body) {
+  graph::TraversalPipeline pipeline;
+  if (body.contains("start"))
+    pipeline.start = body["start"].get<std::vector<std::string>>();
+  if (body.contains("start_where"))
+    pipeline.start_where = parse_property_predicates(body["start_where"]);
+  if (body.contains("steps")) {
+    if (!body["steps"].is_array())
+      throw std::invalid_argument("steps 必须是数组");
+    for (const auto &step : body["steps"]) {
+      if (!step.is_object())
+        throw std::invalid_argument("steps 的每一项必须是对象");
+      if (step.contains("expand")) {
+        json filter = {{"direction", step["expand"]}};
+        if (step.contains("labels"))
+          filter["labels"] = step["labels"];
+        graph::TraversalStep expand;
+        expand.filter = parse_traversal_filter(filter);
+        pipeline.steps.push_back(std::move(expand));
+      } else if (step.contains("where")) {
+        pipeline.Where(parse_property_predicates(step["where"]));
+      } else if (step.contains("limit")) {
+        pipeline.Limit(step["limit"].get<size_t>());
+      } else {
+        throw std::invalid_argument("step 只能是 expand / where / limit");
+      }
+    }
+  }
+  if (body.contains("as_of"))
+    pipeline.as_of = body["as_of"].get<int64_t>();
+  pipeline.projection = parse_projection(body);
+  pipeline.batch_size = body.value("batch_size", pipeline.batch_size);
+  return pipeline;
+}
+
+graph::Projection HttpServer::parse_projection(const json &body) {
+  if (body.value("ids_only", false))
+    return graph::Projection::IdsOnly();
+  if (body.contains("fields"))
+    return graph::Projection::Fields(
+        body["fields"].get<std::vector<std::string>>());
+  return {};
+}
+
+bool HttpServer::is_binary_vector(const httplib::Request &req) {
+  return req.get_header_value("Content-Type").rfind(kOctetStream, 0) == 0;
+}
+
+VectorDtype HttpServer::parse_vector_dtype(const httplib::Request &req) {
+  std::string dtype = req.get_header_value("X-Vector-Dtype", "fp32");
+  if (dtype == "fp32") {
+    return VectorDtype::FP32;
+  }
+  if (dtype == "fp16") {
+    return VectorDtype::FP16;
+  }
+  throw std::invalid_argument("X-Vector-Dtype 必须是 fp32 / fp16");
+}
+
+size_t HttpServer::parse_binary_vector(const httplib::Request &req,
+                                       VectorDtype dtype) {
+  std::string header = req.get_header_value("X-Vector-Dimension");
+  size_t dimension = 0;
+  auto [ptr, ec] = std::from_chars(header.data(),
+                                   header.data() + header.size(), dimension);
+  if (header.empty() || ec != std::errc() ||
+      ptr != header.data() + header.size() || dimension == 0) {
+    throw std::invalid_argument("缺少或非法的请求头：X-Vector-Dimension");
+  }
+  size_t element = dtype == VectorDtype::FP16 ? 2 : sizeof(float);
+  if (req.body.size() / element != dimension ||
+      req.body.size() % element != 0) {
+    throw std::invalid_argument("请求体长度与 X-Vector-Dimension 不一致");
+  }
+  return dimension;
+}
+
+int64_t HttpServer::int_param(const httplib::Request &req, const char *name,
+                              int64_t def) {
+  if (!req.has_param(name)) {
+    return def;
+  }
+  std::string value = req.get_param_value(name);
+  int64_t out = 0;
+  auto [ptr, ec] =
+      std::from_chars(value.data(), value.data() + value.size(), out);
+  if (value.empty() || ec != std::errc() ||
+      ptr != value.data() + value.size()) {
+    throw std::invalid_argument(std::string("查询参数 ") + name +
+                                " 必须是整数");
+  }
+  return out;
+}
+
+const json &HttpServer::batch_array(const json &body, const char *field) {
+  auto it = body.find(field);
+  if (it == body.end() || !it->is_array()) {
+    throw std::invalid_argument(std::string("缺少必填数组字段：") + field);
+  }
+  if (it->size() > kMaxBatchSize) {
+    throw std::invalid_argument(std::string(field) + " 超过单次批量上限 " +
+                                std::to_string(kMaxBatchSize));
+  }
+  return *it;
+}
+
+bool HttpServer::wants_stream(const httplib::Request &req, const json &body) {
+  return body.value("stream", false) ||
+         req.get_header_value("Accept").find(kNdjson) != std::string::npos;
+}
+
+db::ScanCursor HttpServer::parse_scan_cursor(const std::string &text) {
+  db::ScanCursor cursor;
+  if (text == "0")
+    return cursor;
+  size_t *fields[] = {&cursor.shard, &cursor.bucket, &cursor.bucket_count};
+  const char *p = text.data();
+  const char *end = text.data() + text.size();
+  for (size_t i = 0; i < 3; ++i) {
+    if (i > 0 && (p == end || *p++ != '-'))
+      throw std::invalid_argument("非法的游标：" + text);
+    auto [next, ec] = std::from_chars(p, end, *fields[i]);
+    if (ec != std::errc() || next == p)
+      throw std::invalid_argument("非法的游标：" + text);
+    p = next;
+  }
+  if (p != end)
+    throw std::invalid_argument("非法的游标：" + text);
+  return cursor;
+}
+
+std::string HttpServer::format_scan_cursor(const db::ScanCursor &cursor) {
+  if (cursor.done)
+    return "0";
+  return std::to_string(cursor.shard) + "-" + std::to_string(cursor.bucket) +
+         "-" + std::to_string(cursor.bucket_count);
+}
+
 void HttpServer::send_error(httplib::Response &res, int status_code,
                             const std::string &message) {
   // [统一错误格式] {"success": false, "error": "<message>"}
-  json response = {{"success", false}, {"error", message}};
+  std::string out;
+  JsonWriter(out)
+      .begin_object()
+      .field("success", false)
+      .field("error", message)
+      .end_object();
   res.status = status_code;
-  res.set_content(response.dump(), "application/json");
+  res.set_content(std::move(out), "application/json");
 }
 
 void HttpServer::send_success(httplib::Response &res, const json &data) {
@@ -357,6 +1270,41 @@ void HttpServer::send_success(httplib::Response &res, const json &data) {
   res.set_content(data.dump(), "application/json");
 }
 
+void HttpServer::send_json(httplib::Response &res, std::string &&body) {
+  res.status = 200;
+  res.set_content(std::move(body), "application/json");
+}
+
+void HttpServer::send_vector_put(httplib::Response &res,
+                                 const std::string &key, size_t dimension) {
+  std::string out;
+  JsonWriter(out)
+      .begin_object()
+      .field("success", true)
+      .field("message", "向量写入成功")
+      .field("key", key)
+      .field("dimension", dimension)
+      .end_object();
+  send_json(res, std::move(out));
+}
+
+void HttpServer::send_vector_search(httplib::Response &res,
+                                    size_t query_dimension, int64_t top_k,
+                                    const std::vector<std::string> &keys,
+                                    bool partial) {
+  std::string out;
+  JsonWriter w(out);
+  w.begin_object().field("success", true);
+  if (partial)
+    w.field("partial", true);
+  w.field("query_dimension", query_dimension)
+      .field("top_k", top_k)
+      .field("results_count", keys.size())
+      .field("results", keys)
+      .end_object();
+  send_json(res, std::move(out));
+}
+
 // ==========================================
 // 图接口处理器
 // ==========================================
@@ -382,7 +1330,13 @@ void HttpServer::handle_graph_add_node(const httplib::Request &req,
       graph_store_->SetNodeEmbedding(node.node_id, emb);
     }
 
-    send_success(res, {{"success", true}, {"node_id", node.node_id}});
+    std::string out;
+    JsonWriter(out)
+        .begin_object()
+        .field("success", true)
+        .field("node_id", node.node_id)
+        .end_object();
+    send_json(res, std::move(out));
   } catch (const json::exception &e) {
     send_error(res, 400, std::string("JSON 解析错误：") + e.what());
   } catch (const std::exception &e) {
@@ -407,53 +1361,461 @@ void HttpServer::handle_graph_add_edge(const httplib::Request &req,
     edge.weight = body.value("weight", 1.0f); // 边权重，默认 1.0
     edge.properties_json =
         body.value("properties_json", "{}"); // 边属性，默认空对象
+    // 有效期 [valid_from, valid_to)，默认不限
+    edge.valid_from = body.value("valid_from", graph::VALID_FROM_ALWAYS);
+    edge.valid_to = body.value("valid_to", graph::VALID_TO_FOREVER);
     graph_store_->AddEdge(edge);
 
-    send_success(res, {{"success", true},
-                       {"src_id", edge.src_id},
-                       {"dst_id", edge.dst_id},
-                       {"label", edge.label}});
+    std::string out;
+    JsonWriter(out)
+        .begin_object()
+        .field("success", true)
+        .field("src_id", edge.src_id)
+        .field("dst_id", edge.dst_id)
+        .field("label", edge.label)
+        .end_object();
+    send_json(res, std::move(out));
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_graph_add_nodes(const httplib::Request &req,
+                                        httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    const json &items = batch_array(body, "nodes");
+
+    std::vector<graph::Node> nodes;
+    std::vector<std::pair<std::string, std::vector<float>>> embeddings;
+    std::string out;
+    JsonWriter w(out);
+    w.begin_object().field("success", true).field("count", items.size());
+    w.key("results").begin_array();
+    size_t failed = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      try {
+        const json &item = items[i];
+        graph::Node node;
+        node.node_id = item.at("node_id");
+        node.properties_json = item.value("properties_json", "{}");
+        if (item.contains("embedding")) {
+          embeddings.emplace_back(node.node_id,
+                                  item["embedding"].get<std::vector<float>>());
+        }
+        begin_batch_item(w, i).field("node_id", node.node_id).end_object();
+        nodes.push_back(std::move(node));
+      } catch (const json::exception &e) {
+        batch_error(w, i, e.what());
+        ++failed;
+      }
+    }
+    graph_store_->AddNodes(nodes);
+    for (const auto &[node_id, emb] : embeddings)
+      graph_store_->SetNodeEmbedding(node_id, emb);
+
+    w.end_array().field("failed", failed).end_object();
+    send_json(res, std::move(out));
   } catch (const json::exception &e) {
     send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
   } catch (const std::exception &e) {
     send_error(res, 500, std::string("内部错误：") + e.what());
   }
 }
 
+void HttpServer::handle_graph_add_edges(const httplib::Request &req,
+                                        httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    const json &items = batch_array(body, "edges");
+
+    std::vector<graph::Edge> edges;
+    std::string out;
+    JsonWriter w(out);
+    w.begin_object().field("success", true).field("count", items.size());
+    w.key("results").begin_array();
+    size_t failed = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      try {
+        const json &item = items[i];
+        graph::Edge edge;
+        edge.src_id = item.at("src_id");
+        edge.dst_id = item.at("dst_id");
+        edge.label = item.at("label");
+        edge.weight = item.value("weight", 1.0f);
+        edge.properties_json = item.value("properties_json", "{}");
+        edge.valid_from = item.value("valid_from", graph::VALID_FROM_ALWAYS);
+        edge.valid_to = item.value("valid_to", graph::VALID_TO_FOREVER);
+        // 与 AddEdge 相同的校验在这里逐项做，非法项不进入批量写入
+        if (edge.valid_from >= edge.valid_to) {
+          batch_error(w, i, "edge valid_from must be < valid_to");
+          ++failed;
+          continue;
+        }
+        begin_batch_item(w, i)
+            .field("src_id", edge.src_id)
+            .field("dst_id", edge.dst_id)
+            .field("label", edge.label)
+            .end_object();
+        edges.push_back(std::move(edge));
+      } catch (const json::exception &e) {
+        batch_error(w, i, e.what());
+        ++failed;
+      }
+    }
+    graph_store_->AddEdges(edges);
+
+    w.end_array().field("failed", failed).end_object();
+    send_json(res, std::move(out));
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+/**
+ * 结束 GraphRAG 响应：w 已向 out 写好除 nodes 以外的字段（对象未闭合）
+ *
+ * 流式时这些字段闭合后单独作为首行，节点逐行发送；否则接着写 nodes
+ * 数组并一次发出。
+ */
+template <typename T, typename F>
+static void send_graph_nodes(httplib::Response &res, std::string &out,
+                             JsonWriter &w, bool stream, std::vector<T> nodes,
+                             F write_item) {
+  if (stream) {
+    w.end_object();
+    out += '\n';
+    send_ndjson(res, std::move(out), std::move(nodes), write_item);
+    return;
+  }
+  w.key("nodes").begin_array();
+  for (const auto &n : nodes)
+    write_item(w, n);
+  w.end_array().end_object();
+  res.status = 200;
+  res.set_content(std::move(out), "application/json");
+}
+
 void HttpServer::handle_graph_rag_query(const httplib::Request &req,
                                         httplib::Response &res) {
   try {
     json body = json::parse(req.body);
-    if (!body.contains("query_embedding")) {
+    // 混合模式只带 query_text 时可以不提供 embedding（退化为关键词检索）
+    if (!body.contains("query_embedding") && !body.contains("query_text")) {
       send_error(res, 400, "缺少必填字段：query_embedding");
       return;
     }
 
-    std::vector<float> query_emb = body["query_embedding"];
+    std::vector<float> query_emb =
+        body.value("query_embedding", std::vector<float>{});
     int vector_top_k =
         body.value("vector_top_k", 3); // 向量检索阶段返回的入口节点数
     int hop_depth = body.value("hop_depth", 2); // BFS 图遍历的最大跳数
+    // 按边标签 / 方向限定扩展范围，过滤在邻接表条目上完成
+    graph::TraversalFilter filter = parse_traversal_filter(body);
+    // 只返回 ID 或部分属性字段，避免大属性 blob 的拷贝和序列化
+    graph::Projection projection = parse_projection(body);
+    const bool stream = wants_stream(req, body);
+    RequestDeadline deadline = parse_request_deadline(req, &body);
+    if (reject_expired(res, deadline))
+      return;
+    auto write_node = [](JsonWriter &w, const graph::Node &n) {
+      w.begin_object()
+          .field("node_id", n.node_id)
+          .field("properties_json", n.properties_json)
+          .end_object();
+    };
+    // 各模式共有的响应字段，写完后 out 中是一个未闭合的对象
+    std::string out;
+    JsonWriter w(out);
+    // 超时且不允许部分结果时回 504 并返回 false，否则写响应开头
+    auto begin_response = [&](size_t node_count) {
+      if (reject_expired(res, deadline))
+        return false;
+      w.begin_object().field("success", true);
+      if (deadline.expired())
+        w.field("partial", true);
+      w.field("node_count", node_count)
+          .field("vector_top_k", vector_top_k)
+          .field("hop_depth", hop_depth);
+      return true;
+    };
+
+    // [排序模式] 个性化 PageRank，按相关性返回 top_n 个节点及得分
+    if (body.value("ranked", false)) {
+      graph::GraphRAGOptions opts;
+      opts.vector_top_k = vector_top_k;
+      opts.hop_depth = hop_depth;
+      opts.top_n = body.value("top_n", opts.top_n);
+      opts.residual_tolerance =
+          body.value("residual_tolerance", opts.residual_tolerance);
+      // 自带时间预算的模式：预算收紧到请求截止时间之前
+      opts.time_budget = deadline.clamp(
+          std::chrono::milliseconds(body.value("time_budget_ms", 0)));
+      opts.filter = filter;
+      opts.projection = projection;
+      auto ranked = graph_store_->GraphRAGQueryRanked(query_emb, opts);
+
+      if (!begin_response(ranked.nodes.size()))
+        return;
+      w.field("pushes", ranked.pushes).field("converged", ranked.converged);
+      auto write_scored = [](JsonWriter &w, const auto &sn) {
+        w.begin_object()
+            .field("node_id", sn.node.node_id)
+            .field("properties_json", sn.node.properties_json)
+            .field("score", sn.score)
+            .end_object();
+      };
+      send_graph_nodes(res, out, w, stream,
+                       std::move(ranked.nodes), write_scored);
+      return;
+    }
+
+    // [有界模式] 扇出采样 + 结果上限 + 截止时间，返回截断统计
+    graph::GraphRAGBudget budget;
+    if (parse_graphrag_budget(body, budget)) {
+      budget.deadline = deadline.clamp(budget.deadline);
+      auto bounded = graph_store_->GraphRAGQueryBounded(
+          query_emb, vector_top_k, hop_depth, budget, filter, projection);
+
+      if (!begin_response(bounded.nodes.size()))
+        return;
+      w.key("truncation")
+          .begin_object()
+          .field("hops_completed", bounded.hops_completed)
+          .field("fanout_sampled_nodes", bounded.fanout_sampled_nodes)
+          .field("fanout_dropped_edges", bounded.fanout_dropped_edges)
+          .field("result_truncated", bounded.result_truncated)
+          .field("deadline_exceeded", bounded.deadline_exceeded)
+          .end_object();
+      send_graph_nodes(res, out, w, stream,
+                       std::move(bounded.nodes), write_node);
+      return;
+    }
+
+    // [混合模式] 向量 + BM25 关键词检索，倒数排名融合（RRF）选入口节点
+    if (body.contains("query_text")) {
+      if (!graph_store_->KeywordIndexEnabled()) {
+        send_error(res, 400,
+                   "关键词索引未启用（GraphStore::EnableKeywordIndex）");
+        return;
+      }
+      graph::HybridSearchOptions opts;
+      opts.entry_top_k = vector_top_k;
+      opts.candidate_k = body.value("candidate_k", opts.candidate_k);
+      opts.rrf_k = body.value("rrf_k", opts.rrf_k);
+      auto hybrid = graph_store_->GraphRAGQueryHybrid(
+          query_emb, body["query_text"].get<std::string>(), hop_depth, opts,
+          filter, projection, deadline.token);
+
+      if (!begin_response(hybrid.nodes.size()))
+        return;
+      w.key("entries").begin_array();
+      for (const auto &e : hybrid.entries) {
+        w.begin_object()
+            .field("node_id", e.node_id)
+            .field("score", e.score)
+            .field("vector_rank", e.vector_rank)
+            .field("keyword_rank", e.keyword_rank)
+            .end_object();
+      }
+      w.end_array();
+      send_graph_nodes(res, out, w, stream,
+                       std::move(hybrid.nodes), write_node);
+      return;
+    }
 
     // [两阶段 GraphRAG]
     // 第一阶段：向量检索，找到语义最近的 vector_top_k 个入口节点
     // 第二阶段：从入口节点出发做 hop_depth 跳 BFS，收集所有可达节点
-    auto nodes =
-        graph_store_->GraphRAGQuery(query_emb, vector_top_k, hop_depth);
+    auto nodes = graph_store_->GraphRAGQuery(
+        query_emb, vector_top_k, hop_depth, filter, projection, deadline.token);
+
+    if (!begin_response(nodes.size()))
+      return;
+    send_graph_nodes(res, out, w, stream, std::move(nodes),
+                     write_node);
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_graph_shortest_path(const httplib::Request &req,
+                                            httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    if (!body.contains("src_id") || !body.contains("dst_id")) {
+      send_error(res, 400, "缺少必填字段：src_id, dst_id");
+      return;
+    }
+
+    std::string src_id = body["src_id"];
+    std::string dst_id = body["dst_id"];
+    std::string algorithm = body.value("algorithm", "dijkstra");
+
+    graph::WeightedPath wp;
+    if (algorithm == "dijkstra") {
+      wp = graph_store_->FindWeightedPath(src_id, dst_id);
+    } else if (algorithm == "astar") {
+      wp = graph_store_->FindWeightedPathAStar(
+          src_id, dst_id, body.value("heuristic_scale", 1.0f));
+    } else {
+      send_error(res, 400, "未知的 algorithm：" + algorithm);
+      return;
+    }
+
+    send_success(res, {{"success", true},
+                       {"reachable", !wp.path.empty()},
+                       {"path", wp.path},
+                       {"cost", wp.cost},
+                       {"expanded", wp.expanded},
+                       {"algorithm", algorithm}});
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::domain_error &e) {
+    // 请求本身合法，但图中的边权不满足最短路前提（负权 / NaN）
+    send_error(res, 422, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_graph_cache_stats(const httplib::Request &,
+                                          httplib::Response &res) {
+  auto stats = graph_store_->QueryCacheStats();
+  send_success(res, {{"success", true},
+                     {"hits", stats.hits},
+                     {"misses", stats.misses},
+                     {"stale", stats.stale},
+                     {"inserts", stats.inserts},
+                     {"evictions", stats.evictions},
+                     {"entries", stats.entries},
+                     {"hit_rate", stats.hit_rate()}});
+}
+
+void HttpServer::handle_graph_degree_stats(const httplib::Request &req,
+                                           httplib::Response &res) {
+  auto h = graph_store_->DegreeStats();
+  json body = {{"success", true},
+               {"nodes", h.nodes},
+               {"edges", h.edges},
+               {"max_out", h.max_out},
+               {"max_in", h.max_in},
+               {"paged_lists", h.paged_lists},
+               {"out_buckets", h.out},
+               {"in_buckets", h.in}};
+  if (req.has_param("node_id")) {
+    auto d = graph_store_->GetDegree(req.get_param_value("node_id"));
+    body["node"] = {{"out", d.out}, {"in", d.in}};
+  }
+  send_success(res, body);
+}
+
+void HttpServer::handle_graph_property_index(const httplib::Request &req,
+                                             httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    if (!body.contains("field")) {
+      send_error(res, 400, "缺少必填字段：field");
+      return;
+    }
+    std::string type = body.value("type", "hash");
+    graph::PropertyIndexType index_type;
+    if (type == "hash") {
+      index_type = graph::PropertyIndexType::HASH;
+    } else if (type == "ordered") {
+      index_type = graph::PropertyIndexType::ORDERED;
+    } else {
+      send_error(res, 400, "type 必须是 hash / ordered");
+      return;
+    }
+    graph_store_->CreatePropertyIndex(body["field"].get<std::string>(),
+                                      index_type);
+
+    json indexes = json::array();
+    for (const auto &info : graph_store_->ListPropertyIndexes()) {
+      indexes.push_back(
+          {{"field", info.field},
+           {"type", info.type == graph::PropertyIndexType::HASH ? "hash"
+                                                                 : "ordered"},
+           {"entries", info.entries}});
+    }
+    send_success(res, {{"success", true}, {"indexes", indexes}});
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_graph_find_nodes(const httplib::Request &req,
+                                         httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    if (!body.contains("where")) {
+      send_error(res, 400, "缺少必填字段：where");
+      return;
+    }
+    auto nodes = graph_store_->FindNodesByProperties(
+        parse_property_predicates(body["where"]), parse_projection(body));
 
-    // 将节点列表序列化为 JSON 数组
     json nodes_json = json::array();
     for (const auto &n : nodes) {
       nodes_json.push_back(
           {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
     }
-
     send_success(res, {{"success", true},
                        {"node_count", nodes.size()},
-                       {"vector_top_k", vector_top_k},
-                       {"hop_depth", hop_depth},
                        {"nodes", nodes_json}});
   } catch (const json::exception &e) {
     send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
+  } catch (const std::exception &e) {
+    send_error(res, 500, std::string("内部错误：") + e.what());
+  }
+}
+
+void HttpServer::handle_graph_traverse(const httplib::Request &req,
+                                       httplib::Response &res) {
+  try {
+    json body = json::parse(req.body);
+    auto result = graph_store_->Traverse(parse_traversal_pipeline(body));
+
+    json nodes_json = json::array();
+    for (const auto &n : result.nodes) {
+      nodes_json.push_back(
+          {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
+    }
+    const auto &st = result.stats;
+    send_success(res, {{"success", true},
+                       {"node_count", result.nodes.size()},
+                       {"nodes", nodes_json},
+                       {"stats",
+                        {{"batches", st.batches},
+                         {"nodes_expanded", st.nodes_expanded},
+                         {"neighbors_scanned", st.neighbors_scanned},
+                         {"nodes_filtered", st.nodes_filtered},
+                         {"filters_pushed_down", st.filters_pushed_down},
+                         {"limit_reached", st.limit_reached}}}});
+  } catch (const json::exception &e) {
+    send_error(res, 400, std::string("JSON 解析错误：") + e.what());
+  } catch (const std::invalid_argument &e) {
+    send_error(res, 400, e.what());
   } catch (const std::exception &e) {
     send_error(res, 500, std::string("内部错误：") + e.what());
   }
@@ -1,16 +1,20 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <thread>
+#include <unordered_map>
 
+#include "../base/thread_pool.h"
 #include "../core/minkv.h"
 #include "../graph/graph_store.h"
 #include "../vector/vector_ops.h"
-#include "../vector/vector_value.h"
+#include "admission.h"
 #include "httplib.h"
+#include "request_deadline.h"
 
 namespace minkv {
 namespace server {
@@ -29,6 +33,49 @@ enum class DistanceMetric {
   DOT_PRODUCT ///< 点积（预留）
 };
 
+/**
+ * @brief 二进制向量传输的元素类型（请求头 X-Vector-Dtype）
+ *
+ * 字节序为小端，与存储格式相同；fp16 在服务端与 fp32 互相转换，
+ * 存储中始终是 fp32。
+ */
+enum class VectorDtype {
+  FP32, ///< 4 字节单精度（默认，写入时字节直接入库）
+  FP16  ///< 2 字节半精度，传输体积减半
+};
+
+/**
+ * @brief HTTP 准入控制配置（HttpServer::set_admission_options）
+ *
+ * [两层限流]
+ * 1. 连接层：httplib 每个连接占用一个工作线程直到断开（keep-alive 连接
+ *    一直占着），线程用完后新连接在队列里等；队列满时 httplib 直接关闭
+ *    新连接，这一层无法回 503
+ * 2. 端点层：每个端点一个 AdmissionLimiter，超过并发上限的请求排队，
+ *    队列满或排队超时立即回 503 + Retry-After
+ *
+ * 端点分为便宜（KV、点查、写入）和昂贵（向量检索、GraphRAG、图遍历、
+ * 建索引）两类，默认分别用 cheap / expensive 的限制，endpoints 按路径
+ * 单独覆盖。昂贵端点在独立线程池中执行，池大小即昂贵操作的全局并发
+ * 上限，它们再多也不会占满 CPU、拖慢便宜端点。
+ */
+struct HttpAdmissionOptions {
+  bool enabled = true; // false 时不做端点级限流，也不用独立线程池
+  // 连接处理线程数，0 表示 httplib 默认（max(8, 核数 - 1)）；
+  // 动态扩容到 max_worker_threads，0 表示 worker_threads 的 4 倍
+  size_t worker_threads = 0;
+  size_t max_worker_threads = 0;
+  // 等待工作线程的连接数上限，超过直接关闭连接；0 表示不限
+  size_t max_queued_connections = 1024;
+  size_t expensive_threads = 0; // 昂贵端点的线程池大小，0 表示 CPU 核数
+  int retry_after_s = 1;        // 503 响应的 Retry-After 头
+  // 便宜端点：固定上限，不自适应（耗时主要是排队和网络，不反映负载）
+  AdmissionLimits cheap = {256, 16, 1024, 512, 100, 0};
+  // 昂贵端点：处理耗时超过 100ms 时 AIMD 收缩并发上限
+  AdmissionLimits expensive = {8, 1, 64, 64, 200, 100};
+  std::map<std::string, AdmissionLimits> endpoints; // 按路径覆盖，如 "/kv/get"
+};
+
 /**
  * @brief MinKV HTTP 服务器
  *
@@ -40,21 +87,51 @@ enum class DistanceMetric {
  *   POST   /kv/set      写入键值对（支持 TTL 过期）
  *   GET    /kv/get      按 key 精确读取
  *   DELETE /kv/del      删除指定 key
+ *   POST   /kv/mget     批量读取
+ *   POST   /kv/mset     批量写入
+ *   POST   /kv/mdel     批量删除
+ *   GET    /kv/scan     游标遍历，NDJSON 流式返回
  * - 向量接口：情景记忆的语义存取，支持近似最近邻检索
  *   POST   /vector/put      插入向量及元数据
  *   POST   /vector/search   向量相似度搜索
  *   GET    /vector/get      按 key 获取向量
  *   DELETE /vector/delete   删除向量
+ *   POST   /vector/mput     批量插入向量
+ *   POST   /vector/msearch  批量相似度搜索
+ *   put / search 的请求体和 get 的响应体也可以是 application/octet-stream
+ *   原始向量字节，维度放在 X-Vector-Dimension 头里，省去 JSON 浮点数组的
+ *   文本编解码
  * - 图接口：知识图谱与 GraphRAG 多跳推理
  *   POST   /graph/add_node  添加图节点
  *   POST   /graph/add_edge  添加有向边
+ *   POST   /graph/add_nodes 批量添加节点
+ *   POST   /graph/add_edges 批量添加有向边
  *   POST   /graph/rag_query GraphRAG 查询（向量检索 + K 跳 BFS 展开）
+ *   POST   /graph/shortest_path 带权最短路径（Dijkstra / A*）
+ * 另有 GET /health 探活和 GET /stats/admission 准入控制统计，两者不限流。
  *
  * 设计原则：
  * - [RAII] 服务器生命周期由构造/析构函数管理，资源自动释放
  * - [线程安全] 所有端点均线程安全，running_ 使用原子变量保护
  * - [错误处理] 统一使用 send_error/send_success 封装 HTTP 状态码与 JSON 响应
  * - [可选图支持] graph_store_ 为 nullptr 时图端点不注册，向量端点仍正常工作
+ * - [流式响应] /kv/scan 和带 "stream": true 的 /graph/rag_query 以 chunked
+ *   编码逐块发送 NDJSON（application/x-ndjson，每行一个 JSON 对象），
+ *   不在内存里拼出完整的 JSON 文档和响应字符串，首字节也更早发出
+ * - [批量接口] m* / add_nodes / add_edges 一个请求携带一组操作，内部按分片
+ *   分组执行，响应中 results 与请求数组一一对应；单项格式错误只让这一项
+ *   失败（success: false），整体仍返回 200，失败项数见 failed
+ * - [响应编码] KV / 向量 / GraphRAG 等热点端点用 JsonWriter 直接把响应
+ *   写进字符串，不构造 nlohmann::json；nlohmann 只用于解析请求体和
+ *   统计类端点的响应
+ * - [准入控制] 每个端点有并发上限和有界等待队列，过载时快速返回 503 而
+ *   不是无限堆积；昂贵端点在独立线程池中执行并按耗时自适应调整上限，
+ *   见 HttpAdmissionOptions，各端点的排队与拒绝计数在 GET /stats/admission
+ * - [截止时间] /vector/search、/vector/msearch、/graph/rag_query 接受请求头
+ *   X-Timeout-Ms 或请求体 "timeout_ms"，超时后检索和图扩展在分块 / 每跳
+ *   边界停止并释放线程，返回 504；允许部分结果时（X-Allow-Partial: true
+ *   或 "allow_partial": true）返回已算出的结果并带 "partial": true，
+ *   见 RequestDeadline
  *
  * @note 依赖 cpp-httplib（单头文件）和 nlohmann/json
  */
@@ -64,7 +141,9 @@ public:
    * @brief 构造 HTTP 服务器
    * @param kv          MinKV 存储引擎实例，提供 KV 与向量操作能力
    * @param graph_store 图存储实例（可为 nullptr，为空时不注册图端点）
-   * @param host        监听地址，默认 "0.0.0.0" 监听所有网卡
+   * @param host        监听地址，默认 "0.0.0.0" 监听所有网卡；
+   *                    "unix:<路径>" 表示监听 Unix domain socket（同机
+   *                    客户端，省掉 TCP 回环），此时忽略 port
    * @param port        监听端口，默认 8080
    *
    * [初始化流程] 构造时调用 setup_routes() 完成所有路由注册，
@@ -129,6 +208,19 @@ public:
    */
   int port() const { return port_; }
 
+  /**
+   * @brief 设置准入控制，须在 start() / start_async() 之前调用
+   * @return 服务器已在运行时不生效，返回 false
+   * @throws std::invalid_argument 某个端点的限制不合法
+   *
+   * 重建各端点的 AdmissionLimiter（计数清零）和昂贵端点线程池；
+   * 构造时已按默认 HttpAdmissionOptions 设置过一次。
+   */
+  bool set_admission_options(const HttpAdmissionOptions &options);
+
+  /** @brief 各端点的准入统计，按路径排序（未启用准入控制时为空） */
+  std::map<std::string, AdmissionStats> admission_stats() const;
+
 private:
   std::shared_ptr<MinKV<std::string, std::string>>
       kv_; ///< MinKV 存储引擎，提供 KV、向量、持久化能力
@@ -141,6 +233,29 @@ private:
   std::atomic<bool> running_; ///< 运行状态标志，原子操作保证可见性
   std::unique_ptr<std::thread> server_thread_; ///< 异步模式下的后台线程
 
+  /** @brief 端点开销分类，决定默认限制和执行线程 */
+  enum class Cost { Cheap, Expensive };
+  using Handler = void (HttpServer::*)(const httplib::Request &,
+                                       httplib::Response &);
+
+  HttpAdmissionOptions admission_;            ///< 当前准入配置
+  std::map<std::string, Cost> endpoint_cost_; ///< 限流端点，setup_routes 填
+  /// 每个限流端点一个，start() 之后只读，请求线程查表不加锁
+  std::unordered_map<std::string, std::unique_ptr<AdmissionLimiter>>
+      limiters_;
+  std::unique_ptr<base::ThreadPool> expensive_pool_; ///< 昂贵端点的执行线程
+  std::atomic<size_t> queued_connections_{0};        ///< 等待工作线程的连接数
+  std::atomic<uint64_t> rejected_connections_{0};    ///< 因连接队列满被关闭
+
+  /** @brief host 为 "unix:<路径>" 时返回路径，否则返回空串 */
+  std::string unix_path() const;
+
+  /** @brief 日志里显示的监听地址："host:port" 或 "unix:<路径>" */
+  std::string endpoint() const;
+
+  /** @brief 按 host 在 TCP 或 Unix domain socket 上进入事件循环（阻塞） */
+  bool listen();
+
   /**
    * @brief 注册所有 HTTP 路由
    *
@@ -149,9 +264,59 @@ private:
    * 2. 向量接口（/vector/*）
    * 3. 健康检查（/health）
    * 4. 图接口（/graph/*，仅当 graph_store_ 非空时注册）
+   * 5. 准入统计（/stats/admission）
    */
   void setup_routes();
 
+  /**
+   * @brief 注册一个限流端点
+   *
+   * 请求先向该路径的 AdmissionLimiter 申请名额，拿不到时回 503；
+   * 昂贵端点拿到名额后提交到 expensive_pool_ 执行，httplib 工作线程等它
+   * 完成（handler 引用的 req / res 在此期间一直有效）。
+   * handler 设置了 chunked content provider 时，名额一直占到响应发送完，
+   * 记入限流器的耗时也包括发送时间。
+   */
+  void route(const std::string &method, const std::string &path, Cost cost,
+             Handler handler);
+
+  /** @brief 按 admission_ 和 endpoint_cost_ 重建限流器和线程池 */
+  void apply_admission();
+
+  /**
+   * @brief 请求已过截止时间且不允许部分结果时回 504 并返回 true
+   *
+   * 长查询在计算前后各调用一次：排队期间已超时的请求不再计算，
+   * 计算中途超时的请求不返回不完整的结果。
+   */
+  bool reject_expired(httplib::Response &res, const RequestDeadline &deadline);
+
+  /** @brief 申请名额失败：503 + Retry-After */
+  void send_overloaded(httplib::Response &res, const std::string &path,
+                       AdmissionLimiter::Result result);
+
+  /**
+   * @brief GET /stats/admission — 准入控制统计
+   *
+   * [响应]
+   * {
+   *   "success": true, "enabled": true,
+   *   "connections": {"worker_threads": 8, "max_worker_threads": 32,
+   *                   "queued": 0, "max_queued": 1024, "rejected": 0},
+   *   "expensive_threads": 8,
+   *   "endpoints": {
+   *     "/vector/search": {"cost": "expensive", "limit": 8, "in_flight": 3,
+   *                        "queued": 0, "max_queue": 64, "admitted": 1200,
+   *                        "rejected_queue_full": 0, "rejected_timeout": 2,
+   *                        "limit_decreases": 1, "avg_latency_ms": 12.5,
+   *                        "avg_queue_ms": 0.4},
+   *     ...
+   *   }
+   * }
+   */
+  void handle_admission_stats(const httplib::Request &req,
+                              httplib::Response &res);
+
   // ==========================================
   // KV 基础接口处理器
   // ==========================================
@@ -197,6 +362,77 @@ private:
    */
   void handle_kv_delete(const httplib::Request &req, httplib::Response &res);
 
+  /**
+   * @brief POST /kv/mget — 批量读取
+   *
+   * [请求体] {"keys": ["k1", "k2", ...]}
+   *
+   * [响应]
+   * {
+   *   "success": true, "count": 2,
+   *   "results": [{"key": "k1", "found": true, "value": "v1"},
+   *               {"key": "k2", "found": false}]
+   * }
+   *
+   * [性能] 底层 multiGet 按分片分组，N 个 key 最多加分片数次锁
+   */
+  void handle_kv_mget(const httplib::Request &req, httplib::Response &res);
+
+  /**
+   * @brief POST /kv/mset — 批量写入
+   *
+   * [请求体]
+   * {
+   *   "items": [{"key": "k1", "value": "v1", "ttl_ms": 5000}, ...],
+   *   "ttl_ms": 0      // 可选，单项未给出 ttl_ms 时使用，默认永不过期
+   * }
+   *
+   * [响应]
+   * {
+   *   "success": true, "count": 2, "failed": 1,
+   *   "results": [{"index": 0, "success": true, "key": "k1"},
+   *               {"index": 1, "success": false, "error": "..."}]
+   * }
+   *
+   * @note 按 ttl_ms 分组后每组一次 multiPut（WAL 一次加锁追加）；
+   *       同一 key 以不同 ttl_ms 出现多次时以哪一项为准不保证
+   */
+  void handle_kv_mset(const httplib::Request &req, httplib::Response &res);
+
+  /**
+   * @brief POST /kv/mdel — 批量删除
+   *
+   * [请求体] {"keys": ["k1", "k2", ...]}
+   *
+   * [响应] results 为 [{"key": "k1", "deleted": true}, ...]，
+   *   deleted 为 false 表示 key 不存在（单个删除时的 404）
+   */
+  void handle_kv_mdel(const httplib::Request &req, httplib::Response &res);
+
+  /**
+   * @brief GET /kv/scan — 游标遍历，NDJSON 流式返回
+   *
+   * [查询参数]
+   *   cursor=0        // 可选，上次响应末行的 cursor，"0" 表示从头开始
+   *   prefix=user:    // 可选，只返回以此开头的 key
+   *   count=1000      // 可选，每次加锁遍历的条目数（也是每块的大小）
+   *   limit=0         // 可选，本次最多返回的条目数，0 表示遍历到底；
+   *                   // 遍历按整个哈希桶推进，末页可能多出同一桶里的几条
+   *   keys_only=false // 可选，true 时不返回 value
+   *
+   * [响应] Transfer-Encoding: chunked，每行一个 JSON：
+   *   {"key": "user:1", "value": "..."}
+   *   ...
+   *   {"cursor": "3-512-1031", "count": 1000}   // 末行；cursor 为 "0" 表示
+   *                                              // 已遍历完，否则可续传
+   *
+   * [语义] 同 Redis SCAN：遍历期间一直存在的 key 至少返回一次，
+   *   可能重复；每块只持一个分片锁，不阻塞其他分片
+   * [准入] 按廉价端点限流，遍历在发送过程中进行，名额占到流结束为止
+   * 游标格式非法时返回 400（在开始发送之前）
+   */
+  void handle_kv_scan(const httplib::Request &req, httplib::Response &res);
+
   // ==========================================
   // 向量接口处理器
   // ==========================================
@@ -214,6 +450,13 @@ private:
    *
    * [响应] {"success": true, "key": "doc:001", "dimension": 1536}
    *
+   * [二进制请求] Content-Type: application/octet-stream
+   *   POST /vector/put?key=doc:001&ttl_ms=0
+   *   X-Vector-Dimension: 1536           // 必填，须与请求体长度一致
+   *   X-Vector-Dtype:     fp32 | fp16    // 可选，默认 fp32
+   *   请求体为小端原始向量；fp32 字节直接写入存储，fp16 逐个解码成
+   *   fp32 写入，都不经过 vector<float>
+   *
    * [应用场景] 将文本/图像 embedding 写入向量索引，用于后续语义检索
    */
   void handle_vector_put(const httplib::Request &req, httplib::Response &res);
@@ -224,17 +467,24 @@ private:
    * [请求体]
    * {
    *   "query": [0.1, 0.2, ...],  // 必填，查询向量
-   *   "top_k": 10                 // 必填，返回最相似的 k 个结果
+   *   "top_k": 10,                // 必填，返回最相似的 k 个结果
+   *   "timeout_ms": 50,           // 可选，截止时间（也可用 X-Timeout-Ms）
+   *   "allow_partial": false      // 可选，超时返回部分结果而不是 504
    * }
    *
    * [响应]
    * {
    *   "success": true,
+   *   "partial": true,            // 仅在超时返回部分结果时出现
    *   "query_dimension": 1536,
    *   "top_k": 10,
    *   "results": ["doc:001", "doc:002", ...]  // 仅返回 key 列表
    * }
    *
+   * [二进制请求] Content-Type: application/octet-stream
+   *   POST /vector/search?top_k=10，请求头同 /vector/put，响应仍为上面的 JSON；
+   *   fp32 查询向量直接指向请求体参与计算；截止时间只能用请求头
+   *
    * [性能] 底层使用 SIMD（AVX2）加速 L2 距离计算，微秒级延迟
    * @note 当前实现仅支持 L2 距离，返回结果按距离升序排列（最近邻在前）
    */
@@ -255,6 +505,10 @@ private:
    *   "timestamp": 1712345678000,
    *   "dimension": 1536
    * }
+   *
+   * [二进制响应] 请求头 Accept: application/octet-stream 时响应体为小端原始
+   *   向量，维度和类型在 X-Vector-Dimension / X-Vector-Dtype 响应头里；
+   *   请求头 X-Vector-Dtype: fp16 时按半精度返回
    */
   void handle_vector_get(const httplib::Request &req, httplib::Response &res);
 
@@ -271,6 +525,44 @@ private:
   void handle_vector_delete(const httplib::Request &req,
                             httplib::Response &res);
 
+  /**
+   * @brief POST /vector/mput — 批量插入向量
+   *
+   * [请求体]
+   * {
+   *   "items": [{"key": "doc:001", "embedding": [0.1, ...], "ttl_ms": 0},
+   *             ...],
+   *   "ttl_ms": 0      // 可选，单项未给出 ttl_ms 时使用
+   * }
+   *
+   * [响应] 格式同 /kv/mset，成功项带 "dimension"
+   */
+  void handle_vector_mput(const httplib::Request &req,
+                          httplib::Response &res);
+
+  /**
+   * @brief POST /vector/msearch — 批量相似度搜索
+   *
+   * [请求体]
+   * {
+   *   "queries": [[0.1, 0.2, ...], [0.3, ...]],  // 维度可以各不相同
+   *   "top_k": 10,
+   *   "timeout_ms": 50, "allow_partial": false   // 可选，同 /vector/search
+   * }
+   *
+   * [响应]
+   * {
+   *   "success": true, "count": 2, "top_k": 10,
+   *   "results": [{"success": true, "results": ["doc:001", ...]},
+   *               {"success": false, "error": "查询向量不能为空"}]
+   * }
+   *
+   * [性能] 每个分片只快照一次，所有查询共用（vectorSearchBatch），
+   *   而不是每个查询各扫描一遍全部分片
+   */
+  void handle_vector_msearch(const httplib::Request &req,
+                             httplib::Response &res);
+
   // ==========================================
   // 图接口处理器
   // ==========================================
@@ -302,8 +594,11 @@ private:
    *   "dst_id":          "bob",            // 必填，目标节点 ID
    *   "label":           "KNOWS",          // 必填，边类型标签
    *   "weight":          1.0,              // 可选，边权重，默认 1.0
-   *   "properties_json": "{}"              // 可选，边属性（JSON 字符串）
+   *   "properties_json": "{}",             // 可选，边属性（JSON 字符串）
+   *   "valid_from":      1700000000000,    // 可选，生效时刻（含），默认不限
+   *   "valid_to":        1800000000000     // 可选，失效时刻（不含），默认不限
    * }
+   * valid_from >= valid_to 时返回 400
    *
    * [响应] {"success": true, "src_id": "alice", "dst_id": "bob", "label":
    * "KNOWS"}
@@ -311,6 +606,32 @@ private:
   void handle_graph_add_edge(const httplib::Request &req,
                              httplib::Response &res);
 
+  /**
+   * @brief POST /graph/add_nodes — 批量添加节点
+   *
+   * [请求体] {"nodes": [{...}, ...]}，每项字段同 /graph/add_node
+   *
+   * [响应] 格式同 /kv/mset，成功项带 "node_id"
+   *
+   * @note 节点记录经 GraphStore::AddNodes 一次按分片写入
+   */
+  void handle_graph_add_nodes(const httplib::Request &req,
+                              httplib::Response &res);
+
+  /**
+   * @brief POST /graph/add_edges — 批量添加有向边
+   *
+   * [请求体] {"edges": [{...}, ...]}，每项字段同 /graph/add_edge
+   *
+   * [响应] 格式同 /kv/mset，成功项带 src_id / dst_id / label；
+   *   valid_from >= valid_to 的项单独失败，不影响其余各项
+   *
+   * @note GraphStore::AddEdges 按节点合并邻接表更新，
+   *       每个节点的出边 / 入边表各只做一次 read-modify-write
+   */
+  void handle_graph_add_edges(const httplib::Request &req,
+                              httplib::Response &res);
+
   /**
    * @brief POST /graph/rag_query — GraphRAG 混合查询
    *
@@ -324,8 +645,40 @@ private:
    * {
    *   "query_embedding": [0.1, 0.2, ...],  // 必填，查询向量
    *   "vector_top_k":    3,                // 可选，向量检索入口节点数，默认 3
-   *   "hop_depth":       2                 // 可选，BFS 跳数，默认 2
+   *   "hop_depth":       2,                // 可选，BFS 跳数，默认 2
+   *   "ranked":          false,            // 可选，true 时按个性化 PageRank
+   *                                        // 排序，每个节点附带 "score"
+   *   "top_n":           20,               // 可选，排序模式返回的节点数
+   *   "residual_tolerance": 1e-4,          // 可选，排序模式 push 残差阈值（> 0）
+   *   "time_budget_ms":  0,                // 可选，排序模式时间预算，0 不限
+   *   "labels":    ["WORKS_AT"],           // 可选，只沿这些标签的边扩展
+   *   "direction": "out",                  // 可选，"out" / "in" / "both"
+   *   "as_of":     1750000000000,          // 可选，只经过该时刻有效的边
+   *   "where": [{"field": "type", "value": "Person"}], // 可选，只经过满足
+   *                                        // 谓词的节点（字段需已建索引）
+   *   "max_fanout":  50,                   // 可选，每节点最多扩展的邻居数
+   *   "sampling":    "top_weight",         // 可选，"top_weight" / "reservoir"
+   *   "max_results": 500,                  // 可选，返回节点数上限
+   *   "deadline_ms": 20,                   // 可选，扩展阶段截止时间
+   *   "fields":   ["name"],                // 可选，只返回这些顶层属性字段
+   *   "ids_only": false,                   // 可选，true 时不返回属性
+   *   "query_text":  "X9000 参数",          // 可选，见下方混合模式
+   *   "candidate_k": 20,                   // 可选，混合模式每路候选数（> 0）
+   *   "rrf_k":       60,                   // 可选，混合模式 RRF 常数（>= 0）
+   *   "timeout_ms":  100,                  // 可选，整个请求的截止时间
+   *   "allow_partial": false               // 可选，超时返回部分结果
    * }
+   * 带 query_text 时走混合模式：向量检索与关键词 BM25 检索各取 candidate_k
+   * 个候选，按倒数排名融合后取 vector_top_k 个入口节点，此时 query_embedding
+   * 可省略；响应额外包含 "entries"（融合得分与两路名次）。需要 GraphStore
+   * 已调用 EnableKeywordIndex，否则返回 400。
+   * 带 max_fanout / max_results / deadline_ms 任一字段时走有界扩展，
+   * 响应额外包含 "truncation" 对象（hops_completed、fanout_sampled_nodes、
+   * fanout_dropped_edges、result_truncated、deadline_exceeded）。
+   * 带 timeout_ms（或请求头 X-Timeout-Ms）时，向量检索和每跳扩展在截止
+   * 时间到达后停止：默认返回 504，allow_partial 时返回已收集的节点并带
+   * "partial": true。排序 / 有界模式的 time_budget_ms / deadline_ms 会被
+   * 收紧到截止时间之前。
    *
    * [响应]
    * {
@@ -336,10 +689,118 @@ private:
    *     ...
    *   ]
    * }
+   *
+   * [流式响应] 请求体带 "stream": true 或请求头 Accept: application/x-ndjson
+   *   时以 chunked NDJSON 返回：首行是不含 "nodes" 的响应对象，
+   *   之后每行一个节点；节点在发送时才逐个序列化
    */
   void handle_graph_rag_query(const httplib::Request &req,
                               httplib::Response &res);
 
+  /**
+   * @brief POST /graph/shortest_path — 带权最短路径
+   *
+   * [原理] 以边的 weight 为长度做 Dijkstra；algorithm 为 "astar" 时
+   * 用节点 embedding 到终点 embedding 的 L2 距离（乘 heuristic_scale）
+   * 作为启发函数，减少扩展的节点数
+   *
+   * [请求体]
+   * {
+   *   "src_id":          "alice",     // 必填，起点
+   *   "dst_id":          "carol",     // 必填，终点
+   *   "algorithm":       "dijkstra",  // 可选，"dijkstra"（默认）或 "astar"
+   *   "heuristic_scale": 1.0          // 可选，A* 启发函数系数
+   * }
+   *
+   * [响应]
+   * {"success": true, "reachable": true, "path": ["alice", "bob", "carol"],
+   *  "cost": 2.5, "expanded": 7, "algorithm": "dijkstra"}
+   * 搜索经过负权或 NaN 权重的边时返回 422
+   */
+  void handle_graph_shortest_path(const httplib::Request &req,
+                                  httplib::Response &res);
+
+  /**
+   * @brief GET /graph/cache_stats — GraphRAG 查询缓存统计
+   *
+   * [原理] 缓存由 GraphStore::EnableQueryCache 启用，写操作递增版本号，
+   * 查找时版本不符的条目计入 stale 并丢弃
+   *
+   * [响应]
+   * {"success": true, "hits": 120, "misses": 30, "stale": 4,
+   *  "inserts": 30, "evictions": 0, "entries": 26, "hit_rate": 0.8}
+   */
+  void handle_graph_cache_stats(const httplib::Request &req,
+                                httplib::Response &res);
+
+  /**
+   * @brief GET /graph/degree_stats — 度数直方图
+   *
+   * [原理] 度数由邻接表写操作维护；out_buckets[i]（i ≥ 1）为度数落在
+   * [2^(i-1), 2^i) 的节点数，paged_lists 为已转为分页存储的超级节点邻接表数
+   *
+   * [参数] ?node_id=hub   可选，附带该节点的出度 / 入度
+   *
+   * [响应]
+   * {"success": true, "nodes": 1200, "edges": 5400, "max_out": 900,
+   *  "max_in": 12, "paged_lists": 0, "out_buckets": [...],
+   *  "in_buckets": [...], "node": {"out": 900, "in": 3}}
+   */
+  void handle_graph_degree_stats(const httplib::Request &req,
+                                 httplib::Response &res);
+
+  /**
+   * @brief POST /graph/property_index — 为节点属性字段建立二级索引
+   *
+   * [原理] 索引建立后由节点写操作在同一临界区内维护，查询与遍历过滤
+   * （"where"）直接查索引，不再全量导出
+   *
+   * [请求体] {"field": "age", "type": "ordered"}   // type: hash / ordered
+   * [响应]   {"success": true, "indexes": [{"field": "age",
+   *           "type": "ordered", "entries": 42}, ...]}
+   */
+  void handle_graph_property_index(const httplib::Request &req,
+                                   httplib::Response &res);
+
+  /**
+   * @brief POST /graph/find_nodes — 按属性谓词查找节点
+   *
+   * [请求体]
+   * {
+   *   "where": [{"field": "type", "op": "eq", "value": "Person"},
+   *             {"field": "age",  "op": "gt", "value": 30}],
+   *   "fields": ["name"], "ids_only": false,  // 可选，属性投影
+   *   "as_of": 1750000000000                  // 可选，只经过该时刻有效的边
+   * }
+   * 谓词字段必须已建立索引，否则返回 400；范围运算需要 ordered 索引。
+   *
+   * [响应] {"success": true, "node_count": 2, "nodes": [...]}
+   */
+  void handle_graph_find_nodes(const httplib::Request &req,
+                               httplib::Response &res);
+
+  /**
+   * @brief POST /graph/traverse — 服务端遍历管道
+   *
+   * [原理] 起点 → 扩展 / 过滤 / 截断 在服务端流式分批执行，
+   * 中间结果不经过 HTTP；紧跟扩展的过滤若谓词字段都有索引，
+   * 下推到邻接表扫描（见 GraphStore::Traverse）
+   *
+   * [请求体]
+   * {
+   *   "start": ["alice"],                 // 或 "start_where": [谓词...]
+   *   "steps": [{"expand": "out", "labels": ["KNOWS"]},
+   *             {"where": [{"field": "age", "op": "gt", "value": 30}]},
+   *             {"limit": 10}],
+   *   "fields": ["name"], "ids_only": false   // 可选，属性投影
+   * }
+   *
+   * [响应] {"success": true, "node_count": 3, "nodes": [...],
+   *         "stats": {"nodes_expanded": 4, "filters_pushed_down": 1, ...}}
+   */
+  void handle_graph_traverse(const httplib::Request &req,
+                             httplib::Response &res);
+
   // ==========================================
   // 辅助方法
   // ==========================================
@@ -353,6 +814,99 @@ private:
    */
   DistanceMetric parse_metric(const std::string &metric_str);
 
+  /**
+   * @brief 从请求体解析图遍历过滤条件
+   * @param body 可含 "labels"（字符串数组）、"direction"（"out"/"in"/"both"）、
+   *             "where"（节点属性谓词数组，见 parse_property_predicates）
+   *             和 "as_of"（整数时刻，只经过该时刻有效的边）
+   * @return 未提供的字段取默认值（不限标签、出边方向、不限节点）
+   * @throws std::invalid_argument direction 取值非法时抛出（映射为 400）
+   */
+  static graph::TraversalFilter parse_traversal_filter(const json &body);
+
+  /**
+   * @brief 解析属性谓词数组
+   * @param where [{"field": "age", "op": "gt", "value": 30}, ...]，
+   *              op 取 eq / lt / le / gt / ge（缺省 eq），value 为任意 JSON 值
+   * @throws std::invalid_argument 格式非法时抛出（映射为 400）
+   */
+  static std::vector<graph::PropertyPredicate>
+  parse_property_predicates(const json &where);
+
+  /**
+   * @brief 从请求体解析 GraphRAG 有界扩展参数
+   * @param body   可含 max_fanout / max_results / deadline_ms / sampling / seed
+   * @param budget 输出参数
+   * @return 请求体不含任何预算字段时返回 false（走普通查询）
+   * @throws std::invalid_argument sampling 取值非法时抛出（映射为 400）
+   */
+  static bool parse_graphrag_budget(const json &body,
+                                    graph::GraphRAGBudget &budget);
+
+  /**
+   * @brief 解析遍历管道（格式见 handle_graph_traverse）
+   * @throws std::invalid_argument step 或谓词格式非法时抛出（映射为 400）
+   */
+  static graph::TraversalPipeline parse_traversal_pipeline(const json &body);
+
+  /**
+   * @brief 从请求体解析返回节点的属性投影
+   * @param body 可含 "ids_only"（布尔）或 "fields"（顶层字段名数组）
+   * @return 都未提供时返回完整属性
+   */
+  static graph::Projection parse_projection(const json &body);
+
+  /**
+   * @brief 请求体是否为二进制向量（Content-Type: application/octet-stream）
+   */
+  static bool is_binary_vector(const httplib::Request &req);
+
+  /**
+   * @brief 解析 X-Vector-Dtype 请求头（fp32 / fp16，缺省 fp32）
+   * @throws std::invalid_argument 取值非法时抛出（映射为 400）
+   */
+  static VectorDtype parse_vector_dtype(const httplib::Request &req);
+
+  /**
+   * @brief 校验二进制向量请求体，返回维度
+   * @return X-Vector-Dimension 的值，保证请求体恰好是 dimension 个元素
+   * @throws std::invalid_argument 缺少维度头、维度非法或长度不一致（400）
+   */
+  static size_t parse_binary_vector(const httplib::Request &req,
+                                    VectorDtype dtype);
+
+  /**
+   * @brief 读取整数查询参数
+   * @return 参数不存在时返回 def
+   * @throws std::invalid_argument 参数不是整数时抛出（映射为 400）
+   */
+  static int64_t int_param(const httplib::Request &req, const char *name,
+                           int64_t def);
+
+  /**
+   * @brief 取出批量请求中的操作数组
+   * @throws std::invalid_argument 字段缺失、不是数组或超过 kMaxBatchSize 项
+   */
+  static const json &batch_array(const json &body, const char *field);
+
+  /**
+   * @brief 客户端是否要求流式响应
+   * @return 请求体 "stream" 为 true，或 Accept 头含 application/x-ndjson
+   */
+  static bool wants_stream(const httplib::Request &req, const json &body);
+
+  /**
+   * @brief 解析 /kv/scan 的游标字符串（"0" 或 "shard-bucket-buckets"）
+   * @throws std::invalid_argument 格式非法
+   */
+  static db::ScanCursor parse_scan_cursor(const std::string &text);
+
+  /** @brief 游标的字符串形式，遍历完成时为 "0" */
+  static std::string format_scan_cursor(const db::ScanCursor &cursor);
+
+  /** @brief 单个批量请求最多携带的操作数 */
+  static constexpr size_t kMaxBatchSize = 10000;
+
   /**
    * @brief 发送错误响应
    * @param res         httplib 响应对象
@@ -372,6 +926,25 @@ private:
    * [统一格式] Content-Type 固定为 application/json
    */
   void send_success(httplib::Response &res, const json &data);
+
+  /**
+   * @brief 发送已编码好的 JSON 响应体（HTTP 200）
+   * @param body JsonWriter 写好的完整 JSON 文本，移交给响应对象
+   */
+  static void send_json(httplib::Response &res, std::string &&body);
+
+  /** @brief /vector/put 的响应（JSON 与二进制写入共用） */
+  static void send_vector_put(httplib::Response &res, const std::string &key,
+                              size_t dimension);
+
+  /**
+   * @brief /vector/search 的响应（JSON 与二进制查询共用）
+   * @param partial 超时提前结束，keys 只是已扫描部分的结果
+   */
+  static void send_vector_search(httplib::Response &res,
+                                 size_t query_dimension, int64_t top_k,
+                                 const std::vector<std::string> &keys,
+                                 bool partial = false);
 };
 
 } // namespace server
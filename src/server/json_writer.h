@@ -0,0 +1,247 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace minkv {
+namespace server {
+
+/**
+ * @brief 直接向 std::string 追加 JSON 文本的流式编码器
+ *
+ * 热点 HTTP 响应（KV / 向量 / GraphRAG）的结构固定，不需要先构造
+ * nlohmann::json 的 DOM 再 dump：每个字段都是一次 map 节点分配和一次
+ * 字符串拷贝。JsonWriter 按调用顺序把 token 写进调用方给的字符串，
+ * 逗号由内部按嵌套层记录，调用方提前 reserve 时整个编码过程不分配内存。
+ *
+ *   std::string body;
+ *   JsonWriter w(body);
+ *   w.begin_object().field("success", true).field("key", key);
+ *   w.key("results").value(keys).end_object();
+ *
+ * - 数字用 std::to_chars 输出最短可往返表示；NaN / Inf 输出 null
+ * - 字符串转义与 nlohmann::json::dump() 一致（"、\、控制字符），
+ *   非 ASCII 字节原样输出；非法 UTF-8 字节替换为 U+FFFD，而不是抛异常
+ * - depth 为 0 时连续写多个值不加逗号，可直接用来拼 NDJSON 行
+ * - 不检查调用顺序（例如对象里漏写 key），结构由调用方保证
+ */
+class JsonWriter {
+public:
+  /** 最大嵌套层数 */
+  static constexpr int kMaxDepth = 64;
+
+  explicit JsonWriter(std::string &out) : out_(out) {}
+
+  JsonWriter &begin_object() { return open('{'); }
+  JsonWriter &end_object() { return close('}'); }
+  JsonWriter &begin_array() { return open('['); }
+  JsonWriter &end_array() { return close(']'); }
+
+  /** 写对象的键，下一次写入的值属于这个键 */
+  JsonWriter &key(std::string_view k) {
+    separate();
+    write_string(k);
+    out_ += ':';
+    after_key_ = true;
+    return *this;
+  }
+
+  JsonWriter &value(std::string_view s) {
+    separate();
+    write_string(s);
+    return *this;
+  }
+
+  JsonWriter &value(const char *s) { return value(std::string_view(s)); }
+
+  JsonWriter &value(bool b) {
+    separate();
+    out_ += b ? "true" : "false";
+    return *this;
+  }
+
+  template <typename T,
+            std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                             int> = 0>
+  JsonWriter &value(T v) {
+    separate();
+    char buf[24];
+    auto r = std::to_chars(buf, buf + sizeof(buf), v);
+    out_.append(buf, r.ptr);
+    return *this;
+  }
+
+  JsonWriter &value(double v) { return write_float(v); }
+  JsonWriter &value(float v) { return write_float(v); }
+
+  /** 数组：元素逐个按 value 的重载写出 */
+  template <typename T> JsonWriter &value(const std::vector<T> &items) {
+    begin_array();
+    for (const auto &item : items)
+      value(item);
+    return end_array();
+  }
+
+  JsonWriter &null() {
+    separate();
+    out_ += "null";
+    return *this;
+  }
+
+  /** key(k).value(v) 的简写 */
+  template <typename T> JsonWriter &field(std::string_view k, const T &v) {
+    key(k);
+    return value(v);
+  }
+
+  /** 当前嵌套层数，写完一个完整值后为 0 */
+  int depth() const { return depth_; }
+
+private:
+  // 写值之前：对象 / 数组中第二个及以后的元素先写逗号
+  void separate() {
+    if (after_key_) {
+      after_key_ = false;
+      return;
+    }
+    if (depth_ == 0)
+      return;
+    uint64_t bit = uint64_t(1) << (depth_ - 1);
+    if (has_items_ & bit)
+      out_ += ',';
+    else
+      has_items_ |= bit;
+  }
+
+  JsonWriter &open(char c) {
+    separate();
+    if (depth_ == kMaxDepth)
+      throw std::runtime_error("JsonWriter: nesting too deep");
+    has_items_ &= ~(uint64_t(1) << depth_);
+    ++depth_;
+    out_ += c;
+    return *this;
+  }
+
+  JsonWriter &close(char c) {
+    --depth_;
+    out_ += c;
+    return *this;
+  }
+
+  template <typename T> JsonWriter &write_float(T v) {
+    separate();
+    if (!std::isfinite(v)) {
+      out_ += "null"; // JSON 没有 NaN / Inf，与 nlohmann 的输出一致
+      return *this;
+    }
+    char buf[32];
+    auto r = std::to_chars(buf, buf + sizeof(buf), v);
+    out_.append(buf, r.ptr);
+    return *this;
+  }
+
+  /**
+   * 从 p 开始的合法 UTF-8 多字节序列长度，非法时返回 0
+   * 排除过长编码、代理区（U+D800..U+DFFF）和 U+10FFFF 以上的码点
+   */
+  static size_t utf8_sequence(const unsigned char *p,
+                              const unsigned char *end) {
+    unsigned char c = p[0];
+    unsigned char lo = 0x80, hi = 0xBF; // 第二个字节的合法范围
+    size_t n;
+    if (c >= 0xC2 && c <= 0xDF) {
+      n = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+      n = 3;
+      if (c == 0xE0)
+        lo = 0xA0;
+      else if (c == 0xED)
+        hi = 0x9F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+      n = 4;
+      if (c == 0xF0)
+        lo = 0x90;
+      else if (c == 0xF4)
+        hi = 0x8F;
+    } else {
+      return 0;
+    }
+    if (static_cast<size_t>(end - p) < n || p[1] < lo || p[1] > hi)
+      return 0;
+    for (size_t i = 2; i < n; ++i)
+      if ((p[i] & 0xC0) != 0x80)
+        return 0;
+    return n;
+  }
+
+  void write_string(std::string_view s) {
+    static const char kHex[] = "0123456789abcdef";
+    const auto *p = reinterpret_cast<const unsigned char *>(s.data());
+    const auto *end = p + s.size();
+    const auto *run = p; // 尚未写出的、不需要转义的一段
+    out_ += '"';
+    while (p < end) {
+      unsigned char c = *p;
+      if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80) {
+        ++p;
+        continue;
+      }
+      size_t n = c >= 0x80 ? utf8_sequence(p, end) : 0;
+      if (n != 0) {
+        p += n; // 合法的多字节字符原样输出
+        continue;
+      }
+      out_.append(reinterpret_cast<const char *>(run), p - run);
+      switch (c) {
+      case '"':
+        out_ += "\\\"";
+        break;
+      case '\\':
+        out_ += "\\\\";
+        break;
+      case '\b':
+        out_ += "\\b";
+        break;
+      case '\f':
+        out_ += "\\f";
+        break;
+      case '\n':
+        out_ += "\\n";
+        break;
+      case '\r':
+        out_ += "\\r";
+        break;
+      case '\t':
+        out_ += "\\t";
+        break;
+      default:
+        if (c < 0x20) {
+          out_ += "\\u00";
+          out_ += kHex[c >> 4];
+          out_ += kHex[c & 0xF];
+        } else {
+          out_ += "\xEF\xBF\xBD"; // 非法 UTF-8 字节 -> U+FFFD
+        }
+      }
+      run = ++p;
+    }
+    out_.append(reinterpret_cast<const char *>(run), p - run);
+    out_ += '"';
+  }
+
+  std::string &out_;
+  int depth_ = 0;
+  uint64_t has_items_ = 0; // 第 i 位：第 i+1 层容器是否已写过元素
+  bool after_key_ = false;
+};
+
+} // namespace server
+} // namespace minkv
@@ -0,0 +1,92 @@
+/**
+ * MinKV RESP Server
+ *
+ * 讲 RESP2 协议的 KV 服务，可直接用 redis-cli / redis-benchmark 访问。
+ * 命令列表见 resp_server.h。
+ *
+ * 编译：
+ *   cmake --build MinKV/build --target minkv_resp_server
+ *
+ * 运行：
+ *   ./MinKV/build/bin/minkv_resp_server [port] [reactors] [unix] [shm]
+ *   port 默认 6379；reactors 为事件循环线程数，默认 CPU 核数
+ *   unix 为 RESP 的 Unix domain socket 路径（同机客户端，省掉 TCP 协议栈）
+ *   shm 为共享内存传输的控制 socket 路径（见 shm_server.h / ShmClient）
+ *   路径传 "-" 表示不启用
+ *
+ * 压测：
+ *   redis-benchmark -p 6379 -t set,get,incr,mset -P 16 -c 50
+ *   ./MinKV/build/bin/resp_benchmark -p 6379 -t set,get,vset,vsearch
+ */
+
+#include <signal.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "resp_server.h"
+#include "shm_server.h"
+
+using namespace minkv;
+using namespace minkv::server;
+
+int main(int argc, char *argv[]) {
+  RespServerOptions options;
+  if (argc >= 2)
+    options.port = static_cast<uint16_t>(std::atoi(argv[1]));
+  if (argc >= 3)
+    options.reactors = static_cast<size_t>(std::atoi(argv[2]));
+  if (argc >= 4 && std::string(argv[3]) != "-")
+    options.unix_path = argv[3];
+  ShmServerOptions shm_options;
+  if (argc >= 5 && std::string(argv[4]) != "-")
+    shm_options.path = argv[4];
+
+  std::shared_ptr<StringKV> kv = StringKV::create(65536, 16);
+  kv->startExpirationService();
+
+  // 信号只由主线程 sigwait 处理，reactor 线程继承屏蔽字
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  RespServer server(kv, options);
+  std::unique_ptr<ShmServer> shm;
+  try {
+    server.Start();
+    if (!shm_options.path.empty()) {
+      shm = std::make_unique<ShmServer>(kv, shm_options);
+      shm->Start();
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "[MinKVRespServer] " << e.what() << "\n";
+    return 1;
+  }
+  std::cout << "[MinKVRespServer] listening on " << options.host << ":"
+            << server.port() << " with "
+            << (options.reactors ? options.reactors
+                                 : std::thread::hardware_concurrency())
+            << " reactors\n";
+  if (!options.unix_path.empty())
+    std::cout << "[MinKVRespServer] unix socket " << options.unix_path << "\n";
+  if (shm)
+    std::cout << "[MinKVRespServer] shared memory " << shm_options.path
+              << "\n";
+
+  int sig = 0;
+  sigwait(&signals, &sig);
+
+  if (shm)
+    shm->Stop();
+  server.Stop();
+  kv->stopExpirationService();
+  auto stats = server.Stats();
+  std::cout << "[MinKVRespServer] stopped: " << stats.connections_accepted
+            << " connections, " << stats.commands << " commands\n";
+  return 0;
+}
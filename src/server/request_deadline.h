@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+
+#include "../base/cancellation.h"
+#include "httplib.h"
+
+namespace minkv {
+namespace server {
+
+/**
+ * 单个请求的截止时间（长查询端点共用）
+ *
+ * [来源] 请求头 X-Timeout-Ms 或请求体字段 "timeout_ms"，单位毫秒，两者
+ * 都给出时取较小的；从 httplib 读到请求行时算起，排队等待准入的时间
+ * 也计入。都没有时 token 不限时。
+ *
+ * [超时] token 传进 vectorSearch / MultiSourceKHop / GraphRAGQuery，
+ * 在分块或每跳边界检查，过期后计算尽快停止、释放线程。请求头
+ * X-Allow-Partial: true 或请求体 "allow_partial": true 时返回已算出的
+ * 部分结果并带 "partial": true，否则返回 504。
+ */
+struct RequestDeadline {
+  base::CancellationToken token;
+  bool allow_partial = false;
+
+  /** 已过截止时间 */
+  bool expired() const { return token.cancelled(); }
+
+  /**
+   * 把已有的时间预算（0 表示不限）收紧到截止时间之前，用于自带
+   * 时间预算的查询（排序 / 有界 GraphRAG）；至少 1us，避免变成 0（不限）
+   */
+  std::chrono::microseconds clamp(std::chrono::microseconds budget) const {
+    if (!token.has_deadline())
+      return budget;
+    auto left = std::chrono::duration_cast<std::chrono::microseconds>(
+        token.deadline() - base::CancellationToken::Clock::now());
+    left = std::max(left, std::chrono::microseconds(1));
+    return budget.count() > 0 ? std::min(budget, left) : left;
+  }
+};
+
+/**
+ * 解析请求的截止时间，body 为 nullptr 时只看请求头
+ * @throws std::invalid_argument timeout 不是正整数
+ */
+inline RequestDeadline parse_request_deadline(const httplib::Request &req,
+                                              const nlohmann::json *body) {
+  int64_t timeout_ms = 0;
+  auto take = [&timeout_ms](int64_t ms) {
+    if (ms <= 0)
+      throw std::invalid_argument("timeout_ms 必须是正整数");
+    timeout_ms = timeout_ms > 0 ? std::min(timeout_ms, ms) : ms;
+  };
+  if (req.has_header("X-Timeout-Ms")) {
+    std::string v = req.get_header_value("X-Timeout-Ms");
+    int64_t ms = 0;
+    auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), ms);
+    if (ec != std::errc() || ptr != v.data() + v.size())
+      throw std::invalid_argument("非法的请求头 X-Timeout-Ms：" + v);
+    take(ms);
+  }
+  if (body && body->contains("timeout_ms"))
+    take((*body)["timeout_ms"].get<int64_t>());
+
+  RequestDeadline deadline;
+  deadline.allow_partial =
+      req.get_header_value("X-Allow-Partial") == "true" ||
+      (body && body->value("allow_partial", false));
+  if (timeout_ms > 0) {
+    // httplib 在读到请求行时记录 start_time_；手工构造的请求没有这个时间
+    auto start = req.start_time_;
+    if (start == base::CancellationToken::Clock::time_point::min())
+      start = base::CancellationToken::Clock::now();
+    deadline.token = base::CancellationToken::with_deadline(
+        start + std::chrono::milliseconds(timeout_ms));
+  }
+  return deadline;
+}
+
+} // namespace server
+} // namespace minkv
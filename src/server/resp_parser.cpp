@@ -6,79 +6,40 @@
 namespace minkv {
 namespace server {
 
-// 辅助函数：查找下一个 CRLF (\r\n) 的位置
-// 返回值是相对于 view 开头的偏移量
-static size_t find_crlf(std::string_view view) { return view.find("\r\n"); }
-
 // 辅助函数：将 string_view 转为整数 (比 atoi 快且安全)
-static std::optional<int> parse_int(std::string_view view) {
-  int result;
+static std::optional<int64_t> parse_int(std::string_view view) {
+  int64_t result;
   auto [ptr, ec] =
       std::from_chars(view.data(), view.data() + view.size(), result);
-  if (ec == std::errc()) {
+  if (ec == std::errc() && ptr == view.data() + view.size()) {
     return result;
   }
   return std::nullopt;
 }
 
-std::optional<RespParser::Command> RespParser::parse(std::string_view data) {
-  Command args;
-  size_t pos = 0; // 当前解析到的位置指针
+// 长度行（"*3\r\n" / "$5\r\n"）的最大长度，超过仍没有 CRLF 视为格式错误
+static constexpr size_t MAX_LENGTH_LINE = 32;
 
-  // 1. 检查是否为空或格式错误
-  if (data.empty() || data[0] != '*') {
-    return std::nullopt; // 目前只处理 Array 格式 (*3\r\n...)
+RespParser::Status RespParser::parse(std::string_view data, Command &out,
+                                     size_t &consumed) {
+  RespStreamParser parser;
+  RespStreamParser::Args args;
+  Status status = parser.next(data, args);
+  if (status == Status::OK) {
+    out.assign(args.begin(), args.end());
+    consumed = parser.consumed();
   }
+  return status;
+}
 
-  // 2. 解析数组长度 (*3\r\n)
-  // 跳过 '*'
-  pos++;
-
-  // 找到第一个 \r\n
-  size_t crlf = find_crlf(data.substr(pos));
-  if (crlf == std::string_view::npos)
+std::optional<RespParser::Command> RespParser::parse(std::string_view data) {
+  // 兼容旧接口：只处理 Array 格式，数据不完整或格式错误都返回 nullopt
+  if (data.empty() || data[0] != '*')
     return std::nullopt;
-
-  // 截取数字部分 "3"
-  auto count_str = data.substr(pos, crlf);
-  auto count = parse_int(count_str);
-  if (!count.has_value())
+  Command args;
+  size_t consumed = 0;
+  if (parse(data, args, consumed) != Status::OK)
     return std::nullopt;
-
-  // 移动指针到 \r\n 之后
-  pos += crlf + 2; // +2 是因为 \r\n 占2字节
-
-  // 3. 循环解析每个参数
-  for (int i = 0; i < count.value(); ++i) {
-    // 检查剩余数据是否足够 ($len\r\nval\r\n 至少要有 $ + 数字 + \r\n)
-    if (pos >= data.size() || data[pos] != '$')
-      return std::nullopt;
-    pos++; // 跳过 '$'
-
-    // 读取字符串长度 ($3\r\n)
-    crlf = find_crlf(data.substr(pos));
-    if (crlf == std::string_view::npos)
-      return std::nullopt;
-
-    auto len_str = data.substr(pos, crlf);
-    auto len = parse_int(len_str);
-    if (!len.has_value())
-      return std::nullopt;
-
-    pos += crlf + 2; // 跳过长度行
-
-    // 读取实际内容 (SET\r\n)
-    // 检查剩余长度是否够 (内容长度 + \r\n)
-    if (pos + len.value() + 2 > data.size())
-      return std::nullopt;
-
-    // 截取内容并存入 vector
-    args.emplace_back(data.substr(pos, len.value()));
-
-    // 移动指针跳过内容和 \r\n
-    pos += len.value() + 2;
-  }
-
   return args;
 }
 
@@ -104,5 +65,260 @@ std::string RespParser::serialize_null() {
   return "$-1\r\n";
 }
 
+std::string RespParser::serialize_integer(int64_t n) {
+  // 整数: :42\r\n
+  return ":" + std::to_string(n) + "\r\n";
+}
+
+std::string RespParser::serialize_array_header(size_t count) {
+  // 数组头: *3\r\n，元素由调用方依次追加
+  return "*" + std::to_string(count) + "\r\n";
+}
+
+// ==========================================
+// RespStreamParser
+// ==========================================
+
+RespParser::Status RespStreamParser::read_length(std::string_view buf,
+                                                 char prefix, int64_t &out) {
+  if (pos_ >= buf.size())
+    return RespParser::Status::INCOMPLETE;
+  if (buf[pos_] != prefix)
+    return RespParser::Status::ERROR;
+
+  // 从上次检查到的位置继续找 CRLF；'\r' 可能是上次的最后一个字节
+  size_t from = std::max(scan_, pos_ + 1);
+  size_t crlf = buf.find("\r\n", from);
+  if (crlf == std::string_view::npos) {
+    if (buf.size() - pos_ > MAX_LENGTH_LINE)
+      return RespParser::Status::ERROR;
+    scan_ = std::max(from, buf.size() - 1);
+    return RespParser::Status::INCOMPLETE;
+  }
+  auto value = parse_int(buf.substr(pos_ + 1, crlf - pos_ - 1));
+  if (!value)
+    return RespParser::Status::ERROR;
+  out = *value;
+  pos_ = scan_ = crlf + 2;
+  return RespParser::Status::OK;
+}
+
+RespParser::Status RespStreamParser::next(std::string_view buf, Args &args) {
+  using Status = RespParser::Status;
+
+  // 新命令：根据首字节决定格式
+  if (argc_ < 0 && !inline_) {
+    if (start_ >= buf.size())
+      return Status::INCOMPLETE;
+    inline_ = buf[start_] != '*';
+  }
+
+  // inline 命令：一行以空格 / 制表符分隔的参数，"\r\n" 或 "\n" 结尾
+  if (inline_) {
+    size_t eol = buf.find('\n', std::max(scan_, start_));
+    if (eol == std::string_view::npos) {
+      if (buf.size() - start_ > RespParser::MAX_INLINE_LENGTH)
+        return Status::ERROR;
+      scan_ = buf.size();
+      return Status::INCOMPLETE;
+    }
+    std::string_view line = buf.substr(start_, eol - start_);
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+
+    args.clear();
+    size_t pos = 0;
+    while (pos < line.size()) {
+      while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+        ++pos;
+      size_t begin = pos;
+      while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t')
+        ++pos;
+      if (pos > begin)
+        args.push_back(line.substr(begin, pos - begin));
+    }
+    start_ = pos_ = scan_ = eol + 1;
+    inline_ = false;
+    return Status::OK;
+  }
+
+  // 1. 数组头 (*3\r\n)
+  if (argc_ < 0) {
+    int64_t count = 0;
+    Status st = read_length(buf, '*', count);
+    if (st != Status::OK)
+      return st;
+    if (count < 0 || count > RespParser::MAX_ARRAY_LENGTH)
+      return Status::ERROR;
+    argc_ = count;
+    spans_.clear();
+    spans_.reserve(static_cast<size_t>(count));
+  }
+
+  // 2. 逐个参数 ($len\r\nval\r\n)，从断点继续
+  while (static_cast<int64_t>(spans_.size()) < argc_) {
+    if (bulk_len_ < 0) {
+      int64_t len = 0;
+      Status st = read_length(buf, '$', len);
+      if (st != Status::OK)
+        return st;
+      if (len < 0 || len > RespParser::MAX_BULK_LENGTH)
+        return Status::ERROR;
+      bulk_len_ = len;
+    }
+    // 等待内容和结尾的 \r\n 全部到达，期间不需要扫描
+    size_t n = static_cast<size_t>(bulk_len_);
+    if (buf.size() < pos_ + n + 2)
+      return Status::INCOMPLETE;
+    if (buf[pos_ + n] != '\r' || buf[pos_ + n + 1] != '\n')
+      return Status::ERROR;
+    spans_.push_back({pos_, n});
+    pos_ = scan_ = pos_ + n + 2;
+    bulk_len_ = -1;
+  }
+
+  args.clear();
+  for (const Span &span : spans_)
+    args.push_back(buf.substr(span.offset, span.length));
+  start_ = pos_;
+  argc_ = -1;
+  return Status::OK;
+}
+
+void RespStreamParser::discard(size_t n) {
+  start_ -= n;
+  pos_ -= n;
+  scan_ -= n;
+  for (Span &span : spans_)
+    span.offset -= n;
+}
+
+void RespStreamParser::reset() { *this = RespStreamParser(); }
+
+// ==========================================
+// RespReplyBuffer
+// ==========================================
+
+std::string &RespReplyBuffer::tail() {
+  if (segments_.empty() || tail_sealed_) {
+    segments_.emplace_back();
+    tail_sealed_ = false;
+  }
+  return segments_.back();
+}
+
+void RespReplyBuffer::simple_string(std::string_view msg) {
+  std::string &t = tail();
+  t += '+';
+  t.append(msg.data(), msg.size());
+  t += "\r\n";
+  bytes_ += msg.size() + 3;
+}
+
+void RespReplyBuffer::error(std::string_view msg) {
+  std::string &t = tail();
+  t += '-';
+  t.append(msg.data(), msg.size());
+  t += "\r\n";
+  bytes_ += msg.size() + 3;
+}
+
+// 写入 "<prefix><n>\r\n"
+static size_t append_number_line(std::string &t, char prefix, int64_t n) {
+  char buf[24];
+  buf[0] = prefix;
+  auto res = std::to_chars(buf + 1, buf + sizeof(buf) - 2, n);
+  res.ptr[0] = '\r';
+  res.ptr[1] = '\n';
+  size_t len = static_cast<size_t>(res.ptr + 2 - buf);
+  t.append(buf, len);
+  return len;
+}
+
+void RespReplyBuffer::integer(int64_t n) {
+  bytes_ += append_number_line(tail(), ':', n);
+}
+
+void RespReplyBuffer::null() {
+  tail() += "$-1\r\n";
+  bytes_ += 5;
+}
+
+void RespReplyBuffer::array_header(size_t count) {
+  bytes_ += append_number_line(tail(), '*', static_cast<int64_t>(count));
+}
+
+void RespReplyBuffer::bulk(std::string_view val) {
+  std::string &t = tail();
+  bytes_ += append_number_line(t, '$', static_cast<int64_t>(val.size()));
+  t.append(val.data(), val.size());
+  t += "\r\n";
+  bytes_ += val.size() + 2;
+}
+
+void RespReplyBuffer::bulk(std::string &&val) {
+  if (val.size() < ZERO_COPY_THRESHOLD) {
+    bulk(std::string_view(val));
+    return;
+  }
+  size_t n = val.size();
+  bytes_ += append_number_line(tail(), '$', static_cast<int64_t>(n));
+  segments_.push_back(std::move(val));
+  tail_sealed_ = true;
+  bytes_ += n;
+  tail() += "\r\n";
+  bytes_ += 2;
+}
+
+size_t RespReplyBuffer::gather(struct iovec *iov, size_t max) const {
+  size_t count = 0;
+  size_t skip = head_offset_;
+  for (const std::string &seg : segments_) {
+    if (count == max)
+      break;
+    if (seg.size() == skip) { // 只可能是已发完的空尾分段
+      skip = 0;
+      continue;
+    }
+    iov[count].iov_base = const_cast<char *>(seg.data() + skip);
+    iov[count].iov_len = seg.size() - skip;
+    ++count;
+    skip = 0;
+  }
+  return count;
+}
+
+void RespReplyBuffer::consume(size_t n) {
+  bytes_ -= n;
+  while (n > 0 && !segments_.empty()) {
+    size_t remaining = segments_.front().size() - head_offset_;
+    if (n < remaining) {
+      head_offset_ += n;
+      return;
+    }
+    n -= remaining;
+    head_offset_ = 0;
+    if (segments_.size() == 1 && !tail_sealed_ &&
+        segments_.front().capacity() <= MAX_RETAINED_CAPACITY) {
+      segments_.front().clear(); // 保留容量，下一批回复直接复用
+    } else {
+      segments_.pop_front();
+    }
+  }
+  if (segments_.empty())
+    tail_sealed_ = false;
+}
+
+std::string RespReplyBuffer::str() const {
+  std::string out;
+  out.reserve(bytes_);
+  size_t skip = head_offset_;
+  for (const std::string &seg : segments_) {
+    out.append(seg, skip, std::string::npos);
+    skip = 0;
+  }
+  return out;
+}
+
 } // namespace server
 } // namespace minkv
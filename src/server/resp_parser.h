@@ -1,10 +1,15 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include <sys/uio.h>
+
 namespace minkv {
 namespace server {
 
@@ -12,14 +17,38 @@ namespace server {
  * @brief RESP (Redis Serialization Protocol) 解析器
  *
  * 负责将客户端发送的字节流解析为命令参数列表。
- * 目前仅支持解析 RESP 数组（Array）格式，因为这是客户端发送命令的标准格式。
+ * 支持 RESP 数组（Array）格式，这是客户端发送命令的标准格式：
  * 例如: "*3\r\n$3\r\nSET\r\n..." -> {"SET", "key", "value"}
+ * 以及 inline 命令（"PING\r\n"，空格分隔），兼容 telnet 和
+ * redis-benchmark 的 PING_INLINE。
  */
 class RespParser {
 public:
   // 解析结果类型：命令参数列表
   using Command = std::vector<std::string>;
 
+  // 单个参数 / 数组元素个数上限，超过视为协议错误（与 Redis 默认值一致）
+  static constexpr int64_t MAX_BULK_LENGTH = 512 * 1024 * 1024;
+  static constexpr int64_t MAX_ARRAY_LENGTH = 1024 * 1024;
+  // inline 命令一行的长度上限
+  static constexpr size_t MAX_INLINE_LENGTH = 64 * 1024;
+
+  /** 从缓冲区开头解析一条命令的结果 */
+  enum class Status {
+    OK,         // 解析出一条完整命令
+    INCOMPLETE, // 数据还不完整，等待更多字节
+    ERROR       // 格式错误，连接应当关闭
+  };
+
+  /**
+   * @brief 从 data 开头解析一条命令，用于同一缓冲区中的多条命令（pipeline）
+   *
+   * @param data     连接的读缓冲区（可以包含多条命令或半条命令）
+   * @param out      成功时写入参数列表
+   * @param consumed 成功时写入这条命令占用的字节数
+   */
+  static Status parse(std::string_view data, Command &out, size_t &consumed);
+
   /**
    * @brief 解析一段完整的 RESP 消息
    *
@@ -58,6 +87,113 @@ public:
    * @return "$-1\r\n"
    */
   static std::string serialize_null();
+
+  /**
+   * @brief 将整数序列化为 RESP 格式 (用于 DEL / INCR / TTL 返回)
+   *
+   * @return ":n\r\n"
+   */
+  static std::string serialize_integer(int64_t n);
+
+  /**
+   * @brief 数组头，后面紧跟 count 个元素
+   *
+   * @return "*count\r\n"
+   */
+  static std::string serialize_array_header(size_t count);
+};
+
+/**
+ * @brief 可续传的 RESP 流式解析器，参数以 string_view 指向读缓冲区
+ *
+ * 解析器只记录偏移量，不拷贝参数。数据不完整时保存已解析到的位置
+ * （数组头、已完成的参数、当前参数的长度），新数据到达后从断点继续，
+ * 不会从命令开头重新扫描。一次 read 读到的多条命令（pipeline）通过
+ * 循环调用 next() 依次取出。
+ *
+ * 缓冲区约定：两次调用之间调用方只能在 buf 末尾追加数据；丢弃头部已
+ * 解析的字节后必须调用 discard() 同步偏移量。
+ */
+class RespStreamParser {
+public:
+  using Args = std::vector<std::string_view>;
+
+  /**
+   * @brief 从上次停下的位置继续解析下一条命令
+   *
+   * @param buf  连接的读缓冲区（从未丢弃的第一个字节开始）
+   * @param args OK 时写入参数，指向 buf，在缓冲区被修改之前有效
+   */
+  RespParser::Status next(std::string_view buf, Args &args);
+
+  /** 已解析完的命令在缓冲区头部占用的字节数，可以丢弃 */
+  size_t consumed() const { return start_; }
+
+  /** 调用方从缓冲区头部丢弃了 n 字节（n <= consumed()） */
+  void discard(size_t n);
+
+  void reset();
+
+private:
+  // 读取 "<prefix><整数>\r\n" 形式的长度行
+  RespParser::Status read_length(std::string_view buf, char prefix,
+                                 int64_t &out);
+
+  struct Span {
+    size_t offset;
+    size_t length;
+  };
+
+  size_t start_ = 0;      // 当前命令的起点
+  size_t pos_ = 0;        // 下一个待解析字节
+  size_t scan_ = 0;       // 找行尾时已经检查过的位置
+  int64_t argc_ = -1;     // 数组元素个数，-1 表示还没读到数组头
+  int64_t bulk_len_ = -1; // 当前参数长度，-1 表示还没读到 $len 行
+  bool inline_ = false;   // 当前命令是 inline 格式
+  std::vector<Span> spans_;
+};
+
+/**
+ * @brief 一个连接待发送的回复，按分段组织，用 writev 一次发出
+ *
+ * 小回复追加到同一个分段里；不小于 ZERO_COPY_THRESHOLD 的 bulk 值
+ * 以右值传入时直接移入独立分段，发送时不再拷贝进缓冲区。
+ */
+class RespReplyBuffer {
+public:
+  static constexpr size_t ZERO_COPY_THRESHOLD = 4096;
+
+  void simple_string(std::string_view msg);
+  void error(std::string_view msg);
+  void integer(int64_t n);
+  void null();
+  void array_header(size_t count);
+  void bulk(std::string_view val);
+  void bulk(std::string &&val);
+
+  /** 待发送的字节数 */
+  size_t size() const { return bytes_; }
+  bool empty() const { return bytes_ == 0; }
+
+  /** 把待发送数据依次填入 iov，最多 max 段，返回段数 */
+  size_t gather(struct iovec *iov, size_t max) const;
+
+  /** 丢弃已发出的前 n 字节 */
+  void consume(size_t n);
+
+  /** 拼接全部待发送数据（测试和非网络调用方使用） */
+  std::string str() const;
+
+private:
+  // 发完后保留的分段容量上限，避免一次大回复长期占用内存
+  static constexpr size_t MAX_RETAINED_CAPACITY = 1024 * 1024;
+
+  std::string &tail();
+
+  std::deque<std::string> segments_;
+  size_t head_offset_ = 0;   // 第一个分段中已发出的字节数
+  size_t bytes_ = 0;         // 待发送总字节数
+  bool tail_sealed_ = false; // 最后一个分段是移入的 value，不能再追加
 };
 
 } // namespace server
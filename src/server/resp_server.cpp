@@ -0,0 +1,688 @@
+#include "resp_server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "unix_socket.h"
+
+namespace minkv {
+namespace server {
+
+namespace {
+
+using Args = RespStreamParser::Args;
+using Store = RespServer::Store;
+
+constexpr int kMaxEvents = 256;
+constexpr size_t kReadChunk = 16 * 1024;     // 每次 read 至少预留的空间
+constexpr size_t kMaxIdleBuffer = 256 * 1024; // 空闲连接保留的读缓冲区上限
+constexpr size_t kMaxIov = 64;                // 每次 writev 的分段数
+
+[[noreturn]] void FailErrno(const char *op) {
+  throw std::runtime_error(std::string("RespServer: ") + op +
+                           " failed: " + std::strerror(errno));
+}
+
+std::optional<int64_t> ParseInt64(std::string_view s) {
+  int64_t v;
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+  if (ec != std::errc() || ptr != s.data() + s.size() || s.empty())
+    return std::nullopt;
+  return v;
+}
+
+bool ParseFloats(const Args &args, size_t first, std::vector<float> &out) {
+  out.reserve(args.size() - first);
+  std::string tmp; // strtof 需要 '\0' 结尾
+  for (size_t i = first; i < args.size(); ++i) {
+    tmp.assign(args[i].data(), args[i].size());
+    char *end = nullptr;
+    errno = 0;
+    float v = std::strtof(tmp.c_str(), &end);
+    if (tmp.empty() || end != tmp.c_str() + tmp.size() || errno == ERANGE)
+      return false;
+    out.push_back(v);
+  }
+  return true;
+}
+
+std::string Upper(std::string_view s) {
+  std::string out(s);
+  std::transform(out.begin(), out.end(), out.begin(), ::toupper);
+  return out;
+}
+
+const char *kNotInteger = "ERR value is not an integer or out of range";
+const char *kNotFloat = "ERR value is not a valid float";
+const char *kSyntax = "ERR syntax error";
+
+// ── 命令实现 ─────────────────────────────────────────────────────────────────
+
+std::string Key(std::string_view s) { return std::string(s); }
+
+void CmdPing(Store &, const Args &args, RespReplyBuffer &out) {
+  if (args.size() == 1)
+    out.simple_string("PONG");
+  else
+    out.bulk(args[1]);
+}
+
+void CmdEcho(Store &, const Args &args, RespReplyBuffer &out) {
+  out.bulk(args[1]);
+}
+
+void CmdGet(Store &store, const Args &args, RespReplyBuffer &out) {
+  auto val = store.get(Key(args[1]));
+  if (val)
+    out.bulk(std::move(*val)); // 大 value 直接移交给 writev
+  else
+    out.null();
+}
+
+void CmdSet(Store &store, const Args &args, RespReplyBuffer &out) {
+  int64_t ttl_ms = 0;
+  for (size_t i = 3; i < args.size(); i += 2) {
+    std::string opt = Upper(args[i]);
+    if ((opt != "EX" && opt != "PX") || i + 1 >= args.size()) {
+      out.error(kSyntax);
+      return;
+    }
+    auto n = ParseInt64(args[i + 1]);
+    if (!n) {
+      out.error(kNotInteger);
+      return;
+    }
+    if (*n <= 0 || (opt == "EX" && *n > INT64_MAX / 1000)) {
+      out.error("ERR invalid expire time in 'set' command");
+      return;
+    }
+    ttl_ms = opt == "EX" ? *n * 1000 : *n;
+  }
+  store.put(Key(args[1]), std::string(args[2]), ttl_ms);
+  out.simple_string("OK");
+}
+
+void CmdDel(Store &store, const Args &args, RespReplyBuffer &out) {
+  int64_t removed = 0;
+  for (size_t i = 1; i < args.size(); ++i)
+    removed += store.remove(Key(args[i])) ? 1 : 0;
+  out.integer(removed);
+}
+
+void CmdExists(Store &store, const Args &args, RespReplyBuffer &out) {
+  int64_t found = 0;
+  for (size_t i = 1; i < args.size(); ++i)
+    found += store.ttl(Key(args[i])) != -2 ? 1 : 0; // 不拷贝 value
+  out.integer(found);
+}
+
+void CmdMGet(Store &store, const Args &args, RespReplyBuffer &out) {
+  std::vector<std::string> keys(args.begin() + 1, args.end());
+  auto vals = store.multiGet(keys);
+  out.array_header(vals.size());
+  for (auto &v : vals) {
+    if (v)
+      out.bulk(std::move(*v));
+    else
+      out.null();
+  }
+}
+
+void CmdMSet(Store &store, const Args &args, RespReplyBuffer &out) {
+  if (args.size() % 2 != 1) {
+    out.error("ERR wrong number of arguments for 'mset' command");
+    return;
+  }
+  for (size_t i = 1; i < args.size(); i += 2)
+    store.put(Key(args[i]), std::string(args[i + 1]));
+  out.simple_string("OK");
+}
+
+// EXPIRE / PEXPIRE：非正数的过期时间立即删除 key（与 Redis 一致）
+void ExpireGeneric(Store &store, const Args &args, RespReplyBuffer &out,
+                   int64_t unit_ms) {
+  auto n = ParseInt64(args[2]);
+  if (!n || *n > INT64_MAX / unit_ms) {
+    out.error(kNotInteger);
+    return;
+  }
+  std::string key = Key(args[1]);
+  bool ok = *n <= 0 ? store.remove(key) : store.expire(key, *n * unit_ms);
+  out.integer(ok ? 1 : 0);
+}
+
+void CmdExpire(Store &store, const Args &args, RespReplyBuffer &out) {
+  ExpireGeneric(store, args, out, 1000);
+}
+
+void CmdPExpire(Store &store, const Args &args, RespReplyBuffer &out) {
+  ExpireGeneric(store, args, out, 1);
+}
+
+void CmdTtl(Store &store, const Args &args, RespReplyBuffer &out) {
+  int64_t ms = store.ttl(Key(args[1]));
+  out.integer(ms < 0 ? ms : (ms + 500) / 1000);
+}
+
+void CmdPTtl(Store &store, const Args &args, RespReplyBuffer &out) {
+  out.integer(store.ttl(Key(args[1])));
+}
+
+void CmdPersist(Store &store, const Args &args, RespReplyBuffer &out) {
+  std::string key = Key(args[1]);
+  bool changed = store.ttl(key) >= 0 && store.expire(key, 0);
+  out.integer(changed ? 1 : 0);
+}
+
+// INCR 系列：在分片锁内完成读-加-写；旧值不是整数或溢出时写回原值
+void IncrBy(Store &store, std::string_view key, int64_t delta,
+            RespReplyBuffer &out) {
+  bool ok = true;
+  int64_t result = 0;
+  store.updateInPlace(Key(key), [&](const std::optional<std::string> &old) {
+    int64_t current = 0;
+    if (old) {
+      auto v = ParseInt64(*old);
+      if (!v || __builtin_add_overflow(*v, delta, &result)) {
+        ok = false;
+        return *old;
+      }
+      current = *v;
+    }
+    result = current + delta;
+    return std::to_string(result);
+  });
+  if (ok)
+    out.integer(result);
+  else
+    out.error(kNotInteger);
+}
+
+void CmdIncr(Store &store, const Args &args, RespReplyBuffer &out) {
+  IncrBy(store, args[1], 1, out);
+}
+
+void CmdDecr(Store &store, const Args &args, RespReplyBuffer &out) {
+  IncrBy(store, args[1], -1, out);
+}
+
+void CmdIncrBy(Store &store, const Args &args, RespReplyBuffer &out) {
+  auto delta = ParseInt64(args[2]);
+  if (!delta)
+    out.error(kNotInteger);
+  else
+    IncrBy(store, args[1], *delta, out);
+}
+
+void CmdDecrBy(Store &store, const Args &args, RespReplyBuffer &out) {
+  auto delta = ParseInt64(args[2]);
+  if (!delta || *delta == INT64_MIN)
+    out.error(kNotInteger);
+  else
+    IncrBy(store, args[1], -*delta, out);
+}
+
+void CmdVSet(Store &store, const Args &args, RespReplyBuffer &out) {
+  std::vector<float> vec;
+  if (!ParseFloats(args, 2, vec)) {
+    out.error(kNotFloat);
+    return;
+  }
+  store.vectorPut(Key(args[1]), vec);
+  out.simple_string("OK");
+}
+
+void CmdVGet(Store &store, const Args &args, RespReplyBuffer &out) {
+  auto vec = store.vectorGet(Key(args[1]));
+  out.array_header(vec.size());
+  char buf[32];
+  for (float x : vec) {
+    int n = std::snprintf(buf, sizeof(buf), "%.9g", x);
+    out.bulk(std::string_view(buf, static_cast<size_t>(n)));
+  }
+}
+
+void CmdVSearch(Store &store, const Args &args, RespReplyBuffer &out) {
+  auto k = ParseInt64(args[1]);
+  if (!k || *k <= 0 || *k > INT32_MAX) {
+    out.error(kNotInteger);
+    return;
+  }
+  std::vector<float> query;
+  if (!ParseFloats(args, 2, query)) {
+    out.error(kNotFloat);
+    return;
+  }
+  auto keys = store.vectorSearch(query, static_cast<int>(*k));
+  out.array_header(keys.size());
+  for (const auto &key : keys)
+    out.bulk(key);
+}
+
+void CmdDbSize(Store &store, const Args &, RespReplyBuffer &out) {
+  out.integer(static_cast<int64_t>(store.size()));
+}
+
+void CmdCommand(Store &, const Args &, RespReplyBuffer &out) {
+  out.array_header(0);
+}
+
+void CmdConfig(Store &, const Args &args, RespReplyBuffer &out) {
+  if (Upper(args[1]) == "GET")
+    out.array_header(0); // 没有可暴露的配置项
+  else
+    out.error("ERR unsupported CONFIG subcommand '" + Key(args[1]) + "'");
+}
+
+struct CommandSpec {
+  void (*fn)(Store &, const Args &, RespReplyBuffer &);
+  int arity; // 与 Redis 相同：正数为精确参数个数，负数为最少参数个数
+};
+
+const std::unordered_map<std::string, CommandSpec> &CommandTable() {
+  static const std::unordered_map<std::string, CommandSpec> table = {
+      {"PING", {CmdPing, -1}},       {"ECHO", {CmdEcho, 2}},
+      {"GET", {CmdGet, 2}},          {"SET", {CmdSet, -3}},
+      {"DEL", {CmdDel, -2}},         {"EXISTS", {CmdExists, -2}},
+      {"MGET", {CmdMGet, -2}},       {"MSET", {CmdMSet, -3}},
+      {"EXPIRE", {CmdExpire, 3}},    {"PEXPIRE", {CmdPExpire, 3}},
+      {"TTL", {CmdTtl, 2}},          {"PTTL", {CmdPTtl, 2}},
+      {"PERSIST", {CmdPersist, 2}},  {"INCR", {CmdIncr, 2}},
+      {"DECR", {CmdDecr, 2}},        {"INCRBY", {CmdIncrBy, 3}},
+      {"DECRBY", {CmdDecrBy, 3}},    {"VSET", {CmdVSet, -3}},
+      {"VGET", {CmdVGet, 2}},        {"VSEARCH", {CmdVSearch, -3}},
+      {"DBSIZE", {CmdDbSize, 1}},    {"COMMAND", {CmdCommand, -1}},
+      {"CONFIG", {CmdConfig, -2}},
+  };
+  return table;
+}
+
+} // namespace
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 命令分发
+// ══════════════════════════════════════════════════════════════════════════════
+
+void RespServer::Execute(const Args &args, RespReplyBuffer &out) {
+  if (args.empty())
+    return; // 空 inline 行：Redis 同样不回复
+  commands_.fetch_add(1, std::memory_order_relaxed);
+
+  std::string name = Upper(args[0]);
+  const auto &table = CommandTable();
+  auto it = table.find(name);
+  if (it == table.end()) {
+    out.error("ERR unknown command '" + Key(args[0]) + "'");
+    return;
+  }
+  const CommandSpec &spec = it->second;
+  int argc = static_cast<int>(args.size());
+  if ((spec.arity > 0 && argc != spec.arity) ||
+      (spec.arity < 0 && argc < -spec.arity)) {
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    out.error("ERR wrong number of arguments for '" + name + "' command");
+    return;
+  }
+  try {
+    spec.fn(*store_, args, out);
+  } catch (const std::exception &e) {
+    out.error(std::string("ERR ") + e.what());
+  }
+}
+
+void RespServer::Execute(const RespParser::Command &cmd, std::string &out) {
+  Args args(cmd.begin(), cmd.end());
+  RespReplyBuffer reply;
+  Execute(args, reply);
+  out += reply.str();
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 网络层
+// ══════════════════════════════════════════════════════════════════════════════
+
+RespServer::RespServer(std::shared_ptr<Store> store,
+                       const RespServerOptions &options)
+    : store_(std::move(store)), options_(options) {
+  if (!store_)
+    throw std::invalid_argument("RespServer: store must not be null");
+  if (options_.reactors == 0)
+    options_.reactors = std::max(1u, std::thread::hardware_concurrency());
+}
+
+RespServer::~RespServer() { Stop(); }
+
+void RespServer::Start() {
+  if (running_)
+    return;
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  if (::inet_pton(AF_INET, options_.host.c_str(), &addr.sin_addr) != 1)
+    throw std::runtime_error("RespServer: bad host " + options_.host);
+  port_ = options_.port;
+
+  try {
+    for (size_t i = 0; i < options_.reactors; ++i) {
+      auto r = std::make_unique<Reactor>();
+      Reactor &ref = *r;
+      reactors_.push_back(std::move(r));
+
+      ref.listen_fd =
+          ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (ref.listen_fd < 0)
+        FailErrno("socket");
+      int one = 1;
+      ::setsockopt(ref.listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      if (::setsockopt(ref.listen_fd, SOL_SOCKET, SO_REUSEPORT, &one,
+                       sizeof(one)) != 0)
+        FailErrno("setsockopt(SO_REUSEPORT)");
+      // 端口为 0 时第一个 socket 由内核分配，其余绑定同一端口
+      addr.sin_port = htons(port_);
+      if (::bind(ref.listen_fd, reinterpret_cast<sockaddr *>(&addr),
+                 sizeof(addr)) != 0)
+        FailErrno("bind");
+      if (::listen(ref.listen_fd, options_.backlog) != 0)
+        FailErrno("listen");
+      if (port_ == 0) {
+        sockaddr_in bound{};
+        socklen_t len = sizeof(bound);
+        if (::getsockname(ref.listen_fd, reinterpret_cast<sockaddr *>(&bound),
+                          &len) != 0)
+          FailErrno("getsockname");
+        port_ = ntohs(bound.sin_port);
+      }
+
+      ref.epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+      if (ref.epoll_fd < 0)
+        FailErrno("epoll_create1");
+      ref.wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (ref.wake_fd < 0)
+        FailErrno("eventfd");
+      for (int fd : {ref.listen_fd, ref.wake_fd}) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (::epoll_ctl(ref.epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+          FailErrno("epoll_ctl");
+      }
+    }
+
+    if (!options_.unix_path.empty()) {
+      // 只有一个监听 socket：EPOLLEXCLUSIVE 让每个新连接只唤醒一个 reactor
+      unix_fd_ = ListenUnix(options_.unix_path, options_.backlog);
+      for (auto &r : reactors_) {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.fd = unix_fd_;
+        if (::epoll_ctl(r->epoll_fd, EPOLL_CTL_ADD, unix_fd_, &ev) != 0)
+          FailErrno("epoll_ctl");
+      }
+    }
+  } catch (...) {
+    for (auto &r : reactors_)
+      CloseReactor(*r);
+    reactors_.clear();
+    CloseUnixListener();
+    throw;
+  }
+
+  running_ = true;
+  for (auto &r : reactors_) {
+    Reactor *ptr = r.get();
+    r->thread = std::thread([this, ptr] { RunReactor(*ptr); });
+  }
+}
+
+void RespServer::Stop() {
+  if (!running_)
+    return;
+  for (auto &r : reactors_) {
+    uint64_t one = 1;
+    ssize_t n = ::write(r->wake_fd, &one, sizeof(one));
+    (void)n;
+  }
+  for (auto &r : reactors_) {
+    if (r->thread.joinable())
+      r->thread.join();
+    CloseReactor(*r);
+  }
+  reactors_.clear();
+  CloseUnixListener();
+  running_ = false;
+}
+
+void RespServer::CloseUnixListener() {
+  if (unix_fd_ < 0)
+    return;
+  ::close(unix_fd_);
+  ::unlink(options_.unix_path.c_str());
+  unix_fd_ = -1;
+}
+
+RespServerStats RespServer::Stats() const {
+  RespServerStats s;
+  s.connections_accepted = accepted_.load(std::memory_order_relaxed);
+  s.connections_active = active_.load(std::memory_order_relaxed);
+  s.commands = commands_.load(std::memory_order_relaxed);
+  s.protocol_errors = protocol_errors_.load(std::memory_order_relaxed);
+  return s;
+}
+
+void RespServer::CloseReactor(Reactor &r) {
+  for (auto &[fd, conn] : r.conns) {
+    ::close(fd);
+    active_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  r.conns.clear();
+  for (int *fd : {&r.listen_fd, &r.wake_fd, &r.epoll_fd}) {
+    if (*fd >= 0)
+      ::close(*fd);
+    *fd = -1;
+  }
+}
+
+void RespServer::RunReactor(Reactor &r) {
+  epoll_event events[kMaxEvents];
+  while (true) {
+    int n = ::epoll_wait(r.epoll_fd, events, kMaxEvents, -1);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    for (int i = 0; i < n; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == r.wake_fd)
+        return; // Stop：连接由 CloseReactor 关闭
+      if (fd == r.listen_fd || fd == unix_fd_) {
+        Accept(r, fd);
+        continue;
+      }
+      auto it = r.conns.find(fd);
+      if (it == r.conns.end())
+        continue;
+      Connection &c = it->second;
+      uint32_t ev = events[i].events;
+      bool keep = !(ev & EPOLLERR);
+      if (keep && (ev & (EPOLLIN | EPOLLHUP)))
+        keep = OnReadable(r, c);
+      if (keep && (ev & EPOLLOUT))
+        keep = Flush(r, c);
+      if (!keep)
+        Close(r, fd);
+    }
+  }
+}
+
+void RespServer::Accept(Reactor &r, int listen_fd) {
+  while (true) {
+    int fd =
+        ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR)
+        continue;
+      // EAGAIN：已取完（Unix socket 的连接可能已被其他 reactor 取走）；
+      // 其他错误（如 EMFILE）留给下次事件
+      return;
+    }
+    if (listen_fd == r.listen_fd) {
+      int one = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = fd;
+    if (::epoll_ctl(r.epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      ::close(fd);
+      continue;
+    }
+    Connection &c = r.conns[fd];
+    c.fd = fd;
+    c.events = ev.events;
+    accepted_.fetch_add(1, std::memory_order_relaxed);
+    active_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool RespServer::OnReadable(Reactor &r, Connection &c) {
+  // 直接读进连接缓冲区的空闲尾部，每读一次就解析并执行其中的完整命令；
+  // 回复累积在 c.out 中，读到 EAGAIN 后一次 writev 发出
+  // 回复超限时不再读取（EPOLLHUP 等事件仍会进来），等 Flush 发出去
+  bool peer_closed = false;
+  while (!c.closing && !OutputFull(c)) {
+    if (c.in.size() - c.in_len < kReadChunk)
+      c.in.resize(c.in_len + kReadChunk);
+    size_t room = c.in.size() - c.in_len;
+    ssize_t n = ::read(c.fd, &c.in[c.in_len], room);
+    if (n > 0) {
+      c.in_len += static_cast<size_t>(n);
+      ProcessInput(r, c);
+      if (static_cast<size_t>(n) < room)
+        break;
+      continue;
+    }
+    if (n == 0) {
+      peer_closed = true;
+      break;
+    }
+    if (errno == EINTR)
+      continue;
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      break;
+    return false;
+  }
+
+  if (!Flush(r, c))
+    return false;
+  return !peer_closed;
+}
+
+void RespServer::ProcessInput(Reactor &r, Connection &c) {
+  std::string_view buf(c.in.data(), c.in_len);
+  c.pending = false;
+  while (true) {
+    if (OutputFull(c)) {
+      c.pending = true; // 剩下的命令等回复发出去后再执行
+      break;
+    }
+    auto status = c.parser.next(buf, r.args);
+    if (status == RespParser::Status::INCOMPLETE)
+      break;
+    if (status == RespParser::Status::ERROR) {
+      protocol_errors_.fetch_add(1, std::memory_order_relaxed);
+      c.out.error("ERR Protocol error");
+      c.closing = true;
+      return;
+    }
+    Execute(r.args, c.out); // args 指向 c.in，执行完之前缓冲区不变
+  }
+
+  // 丢弃已执行的命令，只搬移末尾的半条命令
+  size_t done = c.parser.consumed();
+  if (done > 0) {
+    std::memmove(&c.in[0], c.in.data() + done, c.in_len - done);
+    c.in_len -= done;
+    c.parser.discard(done);
+  }
+  if (c.in_len > options_.max_request_bytes) {
+    protocol_errors_.fetch_add(1, std::memory_order_relaxed);
+    c.out.error("ERR Protocol error: request too large");
+    c.closing = true;
+  } else if (c.in_len == 0 && c.in.size() > kMaxIdleBuffer) {
+    std::string().swap(c.in); // 大请求处理完后归还内存
+  }
+}
+
+bool RespServer::Flush(Reactor &r, Connection &c) {
+  iovec iov[kMaxIov];
+  bool blocked = false; // 内核发送缓冲区已满
+  while (true) {
+    blocked = false;
+    while (!c.out.empty()) {
+      size_t count = c.out.gather(iov, kMaxIov);
+      ssize_t n = ::writev(c.fd, iov, static_cast<int>(count));
+      if (n > 0) {
+        c.out.consume(static_cast<size_t>(n));
+        continue;
+      }
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        blocked = true;
+        break;
+      }
+      return false;
+    }
+    // 回复降到上限以下：接着执行暂停时留在缓冲区里的命令
+    if (!c.pending || c.closing || OutputFull(c))
+      break;
+    ProcessInput(r, c);
+  }
+
+  // 写满时注册 EPOLLOUT，可写时继续；回复超限时取消 EPOLLIN 停止读取。
+  // 暂停期间也不关心 EPOLLRDHUP，否则水平触发会一直报告对端半关闭
+  uint32_t events = blocked ? EPOLLOUT : 0;
+  if (!OutputFull(c))
+    events |= EPOLLIN | EPOLLRDHUP;
+  if (events != c.events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = c.fd;
+    ::epoll_ctl(r.epoll_fd, EPOLL_CTL_MOD, c.fd, &ev);
+    c.events = events;
+  }
+  return blocked || !c.closing;
+}
+
+bool RespServer::OutputFull(const Connection &c) const {
+  return options_.max_output_bytes > 0 &&
+         c.out.size() > options_.max_output_bytes;
+}
+
+void RespServer::Close(Reactor &r, int fd) {
+  ::epoll_ctl(r.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+  ::close(fd);
+  r.conns.erase(fd);
+  active_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace server
+} // namespace minkv
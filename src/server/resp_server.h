@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/minkv.h"
+#include "resp_parser.h"
+
+namespace minkv {
+namespace server {
+
+/** RESP 服务器配置 */
+struct RespServerOptions {
+  std::string host = "0.0.0.0";
+  uint16_t port = 6379; // 0 表示由内核分配（测试用），见 RespServer::port()
+  size_t reactors = 0;  // 事件循环（线程）数，0 表示 CPU 核数
+  int backlog = 1024;
+  // 单个连接读缓冲区中未解析完的数据上限，超过视为协议错误并断开
+  size_t max_request_bytes = 64 * 1024 * 1024;
+  // 单个连接待发回复的上限：超过后暂停读取和执行该连接的命令，
+  // 发到上限以下再继续（不读回复的客户端不会让内存无限增长）；
+  // 单条回复本身可以超过它。0 表示不限
+  size_t max_output_bytes = 64 * 1024 * 1024;
+  // 非空时同时监听这个 Unix domain socket（同机客户端，如 redis-cli -s）
+  std::string unix_path;
+};
+
+/** RESP 服务器运行统计 */
+struct RespServerStats {
+  uint64_t connections_accepted = 0;
+  uint64_t connections_active = 0;
+  uint64_t commands = 0;
+  uint64_t protocol_errors = 0;
+};
+
+/**
+ * RespServer — 讲 RESP2 协议的多 reactor epoll TCP 服务器
+ *
+ * 每个 reactor 一个线程、一个 epoll 实例和一个独立的监听 socket，
+ * 各监听 socket 通过 SO_REUSEPORT 绑定同一端口，由内核把新连接分摊到
+ * 各 reactor；连接建立后只归这一个线程处理，reactor 之间不共享状态，
+ * 数据并发由 MinKV 的分片锁负责。
+ *
+ * 每次可读事件把数据直接读进连接的缓冲区，由 RespStreamParser 从上次
+ * 的断点继续解析，取出其中的全部完整命令（客户端 pipeline），参数以
+ * string_view 指向缓冲区，不逐个拷贝；回复累积在 RespReplyBuffer 中，
+ * 读完后一次 writev 发出，写不完时注册 EPOLLOUT 继续发送。待发回复超过
+ * max_output_bytes 时停止读取（取消 EPOLLIN），已读入的命令留在缓冲区，
+ * 回复发到上限以下后接着执行。
+ *
+ * 配置了 unix_path 时另有一个 Unix domain socket 监听，以 EPOLLEXCLUSIVE
+ * 注册到每个 reactor，新连接同样只归接入它的 reactor；同机客户端走它
+ * 可以省掉 TCP 协议栈的开销。
+ *
+ * 支持的命令：
+ *   PING [msg]、ECHO msg
+ *   GET key、SET key value [EX s | PX ms]、DEL key...、EXISTS key...
+ *   MGET key...、MSET key value...
+ *   EXPIRE key s、PEXPIRE key ms、TTL key、PTTL key、PERSIST key
+ *   INCR key、DECR key、INCRBY key n、DECRBY key n
+ *   VSET key x1 x2 ...      写入向量（浮点数按参数逐个给出）
+ *   VGET key                返回向量各分量（bulk string 数组，空向量为空数组）
+ *   VSEARCH k x1 x2 ...     返回最相似的 k 个 key
+ *   DBSIZE、COMMAND、CONFIG GET（redis-benchmark 启动时会发送，返回空结果）
+ */
+class RespServer {
+public:
+  using Store = MinKV<std::string, std::string>;
+
+  explicit RespServer(std::shared_ptr<Store> store,
+                      const RespServerOptions &options = {});
+  ~RespServer();
+
+  RespServer(const RespServer &) = delete;
+  RespServer &operator=(const RespServer &) = delete;
+
+  /**
+   * 绑定端口并启动全部 reactor 线程，立即返回
+   * @throws std::runtime_error socket / bind / listen / epoll 失败
+   */
+  void Start();
+
+  /** 停止全部 reactor，关闭监听 socket 和所有连接；可重复调用 */
+  void Stop();
+
+  /** 实际监听的端口（options.port 为 0 时由内核分配），Start 之后有效 */
+  uint16_t port() const { return port_; }
+
+  RespServerStats Stats() const;
+
+  /**
+   * 执行一条命令，把 RESP 回复追加到 out
+   * 命令错误（未知命令、参数个数 / 类型不对）以 RESP 错误回复，不抛异常
+   */
+  void Execute(const RespStreamParser::Args &args, RespReplyBuffer &out);
+
+  /** 同上，参数和回复为普通字符串（测试和非网络调用方使用） */
+  void Execute(const RespParser::Command &cmd, std::string &out);
+
+private:
+  struct Connection {
+    int fd = -1;
+    std::string in;       // 读缓冲区，前 in_len 字节有效
+    size_t in_len = 0;    // 尚未执行完的请求字节数
+    RespStreamParser parser;
+    RespReplyBuffer out;  // 尚未发出的回复
+    uint32_t events = 0;  // 当前注册的 epoll 事件
+    bool pending = false; // 回复超限时缓冲区里还留有未执行的命令
+    bool closing = false; // 协议错误：发完回复后关闭
+  };
+
+  struct Reactor {
+    int epoll_fd = -1;
+    int listen_fd = -1;
+    int wake_fd = -1; // eventfd，Stop 时唤醒 epoll_wait
+    std::thread thread;
+    std::unordered_map<int, Connection> conns;
+    RespStreamParser::Args args; // 解析结果，各连接复用
+  };
+
+  void RunReactor(Reactor &r);
+  void Accept(Reactor &r, int listen_fd);
+  /** 读取并处理请求；返回 false 表示连接应当关闭 */
+  bool OnReadable(Reactor &r, Connection &c);
+  /**
+   * 执行缓冲区中的完整命令，丢弃已执行的字节；
+   * 回复超过 max_output_bytes 时停下并置 pending
+   */
+  void ProcessInput(Reactor &r, Connection &c);
+  /**
+   * 尽量发出写缓冲区，回复降到上限以下时继续执行 pending 的命令，
+   * 最后按是否写满 / 回复是否超限更新 epoll 事件；
+   * 返回 false 表示连接应当关闭
+   */
+  bool Flush(Reactor &r, Connection &c);
+  /** 待发回复超过 max_output_bytes */
+  bool OutputFull(const Connection &c) const;
+  void Close(Reactor &r, int fd);
+  void CloseReactor(Reactor &r);
+  void CloseUnixListener();
+
+  std::shared_ptr<Store> store_;
+  RespServerOptions options_;
+  uint16_t port_ = 0;
+  int unix_fd_ = -1; // Unix domain socket 监听，各 reactor 共享
+  std::vector<std::unique_ptr<Reactor>> reactors_;
+  bool running_ = false;
+
+  std::atomic<uint64_t> accepted_{0};
+  std::atomic<uint64_t> active_{0};
+  std::atomic<uint64_t> commands_{0};
+  std::atomic<uint64_t> protocol_errors_{0};
+};
+
+} // namespace server
+} // namespace minkv
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace minkv {
+namespace server {
+
+/**
+ * 共享内存传输的段布局（同机客户端，见 ShmServer / client::ShmClient）
+ *
+ *   [ShmSegmentHeader][请求环数据 ring_bytes][响应环数据 ring_bytes]
+ *
+ * 段由服务端用 memfd_create 创建，文件描述符经 Unix domain socket 的
+ * SCM_RIGHTS 交给客户端，双方各自 mmap(MAP_SHARED)。请求环客户端写、
+ * 服务端读，响应环反之，两个环都是单生产者 / 单消费者，不需要锁。
+ */
+struct alignas(64) ShmRingControl {
+  std::atomic<uint64_t> head{0}; // 生产者已发布到的字节位置（单调递增）
+  char pad0[56];
+  std::atomic<uint64_t> tail{0}; // 消费者已释放到的字节位置
+  char pad1[56];
+  // futex 字：生产者发布后 +1，消费者在上面等数据
+  std::atomic<uint32_t> data_seq{0};
+  std::atomic<uint32_t> data_waiters{0};
+  // futex 字：消费者释放后 +1，生产者在上面等空间
+  std::atomic<uint32_t> space_seq{0};
+  std::atomic<uint32_t> space_waiters{0};
+};
+
+struct ShmSegmentHeader {
+  static constexpr uint32_t kMagic = 0x4d4b5652; // "MKVR"
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint64_t ring_bytes = 0;
+  std::atomic<uint32_t> closed{0}; // 服务端停止时置 1，客户端据此报错
+  ShmRingControl requests;
+  ShmRingControl responses;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+
+/**
+ * ShmRing — 共享内存里的 SPSC 消息环（不拥有内存）
+ *
+ * 每条消息是 8 字节头（载荷长度）+ 载荷，按 8 字节对齐。放不下到环尾
+ * 的消息先写一个回绕标记再从 0 开始，所以载荷在内存中总是连续的：
+ * 消费者 peek 拿到的 string_view 直接指向共享内存，处理完 release
+ * 之后生产者才会覆盖这段空间（零拷贝读取）。
+ *
+ * 等待先忙等 spin_us 微秒（单核机器上跳过），之后在 futex 上睡眠。
+ * futex 字在发布 / 释放后递增，睡眠前读到的值与内核中的值不一致时
+ * FUTEX_WAIT 立即返回，所以不会丢唤醒；waiters 计数只用来在没人睡眠
+ * 时省掉 FUTEX_WAKE 系统调用。段是 MAP_SHARED 的，futex 不能用
+ * PRIVATE 版本。
+ */
+class ShmRing {
+public:
+  ShmRing(ShmRingControl *ctl, char *data, uint64_t capacity)
+      : ctl_(ctl), data_(data), capacity_(capacity) {}
+
+  /** 单条消息载荷的上限：保证回绕时总能放下 */
+  size_t max_message() const { return capacity_ / 2 - kHeader; }
+
+  // ── 生产者 ───────────────────────────────────────────────────
+
+  /**
+   * 预留一条 len 字节消息的连续空间，返回载荷的写入位置
+   * 空间不足时返回 nullptr（可以 wait_space 后重试），写完调用 commit
+   * @throws std::length_error len 超过 max_message()
+   */
+  char *reserve(size_t len) {
+    if (len > max_message())
+      throw std::length_error("ShmRing: message too large");
+    uint64_t rec = record_size(len);
+    uint64_t skip = wrap_skip(rec);
+    if (!fits(skip + rec))
+      return nullptr;
+    uint64_t idx =
+        ctl_->head.load(std::memory_order_relaxed) & (capacity_ - 1);
+    if (skip != 0) {
+      write_header(idx, kWrap);
+      idx = 0;
+    }
+    write_header(idx, static_cast<uint32_t>(len));
+    reserved_ = skip + rec;
+    return data_ + idx + kHeader;
+  }
+
+  /** 发布 reserve 得到的消息并唤醒消费者 */
+  void commit() {
+    ctl_->head.store(ctl_->head.load(std::memory_order_relaxed) + reserved_,
+                     std::memory_order_release);
+    reserved_ = 0;
+    notify(ctl_->data_seq, ctl_->data_waiters);
+  }
+
+  /** 等到能放下 len 字节的消息；超时返回 false */
+  bool wait_space(size_t len, int spin_us, int timeout_ms) {
+    uint64_t rec = record_size(len);
+    uint64_t need = wrap_skip(rec) + rec; // head 只由生产者移动，等待期间不变
+    return wait(ctl_->space_seq, ctl_->space_waiters, spin_us, timeout_ms,
+                [&] { return fits(need); });
+  }
+
+  // ── 消费者 ───────────────────────────────────────────────────
+
+  /**
+   * 取下一条消息（不移除），msg 指向共享内存，release 之前有效
+   * @return 环为空时返回 false
+   * @throws std::runtime_error 消息头不合法（对端写坏了共享内存）
+   */
+  bool peek(std::string_view &msg) {
+    uint64_t tail = ctl_->tail.load(std::memory_order_relaxed);
+    uint64_t head = ctl_->head.load(std::memory_order_acquire);
+    if (tail == head)
+      return false;
+    uint64_t idx = tail & (capacity_ - 1);
+    uint32_t len = read_header(idx);
+    if (len == kWrap) {
+      tail += capacity_ - idx;
+      idx = 0;
+      len = read_header(idx);
+    }
+    uint64_t end = tail + record_size(len);
+    if (len > max_message() || end > head)
+      throw std::runtime_error("ShmRing: corrupted message header");
+    msg = std::string_view(data_ + idx + kHeader, len);
+    peeked_end_ = end;
+    return true;
+  }
+
+  /** 释放 peek 得到的消息（必须先 peek 成功），其空间可以被生产者复用 */
+  void release() {
+    ctl_->tail.store(peeked_end_, std::memory_order_release);
+    notify(ctl_->space_seq, ctl_->space_waiters);
+  }
+
+  /** 等到环非空；超时返回 false */
+  bool wait_data(int spin_us, int timeout_ms) {
+    return wait(ctl_->data_seq, ctl_->data_waiters, spin_us, timeout_ms, [&] {
+      return ctl_->head.load(std::memory_order_acquire) !=
+             ctl_->tail.load(std::memory_order_relaxed);
+    });
+  }
+
+  /** 唤醒在数据上睡眠的消费者（停止时用，不发布消息） */
+  void wake_consumer() {
+    ctl_->data_seq.fetch_add(1, std::memory_order_seq_cst);
+    futex_wake(ctl_->data_seq);
+  }
+
+private:
+  static constexpr uint64_t kHeader = 8;
+  static constexpr uint32_t kWrap = UINT32_MAX;
+
+  static uint64_t record_size(uint64_t len) {
+    return kHeader + ((len + 7) & ~uint64_t(7));
+  }
+
+  // 一条 rec 字节的记录放不下到环尾时，回绕需要跳过的字节数
+  uint64_t wrap_skip(uint64_t rec) const {
+    uint64_t to_end =
+        capacity_ - (ctl_->head.load(std::memory_order_relaxed) &
+                     (capacity_ - 1));
+    return rec <= to_end ? 0 : to_end;
+  }
+
+  bool fits(uint64_t bytes) const {
+    uint64_t used = ctl_->head.load(std::memory_order_relaxed) -
+                    ctl_->tail.load(std::memory_order_acquire);
+    return capacity_ - used >= bytes;
+  }
+
+  // 单核上忙等只会占住对端需要的 CPU，直接睡眠让出
+  static bool multi_core() {
+    static const bool multi = ::sysconf(_SC_NPROCESSORS_ONLN) > 1;
+    return multi;
+  }
+
+  static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  }
+
+  void write_header(uint64_t idx, uint32_t len) {
+    std::memcpy(data_ + idx, &len, sizeof(len));
+  }
+
+  uint32_t read_header(uint64_t idx) const {
+    uint32_t len;
+    std::memcpy(&len, data_ + idx, sizeof(len));
+    return len;
+  }
+
+  static void futex_wait(std::atomic<uint32_t> &word, uint32_t expected,
+                         int timeout_ms) {
+    timespec ts{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT,
+              expected, timeout_ms < 0 ? nullptr : &ts, nullptr, 0);
+  }
+
+  static void futex_wake(std::atomic<uint32_t> &word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE,
+              INT_MAX, nullptr, nullptr, 0);
+  }
+
+  static void notify(std::atomic<uint32_t> &seq,
+                     std::atomic<uint32_t> &waiters) {
+    seq.fetch_add(1, std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_seq_cst) != 0)
+      futex_wake(seq);
+  }
+
+  template <typename Ready>
+  static bool wait(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiters,
+                   int spin_us, int timeout_ms, Ready ready) {
+    if (ready())
+      return true;
+    if (spin_us > 0 && multi_core()) {
+      timespec start;
+      ::clock_gettime(CLOCK_MONOTONIC, &start);
+      while (true) {
+        for (int i = 0; i < 64; ++i) {
+          if (ready())
+            return true;
+          cpu_relax();
+        }
+        timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        int64_t elapsed_us = (now.tv_sec - start.tv_sec) * 1000000 +
+                             (now.tv_nsec - start.tv_nsec) / 1000;
+        if (elapsed_us >= spin_us)
+          break;
+      }
+    }
+    // 先读 futex 字再检查条件：检查之后才发生的发布会改变 futex 字，
+    // FUTEX_WAIT 发现值不符会立即返回
+    uint32_t observed = seq.load(std::memory_order_acquire);
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    bool ok = ready();
+    if (!ok) {
+      futex_wait(seq, observed, timeout_ms);
+      ok = ready();
+    }
+    waiters.fetch_sub(1, std::memory_order_seq_cst);
+    return ok;
+  }
+
+  ShmRingControl *ctl_;
+  char *data_;
+  uint64_t capacity_;
+  uint64_t reserved_ = 0;   // reserve 后待发布的字节数（含回绕）
+  uint64_t peeked_end_ = 0; // peek 到的消息之后的位置
+};
+
+/**
+ * ShmSegment — 一段 memfd 共享内存的所有者（mmap + fd），只能移动
+ */
+class ShmSegment {
+public:
+  ShmSegment() = default;
+  ShmSegment(const ShmSegment &) = delete;
+  ShmSegment &operator=(const ShmSegment &) = delete;
+  ShmSegment(ShmSegment &&other) noexcept { *this = std::move(other); }
+  ShmSegment &operator=(ShmSegment &&other) noexcept {
+    if (this != &other) {
+      reset();
+      std::swap(fd_, other.fd_);
+      std::swap(base_, other.base_);
+      std::swap(size_, other.size_);
+    }
+    return *this;
+  }
+  ~ShmSegment() { reset(); }
+
+  /**
+   * 创建并初始化一段新的共享内存（服务端）
+   * @param ring_bytes 每个环的大小，必须是 2 的幂且不小于 4 KiB
+   * @throws std::invalid_argument / std::runtime_error
+   */
+  static ShmSegment Create(uint64_t ring_bytes) {
+    if (ring_bytes < 4096 || (ring_bytes & (ring_bytes - 1)) != 0)
+      throw std::invalid_argument(
+          "ShmSegment: ring_bytes must be a power of two >= 4096");
+    ShmSegment seg;
+    seg.fd_ = ::memfd_create("minkv-shm", MFD_CLOEXEC);
+    if (seg.fd_ < 0)
+      fail("memfd_create");
+    seg.size_ = sizeof(ShmSegmentHeader) + 2 * ring_bytes;
+    if (::ftruncate(seg.fd_, static_cast<off_t>(seg.size_)) != 0)
+      fail("ftruncate");
+    seg.map();
+    auto *hdr = new (seg.base_) ShmSegmentHeader();
+    hdr->ring_bytes = ring_bytes;
+    return seg;
+  }
+
+  /**
+   * 映射对端发来的共享内存（客户端），接管 fd
+   * @throws std::runtime_error 大小或头部不合法
+   */
+  static ShmSegment Attach(int fd) {
+    ShmSegment seg;
+    seg.fd_ = fd;
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+      fail("fstat");
+    seg.size_ = static_cast<size_t>(st.st_size);
+    if (seg.size_ < sizeof(ShmSegmentHeader))
+      throw std::runtime_error("ShmSegment: segment too small");
+    seg.map();
+    const ShmSegmentHeader *hdr = seg.header();
+    uint64_t ring = hdr->ring_bytes;
+    if (hdr->magic != ShmSegmentHeader::kMagic ||
+        hdr->version != ShmSegmentHeader::kVersion || ring < 4096 ||
+        (ring & (ring - 1)) != 0 ||
+        seg.size_ != sizeof(ShmSegmentHeader) + 2 * ring)
+      throw std::runtime_error("ShmSegment: bad segment header");
+    return seg;
+  }
+
+  int fd() const { return fd_; }
+  ShmSegmentHeader *header() const {
+    return static_cast<ShmSegmentHeader *>(base_);
+  }
+
+  ShmRing requests() const {
+    return ShmRing(&header()->requests, ring_data(0), header()->ring_bytes);
+  }
+  ShmRing responses() const {
+    return ShmRing(&header()->responses, ring_data(1), header()->ring_bytes);
+  }
+
+private:
+  [[noreturn]] static void fail(const char *op) {
+    throw std::runtime_error(std::string("ShmSegment: ") + op +
+                             " failed: " + std::strerror(errno));
+  }
+
+  void map() {
+    void *p = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                     0);
+    if (p == MAP_FAILED)
+      fail("mmap");
+    base_ = p;
+  }
+
+  char *ring_data(int i) const {
+    return static_cast<char *>(base_) + sizeof(ShmSegmentHeader) +
+           i * header()->ring_bytes;
+  }
+
+  void reset() {
+    if (base_)
+      ::munmap(base_, size_);
+    if (fd_ >= 0)
+      ::close(fd_);
+    base_ = nullptr;
+    fd_ = -1;
+    size_ = 0;
+  }
+
+  int fd_ = -1;
+  void *base_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace server
+} // namespace minkv
@@ -0,0 +1,210 @@
+#include "shm_server.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "unix_socket.h"
+
+namespace minkv {
+namespace server {
+
+namespace {
+
+constexpr size_t kMaxIov = 64;
+
+// 把回复的全部分段拷进 dst（共享内存），拷完后 reply 为空
+void CopyReply(RespReplyBuffer &reply, char *dst) {
+  iovec iov[kMaxIov];
+  while (!reply.empty()) {
+    size_t count = reply.gather(iov, kMaxIov);
+    size_t copied = 0;
+    for (size_t i = 0; i < count; ++i) {
+      std::memcpy(dst + copied, iov[i].iov_base, iov[i].iov_len);
+      copied += iov[i].iov_len;
+    }
+    reply.consume(copied);
+    dst += copied;
+  }
+}
+
+} // namespace
+
+ShmServer::ShmServer(std::shared_ptr<Store> store,
+                     const ShmServerOptions &options)
+    : executor_(std::move(store)), options_(options) {
+  if (options_.path.empty())
+    throw std::invalid_argument("ShmServer: path must not be empty");
+  if (options_.ring_bytes < 4096 ||
+      (options_.ring_bytes & (options_.ring_bytes - 1)) != 0)
+    throw std::invalid_argument(
+        "ShmServer: ring_bytes must be a power of two >= 4096");
+}
+
+ShmServer::~ShmServer() { Stop(); }
+
+void ShmServer::Start() {
+  if (running_)
+    return;
+  listen_fd_ = ListenUnix(options_.path, 128);
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ < 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    throw std::runtime_error(std::string("ShmServer: eventfd failed: ") +
+                             std::strerror(errno));
+  }
+  running_ = true;
+  accept_thread_ = std::thread([this] { AcceptLoop(); });
+}
+
+void ShmServer::Stop() {
+  if (!running_.exchange(false))
+    return;
+  uint64_t one = 1;
+  ssize_t n = ::write(wake_fd_, &one, sizeof(one));
+  (void)n;
+  if (accept_thread_.joinable())
+    accept_thread_.join();
+
+  // 客户端线程可能睡在 futex 上：置 closed 并唤醒，等它们看到 running_
+  std::list<Client> clients;
+  {
+    std::lock_guard<std::mutex> lock(clients_mu_);
+    clients.swap(clients_);
+  }
+  for (auto &c : clients) {
+    c.segment.header()->closed.store(1, std::memory_order_release);
+    c.segment.requests().wake_consumer();
+    c.segment.responses().wake_consumer(); // 正在等回复的客户端
+  }
+  for (auto &c : clients) {
+    if (c.thread.joinable())
+      c.thread.join();
+    ::close(c.fd);
+  }
+
+  ::close(listen_fd_);
+  ::close(wake_fd_);
+  listen_fd_ = wake_fd_ = -1;
+  ::unlink(options_.path.c_str());
+}
+
+ShmServerStats ShmServer::Stats() const {
+  ShmServerStats s;
+  s.clients_accepted = accepted_.load(std::memory_order_relaxed);
+  s.clients_active = active_.load(std::memory_order_relaxed);
+  s.requests = requests_.load(std::memory_order_relaxed);
+  return s;
+}
+
+void ShmServer::AcceptLoop() {
+  pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+  while (running_) {
+    int n = ::poll(fds, 2, options_.poll_ms);
+    Reap();
+    if (n < 0 && errno != EINTR)
+      return;
+    if (n <= 0 || (fds[1].revents & POLLIN))
+      continue; // 超时 / 信号；Stop 时 running_ 已为 false
+    while (true) {
+      int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (fd < 0)
+        break; // EAGAIN：已取完
+      try {
+        Admit(fd);
+      } catch (const std::exception &e) {
+        std::cerr << "[ShmServer] " << e.what() << "\n";
+        ::close(fd);
+      }
+    }
+  }
+}
+
+void ShmServer::Admit(int fd) {
+  ShmSegment segment = ShmSegment::Create(options_.ring_bytes);
+  if (!SendFd(fd, segment.fd()))
+    throw std::runtime_error("ShmServer: failed to pass segment to client");
+
+  std::lock_guard<std::mutex> lock(clients_mu_);
+  Client &c = clients_.emplace_back();
+  c.fd = fd;
+  c.segment = std::move(segment);
+  accepted_.fetch_add(1, std::memory_order_relaxed);
+  active_.fetch_add(1, std::memory_order_relaxed);
+  c.thread = std::thread([this, &c] { Serve(c); });
+}
+
+void ShmServer::Reap() {
+  std::lock_guard<std::mutex> lock(clients_mu_);
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    if (!it->finished.load(std::memory_order_acquire)) {
+      ++it;
+      continue;
+    }
+    it->thread.join();
+    ::close(it->fd);
+    it = clients_.erase(it);
+  }
+}
+
+void ShmServer::Serve(Client &c) {
+  ShmRing requests = c.segment.requests();
+  ShmRing responses = c.segment.responses();
+  RespStreamParser parser;
+  RespStreamParser::Args args;
+  RespReplyBuffer reply;
+
+  try {
+    while (running_) {
+      std::string_view msg;
+      if (!requests.peek(msg)) {
+        if (!requests.wait_data(options_.spin_us, options_.poll_ms) &&
+            PeerClosed(c.fd))
+          break;
+        continue;
+      }
+
+      // 每条消息恰好是一条 RESP 命令；参数指向共享内存，执行完才释放
+      parser.reset();
+      if (parser.next(msg, args) != RespParser::Status::OK ||
+          parser.consumed() != msg.size() || args.empty()) {
+        reply.error("ERR Protocol error");
+      } else {
+        executor_.Execute(args, reply);
+      }
+      if (reply.size() > responses.max_message()) {
+        reply.consume(reply.size());
+        reply.error("ERR reply too large for shared-memory ring");
+      }
+
+      size_t len = reply.size();
+      char *dst;
+      while ((dst = responses.reserve(len)) == nullptr) {
+        // 客户端还没读走之前的回复（pipeline）
+        if (!running_ || (!responses.wait_space(len, options_.spin_us,
+                                                 options_.poll_ms) &&
+                          PeerClosed(c.fd)))
+          throw std::runtime_error("client gone");
+      }
+      CopyReply(reply, dst);
+      responses.commit();
+      requests.release();
+      requests_.fetch_add(1, std::memory_order_relaxed);
+    }
+  } catch (const std::exception &) {
+    // 客户端退出或写坏了共享内存：只影响这一个客户端
+  }
+  active_.fetch_sub(1, std::memory_order_relaxed);
+  c.finished.store(true, std::memory_order_release);
+}
+
+} // namespace server
+} // namespace minkv
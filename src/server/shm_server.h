@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../core/minkv.h"
+#include "resp_server.h"
+#include "shm_ring.h"
+
+namespace minkv {
+namespace server {
+
+/** 共享内存传输服务端配置 */
+struct ShmServerOptions {
+  std::string path;              // 控制 socket（Unix domain socket）路径
+  uint64_t ring_bytes = 4 << 20; // 每个方向的环大小，2 的幂
+  int spin_us = 50;              // 在 futex 上睡眠之前忙等的时间
+  int poll_ms = 100;             // 睡眠超时，超时后检查客户端是否断开
+};
+
+/** 共享内存传输运行统计 */
+struct ShmServerStats {
+  uint64_t clients_accepted = 0;
+  uint64_t clients_active = 0;
+  uint64_t requests = 0;
+};
+
+/**
+ * ShmServer — 给同机客户端用的共享内存传输
+ *
+ * 客户端连上控制 socket 后，服务端为它创建一段 memfd 共享内存（请求环 +
+ * 响应环，见 shm_ring.h），用 SCM_RIGHTS 把 fd 发过去，之后所有请求都
+ * 走共享内存，控制 socket 只用来感知客户端退出（对端关闭）。
+ *
+ * 每个客户端一个服务线程：请求环中每条消息是一条 RESP 命令，参数以
+ * string_view 直接指向共享内存，由 RespServer::Execute 执行（命令集与
+ * RESP 服务器相同），回复写进响应环后才释放请求。空闲时先忙等
+ * spin_us，再在 futex 上睡眠，省掉 TCP 协议栈和 epoll 唤醒的开销。
+ *
+ * 适用于少量长连接的 sidecar 客户端；客户端多时每个线程的空闲成本
+ * 只有一次 futex 等待，但线程数随客户端数增长。
+ */
+class ShmServer {
+public:
+  using Store = MinKV<std::string, std::string>;
+
+  ShmServer(std::shared_ptr<Store> store, const ShmServerOptions &options);
+  ~ShmServer();
+
+  ShmServer(const ShmServer &) = delete;
+  ShmServer &operator=(const ShmServer &) = delete;
+
+  /**
+   * 创建控制 socket（已存在的同名文件会被删除）并启动接入线程
+   * @throws std::runtime_error socket / bind / listen 失败
+   */
+  void Start();
+
+  /** 停止接入，通知并等待全部客户端线程退出，删除 socket 文件 */
+  void Stop();
+
+  ShmServerStats Stats() const;
+
+private:
+  struct Client {
+    int fd = -1; // 控制 socket
+    ShmSegment segment;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+  };
+
+  void AcceptLoop();
+  /** 建立一个客户端：创建共享内存并把 fd 发给它 */
+  void Admit(int fd);
+  void Serve(Client &c);
+  /** 回收已退出的客户端线程 */
+  void Reap();
+
+  RespServer executor_; // 只用 Execute，不监听
+  ShmServerOptions options_;
+  int listen_fd_ = -1;
+  int wake_fd_ = -1;
+  std::thread accept_thread_;
+  std::atomic<bool> running_{false};
+
+  std::mutex clients_mu_;
+  std::list<Client> clients_;
+
+  std::atomic<uint64_t> accepted_{0};
+  std::atomic<uint64_t> active_{0};
+  std::atomic<uint64_t> requests_{0};
+};
+
+} // namespace server
+} // namespace minkv
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace minkv {
+namespace server {
+
+/**
+ * Unix domain socket 工具函数（RESP / HTTP 的本机监听和共享内存传输的
+ * 控制连接共用）
+ *
+ * 失败时抛 std::runtime_error，消息带上操作名和 strerror。
+ */
+
+inline sockaddr_un UnixAddress(const std::string &path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path))
+    throw std::runtime_error("unix socket path empty or too long: " + path);
+  std::memcpy(addr.sun_path, path.data(), path.size());
+  return addr;
+}
+
+[[noreturn]] inline void FailUnixSocket(const char *op,
+                                        const std::string &path) {
+  throw std::runtime_error(std::string("unix socket ") + op + " " + path +
+                           " failed: " + std::strerror(errno));
+}
+
+/**
+ * 在 path 上监听（非阻塞），先删除同名的旧 socket 文件
+ * 调用方负责 close 并在停止时 unlink(path)
+ */
+inline int ListenUnix(const std::string &path, int backlog) {
+  sockaddr_un addr = UnixAddress(path);
+  int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    FailUnixSocket("socket", path);
+  ::unlink(path.c_str()); // 上次未正常退出留下的文件
+  if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      ::listen(fd, backlog) != 0) {
+    int saved = errno;
+    ::close(fd);
+    errno = saved;
+    FailUnixSocket("bind/listen", path);
+  }
+  return fd;
+}
+
+/** 阻塞式连接到 path */
+inline int ConnectUnix(const std::string &path) {
+  sockaddr_un addr = UnixAddress(path);
+  int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    FailUnixSocket("socket", path);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    int saved = errno;
+    ::close(fd);
+    errno = saved;
+    FailUnixSocket("connect", path);
+  }
+  return fd;
+}
+
+/** 不阻塞地检查对端是否已关闭连接（进程退出时内核会关闭它的 socket） */
+inline bool PeerClosed(int fd) {
+  char byte;
+  ssize_t n = ::recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (n == 0)
+    return true;
+  return n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+}
+
+/** 经 SCM_RIGHTS 发送一个文件描述符，附带 1 字节数据；失败返回 false */
+inline bool SendFd(int sock, int fd) {
+  char byte = 0;
+  iovec iov{&byte, 1};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+  ssize_t n;
+  do {
+    n = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+  } while (n < 0 && errno == EINTR);
+  return n == 1;
+}
+
+/** 阻塞接收 SendFd 发来的文件描述符；失败返回 -1 */
+inline int RecvFd(int sock) {
+  char byte;
+  iovec iov{&byte, 1};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t n;
+  do {
+    n = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+  } while (n < 0 && errno == EINTR);
+  if (n != 1)
+    return -1;
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  if (!cmsg || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(int)))
+    return -1;
+  int fd;
+  std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+  return fd;
+}
+
+} // namespace server
+} // namespace minkv
@@ -3,6 +3,8 @@
 #include <immintrin.h> // AVX/AVX2
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -259,4 +261,99 @@ public:
 
     return similarities;
   }
+
+  // ==========================================
+  // Phase 5: 传输层 (fp16 编解码)
+  // ==========================================
+
+  /**
+   * IEEE 754 半精度 -> 单精度（精确，无舍入）
+   */
+  static float HalfToFloat(uint16_t h) {
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1f;
+    uint32_t mant = h & 0x3ff;
+    uint32_t bits;
+    if (exp == 0x1f) {
+      bits = sign | 0x7f800000 | (mant << 13); // Inf / NaN
+    } else if (exp != 0) {
+      bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    } else if (mant == 0) {
+      bits = sign; // ±0
+    } else {
+      // 半精度非规格化数在单精度里是规格化数：左移到隐含位出现
+      exp = 127 - 15 + 1;
+      while (!(mant & 0x400)) {
+        mant <<= 1;
+        --exp;
+      }
+      bits = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+
+  /**
+   * 单精度 -> 半精度，就近舍入（平局取偶），超出范围变为 ±Inf
+   */
+  static uint16_t FloatToHalf(float f) {
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    uint16_t sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    uint32_t exp = (x >> 23) & 0xff;
+    uint32_t mant = x & 0x7fffff;
+    if (exp == 0xff) // Inf / NaN（NaN 保持为 quiet NaN）
+      return sign | 0x7c00 | (mant ? 0x200 : 0);
+
+    int32_t e = static_cast<int32_t>(exp) - 127 + 15;
+    if (e >= 0x1f)
+      return sign | 0x7c00;
+    uint32_t half, rem, halfway;
+    if (e <= 0) {
+      // 结果是非规格化数（或下溢为 0）
+      if (e < -10)
+        return sign;
+      mant |= 0x800000;
+      uint32_t shift = static_cast<uint32_t>(14 - e);
+      half = mant >> shift;
+      rem = mant & ((1u << shift) - 1);
+      halfway = 1u << (shift - 1);
+    } else {
+      half = (static_cast<uint32_t>(e) << 10) | (mant >> 13);
+      rem = mant & 0x1fff;
+      halfway = 0x1000;
+    }
+    // 进位可能溢出到指数位，结果仍然正确（最大有限值舍入为 Inf）
+    if (rem > halfway || (rem == halfway && (half & 1)))
+      ++half;
+    return static_cast<uint16_t>(sign | half);
+  }
+
+  /**
+   * 把 dim 个 fp16（小端字节）直接解码成与 Serialize 相同的存储格式
+   * 用于二进制传输：请求体解码后直接写入存储，不经过 vector<float>
+   */
+  static std::string SerializeFromHalf(const char *half_data, size_t dim) {
+    std::string out(dim * sizeof(float), '\0');
+    float *dst = reinterpret_cast<float *>(&out[0]);
+    for (size_t i = 0; i < dim; ++i) {
+      uint16_t h;
+      std::memcpy(&h, half_data + i * sizeof(h), sizeof(h));
+      dst[i] = HalfToFloat(h);
+    }
+    return out;
+  }
+
+  /**
+   * 把 fp32 数组编码为 fp16 字节（小端），用于二进制响应
+   */
+  static std::string EncodeHalf(const float *data, size_t dim) {
+    std::string out(dim * sizeof(uint16_t), '\0');
+    for (size_t i = 0; i < dim; ++i) {
+      uint16_t h = FloatToHalf(data[i]);
+      std::memcpy(&out[i * sizeof(h)], &h, sizeof(h));
+    }
+    return out;
+  }
 };
@@ -0,0 +1,145 @@
+/**
+ * 准入控制压测：昂贵端点被打满时便宜端点的延迟
+ *
+ * 进程内启动 HttpServer（30000 个 128 维向量 + 10000 个 KV），
+ * F 个线程不停发 /vector/search（暴力检索，每次数毫秒），同时 2 个
+ * 线程发 /kv/get 并记录延迟，持续 D 秒。分别在关闭和开启准入控制下
+ * 运行，输出 /kv/get 的 p50 / p99 延迟、检索吞吐和 503 数：
+ *
+ *   off  所有请求都在 httplib 工作线程上直接执行，F 个检索抢满 CPU
+ *   on   检索在独立线程池（CPU 核数）中执行并受 AIMD 上限约束，
+ *        超出的快速 503；KV 请求不排在检索后面
+ *
+ *   admission_benchmark [flood_threads] [seconds]   默认 16、3
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "server/http_server.h"
+#include "server/httplib.h"
+
+using namespace minkv;
+using namespace minkv::server;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPort = 18100;
+constexpr int kDim = 128;
+constexpr int kVectors = 30000;
+constexpr int kKeys = 10000;
+constexpr int kReaders = 2;
+
+std::string SearchBody() {
+  std::string body = "{\"top_k\": 10, \"query\": [";
+  for (int i = 0; i < kDim; ++i)
+    body += (i ? ",0.5" : "0.5");
+  return body + "]}";
+}
+
+double Percentile(std::vector<double> &v, double p) {
+  if (v.empty())
+    return 0;
+  size_t i = static_cast<size_t>(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+void Run(const char *name, std::shared_ptr<StringKV> kv, bool enabled,
+         int flood, int seconds) {
+  HttpServer server(kv, nullptr, "127.0.0.1", kPort);
+  HttpAdmissionOptions options;
+  options.enabled = enabled;
+  server.set_admission_options(options);
+  if (!server.start_async()) {
+    std::fprintf(stderr, "failed to start HTTP server\n");
+    std::exit(1);
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> searches{0}, rejected{0};
+  std::vector<std::vector<double>> latencies(kReaders);
+  std::vector<std::thread> threads;
+  std::string body = SearchBody();
+  for (int t = 0; t < flood; ++t) {
+    threads.emplace_back([&] {
+      httplib::Client cli("127.0.0.1", kPort);
+      cli.set_keep_alive(true);
+      while (!stop) {
+        auto res = cli.Post("/vector/search", body, "application/json");
+        if (res && res->status == 200)
+          ++searches;
+        else if (res && res->status == 503)
+          ++rejected;
+      }
+    });
+  }
+  for (int t = 0; t < kReaders; ++t) {
+    threads.emplace_back([&, t] {
+      httplib::Client cli("127.0.0.1", kPort);
+      cli.set_keep_alive(true);
+      std::mt19937 rng(t);
+      while (!stop) {
+        auto start = Clock::now();
+        auto res = cli.Get("/kv/get?key=k" + std::to_string(rng() % kKeys));
+        if (res && res->status == 200)
+          latencies[t].push_back(
+              std::chrono::duration<double, std::micro>(Clock::now() - start)
+                  .count());
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  stop = true;
+  for (auto &t : threads)
+    t.join();
+  server.stop();
+
+  std::vector<double> all;
+  for (auto &v : latencies)
+    all.insert(all.end(), v.begin(), v.end());
+  std::printf("%-4s kv/get p50 %8.0f us  p99 %8.0f us  (%zu reqs)   "
+              "search %6.0f ok/s  %7.0f 503/s\n",
+              name, Percentile(all, 0.5), Percentile(all, 0.99), all.size(),
+              static_cast<double>(searches) / seconds,
+              static_cast<double>(rejected) / seconds);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int flood = argc >= 2 ? std::atoi(argv[1]) : 16;
+  int seconds = argc >= 3 ? std::atoi(argv[2]) : 3;
+  if (flood <= 0 || seconds <= 0) {
+    std::fprintf(stderr, "usage: %s [flood_threads] [seconds]\n", argv[0]);
+    return 1;
+  }
+
+  std::shared_ptr<StringKV> kv = StringKV::create(65536, 16);
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::vector<float> v(kDim);
+  for (int i = 0; i < kVectors; ++i) {
+    for (auto &x : v)
+      x = dist(rng);
+    kv->vectorPut("vec:" + std::to_string(i), v);
+  }
+  for (int i = 0; i < kKeys; ++i)
+    kv->put("k" + std::to_string(i), std::string(128, 'x'));
+
+  std::printf("\n%d search threads + %d kv/get threads, %d s each\n\n", flood,
+              kReaders, seconds);
+  Run("off", kv, false, flood, seconds);
+  Run("on", kv, true, flood, seconds);
+  return 0;
+}
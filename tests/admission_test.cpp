@@ -0,0 +1,410 @@
+/**
+ * 准入控制测试
+ *
+ * 单元测试（AdmissionLimiter）：
+ *   - 固定上限：名额用完后队列满立即拒绝、排队超时拒绝、归还名额唤醒排队者
+ *   - AIMD：耗时超过目标时每个窗口至多乘性减一次，不低于 min_limit；
+ *     上限用满且未超时时加性增长，不超过 max_limit
+ *   - 配置不合法时抛 std::invalid_argument
+ * 端到端测试（进程内 HttpServer）：
+ *   - 昂贵端点超过并发上限时回 503 + Retry-After，/stats/admission 的
+ *     计数与客户端看到的一致；/health 不限流
+ *   - 运行中不能修改配置；关闭准入控制后不再限流
+ *   - /kv/scan 的名额占到流式响应发送完为止，而不是处理器返回时
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "server/admission.h"
+#include "server/http_server.h"
+#include "server/httplib.h"
+
+using namespace minkv;
+using namespace minkv::server;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+using Result = AdmissionLimiter::Result;
+
+static AdmissionLimits fixed_limits(size_t limit, size_t max_queue,
+                                    int timeout_ms) {
+  AdmissionLimits limits;
+  limits.initial_limit = limit;
+  limits.min_limit = 1;
+  limits.max_limit = limit;
+  limits.max_queue = max_queue;
+  limits.queue_timeout_ms = timeout_ms;
+  return limits;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// AdmissionLimiter
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_fixed_limit() {
+  {
+    AdmissionLimiter limiter(fixed_limits(2, 0, 0));
+    CHECK(limiter.Acquire() == Result::Admitted, "first permit");
+    CHECK(limiter.Acquire() == Result::Admitted, "second permit");
+    CHECK(limiter.Acquire() == Result::QueueFull,
+          "max_queue 0 should reject at once");
+    AdmissionStats s = limiter.Stats();
+    CHECK(s.in_flight == 2 && s.admitted == 2 && s.rejected_queue_full == 1,
+          "stats after rejection");
+    limiter.Release(1);
+    CHECK(limiter.Acquire() == Result::Admitted, "released slot reusable");
+  }
+  {
+    AdmissionLimiter limiter(fixed_limits(1, 1, 30));
+    CHECK(limiter.Acquire() == Result::Admitted, "only permit");
+    auto start = std::chrono::steady_clock::now();
+    CHECK(limiter.Acquire() == Result::Timeout, "queued request times out");
+    auto waited = std::chrono::steady_clock::now() - start;
+    CHECK(waited >= std::chrono::milliseconds(25), "timeout honoured");
+    CHECK(limiter.Stats().rejected_timeout == 1, "timeout counted");
+    CHECK(limiter.Stats().queued == 0, "queue empty after timeout");
+  }
+  {
+    // 归还名额唤醒排队者；排队期间再来的请求因队列满被拒绝
+    AdmissionLimiter limiter(fixed_limits(1, 1, 5000));
+    CHECK(limiter.Acquire() == Result::Admitted, "holder");
+    auto waiter = std::async(std::launch::async, [&] {
+      return limiter.Acquire();
+    });
+    while (limiter.Stats().queued == 0)
+      std::this_thread::yield();
+    CHECK(limiter.Acquire() == Result::QueueFull, "queue of one is full");
+    limiter.Release(1);
+    CHECK(waiter.get() == Result::Admitted, "waiter admitted after release");
+    AdmissionStats s = limiter.Stats();
+    CHECK(s.in_flight == 1 && s.queued == 0 && s.admitted == 2,
+          "stats after hand-off");
+  }
+  {
+    AdmissionLimiter limiter(fixed_limits(1, 0, 0));
+    {
+      AdmissionLimiter::Permit a(limiter);
+      AdmissionLimiter::Permit b(limiter);
+      CHECK(a && !b, "second permit rejected");
+      CHECK(b.result() == Result::QueueFull, "rejection reason");
+    }
+    CHECK(limiter.Stats().in_flight == 0, "permit released on scope exit");
+  }
+  PASS("fixed_limit");
+  return true;
+}
+
+static bool test_aimd() {
+  AdmissionLimits limits;
+  limits.initial_limit = 10;
+  limits.min_limit = 8;
+  limits.max_limit = 12;
+  limits.max_queue = 0;
+  limits.target_latency_ms = 10;
+
+  {
+    AdmissionLimiter limiter(limits);
+    // 每完成上限个请求至多减一次：10 -> 9（10 个慢请求）-> 8（再 9 个）
+    for (int i = 0; i < 9; ++i) {
+      limiter.Acquire();
+      limiter.Release(50);
+    }
+    CHECK(limiter.Stats().limit == 10, "no decrease within first window");
+    limiter.Acquire();
+    limiter.Release(50);
+    CHECK(limiter.Stats().limit == 9, "decrease after a full window");
+    for (int i = 0; i < 100; ++i) {
+      limiter.Acquire();
+      limiter.Release(50);
+    }
+    AdmissionStats s = limiter.Stats();
+    CHECK(s.limit == 8, "clamped to min_limit, got " << s.limit);
+    CHECK(s.limit_decreases == 2, "two decreases, got " << s.limit_decreases);
+    CHECK(s.avg_latency_ms > 40, "latency average tracked");
+  }
+  {
+    AdmissionLimiter limiter(limits);
+    // 上限未用满时快请求不增长
+    for (int i = 0; i < 50; ++i) {
+      limiter.Acquire();
+      limiter.Release(1);
+    }
+    CHECK(limiter.Stats().limit == 10, "no growth when not saturated");
+
+    // 占住上限 - 1 个名额，最后一个反复申请归还：每次都是用满状态
+    size_t held = 0;
+    for (int i = 0; i < 200; ++i) {
+      for (; held + 1 < limiter.Stats().limit; ++held)
+        limiter.Acquire();
+      CHECK(limiter.Acquire() == Result::Admitted, "saturating permit");
+      limiter.Release(1);
+    }
+    AdmissionStats s = limiter.Stats();
+    CHECK(s.limit == 12, "clamped to max_limit, got " << s.limit);
+    CHECK(s.limit_decreases == 0, "no decrease under target latency");
+  }
+  PASS("aimd");
+  return true;
+}
+
+static bool test_invalid_limits() {
+  auto throws = [](AdmissionLimits limits) {
+    try {
+      AdmissionLimiter limiter(limits);
+    } catch (const std::invalid_argument &) {
+      return true;
+    }
+    return false;
+  };
+  AdmissionLimits limits;
+  limits.min_limit = 0;
+  CHECK(throws(limits), "min_limit 0");
+  limits = AdmissionLimits();
+  limits.initial_limit = limits.max_limit + 1;
+  CHECK(throws(limits), "initial above max");
+  limits = AdmissionLimits();
+  limits.queue_timeout_ms = -1;
+  CHECK(throws(limits), "negative timeout");
+  PASS("invalid_limits");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// HttpServer
+// ══════════════════════════════════════════════════════════════════════════════
+
+static constexpr int kPort = 18099;
+static constexpr int kDim = 128;
+
+// 足够多的向量让一次暴力检索耗时数毫秒，并发请求能撞上上限
+static std::shared_ptr<StringKV> make_vector_kv() {
+  std::shared_ptr<StringKV> kv = StringKV::create(65536, 16);
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::vector<float> v(kDim);
+  for (int i = 0; i < 30000; ++i) {
+    for (auto &x : v)
+      x = dist(rng);
+    kv->vectorPut("vec:" + std::to_string(i), v);
+  }
+  return kv;
+}
+
+static std::string search_body() {
+  std::string body = "{\"top_k\": 10, \"query\": [";
+  for (int i = 0; i < kDim; ++i)
+    body += (i ? ",0.5" : "0.5");
+  return body + "]}";
+}
+
+static bool test_http_overload() {
+  HttpServer server(make_vector_kv(), nullptr, "127.0.0.1", kPort);
+  HttpAdmissionOptions options;
+  options.expensive_threads = 1;
+  options.retry_after_s = 2;
+  options.endpoints["/vector/search"] = fixed_limits(1, 0, 0);
+  CHECK(server.set_admission_options(options), "configure before start");
+  CHECK(server.start_async(), "server start");
+  CHECK(!server.set_admission_options(options), "reconfigure while running");
+
+  constexpr int kClients = 16;
+  std::atomic<int> ok{0}, busy{0}, other{0};
+  std::atomic<bool> retry_after{true};
+  std::vector<std::thread> clients;
+  std::string body = search_body();
+  for (int i = 0; i < kClients; ++i) {
+    clients.emplace_back([&] {
+      httplib::Client cli("127.0.0.1", kPort);
+      auto res = cli.Post("/vector/search", body, "application/json");
+      if (res && res->status == 200) {
+        ++ok;
+      } else if (res && res->status == 503) {
+        ++busy;
+        if (res->get_header_value("Retry-After") != "2" ||
+            json::parse(res->body).value("success", true))
+          retry_after = false;
+      } else {
+        ++other;
+      }
+    });
+  }
+  for (auto &t : clients)
+    t.join();
+  CHECK(other == 0, "only 200 or 503 expected");
+  CHECK(ok >= 1 && busy >= 1,
+        "expected both outcomes, ok=" << ok << " busy=" << busy);
+  CHECK(retry_after, "503 carries Retry-After and a JSON error");
+
+  httplib::Client cli("127.0.0.1", kPort);
+  auto health = cli.Get("/health");
+  CHECK(health && health->status == 200, "/health not limited");
+  auto res = cli.Get("/stats/admission");
+  CHECK(res && res->status == 200, "/stats/admission");
+  json stats = json::parse(res->body);
+  const json &search = stats["endpoints"]["/vector/search"];
+  CHECK(search["cost"] == "expensive", "search classified as expensive");
+  CHECK(search["limit"] == 1 && search["max_queue"] == 0, "override applied");
+  CHECK(search["admitted"] == ok.load(), "admitted matches 200s");
+  CHECK(search["rejected_queue_full"] == busy.load(),
+        "rejections match 503s");
+  CHECK(stats["endpoints"]["/kv/get"]["cost"] == "cheap", "kv is cheap");
+  CHECK(stats["endpoints"]["/kv/get"]["limit"] == options.cheap.initial_limit,
+        "cheap default applied");
+  CHECK(stats["connections"]["max_queued"] == options.max_queued_connections,
+        "connection queue bound exported");
+  CHECK(stats["expensive_threads"] == 1, "expensive pool size exported");
+  CHECK(server.admission_stats().at("/vector/search").admitted ==
+            static_cast<uint64_t>(ok.load()),
+        "admission_stats() agrees");
+  server.stop();
+  PASS("http_overload");
+  return true;
+}
+
+static bool test_http_scan_stream() {
+  // 数据量远超 socket 缓冲区：客户端不读时服务端停在 provider 里
+  std::shared_ptr<StringKV> kv = StringKV::create(1 << 18, 16);
+  const std::string value(100, 'x');
+  for (int i = 0; i < 200000; ++i)
+    kv->put("key:" + std::to_string(i), value);
+  HttpServer server(kv, nullptr, "127.0.0.1", kPort);
+  HttpAdmissionOptions options;
+  options.endpoints["/kv/scan"] = fixed_limits(1, 0, 0);
+  CHECK(server.set_admission_options(options), "configure before start");
+  CHECK(server.start_async(), "server start");
+
+  std::promise<void> first_chunk, resume;
+  auto resumed = resume.get_future().share();
+  auto reader = std::async(std::launch::async, [&] {
+    httplib::Client cli("127.0.0.1", kPort);
+    bool first = true;
+    size_t bytes = 0;
+    auto res = cli.Get("/kv/scan?count=100",
+                       [&](const char *, size_t n) {
+                         if (first) {
+                           first = false;
+                           first_chunk.set_value();
+                           resumed.wait();
+                         }
+                         bytes += n;
+                         return true;
+                       });
+    return res && res->status == 200 ? bytes : 0;
+  });
+  first_chunk.get_future().wait();
+
+  auto scan_stats = [&] { return server.admission_stats().at("/kv/scan"); };
+  size_t in_flight = scan_stats().in_flight;
+  httplib::Client cli("127.0.0.1", kPort);
+  auto res = cli.Get("/kv/scan?count=100");
+  resume.set_value(); // 先放行读端，CHECK 失败时也不会卡住
+  size_t streamed = reader.get();
+  CHECK(in_flight == 1, "permit held while streaming");
+  CHECK(res && res->status == 503, "second scan rejected during stream");
+  CHECK(streamed > 200000 * value.size(), "stream completes");
+
+  // 客户端读完最后一块时服务端可能还没析构 Response
+  for (int i = 0; i < 100 && scan_stats().in_flight != 0; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  CHECK(scan_stats().in_flight == 0, "permit released after stream");
+  res = cli.Get("/kv/scan?limit=1");
+  CHECK(res && res->status == 200, "scan admitted again");
+  server.stop();
+  PASS("http_scan_stream");
+  return true;
+}
+
+static bool test_http_disabled() {
+  HttpServer server(make_vector_kv(), nullptr, "127.0.0.1", kPort);
+  HttpAdmissionOptions options;
+  options.enabled = false;
+  options.endpoints["/vector/search"] = fixed_limits(1, 0, 0);
+  CHECK(server.set_admission_options(options), "configure");
+  CHECK(server.admission_stats().empty(), "no limiters when disabled");
+  CHECK(server.start_async(), "server start");
+
+  std::vector<std::future<int>> results;
+  std::string body = search_body();
+  for (int i = 0; i < 8; ++i) {
+    results.push_back(std::async(std::launch::async, [&] {
+      httplib::Client cli("127.0.0.1", kPort);
+      auto res = cli.Post("/vector/search", body, "application/json");
+      return res ? res->status : -1;
+    }));
+  }
+  for (auto &r : results)
+    CHECK(r.get() == 200, "no rejection when disabled");
+  server.stop();
+  PASS("http_disabled");
+  return true;
+}
+
+static bool test_invalid_options() {
+  HttpServer server(StringKV::create(1024, 4), nullptr, "127.0.0.1", kPort);
+  HttpAdmissionOptions bad;
+  bad.endpoints["/kv/get"].min_limit = 0;
+  try {
+    server.set_admission_options(bad);
+    CHECK(false, "invalid limits should throw");
+  } catch (const std::invalid_argument &) {
+  }
+  // 原配置保持生效
+  CHECK(server.admission_stats().at("/kv/get").limit ==
+            HttpAdmissionOptions().cheap.initial_limit,
+        "previous limiters kept");
+  PASS("invalid_options");
+  return true;
+}
+
+int main() {
+  std::cout << "=== Admission Control Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_fixed_limit, "fixed_limit");
+  run(test_aimd, "aimd");
+  run(test_invalid_limits, "invalid_limits");
+  run(test_http_overload, "http_overload");
+  run(test_http_scan_stream, "http_scan_stream");
+  run(test_http_disabled, "http_disabled");
+  run(test_invalid_options, "invalid_options");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
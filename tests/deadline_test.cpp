@@ -0,0 +1,278 @@
+/**
+ * 请求截止时间与协作式取消测试
+ *
+ * 单元测试：
+ *   - CancellationToken：默认 token 不取消；manual() 的拷贝共享取消状态；
+ *     过期后 cancelled() 保持为 true
+ *   - vectorSearch / vectorSearchBatch：已取消的 token 不扫描分片，
+ *     返回空结果；未取消时结果与不传 token 一致
+ *   - KHopNeighbors / GraphRAGQuery：已取消时不再扩展，部分结果不写入
+ *     查询缓存，之后的完整查询不受影响
+ * 端到端测试（进程内 HttpServer）：
+ *   - X-Timeout-Ms / timeout_ms 过期时 /vector/search、/vector/msearch、
+ *     /graph/rag_query 返回 504，且比完整检索提前返回
+ *   - X-Allow-Partial / allow_partial 时返回 200 + "partial": true
+ *   - 截止时间充足时结果完整、不带 partial；非法 timeout 返回 400
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/cancellation.h"
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+#include "server/http_server.h"
+#include "server/httplib.h"
+
+using namespace minkv;
+using namespace minkv::server;
+using minkv::base::CancellationToken;
+using GraphKVStore = minkv::db::ShardedCache<std::string, std::string>;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int kPort = 18101;
+static constexpr int kDim = 128;
+
+static CancellationToken cancelled_token() {
+  auto token = CancellationToken::manual();
+  token.cancel();
+  return token;
+}
+
+static std::vector<float> random_vector(std::mt19937 &rng, int dim) {
+  std::uniform_real_distribution<float> dist(-1, 1);
+  std::vector<float> v(dim);
+  for (auto &x : v)
+    x = dist(rng);
+  return v;
+}
+
+static std::shared_ptr<StringKV> make_vector_kv(int count) {
+  std::shared_ptr<StringKV> kv = StringKV::create(1 << 18, 16);
+  std::mt19937 rng(7);
+  for (int i = 0; i < count; ++i)
+    kv->vectorPut("vec:" + std::to_string(i), random_vector(rng, kDim));
+  return kv;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 单元测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_token() {
+  CancellationToken none;
+  none.cancel();
+  CHECK(!none.cancelled() && !none.has_deadline(),
+        "default token never cancels");
+
+  auto manual = CancellationToken::manual();
+  CancellationToken copy = manual;
+  CHECK(!manual.cancelled() && !manual.has_deadline(), "manual starts live");
+  copy.cancel();
+  CHECK(manual.cancelled(), "copies share the cancellation state");
+
+  auto expired = CancellationToken::with_timeout(std::chrono::milliseconds(0));
+  CHECK(expired.has_deadline() && expired.cancelled(), "zero timeout expired");
+
+  auto later = CancellationToken::with_timeout(std::chrono::hours(1));
+  CHECK(later.has_deadline() && !later.cancelled(), "future deadline live");
+  later.cancel();
+  CHECK(later.cancelled(), "deadline token can also be cancelled by hand");
+  PASS("token");
+  return true;
+}
+
+static bool test_vector_search_cancel() {
+  auto kv = make_vector_kv(5000);
+  std::mt19937 rng(11);
+  auto query = random_vector(rng, kDim);
+
+  auto full = kv->vectorSearch(query, 10);
+  CHECK(full.size() == 10, "uncancelled search returns top_k");
+  auto live = CancellationToken::with_timeout(std::chrono::hours(1));
+  CHECK(kv->vectorSearch(query, 10, live) == full,
+        "live token does not change the result");
+  CHECK(kv->vectorSearch(query, 10, cancelled_token()).empty(),
+        "cancelled search skips every shard");
+
+  std::vector<std::vector<float>> queries = {query, random_vector(rng, kDim)};
+  auto batch = kv->vectorSearchBatch(queries, 5, cancelled_token());
+  CHECK(batch.size() == 2 && batch[0].empty() && batch[1].empty(),
+        "cancelled batch keeps one empty slot per query");
+  PASS("vector_search_cancel");
+  return true;
+}
+
+static bool test_graph_cancel() {
+  graph::GraphStore gs(std::make_shared<GraphKVStore>(1 << 16, 16));
+  for (const char *id : {"a", "b", "c"})
+    gs.AddNode({id, "{}"});
+  gs.SetNodeEmbedding("a", {1.0f, 0.0f});
+  gs.AddEdge({"a", "b", "R", 1.0f, ""});
+  gs.AddEdge({"b", "c", "R", 1.0f, ""});
+  gs.EnableQueryCache();
+
+  CHECK(gs.KHopNeighbors("a", 2).size() == 2, "uncancelled k-hop");
+  CHECK(gs.KHopNeighbors("a", 2, {}, cancelled_token()).empty(),
+        "cancelled k-hop does not expand");
+
+  std::vector<float> q = {1.0f, 0.0f};
+  auto partial = gs.GraphRAGQuery(q, 1, 2, {}, {}, cancelled_token());
+  CHECK(partial.empty(), "cancelled GraphRAG finds no entry");
+  CHECK(gs.QueryCacheStats().entries == 0, "partial result not cached");
+
+  std::set<std::string> ids;
+  for (const auto &n : gs.GraphRAGQuery(q, 1, 2))
+    ids.insert(n.node_id);
+  CHECK(ids == std::set<std::string>({"a", "b", "c"}),
+        "later full query unaffected");
+  CHECK(gs.QueryCacheStats().entries == 1, "full result cached");
+  PASS("graph_cancel");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 端到端测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static std::string query_json(const char *field, int count) {
+  std::string body = std::string("\"") + field + "\": ";
+  body += count > 1 ? "[" : "";
+  for (int q = 0; q < count; ++q) {
+    body += q ? ",[" : "[";
+    for (int i = 0; i < kDim; ++i)
+      body += (i ? ",0.5" : "0.5");
+    body += "]";
+  }
+  return body + (count > 1 ? "]" : "");
+}
+
+static bool test_http_deadline() {
+  // 10 万个向量：一次暴力检索耗时数十毫秒，1ms 的截止时间必然过期
+  auto kv = make_vector_kv(100000);
+  auto gs = std::make_shared<graph::GraphStore>(
+      std::make_shared<GraphKVStore>(1 << 18, 16));
+  std::mt19937 rng(3);
+  for (int i = 0; i < 20000; ++i) {
+    std::string id = "n" + std::to_string(i);
+    gs->AddNode({id, "{}"});
+    gs->SetNodeEmbedding(id, random_vector(rng, kDim));
+    if (i > 0)
+      gs->AddEdge({"n" + std::to_string(i - 1), id, "R", 1.0f, ""});
+  }
+  HttpServer server(kv, gs, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+
+  const std::string search = "{\"top_k\": 10, " + query_json("query", 1);
+  auto t0 = Clock::now();
+  auto res = cli.Post("/vector/search", search + "}", "application/json");
+  double full_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+  CHECK(res && res->status == 200, "search without deadline");
+  json body = json::parse(res->body);
+  CHECK(body["results_count"] == 10 && !body.contains("partial"),
+        "complete result has no partial flag");
+
+  res = cli.Post("/vector/search", search + ", \"timeout_ms\": 60000}",
+                 "application/json");
+  CHECK(res && res->status == 200, "generous deadline");
+  CHECK(json::parse(res->body)["results_count"] == 10, "generous complete");
+
+  httplib::Headers timeout = {{"X-Timeout-Ms", "1"}};
+  t0 = Clock::now();
+  res = cli.Post("/vector/search", timeout, search + "}", "application/json");
+  double cut_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+  CHECK(res && res->status == 504, "expired search returns 504");
+  CHECK(!json::parse(res->body).value("success", true), "504 is an error");
+  std::cout << "  full search " << full_ms << " ms, cancelled " << cut_ms
+            << " ms\n";
+  CHECK(cut_ms < full_ms, "cancelled search returns early");
+
+  res = cli.Post("/vector/search", search + ", \"timeout_ms\": 1, "
+                                            "\"allow_partial\": true}",
+                 "application/json");
+  CHECK(res && res->status == 200, "partial search returns 200");
+  CHECK(json::parse(res->body).value("partial", false), "partial flag set");
+
+  res = cli.Post("/vector/msearch",
+                 "{\"top_k\": 5, \"timeout_ms\": 1, " +
+                     query_json("queries", 4) + "}",
+                 "application/json");
+  CHECK(res && res->status == 504, "expired msearch returns 504");
+
+  const std::string rag = "{\"vector_top_k\": 2, \"hop_depth\": 3, " +
+                          query_json("query_embedding", 1);
+  res = cli.Post("/graph/rag_query", timeout, rag + "}", "application/json");
+  CHECK(res && res->status == 504, "expired rag_query returns 504");
+  res = cli.Post("/graph/rag_query", rag + ", \"timeout_ms\": 1, "
+                                           "\"allow_partial\": true}",
+                 "application/json");
+  CHECK(res && res->status == 200, "partial rag_query returns 200");
+  CHECK(json::parse(res->body).value("partial", false), "rag partial flag");
+  res = cli.Post("/graph/rag_query", rag + "}", "application/json");
+  CHECK(res && res->status == 200, "rag_query without deadline");
+  body = json::parse(res->body);
+  CHECK(body["node_count"] > 2 && !body.contains("partial"),
+        "full rag_query expands past the entries");
+
+  res = cli.Post("/vector/search", {{"X-Timeout-Ms", "abc"}}, search + "}",
+                 "application/json");
+  CHECK(res && res->status == 400, "malformed X-Timeout-Ms");
+  res = cli.Post("/vector/search", search + ", \"timeout_ms\": 0}",
+                 "application/json");
+  CHECK(res && res->status == 400, "non-positive timeout_ms");
+  server.stop();
+  PASS("http_deadline");
+  return true;
+}
+
+int main() {
+  std::cout << "=== Deadline / Cancellation Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_token, "token");
+  run(test_vector_search_cancel, "vector_search_cancel");
+  run(test_graph_cancel, "graph_cancel");
+  run(test_http_deadline, "http_deadline");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/**
+ * 图遍历性能测试（合成幂律图）
+ *
+ * 对比内容：
+ * 1. FindPath：单向 BFS（基线，测试内实现）vs 双向 BFS（GraphStore::FindPath）
+ *    - 指标：平均延迟、平均探索节点数（读取邻接表的次数）
+ * 2. KHopNeighbors：串行（n_threads=1）vs 按层并行（线程池）
+ *
+ * 图生成：Barabási–Albert 优先连接模型，新节点按度数比例挑选 M 个已有节点连边，
+ * 得到度分布近似幂律的有向图（少量 hub 节点拥有大量入边/出边）。
+ * 边方向随机，保证 hub 同时拥有大量出边和入边。
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+static std::string node_name(int i) { return "v" + std::to_string(i); }
+
+// 构建 BA 幂律图，两个 GraphStore 共享同一份图数据时只需构建一次
+void build_power_law_graph(GraphStore &gs, int num_nodes, int m,
+                           std::mt19937 &rng) {
+  // targets 中每个节点出现的次数 = 其度数，均匀抽样即实现"按度数比例"选择
+  std::vector<int> targets;
+  targets.reserve(static_cast<size_t>(num_nodes) * m * 2);
+  for (int i = 0; i <= m; ++i) {
+    gs.AddNode({node_name(i), "{}"});
+    for (int j = 0; j < i; ++j) {
+      gs.AddEdge({node_name(i), node_name(j), "LINK", 1.0f, ""});
+      gs.AddEdge({node_name(j), node_name(i), "LINK", 1.0f, ""});
+      targets.push_back(i);
+      targets.push_back(j);
+    }
+  }
+
+  std::bernoulli_distribution coin(0.5);
+  for (int i = m + 1; i < num_nodes; ++i) {
+    gs.AddNode({node_name(i), "{}"});
+    std::unordered_set<int> chosen;
+    while (static_cast<int>(chosen.size()) < m) {
+      std::uniform_int_distribution<size_t> pick(0, targets.size() - 1);
+      chosen.insert(targets[pick(rng)]);
+    }
+    for (int t : chosen) {
+      if (coin(rng)) {
+        gs.AddEdge({node_name(i), node_name(t), "LINK", 1.0f, ""});
+      } else {
+        gs.AddEdge({node_name(t), node_name(i), "LINK", 1.0f, ""});
+      }
+      targets.push_back(i);
+      targets.push_back(t);
+    }
+  }
+}
+
+// 基线：单向 BFS 最短路径（与双向版本改造前的 FindPath 相同），
+// expanded 统计读取邻接表的次数
+std::vector<std::string> unidirectional_path(const GraphStore &gs,
+                                             const std::string &src,
+                                             const std::string &dst,
+                                             size_t &expanded) {
+  if (src == dst)
+    return {src};
+  std::unordered_map<std::string, std::string> parent{{src, src}};
+  std::queue<std::string> q;
+  q.push(src);
+  while (!q.empty()) {
+    std::string cur = q.front();
+    q.pop();
+    ++expanded;
+    for (const auto &nb : gs.GetOutNeighbors(cur)) {
+      if (!parent.emplace(nb, cur).second)
+        continue;
+      if (nb == dst) {
+        std::vector<std::string> path;
+        for (std::string n = dst; n != src; n = parent[n])
+          path.push_back(n);
+        path.push_back(src);
+        std::reverse(path.begin(), path.end());
+        return path;
+      }
+      q.push(nb);
+    }
+  }
+  return {};
+}
+
+template <typename F> double time_ms(F &&fn) {
+  auto start = std::chrono::high_resolution_clock::now();
+  fn();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+  std::cout << "╔══════════════════════════════════════════════════════╗\n";
+  std::cout << "║   图遍历性能测试（合成幂律图）                       ║\n";
+  std::cout << "╚══════════════════════════════════════════════════════╝\n\n";
+
+  const int NUM_NODES = 20000;
+  const int M = 4; // 每个新节点连出的边数
+  const int NUM_QUERIES = 50;
+  const int K = 5;
+
+  auto kv = std::make_shared<GraphKVStore>(65536, 16);
+  GraphStore gs_serial(kv, 1); // 无线程池：串行扩展
+  GraphStore gs_parallel(kv, std::thread::hardware_concurrency());
+
+  std::mt19937 rng(2024);
+  double build_ms =
+      time_ms([&] { build_power_law_graph(gs_serial, NUM_NODES, M, rng); });
+  std::cout << "构建 BA 幂律图: " << NUM_NODES << " 节点, 约 "
+            << NUM_NODES * M << " 条边, 耗时 " << std::fixed
+            << std::setprecision(1) << build_ms << " ms\n\n";
+
+  // 随机挑选查询对（只保留可达的，确保两种算法都走完整搜索）
+  std::uniform_int_distribution<int> node_dist(0, NUM_NODES - 1);
+  std::vector<std::pair<std::string, std::string>> pairs;
+  while (static_cast<int>(pairs.size()) < NUM_QUERIES) {
+    std::string s = node_name(node_dist(rng));
+    std::string d = node_name(node_dist(rng));
+    if (s != d && !gs_serial.FindPath(s, d).empty())
+      pairs.push_back({s, d});
+  }
+
+  // ── FindPath: 单向 vs 双向 ────────────────────────────────────────────────
+  size_t uni_expanded = 0;
+  size_t mismatched = 0;
+  std::vector<size_t> uni_lengths;
+  double uni_ms = time_ms([&] {
+    for (const auto &[s, d] : pairs)
+      uni_lengths.push_back(unidirectional_path(gs_serial, s, d, uni_expanded)
+                                .size());
+  });
+
+  size_t idx = 0;
+  double bi_ms = time_ms([&] {
+    for (const auto &[s, d] : pairs) {
+      if (gs_serial.FindPath(s, d).size() != uni_lengths[idx++])
+        ++mismatched;
+    }
+  });
+
+  // 双向 BFS 的探索量：用 GetOutNeighbors/GetInNeighbors 调用次数近似，
+  // 这里通过 KV 命中统计差值得到（每次邻接表读取对应一次 get）
+  kv->resetStats();
+  for (const auto &[s, d] : pairs)
+    gs_serial.FindPath(s, d);
+  uint64_t bi_gets = kv->getStats().total_gets();
+
+  std::cout << "FindPath（" << NUM_QUERIES << " 个可达查询）\n";
+  std::cout << std::left << std::setw(18) << "算法" << std::setw(18)
+            << "平均延迟(ms)" << std::setw(18) << "平均探索节点" << "\n";
+  std::cout << std::string(54, '-') << "\n";
+  std::cout << std::left << std::setw(18) << "单向 BFS" << std::setw(18)
+            << std::setprecision(3) << uni_ms / NUM_QUERIES << std::setw(18)
+            << uni_expanded / NUM_QUERIES << "\n";
+  std::cout << std::left << std::setw(18) << "双向 BFS" << std::setw(18)
+            << bi_ms / NUM_QUERIES << std::setw(18) << bi_gets / NUM_QUERIES
+            << "\n";
+  std::cout << "加速比: " << std::setprecision(2) << uni_ms / bi_ms
+            << "x, 路径长度不一致: " << mismatched << "\n\n";
+
+  // ── KHopNeighbors: 串行 vs 并行 ───────────────────────────────────────────
+  std::vector<std::string> starts;
+  for (int i = 0; i < NUM_QUERIES; ++i)
+    starts.push_back(node_name(node_dist(rng)));
+
+  size_t serial_total = 0, parallel_total = 0;
+  double serial_ms = time_ms([&] {
+    for (const auto &s : starts)
+      serial_total += gs_serial.KHopNeighbors(s, K).size();
+  });
+  double parallel_ms = time_ms([&] {
+    for (const auto &s : starts)
+      parallel_total += gs_parallel.KHopNeighbors(s, K).size();
+  });
+
+  std::cout << "KHopNeighbors（k=" << K << ", " << NUM_QUERIES
+            << " 个起点, 线程池 " << std::thread::hardware_concurrency()
+            << " 线程）\n";
+  std::cout << std::left << std::setw(18) << "模式" << std::setw(18)
+            << "平均延迟(ms)" << std::setw(18) << "平均结果数" << "\n";
+  std::cout << std::string(54, '-') << "\n";
+  std::cout << std::left << std::setw(18) << "串行" << std::setw(18)
+            << serial_ms / NUM_QUERIES << std::setw(18)
+            << serial_total / NUM_QUERIES << "\n";
+  std::cout << std::left << std::setw(18) << "按层并行" << std::setw(18)
+            << parallel_ms / NUM_QUERIES << std::setw(18)
+            << parallel_total / NUM_QUERIES << "\n";
+  std::cout << "加速比: " << serial_ms / parallel_ms << "x\n";
+
+  if (mismatched != 0 || serial_total != parallel_total) {
+    std::cerr << "[FAIL] 结果不一致\n";
+    return 1;
+  }
+  return 0;
+}
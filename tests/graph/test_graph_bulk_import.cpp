@@ -0,0 +1,383 @@
+/**
+ * 批量导入测试：GraphEdgeReader 解析 + GraphStore::BulkImportEdges
+ *
+ * 单元测试：
+ *   - ReadCsv：表头/注释/空行、可选 weight、properties 中含逗号、错误带行号
+ *   - ReadJsonl：字符串转义、内嵌对象原样保留、缺少必填字段报错
+ *   - WriteBinary / ReadBinary：往返一致、坏文件头报错
+ *   - BulkImportEdges：与逐条 AddEdge 的结果一致（含重复边、多重边，
+ *     数据量足以触发并行排序）
+ *   - BulkImportEdges：与已有邻接表合并，导入后 DeleteEdge 正常
+ *   - BulkImportFile：从文件导入并返回统计
+ *   - AddEdges / AddNodes：在线批量写入与逐条写入的结果一致
+ *     （含超级节点分页），非法边整批拒绝
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_bulk_import.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 20, 16);
+}
+
+template <typename F> static bool throws(F &&fn) {
+  try {
+    fn();
+  } catch (const std::runtime_error &) {
+    return true;
+  }
+  return false;
+}
+
+static std::set<std::string> as_set(const std::vector<std::string> &v) {
+  return {v.begin(), v.end()};
+}
+
+// ── GraphEdgeReader
+// ───────────────────────────────────────────────────────────
+
+bool test_read_csv() {
+  std::istringstream in("src_id,dst_id,label,weight,properties_json\n"
+                        "# comment\n"
+                        "\n"
+                        "a,b,KNOWS\n"
+                        "b,c,LIKES,2.5\r\n"
+                        "c,a,CITES,0.5,{\"x\":1,\"y\":[1,2]}\n");
+  auto edges = GraphEdgeReader::ReadCsv(in);
+  CHECK(edges.size() == 3, "header, comment and blank line skipped");
+  CHECK(edges[0].src_id == "a" && edges[0].dst_id == "b" &&
+            edges[0].label == "KNOWS" && edges[0].weight == 1.0f,
+        "weight defaults to 1.0");
+  CHECK(edges[1].label == "LIKES" && edges[1].weight == 2.5f,
+        "weight parsed, CR stripped");
+  CHECK(edges[2].properties_json == "{\"x\":1,\"y\":[1,2]}",
+        "properties keep their commas");
+
+  std::istringstream bad("a,b,L\na,b\n");
+  try {
+    GraphEdgeReader::ReadCsv(bad);
+    CHECK(false, "missing label should throw");
+  } catch (const std::runtime_error &ex) {
+    CHECK(std::string(ex.what()).find("line 2") != std::string::npos,
+          "error mentions line number");
+  }
+  std::istringstream bad_weight("a,b,L,heavy\n");
+  CHECK(throws([&] { GraphEdgeReader::ReadCsv(bad_weight); }),
+        "bad weight throws");
+  PASS("ReadCsv parses fields and reports bad lines");
+  return true;
+}
+
+bool test_read_jsonl() {
+  std::istringstream in(
+      "{\"src_id\":\"a:1\",\"dst_id\":\"b\",\"label\":\"L\",\"weight\":3}\n"
+      "\n"
+      "{ \"label\" : \"M\", \"dst_id\" : \"c\", \"src_id\" : \"b\\\"q\\u00e9\","
+      " \"properties_json\" : {\"k\": \"}{\", \"n\": [1, {\"z\": 2}]},"
+      " \"extra\": true }\n"
+      "{\"src_id\":\"c\",\"dst_id\":\"a\",\"label\":\"N\","
+      "\"properties_json\":\"{\\\"s\\\":1}\"}\n");
+  auto edges = GraphEdgeReader::ReadJsonl(in);
+  CHECK(edges.size() == 3, "blank line skipped");
+  CHECK(edges[0].src_id == "a:1" && edges[0].weight == 3.0f, "number weight");
+  CHECK(edges[1].src_id == "b\"q\xC3\xA9", "escapes and \\u decoded");
+  CHECK(edges[1].properties_json == "{\"k\": \"}{\", \"n\": [1, {\"z\": 2}]}",
+        "nested object kept verbatim");
+  CHECK(edges[1].weight == 1.0f, "weight defaults to 1.0");
+  CHECK(edges[2].properties_json == "{\"s\":1}", "string properties unescaped");
+
+  std::istringstream missing("{\"src_id\":\"a\",\"label\":\"L\"}\n");
+  CHECK(throws([&] { GraphEdgeReader::ReadJsonl(missing); }),
+        "missing dst_id throws");
+  std::istringstream truncated("{\"src_id\":\"a\",\"dst_id\":\n");
+  CHECK(throws([&] { GraphEdgeReader::ReadJsonl(truncated); }),
+        "truncated object throws");
+  PASS("ReadJsonl parses flat objects");
+  return true;
+}
+
+bool test_binary_roundtrip() {
+  std::vector<Edge> edges = {{"a", "b", "L", 0.25f, "{\"p\":1}"},
+                             {"b", "c", "M", 2.0f, ""},
+                             {"x:y", "z\\w", "N:1", 1.0f, "{}"}};
+  std::stringstream buf(std::ios::in | std::ios::out | std::ios::binary);
+  GraphEdgeReader::WriteBinary(buf, edges);
+  auto back = GraphEdgeReader::ReadBinary(buf);
+  CHECK(back == edges, "binary roundtrip preserves all fields");
+
+  std::istringstream bad_magic(std::string("XXXX\1\0\0\0", 8));
+  CHECK(throws([&] { GraphEdgeReader::ReadBinary(bad_magic); }),
+        "bad magic throws");
+  std::string cut = buf.str();
+  cut.resize(cut.size() - 3);
+  std::istringstream truncated(cut);
+  CHECK(throws([&] { GraphEdgeReader::ReadBinary(truncated); }),
+        "truncated record throws");
+  PASS("WriteBinary / ReadBinary roundtrip");
+  return true;
+}
+
+// ── BulkImportEdges
+// ───────────────────────────────────────────────────────────
+
+bool test_bulk_matches_add_edge() {
+  // 幂律度分布 + 重复边 + 多重边；边数足以触发并行排序和并行写入
+  std::mt19937 rng(7);
+  const int n_nodes = 3000;
+  const size_t n_edges = 60000;
+  std::vector<Edge> edges;
+  edges.reserve(n_edges);
+  for (size_t i = 0; i < n_edges; ++i) {
+    int src = static_cast<int>(std::pow(rng() % 1000000 / 1e6, 3) * n_nodes);
+    int dst = rng() % n_nodes;
+    std::string label = (rng() % 4 == 0) ? "B" : "A";
+    float weight = static_cast<float>(rng() % 100) / 10.0f;
+    edges.push_back({"n" + std::to_string(src), "n" + std::to_string(dst),
+                     label, weight, "{\"i\":" + std::to_string(i) + "}"});
+  }
+
+  GraphStore reference(make_kv(), 1);
+  for (const auto &e : edges)
+    reference.AddEdge(e);
+
+  GraphStore bulk(make_kv(), 4);
+  auto stats = bulk.BulkImportEdges(edges, false);
+  CHECK(stats.edges_read == n_edges, "edges_read");
+  CHECK(stats.edges_written < n_edges, "duplicates collapsed");
+
+  std::set<std::tuple<std::string, std::string, std::string>> triples;
+  for (const auto &e : edges)
+    triples.insert({e.src_id, e.dst_id, e.label});
+  CHECK(stats.edges_written == triples.size(), "one record per triple");
+
+  for (const auto &[s, d, l] : triples) {
+    auto a = reference.GetEdge(s, d, l);
+    auto b = bulk.GetEdge(s, d, l);
+    CHECK(a && b && *a == *b, "edge " + s + "->" + d + " matches AddEdge");
+  }
+  for (int i = 0; i < n_nodes; ++i) {
+    std::string id = "n" + std::to_string(i);
+    CHECK(as_set(reference.GetOutNeighbors(id)) ==
+              as_set(bulk.GetOutNeighbors(id)),
+          "out neighbors of " + id);
+    CHECK(as_set(reference.GetInNeighbors(id)) ==
+              as_set(bulk.GetInNeighbors(id)),
+          "in neighbors of " + id);
+  }
+  // 邻接表中的权重与 AddEdge 一致（带权路径读的是邻接表条目）
+  for (int i = 0; i < 50; ++i) {
+    std::string s = "n" + std::to_string(rng() % n_nodes);
+    std::string d = "n" + std::to_string(rng() % n_nodes);
+    CHECK(reference.FindWeightedPath(s, d).cost ==
+              bulk.FindWeightedPath(s, d).cost,
+          "weighted path cost " + s + "->" + d);
+  }
+  PASS("BulkImportEdges matches per-edge AddEdge");
+  return true;
+}
+
+bool test_bulk_merges_existing() {
+  GraphStore gs(make_kv(), 2);
+  gs.AddEdge({"a", "b", "L", 5.0f, ""});
+  gs.AddEdge({"a", "d", "L", 1.0f, ""});
+  gs.AddEdge({"x", "b", "M", 1.0f, ""});
+
+  auto stats = gs.BulkImportEdges({{"a", "b", "L", 2.0f, "{\"v\":1}"},
+                                   {"a", "c", "L", 1.0f, ""},
+                                   {"a", "b", "L", 3.0f, "{\"v\":2}"}},
+                                  false);
+  CHECK(stats.edges_written == 2, "later duplicate wins");
+  CHECK(stats.adj_lists_written == 3, "adj:out:a, adj:in:b, adj:in:c");
+
+  CHECK(as_set(gs.GetOutNeighbors("a")) ==
+            std::set<std::string>({"b", "c", "d"}),
+        "existing out entries kept");
+  CHECK(as_set(gs.GetInNeighbors("b")) == std::set<std::string>({"a", "x"}),
+        "existing in entries kept");
+  CHECK(gs.GetEdge("a", "b", "L")->properties_json == "{\"v\":2}",
+        "edge record overwritten by last occurrence");
+  CHECK(gs.FindWeightedPath("a", "b").cost == 3.0, "weight overwritten");
+
+  gs.DeleteEdge("a", "b", "L");
+  CHECK(as_set(gs.GetOutNeighbors("a")) == std::set<std::string>({"c", "d"}),
+        "DeleteEdge works on imported adjacency");
+  CHECK(as_set(gs.GetInNeighbors("b")) == std::set<std::string>({"x"}),
+        "in side cleaned up too");
+  PASS("BulkImportEdges merges with existing adjacency");
+  return true;
+}
+
+bool test_bulk_import_file() {
+  std::string path = "/tmp/minkv_bulk_import_test.csv";
+  {
+    std::ofstream out(path);
+    out << "src_id,dst_id,label,weight\n"
+        << "a,b,L,1\n"
+        << "b,c,L,1\n"
+        << "c,d,L,1\n";
+  }
+  GraphStore gs(make_kv(), 1);
+  auto stats = gs.BulkImportFile(path, EdgeFileFormat::CSV, false);
+  std::remove(path.c_str());
+  CHECK(stats.edges_read == 3 && stats.edges_written == 3, "stats");
+  CHECK(gs.FindPath("a", "d") ==
+            std::vector<std::string>({"a", "b", "c", "d"}),
+        "imported graph is traversable");
+
+  CHECK(throws([&] {
+          gs.BulkImportFile("/nonexistent/edges.csv", EdgeFileFormat::CSV);
+        }),
+        "missing file throws");
+  PASS("BulkImportFile imports CSV");
+  return true;
+}
+
+bool test_add_edges_matches_add_edge() {
+  // 小阈值让 hub 在批内和第二批中都走分页路径
+  SupernodeOptions options;
+  options.promote_threshold = 64;
+  options.page_size = 16;
+
+  std::mt19937 rng(11);
+  std::vector<Edge> edges;
+  for (int i = 0; i < 3000; ++i) {
+    std::string src = (i % 3 == 0) ? "hub" : "n" + std::to_string(rng() % 200);
+    std::string dst = "n" + std::to_string(rng() % 200);
+    std::string label = (rng() % 4 == 0) ? "B" : "A";
+    edges.push_back({src, dst, label, static_cast<float>(rng() % 100),
+                     "{\"i\":" + std::to_string(i) + "}"});
+  }
+
+  GraphStore reference(make_kv(), 1);
+  reference.ConfigureSupernodes(options);
+  for (const auto &e : edges)
+    reference.AddEdge(e);
+
+  GraphStore batch(make_kv(), 1);
+  batch.ConfigureSupernodes(options);
+  const size_t half = edges.size() / 2;
+  batch.AddEdges({edges.begin(), edges.begin() + half});
+  batch.AddEdges({edges.begin() + half, edges.end()});
+
+  for (const auto &e : edges) {
+    auto a = reference.GetEdge(e.src_id, e.dst_id, e.label);
+    auto b = batch.GetEdge(e.src_id, e.dst_id, e.label);
+    CHECK(a && b && *a == *b, "edge " + e.src_id + "->" + e.dst_id);
+  }
+  std::vector<std::string> ids = {"hub"};
+  for (int i = 0; i < 200; ++i)
+    ids.push_back("n" + std::to_string(i));
+  for (const auto &id : ids) {
+    CHECK(as_set(reference.GetOutNeighbors(id)) ==
+              as_set(batch.GetOutNeighbors(id)),
+          "out neighbors of " + id);
+    CHECK(as_set(reference.GetInNeighbors(id)) ==
+              as_set(batch.GetInNeighbors(id)),
+          "in neighbors of " + id);
+    auto da = reference.GetDegree(id);
+    auto db = batch.GetDegree(id);
+    CHECK(da.out == db.out && da.in == db.in,
+          "degree of " + id);
+  }
+  CHECK(batch.FindWeightedPath("hub", "n7").cost ==
+            reference.FindWeightedPath("hub", "n7").cost,
+        "weights match");
+
+  bool rejected = false;
+  Edge bad{"x", "y", "L", 1.0f, ""};
+  bad.valid_from = 10;
+  bad.valid_to = 5;
+  try {
+    batch.AddEdges({{"x", "z", "L", 1.0f, ""}, bad});
+  } catch (const std::invalid_argument &) {
+    rejected = true;
+  }
+  CHECK(rejected, "invalid edge rejects the batch");
+  CHECK(!batch.GetEdge("x", "z", "L"), "nothing written on rejection");
+  PASS("AddEdges matches per-edge AddEdge");
+  return true;
+}
+
+bool test_add_nodes() {
+  GraphStore gs(make_kv(), 1);
+  gs.CreatePropertyIndex("kind", PropertyIndexType::HASH);
+  gs.AddNodes({{"a", "{\"kind\":\"x\"}"},
+               {"b", "{\"kind\":\"y\"}"},
+               {"a", "{\"kind\":\"z\"}"}});
+  CHECK(gs.GetNode("a")->properties_json == "{\"kind\":\"z\"}",
+        "later duplicate wins");
+  CHECK(gs.GetNode("b"), "node b written");
+  CHECK(gs.FindNodeIdsByProperties({{"kind", PropertyOp::EQ, "\"z\""}}) ==
+            std::vector<std::string>({"a"}),
+        "property index updated");
+  CHECK(gs.FindNodeIdsByProperties({{"kind", PropertyOp::EQ, "\"x\""}}).empty(),
+        "stale index entry replaced");
+  PASS("AddNodes writes nodes and indexes");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Graph Bulk Import Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_read_csv, "read_csv");
+  run(test_read_jsonl, "read_jsonl");
+  run(test_binary_roundtrip, "binary_roundtrip");
+  run(test_bulk_matches_add_edge, "bulk_matches_add_edge");
+  run(test_bulk_merges_existing, "bulk_merges_existing");
+  run(test_bulk_import_file, "bulk_import_file");
+  run(test_add_edges_matches_add_edge, "add_edges_matches_add_edge");
+  run(test_add_nodes, "add_nodes");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -9,6 +9,8 @@
  *
  * Property 4: 邻接表序列化往返 — 反序列化结果与原列表元素集合相同
  *   Validates: Requirements 4.7, 4.8
+ *
+ * Property 5: 零拷贝视图 — ViewNode / ViewEdge 物化后与 Deserialize 结果相同
  */
 
 #include <rapidcheck.h>
@@ -110,8 +112,20 @@ int main() {
   if (!p4)
     ++failed;
 
+  // ── Property 5: 零拷贝视图 ───────────────────────────────────────────────
+  bool p5 = rc::check(
+      "Property 5: 零拷贝视图 — ViewNode/ViewEdge 与 Deserialize 一致",
+      [](const Node &n, const Edge &e) {
+        auto node_bytes = GraphSerializer::SerializeNode(n);
+        RC_ASSERT(GraphSerializer::ViewNode(node_bytes).ToNode() == n);
+        auto edge_bytes = GraphSerializer::SerializeEdge(e);
+        RC_ASSERT(GraphSerializer::ViewEdge(edge_bytes).ToEdge() == e);
+      });
+  if (!p5)
+    ++failed;
+
   if (failed == 0) {
-    std::cout << "\n[PASS] All 3 property-based tests passed.\n";
+    std::cout << "\n[PASS] All 4 property-based tests passed.\n";
     return 0;
   } else {
     std::cerr << "\n[FAIL] " << failed << " property test(s) failed.\n";
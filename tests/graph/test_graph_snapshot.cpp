@@ -0,0 +1,275 @@
+/**
+ * 图快照测试
+ *
+ * 单元测试：
+ *   - 往返：节点、边（含属性）、embedding、只作为端点出现的节点、
+ *     含 ':' 的 ID 写出后加载到新的 GraphStore，查询结果一致
+ *   - 超级节点：超过阈值的邻接表加载后以分页形式存储，度数统计正确，
+ *     加载后的增删边照常工作
+ *   - 损坏文件：不存在、被截断、字节被改动时抛 runtime_error，KV 不变
+ *   - 索引与并行加载：已启用的关键词 / 属性索引同步更新；
+ *     有线程池时按节点分块并行加载
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 16, 16);
+}
+
+static std::string temp_path(const std::string &name) {
+  return "/tmp/minkv_graph_snapshot_" + std::to_string(::getpid()) + "_" +
+         name + ".bin";
+}
+
+static size_t count_prefix(GraphKVStore &kv, const std::string &prefix) {
+  size_t n = 0;
+  for (const auto &[k, v] : kv.export_all_data()) {
+    if (k.compare(0, prefix.size(), prefix) == 0)
+      ++n;
+  }
+  return n;
+}
+
+static bool load_throws(GraphStore &gs, const std::string &path) {
+  try {
+    gs.LoadSnapshot(path);
+  } catch (const std::runtime_error &) {
+    return true;
+  }
+  return false;
+}
+
+// ── 测试用例
+// ──────────────────────────────────────────────────────────────────
+
+static bool test_round_trip() {
+  std::string path = temp_path("round_trip");
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.AddNode({"alice", R"({"name":"Alice"})"});
+  gs.AddNode({"bob", R"({"name":"Bob"})"});
+  gs.AddNode({"ns:carol", R"({"name":"Carol"})"});
+  gs.AddEdge({"alice", "bob", "KNOWS", 0.5f, R"({"since":2020})"});
+  gs.AddEdge({"alice", "bob", "LIKES", 2.0f, ""});
+  gs.AddEdge({"bob", "ns:carol", "KNOWS", 1.5f, ""});
+  gs.AddEdge({"ns:carol", "ghost", "KNOWS", 1.0f, ""}); // ghost 没有 n: 记录
+  gs.SetNodeEmbedding("alice", {1.0f, 0.0f, 0.5f});
+  gs.SetNodeEmbedding("ns:carol", {0.0f, 1.0f, 0.5f});
+
+  auto saved = gs.SaveSnapshot(path);
+  CHECK(saved.nodes == 4 && saved.node_records == 3 && saved.edges == 4 &&
+            saved.embeddings == 2 && saved.labels == 2,
+        "save stats");
+
+  auto kv2 = make_kv();
+  GraphStore loaded(kv2);
+  auto stats = loaded.LoadSnapshot(path);
+  std::remove(path.c_str());
+  CHECK(stats.nodes == 4 && stats.node_records == 3 && stats.edges == 4 &&
+            stats.embeddings == 2 && stats.bytes == saved.bytes,
+        "load stats");
+
+  CHECK(loaded.GetNode("ns:carol") &&
+            loaded.GetNode("ns:carol")->properties_json ==
+                R"({"name":"Carol"})",
+        "node record restored");
+  CHECK(!loaded.GetNode("ghost"), "endpoint without record stays absent");
+  auto edge = loaded.GetEdge("alice", "bob", "KNOWS");
+  CHECK(edge && edge->weight == 0.5f &&
+            edge->properties_json == R"({"since":2020})",
+        "edge record restored");
+  CHECK(loaded.GetOutNeighbors("alice") == gs.GetOutNeighbors("alice") &&
+            loaded.GetInNeighbors("ns:carol") ==
+                gs.GetInNeighbors("ns:carol") &&
+            loaded.GetInNeighbors("ghost").size() == 1,
+        "adjacency rebuilt from CSR");
+  TraversalFilter likes;
+  likes.labels = {"LIKES"};
+  CHECK(loaded.GetNeighbors("alice", likes) ==
+            std::vector<std::string>{"bob"},
+        "labels preserved");
+  CHECK((loaded.GetNodeEmbedding("alice") ==
+         std::vector<float>{1.0f, 0.0f, 0.5f}),
+        "embedding restored");
+  auto path_ab = loaded.FindWeightedPath("alice", "ghost");
+  CHECK(path_ab.path.size() == 4 && path_ab.cost == 3.0f,
+        "weights restored");
+  CHECK(loaded.GetDegree("alice").out == 2 &&
+            loaded.GetDegree("bob").in == 2,
+        "degrees restored");
+  CHECK(count_prefix(*kv2, "adj:") == count_prefix(*kv, "adj:") &&
+            kv2->export_all_data() == kv->export_all_data(),
+        "KV contents identical");
+  PASS("round trip");
+  return true;
+}
+
+static bool test_supernode_paging() {
+  std::string path = temp_path("supernode");
+  SupernodeOptions options;
+  options.promote_threshold = 32;
+  options.page_size = 8;
+
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  for (int i = 0; i < 100; ++i)
+    gs.AddEdge({"hub", "leaf" + std::to_string(i), "E", 1.0f, ""});
+  gs.SaveSnapshot(path);
+
+  auto kv2 = make_kv();
+  GraphStore loaded(kv2);
+  loaded.ConfigureSupernodes(options);
+  loaded.LoadSnapshot(path);
+  std::remove(path.c_str());
+  CHECK(PagedAdjacency::IsHeader(*kv2->get("adj:out:hub")),
+        "large list is stored paged");
+  CHECK(count_prefix(*kv2, "adjp:out:hub:") == 13, "100 entries in 13 pages");
+  CHECK(loaded.DegreeStats().paged_lists == 1 &&
+            loaded.GetDegree("hub").out == 100,
+        "degree and paging stats");
+  CHECK(loaded.GetOutNeighbors("hub").size() == 100, "paged list readable");
+
+  loaded.AddEdge({"hub", "extra", "E", 1.0f, ""});
+  loaded.DeleteEdge("hub", "leaf0", "E");
+  CHECK(loaded.GetOutNeighbors("hub").size() == 100 &&
+            loaded.GetDegree("hub").out == 100 &&
+            loaded.GetInNeighbors("extra").size() == 1,
+        "writes after load");
+  PASS("supernode paging");
+  return true;
+}
+
+static bool test_corrupt_file() {
+  std::string path = temp_path("corrupt");
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.AddNode({"a", "{}"});
+  gs.AddEdge({"a", "b", "E", 1.0f, ""});
+  auto saved = gs.SaveSnapshot(path);
+
+  std::string bytes;
+  {
+    std::ifstream in(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  CHECK(bytes.size() == saved.bytes, "reported size matches file");
+  auto write = [&](const std::string &data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  };
+
+  auto kv2 = make_kv();
+  GraphStore target(kv2);
+  CHECK(load_throws(target, temp_path("missing")), "missing file throws");
+
+  write(bytes.substr(0, bytes.size() - 5));
+  CHECK(load_throws(target, path), "truncated file throws");
+
+  std::string flipped = bytes;
+  flipped[flipped.size() - 3] ^= 0x5A;
+  write(flipped);
+  CHECK(load_throws(target, path), "checksum mismatch throws");
+
+  std::string bad_magic = bytes;
+  bad_magic[0] = 'X';
+  write(bad_magic);
+  CHECK(load_throws(target, path), "bad magic throws");
+  std::remove(path.c_str());
+
+  CHECK(kv2->export_all_data().empty() && !target.GetNode("a"),
+        "failed loads leave the store untouched");
+  CHECK(!std::ifstream(path + ".tmp").good(), "no temp file left behind");
+  PASS("corrupt file");
+  return true;
+}
+
+static bool test_indexes_and_parallel_load() {
+  std::string path = temp_path("parallel");
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  for (int i = 0; i < 3000; ++i) {
+    std::string id = "n" + std::to_string(i);
+    gs.AddNode({id, R"({"kind":")" + std::string(i % 3 ? "doc" : "topic") +
+                        R"(","text":"graph node )" + std::to_string(i) +
+                        "\"}"});
+    gs.AddEdge({id, "n" + std::to_string((i + 1) % 3000), "NEXT", 1.0f, ""});
+  }
+  gs.SaveSnapshot(path);
+
+  auto kv2 = make_kv();
+  GraphStore loaded(kv2, /*n_threads=*/4);
+  loaded.EnableKeywordIndex();
+  loaded.CreatePropertyIndex("kind");
+  auto stats = loaded.LoadSnapshot(path);
+  std::remove(path.c_str());
+  CHECK(stats.nodes == 3000 && stats.edges == 3000, "all loaded");
+  CHECK(loaded.FindNodeIdsByProperties(
+                  {PropertyPredicate::Eq("kind", "\"topic\"")})
+                .size() == 1000,
+        "property index updated");
+  CHECK(loaded.KeywordStats().documents == 3000, "keyword index updated");
+  CHECK(loaded.FindPath("n0", "n2999").size() == 3000,
+        "ring traversable after parallel load");
+  CHECK(kv2->export_all_data() == kv->export_all_data(),
+        "KV contents identical");
+  PASS("indexes and parallel load");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Graph Snapshot Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_round_trip, "round_trip");
+  run(test_supernode_paging, "supernode_paging");
+  run(test_corrupt_file, "corrupt_file");
+  run(test_indexes_and_parallel_load, "indexes_and_parallel_load");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
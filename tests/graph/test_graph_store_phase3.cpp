@@ -0,0 +1,888 @@
+/**
+ * Phase 3 测试：图查询（K-hop BFS、最短路径、GraphRAG 排序）
+ *
+ * 单元测试：
+ *   - KHopNeighbors：跳数正确、k=0 返回空、有环图不死循环
+ *   - KHopNeighbors：大 frontier 下并行扩展与串行结果一致
+ *   - MultiSourceKHop：距离等于到各起点距离的最小值
+ *   - FindPath：双向 BFS 返回最短路径、src == dst、不可达、max_hops 截断
+ *   - FindPath：与参考单向 BFS 在随机图上路径长度一致
+ *   - PairingHeap：push/decrease_key/pop 输出有序
+ *   - FindWeightedPath：多重边取最小权重、不可达、负权报错、与参考实现一致
+ *   - FindWeightedPathAStar：网格图上代价与 Dijkstra 相同且扩展更少
+ *   - GraphRAGQueryRanked：按边权排序、top_n、与幂迭代 PPR 一致、时间预算；
+ *     alpha / residual_tolerance 非法时抛 std::invalid_argument
+ *   - TraversalFilter：标签 / 方向过滤作用于 GetNeighbors、KHop、FindPath、
+ *     GraphRAGQuery
+ *   - GraphRAGQueryBounded：扇出采样、结果上限、截止时间及截断统计
+ *   - GetNodes：批量读取与逐个 GetNode 一致
+ *   - Projection / NodeView：按需提取 JSON 字段、只返回 ID 或部分字段
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+#include "graph/pairing_heap.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(65536, 16);
+}
+
+// 路径合法性：首尾正确，且相邻节点之间存在出边
+static bool is_valid_path(const GraphStore &gs,
+                          const std::vector<std::string> &path,
+                          const std::string &src, const std::string &dst) {
+  if (path.empty() || path.front() != src || path.back() != dst)
+    return false;
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    auto out = gs.GetOutNeighbors(path[i]);
+    if (std::find(out.begin(), out.end(), path[i + 1]) == out.end())
+      return false;
+  }
+  return true;
+}
+
+// 参考实现：单向 BFS 求最短跳数，不可达返回 -1
+static int reference_distance(const GraphStore &gs, const std::string &src,
+                              const std::string &dst) {
+  if (src == dst)
+    return 0;
+  std::unordered_map<std::string, int> dist{{src, 0}};
+  std::queue<std::string> q;
+  q.push(src);
+  while (!q.empty()) {
+    auto cur = q.front();
+    q.pop();
+    for (const auto &nb : gs.GetOutNeighbors(cur)) {
+      if (dist.emplace(nb, dist[cur] + 1).second) {
+        if (nb == dst)
+          return dist[nb];
+        q.push(nb);
+      }
+    }
+  }
+  return -1;
+}
+
+// ── KHopNeighbors
+// ─────────────────────────────────────────────────────────────
+
+bool test_khop_distances() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  // a -> b -> c -> d，另有捷径 a -> c
+  gs.AddEdge({"a", "b", "E", 1.0f, ""});
+  gs.AddEdge({"b", "c", "E", 1.0f, ""});
+  gs.AddEdge({"c", "d", "E", 1.0f, ""});
+  gs.AddEdge({"a", "c", "E", 1.0f, ""});
+
+  auto r = gs.KHopNeighbors("a", 2);
+  CHECK(r.size() == 3, "KHop(a,2) has 3 nodes");
+  CHECK(r["b"] == 1 && r["c"] == 1 && r["d"] == 2,
+        "KHop(a,2) reports shortest hop distances");
+  CHECK(r.count("a") == 0, "KHop result excludes start node");
+  CHECK(gs.KHopNeighbors("a", 0).empty(), "KHop(a,0) is empty");
+  PASS("KHopNeighbors hop distances");
+  return true;
+}
+
+bool test_khop_cycle() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  gs.AddEdge({"x", "y", "E", 1.0f, ""});
+  gs.AddEdge({"y", "z", "E", 1.0f, ""});
+  gs.AddEdge({"z", "x", "E", 1.0f, ""});
+
+  auto r = gs.KHopNeighbors("x", 10);
+  CHECK(r.size() == 2, "KHop on cycle visits each node once");
+  PASS("KHopNeighbors terminates on cycles");
+  return true;
+}
+
+// 宽 frontier：root 连 1000 个中间节点，每个中间节点再连一个叶子，
+// 第二层扩展超过并行阈值，结果必须与串行完全一致
+bool test_khop_parallel_matches_serial() {
+  auto kv = make_kv();
+  GraphStore gs_serial(kv, 1);
+  GraphStore gs_parallel(kv, 4);
+
+  for (int i = 0; i < 1000; ++i) {
+    std::string mid = "m" + std::to_string(i);
+    gs_serial.AddEdge({"root", mid, "E", 1.0f, ""});
+    gs_serial.AddEdge({mid, "leaf" + std::to_string(i % 300), "E", 1.0f, ""});
+  }
+
+  auto serial = gs_serial.KHopNeighbors("root", 3);
+  auto parallel = gs_parallel.KHopNeighbors("root", 3);
+  CHECK(serial.size() == 1300, "serial KHop finds 1000 mids + 300 leaves");
+  CHECK(serial == parallel, "parallel KHop equals serial KHop");
+  PASS("KHopNeighbors parallel frontier expansion matches serial");
+  return true;
+}
+
+bool test_multi_source_khop() {
+  std::mt19937 rng(11);
+  GraphStore gs(make_kv(), 4);
+  const int n = 2000;
+  for (int i = 0; i < n * 4; ++i) {
+    gs.AddEdge({"v" + std::to_string(rng() % n),
+                "v" + std::to_string(rng() % n), "E", 1.0f, ""});
+  }
+
+  std::vector<std::string> sources = {"v1", "v7", "v7", "v42", "v999"};
+  auto multi = gs.MultiSourceKHop(sources, 3);
+
+  // 参考：每个起点单独 BFS，取最小跳数
+  std::unordered_map<std::string, int> expected;
+  for (const auto &src : sources) {
+    expected[src] = 0;
+    for (const auto &[id, d] : gs.KHopNeighbors(src, 3)) {
+      auto it = expected.find(id);
+      if (it == expected.end() || d < it->second)
+        expected[id] = d;
+    }
+  }
+  CHECK(multi == expected, "multi-source distances equal per-source minimum");
+  CHECK(gs.MultiSourceKHop(sources, 0).size() == 4,
+        "k=0 returns the distinct sources");
+  CHECK(gs.MultiSourceKHop({}, 3).empty(), "no sources, no result");
+  PASS("MultiSourceKHop matches per-source BFS");
+  return true;
+}
+
+// ── FindPath
+// ──────────────────────────────────────────────────────────────────
+
+bool test_find_path_basic() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  // 长路径 a->b->c->d->e，捷径 a->x->e
+  gs.AddEdge({"a", "b", "E", 1.0f, ""});
+  gs.AddEdge({"b", "c", "E", 1.0f, ""});
+  gs.AddEdge({"c", "d", "E", 1.0f, ""});
+  gs.AddEdge({"d", "e", "E", 1.0f, ""});
+  gs.AddEdge({"a", "x", "E", 1.0f, ""});
+  gs.AddEdge({"x", "e", "E", 1.0f, ""});
+
+  auto path = gs.FindPath("a", "e");
+  CHECK(path == std::vector<std::string>({"a", "x", "e"}),
+        "FindPath picks the 2-hop shortcut");
+  CHECK(gs.FindPath("a", "a") == std::vector<std::string>({"a"}),
+        "FindPath(src, src) returns {src}");
+  CHECK(gs.FindPath("e", "a").empty(), "FindPath respects edge direction");
+  CHECK(gs.FindPath("a", "e", 1).empty(), "FindPath respects max_hops");
+  CHECK(gs.FindPath("a", "e", 2).size() == 3, "max_hops == path length ok");
+  CHECK(gs.FindPath("a", "d").size() == 4, "FindPath a->d has 3 hops");
+  PASS("FindPath bidirectional BFS basic cases");
+  return true;
+}
+
+bool test_find_path_matches_reference() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> pick(0, 299);
+  for (int i = 0; i < 900; ++i) {
+    gs.AddEdge({"n" + std::to_string(pick(rng)),
+                "n" + std::to_string(pick(rng)), "E", 1.0f, ""});
+  }
+
+  for (int q = 0; q < 100; ++q) {
+    std::string s = "n" + std::to_string(pick(rng));
+    std::string d = "n" + std::to_string(pick(rng));
+    int ref = reference_distance(gs, s, d);
+    auto path = gs.FindPath(s, d);
+    if (ref < 0) {
+      CHECK(path.empty(), "unreachable pair returns empty path");
+    } else {
+      CHECK(is_valid_path(gs, path, s, d), "FindPath returns a valid path");
+      CHECK(static_cast<int>(path.size()) - 1 == ref,
+            "FindPath length equals reference BFS distance");
+    }
+  }
+  PASS("FindPath matches reference BFS on random graph");
+  return true;
+}
+
+// ── 带权最短路径
+// ──────────────────────────────────────────────────────────────
+
+bool test_pairing_heap_order() {
+  PairingHeap<double> heap;
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> dist(0.0, 1000.0);
+
+  std::vector<PairingHeap<double>::Handle> handles;
+  std::vector<double> prio;
+  for (uint32_t i = 0; i < 2000; ++i) {
+    prio.push_back(dist(rng));
+    handles.push_back(heap.push(i, prio.back()));
+  }
+  // 随机降低一半元素的优先级
+  for (uint32_t i = 0; i < 2000; i += 2) {
+    prio[i] *= 0.5;
+    heap.decrease_key(handles[i], prio[i]);
+  }
+
+  double last = -1.0;
+  size_t popped = 0;
+  while (!heap.empty()) {
+    CHECK(heap.top_priority() >= last, "PairingHeap pops in ascending order");
+    CHECK(heap.top_priority() == prio[heap.top()],
+          "PairingHeap priority matches value");
+    last = heap.top_priority();
+    heap.pop();
+    ++popped;
+  }
+  CHECK(popped == 2000, "PairingHeap pops every element once");
+  PASS("PairingHeap push / decrease_key / pop ordering");
+  return true;
+}
+
+bool test_weighted_path_basic() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  // a->b->d 代价 1+1=2；a->d 直连代价 5；a->c->d 代价 0.5+0.5=1
+  gs.AddEdge({"a", "b", "E", 1.0f, ""});
+  gs.AddEdge({"b", "d", "E", 1.0f, ""});
+  gs.AddEdge({"a", "d", "E", 5.0f, ""});
+  gs.AddEdge({"a", "c", "E", 0.5f, ""});
+  gs.AddEdge({"c", "d", "E", 0.5f, ""});
+
+  auto wp = gs.FindWeightedPath("a", "d");
+  CHECK(wp.path == std::vector<std::string>({"a", "c", "d"}),
+        "Dijkstra picks the cheapest path");
+  CHECK(std::abs(wp.cost - 1.0) < 1e-9, "Dijkstra cost is 1.0");
+  CHECK(wp.expanded >= 1, "expanded counts at least the source");
+
+  // 多重边：c->d 再加一条更便宜的 label，最短代价随之下降
+  gs.AddEdge({"c", "d", "CHEAP", 0.1f, ""});
+  CHECK(std::abs(gs.FindWeightedPath("a", "d").cost - 0.6) < 1e-6,
+        "parallel edges use the minimum weight");
+  // 删除便宜的那条，回到原代价；另一条 label 的边不受影响
+  gs.DeleteEdge("c", "d", "CHEAP");
+  CHECK(std::abs(gs.FindWeightedPath("a", "d").cost - 1.0) < 1e-6,
+        "DeleteEdge removes only the matching label");
+  // 重复 AddEdge 同一条边会更新权重
+  gs.AddEdge({"a", "c", "E", 10.0f, ""});
+  CHECK(gs.FindWeightedPath("a", "d").path ==
+            std::vector<std::string>({"a", "b", "d"}),
+        "re-adding an edge updates its weight");
+
+  auto self = gs.FindWeightedPath("a", "a");
+  CHECK(self.path == std::vector<std::string>({"a"}) && self.cost == 0.0,
+        "src == dst returns {src} with zero cost");
+  CHECK(gs.FindWeightedPath("d", "a").path.empty(), "unreachable is empty");
+
+  gs.AddEdge({"d", "x", "E", -1.0f, ""});
+  bool threw = false;
+  try {
+    gs.FindWeightedPath("d", "x");
+  } catch (const std::domain_error &) {
+    threw = true;
+  }
+  CHECK(threw, "negative weight throws");
+  PASS("FindWeightedPath basic cases");
+  return true;
+}
+
+// 参考实现：O(V^2) 的朴素 Dijkstra，基于 GetEdge 读取权重
+static double reference_weighted(const GraphStore &gs, int n,
+                                 const std::string &src,
+                                 const std::string &dst) {
+  const double INF = std::numeric_limits<double>::infinity();
+  std::unordered_map<std::string, double> dist;
+  std::unordered_set<std::string> done;
+  for (int i = 0; i < n; ++i)
+    dist["n" + std::to_string(i)] = INF;
+  dist[src] = 0.0;
+  while (true) {
+    std::string u;
+    double best = INF;
+    for (const auto &[id, d] : dist) {
+      if (!done.count(id) && d < best) {
+        best = d;
+        u = id;
+      }
+    }
+    if (best == INF)
+      return -1.0;
+    if (u == dst)
+      return best;
+    done.insert(u);
+    for (const auto &v : gs.GetOutNeighbors(u)) {
+      for (const char *label : {"A", "B"}) {
+        auto e = gs.GetEdge(u, v, label);
+        if (e && best + e->weight < dist[v])
+          dist[v] = best + e->weight;
+      }
+    }
+  }
+}
+
+bool test_weighted_path_matches_reference() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  const int N = 150;
+  std::mt19937 rng(99);
+  std::uniform_int_distribution<int> pick(0, N - 1);
+  std::uniform_real_distribution<float> wdist(0.1f, 10.0f);
+  std::bernoulli_distribution coin(0.5);
+  for (int i = 0; i < 600; ++i) {
+    gs.AddEdge({"n" + std::to_string(pick(rng)),
+                "n" + std::to_string(pick(rng)), coin(rng) ? "A" : "B",
+                wdist(rng), ""});
+  }
+
+  for (int q = 0; q < 40; ++q) {
+    std::string s = "n" + std::to_string(pick(rng));
+    std::string d = "n" + std::to_string(pick(rng));
+    double ref = reference_weighted(gs, N, s, d);
+    auto wp = gs.FindWeightedPath(s, d);
+    if (ref < 0) {
+      CHECK(wp.path.empty(), "unreachable pair returns empty path");
+      continue;
+    }
+    CHECK(!wp.path.empty() && wp.path.front() == s && wp.path.back() == d,
+          "weighted path endpoints");
+    CHECK(std::abs(wp.cost - ref) < 1e-4,
+          "Dijkstra cost equals reference cost");
+  }
+  PASS("FindWeightedPath matches reference Dijkstra on random graph");
+  return true;
+}
+
+// 网格图：embedding 为节点坐标，边权 >= 欧氏距离，L2 启发函数可采纳且一致
+bool test_astar_grid() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  const int W = 30;
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> extra(0.0f, 0.5f);
+  auto name = [](int x, int y) {
+    return "g" + std::to_string(x) + "_" + std::to_string(y);
+  };
+  for (int x = 0; x < W; ++x) {
+    for (int y = 0; y < W; ++y) {
+      gs.SetNodeEmbedding(name(x, y), {float(x), float(y)});
+      const int dx[] = {1, -1, 0, 0};
+      const int dy[] = {0, 0, 1, -1};
+      for (int d = 0; d < 4; ++d) {
+        int nx = x + dx[d], ny = y + dy[d];
+        if (nx < 0 || ny < 0 || nx >= W || ny >= W)
+          continue;
+        gs.AddEdge({name(x, y), name(nx, ny), "E", 1.0f + extra(rng), ""});
+      }
+    }
+  }
+
+  auto dij = gs.FindWeightedPath(name(2, 3), name(25, 20));
+  auto astar = gs.FindWeightedPathAStar(name(2, 3), name(25, 20), 1.0f);
+  CHECK(!dij.path.empty(), "grid is connected");
+  CHECK(std::abs(dij.cost - astar.cost) < 1e-4, "A* cost equals Dijkstra");
+  CHECK(astar.expanded < dij.expanded, "A* expands fewer nodes");
+
+  // 终点没有 embedding 时 A* 退化为 Dijkstra
+  gs.AddEdge({name(0, 0), "plain", "E", 1.0f, ""});
+  auto fallback = gs.FindWeightedPathAStar(name(1, 0), "plain", 1.0f);
+  auto plain = gs.FindWeightedPath(name(1, 0), "plain");
+  CHECK(std::abs(fallback.cost - plain.cost) < 1e-6,
+        "A* without target embedding matches Dijkstra");
+  PASS("FindWeightedPathAStar on grid (embedding heuristic)");
+  return true;
+}
+
+// ── GraphRAG 排序（个性化 PageRank）
+// ──────────────────────────────────────────────
+
+bool test_ranked_basic() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  for (const char *id : {"seed", "heavy", "light", "far"})
+    gs.AddNode({id, "{}"});
+  gs.SetNodeEmbedding("seed", {1.0f, 0.0f});
+  gs.AddEdge({"seed", "heavy", "E", 3.0f, ""});
+  gs.AddEdge({"seed", "light", "E", 1.0f, ""});
+  gs.AddEdge({"heavy", "far", "E", 1.0f, ""});
+
+  GraphRAGOptions opts;
+  opts.vector_top_k = 1;
+  opts.hop_depth = 2;
+  opts.top_n = 10;
+  opts.residual_tolerance = 1e-6;
+  auto res = gs.GraphRAGQueryRanked({1.0f, 0.0f}, opts);
+
+  CHECK(res.converged, "small graph converges");
+  CHECK(res.nodes.size() == 4, "all 4 nodes ranked");
+  CHECK(res.nodes[0].node.node_id == "seed", "seed ranks first");
+  for (size_t i = 1; i < res.nodes.size(); ++i) {
+    CHECK(res.nodes[i - 1].score >= res.nodes[i].score,
+          "scores are in descending order");
+  }
+  std::unordered_map<std::string, double> score;
+  for (const auto &sn : res.nodes)
+    score[sn.node.node_id] = sn.score;
+  CHECK(score["heavy"] > score["light"], "heavier edge gets more mass");
+
+  // hop_depth = 1：far 在 2 跳之外，不可能获得质量
+  opts.hop_depth = 1;
+  auto shallow = gs.GraphRAGQueryRanked({1.0f, 0.0f}, opts);
+  for (const auto &sn : shallow.nodes)
+    CHECK(sn.node.node_id != "far", "hop_depth bounds propagation");
+
+  opts.hop_depth = 2;
+  opts.top_n = 2;
+  CHECK(gs.GraphRAGQueryRanked({1.0f, 0.0f}, opts).nodes.size() == 2,
+        "top_n limits result size");
+  PASS("GraphRAGQueryRanked basic ranking");
+  return true;
+}
+
+// 参考实现：幂迭代求 PPR（悬挂节点跳回种子，与 push 实现一致）
+static std::unordered_map<std::string, double>
+reference_ppr(const GraphStore &gs, int n, const std::string &seed,
+              double alpha) {
+  std::vector<std::string> ids;
+  std::unordered_map<std::string, int> idx;
+  for (int i = 0; i < n; ++i) {
+    ids.push_back("n" + std::to_string(i));
+    idx[ids.back()] = i;
+  }
+  std::vector<std::vector<std::pair<int, double>>> out(n);
+  for (int i = 0; i < n; ++i) {
+    for (const auto &v : gs.GetOutNeighbors(ids[i])) {
+      for (const char *label : {"A", "B"}) {
+        auto e = gs.GetEdge(ids[i], v, label);
+        if (e)
+          out[i].push_back({idx[v], e->weight});
+      }
+    }
+  }
+  std::vector<double> pi(n, 0.0), s(n, 0.0);
+  s[idx[seed]] = 1.0;
+  pi = s;
+  for (int iter = 0; iter < 200; ++iter) {
+    std::vector<double> next(n, 0.0);
+    for (int i = 0; i < n; ++i) {
+      next[i] += alpha * s[i];
+      if (out[i].empty()) {
+        next[idx[seed]] += (1 - alpha) * pi[i];
+        continue;
+      }
+      double total = 0.0;
+      for (auto &[v, w] : out[i])
+        total += w;
+      for (auto &[v, w] : out[i])
+        next[v] += (1 - alpha) * pi[i] * w / total;
+    }
+    pi.swap(next);
+  }
+  std::unordered_map<std::string, double> result;
+  for (int i = 0; i < n; ++i)
+    result[ids[i]] = pi[i];
+  return result;
+}
+
+bool test_ranked_matches_power_iteration() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  const int N = 200;
+  std::mt19937 rng(321);
+  std::uniform_int_distribution<int> pick(0, N - 1);
+  std::uniform_real_distribution<float> wdist(0.5f, 2.0f);
+  std::bernoulli_distribution coin(0.5);
+  for (int i = 0; i < N; ++i)
+    gs.AddNode({"n" + std::to_string(i), "{}"});
+  for (int i = 0; i < 800; ++i) {
+    gs.AddEdge({"n" + std::to_string(pick(rng)),
+                "n" + std::to_string(pick(rng)), coin(rng) ? "A" : "B",
+                wdist(rng), ""});
+  }
+  gs.SetNodeEmbedding("n0", {0.0f, 1.0f});
+
+  GraphRAGOptions opts;
+  opts.vector_top_k = 1;
+  opts.hop_depth = N; // 不限制跳数，与全局 PPR 对比
+  opts.top_n = 10;
+  opts.residual_tolerance = 1e-9;
+  auto res = gs.GraphRAGQueryRanked({0.0f, 1.0f}, opts);
+  auto ref = reference_ppr(gs, N, "n0", opts.alpha);
+
+  CHECK(res.converged, "push converges without time budget");
+  CHECK(res.nodes.size() == 10, "top 10 returned");
+  for (const auto &sn : res.nodes) {
+    CHECK(std::abs(sn.score - ref[sn.node.node_id]) < 1e-5,
+          "push estimate matches power iteration");
+  }
+  PASS("GraphRAGQueryRanked matches power-iteration PPR");
+  return true;
+}
+
+bool test_ranked_rejects_bad_options() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  // 悬挂种子：阈值非正时会把质量无限次跳回自己
+  gs.AddNode({"seed", "{}"});
+  gs.SetNodeEmbedding("seed", {1.0f});
+  gs.AddEdge({"a", "b", "E", 1.0f, ""});
+  gs.AddEdge({"b", "a", "E", 1.0f, ""});
+
+  auto rejected = [&](double alpha, double tolerance) {
+    GraphRAGOptions opts;
+    opts.alpha = alpha;
+    opts.residual_tolerance = tolerance;
+    try {
+      gs.GraphRAGQueryRanked({1.0f}, opts);
+    } catch (const std::invalid_argument &) {
+      return true;
+    }
+    return false;
+  };
+  CHECK(rejected(0.15, 0.0), "zero residual_tolerance rejected");
+  CHECK(rejected(0.15, -1e-4), "negative residual_tolerance rejected");
+  CHECK(rejected(0.15, std::nan("")), "NaN residual_tolerance rejected");
+  CHECK(rejected(0.0, 1e-4), "alpha = 0 rejected");
+  CHECK(rejected(1.0, 1e-4), "alpha = 1 rejected");
+  CHECK(rejected(-0.5, 1e-4), "negative alpha rejected");
+  CHECK(!rejected(0.15, 1e-4), "defaults accepted");
+  PASS("GraphRAGQueryRanked rejects bad options");
+  return true;
+}
+
+bool test_ranked_time_budget() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+
+  std::mt19937 rng(8);
+  std::uniform_int_distribution<int> pick(0, 1999);
+  for (int i = 0; i < 8000; ++i) {
+    gs.AddEdge({"n" + std::to_string(pick(rng)),
+                "n" + std::to_string(pick(rng)), "E", 1.0f, ""});
+  }
+  gs.AddNode({"n0", "{}"});
+  gs.SetNodeEmbedding("n0", {1.0f});
+
+  GraphRAGOptions opts;
+  opts.vector_top_k = 1;
+  opts.hop_depth = 100;
+  opts.residual_tolerance = 1e-12;
+  opts.time_budget = std::chrono::microseconds(1);
+  auto res = gs.GraphRAGQueryRanked({1.0f}, opts);
+  CHECK(!res.converged, "tiny time budget stops push early");
+  CHECK(!res.nodes.empty(), "partial estimate still returns nodes");
+  PASS("GraphRAGQueryRanked respects time budget");
+  return true;
+}
+
+// ── TraversalFilter
+// ───────────────────────────────────────────────────────────
+
+// alice -KNOWS-> bob，二者各 WORKS_AT 一家公司，公司 LOCATED_IN 城市
+static void build_company_graph(GraphStore &gs) {
+  gs.AddEdge({"alice", "acme", "WORKS_AT", 1.0f, ""});
+  gs.AddEdge({"alice", "bob", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"bob", "initech", "WORKS_AT", 1.0f, ""});
+  gs.AddEdge({"acme", "city", "LOCATED_IN", 1.0f, ""});
+  gs.AddEdge({"initech", "city", "LOCATED_IN", 1.0f, ""});
+}
+
+bool test_label_filtered_traversal() {
+  GraphStore gs(make_kv());
+  build_company_graph(gs);
+
+  TraversalFilter works_at{{"WORKS_AT"}, Direction::OUT};
+  CHECK(gs.GetNeighbors("alice", works_at) ==
+            std::vector<std::string>({"acme"}),
+        "GetNeighbors keeps only WORKS_AT");
+  CHECK(gs.GetNeighbors("alice", {}).size() == 2, "empty filter keeps all");
+
+  auto r = gs.KHopNeighbors("alice", 3, {{"KNOWS", "WORKS_AT"}});
+  CHECK(r.size() == 3 && r["acme"] == 1 && r["bob"] == 1 &&
+            r["initech"] == 2,
+        "KHop follows only KNOWS / WORKS_AT");
+  CHECK(r.count("city") == 0, "LOCATED_IN is not followed");
+
+  auto in = gs.KHopNeighbors("city", 2, {{}, Direction::IN});
+  CHECK(in.size() == 4 && in["acme"] == 1 && in["alice"] == 2,
+        "IN direction walks edges backwards");
+  auto both = gs.KHopNeighbors("bob", 1, {{}, Direction::BOTH});
+  CHECK(both.size() == 2 && both.count("alice") && both.count("initech"),
+        "BOTH direction sees predecessors and successors");
+
+  CHECK(gs.FindPath("alice", "initech", INT_MAX, {{"KNOWS", "WORKS_AT"}}) ==
+            std::vector<std::string>({"alice", "bob", "initech"}),
+        "FindPath with label filter");
+  CHECK(gs.FindPath("alice", "initech", INT_MAX, works_at).empty(),
+        "no WORKS_AT-only path");
+  CHECK(gs.FindPath("initech", "alice", INT_MAX, {{}, Direction::IN}) ==
+            std::vector<std::string>({"initech", "bob", "alice"}),
+        "FindPath against edge direction");
+  CHECK(gs.FindPath("acme", "bob", INT_MAX,
+                    {{"WORKS_AT", "KNOWS"}, Direction::BOTH}) ==
+            std::vector<std::string>({"acme", "alice", "bob"}),
+        "FindPath on undirected view");
+  PASS("label / direction filtered traversal");
+  return true;
+}
+
+bool test_label_filtered_graphrag() {
+  GraphStore gs(make_kv());
+  build_company_graph(gs);
+  gs.SetNodeEmbedding("alice", {1.0f, 0.0f});
+  gs.SetNodeEmbedding("city", {0.0f, 1.0f});
+
+  auto ids = [](const std::vector<Node> &nodes) {
+    std::unordered_set<std::string> out;
+    for (const auto &n : nodes)
+      out.insert(n.node_id);
+    return out;
+  };
+  // 节点数据只有写过 AddNode 的才返回，这里补齐
+  for (const char *id : {"alice", "bob", "acme", "initech", "city"})
+    gs.AddNode({id, "{}"});
+
+  auto nodes = gs.GraphRAGQuery({1.0f, 0.0f}, 1, 2, {{"WORKS_AT"}});
+  CHECK(ids(nodes) == std::unordered_set<std::string>({"alice", "acme"}),
+        "GraphRAGQuery expands only WORKS_AT edges");
+
+  std::vector<std::vector<float>> batch = {{1.0f, 0.0f}, {0.0f, 1.0f}};
+  auto batched = gs.GraphRAGQuery(batch, 1, 1, {{}, Direction::IN});
+  CHECK(ids(batched) == std::unordered_set<std::string>(
+                            {"alice", "city", "acme", "initech"}),
+        "batched GraphRAGQuery honours direction");
+
+  GraphRAGOptions opts;
+  opts.vector_top_k = 1;
+  opts.filter = {{"WORKS_AT"}, Direction::OUT};
+  auto ranked = gs.GraphRAGQueryRanked({1.0f, 0.0f}, opts);
+  std::vector<Node> ranked_nodes;
+  for (const auto &sn : ranked.nodes)
+    ranked_nodes.push_back(sn.node);
+  CHECK(ids(ranked_nodes) ==
+            std::unordered_set<std::string>({"alice", "acme"}),
+        "ranked query pushes mass only along WORKS_AT");
+  PASS("label filtered GraphRAG queries");
+  return true;
+}
+
+// ── GraphRAGQueryBounded
+// ──────────────────────────────────────────────────────────────
+
+// hub -> l0..l999（权重递增），每个 li -> mi
+static void build_supernode_graph(GraphStore &gs) {
+  gs.AddNode({"hub", "{}"});
+  gs.SetNodeEmbedding("hub", {1.0f, 0.0f});
+  for (int i = 0; i < 1000; ++i) {
+    std::string l = "l" + std::to_string(i);
+    std::string m = "m" + std::to_string(i);
+    gs.AddNode({l, "{}"});
+    gs.AddNode({m, "{}"});
+    gs.AddEdge({"hub", l, "E", static_cast<float>(i) / 1000.0f, ""});
+    gs.AddEdge({l, m, "E", 1.0f, ""});
+  }
+}
+
+bool test_bounded_graphrag() {
+  GraphStore gs(make_kv());
+  build_supernode_graph(gs);
+  std::vector<float> q = {1.0f, 0.0f};
+
+  CHECK(gs.GraphRAGQuery(q, 1, 2).size() == 2001, "unbounded explodes");
+
+  GraphRAGBudget top;
+  top.max_fanout = 10;
+  auto r = gs.GraphRAGQueryBounded(q, 1, 1, top);
+  CHECK(r.nodes.size() == 11 && r.nodes[0].node_id == "hub",
+        "hub plus 10 sampled neighbours");
+  std::unordered_set<std::string> kept;
+  for (size_t i = 1; i < r.nodes.size(); ++i)
+    kept.insert(r.nodes[i].node_id);
+  for (int i = 990; i < 1000; ++i)
+    CHECK(kept.count("l" + std::to_string(i)), "top-weight keeps heaviest");
+  CHECK(r.fanout_sampled_nodes == 1 && r.fanout_dropped_edges == 990,
+        "fanout stats");
+  CHECK(r.hops_completed == 1 && !r.result_truncated && !r.deadline_exceeded,
+        "no other truncation");
+
+  GraphRAGBudget reservoir;
+  reservoir.max_fanout = 10;
+  reservoir.sampling = FanoutSampling::RESERVOIR;
+  reservoir.seed = 7;
+  auto a = gs.GraphRAGQueryBounded(q, 1, 2, reservoir);
+  auto b = gs.GraphRAGQueryBounded(q, 1, 2, reservoir);
+  CHECK(a.nodes.size() == 21, "hub + 10 sampled + their 10 children");
+  CHECK(a.nodes == b.nodes, "same seed, same sample");
+  reservoir.seed = 8;
+  CHECK(gs.GraphRAGQueryBounded(q, 1, 2, reservoir).nodes != a.nodes,
+        "different seed, different sample");
+
+  GraphRAGBudget capped;
+  capped.max_results = 50;
+  auto c = gs.GraphRAGQueryBounded(q, 1, 2, capped);
+  CHECK(c.nodes.size() == 50 && c.result_truncated && c.hops_completed == 0,
+        "max_results stops expansion");
+
+  GraphRAGBudget late;
+  late.deadline = std::chrono::microseconds(1);
+  auto d = gs.GraphRAGQueryBounded(q, 1, 2, late);
+  CHECK(d.deadline_exceeded && !d.nodes.empty(),
+        "deadline returns what was found so far");
+  PASS("GraphRAGQueryBounded enforces fanout / result / time budgets");
+  return true;
+}
+
+bool test_get_nodes_batch() {
+  GraphStore gs(make_kv());
+  for (int i = 0; i < 100; ++i)
+    gs.AddNode({"n" + std::to_string(i), std::to_string(i)});
+
+  std::vector<std::string> ids = {"n5", "missing", "n99", "n5", "n0"};
+  auto nodes = gs.GetNodes(ids);
+  CHECK(nodes.size() == ids.size(), "one result per id");
+  for (size_t i = 0; i < ids.size(); ++i) {
+    auto single = gs.GetNode(ids[i]);
+    CHECK(nodes[i].has_value() == single.has_value() &&
+              (!single || *nodes[i] == *single),
+          "GetNodes matches GetNode for " + ids[i]);
+  }
+  PASS("GetNodes batch lookup");
+  return true;
+}
+
+bool test_projection_and_views() {
+  const std::string props =
+      R"({"name":"Alice","tags":["a","b}"],"nested":{"x":{"y":1}},)"
+      R"("age":30,"s":"q\"uote"})";
+  CHECK(ExtractJsonField(props, "name") == std::string_view(R"("Alice")"),
+        "string field keeps quotes");
+  CHECK(ExtractJsonField(props, "tags") == std::string_view(R"(["a","b}"])"),
+        "array with bracket inside string");
+  CHECK(ExtractJsonField(props, "nested") ==
+            std::string_view(R"({"x":{"y":1}})"),
+        "nested object");
+  CHECK(ExtractJsonField(props, "age") == std::string_view("30"), "number");
+  CHECK(ExtractJsonField(props, "s") == std::string_view(R"("q\"uote")"),
+        "escaped quote");
+  CHECK(!ExtractJsonField(props, "y"), "only top-level fields");
+  CHECK(!ExtractJsonField("[1,2]", "name"), "not an object");
+
+  GraphStore gs(make_kv());
+  gs.AddNode({"alice", props});
+  gs.AddNode({"bob", R"({"name":"Bob"})"});
+  gs.SetNodeEmbedding("alice", {1.0f, 0.0f});
+  gs.AddEdge({"alice", "bob", "KNOWS", 1.0f, ""});
+
+  auto ids_only = gs.GetNodes({"alice", "nobody"}, Projection::IdsOnly());
+  CHECK(ids_only[0] && ids_only[0]->node_id == "alice" &&
+            ids_only[0]->properties_json.empty() && !ids_only[1],
+        "ids-only projection");
+  auto some = gs.GetNodes({"alice"}, Projection::Fields({"age", "x", "name"}));
+  CHECK(some[0]->properties_json == R"({"age":30,"name":"Alice"})",
+        "field projection keeps requested order, skips missing");
+
+  std::vector<std::string> names;
+  gs.VisitNodes({"bob", "alice", "nobody"},
+                [&](size_t i, const NodeView &view) {
+                  auto name = view.Property("name");
+                  names.push_back(std::to_string(i) + ":" +
+                                  std::string(name ? *name : ""));
+                });
+  std::sort(names.begin(), names.end());
+  CHECK(names == std::vector<std::string>({R"(0:"Bob")", R"(1:"Alice")"}),
+        "VisitNodes visits existing nodes with their index");
+
+  std::vector<float> q = {1.0f, 0.0f};
+  auto full = gs.GraphRAGQuery(q, 1, 1);
+  auto light = gs.GraphRAGQuery(q, 1, 1, {}, Projection::IdsOnly());
+  CHECK(full.size() == 2 && light.size() == 2, "same nodes");
+  for (size_t i = 0; i < full.size(); ++i)
+    CHECK(light[i].node_id == full[i].node_id &&
+              light[i].properties_json.empty(),
+          "GraphRAGQuery honours projection");
+  PASS("projection and zero-copy node views");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Phase 3 Unit Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_khop_distances, "khop_distances");
+  run(test_khop_cycle, "khop_cycle");
+  run(test_khop_parallel_matches_serial, "khop_parallel_matches_serial");
+  run(test_multi_source_khop, "multi_source_khop");
+  run(test_find_path_basic, "find_path_basic");
+  run(test_find_path_matches_reference, "find_path_matches_reference");
+  run(test_pairing_heap_order, "pairing_heap_order");
+  run(test_weighted_path_basic, "weighted_path_basic");
+  run(test_weighted_path_matches_reference,
+      "weighted_path_matches_reference");
+  run(test_astar_grid, "astar_grid");
+  run(test_ranked_basic, "ranked_basic");
+  run(test_ranked_matches_power_iteration, "ranked_matches_power_iteration");
+  run(test_ranked_rejects_bad_options, "ranked_rejects_bad_options");
+  run(test_ranked_time_budget, "ranked_time_budget");
+  run(test_label_filtered_traversal, "label_filtered_traversal");
+  run(test_label_filtered_graphrag, "label_filtered_graphrag");
+  run(test_bounded_graphrag, "bounded_graphrag");
+  run(test_get_nodes_batch, "get_nodes_batch");
+  run(test_projection_and_views, "projection_and_views");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -6,6 +6,11 @@
  * 2. 批量并发版本：调用 GraphRAGQuery(const vector<vector<float>>&, ...)
  *
  * 测试不同查询数量下的加速比。
+ *
+ * 另外单独对比图遍历阶段的两种策略：
+ * 1. 逐入口独立 BFS：每个入口节点各跑一次 KHopNeighbors，再合并去重
+ * 2. 多源 BFS：所有入口节点共享一次 MultiSourceKHop
+ * 入口节点越多、邻域重叠越多，多源 BFS 省下的重复扩展越多。
  */
 
 #include <cassert>
@@ -13,6 +18,7 @@
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <unordered_set>
 #include <vector>
 
 #include "core/sharded_cache.h"
@@ -100,6 +106,66 @@ double test_batch_query(GraphStore &gs,
   return elapsed.count();
 }
 
+// 图遍历阶段对比：逐入口独立 BFS vs 多源 BFS
+void compare_multi_source_bfs() {
+  const int NUM_NODES = 20000;
+  const int EDGES_PER_NODE = 8;
+  const int HOP_DEPTH = 3;
+
+  auto kv = std::make_shared<GraphKVStore>(1 << 20, 16);
+  GraphStore gs(kv, std::thread::hardware_concurrency());
+
+  std::mt19937 rng(4242);
+  std::uniform_int_distribution<int> node_dist(0, NUM_NODES - 1);
+  std::vector<Edge> edges;
+  edges.reserve(NUM_NODES * EDGES_PER_NODE);
+  for (int i = 0; i < NUM_NODES; ++i) {
+    for (int e = 0; e < EDGES_PER_NODE; ++e) {
+      edges.push_back({"node_" + std::to_string(i),
+                       "node_" + std::to_string(node_dist(rng)), "connects",
+                       1.0f, ""});
+    }
+  }
+  gs.BulkImportEdges(std::move(edges), false);
+
+  std::cout << "\n══════════════════════════════════════════════════════\n";
+  std::cout << "图遍历阶段: " << NUM_NODES << " 节点, 平均出度 "
+            << EDGES_PER_NODE << ", hop_depth " << HOP_DEPTH << "\n";
+  std::cout << "══════════════════════════════════════════════════════\n\n";
+  std::cout << std::left << std::setw(12) << "入口数" << std::setw(20)
+            << "独立BFS(ms)" << std::setw(20) << "多源BFS(ms)" << std::setw(15)
+            << "加速比" << std::setw(20) << "覆盖节点数" << std::endl;
+  std::cout << std::string(85, '-') << std::endl;
+
+  for (int n_entries : {4, 16, 64}) {
+    std::vector<std::string> entries;
+    for (int i = 0; i < n_entries; ++i)
+      entries.push_back("node_" + std::to_string(node_dist(rng)));
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::unordered_set<std::string> independent(entries.begin(),
+                                                entries.end());
+    for (const auto &entry : entries) {
+      for (const auto &[id, d] : gs.KHopNeighbors(entry, HOP_DEPTH))
+        independent.insert(id);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto shared = gs.MultiSourceKHop(entries, HOP_DEPTH);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    assert(shared.size() == independent.size());
+    double ms_independent =
+        std::chrono::duration<double, std::milli>(t1 - t0).count();
+    double ms_shared =
+        std::chrono::duration<double, std::milli>(t2 - t1).count();
+    std::cout << std::left << std::setw(12) << n_entries << std::setw(20)
+              << std::fixed << std::setprecision(2) << ms_independent
+              << std::setw(20) << ms_shared << std::setw(15)
+              << ms_independent / ms_shared << std::setw(20) << shared.size()
+              << std::endl;
+  }
+}
+
 int main() {
   std::cout << "╔══════════════════════════════════════════════════════╗\n";
   std::cout << "║   GraphRAG 批量并发性能对比测试                      ║\n";
@@ -167,12 +233,15 @@ int main() {
               << std::endl;
   }
 
+  compare_multi_source_bfs();
+
   std::cout << "\n══════════════════════════════════════════════════════\n";
   std::cout << "结论:\n";
   std::cout << "1. 当查询数量 > 1 时，批量并发版本显著快于串行循环。\n";
   std::cout
       << "2. 加速比随查询数量增加而提高，但受限于 CPU 核心数和任务并行度。\n";
   std::cout << "3. 效率指标显示并行化效果（理想值 100%）。\n";
+  std::cout << "4. 多源 BFS 让重叠的入口邻域只扩展一次，入口越多收益越大。\n";
   std::cout << "══════════════════════════════════════════════════════\n";
 
   return 0;
@@ -0,0 +1,248 @@
+/**
+ * GraphRAG 查询缓存测试：GraphVersionTracker + GraphRAGQueryCache
+ *
+ * 单元测试：
+ *   - 重复查询命中；差异小于量化步长的 embedding 共享条目；
+ *     top_k / hop_depth / filter 不同则不共享
+ *   - GRAPH_WIDE：任何写操作都使条目失效
+ *   - PER_REGION：与结果无关区域的写入不失效；触及结果节点的
+ *     AddEdge / UpdateNode / DeleteNode 以及 SetNodeEmbedding 使条目失效，
+ *     失效后重新计算的结果与未缓存时一致
+ *   - 遍历到但尚不存在的节点被 AddNode 后条目失效
+ *   - 容量满时按 LRU 淘汰并计入统计
+ */
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 16, 16);
+}
+
+static std::set<std::string> ids_of(const std::vector<Node> &nodes) {
+  std::set<std::string> ids;
+  for (const auto &n : nodes)
+    ids.insert(n.node_id);
+  return ids;
+}
+
+// a -> b -> c，a 带 embedding；d 是另一个连通分量
+static void build_chain(GraphStore &gs) {
+  for (const char *id : {"a", "b", "c", "d"})
+    gs.AddNode({id, "{}"});
+  gs.SetNodeEmbedding("a", {1.0f, 0.0f});
+  gs.SetNodeEmbedding("d", {0.0f, 1.0f});
+  gs.AddEdge({"a", "b", "R", 1.0f, ""});
+  gs.AddEdge({"b", "c", "R", 1.0f, ""});
+}
+
+// 找一个所在区域与 ids 都不同的节点 ID
+static std::string id_outside_regions(const std::set<std::string> &ids) {
+  std::set<size_t> used;
+  for (const auto &id : ids)
+    used.insert(GraphVersionTracker::RegionOf(id));
+  for (int i = 0;; ++i) {
+    std::string id = "x" + std::to_string(i);
+    if (!used.count(GraphVersionTracker::RegionOf(id)))
+      return id;
+  }
+}
+
+// ── 测试
+// ──────────────────────────────────────────────────────────────────────
+
+bool test_repeat_hits() {
+  GraphStore gs(make_kv());
+  build_chain(gs);
+  gs.EnableQueryCache();
+
+  std::vector<float> q = {1.0f, 0.0f};
+  auto first = gs.GraphRAGQuery(q, 1, 2);
+  auto second = gs.GraphRAGQuery(q, 1, 2);
+  CHECK(ids_of(first) == std::set<std::string>({"a", "b", "c"}),
+        "first query result");
+  CHECK(first == second, "cached result equals computed result");
+
+  // 量化步长 1e-3，1e-5 的扰动落在同一个格子里
+  gs.GraphRAGQuery({1.00001f, 0.00001f}, 1, 2);
+  auto stats = gs.QueryCacheStats();
+  CHECK(stats.hits == 2 && stats.misses == 1, "near-identical query hits");
+
+  gs.GraphRAGQuery(q, 2, 2);
+  gs.GraphRAGQuery(q, 1, 1);
+  TraversalFilter in_only;
+  in_only.direction = Direction::IN;
+  gs.GraphRAGQuery(q, 1, 2, in_only);
+  stats = gs.QueryCacheStats();
+  CHECK(stats.hits == 2 && stats.misses == 4 && stats.entries == 4,
+        "top_k / hop_depth / filter are part of the key");
+  CHECK(stats.hit_rate() > 0.3 && stats.hit_rate() < 0.4, "hit rate 2/6");
+
+  // 命中路径只做一次 LRU 查找和结果复制
+  using Clock = std::chrono::steady_clock;
+  const int rounds = 10000;
+  auto t0 = Clock::now();
+  for (int i = 0; i < rounds; ++i)
+    gs.GraphRAGQuery(q, 1, 2);
+  double us = std::chrono::duration<double, std::micro>(Clock::now() - t0)
+                  .count() /
+              rounds;
+  std::cout << "  cached GraphRAGQuery: " << us << " us/query\n";
+  PASS("repeated queries are served from the cache");
+  return true;
+}
+
+bool test_graph_wide_invalidation() {
+  GraphStore gs(make_kv());
+  build_chain(gs);
+  GraphRAGCacheOptions opts;
+  opts.invalidation = CacheInvalidation::GRAPH_WIDE;
+  gs.EnableQueryCache(opts);
+
+  std::vector<float> q = {1.0f, 0.0f};
+  gs.GraphRAGQuery(q, 1, 2);
+  gs.AddNode({"unrelated", "{}"});
+  gs.GraphRAGQuery(q, 1, 2);
+  auto stats = gs.QueryCacheStats();
+  CHECK(stats.hits == 0 && stats.stale == 1, "any write invalidates");
+  gs.GraphRAGQuery(q, 1, 2);
+  CHECK(gs.QueryCacheStats().hits == 1, "re-cached after recompute");
+  PASS("GRAPH_WIDE invalidation");
+  return true;
+}
+
+bool test_per_region_invalidation() {
+  GraphStore gs(make_kv());
+  build_chain(gs);
+  gs.EnableQueryCache();
+
+  std::vector<float> q = {1.0f, 0.0f};
+  auto base = gs.GraphRAGQuery(q, 1, 2);
+
+  // 与结果无关区域的写入：条目仍然有效
+  std::string far = id_outside_regions(ids_of(base));
+  gs.AddNode({far, "{}"});
+  gs.AddEdge({far, far, "R", 1.0f, ""});
+  gs.GraphRAGQuery(q, 1, 2);
+  CHECK(gs.QueryCacheStats().hits == 1, "unrelated region keeps entry");
+
+  // 结果节点新增出边：新邻居出现在结果中
+  gs.AddEdge({"a", far, "R", 1.0f, ""});
+  auto grown = gs.GraphRAGQuery(q, 1, 2);
+  CHECK(gs.QueryCacheStats().stale == 1, "AddEdge on result node is stale");
+  CHECK(ids_of(grown).count(far), "recomputed result sees the new edge");
+
+  // 更新结果节点属性
+  gs.UpdateNode({"b", R"({"v":2})"});
+  auto updated = gs.GraphRAGQuery(q, 1, 2);
+  bool seen = false;
+  for (const auto &n : updated)
+    seen |= n.node_id == "b" && n.properties_json == R"({"v":2})";
+  CHECK(seen, "UpdateNode invalidates");
+
+  // 删除结果节点
+  gs.DeleteNode("c");
+  CHECK(!ids_of(gs.GraphRAGQuery(q, 1, 2)).count("c"),
+        "DeleteNode invalidates");
+
+  // embedding 变化可能改变任意查询的入口节点
+  gs.SetNodeEmbedding("d", {1.0f, 0.0f});
+  gs.GraphRAGQuery(q, 2, 2);
+  uint64_t stale = gs.QueryCacheStats().stale;
+  gs.SetNodeEmbedding("d", {0.0f, 1.0f});
+  gs.GraphRAGQuery(q, 2, 2);
+  CHECK(gs.QueryCacheStats().stale == stale + 1,
+        "SetNodeEmbedding invalidates every entry");
+  PASS("PER_REGION invalidation");
+  return true;
+}
+
+bool test_missing_node_added_later() {
+  GraphStore gs(make_kv());
+  build_chain(gs);
+  gs.AddEdge({"a", "ghost", "R", 1.0f, ""}); // ghost 还没有节点数据
+  gs.EnableQueryCache();
+
+  std::vector<float> q = {1.0f, 0.0f};
+  CHECK(!ids_of(gs.GraphRAGQuery(q, 1, 1)).count("ghost"),
+        "missing node skipped");
+  gs.AddNode({"ghost", "{}"});
+  CHECK(ids_of(gs.GraphRAGQuery(q, 1, 1)).count("ghost"),
+        "AddNode of a traversed id invalidates");
+  PASS("traversed-but-missing nodes are tracked");
+  return true;
+}
+
+bool test_lru_eviction() {
+  GraphStore gs(make_kv());
+  build_chain(gs);
+  GraphRAGCacheOptions opts;
+  opts.capacity = 2;
+  gs.EnableQueryCache(opts);
+
+  std::vector<float> q = {1.0f, 0.0f};
+  for (int hop = 0; hop < 3; ++hop)
+    gs.GraphRAGQuery(q, 1, hop);
+  auto stats = gs.QueryCacheStats();
+  CHECK(stats.entries == 2 && stats.evictions == 1 && stats.inserts == 3,
+        "capacity bounds the cache");
+  gs.GraphRAGQuery(q, 1, 0);
+  CHECK(gs.QueryCacheStats().hits == 0, "oldest entry was evicted");
+  PASS("LRU eviction");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== GraphRAG Query Cache Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_repeat_hits, "repeat_hits");
+  run(test_graph_wide_invalidation, "graph_wide_invalidation");
+  run(test_per_region_invalidation, "per_region_invalidation");
+  run(test_missing_node_added_later, "missing_node_added_later");
+  run(test_lru_eviction, "lru_eviction");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+/**
+ * 关键词索引 + 混合 GraphRAG 测试
+ *
+ * 单元测试：
+ *   - 分词：ASCII 转小写、标点分隔、中文按字切分、JSON 转义作分隔符
+ *   - BM25：命中更多查询词 / 词频更高的节点排在前面，稀有词权重更高
+ *   - 维护：UpdateNode 重新索引、DeleteNode 移除，倒排表随之收缩
+ *   - EnableKeywordIndex 为已有节点建立索引；fields 只索引指定字段
+ *   - 混合检索：embedding 不相近但名字精确匹配的节点经 RRF 成为入口；
+ *     candidate_k <= 0 或 rrf_k < 0 抛 invalid_argument
+ */
+
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 16, 16);
+}
+
+static std::set<std::string> ids_of(const std::vector<Node> &nodes) {
+  std::set<std::string> ids;
+  for (const auto &n : nodes)
+    ids.insert(n.node_id);
+  return ids;
+}
+
+// ── 测试用例
+// ──────────────────────────────────────────────────────────────────
+
+static bool test_tokenize() {
+  auto t = KeywordIndex::Tokenize("Hello, RTX-4090 world!");
+  CHECK((t == std::vector<std::string>{"hello", "rtx", "4090", "world"}),
+        "ascii tokens are lowercased and split on punctuation");
+
+  t = KeywordIndex::Tokenize("图数据库v2");
+  CHECK((t == std::vector<std::string>{"图", "数", "据", "库", "v2"}),
+        "CJK characters become single-character tokens");
+
+  t = KeywordIndex::Tokenize(R"(line\none \"quoted\" \u00e9)");
+  CHECK((t == std::vector<std::string>{"line", "one", "quoted"}),
+        "JSON escapes act as separators");
+  PASS("tokenize");
+  return true;
+}
+
+static bool test_bm25_ranking() {
+  KeywordIndex index;
+  index.Upsert("a", R"({"name":"graph database","desc":"storage engine"})");
+  index.Upsert("b", R"({"name":"graph","desc":"graph graph theory"})");
+  index.Upsert("c", R"({"name":"vector database"})");
+  index.Upsert("d", R"({"name":"cooking recipes"})");
+
+  auto hits = index.Search("graph database", 10);
+  CHECK(hits.size() == 3, "only documents with a query term match");
+  CHECK(hits[0].first == "a", "matching both terms ranks first");
+
+  hits = index.Search("graph", 10);
+  CHECK(hits.size() == 2 && hits[0].first == "b",
+        "higher term frequency ranks first");
+
+  // "theory" 只出现在一个文档中，idf 高于出现在两个文档中的 "database"
+  auto theory = index.Search("theory", 1);
+  auto database = index.Search("database", 1);
+  CHECK(theory[0].second > database[0].second, "rare terms weigh more");
+
+  CHECK(index.Search("GRAPH", 10) == index.Search("graph", 10),
+        "queries are case-insensitive");
+  CHECK(index.Search("missing", 10).empty(), "unknown term has no hits");
+  CHECK(index.Search("graph", 1).size() == 1, "top_k bounds the result");
+  PASS("BM25 ranking");
+  return true;
+}
+
+static bool test_store_maintenance() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.AddNode({"before", R"({"name":"legacy"})"});
+  gs.EnableKeywordIndex();
+  CHECK(gs.KeywordIndexEnabled(), "index enabled");
+  CHECK(gs.SearchKeyword("legacy", 5).size() == 1,
+        "existing nodes are indexed on enable");
+
+  for (int i = 0; i < 200; ++i)
+    gs.AddNode({"n" + std::to_string(i),
+                R"({"name":"common item )" + std::to_string(i) + "\"}"});
+  auto stats = gs.KeywordStats();
+  CHECK(stats.documents == 201, "every node is a document");
+  // "common"/"item" 各 200 个条目，连续文档号的增量编码每条 2 字节
+  CHECK(stats.posting_bytes < stats.postings * 3,
+        "postings are delta/varint compressed");
+
+  gs.UpdateNode({"n7", R"({"name":"renamed"})"});
+  CHECK(gs.SearchKeyword("renamed", 5).size() == 1, "update indexes new text");
+  CHECK(gs.SearchKeyword("common", 500).size() == 199,
+        "update drops the old text");
+
+  gs.DeleteNode("n8");
+  CHECK(gs.SearchKeyword("common", 500).size() == 198,
+        "delete removes the document");
+  CHECK(gs.KeywordStats().documents == 200, "document count shrinks");
+
+  // 删除剩余节点后，倒排条目数归零
+  for (int i = 0; i < 200; ++i)
+    gs.DeleteNode("n" + std::to_string(i));
+  gs.DeleteNode("before");
+  stats = gs.KeywordStats();
+  CHECK(stats.documents == 0 && stats.postings == 0 &&
+            stats.posting_bytes == 0,
+        "postings are empty after deleting everything");
+  PASS("store maintenance");
+  return true;
+}
+
+static bool test_indexed_fields() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  KeywordIndexOptions options;
+  options.fields = {"name"};
+  gs.EnableKeywordIndex(options);
+  gs.AddNode({"p", R"({"name":"alice","bio":"likes bob"})"});
+  CHECK(gs.SearchKeyword("alice", 5).size() == 1, "indexed field matches");
+  CHECK(gs.SearchKeyword("bob", 5).empty(), "other fields are not indexed");
+  PASS("indexed fields");
+  return true;
+}
+
+static bool test_hybrid_query() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.EnableKeywordIndex();
+
+  // 5 个与查询 embedding 很近的泛化节点，以及一个 embedding 较远但
+  // 名字精确匹配的实体节点 "x9"
+  for (int i = 0; i < 5; ++i) {
+    std::string id = "g" + std::to_string(i);
+    gs.AddNode({id, R"({"name":"generic topic"})"});
+    gs.SetNodeEmbedding(id, {1.0f, 0.01f * i});
+  }
+  gs.AddNode({"x9", R"({"name":"Model X9000 spec"})"});
+  gs.SetNodeEmbedding("x9", {0.0f, 1.0f});
+  gs.AddNode({"x9_vendor", R"({"name":"vendor"})"});
+  gs.AddEdge({"x9", "x9_vendor", "MADE_BY", 1.0f, ""});
+
+  std::vector<float> q = {1.0f, 0.0f};
+  auto plain = gs.GraphRAGQuery(q, 3, 1);
+  CHECK(!ids_of(plain).count("x9"), "vector-only query misses the entity");
+
+  HybridSearchOptions options;
+  options.entry_top_k = 3;
+  auto hybrid = gs.GraphRAGQueryHybrid(q, "x9000", 1, options);
+  CHECK(hybrid.entries.size() == 3, "entry_top_k bounds fused entries");
+  CHECK(hybrid.entries[0].node_id == "x9",
+        "keyword rank 1 + vector rank 6 beats vector rank 2 alone");
+  CHECK(hybrid.entries[0].keyword_rank == 1 &&
+            hybrid.entries[0].vector_rank == 6,
+        "ranks from both lists are reported");
+  CHECK(hybrid.entries[1].node_id == "g0" &&
+            hybrid.entries[1].keyword_rank == 0,
+        "vector-only candidates follow");
+  auto ids = ids_of(hybrid.nodes);
+  CHECK(ids.count("x9") && ids.count("x9_vendor"),
+        "entity neighborhood is expanded");
+
+  auto keyword_only = gs.GraphRAGQueryHybrid({}, "x9000", 0, options);
+  CHECK(keyword_only.entries.size() == 1 && keyword_only.nodes.size() == 1,
+        "empty embedding falls back to keyword search");
+
+  auto rejected = [&](int candidate_k, int rrf_k) {
+    HybridSearchOptions bad;
+    bad.candidate_k = candidate_k;
+    bad.rrf_k = rrf_k;
+    try {
+      gs.GraphRAGQueryHybrid(q, "x9000", 1, bad);
+    } catch (const std::invalid_argument &) {
+      return true;
+    }
+    return false;
+  };
+  CHECK(rejected(0, 60) && rejected(-1, 60), "non-positive candidate_k");
+  CHECK(rejected(20, -1), "negative rrf_k");
+  CHECK(!rejected(20, 0), "rrf_k == 0 allowed");
+  PASS("hybrid query");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Keyword Index Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_tokenize, "tokenize");
+  run(test_bm25_ranking, "bm25_ranking");
+  run(test_store_maintenance, "store_maintenance");
+  run(test_indexed_fields, "indexed_fields");
+  run(test_hybrid_query, "hybrid_query");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
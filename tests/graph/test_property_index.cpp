@@ -0,0 +1,277 @@
+/**
+ * 属性二级索引测试
+ *
+ * 单元测试：
+ *   - PropertyKey：数字按数值比较（30 == 30.0），字符串与数字不相等
+ *   - HASH 等值查询；ORDERED 等值 + 范围查询；多谓词取交集
+ *   - 维护：CreatePropertyIndex 索引现有节点，UpdateNode / DeleteNode
+ *     之后查询结果随之变化；DropPropertyIndex 后查询报错
+ *   - 错误：字段没有索引、在 HASH 索引上做范围查询抛 invalid_argument
+ *   - 遍历：node_predicates 剪掉不满足谓词的邻居，且不再从它们继续扩展；
+ *     GraphRAGQuery 带谓词时不写入查询缓存
+ *   - 一致性：并发修改属性时，FindNodesByProperties 返回的节点都满足谓词
+ */
+
+#include <atomic>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 16, 16);
+}
+
+static std::set<std::string> ids_of(const std::vector<Node> &nodes) {
+  std::set<std::string> ids;
+  for (const auto &n : nodes)
+    ids.insert(n.node_id);
+  return ids;
+}
+
+static bool throws_invalid(const std::function<void()> &fn) {
+  try {
+    fn();
+  } catch (const std::invalid_argument &) {
+    return true;
+  }
+  return false;
+}
+
+// 5 个人（年龄 20..60）+ 2 家公司
+static void build_people(GraphStore &gs) {
+  for (int i = 0; i < 5; ++i) {
+    gs.AddNode({"p" + std::to_string(i),
+                R"({"type":"Person","age":)" + std::to_string(20 + 10 * i) +
+                    "}"});
+  }
+  gs.AddNode({"acme", R"({"type":"Company","age":"old"})"});
+  gs.AddNode({"init", R"({"type":"Company"})"});
+}
+
+// ── 测试用例
+// ──────────────────────────────────────────────────────────────────
+
+static bool test_property_key() {
+  CHECK(PropertyKey::Parse("30") == PropertyKey::Parse(" 30.0 "),
+        "numbers compare by value");
+  CHECK(PropertyKey::Parse("30").Canonical() ==
+            PropertyKey::Parse("3e1").Canonical(),
+        "canonical form is numeric");
+  CHECK(!(PropertyKey::Parse("30") == PropertyKey::Parse("\"30\"")),
+        "string and number differ");
+  CHECK(PropertyKey::Parse("9") < PropertyKey::Parse("10"),
+        "numeric ordering, not lexicographic");
+  CHECK(PropertyKey::Parse("\"b\"").text == "b", "string quotes stripped");
+  CHECK(PropertyKey::Parse("true").kind == PropertyKey::Kind::OTHER,
+        "literals are OTHER");
+  PASS("property key");
+  return true;
+}
+
+static bool test_hash_and_ordered_queries() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  build_people(gs);
+  gs.CreatePropertyIndex("type", PropertyIndexType::HASH);
+  gs.CreatePropertyIndex("age", PropertyIndexType::ORDERED);
+
+  auto ids = gs.FindNodeIdsByProperties(
+      {PropertyPredicate::Eq("type", "\"Company\"")});
+  CHECK((ids == std::vector<std::string>{"acme", "init"}), "hash equality");
+
+  ids = gs.FindNodeIdsByProperties({{"age", PropertyOp::GT, "30"}});
+  CHECK((ids == std::vector<std::string>{"p2", "p3", "p4"}),
+        "GT excludes equal values and non-numbers");
+  ids = gs.FindNodeIdsByProperties({{"age", PropertyOp::LE, "30"}});
+  CHECK((ids == std::vector<std::string>{"p0", "p1"}), "LE range");
+  ids = gs.FindNodeIdsByProperties({{"age", PropertyOp::EQ, "40.0"}});
+  CHECK((ids == std::vector<std::string>{"p2"}), "ordered equality");
+  ids = gs.FindNodeIdsByProperties({{"age", PropertyOp::GE, "\"a\""}});
+  CHECK((ids == std::vector<std::string>{"acme"}), "string range");
+
+  ids = gs.FindNodeIdsByProperties(
+      {{"age", PropertyOp::GE, "30"},
+       {"age", PropertyOp::LT, "50"},
+       PropertyPredicate::Eq("type", "\"Person\"")});
+  CHECK((ids == std::vector<std::string>{"p1", "p2"}),
+        "predicates are intersected");
+
+  auto nodes = gs.FindNodesByProperties(
+      {PropertyPredicate::Eq("type", "\"Company\"")}, Projection::IdsOnly());
+  CHECK(nodes.size() == 2 && nodes[0].properties_json.empty(),
+        "nodes are loaded with projection");
+
+  auto indexes = gs.ListPropertyIndexes();
+  CHECK(indexes.size() == 2 && indexes[0].field == "age" &&
+            indexes[0].entries == 6 && indexes[1].entries == 7,
+        "index listing");
+  PASS("hash and ordered queries");
+  return true;
+}
+
+static bool test_maintenance_and_errors() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  build_people(gs);
+  gs.CreatePropertyIndex("type");
+
+  gs.UpdateNode({"p0", R"({"type":"Robot"})"});
+  gs.DeleteNode("p1");
+  gs.AddNode({"p9", R"({"type":"Person"})"});
+  auto ids =
+      gs.FindNodeIdsByProperties({PropertyPredicate::Eq("type", "\"Person\"")});
+  CHECK((ids == std::vector<std::string>{"p2", "p3", "p4", "p9"}),
+        "index follows update / delete / add");
+  ids =
+      gs.FindNodeIdsByProperties({PropertyPredicate::Eq("type", "\"Robot\"")});
+  CHECK((ids == std::vector<std::string>{"p0"}), "updated value is indexed");
+
+  CHECK(throws_invalid([&] {
+          gs.FindNodeIdsByProperties({PropertyPredicate::Eq("age", "20")});
+        }),
+        "field without index throws");
+  CHECK(throws_invalid([&] {
+          gs.FindNodeIdsByProperties({{"type", PropertyOp::GT, "\"A\""}});
+        }),
+        "range on hash index throws");
+  CHECK(throws_invalid([&] { gs.FindNodeIdsByProperties({}); }),
+        "empty predicate list throws");
+
+  CHECK(gs.DropPropertyIndex("type") && !gs.DropPropertyIndex("type"),
+        "drop index");
+  CHECK(throws_invalid([&] {
+          gs.FindNodeIdsByProperties(
+              {PropertyPredicate::Eq("type", "\"Person\"")});
+        }),
+        "dropped index is gone");
+  PASS("maintenance and errors");
+  return true;
+}
+
+static bool test_traversal_filter() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.EnableQueryCache();
+  // root -> p(Person) -> q(Person)
+  //      -> c(Company) -> r(Person)   r 只能经过 c 到达
+  gs.AddNode({"root", R"({"type":"Person"})"});
+  gs.AddNode({"p", R"({"type":"Person"})"});
+  gs.AddNode({"q", R"({"type":"Person"})"});
+  gs.AddNode({"c", R"({"type":"Company"})"});
+  gs.AddNode({"r", R"({"type":"Person"})"});
+  gs.AddEdge({"root", "p", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"p", "q", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"root", "c", "WORKS_AT", 1.0f, ""});
+  gs.AddEdge({"c", "r", "EMPLOYS", 1.0f, ""});
+  gs.SetNodeEmbedding("root", {1.0f, 0.0f});
+  gs.CreatePropertyIndex("type");
+
+  TraversalFilter filter;
+  filter.node_predicates = {PropertyPredicate::Eq("type", "\"Person\"")};
+  auto reached = gs.KHopNeighbors("root", 3, filter);
+  CHECK(reached.size() == 2 && reached.count("p") && reached.count("q"),
+        "non-matching neighbor is pruned along with what lies behind it");
+
+  auto nodes = gs.GraphRAGQuery({1.0f, 0.0f}, 1, 3, filter);
+  CHECK((ids_of(nodes) == std::set<std::string>{"root", "p", "q"}),
+        "GraphRAG respects node predicates");
+  CHECK(gs.QueryCacheStats().inserts == 0,
+        "queries with node predicates bypass the cache");
+
+  // c 改成 Person 后 r 变得可达
+  gs.UpdateNode({"c", R"({"type":"Person"})"});
+  nodes = gs.GraphRAGQuery({1.0f, 0.0f}, 1, 3, filter);
+  CHECK(ids_of(nodes).count("r"), "predicate sees updated properties");
+
+  auto path = gs.FindPath("root", "r", 3, filter);
+  CHECK(path.size() == 3, "shortest path honours predicates");
+  PASS("traversal filter");
+  return true;
+}
+
+static bool test_concurrent_consistency() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  for (int i = 0; i < 64; ++i)
+    gs.AddNode({"n" + std::to_string(i), R"({"type":"A"})"});
+  gs.CreatePropertyIndex("type");
+
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    for (int round = 0; !stop.load(); ++round) {
+      const char *type = round % 2 ? R"({"type":"A"})" : R"({"type":"B"})";
+      for (int i = 0; i < 64; ++i)
+        gs.UpdateNode({"n" + std::to_string(i), type});
+    }
+  });
+
+  bool consistent = true;
+  for (int iter = 0; iter < 500 && consistent; ++iter) {
+    auto nodes =
+        gs.FindNodesByProperties({PropertyPredicate::Eq("type", "\"A\"")});
+    for (const auto &n : nodes) {
+      if (n.properties_json != R"({"type":"A"})")
+        consistent = false;
+    }
+  }
+  stop = true;
+  writer.join();
+  CHECK(consistent, "loaded nodes always satisfy the predicate");
+  PASS("concurrent consistency");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Property Index Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_property_key, "property_key");
+  run(test_hash_and_ordered_queries, "hash_and_ordered_queries");
+  run(test_maintenance_and_errors, "maintenance_and_errors");
+  run(test_traversal_filter, "traversal_filter");
+  run(test_concurrent_consistency, "concurrent_consistency");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
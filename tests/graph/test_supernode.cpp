@@ -0,0 +1,305 @@
+/**
+ * 度数统计与超级节点分页邻接表测试
+ *
+ * 单元测试：
+ *   - 度数：AddEdge / 重复 AddEdge / 多重边 / DeleteEdge / DeleteNode
+ *     之后 GetDegree 与邻接表条目数一致；直方图按 2 的幂分桶
+ *   - 升级：出度超过阈值后 adj:out 变为页头，数据分散到 adjp: 页，
+ *     邻居、标签过滤、权重与升级前语义一致
+ *   - 分页表上的删边、按邻居删除、删空后清理页头和全部页
+ *   - 目录重建：新 GraphStore 打开同一个 KV，从页头和页数据恢复目录
+ *   - 批量导入与 RebuildAdjacencyList 直接生成分页表，度数随之重建
+ *   - 并发：多线程同时向同一个枢纽节点加边，结果不丢边、度数准确
+ */
+
+#include <atomic>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 16, 16);
+}
+
+// 阈值 64、每页 16 条：几百条边就能覆盖多页的情形
+static SupernodeOptions small_pages() {
+  SupernodeOptions options;
+  options.promote_threshold = 64;
+  options.page_size = 16;
+  return options;
+}
+
+static bool is_paged(GraphKVStore &kv, const std::string &key) {
+  auto val = kv.get(key);
+  return val && PagedAdjacency::IsHeader(*val);
+}
+
+static size_t count_prefix(GraphKVStore &kv, const std::string &prefix) {
+  size_t n = 0;
+  for (const auto &[k, v] : kv.export_all_data()) {
+    if (k.compare(0, prefix.size(), prefix) == 0)
+      ++n;
+  }
+  return n;
+}
+
+static void add_hub(GraphStore &gs, const std::string &hub, int fanout) {
+  for (int i = 0; i < fanout; ++i)
+    gs.AddEdge({hub, "leaf" + std::to_string(i), i % 2 ? "B" : "A",
+                static_cast<float>(i), ""});
+}
+
+// ── 测试用例
+// ──────────────────────────────────────────────────────────────────
+
+static bool test_degree_tracking() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.AddEdge({"a", "b", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"a", "b", "KNOWS", 2.0f, ""}); // 覆盖权重，度数不变
+  gs.AddEdge({"a", "b", "LIKES", 1.0f, ""}); // 多重边按条数计
+  gs.AddEdge({"a", "c", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"c", "a", "KNOWS", 1.0f, ""});
+
+  auto a = gs.GetDegree("a");
+  CHECK(a.out == 3 && a.in == 1, "out/in degree of a");
+  CHECK(gs.GetDegree("b").in == 2 && gs.GetDegree("b").out == 0,
+        "multi-edges count twice");
+  CHECK(gs.GetDegree("missing").total() == 0, "unknown node has degree 0");
+
+  gs.DeleteEdge("a", "b", "LIKES");
+  gs.DeleteEdge("a", "b", "NOPE"); // 不存在的边不改变度数
+  CHECK(gs.GetDegree("a").out == 2 && gs.GetDegree("b").in == 1,
+        "DeleteEdge updates both endpoints");
+
+  gs.DeleteNode("a");
+  CHECK(gs.GetDegree("a").total() == 0, "deleted node has no degree");
+  CHECK(gs.GetDegree("b").in == 0 && gs.GetDegree("c").total() == 0,
+        "cascade clears neighbours");
+  CHECK(gs.DegreeStats().nodes == 0, "no node with edges left");
+  PASS("degree tracking");
+  return true;
+}
+
+static bool test_histogram() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  add_hub(gs, "hub", 5); // hub 出度 5，5 个叶子入度 1
+  gs.AddEdge({"x", "y", "E", 1.0f, ""});
+
+  auto h = gs.DegreeStats();
+  CHECK(h.nodes == 8 && h.edges == 6, "node / edge totals");
+  CHECK(h.max_out == 5 && h.max_in == 1, "max degrees");
+  // out: 6 个节点出度 0 → 桶 0；x 出度 1 → 桶 1；hub 出度 5 → 桶 3 [4, 8)
+  CHECK((h.out == std::vector<uint64_t>{6, 1, 0, 1}), "out buckets");
+  CHECK((h.in == std::vector<uint64_t>{2, 6}), "in buckets");
+  CHECK(h.paged_lists == 0, "nothing paged yet");
+  PASS("histogram");
+  return true;
+}
+
+static bool test_promotion() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.ConfigureSupernodes(small_pages());
+
+  add_hub(gs, "hub", 64);
+  CHECK(!is_paged(*kv, "adj:out:hub"), "at threshold the list stays a blob");
+  add_hub(gs, "hub", 200); // 前 64 条覆盖权重，之后继续追加
+  CHECK(is_paged(*kv, "adj:out:hub"), "list above threshold is paged");
+  CHECK(count_prefix(*kv, "adjp:out:hub:") == 200 / 16 + 1, "page count");
+  CHECK(gs.DegreeStats().paged_lists == 1, "paged list is counted");
+  CHECK(gs.GetDegree("hub").out == 200, "degree follows paged writes");
+
+  auto out = gs.GetOutNeighbors("hub");
+  CHECK(out.size() == 200, "all neighbours readable after promotion");
+  TraversalFilter only_a;
+  only_a.labels = {"A"};
+  CHECK(gs.GetNeighbors("hub", only_a).size() == 100,
+        "label filter applies to pages");
+  auto path = gs.FindWeightedPath("hub", "leaf7");
+  CHECK(path.path.size() == 2 && path.cost == 7.0, "weights survive paging");
+
+  // 重复加边只覆盖权重
+  gs.AddEdge({"hub", "leaf7", "B", 0.5f, ""});
+  CHECK(gs.GetDegree("hub").out == 200, "re-adding an edge is idempotent");
+  path = gs.FindWeightedPath("hub", "leaf7");
+  CHECK(path.cost == 0.5, "weight overwritten in place");
+  PASS("promotion");
+  return true;
+}
+
+static bool test_paged_removal() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.ConfigureSupernodes(small_pages());
+  add_hub(gs, "hub", 100);
+  // leaf3 额外有一条反向边，以及一条不同标签的重边
+  gs.AddEdge({"hub", "leaf3", "C", 1.0f, ""});
+
+  gs.DeleteEdge("hub", "leaf0", "A");
+  CHECK(gs.GetDegree("hub").out == 100, "DeleteEdge on a paged list");
+  CHECK(gs.GetOutNeighbors("hub").size() == 99, "neighbour removed");
+
+  gs.DeleteNode("leaf3"); // 级联：从 hub 的分页出边表删除两条
+  CHECK(gs.GetDegree("hub").out == 98, "RemoveNeighbor on a paged list");
+
+  // 新边填入删除留下的空位，不新开页
+  size_t pages = count_prefix(*kv, "adjp:out:hub:");
+  gs.AddEdge({"hub", "fresh", "A", 1.0f, ""});
+  CHECK(count_prefix(*kv, "adjp:out:hub:") == pages, "holes are reused");
+
+  gs.DeleteNode("hub");
+  CHECK(!kv->get("adj:out:hub") && count_prefix(*kv, "adjp:") == 0,
+        "deleting the hub drops header and pages");
+  CHECK(gs.DegreeStats().paged_lists == 0, "directory forgotten");
+  CHECK(gs.GetDegree("leaf5").in == 0, "leaves lose their in-edge");
+
+  // 逐条删空分页表同样清理干净
+  add_hub(gs, "hub2", 70);
+  for (int i = 0; i < 70; ++i)
+    gs.DeleteEdge("hub2", "leaf" + std::to_string(i), i % 2 ? "B" : "A");
+  CHECK(!kv->get("adj:out:hub2") && count_prefix(*kv, "adjp:") == 0,
+        "emptied paged list is removed");
+  PASS("paged removal");
+  return true;
+}
+
+static bool test_directory_reload() {
+  auto kv = make_kv();
+  {
+    GraphStore gs(kv);
+    gs.ConfigureSupernodes(small_pages());
+    add_hub(gs, "hub", 90);
+  }
+  // 新实例没有内存目录：读写都从页头和页数据重建
+  GraphStore gs(kv);
+  gs.ConfigureSupernodes(small_pages());
+  CHECK(gs.GetOutNeighbors("hub").size() == 90, "read rebuilds directory");
+  gs.AddEdge({"hub", "late", "A", 1.0f, ""});
+  gs.DeleteEdge("hub", "leaf1", "B");
+  CHECK(gs.GetOutNeighbors("hub").size() == 90, "writes after reload");
+  CHECK(is_paged(*kv, "adj:out:hub"), "list stays paged");
+  PASS("directory reload");
+  return true;
+}
+
+static bool test_bulk_import_and_rebuild() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.ConfigureSupernodes(small_pages());
+  std::vector<Edge> edges;
+  for (int i = 0; i < 300; ++i)
+    edges.push_back({"hub", "n" + std::to_string(i), "E", 1.0f, ""});
+  edges.push_back({"n1", "n2", "E", 1.0f, ""});
+  gs.BulkImportEdges(edges, false);
+
+  CHECK(is_paged(*kv, "adj:out:hub"), "bulk import writes pages directly");
+  CHECK(gs.GetDegree("hub").out == 300 && gs.GetDegree("n2").in == 2,
+        "bulk import records degrees");
+
+  // 再导入一批：与已有分页表合并
+  gs.BulkImportEdges({{"hub", "extra", "E", 1.0f, ""}}, false);
+  CHECK(gs.GetOutNeighbors("hub").size() == 301, "bulk merge into pages");
+
+  gs.RebuildAdjacencyList();
+  CHECK(is_paged(*kv, "adj:out:hub"), "rebuild re-pages the hub");
+  CHECK(count_prefix(*kv, "adjp:out:hub:") == 301 / 16 + 1,
+        "no stale pages after rebuild");
+  CHECK(gs.GetDegree("hub").out == 301 && gs.GetDegree("n1").total() == 2,
+        "rebuild recomputes degrees");
+  PASS("bulk import and rebuild");
+  return true;
+}
+
+static bool test_concurrent_hub_writes() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.ConfigureSupernodes(small_pages());
+
+  // 4 个线程同时向 hub 加边（跨越升级点），另有线程读
+  constexpr int kThreads = 4, kPerThread = 200;
+  std::atomic<bool> stop{false};
+  std::thread reader([&] {
+    while (!stop.load())
+      gs.GetOutNeighbors("hub");
+  });
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; ++t) {
+    writers.emplace_back([&, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        std::string leaf = "t" + std::to_string(t) + "_" + std::to_string(i);
+        gs.AddEdge({"hub", leaf, "E", 1.0f, ""});
+        if (i % 10 == 0)
+          gs.DeleteEdge("hub", leaf, "E");
+      }
+    });
+  }
+  for (auto &w : writers)
+    w.join();
+  stop = true;
+  reader.join();
+
+  const size_t expected = kThreads * (kPerThread - kPerThread / 10);
+  CHECK(gs.GetOutNeighbors("hub").size() == expected, "no lost edges");
+  CHECK(gs.GetDegree("hub").out == expected, "degree is exact");
+  CHECK(gs.DegreeStats().in[1] == expected, "every leaf has in-degree 1");
+  PASS("concurrent hub writes");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Supernode / Degree Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_degree_tracking, "degree_tracking");
+  run(test_histogram, "histogram");
+  run(test_promotion, "promotion");
+  run(test_paged_removal, "paged_removal");
+  run(test_directory_reload, "directory_reload");
+  run(test_bulk_import_and_rebuild, "bulk_import_and_rebuild");
+  run(test_concurrent_hub_writes, "concurrent_hub_writes");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
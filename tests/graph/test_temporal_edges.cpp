@@ -0,0 +1,398 @@
+/**
+ * 边有效期测试
+ *
+ * 单元测试：
+ *   - 序列化：带有效期的边和邻接表往返一致；不带有效期时字节与旧格式相同
+ *   - as_of 过滤：GetNeighbors / Traverse / KHop 只经过当时有效的边，
+ *     普通邻接表和分页邻接表结果一致；不带 as_of 时有效期不影响遍历
+ *   - 覆盖：重复 AddEdge 更新有效期；非法有效期抛 invalid_argument
+ *   - 下线：RetireExpiredEdges 按保留期删除过期边，忽略已被覆盖的旧条目；
+ *     后台 ExpirationManager 用可控时钟自动下线
+ *   - 并发：下线与重新添加同一条边交错时，重新添加的边不会被误删，
+ *     e: 记录与邻接表保持一致
+ *   - 快照：有效期经 SaveSnapshot / LoadSnapshot 保留
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_serializer.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 16, 16);
+}
+
+static Edge temporal_edge(const std::string &src, const std::string &dst,
+                          int64_t from, int64_t to) {
+  Edge e{src, dst, "E", 1.0f, ""};
+  e.valid_from = from;
+  e.valid_to = to;
+  return e;
+}
+
+static std::vector<std::string> sorted(std::vector<std::string> xs) {
+  std::sort(xs.begin(), xs.end());
+  return xs;
+}
+
+static std::vector<std::string> neighbors_at(const GraphStore &gs,
+                                             const std::string &id,
+                                             int64_t as_of) {
+  TraversalFilter filter;
+  filter.as_of = as_of;
+  return sorted(gs.GetNeighbors(id, filter));
+}
+
+// ── 测试用例
+// ──────────────────────────────────────────────────────────────────
+
+static bool test_serializer() {
+  Edge plain{"a", "b", "E", 2.0f, R"({"k":1})"};
+  Edge timed = temporal_edge("a", "b", 100, 200);
+  timed.properties_json = R"({"k":1})";
+
+  std::string plain_bytes = GraphSerializer::SerializeEdge(plain);
+  CHECK(GraphSerializer::DeserializeEdge(plain_bytes) == plain,
+        "plain edge round trip");
+  CHECK(GraphSerializer::SerializeEdge(timed).size() ==
+            plain_bytes.size() + 16,
+        "validity appended only for temporal edges");
+  CHECK(GraphSerializer::DeserializeEdge(GraphSerializer::SerializeEdge(
+            timed)) == timed,
+        "temporal edge round trip");
+  EdgeView view =
+      GraphSerializer::ViewEdge(GraphSerializer::SerializeEdge(timed));
+  CHECK(view.valid_from == 100 && view.valid_to == 200, "view validity");
+
+  std::vector<AdjEntry> entries = {{"x", "E", 1.0f},
+                                   {"y", "E", 1.0f, 10, 20},
+                                   {"z", "F", 1.0f, 15, VALID_TO_FOREVER},
+                                   {"w", "E", 1.0f, VALID_FROM_ALWAYS, 12}};
+  std::string blob = GraphSerializer::SerializeAdjEntries(entries);
+  CHECK(GraphSerializer::DeserializeAdjEntries(blob) == entries,
+        "adjacency round trip");
+  auto ids_at = [&](int64_t t, std::vector<std::string> labels = {}) {
+    std::vector<std::string> ids;
+    for (const auto &e :
+         GraphSerializer::DeserializeAdjEntries(blob, labels, t))
+      ids.push_back(e.neighbor_id);
+    return sorted(ids);
+  };
+  CHECK((ids_at(5) == std::vector<std::string>{"w", "x"}), "as_of 5");
+  CHECK((ids_at(12) == std::vector<std::string>{"x", "y"}), "as_of 12");
+  CHECK((ids_at(15) == std::vector<std::string>{"x", "y", "z"}), "as_of 15");
+  CHECK((ids_at(20) == std::vector<std::string>{"x", "z"}), "as_of 20");
+  CHECK((ids_at(15, {"F"}) == std::vector<std::string>{"z"}),
+        "as_of combined with labels");
+
+  std::vector<AdjEntry> untimed = {{"x", "E", 1.0f}, {"y", "E", 2.0f}};
+  std::string untimed_blob = GraphSerializer::SerializeAdjEntries(untimed);
+  CHECK(untimed_blob.size() == 4 + 2 * (4 + 1 + 4 + 1 + 4),
+        "untimed adjacency keeps the old layout");
+  CHECK(GraphSerializer::DeserializeAdjEntries(untimed_blob, {}, 0).size() ==
+            2,
+        "untimed entries are always valid");
+  PASS("serializer");
+  return true;
+}
+
+static bool test_as_of_filtering() {
+  SupernodeOptions paged;
+  paged.promote_threshold = 16;
+  paged.page_size = 4;
+
+  for (bool use_pages : {false, true}) {
+    auto kv = make_kv();
+    GraphStore gs(kv);
+    if (use_pages)
+      gs.ConfigureSupernodes(paged);
+    // hub 的第 i 个邻居在 [10i, 10i + 25) 有效
+    for (int i = 0; i < 40; ++i) {
+      gs.AddEdge(
+          temporal_edge("hub", "n" + std::to_string(i), 10 * i, 10 * i + 25));
+    }
+    gs.AddEdge({"hub", "always", "E", 1.0f, ""});
+    gs.AddEdge(temporal_edge("n3", "deep", 0, 1000));
+    gs.AddNode({"deep", "{}"});
+    const std::string mode = use_pages ? " (paged)" : "";
+
+    CHECK((neighbors_at(gs, "hub", 30) ==
+           std::vector<std::string>{"always", "n1", "n2", "n3"}),
+          "out neighbors at 30" + mode);
+    CHECK((neighbors_at(gs, "hub", -5) == std::vector<std::string>{"always"}),
+          "before every interval" + mode);
+    CHECK(gs.GetOutNeighbors("hub").size() == 41,
+          "no as_of means no time filter" + mode);
+
+    TraversalFilter in;
+    in.direction = Direction::IN;
+    in.as_of = 31;
+    CHECK(gs.GetNeighbors("n1", in).size() == 1, "in edge valid" + mode);
+    in.as_of = 35;
+    CHECK(gs.GetNeighbors("n1", in).empty(), "in edge expired" + mode);
+
+    TraversalFilter at35;
+    at35.as_of = 35;
+    auto hop = gs.KHopNeighbors("hub", 2, at35);
+    CHECK(hop.count("n3") && hop.count("deep") && !hop.count("n1"),
+          "k-hop as_of" + mode);
+
+    TraversalPipeline pipeline;
+    pipeline.start = {"hub"};
+    pipeline.as_of = 35;
+    pipeline.Expand(Direction::OUT).Expand(Direction::OUT);
+    pipeline.projection = Projection::IdsOnly();
+    auto result = gs.Traverse(pipeline);
+    CHECK(result.nodes.size() == 1 && result.nodes[0].node_id == "deep",
+          "pipeline as_of applies to every expand" + mode);
+  }
+  PASS("as_of filtering");
+  return true;
+}
+
+static bool test_overwrite_and_validation() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.AddEdge(temporal_edge("a", "b", 0, 10));
+  CHECK(neighbors_at(gs, "a", 15).empty(), "expired before overwrite");
+  gs.AddEdge(temporal_edge("a", "b", 0, 100));
+  CHECK(neighbors_at(gs, "a", 15).size() == 1, "validity overwritten");
+  CHECK(gs.GetEdge("a", "b", "E")->valid_to == 100, "edge record updated");
+  gs.AddEdge({"a", "b", "E", 1.0f, ""});
+  CHECK(neighbors_at(gs, "a", 1000).size() == 1, "validity cleared");
+
+  bool threw = false;
+  try {
+    gs.AddEdge(temporal_edge("a", "c", 10, 10));
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  CHECK(threw && !gs.GetEdge("a", "c", "E"), "empty interval rejected");
+
+  threw = false;
+  try {
+    gs.BulkImportEdges({temporal_edge("x", "y", 0, 5),
+                        temporal_edge("x", "z", 7, 3)});
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  CHECK(threw && !gs.GetEdge("x", "y", "E"),
+        "bulk import validates before writing");
+
+  gs.BulkImportEdges({temporal_edge("x", "y", 0, 5), {"x", "z", "E", 1.0f, ""}},
+                     /*snapshot_at_end=*/false);
+  CHECK((neighbors_at(gs, "x", 6) == std::vector<std::string>{"z"}),
+        "bulk import keeps validity");
+  PASS("overwrite and validation");
+  return true;
+}
+
+static bool test_retire_expired() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  gs.AddEdge(temporal_edge("a", "b", 0, 100));
+  gs.AddEdge(temporal_edge("a", "c", 0, 200));
+  gs.AddEdge({"a", "d", "E", 1.0f, ""});
+
+  EdgeExpirationOptions options;
+  options.retention_ms = 50;
+  options.check_interval = std::chrono::hours(1); // 只测手动下线
+  options.now = [] { return int64_t{0}; };
+  gs.EnableEdgeExpiration(options);
+  CHECK(gs.EdgeExpiration().pending == 2, "existing temporal edges queued");
+
+  gs.AddEdge(temporal_edge("a", "e", 0, 120));
+  gs.AddEdge(temporal_edge("a", "b", 0, 500)); // 覆盖后旧条目过时
+  CHECK(gs.RetireExpiredEdges(140) == 0, "inside retention");
+  CHECK(neighbors_at(gs, "a", 130).size() == 3, "history still visible");
+
+  CHECK(gs.RetireExpiredEdges(180) == 1, "only a->e retired");
+  CHECK(!gs.GetEdge("a", "e", "E") && gs.GetEdge("a", "b", "E"),
+        "overwritten edge survives its stale entry");
+  CHECK(gs.RetireExpiredEdges(1000) == 2, "remaining temporal edges");
+  CHECK(gs.GetOutNeighbors("a") == std::vector<std::string>{"d"},
+        "adjacency cleaned up");
+  CHECK(gs.GetInNeighbors("b").empty() && gs.GetDegree("a").out == 1,
+        "in lists and degrees updated");
+  auto stats = gs.EdgeExpiration();
+  CHECK(stats.pending == 0 && stats.retired == 3, "expiration stats");
+
+  bool threw = false;
+  try {
+    options.retention_ms = -1;
+    gs.EnableEdgeExpiration(options);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  CHECK(threw, "negative retention rejected");
+  PASS("retire expired");
+  return true;
+}
+
+static bool test_retire_concurrent_readd() {
+  constexpr int kEdges = 64;
+  constexpr int kRounds = 50;
+  for (int round = 0; round < kRounds; ++round) {
+    auto kv = make_kv();
+    GraphStore gs(kv);
+    EdgeExpirationOptions options;
+    options.check_interval = std::chrono::hours(1);
+    options.now = [] { return int64_t{0}; };
+    gs.EnableEdgeExpiration(options);
+    for (int i = 0; i < kEdges; ++i)
+      gs.AddEdge(temporal_edge("r", "n" + std::to_string(i), 0, 10));
+
+    // 下线线程按旧有效期删除，同时把每条边重新添加为永久边
+    std::thread retire([&gs] { gs.RetireExpiredEdges(1000); });
+    for (int i = 0; i < kEdges; ++i)
+      gs.AddEdge({"r", "n" + std::to_string(i), "E", 1.0f, ""});
+    retire.join();
+
+    for (int i = 0; i < kEdges; ++i) {
+      const std::string dst = "n" + std::to_string(i);
+      auto edge = gs.GetEdge("r", dst, "E");
+      CHECK(edge && edge->valid_to == VALID_TO_FOREVER,
+            "re-added edge survives retirement: " << dst);
+      CHECK(gs.GetInNeighbors(dst) == std::vector<std::string>{"r"},
+            "in list matches edge record: " << dst);
+    }
+    CHECK(gs.GetOutNeighbors("r").size() == kEdges,
+          "out list matches edge records");
+  }
+  PASS("retire concurrent re-add");
+  return true;
+}
+
+static bool test_background_expiration() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  auto clock = std::make_shared<std::atomic<int64_t>>(0);
+  EdgeExpirationOptions options;
+  options.check_interval = std::chrono::milliseconds(5);
+  options.sample_size = 4;
+  options.now = [clock] { return clock->load(); };
+  gs.EnableEdgeExpiration(options);
+
+  for (int i = 0; i < 30; ++i)
+    gs.AddEdge(temporal_edge("s", "t" + std::to_string(i), 0, 100 + i));
+  gs.AddEdge({"s", "keep", "E", 1.0f, ""});
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  CHECK(gs.GetOutNeighbors("s").size() == 31, "nothing retired early");
+
+  clock->store(115); // [from, to) 半开区间：valid_to == 115 的边也已失效
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (gs.EdgeExpiration().retired < 16 &&
+         std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  CHECK(gs.EdgeExpiration().retired == 16, "edges up to now retired");
+  CHECK(gs.GetOutNeighbors("s").size() == 15 && gs.GetEdge("s", "t16", "E") &&
+            !gs.GetEdge("s", "t15", "E"),
+        "later edges kept");
+  PASS("background expiration");
+  return true;
+}
+
+static bool test_snapshot_validity() {
+  std::string path = "/tmp/minkv_temporal_edges_" +
+                     std::to_string(::getpid()) + ".bin";
+  SupernodeOptions paged;
+  paged.promote_threshold = 16;
+  paged.page_size = 4;
+
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  for (int i = 0; i < 20; ++i)
+    gs.AddEdge(temporal_edge("hub", "n" + std::to_string(i), i, i + 5));
+  gs.AddEdge({"hub", "always", "E", 1.0f, ""});
+  gs.AddEdge(temporal_edge("n1", "hub", 0, 3));
+  gs.SaveSnapshot(path);
+
+  auto kv2 = make_kv();
+  GraphStore loaded(kv2);
+  loaded.ConfigureSupernodes(paged);
+  EdgeExpirationOptions options;
+  options.check_interval = std::chrono::hours(1);
+  options.now = [] { return int64_t{0}; };
+  loaded.EnableEdgeExpiration(options);
+  loaded.LoadSnapshot(path);
+  std::remove(path.c_str());
+
+  CHECK(neighbors_at(loaded, "hub", 10) == neighbors_at(gs, "hub", 10) &&
+            neighbors_at(loaded, "hub", 10).size() == 6,
+        "out validity restored (paged)");
+  TraversalFilter in;
+  in.direction = Direction::IN;
+  in.as_of = 2;
+  CHECK(sorted(loaded.GetNeighbors("hub", in)) ==
+            std::vector<std::string>{"n1"},
+        "in validity restored");
+  in.as_of = 3;
+  CHECK(loaded.GetNeighbors("hub", in).empty(), "in edge expired");
+  CHECK(loaded.GetEdge("hub", "n7", "E")->valid_to == 12,
+        "edge record keeps validity");
+  CHECK(loaded.EdgeExpiration().pending == 21, "loaded edges queued");
+  CHECK(loaded.RetireExpiredEdges(10) == 7, "loaded edges retire");
+  PASS("snapshot validity");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Temporal Edge Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_serializer, "serializer");
+  run(test_as_of_filtering, "as_of_filtering");
+  run(test_overwrite_and_validation, "overwrite_and_validation");
+  run(test_retire_expired, "retire_expired");
+  run(test_retire_concurrent_readd, "retire_concurrent_readd");
+  run(test_background_expiration, "background_expiration");
+  run(test_snapshot_validity, "snapshot_validity");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+/**
+ * 遍历管道测试
+ *
+ * 单元测试：
+ *   - 多步扩展：按方向、标签逐步扩展，每一步输出去重
+ *   - FILTER：没有索引时按批读取节点记录判定；有索引时下推到邻接表扫描，
+ *     两种方式结果一致，且下推后不再读取节点记录
+ *   - LIMIT：满足后停止拉取上游，只读取少量邻接表
+ *   - 起点：start_where 走二级索引；起点为空时抛 invalid_argument
+ *   - 投影与缺失节点：只返回投影字段，没有 n: 记录的端点被省略
+ */
+
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+
+using namespace minkv::graph;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<GraphKVStore> make_kv() {
+  return std::make_shared<GraphKVStore>(1 << 16, 16);
+}
+
+static std::set<std::string> ids_of(const std::vector<Node> &nodes) {
+  std::set<std::string> ids;
+  for (const auto &n : nodes)
+    ids.insert(n.node_id);
+  return ids;
+}
+
+// alice -KNOWS-> bob, carol, dave；bob/carol -WORKS_AT-> acme；
+// dave -WORKS_AT-> init；erin -KNOWS-> alice
+static void build_social(GraphStore &gs) {
+  gs.AddNode({"alice", R"({"type":"Person","age":30})"});
+  gs.AddNode({"bob", R"({"type":"Person","age":25})"});
+  gs.AddNode({"carol", R"({"type":"Person","age":41})"});
+  gs.AddNode({"dave", R"({"type":"Person","age":35})"});
+  gs.AddNode({"erin", R"({"type":"Person","age":50})"});
+  gs.AddNode({"acme", R"({"type":"Company","size":"large"})"});
+  gs.AddNode({"init", R"({"type":"Company","size":"small"})"});
+  gs.AddEdge({"alice", "bob", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"alice", "carol", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"alice", "dave", "KNOWS", 1.0f, ""});
+  gs.AddEdge({"alice", "acme", "LIKES", 1.0f, ""});
+  gs.AddEdge({"bob", "acme", "WORKS_AT", 1.0f, ""});
+  gs.AddEdge({"carol", "acme", "WORKS_AT", 1.0f, ""});
+  gs.AddEdge({"dave", "init", "WORKS_AT", 1.0f, ""});
+  gs.AddEdge({"erin", "alice", "KNOWS", 1.0f, ""});
+}
+
+// ── 测试用例
+// ──────────────────────────────────────────────────────────────────
+
+static bool test_expand_chain() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  build_social(gs);
+
+  TraversalPipeline q;
+  q.start = {"alice", "alice"}; // 重复起点只处理一次
+  q.Expand(Direction::OUT, {"KNOWS"}).Expand(Direction::OUT, {"WORKS_AT"});
+  auto r = gs.Traverse(q);
+  CHECK(r.nodes.size() == 2 &&
+            (ids_of(r.nodes) == std::set<std::string>{"acme", "init"}),
+        "friends' employers, deduplicated");
+  CHECK(r.stats.nodes_expanded == 4, "alice + three friends expanded");
+
+  TraversalPipeline back;
+  back.start = {"acme"};
+  back.Expand(Direction::IN, {"WORKS_AT"}).Expand(Direction::IN);
+  CHECK((ids_of(gs.Traverse(back).nodes) == std::set<std::string>{"alice"}),
+        "incoming expansion");
+
+  TraversalPipeline both;
+  both.start = {"alice"};
+  both.Expand(Direction::BOTH, {"KNOWS"});
+  CHECK(gs.Traverse(both).nodes.size() == 4, "both directions");
+  PASS("expand chain");
+  return true;
+}
+
+static bool test_filter_pushdown() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  build_social(gs);
+
+  TraversalPipeline q;
+  q.start = {"alice"};
+  q.Expand(Direction::OUT)
+      .Where({PropertyPredicate::Eq("type", "\"Person\""),
+              {"age", PropertyOp::GE, "30"}});
+
+  // 没有索引：读取节点记录判定
+  auto scanned = gs.Traverse(q);
+  CHECK((ids_of(scanned.nodes) == std::set<std::string>{"carol", "dave"}),
+        "filter without index");
+  CHECK(scanned.stats.filters_pushed_down == 0 &&
+            scanned.stats.nodes_filtered == 4,
+        "records are read when no index exists");
+
+  // 建索引后下推到邻接表扫描
+  gs.CreatePropertyIndex("type");
+  gs.CreatePropertyIndex("age", PropertyIndexType::ORDERED);
+  auto pushed = gs.Traverse(q);
+  CHECK(ids_of(pushed.nodes) == ids_of(scanned.nodes),
+        "pushdown gives the same answer");
+  CHECK(pushed.stats.filters_pushed_down == 1 &&
+            pushed.stats.nodes_filtered == 0,
+        "pushed-down filter reads no node records");
+  CHECK(pushed.stats.neighbors_scanned == 2,
+        "non-matching neighbours are pruned during the scan");
+
+  // 范围谓词落在 HASH 索引上：不能下推，回退到逐条判定
+  gs.CreatePropertyIndex("age", PropertyIndexType::HASH);
+  auto fallback = gs.Traverse(q);
+  CHECK(fallback.stats.filters_pushed_down == 0 &&
+            ids_of(fallback.nodes) == ids_of(scanned.nodes),
+        "unservable predicates fall back to record filtering");
+
+  // FILTER 作为第一步作用于起点
+  TraversalPipeline first;
+  first.start = {"alice", "acme", "bob"};
+  first.Where({PropertyPredicate::Eq("type", "\"Company\"")});
+  CHECK((ids_of(gs.Traverse(first).nodes) == std::set<std::string>{"acme"}),
+        "filter on the start set");
+  PASS("filter pushdown");
+  return true;
+}
+
+static bool test_limit_stops_early() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  // 1000 个起点，每个各有 2 个邻居
+  std::vector<std::string> start;
+  for (int i = 0; i < 1000; ++i) {
+    std::string id = "s" + std::to_string(i);
+    gs.AddNode({id, "{}"});
+    gs.AddNode({id + "a", "{}"});
+    gs.AddNode({id + "b", "{}"});
+    gs.AddEdge({id, id + "a", "E", 1.0f, ""});
+    gs.AddEdge({id, id + "b", "E", 1.0f, ""});
+    start.push_back(id);
+  }
+
+  TraversalPipeline q;
+  q.start = start;
+  q.batch_size = 16;
+  q.Expand(Direction::OUT).Limit(10);
+  auto r = gs.Traverse(q);
+  CHECK(r.nodes.size() == 10, "limit caps the result");
+  CHECK(r.stats.limit_reached, "limit reported");
+  CHECK(r.stats.nodes_expanded == 16,
+        "only the first batch of adjacency lists is read");
+  CHECK(r.nodes[0].node_id == "s0a" && r.nodes[1].node_id == "s0b",
+        "results follow the start order");
+
+  q.steps.back().limit = 0;
+  r = gs.Traverse(q);
+  CHECK(r.nodes.empty() && r.stats.nodes_expanded == 0,
+        "limit 0 reads nothing");
+
+  TraversalPipeline all;
+  all.start = start;
+  all.Expand(Direction::OUT).Limit(5000);
+  r = gs.Traverse(all);
+  CHECK(r.nodes.size() == 2000 && !r.stats.limit_reached,
+        "limit above the result size");
+  PASS("limit stops early");
+  return true;
+}
+
+static bool test_start_and_projection() {
+  auto kv = make_kv();
+  GraphStore gs(kv);
+  build_social(gs);
+  gs.AddEdge({"alice", "ghost", "KNOWS", 1.0f, ""}); // ghost 没有 n: 记录
+
+  TraversalPipeline empty;
+  bool threw = false;
+  try {
+    gs.Traverse(empty);
+  } catch (const std::invalid_argument &) {
+    threw = true;
+  }
+  CHECK(threw, "missing start throws");
+
+  gs.CreatePropertyIndex("type");
+  TraversalPipeline q;
+  q.start_where = {PropertyPredicate::Eq("type", "\"Company\"")};
+  q.Expand(Direction::IN, {"WORKS_AT"});
+  q.projection = Projection::Fields({"age"});
+  auto r = gs.Traverse(q);
+  CHECK((ids_of(r.nodes) == std::set<std::string>{"bob", "carol", "dave"}),
+        "start_where uses the index");
+  CHECK(r.nodes[0].properties_json.find("type") == std::string::npos &&
+            r.nodes[0].properties_json.find("age") != std::string::npos,
+        "projection applied");
+
+  TraversalPipeline ghost;
+  ghost.start = {"alice"};
+  ghost.Expand(Direction::OUT, {"KNOWS"});
+  CHECK(gs.Traverse(ghost).nodes.size() == 3,
+        "endpoints without a node record are omitted");
+  PASS("start and projection");
+  return true;
+}
+
+// ── main
+// ──────────────────────────────────────────────────────────────────────
+
+int main() {
+  std::cout << "=== Traversal Pipeline Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_expand_chain, "expand_chain");
+  run(test_filter_pushdown, "filter_pushdown");
+  run(test_limit_stops_early, "limit_stops_early");
+  run(test_start_and_projection, "start_and_projection");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
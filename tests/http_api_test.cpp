@@ -0,0 +1,505 @@
+/**
+ * HTTP 接口端到端测试（进程内 HttpServer + httplib::Client）
+ *
+ *   - /kv/scan：limit 限制单次返回条数（末页最多多出一个哈希桶），
+ *     按 cursor 续传能取全所有 key；prefix / keys_only 过滤；非法参数 400
+ *   - 批量接口 /kv/mget|mset|mdel、/vector/mput|msearch、
+ *     /graph/add_nodes|add_edges：逐项结果与 failed 计数，非法项不影响
+ *     其余各项，超过单次上限（10000 项）整体 400
+ *   - 二进制向量传输：fp32 / fp16 经 /vector/put 写入、
+ *     Accept: application/octet-stream 读回逐字节一致；二进制检索；
+ *     请求体长度与 X-Vector-Dimension 不符、X-Vector-Dtype 非法时 400
+ *   - /graph/rag_query 参数校验：排序模式 residual_tolerance <= 0、
+ *     混合模式 candidate_k <= 0 或 rrf_k < 0 时 400
+ *   - /graph/shortest_path：搜索经过负权 / NaN 边时 422
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/sharded_cache.h"
+#include "graph/graph_store.h"
+#include "server/http_server.h"
+#include "server/httplib.h"
+#include "vector/vector_ops.h"
+
+using namespace minkv;
+using namespace minkv::server;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+using GraphKVStore = minkv::db::ShardedCache<std::string, std::string>;
+
+static constexpr int kPort = 18102;
+static constexpr size_t kMaxBatch = 10000; // HttpServer::kMaxBatchSize
+
+/// NDJSON 响应拆成逐行的 JSON
+static std::vector<json> parse_ndjson(const std::string &body) {
+  std::vector<json> lines;
+  std::istringstream in(body);
+  std::string line;
+  while (std::getline(in, line))
+    if (!line.empty())
+      lines.push_back(json::parse(line));
+  return lines;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// /kv/scan
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_kv_scan() {
+  std::shared_ptr<StringKV> kv = StringKV::create(1 << 14, 16);
+  for (int i = 0; i < 1000; ++i)
+    kv->put("user:" + std::to_string(i), "v" + std::to_string(i));
+  for (int i = 0; i < 100; ++i)
+    kv->put("order:" + std::to_string(i), "o");
+  HttpServer server(kv, nullptr, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+
+  // limit 远小于 count：只返回一页左右，cursor 未结束
+  auto res = cli.Get("/kv/scan?limit=10");
+  CHECK(res && res->status == 200, "scan with limit");
+  auto lines = parse_ndjson(res->body);
+  CHECK(!lines.empty(), "scan has trailer");
+  json trailer = lines.back();
+  size_t count = trailer["count"].get<size_t>();
+  std::cout << "  limit=10 returned " << count << " rows\n";
+  CHECK(count + 1 == lines.size(), "count matches rows");
+  CHECK(count >= 10 && count <= 20, "limit caps rows (one bucket overshoot)");
+  CHECK(trailer["cursor"] != "0", "cursor resumable after limit");
+
+  // 按 cursor 续传直到结束：每个 key 至少出现一次
+  std::set<std::string> seen;
+  std::string cursor = "0";
+  int calls = 0;
+  do {
+    res = cli.Get("/kv/scan?prefix=user:&keys_only=true&limit=100&count=64"
+                  "&cursor=" +
+                  cursor);
+    CHECK(res && res->status == 200, "resumed scan");
+    lines = parse_ndjson(res->body);
+    for (size_t i = 0; i + 1 < lines.size(); ++i) {
+      CHECK(!lines[i].contains("value"), "keys_only omits value");
+      seen.insert(lines[i]["key"].get<std::string>());
+    }
+    cursor = lines.back()["cursor"].get<std::string>();
+    ++calls;
+  } while (cursor != "0" && calls < 1000);
+  CHECK(cursor == "0", "scan finishes");
+  CHECK(seen.size() == 1000, "prefix scan returns every user key");
+  CHECK(calls > 1, "limit splits the scan into several calls");
+
+  // 无 limit：一次遍历到底
+  res = cli.Get("/kv/scan?prefix=order:");
+  CHECK(res && res->status == 200, "full scan");
+  lines = parse_ndjson(res->body);
+  CHECK(lines.back()["cursor"] == "0", "full scan done");
+  CHECK(lines.back()["count"] == 100, "full scan returns all matches");
+  CHECK(lines.front()["value"] == "o", "values included by default");
+
+  res = cli.Get("/kv/scan?cursor=bogus");
+  CHECK(res && res->status == 400, "malformed cursor");
+  res = cli.Get("/kv/scan?limit=-1");
+  CHECK(res && res->status == 400, "negative limit");
+  server.stop();
+  PASS("kv_scan");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 批量接口
+// ══════════════════════════════════════════════════════════════════════════════
+
+static json post_json(httplib::Client &cli, const char *path,
+                      const json &body, int expect_status = 200) {
+  auto res = cli.Post(path, body.dump(), "application/json");
+  if (!res || res->status != expect_status)
+    throw std::runtime_error(std::string(path) + " status " +
+                             (res ? std::to_string(res->status) : "none"));
+  return json::parse(res->body);
+}
+
+/// {"<field>": [{}, {}, ...]}，共 n 项
+static json oversized_batch(const char *field, size_t n) {
+  return {{field, json::array_t(n, json::object())}};
+}
+
+static bool test_kv_batch() {
+  std::shared_ptr<StringKV> kv = StringKV::create(4096, 16);
+  HttpServer server(kv, nullptr, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+
+  json res = post_json(cli, "/kv/mset",
+                       {{"items",
+                         {{{"key", "a"}, {"value", "1"}},
+                          {{"key", "b"}, {"value", "2"}, {"ttl_ms", 60000}},
+                          {{"key", "c"}}, // 缺 value
+                          {{"key", "d"}, {"value", "4"}}}}});
+  CHECK(res["count"] == 4 && res["failed"] == 1, "mset counts");
+  CHECK(res["results"][2]["success"] == false &&
+            res["results"][2]["index"] == 2 &&
+            res["results"][2].contains("error"),
+        "mset per-item error");
+  CHECK(res["results"][3]["success"] == true && res["results"][3]["key"] == "d",
+        "items after the bad one still written");
+  CHECK(kv->get("a") == "1" && kv->get("d") == "4" && !kv->get("c"),
+        "mset wrote the valid items");
+  CHECK(kv->ttl("b") > 0 && kv->ttl("a") == -1, "per-item ttl_ms");
+
+  res = post_json(cli, "/kv/mget", {{"keys", {"a", "missing", "d"}}});
+  CHECK(res["count"] == 3, "mget count");
+  CHECK(res["results"][0]["found"] == true && res["results"][0]["value"] == "1",
+        "mget hit");
+  CHECK(res["results"][1]["found"] == false &&
+            !res["results"][1].contains("value"),
+        "mget miss");
+
+  res = post_json(cli, "/kv/mdel", {{"keys", {"a", "missing", "a"}}});
+  CHECK(res["results"][0]["deleted"] == true, "mdel existing");
+  CHECK(res["results"][1]["deleted"] == false, "mdel missing");
+  CHECK(res["results"][2]["deleted"] == false, "mdel duplicate only once");
+  CHECK(!kv->get("a") && kv->get("d"), "mdel removed only listed keys");
+
+  post_json(cli, "/kv/mget", oversized_batch("keys", kMaxBatch + 1), 400);
+  post_json(cli, "/kv/mset", oversized_batch("items", kMaxBatch + 1), 400);
+  post_json(cli, "/kv/mdel", {{"keys", "a"}}, 400); // 不是数组
+  post_json(cli, "/kv/mget", json::object(), 400);
+  res = post_json(cli, "/kv/mget",
+                  {{"keys", json::array_t(kMaxBatch, "missing")}});
+  CHECK(res["count"] == kMaxBatch, "batch at the limit accepted");
+  server.stop();
+  PASS("kv_batch");
+  return true;
+}
+
+static bool test_vector_batch() {
+  std::shared_ptr<StringKV> kv = StringKV::create(4096, 16);
+  HttpServer server(kv, nullptr, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+
+  json res = post_json(
+      cli, "/vector/mput",
+      {{"items",
+        {{{"key", "v0"}, {"embedding", {0.0, 0.0, 0.0}}},
+         {{"key", "v1"}, {"embedding", {1.0, 0.0, 0.0}}},
+         {{"key", "bad"}, {"embedding", json::array()}}, // 空向量
+         {{"key", "v2"}, {"embedding", {5.0, 5.0, 5.0}}},
+         {{"embedding", {1.0, 1.0, 1.0}}}}}}); // 缺 key
+  CHECK(res["count"] == 5 && res["failed"] == 2, "mput counts");
+  CHECK(res["results"][0]["dimension"] == 3, "mput dimension");
+  CHECK(res["results"][2]["success"] == false, "empty embedding rejected");
+  CHECK(res["results"][4]["success"] == false, "missing key rejected");
+  CHECK(kv->vectorGet("v2").size() == 3 && kv->vectorGet("bad").empty(),
+        "mput wrote the valid items");
+
+  res = post_json(cli, "/vector/msearch",
+                  {{"top_k", 1},
+                   {"queries",
+                    {{0.9, 0.0, 0.0}, json::array(), {4.0, 4.0, 4.0}}}});
+  CHECK(res["count"] == 3 && res["top_k"] == 1, "msearch counts");
+  CHECK(res["results"][0]["success"] == true &&
+            res["results"][0]["results"] == json({"v1"}),
+        "msearch first query");
+  CHECK(res["results"][1]["success"] == false &&
+            res["results"][1].contains("error"),
+        "msearch empty query fails alone");
+  CHECK(res["results"][2]["results"] == json({"v2"}), "msearch third query");
+
+  post_json(cli, "/vector/msearch", {{"queries", {{1.0}}}}, 400); // 缺 top_k
+  post_json(cli, "/vector/msearch",
+            {{"top_k", 1}, {"queries", json::array_t(kMaxBatch + 1)}}, 400);
+  post_json(cli, "/vector/mput", oversized_batch("items", kMaxBatch + 1), 400);
+  server.stop();
+  PASS("vector_batch");
+  return true;
+}
+
+static bool test_graph_batch() {
+  std::shared_ptr<StringKV> kv = StringKV::create(4096, 16);
+  auto gs = std::make_shared<graph::GraphStore>(
+      std::make_shared<GraphKVStore>(4096, 16));
+  HttpServer server(kv, gs, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+
+  json res = post_json(
+      cli, "/graph/add_nodes",
+      {{"nodes",
+        {{{"node_id", "alice"}, {"properties_json", "{\"age\":30}"}},
+         {{"node_id", "bob"}, {"embedding", {1.0, 0.0}}},
+         {{"properties_json", "{}"}}, // 缺 node_id
+         {{"node_id", "carol"}}}}});
+  CHECK(res["count"] == 4 && res["failed"] == 1, "add_nodes counts");
+  CHECK(res["results"][3]["node_id"] == "carol", "add_nodes per-item id");
+  auto alice = gs->GetNode("alice");
+  CHECK(alice && alice->properties_json == "{\"age\":30}", "node stored");
+  CHECK(gs->GetNode("carol"), "node after the bad one stored");
+
+  res = post_json(cli, "/graph/add_edges",
+                  {{"edges",
+                    {{{"src_id", "alice"},
+                      {"dst_id", "bob"},
+                      {"label", "KNOWS"}},
+                     {{"src_id", "alice"},
+                      {"dst_id", "carol"},
+                      {"label", "KNOWS"},
+                      {"valid_from", 10},
+                      {"valid_to", 5}}, // 有效期非法
+                     {{"src_id", "bob"}, {"dst_id", "carol"}}, // 缺 label
+                     {{"src_id", "bob"},
+                      {"dst_id", "carol"},
+                      {"label", "KNOWS"},
+                      {"weight", 2.5}}}}});
+  CHECK(res["count"] == 4 && res["failed"] == 2, "add_edges counts");
+  CHECK(res["results"][1]["success"] == false, "bad validity rejected");
+  CHECK(res["results"][3]["label"] == "KNOWS", "add_edges per-item label");
+  auto edge = gs->GetEdge("bob", "carol", "KNOWS");
+  CHECK(edge && edge->weight == 2.5f, "edge stored with weight");
+  CHECK(!gs->GetEdge("alice", "carol", "KNOWS"), "invalid edge not stored");
+  CHECK(gs->GetOutNeighbors("alice") == std::vector<std::string>{"bob"},
+        "adjacency updated");
+
+  post_json(cli, "/graph/add_nodes", oversized_batch("nodes", kMaxBatch + 1),
+            400);
+  post_json(cli, "/graph/add_edges", oversized_batch("edges", kMaxBatch + 1),
+            400);
+  server.stop();
+  PASS("graph_batch");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 二进制向量传输
+// ══════════════════════════════════════════════════════════════════════════════
+
+static std::string fp32_bytes(const std::vector<float> &v) {
+  return std::string(reinterpret_cast<const char *>(v.data()),
+                     v.size() * sizeof(float));
+}
+
+static std::string fp16_bytes(const std::vector<float> &v) {
+  std::string out(v.size() * 2, '\0');
+  for (size_t i = 0; i < v.size(); ++i) {
+    uint16_t h = VectorOps::FloatToHalf(v[i]);
+    std::memcpy(&out[i * 2], &h, 2);
+  }
+  return out;
+}
+
+static httplib::Headers vector_headers(size_t dimension,
+                                       const char *dtype = nullptr) {
+  httplib::Headers headers = {
+      {"X-Vector-Dimension", std::to_string(dimension)}};
+  if (dtype)
+    headers.emplace("X-Vector-Dtype", dtype);
+  return headers;
+}
+
+static bool test_vector_binary() {
+  std::shared_ptr<StringKV> kv = StringKV::create(4096, 16);
+  HttpServer server(kv, nullptr, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+  const char *octet = "application/octet-stream";
+  // 都能用 fp16 精确表示，往返后逐字节一致
+  const std::vector<float> v = {0.5f, -1.25f, 2.0f, 3.75f};
+
+  // fp32：写入后按 fp32 读回
+  auto res = cli.Post("/vector/put?key=f32", vector_headers(4),
+                      fp32_bytes(v), octet);
+  CHECK(res && res->status == 200, "fp32 put");
+  CHECK(json::parse(res->body)["dimension"] == 4, "fp32 put dimension");
+  CHECK(kv->vectorGet("f32") == v, "fp32 stored as is");
+  res = cli.Get("/vector/get?key=f32", {{"Accept", octet}});
+  CHECK(res && res->status == 200, "fp32 get");
+  CHECK(res->get_header_value("Content-Type") == octet, "octet response");
+  CHECK(res->get_header_value("X-Vector-Dimension") == "4", "dimension header");
+  CHECK(res->get_header_value("X-Vector-Dtype") == "fp32", "dtype header");
+  CHECK(res->body == fp32_bytes(v), "fp32 round trip");
+
+  // fp16：写入时解码成 fp32 存储，按 fp16 / fp32 都能读回
+  res = cli.Post("/vector/put?key=f16", vector_headers(4, "fp16"),
+                 fp16_bytes(v), octet);
+  CHECK(res && res->status == 200, "fp16 put");
+  CHECK(kv->vectorGet("f16") == v, "fp16 decoded to fp32");
+  res = cli.Get("/vector/get?key=f16",
+                {{"Accept", octet}, {"X-Vector-Dtype", "fp16"}});
+  CHECK(res && res->status == 200, "fp16 get");
+  CHECK(res->get_header_value("X-Vector-Dtype") == "fp16", "fp16 dtype header");
+  CHECK(res->body == fp16_bytes(v), "fp16 round trip");
+  res = cli.Get("/vector/get?key=f16", {{"Accept", octet}});
+  CHECK(res && res->body == fp32_bytes(v), "fp16 put, fp32 get");
+  res = cli.Get("/vector/get?key=f16");
+  CHECK(res && json::parse(res->body)["embedding"] == json(v),
+        "JSON get of binary put");
+
+  // 二进制检索
+  kv->vectorPut("far", {9.0f, 9.0f, 9.0f, 9.0f});
+  res = cli.Post("/vector/search?top_k=1", vector_headers(4, "fp16"),
+                 fp16_bytes(v), octet);
+  CHECK(res && res->status == 200, "binary search");
+  json body = json::parse(res->body);
+  CHECK(body["query_dimension"] == 4 && body["results_count"] == 1,
+        "binary search counts");
+  CHECK(body["results"][0] != "far", "binary search finds the near vector");
+
+  // 长度与维度不符、dtype 非法、缺维度
+  res = cli.Post("/vector/put?key=bad", vector_headers(4),
+                 fp32_bytes(v).substr(0, 12), octet);
+  CHECK(res && res->status == 400, "fp32 length mismatch");
+  res = cli.Post("/vector/put?key=bad", vector_headers(4, "fp16"),
+                 fp32_bytes(v), octet);
+  CHECK(res && res->status == 400, "fp16 length mismatch");
+  res = cli.Post("/vector/put?key=bad", vector_headers(3, "fp16"),
+                 fp16_bytes(v).substr(0, 5), octet);
+  CHECK(res && res->status == 400, "odd fp16 length");
+  res = cli.Post("/vector/put?key=bad", vector_headers(4, "int8"),
+                 fp32_bytes(v), octet);
+  CHECK(res && res->status == 400, "bad dtype on put");
+  res = cli.Post("/vector/put?key=bad", httplib::Headers{}, fp32_bytes(v),
+                 octet);
+  CHECK(res && res->status == 400, "missing dimension header");
+  res = cli.Post("/vector/search?top_k=1", vector_headers(5), fp32_bytes(v),
+                 octet);
+  CHECK(res && res->status == 400, "search length mismatch");
+  CHECK(!kv->get("bad"), "rejected puts wrote nothing");
+  res = cli.Get("/vector/get?key=f32",
+                {{"Accept", octet}, {"X-Vector-Dtype", "bf16"}});
+  CHECK(res && res->status == 400, "bad dtype on get");
+  res = cli.Get("/vector/get?key=missing", {{"Accept", octet}});
+  CHECK(res && res->status == 404, "binary get of missing key");
+  server.stop();
+  PASS("vector_binary");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// /graph/rag_query 参数校验
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_graph_rag_options() {
+  auto gs = std::make_shared<graph::GraphStore>(
+      std::make_shared<GraphKVStore>(4096, 16));
+  // 悬挂种子：残差阈值非正时 push 会无限循环
+  gs->AddNode({"seed", "{}"});
+  gs->SetNodeEmbedding("seed", {1.0f, 0.0f});
+  gs->EnableKeywordIndex();
+  HttpServer server(StringKV::create(1024, 4), gs, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+
+  const json ranked = {{"query_embedding", {1.0, 0.0}}, {"ranked", true}};
+  json res = post_json(cli, "/graph/rag_query", ranked);
+  CHECK(res["node_count"] == 1, "ranked query with defaults");
+  for (double tolerance : {0.0, -1e-4}) {
+    json body = ranked;
+    body["residual_tolerance"] = tolerance;
+    res = post_json(cli, "/graph/rag_query", body, 400);
+    CHECK(res["success"] == false, "bad residual_tolerance rejected");
+  }
+
+  const json hybrid = {{"query_embedding", {1.0, 0.0}}, {"query_text", "seed"}};
+  res = post_json(cli, "/graph/rag_query", hybrid);
+  CHECK(res["success"] == true, "hybrid query with defaults");
+  for (const auto &[field, value] :
+       {std::pair<const char *, int>{"candidate_k", 0}, {"candidate_k", -3},
+        {"rrf_k", -1}}) {
+    json body = hybrid;
+    body[field] = value;
+    res = post_json(cli, "/graph/rag_query", body, 400);
+    CHECK(res["success"] == false, "bad " << field << " rejected");
+  }
+  server.stop();
+  PASS("graph_rag_options");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// /graph/shortest_path 边权校验
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_graph_shortest_path_weights() {
+  auto gs = std::make_shared<graph::GraphStore>(
+      std::make_shared<GraphKVStore>(4096, 16));
+  gs->AddEdge({"a", "b", "E", 1.0f, ""});
+  gs->AddEdge({"b", "neg", "E", -1.0f, ""});
+  gs->AddEdge({"c", "nan", "E", std::nanf(""), ""});
+  HttpServer server(StringKV::create(1024, 4), gs, "127.0.0.1", kPort);
+  CHECK(server.start_async(), "server start");
+  httplib::Client cli("127.0.0.1", kPort);
+
+  json res = post_json(cli, "/graph/shortest_path",
+                       {{"src_id", "a"}, {"dst_id", "b"}});
+  CHECK(res["reachable"] == true && res["cost"] == 1.0,
+        "search that stops before the bad edge succeeds");
+  for (const char *algorithm : {"dijkstra", "astar"}) {
+    for (const char *src : {"a", "c"}) {
+      res = post_json(cli, "/graph/shortest_path",
+                      {{"src_id", src}, {"dst_id", "z"},
+                       {"algorithm", algorithm}},
+                      422);
+      CHECK(res["success"] == false,
+            "bad weight rejected: " << algorithm << " from " << src);
+    }
+  }
+  server.stop();
+  PASS("graph_shortest_path_weights");
+  return true;
+}
+
+int main() {
+  std::cout << "=== HTTP API Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_kv_scan, "kv_scan");
+  run(test_kv_batch, "kv_batch");
+  run(test_vector_batch, "vector_batch");
+  run(test_graph_batch, "graph_batch");
+  run(test_vector_binary, "vector_binary");
+  run(test_graph_rag_options, "graph_rag_options");
+  run(test_graph_shortest_path_weights, "graph_shortest_path_weights");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
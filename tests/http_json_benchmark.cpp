@@ -0,0 +1,246 @@
+/**
+ * HTTP 响应编码压测：nlohmann::json（构造 DOM + dump）对比 JsonWriter
+ *
+ * 用 HttpServer 热点端点的响应结构各编码 N 次，输出每个响应消耗的
+ * 线程 CPU 时间（ns）和两者之比；不经过网络和存储，只衡量序列化本身。
+ *
+ *   http_json_benchmark [iterations]   默认 20000
+ *
+ * 负载：
+ *   kv_get         {"success","key","value"}，value 256 字节
+ *   vector_get     128 维 embedding
+ *   vector_search  top_k = 10 的 key 列表
+ *   kv_mget        100 个 key / value（64 字节）
+ *   rag_query      100 个节点，每个带 200 字节的 properties_json
+ */
+
+#include <time.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "server/json_writer.h"
+
+using minkv::server::JsonWriter;
+using json = nlohmann::json;
+
+namespace {
+
+struct Node {
+  std::string node_id;
+  std::string properties_json;
+};
+
+struct Payload {
+  std::string key = "session:user:42:context";
+  std::string value;
+  std::vector<float> embedding;
+  std::vector<std::string> search_keys;
+  std::vector<std::string> mget_keys;
+  std::vector<std::string> mget_values;
+  std::vector<Node> nodes;
+};
+
+Payload MakePayload() {
+  Payload p;
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  p.value.assign(256, 'v');
+  for (int i = 0; i < 128; ++i)
+    p.embedding.push_back(dist(rng));
+  for (int i = 0; i < 10; ++i)
+    p.search_keys.push_back("doc:" + std::to_string(100000 + i * 37));
+  for (int i = 0; i < 100; ++i) {
+    p.mget_keys.push_back("key:" + std::to_string(i));
+    p.mget_values.push_back(std::string(64, 'a' + i % 26));
+  }
+  for (int i = 0; i < 100; ++i) {
+    std::string props = R"({"name":"entity )" + std::to_string(i) +
+                        R"(","type":"concept","summary":")" +
+                        std::string(140, 's') + "\"}";
+    p.nodes.push_back({"node:" + std::to_string(i), props});
+  }
+  return p;
+}
+
+// ── nlohmann：与改造前 HttpServer 中的写法相同 ─────────────────────
+
+std::string NlohmannKvGet(const Payload &p) {
+  return json{{"success", true}, {"key", p.key}, {"value", p.value}}.dump();
+}
+
+std::string NlohmannVectorGet(const Payload &p) {
+  return json{{"success", true},
+              {"key", p.key},
+              {"embedding", p.embedding},
+              {"dimension", p.embedding.size()}}
+      .dump();
+}
+
+std::string NlohmannVectorSearch(const Payload &p) {
+  json results_json = json::array();
+  for (const auto &key : p.search_keys)
+    results_json.push_back(key);
+  return json{{"success", true},
+              {"query_dimension", 128},
+              {"top_k", 10},
+              {"results_count", p.search_keys.size()},
+              {"results", results_json}}
+      .dump();
+}
+
+std::string NlohmannMget(const Payload &p) {
+  json results = json::array();
+  for (size_t i = 0; i < p.mget_keys.size(); ++i) {
+    results.push_back({{"key", p.mget_keys[i]},
+                       {"found", true},
+                       {"value", p.mget_values[i]}});
+  }
+  return json{{"success", true},
+              {"count", p.mget_keys.size()},
+              {"results", std::move(results)}}
+      .dump();
+}
+
+std::string NlohmannRag(const Payload &p) {
+  json response = {{"success", true},
+                   {"node_count", p.nodes.size()},
+                   {"vector_top_k", 3},
+                   {"hop_depth", 2}};
+  json nodes_json = json::array();
+  for (const auto &n : p.nodes) {
+    nodes_json.push_back(
+        {{"node_id", n.node_id}, {"properties_json", n.properties_json}});
+  }
+  response["nodes"] = std::move(nodes_json);
+  return response.dump();
+}
+
+// ── JsonWriter：与 HttpServer 当前的写法相同 ──────────────────────
+
+std::string WriterKvGet(const Payload &p) {
+  std::string out;
+  out.reserve(p.key.size() + p.value.size() + 48);
+  JsonWriter(out)
+      .begin_object()
+      .field("success", true)
+      .field("key", p.key)
+      .field("value", p.value)
+      .end_object();
+  return out;
+}
+
+std::string WriterVectorGet(const Payload &p) {
+  std::string out;
+  out.reserve(p.key.size() + p.embedding.size() * 16 + 80);
+  JsonWriter(out)
+      .begin_object()
+      .field("success", true)
+      .field("key", p.key)
+      .field("embedding", p.embedding)
+      .field("dimension", p.embedding.size())
+      .end_object();
+  return out;
+}
+
+std::string WriterVectorSearch(const Payload &p) {
+  std::string out;
+  JsonWriter(out)
+      .begin_object()
+      .field("success", true)
+      .field("query_dimension", 128)
+      .field("top_k", 10)
+      .field("results_count", p.search_keys.size())
+      .field("results", p.search_keys)
+      .end_object();
+  return out;
+}
+
+std::string WriterMget(const Payload &p) {
+  std::string out;
+  JsonWriter w(out);
+  w.begin_object().field("success", true).field("count", p.mget_keys.size());
+  w.key("results").begin_array();
+  for (size_t i = 0; i < p.mget_keys.size(); ++i) {
+    w.begin_object()
+        .field("key", p.mget_keys[i])
+        .field("found", true)
+        .field("value", p.mget_values[i])
+        .end_object();
+  }
+  w.end_array().end_object();
+  return out;
+}
+
+std::string WriterRag(const Payload &p) {
+  std::string out;
+  JsonWriter w(out);
+  w.begin_object()
+      .field("success", true)
+      .field("node_count", p.nodes.size())
+      .field("vector_top_k", 3)
+      .field("hop_depth", 2);
+  w.key("nodes").begin_array();
+  for (const auto &n : p.nodes) {
+    w.begin_object()
+        .field("node_id", n.node_id)
+        .field("properties_json", n.properties_json)
+        .end_object();
+  }
+  w.end_array().end_object();
+  return out;
+}
+
+double ThreadCpuNs() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// 每个响应的平均 CPU 时间（ns）；bytes 防止编码结果被优化掉
+double Measure(std::string (*encode)(const Payload &), const Payload &p,
+               int iterations, size_t &bytes) {
+  for (int i = 0; i < iterations / 10; ++i) // 预热
+    bytes += encode(p).size();
+  double start = ThreadCpuNs();
+  for (int i = 0; i < iterations; ++i)
+    bytes += encode(p).size();
+  return (ThreadCpuNs() - start) / iterations;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int iterations = argc >= 2 ? std::max(1, std::atoi(argv[1])) : 20000;
+  Payload payload = MakePayload();
+
+  struct Case {
+    const char *name;
+    std::string (*nlohmann)(const Payload &);
+    std::string (*writer)(const Payload &);
+  };
+  const Case cases[] = {
+      {"kv_get", NlohmannKvGet, WriterKvGet},
+      {"vector_get", NlohmannVectorGet, WriterVectorGet},
+      {"vector_search", NlohmannVectorSearch, WriterVectorSearch},
+      {"kv_mget", NlohmannMget, WriterMget},
+      {"rag_query", NlohmannRag, WriterRag},
+  };
+
+  size_t bytes = 0;
+  std::printf("%-14s %10s %14s %14s %8s\n", "payload", "bytes",
+              "nlohmann ns", "writer ns", "speedup");
+  for (const auto &c : cases) {
+    double before = Measure(c.nlohmann, payload, iterations, bytes);
+    double after = Measure(c.writer, payload, iterations, bytes);
+    std::printf("%-14s %10zu %14.0f %14.0f %7.1fx\n", c.name,
+                c.writer(payload).size(), before, after, before / after);
+  }
+  return bytes == 0; // 总是 0；只为让编码结果有副作用
+}
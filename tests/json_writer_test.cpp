@@ -0,0 +1,265 @@
+/**
+ * JsonWriter 测试
+ *
+ *   - 结构：嵌套对象 / 数组的逗号、空容器、depth 为 0 时连续写多个值
+ *     （NDJSON 行）
+ *   - 数字：整数边界值、浮点数最短表示可往返、NaN / Inf 输出 null
+ *   - 字符串：引号、反斜杠、控制字符的转义与 nlohmann::json::dump() 相同；
+ *     合法 UTF-8 原样输出，非法字节替换为 U+FFFD
+ *   - 随机文档：与 nlohmann::json 构造同一文档，解析结果相同
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "server/json_writer.h"
+
+using minkv::server::JsonWriter;
+using json = nlohmann::json;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::string write_string(std::string_view s) {
+  std::string out;
+  JsonWriter(out).value(s);
+  return out;
+}
+
+static bool test_structure() {
+  std::string out;
+  JsonWriter w(out);
+  w.begin_object()
+      .field("a", 1)
+      .key("b")
+      .begin_array()
+      .value(true)
+      .null()
+      .begin_object()
+      .end_object()
+      .begin_array()
+      .end_array()
+      .end_array()
+      .key("c")
+      .begin_object()
+      .field("d", "x")
+      .end_object()
+      .end_object();
+  CHECK(out == R"({"a":1,"b":[true,null,{},[]],"c":{"d":"x"}})", out);
+  CHECK(w.depth() == 0, "depth after close");
+
+  // depth 为 0 时连续写值不加逗号，调用方自己加换行
+  std::string lines;
+  JsonWriter l(lines);
+  for (int i = 0; i < 3; ++i) {
+    l.begin_object().field("i", i).end_object();
+    lines += '\n';
+  }
+  CHECK(lines == "{\"i\":0}\n{\"i\":1}\n{\"i\":2}\n", lines);
+
+  std::vector<std::string> keys = {"k1", "k2"};
+  std::vector<float> emb = {0.5f, -1.25f};
+  out.clear();
+  JsonWriter(out)
+      .begin_object()
+      .field("keys", keys)
+      .field("emb", emb)
+      .end_object();
+  CHECK(out == R"({"keys":["k1","k2"],"emb":[0.5,-1.25]})", out);
+  PASS("structure");
+  return true;
+}
+
+static bool test_numbers() {
+  std::string out;
+  JsonWriter w(out);
+  w.begin_array()
+      .value(std::numeric_limits<int64_t>::min())
+      .value(std::numeric_limits<uint64_t>::max())
+      .value(size_t(0))
+      .value(-7)
+      .end_array();
+  CHECK(out == "[-9223372036854775808,18446744073709551615,0,-7]", out);
+
+  out.clear();
+  JsonWriter(out)
+      .begin_array()
+      .value(std::nan(""))
+      .value(std::numeric_limits<double>::infinity())
+      .value(-std::numeric_limits<float>::infinity())
+      .end_array();
+  CHECK(out == "[null,null,null]", out);
+
+  // 最短表示：解析回来与原值逐位相同
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> dist(-1e6, 1e6);
+  for (int i = 0; i < 10000; ++i) {
+    double d = dist(rng) * std::pow(10.0, int(rng() % 40) - 20);
+    float f = static_cast<float>(d);
+    out.clear();
+    JsonWriter(out).begin_array().value(d).value(f).end_array();
+    json parsed = json::parse(out);
+    CHECK(parsed[0].get<double>() == d, "double round trip: " << out);
+    CHECK(parsed[1].get<float>() == f, "float round trip: " << out);
+  }
+  PASS("numbers");
+  return true;
+}
+
+static bool test_strings() {
+  std::string control;
+  for (int c = 0; c < 0x20; ++c)
+    control += static_cast<char>(c);
+  control += "\"\\/\x7f";
+  CHECK(write_string(control) == json(control).dump(), "control escape");
+
+  std::string utf8 = "键 ü € 😀";
+  CHECK(write_string(utf8) == json(utf8).dump(), "valid utf-8 unchanged");
+
+  // 非法字节：孤立的续字节、截断的序列、过长编码、代理区、超出范围
+  const std::string replacement = "\xEF\xBF\xBD";
+  CHECK(write_string("a\x80z") == "\"a" + replacement + "z\"", "lone cont");
+  CHECK(write_string("\xE4\xBD") == "\"" + replacement + replacement + "\"",
+        "truncated sequence");
+  CHECK(write_string("\xC0\xAF") == "\"" + replacement + replacement + "\"",
+        "overlong");
+  CHECK(write_string("\xED\xA0\x80") ==
+            "\"" + replacement + replacement + replacement + "\"",
+        "surrogate");
+  CHECK(write_string("\xF4\x90\x80\x80").size() == 2 + 4 * replacement.size(),
+        "above U+10FFFF");
+  CHECK(json::parse(write_string("x\xFFy\xE4\xBD\xA0")).get<std::string>() ==
+            "x" + replacement + "y你",
+        "output is valid JSON");
+
+  // 键使用同一套转义
+  std::string out;
+  JsonWriter(out).begin_object().field("a\"b", "c").end_object();
+  CHECK(out == R"({"a\"b":"c"})", out);
+  PASS("strings");
+  return true;
+}
+
+// 用同一串随机选择分别构造 nlohmann 文档和 JsonWriter 输出
+static void random_value(std::mt19937 &rng, int depth, json &doc,
+                         JsonWriter &w) {
+  static const std::vector<std::string> words = {
+      "", "key", "a\"b", "tab\there", "换行\n", "\x01", "node:42", "😀"};
+  int kind = rng() % (depth < 4 ? 7 : 5);
+  switch (kind) {
+  case 0:
+    doc = rng() % 2 == 0;
+    w.value(doc.get<bool>());
+    break;
+  case 1: {
+    int64_t v = static_cast<int64_t>(rng()) - (1LL << 31);
+    doc = v;
+    w.value(v);
+    break;
+  }
+  case 2: {
+    double v = std::uniform_real_distribution<double>(-1e3, 1e3)(rng);
+    doc = v;
+    w.value(v);
+    break;
+  }
+  case 3:
+    doc = words[rng() % words.size()];
+    w.value(doc.get<std::string>());
+    break;
+  case 4:
+    doc = nullptr;
+    w.null();
+    break;
+  case 5: {
+    doc = json::array();
+    w.begin_array();
+    int n = rng() % 5;
+    for (int i = 0; i < n; ++i) {
+      json item;
+      random_value(rng, depth + 1, item, w);
+      doc.push_back(std::move(item));
+    }
+    w.end_array();
+    break;
+  }
+  default: {
+    doc = json::object();
+    w.begin_object();
+    int n = rng() % 5;
+    for (int i = 0; i < n; ++i) {
+      std::string k = "f" + std::to_string(i) + words[rng() % words.size()];
+      w.key(k);
+      random_value(rng, depth + 1, doc[k], w);
+    }
+    w.end_object();
+  }
+  }
+}
+
+static bool test_random_documents() {
+  std::mt19937 rng(7);
+  for (int i = 0; i < 2000; ++i) {
+    std::string out;
+    JsonWriter w(out);
+    json doc;
+    random_value(rng, 0, doc, w);
+    CHECK(w.depth() == 0, "unbalanced output");
+    json parsed;
+    try {
+      parsed = json::parse(out);
+    } catch (const json::exception &e) {
+      CHECK(false, "invalid JSON: " << out << " (" << e.what() << ")");
+    }
+    CHECK(parsed == doc, "mismatch: " << out << " vs " << doc.dump());
+  }
+  PASS("random_documents");
+  return true;
+}
+
+int main() {
+  std::cout << "=== JsonWriter Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_structure, "structure");
+  run(test_numbers, "numbers");
+  run(test_strings, "strings");
+  run(test_random_documents, "random_documents");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
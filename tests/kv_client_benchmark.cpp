@@ -0,0 +1,167 @@
+/**
+ * KvClient 压测：对比直接用 httplib 调 HTTP 接口
+ *
+ * 进程内启动 HttpServer 和 RespServer（共用一个 KV 实例），T 个线程
+ * 各发 N 次随机 key 的 GET（value 128 字节），输出吞吐和平均延迟：
+ *
+ *   httplib      每个线程一个 keep-alive 的 httplib::Client，GET /kv/get
+ *   client/sync  所有线程共用一个 KvClient（2 条连接），同步 Get；
+ *                并发请求由 I/O 线程自动 pipeline、合并为 MGET
+ *   client/async 每个线程一次发起 16 个 GetAsync 再逐个等待
+ *   client/near  client/sync 加近端缓存（热点 key 集，TTL 100ms）
+ *
+ *   kv_client_benchmark [threads] [requests_per_thread]   默认 8、20000
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "client/kv_client.h"
+#include "server/http_server.h"
+#include "server/httplib.h"
+#include "server/resp_server.h"
+
+using namespace minkv;
+using namespace minkv::server;
+using minkv::client::KvClient;
+using minkv::client::KvClientOptions;
+using minkv::client::KvClientStats;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kKeys = 10000;
+constexpr int kHotKeys = 1000;
+constexpr int kWindow = 16;
+
+std::string Key(int i) { return "bench:" + std::to_string(i); }
+
+// threads 个线程各执行一次 body(thread_index)，body 返回出错次数
+void Run(const char *name, int threads, int requests,
+         const std::function<int(int)> &body) {
+  std::atomic<int> errors{0};
+  std::vector<std::thread> workers;
+  auto start = Clock::now();
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&, t] { errors += body(t); });
+  for (auto &w : workers)
+    w.join();
+  double secs = std::chrono::duration<double>(Clock::now() - start).count();
+  double total = static_cast<double>(threads) * requests;
+  std::printf("%-13s %9.0f ops/s   avg %7.2f us/op%s\n", name, total / secs,
+              secs * 1e6 * threads / total,
+              errors ? "   (ERRORS)" : "");
+}
+
+void PrintStats(const KvClientStats &s) {
+  std::printf("              round_trips %llu, commands %llu, merged_gets "
+              "%llu, near_hits %llu\n",
+              static_cast<unsigned long long>(s.round_trips),
+              static_cast<unsigned long long>(s.commands),
+              static_cast<unsigned long long>(s.merged_gets),
+              static_cast<unsigned long long>(s.near_hits));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int threads = argc >= 2 ? std::atoi(argv[1]) : 8;
+  int requests = argc >= 3 ? std::atoi(argv[2]) : 20000;
+  if (threads <= 0 || requests <= 0) {
+    std::fprintf(stderr, "usage: %s [threads] [requests_per_thread]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  std::shared_ptr<StringKV> kv = StringKV::create(65536, 16);
+  for (int i = 0; i < kKeys; ++i)
+    kv->put(Key(i), std::string(128, static_cast<char>('a' + i % 26)));
+
+  constexpr int kHttpPort = 18094;
+  HttpServer http(kv, nullptr, "127.0.0.1", kHttpPort);
+  if (!http.start_async()) {
+    std::fprintf(stderr, "failed to start HTTP server\n");
+    return 1;
+  }
+  RespServerOptions resp_options;
+  resp_options.host = "127.0.0.1";
+  resp_options.port = 0;
+  resp_options.reactors = 2;
+  RespServer resp(kv, resp_options);
+  resp.Start();
+
+  std::printf("\n%d threads x %d GETs, %d keys, 128-byte values\n\n", threads,
+              requests, kKeys);
+
+  Run("httplib", threads, requests, [&](int t) {
+    httplib::Client cli("127.0.0.1", kHttpPort);
+    cli.set_keep_alive(true);
+    std::mt19937 rng(t);
+    int errors = 0;
+    for (int i = 0; i < requests; ++i) {
+      auto res = cli.Get("/kv/get?key=" + Key(rng() % kKeys));
+      errors += !res || res->status != 200;
+    }
+    return errors;
+  });
+
+  KvClientOptions options;
+  options.port = resp.port();
+  {
+    KvClient client(options);
+    Run("client/sync", threads, requests, [&](int t) {
+      std::mt19937 rng(t);
+      int errors = 0;
+      for (int i = 0; i < requests; ++i)
+        errors += !client.Get(Key(rng() % kKeys));
+      return errors;
+    });
+    PrintStats(client.Stats());
+  }
+  {
+    KvClient client(options);
+    Run("client/async", threads, requests, [&](int t) {
+      std::mt19937 rng(t);
+      int errors = 0;
+      std::vector<std::future<std::optional<std::string>>> window;
+      for (int i = 0; i < requests; i += kWindow) {
+        window.clear();
+        for (int j = i; j < std::min(i + kWindow, requests); ++j)
+          window.push_back(client.GetAsync(Key(rng() % kKeys)));
+        for (auto &f : window)
+          errors += !f.get();
+      }
+      return errors;
+    });
+    PrintStats(client.Stats());
+  }
+  {
+    KvClientOptions near = options;
+    near.near_cache_capacity = kHotKeys;
+    near.near_cache_ttl_ms = 100;
+    KvClient client(near);
+    Run("client/near", threads, requests, [&](int t) {
+      std::mt19937 rng(t);
+      int errors = 0;
+      for (int i = 0; i < requests; ++i)
+        errors += !client.Get(Key(rng() % kHotKeys));
+      return errors;
+    });
+    PrintStats(client.Stats());
+  }
+
+  resp.Stop();
+  http.stop();
+  return 0;
+}
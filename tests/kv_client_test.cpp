@@ -0,0 +1,373 @@
+/**
+ * KvClient 测试
+ *
+ * 单元测试：
+ *   - 回复解析：各类型、嵌套数组、半包返回 0、格式错误抛异常
+ * 端到端测试（进程内 RespServer，端口 0）：
+ *   - 同步接口 SET / GET / DEL / PX 过期 / MGet / Execute，错误回复
+ *   - Unix domain socket 连接
+ *   - 多线程并发请求自动 pipeline：结果正确，往返次数少于请求数
+ *   - 同一轮的 GET 合并为 MGET；中间隔着写命令时顺序语义不变
+ *   - 近端缓存：命中、本客户端写入立即失效、外部写入在 TTL 后可见
+ *   - 服务器停止后请求以异常失败，服务器恢复后自动重连
+ */
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "client/kv_client.h"
+#include "server/resp_server.h"
+
+using namespace minkv;
+using namespace minkv::client;
+using minkv::server::RespServer;
+using minkv::server::RespServerOptions;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<StringKV> make_kv() {
+  return std::shared_ptr<StringKV>(StringKV::create(4096, 16));
+}
+
+static RespServerOptions server_options() {
+  RespServerOptions options;
+  options.host = "127.0.0.1";
+  options.port = 0;
+  options.reactors = 2;
+  return options;
+}
+
+static KvClientOptions client_options(const RespServer &server) {
+  KvClientOptions options;
+  options.port = server.port();
+  return options;
+}
+
+using Value = std::optional<std::string>;
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 单元测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_parse_reply() {
+  RespReply r;
+  CHECK(ParseReply("+OK\r\n", r) == 5 && r.type == RespReply::Type::Status &&
+            r.str == "OK",
+        "status");
+  CHECK(ParseReply("-ERR bad\r\n", r) == 10 && r.is_error() &&
+            r.str == "ERR bad",
+        "error");
+  CHECK(ParseReply(":-42\r\n", r) == 6 && r.integer == -42, "integer");
+  CHECK(ParseReply("$3\r\na\r\n\r\n", r) == 9 && r.str == "a\r\n",
+        "bulk with CRLF inside");
+  CHECK(ParseReply("$-1\r\n", r) == 5 && r.is_nil(), "nil");
+
+  std::string nested = "*3\r\n$1\r\na\r\n$-1\r\n*2\r\n:1\r\n+x\r\n";
+  CHECK(ParseReply(nested, r) == nested.size(), "nested size");
+  CHECK(r.type == RespReply::Type::Array && r.elements.size() == 3, "array");
+  CHECK(r.elements[0].str == "a" && r.elements[1].is_nil(), "elements");
+  CHECK(r.elements[2].elements.size() == 2 &&
+            r.elements[2].elements[1].str == "x",
+        "inner array");
+
+  // 任意位置截断都是半包
+  for (size_t cut = 0; cut < nested.size(); ++cut)
+    CHECK(ParseReply(nested.substr(0, cut), r) == 0, "incomplete at " << cut);
+  // 两条回复连在一起只取第一条
+  CHECK(ParseReply("+A\r\n+B\r\n", r) == 4 && r.str == "A", "first only");
+
+  for (const char *bad : {"?x\r\n", ":12a\r\n", "$2\r\nabcd\r\n"}) {
+    bool threw = false;
+    try {
+      ParseReply(bad, r);
+    } catch (const std::runtime_error &) {
+      threw = true;
+    }
+    CHECK(threw, "malformed " << bad);
+  }
+  PASS("parse_reply");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 端到端测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_sync_commands() {
+  RespServer server(make_kv(), server_options());
+  server.Start();
+  KvClient kv(client_options(server));
+
+  kv.Set("user:1", "alice");
+  CHECK(kv.Get("user:1") == Value("alice"), "get");
+  CHECK(!kv.Get("missing"), "get missing");
+  CHECK(kv.Del("user:1") && !kv.Del("user:1"), "del");
+
+  kv.Set("tmp", "v", 50);
+  CHECK(kv.Get("tmp"), "ttl not yet expired");
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  CHECK(!kv.Get("tmp"), "ttl expired");
+
+  std::string big(512 * 1024, 'x');
+  kv.Set("big", big);
+  CHECK(kv.Get("big") == big, "big value");
+
+  kv.Set("a", "1");
+  kv.Set("b", "2");
+  std::vector<Value> values = kv.MGet({"a", "missing", "b"});
+  CHECK(values.size() == 3 && values[0] == Value("1") && !values[1] &&
+            values[2] == Value("2"),
+        "mget");
+
+  RespReply r = kv.Execute({"INCRBY", "n", "5"});
+  CHECK(r.type == RespReply::Type::Integer && r.integer == 5, "execute");
+  r = kv.Execute({"NOSUCH"});
+  CHECK(r.is_error(), "error reply");
+
+  kv.Set("s", "abc");
+  CHECK(kv.Execute({"INCR", "s"}).is_error(), "incr error reply");
+  CHECK(kv.Get("s") == Value("abc"), "usable after error reply");
+
+  server.Stop();
+  PASS("sync_commands");
+  return true;
+}
+
+static bool test_unix_socket() {
+  RespServerOptions options = server_options();
+  options.unix_path =
+      "/tmp/minkv_kv_client_test_" + std::to_string(::getpid()) + ".sock";
+  RespServer server(make_kv(), options);
+  server.Start();
+
+  KvClientOptions copts;
+  copts.unix_path = options.unix_path;
+  copts.port = 1; // 走 unix_path 时忽略
+  KvClient kv(copts);
+  kv.Set("k", "via-unix");
+  CHECK(kv.Get("k") == Value("via-unix"), "get over unix socket");
+  server.Stop();
+  PASS("unix_socket");
+  return true;
+}
+
+static bool test_concurrent_pipeline() {
+  RespServer server(make_kv(), server_options());
+  server.Start();
+  KvClient kv(client_options(server));
+
+  constexpr int kThreads = 8, kIncrs = 500;
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      std::string own = "own:" + std::to_string(t);
+      for (int i = 0; i < kIncrs; ++i) {
+        if (kv.Execute({"INCR", "counter"}).integer <= 0)
+          ++failures;
+        kv.Set(own, std::to_string(i));
+        if (kv.Get(own) != Value(std::to_string(i)))
+          ++failures; // 同一 key 上先写后读
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  CHECK(failures == 0, "failures " << failures.load());
+  CHECK(kv.Get("counter") == Value(std::to_string(kThreads * kIncrs)),
+        "counter total");
+
+  KvClientStats s = kv.Stats();
+  CHECK(s.requests == kThreads * kIncrs * 3 + 1, "requests " << s.requests);
+  CHECK(s.round_trips < s.requests, "pipelined: " << s.round_trips << " < "
+                                                  << s.requests);
+  CHECK(s.failures == 0, "stats failures");
+  server.Stop();
+  PASS("concurrent_pipeline");
+  return true;
+}
+
+static bool test_get_batching() {
+  RespServer server(make_kv(), server_options());
+  server.Start();
+  KvClientOptions options = client_options(server);
+  options.connections = 1;
+  KvClient kv(options);
+
+  for (int i = 0; i < 100; ++i)
+    kv.Set("k" + std::to_string(i), "v" + std::to_string(i));
+
+  // 连接正忙着上一个请求时积攒的 GET 合并成 MGET
+  std::vector<std::future<Value>> futures;
+  for (int round = 0; round < 20; ++round)
+    for (int i = 0; i < 100; ++i)
+      futures.push_back(kv.GetAsync("k" + std::to_string(i)));
+  futures.push_back(kv.GetAsync("missing"));
+  for (size_t i = 0; i + 1 < futures.size(); ++i)
+    CHECK(futures[i].get() == Value("v" + std::to_string(i % 100)),
+          "batched value " << i);
+  CHECK(!futures.back().get(), "batched missing");
+  KvClientStats s = kv.Stats();
+  CHECK(s.merged_gets > 0, "gets merged into MGET");
+  CHECK(s.commands < s.requests, "fewer commands than requests");
+
+  // 写命令夹在 GET 之间：前面的 GET 读旧值，后面的读新值
+  auto before = kv.GetAsync("k0");
+  auto set = kv.SetAsync("k0", "new");
+  auto after = kv.GetAsync("k0");
+  auto del = kv.DelAsync("k1");
+  auto gone = kv.GetAsync("k1");
+  CHECK(before.get() == Value("v0"), "read before write");
+  set.get();
+  CHECK(after.get() == Value("new"), "read after write");
+  CHECK(del.get() && !gone.get(), "read after delete");
+
+  // 关闭合并时结果相同，只是不发 MGET
+  options.batch_gets = false;
+  KvClient plain(options);
+  std::vector<std::future<Value>> plain_futures;
+  for (int i = 2; i < 50; ++i)
+    plain_futures.push_back(plain.GetAsync("k" + std::to_string(i)));
+  for (int i = 2; i < 50; ++i)
+    CHECK(plain_futures[i - 2].get() == Value("v" + std::to_string(i)),
+          "unbatched value " << i);
+  CHECK(plain.Stats().merged_gets == 0, "no merging when disabled");
+  server.Stop();
+  PASS("get_batching");
+  return true;
+}
+
+static bool test_near_cache() {
+  RespServer server(make_kv(), server_options());
+  server.Start();
+  KvClientOptions options = client_options(server);
+  options.near_cache_capacity = 128;
+  options.near_cache_ttl_ms = 100;
+  KvClient kv(options);
+  KvClient other(client_options(server)); // 另一个客户端，不带近端缓存
+
+  kv.Set("k", "v1");
+  CHECK(kv.Get("k") == Value("v1"), "first get");
+  CHECK(kv.Get("k") == Value("v1"), "second get");
+  CHECK(kv.Stats().near_hits == 1, "cache hit");
+
+  // 本客户端的写立即失效
+  kv.Set("k", "v2");
+  CHECK(kv.Get("k") == Value("v2"), "read own write");
+  kv.Execute({"APPEND", "k", "x"}); // 未知命令也按写处理
+  kv.Del("k");
+  CHECK(!kv.Get("k"), "read own delete");
+
+  // 其他客户端的写：TTL 内可能读到旧值，TTL 之后一定读到新值
+  kv.Set("shared", "old");
+  CHECK(kv.Get("shared") == Value("old"), "fill");
+  CHECK(kv.Get("shared") == Value("old"), "cached");
+  other.Set("shared", "new");
+  std::this_thread::sleep_for(std::chrono::milliseconds(150));
+  CHECK(kv.Get("shared") == Value("new"), "visible after ttl");
+
+  // 外部失效通知
+  CHECK(kv.Get("shared") == Value("new"), "refill");
+  other.Set("shared", "newer");
+  kv.Invalidate("shared");
+  CHECK(kv.Get("shared") == Value("newer"), "explicit invalidate");
+
+  // 在途的 GET 不会把旧值回填到失效之后
+  kv.Set("race", "a");
+  for (int i = 0; i < 200; ++i) {
+    auto stale = kv.GetAsync("race");
+    auto set = kv.SetAsync("race", std::to_string(i));
+    stale.get();
+    set.get();
+    CHECK(kv.Get("race") == Value(std::to_string(i)), "no stale fill " << i);
+  }
+  server.Stop();
+  PASS("near_cache");
+  return true;
+}
+
+static bool test_reconnect() {
+  RespServerOptions options = server_options();
+  auto server = std::make_unique<RespServer>(make_kv(), options);
+  server->Start();
+  uint16_t port = server->port();
+  KvClientOptions copts = client_options(*server);
+  copts.connections = 1;
+  copts.timeout_ms = 1000;
+  KvClient kv(copts);
+  kv.Set("k", "v");
+
+  server->Stop();
+  server.reset();
+  bool threw = false;
+  try {
+    kv.Get("k");
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  CHECK(threw, "request fails while server is down");
+
+  // 同一端口重新启动：下一轮请求自动重连
+  options.port = port;
+  RespServer restarted(make_kv(), options);
+  restarted.Start();
+  kv.Set("k", "again");
+  CHECK(kv.Get("k") == Value("again"), "works after reconnect");
+  CHECK(kv.Stats().reconnects >= 1, "reconnect counted");
+  CHECK(kv.Stats().failures >= 1, "failure counted");
+  restarted.Stop();
+  PASS("reconnect");
+  return true;
+}
+
+int main() {
+  std::cout << "=== KvClient Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_parse_reply, "parse_reply");
+  run(test_sync_commands, "sync_commands");
+  run(test_unix_socket, "unix_socket");
+  run(test_concurrent_pipeline, "concurrent_pipeline");
+  run(test_get_batching, "get_batching");
+  run(test_near_cache, "near_cache");
+  run(test_reconnect, "reconnect");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
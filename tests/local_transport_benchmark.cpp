@@ -0,0 +1,190 @@
+/**
+ * 同机传输延迟压测：TCP 回环 / Unix domain socket / 共享内存
+ *
+ * 进程内启动 RESP 服务器（TCP + UDS）、共享内存服务器和 HTTP 服务器
+ * （TCP + UDS），共用一个 KV 实例；单个客户端顺序发 GET（一次一条，
+ * 不 pipeline），统计每条请求的往返延迟。
+ *
+ *   local_transport_benchmark [requests] [value_bytes]   默认 20000、256
+ *
+ * 输出每种传输的 avg / p50 / p99（微秒）。服务端和客户端在同一台机器
+ * 上抢 CPU，绝对值依赖机器，关注几种传输之间的相对差距。
+ */
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "client/shm_client.h"
+#include "server/http_server.h"
+#include "server/httplib.h"
+#include "server/resp_server.h"
+#include "server/shm_server.h"
+#include "server/unix_socket.h"
+
+using namespace minkv;
+using namespace minkv::server;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 顺序执行 requests 次 fn，打印延迟分布；fn 返回 false 表示结果不对
+void Measure(const char *name, int requests, const std::function<bool()> &fn) {
+  for (int i = 0; i < requests / 10; ++i) // 预热
+    fn();
+  std::vector<double> us;
+  us.reserve(requests);
+  int bad = 0;
+  for (int i = 0; i < requests; ++i) {
+    auto start = Clock::now();
+    bad += !fn();
+    us.push_back(
+        std::chrono::duration<double, std::micro>(Clock::now() - start)
+            .count());
+  }
+  std::sort(us.begin(), us.end());
+  double sum = 0;
+  for (double v : us)
+    sum += v;
+  std::printf("%-12s avg %7.2f us   p50 %7.2f us   p99 %7.2f us%s\n", name,
+              sum / us.size(), us[us.size() / 2], us[us.size() * 99 / 100],
+              bad ? "   (BAD REPLIES)" : "");
+}
+
+bool SendAll(int fd, const std::string &data) {
+  size_t off = 0;
+  while (off < data.size()) {
+    ssize_t n = ::write(fd, data.data() + off, data.size() - off);
+    if (n <= 0)
+      return false;
+    off += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// 发一条编码好的命令，读满 expected 字节的回复
+bool RoundTrip(int fd, const std::string &request, const std::string &expected,
+               std::string &buf) {
+  if (!SendAll(fd, request))
+    return false;
+  buf.resize(expected.size());
+  size_t got = 0;
+  while (got < expected.size()) {
+    ssize_t n = ::read(fd, &buf[got], expected.size() - got);
+    if (n <= 0)
+      return false;
+    got += static_cast<size_t>(n);
+  }
+  return buf == expected;
+}
+
+int ConnectTcp(uint16_t port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    std::perror("connect");
+    std::exit(1);
+  }
+  return fd;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int requests = argc >= 2 ? std::atoi(argv[1]) : 20000;
+  size_t value_bytes = argc >= 3 ? std::strtoul(argv[2], nullptr, 10) : 256;
+  if (requests <= 0) {
+    std::fprintf(stderr, "usage: %s [requests] [value_bytes]\n", argv[0]);
+    return 1;
+  }
+
+  std::string suffix = std::to_string(::getpid());
+  std::string resp_unix = "/tmp/minkv_bench_resp_" + suffix + ".sock";
+  std::string shm_path = "/tmp/minkv_bench_shm_" + suffix + ".sock";
+  std::string http_unix = "/tmp/minkv_bench_http_" + suffix + ".sock";
+  constexpr int kHttpPort = 18093;
+
+  std::shared_ptr<StringKV> kv = StringKV::create(4096, 16);
+  std::string value(value_bytes, 'v');
+  kv->put("bench:key", value);
+
+  RespServerOptions resp_options;
+  resp_options.host = "127.0.0.1";
+  resp_options.port = 0;
+  resp_options.reactors = 1;
+  resp_options.unix_path = resp_unix;
+  RespServer resp(kv, resp_options);
+  resp.Start();
+
+  ShmServerOptions shm_options;
+  shm_options.path = shm_path;
+  ShmServer shm(kv, shm_options);
+  shm.Start();
+
+  HttpServer http_tcp(kv, nullptr, "127.0.0.1", kHttpPort);
+  HttpServer http_uds(kv, nullptr, "unix:" + http_unix);
+  if (!http_tcp.start_async() || !http_uds.start_async()) {
+    std::fprintf(stderr, "failed to start HTTP servers\n");
+    return 1;
+  }
+
+  std::printf("sequential GET, %d requests, %zu-byte value\n\n", requests,
+              value_bytes);
+
+  std::string request = "*2\r\n$3\r\nGET\r\n$9\r\nbench:key\r\n";
+  std::string expected =
+      "$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+  std::string buf;
+
+  int tcp = ConnectTcp(resp.port());
+  Measure("resp/tcp", requests,
+          [&] { return RoundTrip(tcp, request, expected, buf); });
+  ::close(tcp);
+
+  int uds = ConnectUnix(resp_unix);
+  Measure("resp/unix", requests,
+          [&] { return RoundTrip(uds, request, expected, buf); });
+  ::close(uds);
+
+  {
+    client::ShmClient client(shm_path);
+    std::string_view view;
+    Measure("shm", requests, [&] {
+      return client.GetView("bench:key", view) && view == value;
+    });
+  }
+
+  httplib::Client http_tcp_client("127.0.0.1", kHttpPort);
+  http_tcp_client.set_keep_alive(true);
+  Measure("http/tcp", requests, [&] {
+    auto res = http_tcp_client.Get("/kv/get?key=bench:key");
+    return res && res->status == 200;
+  });
+
+  httplib::Client http_uds_client(http_unix);
+  http_uds_client.set_address_family(AF_UNIX);
+  http_uds_client.set_keep_alive(true);
+  Measure("http/unix", requests, [&] {
+    auto res = http_uds_client.Get("/kv/get?key=bench:key");
+    return res && res->status == 200;
+  });
+
+  http_uds.stop();
+  http_tcp.stop();
+  shm.Stop();
+  resp.Stop();
+  return 0;
+}
@@ -0,0 +1,372 @@
+/**
+ * RESP 压测工具（redis-benchmark 风格）
+ *
+ * 对任意讲 RESP2 的服务（minkv_resp_server 或 Redis）发压，参数和输出
+ * 格式与 redis-benchmark 保持一致，便于直接对比两者的数据：
+ *
+ *   resp_benchmark [-h host] [-p port] [-c clients] [-n requests]
+ *                  [-P pipeline] [-d value_bytes] [-r keyspace]
+ *                  [-v vector_dim] [-t ping,set,get,incr,mset,vset,vsearch]
+ *
+ * 每个客户端一个线程、一个阻塞连接，每轮发送 P 条命令后读满 P 个回复，
+ * 记录这一轮的耗时作为其中每条命令的延迟。
+ * vset / vsearch 是 MinKV 的向量命令，对 Redis 无效。
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+  std::string host = "127.0.0.1";
+  int port = 6379;
+  int clients = 50;
+  int requests = 100000;
+  int pipeline = 1;
+  int data_size = 3;
+  int keyspace = 0; // 0：所有请求使用同一个 key（与 redis-benchmark 相同）
+  int vector_dim = 128;
+  std::vector<std::string> tests = {"ping", "set",  "get",    "incr",
+                                    "mset", "vset", "vsearch"};
+};
+
+std::string Encode(const std::vector<std::string> &args) {
+  std::string out = "*" + std::to_string(args.size()) + "\r\n";
+  for (const auto &a : args)
+    out += "$" + std::to_string(a.size()) + "\r\n" + a + "\r\n";
+  return out;
+}
+
+/**
+ * 阻塞连接上的回复读取器：只跳过回复，不解析内容
+ */
+class ReplyReader {
+public:
+  explicit ReplyReader(int fd) : fd_(fd) {}
+
+  /** 读完一个完整回复；连接断开返回 false */
+  bool Skip() {
+    std::string line;
+    if (!ReadLine(line) || line.empty())
+      return false;
+    switch (line[0]) {
+    case '+':
+    case '-':
+    case ':':
+      return true;
+    case '$': {
+      long len = std::atol(line.c_str() + 1);
+      return len < 0 || Consume(static_cast<size_t>(len) + 2);
+    }
+    case '*': {
+      long n = std::atol(line.c_str() + 1);
+      for (long i = 0; i < n; ++i)
+        if (!Skip())
+          return false;
+      return true;
+    }
+    default:
+      return false;
+    }
+  }
+
+private:
+  bool Fill() {
+    if (pos_ == buf_.size()) {
+      buf_.clear();
+      pos_ = 0;
+    }
+    char tmp[16384];
+    ssize_t n = ::read(fd_, tmp, sizeof(tmp));
+    if (n <= 0)
+      return false;
+    buf_.append(tmp, static_cast<size_t>(n));
+    return true;
+  }
+
+  bool ReadLine(std::string &line) {
+    while (true) {
+      size_t eol = buf_.find("\r\n", pos_);
+      if (eol != std::string::npos) {
+        line.assign(buf_, pos_, eol - pos_);
+        pos_ = eol + 2;
+        return true;
+      }
+      if (!Fill())
+        return false;
+    }
+  }
+
+  bool Consume(size_t n) {
+    while (buf_.size() - pos_ < n)
+      if (!Fill())
+        return false;
+    pos_ += n;
+    return true;
+  }
+
+  int fd_;
+  std::string buf_;
+  size_t pos_ = 0;
+};
+
+int Connect(const Options &opt) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(opt.port));
+  if (::inet_pton(AF_INET, opt.host.c_str(), &addr.sin_addr) != 1 ||
+      ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  int one = 1;
+  ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return fd;
+}
+
+bool SendAll(int fd, const std::string &data) {
+  size_t off = 0;
+  while (off < data.size()) {
+    ssize_t n = ::write(fd, data.data() + off, data.size() - off);
+    if (n <= 0)
+      return false;
+    off += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+/** 生成第 seq 条请求的命令 */
+class CommandFactory {
+public:
+  CommandFactory(const Options &opt, const std::string &test, uint32_t seed)
+      : opt_(opt), test_(test), rng_(seed), value_(opt.data_size, 'x') {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    vector_.reserve(opt.vector_dim);
+    for (int i = 0; i < opt.vector_dim; ++i) {
+      char buf[32];
+      std::snprintf(buf, sizeof(buf), "%.6f", dist(rng_));
+      vector_.push_back(buf);
+    }
+  }
+
+  std::string Next() {
+    if (test_ == "ping")
+      return Encode({"PING"});
+    if (test_ == "set")
+      return Encode({"SET", Key("key:"), value_});
+    if (test_ == "get")
+      return Encode({"GET", Key("key:")});
+    if (test_ == "incr")
+      return Encode({"INCR", Key("counter:")});
+    if (test_ == "mset") {
+      // 与 redis-benchmark 相同：一条 MSET 写 10 个 key
+      std::vector<std::string> args = {"MSET"};
+      for (int i = 0; i < 10; ++i) {
+        args.push_back(Key("key:"));
+        args.push_back(value_);
+      }
+      return Encode(args);
+    }
+    std::vector<std::string> args;
+    if (test_ == "vset") {
+      args = {"VSET", Key("vec:")};
+    } else {
+      args = {"VSEARCH", "10"};
+    }
+    args.insert(args.end(), vector_.begin(), vector_.end());
+    return Encode(args);
+  }
+
+private:
+  std::string Key(const char *prefix) {
+    if (opt_.keyspace <= 0)
+      return std::string(prefix) + "__rand_int__";
+    std::uniform_int_distribution<int> dist(0, opt_.keyspace - 1);
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%012d", dist(rng_));
+    return prefix + std::string(buf);
+  }
+
+  const Options &opt_;
+  std::string test_;
+  std::mt19937 rng_;
+  std::string value_;
+  std::vector<std::string> vector_;
+};
+
+struct ClientResult {
+  std::vector<double> latencies_ms;
+  bool ok = true;
+};
+
+void RunClient(const Options &opt, const std::string &test, int requests,
+               uint32_t seed, ClientResult &result) {
+  int fd = Connect(opt);
+  if (fd < 0) {
+    result.ok = false;
+    return;
+  }
+  CommandFactory factory(opt, test, seed);
+  ReplyReader reader(fd);
+  result.latencies_ms.reserve(requests);
+
+  int done = 0;
+  std::string batch;
+  while (done < requests) {
+    int n = std::min(opt.pipeline, requests - done);
+    batch.clear();
+    for (int i = 0; i < n; ++i)
+      batch += factory.Next();
+
+    auto start = std::chrono::steady_clock::now();
+    if (!SendAll(fd, batch)) {
+      result.ok = false;
+      break;
+    }
+    for (int i = 0; i < n; ++i) {
+      if (!reader.Skip()) {
+        result.ok = false;
+        break;
+      }
+    }
+    if (!result.ok)
+      break;
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    for (int i = 0; i < n; ++i)
+      result.latencies_ms.push_back(ms);
+    done += n;
+  }
+  ::close(fd);
+}
+
+double Percentile(std::vector<double> &sorted, double p) {
+  if (sorted.empty())
+    return 0.0;
+  size_t idx = static_cast<size_t>(p / 100.0 * (sorted.size() - 1));
+  return sorted[idx];
+}
+
+bool RunTest(const Options &opt, const std::string &test) {
+  std::vector<ClientResult> results(opt.clients);
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int c = 0; c < opt.clients; ++c) {
+    // 把请求数均分给各客户端，余数给前几个
+    int share = opt.requests / opt.clients + (c < opt.requests % opt.clients);
+    threads.emplace_back(RunClient, std::cref(opt), std::cref(test), share,
+                         static_cast<uint32_t>(c + 1), std::ref(results[c]));
+  }
+  for (auto &t : threads)
+    t.join();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  std::vector<double> all;
+  bool ok = true;
+  for (auto &r : results) {
+    ok = ok && r.ok;
+    all.insert(all.end(), r.latencies_ms.begin(), r.latencies_ms.end());
+  }
+  std::sort(all.begin(), all.end());
+
+  std::string upper = test;
+  std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+  std::cout << "====== " << upper << " ======\n";
+  std::cout << "  " << all.size() << " requests completed in " << std::fixed
+            << std::setprecision(2) << seconds << " seconds\n";
+  std::cout << "  " << opt.clients << " parallel clients\n";
+  std::cout << "  " << opt.data_size << " bytes payload\n";
+  std::cout << "  pipeline " << opt.pipeline << "\n\n";
+  std::cout << std::setprecision(3) << "  latency (msec): p50 "
+            << Percentile(all, 50) << "  p99 " << Percentile(all, 99)
+            << "  max " << (all.empty() ? 0.0 : all.back()) << "\n";
+  std::cout << std::setprecision(2) << "  " << all.size() / seconds
+            << " requests per second\n\n";
+  if (!ok)
+    std::cerr << "  some clients failed (connection refused or closed)\n";
+  return ok;
+}
+
+void Usage(const char *prog) {
+  std::cerr << "usage: " << prog
+            << " [-h host] [-p port] [-c clients] [-n requests] [-P pipeline]"
+               " [-d value_bytes] [-r keyspace] [-v vector_dim]"
+               " [-t ping,set,get,incr,mset,vset,vsearch]\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options opt;
+  for (int i = 1; i < argc; ++i) {
+    std::string flag = argv[i];
+    if (i + 1 >= argc) {
+      Usage(argv[0]);
+      return 1;
+    }
+    std::string val = argv[++i];
+    if (flag == "-h") {
+      opt.host = val;
+    } else if (flag == "-p") {
+      opt.port = std::atoi(val.c_str());
+    } else if (flag == "-c") {
+      opt.clients = std::max(1, std::atoi(val.c_str()));
+    } else if (flag == "-n") {
+      opt.requests = std::max(1, std::atoi(val.c_str()));
+    } else if (flag == "-P") {
+      opt.pipeline = std::max(1, std::atoi(val.c_str()));
+    } else if (flag == "-d") {
+      opt.data_size = std::max(1, std::atoi(val.c_str()));
+    } else if (flag == "-r") {
+      opt.keyspace = std::atoi(val.c_str());
+    } else if (flag == "-v") {
+      opt.vector_dim = std::max(1, std::atoi(val.c_str()));
+    } else if (flag == "-t") {
+      opt.tests.clear();
+      std::stringstream ss(val);
+      std::string t;
+      while (std::getline(ss, t, ','))
+        if (!t.empty())
+          opt.tests.push_back(t);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  const std::vector<std::string> known = {"ping", "set",  "get",    "incr",
+                                          "mset", "vset", "vsearch"};
+  bool ok = true;
+  for (const auto &test : opt.tests) {
+    if (std::find(known.begin(), known.end(), test) == known.end()) {
+      std::cerr << "unknown test: " << test << "\n";
+      return 1;
+    }
+    ok = RunTest(opt, test) && ok;
+  }
+  return ok ? 0 : 1;
+}
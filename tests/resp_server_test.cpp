@@ -0,0 +1,619 @@
+/**
+ * RESP 服务器测试
+ *
+ * 单元测试：
+ *   - 解析器：inline 命令、半包返回 INCOMPLETE、非法长度返回 ERROR
+ *   - 流式解析器：逐字节喂入时从断点续传，一段缓冲区中取出多条命令，
+ *     discard 之后偏移量正确
+ *   - 回复缓冲区：大 value 独立分段，gather / consume 部分发送后内容不变
+ *   - 命令执行（Execute，不经网络）：GET/SET/DEL/EXISTS、MGET/MSET、
+ *     EXPIRE/TTL/PERSIST、INCR 系列（非整数和溢出报错且不改值）、
+ *     VSET/VGET/VSEARCH、未知命令和参数个数错误
+ * 端到端测试（端口 0，2 个 reactor）：
+ *   - 一次 write 发送多条命令（pipeline），回复按序返回
+ *   - 一条命令拆成两次 write 发送；大量命令在任意位置切开发送
+ *   - 大 value 的 GET 回复（writev 独立分段）
+ *   - 多个并发连接的 INCR 结果正确
+ *   - 协议错误回复后断开连接
+ *   - 客户端 pipeline 大量 GET 却不读回复：回复超过 max_output_bytes 后
+ *     服务端暂停执行，其他连接不受影响；客户端开始读后全部回复按序到达
+ *   - Unix domain socket 监听：TCP 和 UDS 连接看到同一份数据，停止后
+ *     删除 socket 文件
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "server/resp_server.h"
+#include "server/unix_socket.h"
+
+using namespace minkv;
+using namespace minkv::server;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+static std::shared_ptr<StringKV> make_kv() {
+  return std::shared_ptr<StringKV>(StringKV::create(4096, 16));
+}
+
+// 执行一条命令并返回原始回复
+static std::string exec(RespServer &server, std::vector<std::string> cmd) {
+  std::string out;
+  server.Execute(cmd, out);
+  return out;
+}
+
+// ── 客户端辅助 ───────────────────────────────────────────────────────────────
+
+static int connect_to(uint16_t port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  timeval tv{5, 0};
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  return fd;
+}
+
+static bool send_all(int fd, const std::string &data) {
+  size_t off = 0;
+  while (off < data.size()) {
+    ssize_t n = ::write(fd, data.data() + off, data.size() - off);
+    if (n <= 0)
+      return false;
+    off += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// 读到恰好 expected 字节（或对端关闭 / 超时）
+static std::string recv_n(int fd, size_t expected) {
+  std::string got;
+  char buf[4096];
+  while (got.size() < expected) {
+    ssize_t n = ::read(fd, buf, sizeof(buf));
+    if (n <= 0)
+      break;
+    got.append(buf, static_cast<size_t>(n));
+  }
+  return got;
+}
+
+static std::string encode(const std::vector<std::string> &cmd) {
+  std::string out = "*" + std::to_string(cmd.size()) + "\r\n";
+  for (const auto &arg : cmd)
+    out += "$" + std::to_string(arg.size()) + "\r\n" + arg + "\r\n";
+  return out;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 单元测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_parser() {
+  RespParser::Command cmd;
+  size_t consumed = 0;
+
+  std::string inline_cmd = "SET  k\tv\r\nGET k\n";
+  auto st = RespParser::parse(inline_cmd, cmd, consumed);
+  CHECK(st == RespParser::Status::OK, "inline parse");
+  CHECK(cmd.size() == 3 && cmd[0] == "SET" && cmd[2] == "v", "inline args");
+  CHECK(consumed == 10, "inline consumed " << consumed);
+  st = RespParser::parse(std::string_view(inline_cmd).substr(consumed), cmd,
+                         consumed);
+  CHECK(st == RespParser::Status::OK && cmd.size() == 2, "inline \\n only");
+
+  std::string full = encode({"SET", "key", "value"});
+  for (size_t cut = 0; cut < full.size(); ++cut) {
+    st = RespParser::parse(std::string_view(full).substr(0, cut), cmd,
+                           consumed);
+    CHECK(st == RespParser::Status::INCOMPLETE, "prefix " << cut);
+  }
+  st = RespParser::parse(full, cmd, consumed);
+  CHECK(st == RespParser::Status::OK && consumed == full.size(), "full");
+
+  CHECK(RespParser::parse("*1\r\n$-5\r\n", cmd, consumed) ==
+            RespParser::Status::ERROR,
+        "negative bulk length");
+  CHECK(RespParser::parse("*1\r\n$3\r\nabcXY", cmd, consumed) ==
+            RespParser::Status::ERROR,
+        "missing CRLF after bulk");
+  CHECK(RespParser::parse("*x\r\n", cmd, consumed) ==
+            RespParser::Status::ERROR,
+        "bad array length");
+  PASS("parser");
+  return true;
+}
+
+static bool test_stream_parser() {
+  std::vector<std::vector<std::string>> cmds = {
+      {"SET", "k1", "v1"},
+      {"GET", "k1"},
+      {"SET", "big", std::string(5000, 'b')},
+      {"MGET", "a", "", "c"}};
+  std::string stream;
+  for (const auto &c : cmds)
+    stream += encode(c);
+  stream += "PING inline\r\n";
+
+  // 逐字节追加，每次都从断点继续；已解析的前缀随时丢弃
+  RespStreamParser parser;
+  RespStreamParser::Args args;
+  std::string buf;
+  std::vector<std::vector<std::string>> got;
+  for (char ch : stream) {
+    buf += ch;
+    while (true) {
+      auto st = parser.next(buf, args);
+      CHECK(st != RespParser::Status::ERROR, "unexpected error");
+      if (st == RespParser::Status::INCOMPLETE)
+        break;
+      got.emplace_back(args.begin(), args.end());
+    }
+    size_t done = parser.consumed();
+    buf.erase(0, done);
+    parser.discard(done);
+  }
+  CHECK(got.size() == 5, "commands " << got.size());
+  for (size_t i = 0; i < cmds.size(); ++i)
+    CHECK(got[i] == cmds[i], "command " << i);
+  CHECK(got[4].size() == 2 && got[4][1] == "inline", "inline command");
+  CHECK(buf.empty(), "all consumed");
+
+  // 一段缓冲区里的多条命令，参数直接指向缓冲区
+  std::string batch = encode({"GET", "a"}) + encode({"GET", "b"});
+  RespStreamParser p2;
+  CHECK(p2.next(batch, args) == RespParser::Status::OK, "first");
+  CHECK(args[1].data() == batch.data() + batch.find("a\r\n"), "zero copy");
+  CHECK(p2.next(batch, args) == RespParser::Status::OK && args[1] == "b",
+        "second");
+  CHECK(p2.next(batch, args) == RespParser::Status::INCOMPLETE, "drained");
+  CHECK(p2.consumed() == batch.size(), "consumed");
+
+  RespStreamParser p3;
+  CHECK(p3.next("*1\r\n$3\r\nabcd\r\n", args) == RespParser::Status::ERROR,
+        "bulk without CRLF");
+  RespStreamParser p4;
+  CHECK(p4.next("*" + std::string(40, '1'), args) == RespParser::Status::ERROR,
+        "overlong length line");
+  PASS("stream_parser");
+  return true;
+}
+
+static bool test_reply_buffer() {
+  RespReplyBuffer out;
+  out.simple_string("OK");
+  out.integer(-42);
+  std::string big(RespReplyBuffer::ZERO_COPY_THRESHOLD + 10, 'v');
+  const char *big_data = big.data();
+  out.bulk(std::move(big));
+  out.null();
+  out.array_header(2);
+  out.bulk(std::string_view("ab"));
+
+  std::string expected = "+OK\r\n:-42\r\n$" +
+                         std::to_string(RespReplyBuffer::ZERO_COPY_THRESHOLD +
+                                        10) +
+                         "\r\n" +
+                         std::string(RespReplyBuffer::ZERO_COPY_THRESHOLD + 10,
+                                     'v') +
+                         "\r\n$-1\r\n*2\r\n$2\r\nab\r\n";
+  CHECK(out.str() == expected, "content");
+  CHECK(out.size() == expected.size(), "size");
+
+  iovec iov[8];
+  size_t count = out.gather(iov, 8);
+  CHECK(count == 3, "segments " << count);
+  CHECK(iov[1].iov_base == big_data, "big value not copied");
+
+  // 模拟 writev 每次只发出 1000 字节
+  std::string sent;
+  while (!out.empty()) {
+    count = out.gather(iov, 8);
+    size_t budget = 1000;
+    for (size_t i = 0; i < count && budget > 0; ++i) {
+      size_t n = std::min(budget, iov[i].iov_len);
+      sent.append(static_cast<char *>(iov[i].iov_base), n);
+      budget -= n;
+    }
+    out.consume(std::min<size_t>(1000, out.size()));
+  }
+  CHECK(sent == expected, "partial sends");
+  out.integer(7);
+  CHECK(out.str() == ":7\r\n", "reuse after drain");
+  PASS("reply_buffer");
+  return true;
+}
+
+static bool test_basic_commands() {
+  RespServer server(make_kv());
+  CHECK(exec(server, {"PING"}) == "+PONG\r\n", "PING");
+  CHECK(exec(server, {"ping", "hi"}) == "$2\r\nhi\r\n", "PING msg");
+  CHECK(exec(server, {"SET", "a", "1"}) == "+OK\r\n", "SET");
+  CHECK(exec(server, {"GET", "a"}) == "$1\r\n1\r\n", "GET");
+  CHECK(exec(server, {"GET", "missing"}) == "$-1\r\n", "GET miss");
+  CHECK(exec(server, {"EXISTS", "a", "missing", "a"}) == ":2\r\n", "EXISTS");
+  CHECK(exec(server, {"MSET", "b", "2", "c", "3"}) == "+OK\r\n", "MSET");
+  CHECK(exec(server, {"MGET", "a", "x", "c"}) ==
+            "*3\r\n$1\r\n1\r\n$-1\r\n$1\r\n3\r\n",
+        "MGET");
+  CHECK(exec(server, {"DEL", "a", "b", "x"}) == ":2\r\n", "DEL");
+  CHECK(exec(server, {"DBSIZE"}) == ":1\r\n", "DBSIZE");
+
+  CHECK(exec(server, {"NOPE"}) == "-ERR unknown command 'NOPE'\r\n",
+        "unknown command");
+  CHECK(exec(server, {"GET"}) ==
+            "-ERR wrong number of arguments for 'get' command\r\n",
+        "arity");
+  CHECK(exec(server, {"MSET", "a", "1", "b"}).rfind("-ERR wrong number", 0) ==
+            0,
+        "MSET odd arity");
+  CHECK(exec(server, {"SET", "a", "1", "XX"}) == "-ERR syntax error\r\n",
+        "SET bad option");
+  CHECK(exec(server, {"COMMAND", "DOCS"}) == "*0\r\n", "COMMAND");
+  CHECK(exec(server, {"CONFIG", "GET", "save"}) == "*0\r\n", "CONFIG GET");
+  CHECK(server.Stats().commands == 16, "commands " << server.Stats().commands);
+  PASS("basic_commands");
+  return true;
+}
+
+static bool test_ttl_commands() {
+  RespServer server(make_kv());
+  CHECK(exec(server, {"TTL", "k"}) == ":-2\r\n", "TTL missing");
+  CHECK(exec(server, {"EXPIRE", "k", "10"}) == ":0\r\n", "EXPIRE missing");
+  exec(server, {"SET", "k", "v"});
+  CHECK(exec(server, {"TTL", "k"}) == ":-1\r\n", "TTL no expiry");
+  CHECK(exec(server, {"EXPIRE", "k", "100"}) == ":1\r\n", "EXPIRE");
+  CHECK(exec(server, {"TTL", "k"}) == ":100\r\n", "TTL after EXPIRE");
+  std::string pttl = exec(server, {"PTTL", "k"});
+  int64_t ms = std::stoll(pttl.substr(1));
+  CHECK(ms > 99000 && ms <= 100000, "PTTL " << ms);
+
+  // INCR 保留 TTL
+  exec(server, {"SET", "n", "5", "PX", "60000"});
+  CHECK(exec(server, {"INCR", "n"}) == ":6\r\n", "INCR");
+  CHECK(exec(server, {"TTL", "n"}) == ":60\r\n", "INCR keeps TTL");
+
+  CHECK(exec(server, {"PERSIST", "k"}) == ":1\r\n", "PERSIST");
+  CHECK(exec(server, {"PERSIST", "k"}) == ":0\r\n", "PERSIST again");
+  CHECK(exec(server, {"TTL", "k"}) == ":-1\r\n", "TTL after PERSIST");
+
+  exec(server, {"SET", "short", "v", "PX", "30"});
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  CHECK(exec(server, {"GET", "short"}) == "$-1\r\n", "expired");
+  CHECK(exec(server, {"TTL", "short"}) == ":-2\r\n", "TTL expired");
+
+  CHECK(exec(server, {"EXPIRE", "k", "0"}) == ":1\r\n", "EXPIRE 0");
+  CHECK(exec(server, {"EXISTS", "k"}) == ":0\r\n", "EXPIRE 0 deletes");
+  CHECK(exec(server, {"EXPIRE", "k", "x"}).rfind("-ERR value is not", 0) == 0,
+        "EXPIRE non-integer");
+  CHECK(exec(server, {"SET", "k", "v", "EX", "0"}).rfind("-ERR invalid", 0) ==
+            0,
+        "SET EX 0");
+  PASS("ttl_commands");
+  return true;
+}
+
+static bool test_incr() {
+  RespServer server(make_kv());
+  CHECK(exec(server, {"INCR", "c"}) == ":1\r\n", "INCR new");
+  CHECK(exec(server, {"INCRBY", "c", "41"}) == ":42\r\n", "INCRBY");
+  CHECK(exec(server, {"DECR", "c"}) == ":41\r\n", "DECR");
+  CHECK(exec(server, {"DECRBY", "c", "50"}) == ":-9\r\n", "DECRBY");
+  CHECK(exec(server, {"GET", "c"}) == "$2\r\n-9\r\n", "stored as string");
+
+  const std::string not_int =
+      "-ERR value is not an integer or out of range\r\n";
+  exec(server, {"SET", "s", "abc"});
+  CHECK(exec(server, {"INCR", "s"}) == not_int, "INCR non-integer");
+  CHECK(exec(server, {"GET", "s"}) == "$3\r\nabc\r\n", "value unchanged");
+  exec(server, {"SET", "big", "9223372036854775807"});
+  CHECK(exec(server, {"INCR", "big"}) == not_int, "INCR overflow");
+  CHECK(exec(server, {"GET", "big"}) == "$19\r\n9223372036854775807\r\n",
+        "overflow unchanged");
+  CHECK(exec(server, {"INCRBY", "c", "1.5"}) == not_int, "INCRBY float");
+  PASS("incr");
+  return true;
+}
+
+static bool test_vector_commands() {
+  RespServer server(make_kv());
+  CHECK(exec(server, {"VSET", "v1", "1", "0", "0"}) == "+OK\r\n", "VSET");
+  exec(server, {"VSET", "v2", "0", "1", "0"});
+  exec(server, {"VSET", "v3", "0.9", "0.1", "0"});
+  CHECK(exec(server, {"VGET", "v1"}) ==
+            "*3\r\n$1\r\n1\r\n$1\r\n0\r\n$1\r\n0\r\n",
+        "VGET");
+  CHECK(exec(server, {"VGET", "missing"}) == "*0\r\n", "VGET miss");
+  CHECK(exec(server, {"VSEARCH", "2", "1", "0", "0"}) ==
+            "*2\r\n$2\r\nv1\r\n$2\r\nv3\r\n",
+        "VSEARCH");
+  CHECK(exec(server, {"VSET", "v4", "1", "abc"}) ==
+            "-ERR value is not a valid float\r\n",
+        "VSET bad float");
+  CHECK(exec(server, {"VSEARCH", "0", "1"}).rfind("-ERR", 0) == 0,
+        "VSEARCH bad k");
+  PASS("vector_commands");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 端到端测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_pipeline_and_split() {
+  RespServerOptions options;
+  options.host = "127.0.0.1";
+  options.port = 0;
+  options.reactors = 2;
+  RespServer server(make_kv(), options);
+  server.Start();
+  CHECK(server.port() != 0, "ephemeral port");
+
+  int fd = connect_to(server.port());
+  CHECK(fd >= 0, "connect");
+
+  // 一次 write 发送多条命令，含 inline 命令
+  std::string batch = encode({"SET", "k", "hello"}) + encode({"GET", "k"}) +
+                      "PING\r\n" + encode({"INCR", "n"}) +
+                      encode({"INCR", "n"});
+  CHECK(send_all(fd, batch), "send batch");
+  std::string expected = "+OK\r\n$5\r\nhello\r\n+PONG\r\n:1\r\n:2\r\n";
+  std::string got = recv_n(fd, expected.size());
+  CHECK(got == expected, "pipeline reply: " << got);
+
+  // 大 value：回复中的 value 走独立分段
+  std::string big(100000, 'z');
+  CHECK(send_all(fd, encode({"SET", "big", big}) + encode({"GET", "big"})),
+        "send big");
+  expected = "+OK\r\n$100000\r\n" + big + "\r\n";
+  CHECK(recv_n(fd, expected.size()) == expected, "big value reply");
+
+  // 500 条命令在不规则位置切开，分多次发送
+  std::string many, many_expected;
+  for (int i = 0; i < 500; ++i) {
+    many += encode({"SET", "p" + std::to_string(i), std::to_string(i)});
+    many += encode({"GET", "p" + std::to_string(i)});
+    many_expected += "+OK\r\n$" + std::to_string(std::to_string(i).size()) +
+                     "\r\n" + std::to_string(i) + "\r\n";
+  }
+  for (size_t off = 0, step = 7; off < many.size(); off += step, step += 13) {
+    CHECK(send_all(fd, many.substr(off, step)), "send piece");
+    if (step % 3 == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(recv_n(fd, many_expected.size()) == many_expected, "pieces reply");
+
+  // 一条命令拆成两次 write
+  std::string cmd = encode({"SET", "split", std::string(1000, 'x')});
+  CHECK(send_all(fd, cmd.substr(0, 300)), "send first half");
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  CHECK(send_all(fd, cmd.substr(300) + encode({"GET", "split"})),
+        "send second half");
+  expected = "+OK\r\n$1000\r\n" + std::string(1000, 'x') + "\r\n";
+  got = recv_n(fd, expected.size());
+  CHECK(got == expected, "split reply");
+  ::close(fd);
+
+  server.Stop();
+  server.Stop(); // 可重复调用
+  PASS("pipeline_and_split");
+  return true;
+}
+
+static bool test_concurrent_clients() {
+  RespServerOptions options;
+  options.host = "127.0.0.1";
+  options.port = 0;
+  options.reactors = 2;
+  RespServer server(make_kv(), options);
+  server.Start();
+
+  constexpr int kClients = 8, kIncrs = 200;
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < kClients; ++t) {
+    threads.emplace_back([&] {
+      int fd = connect_to(server.port());
+      if (fd < 0) {
+        ++failures;
+        return;
+      }
+      std::string batch;
+      for (int i = 0; i < kIncrs; ++i)
+        batch += encode({"INCR", "counter"});
+      send_all(fd, batch);
+      // 每个回复至少 ":1\r\n"，读到 kIncrs 个 CRLF 为止
+      std::string got;
+      char buf[4096];
+      size_t lines = 0;
+      while (lines < kIncrs) {
+        ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0)
+          break;
+        for (ssize_t i = 0; i < n; ++i)
+          lines += buf[i] == '\n';
+      }
+      if (lines != kIncrs)
+        ++failures;
+      ::close(fd);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  CHECK(failures == 0, "client failures " << failures.load());
+
+  int fd = connect_to(server.port());
+  send_all(fd, encode({"GET", "counter"}));
+  std::string total = std::to_string(kClients * kIncrs);
+  std::string expected =
+      "$" + std::to_string(total.size()) + "\r\n" + total + "\r\n";
+  CHECK(recv_n(fd, expected.size()) == expected, "counter total");
+  ::close(fd);
+
+  CHECK(server.Stats().connections_accepted == kClients + 1, "accepted");
+  server.Stop();
+  PASS("concurrent_clients");
+  return true;
+}
+
+static bool test_protocol_error() {
+  RespServerOptions options;
+  options.host = "127.0.0.1";
+  options.port = 0;
+  options.reactors = 1;
+  RespServer server(make_kv(), options);
+  server.Start();
+
+  int fd = connect_to(server.port());
+  CHECK(send_all(fd, encode({"PING"}) + "*1\r\n$-7\r\n"), "send");
+  std::string expected = "+PONG\r\n-ERR Protocol error\r\n";
+  CHECK(recv_n(fd, expected.size() + 1) == expected, "error reply");
+  ::close(fd);
+  CHECK(server.Stats().protocol_errors == 1, "protocol_errors");
+  server.Stop();
+  PASS("protocol_error");
+  return true;
+}
+
+static bool test_output_limit() {
+  RespServerOptions options;
+  options.host = "127.0.0.1";
+  options.port = 0;
+  options.reactors = 1;
+  options.max_output_bytes = 1024 * 1024;
+  RespServer server(make_kv(), options);
+  server.Start();
+
+  // 1000 条 GET 的回复共 64MB，远超上限加两端 socket 缓冲区
+  constexpr int kGets = 1000;
+  const std::string big(64 * 1024, 'v');
+  int fd = connect_to(server.port());
+  CHECK(send_all(fd, encode({"SET", "big", big})), "send set");
+  CHECK(recv_n(fd, 5) == "+OK\r\n", "set reply");
+  std::string gets;
+  for (int i = 0; i < kGets; ++i)
+    gets += encode({"GET", "big"});
+  CHECK(send_all(fd, gets), "send gets");
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  uint64_t executed = server.Stats().commands - 1;
+  std::cout << "  executed " << executed << " of " << kGets
+            << " GETs while the client was not reading\n";
+  CHECK(executed < kGets, "server paused the non-reading client");
+
+  // 同一 reactor 上的其他连接照常服务
+  int other = connect_to(server.port());
+  CHECK(send_all(other, encode({"PING"})), "other send");
+  CHECK(recv_n(other, 7) == "+PONG\r\n", "other connection served");
+  ::close(other);
+
+  const std::string reply = "$" + std::to_string(big.size()) + "\r\n" + big +
+                            "\r\n";
+  std::string got = recv_n(fd, reply.size() * kGets);
+  CHECK(got.size() == reply.size() * kGets, "all replies after reading");
+  bool intact = true;
+  for (int i = 0; i < kGets && intact; ++i)
+    intact = got.compare(i * reply.size(), reply.size(), reply) == 0;
+  CHECK(intact, "replies intact and in order");
+  CHECK(server.Stats().commands == kGets + 2, "all GETs executed");
+  ::close(fd);
+  server.Stop();
+  PASS("output_limit");
+  return true;
+}
+
+static bool test_unix_socket() {
+  RespServerOptions options;
+  options.host = "127.0.0.1";
+  options.port = 0;
+  options.reactors = 2;
+  options.unix_path =
+      "/tmp/minkv_resp_test_" + std::to_string(::getpid()) + ".sock";
+  RespServer server(make_kv(), options);
+  server.Start();
+  CHECK(::access(options.unix_path.c_str(), F_OK) == 0, "socket file");
+
+  int tcp = connect_to(server.port());
+  CHECK(send_all(tcp, encode({"SET", "k", "via-tcp"})), "tcp send");
+  CHECK(recv_n(tcp, 5) == "+OK\r\n", "tcp set");
+
+  int uds = ConnectUnix(options.unix_path);
+  std::string pipeline = encode({"GET", "k"}) + encode({"SET", "k", "uds"}) +
+                         encode({"GET", "k"});
+  CHECK(send_all(uds, pipeline), "uds send");
+  std::string expected = "$7\r\nvia-tcp\r\n+OK\r\n$3\r\nuds\r\n";
+  CHECK(recv_n(uds, expected.size()) == expected, "uds pipeline");
+  ::close(uds);
+  ::close(tcp);
+
+  CHECK(server.Stats().connections_accepted == 2, "accepted");
+  server.Stop();
+  CHECK(::access(options.unix_path.c_str(), F_OK) != 0, "socket unlinked");
+  PASS("unix_socket");
+  return true;
+}
+
+int main() {
+  std::cout << "=== RESP Server Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_parser, "parser");
+  run(test_stream_parser, "stream_parser");
+  run(test_reply_buffer, "reply_buffer");
+  run(test_basic_commands, "basic_commands");
+  run(test_ttl_commands, "ttl_commands");
+  run(test_incr, "incr");
+  run(test_vector_commands, "vector_commands");
+  run(test_pipeline_and_split, "pipeline_and_split");
+  run(test_concurrent_clients, "concurrent_clients");
+  run(test_protocol_error, "protocol_error");
+  run(test_output_limit, "output_limit");
+  run(test_unix_socket, "unix_socket");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,343 @@
+/**
+ * 共享内存传输测试
+ *
+ * 单元测试（ShmRing，进程内一段普通内存）：
+ *   - 不同长度的消息反复写读，跨过环尾回绕后内容不变
+ *   - 环满时 reserve 返回 nullptr，释放后可以继续写；超长消息抛异常
+ *   - 生产者 / 消费者两个线程，futex 等待下消息不丢不乱序
+ * 端到端测试（ShmServer + ShmClient）：
+ *   - SET / GET / GetView / DEL / PX 过期、大 value
+ *   - 回复超过环的单条上限时返回错误回复，连接仍可用
+ *   - 多个客户端并发 INCR
+ *   - 客户端退出后服务端回收服务线程
+ *   - 服务端停止后客户端调用抛异常，而不是一直等
+ */
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "client/shm_client.h"
+#include "server/shm_server.h"
+
+using namespace minkv;
+using namespace minkv::server;
+using minkv::client::ShmClient;
+
+// ── 辅助宏
+// ────────────────────────────────────────────────────────────────────
+
+#define CHECK(cond, msg)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << "[FAIL] " << msg << "\n";                                   \
+      return false;                                                            \
+    }                                                                          \
+  } while (0)
+
+#define PASS(name)                                                             \
+  do {                                                                         \
+    std::cout << "[PASS] " << name << "\n";                                    \
+  } while (0)
+
+// 进程内的一个环：控制块 + 数据区
+struct LocalRing {
+  explicit LocalRing(uint64_t capacity) : data(capacity) {}
+  ShmRing ring() { return ShmRing(&ctl, data.data(), data.size()); }
+
+  ShmRingControl ctl;
+  std::vector<char> data;
+};
+
+static std::string payload(size_t seq, size_t len) {
+  std::string s(len, static_cast<char>('a' + seq % 26));
+  if (len >= sizeof(seq))
+    std::memcpy(&s[0], &seq, sizeof(seq));
+  return s;
+}
+
+static bool push(ShmRing &ring, const std::string &msg) {
+  char *dst = ring.reserve(msg.size());
+  if (!dst)
+    return false;
+  std::memcpy(dst, msg.data(), msg.size());
+  ring.commit();
+  return true;
+}
+
+static std::shared_ptr<StringKV> make_kv() {
+  return std::shared_ptr<StringKV>(StringKV::create(4096, 16));
+}
+
+static ShmServerOptions server_options(const char *name) {
+  ShmServerOptions options;
+  options.path = "/tmp/minkv_shm_test_" + std::string(name) + "_" +
+                 std::to_string(::getpid()) + ".sock";
+  options.ring_bytes = 1 << 20;
+  options.poll_ms = 20;
+  return options;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 单元测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_ring_wraparound() {
+  LocalRing local(4096);
+  ShmRing producer = local.ring();
+  ShmRing consumer = local.ring();
+
+  // 长度变化的消息写读几十圈，回绕发生在不同位置
+  for (size_t seq = 0; seq < 2000; ++seq) {
+    std::string msg = payload(seq, (seq * 37) % 700);
+    CHECK(push(producer, msg), "push " << seq);
+    std::string_view got;
+    CHECK(consumer.peek(got), "peek " << seq);
+    CHECK(got == msg, "content " << seq);
+    consumer.release();
+  }
+  std::string_view got;
+  CHECK(!consumer.peek(got), "ring empty");
+  CHECK(local.ctl.head.load() > 10 * 4096, "wrapped many times");
+  PASS("ring_wraparound");
+  return true;
+}
+
+static bool test_ring_full() {
+  LocalRing local(4096);
+  ShmRing ring = local.ring();
+  CHECK(ring.max_message() == 4096 / 2 - 8, "max_message");
+
+  bool threw = false;
+  try {
+    ring.reserve(ring.max_message() + 1);
+  } catch (const std::length_error &) {
+    threw = true;
+  }
+  CHECK(threw, "oversized message rejected");
+
+  // 每条记录 8 + 504 = 512 字节，8 条写满
+  std::string msg = payload(1, 504);
+  for (int i = 0; i < 8; ++i)
+    CHECK(push(ring, msg), "push " << i);
+  CHECK(!push(ring, msg), "full ring returns nullptr");
+  CHECK(!ring.wait_space(msg.size(), 0, 1), "wait_space times out");
+
+  std::string_view got;
+  CHECK(ring.peek(got) && got == msg, "peek");
+  ring.release();
+  CHECK(ring.wait_space(msg.size(), 0, 1), "space after release");
+  CHECK(push(ring, msg), "push after release");
+  PASS("ring_full");
+  return true;
+}
+
+static bool test_ring_threaded() {
+  LocalRing local(8192);
+  constexpr size_t kMessages = 200000;
+  std::atomic<bool> ok{true};
+
+  std::thread producer([&] {
+    ShmRing ring = local.ring();
+    for (size_t seq = 0; seq < kMessages; ++seq) {
+      std::string msg = payload(seq, 8 + seq % 300);
+      while (!push(ring, msg))
+        ring.wait_space(msg.size(), 10, 100);
+    }
+  });
+
+  ShmRing ring = local.ring();
+  for (size_t seq = 0; seq < kMessages && ok; ++seq) {
+    std::string_view got;
+    while (!ring.peek(got))
+      ring.wait_data(10, 100);
+    if (got != payload(seq, 8 + seq % 300))
+      ok = false;
+    ring.release();
+  }
+  producer.join();
+  CHECK(ok, "messages lost or reordered");
+  PASS("ring_threaded");
+  return true;
+}
+
+// ══════════════════════════════════════════════════════════════════════════════
+// 端到端测试
+// ══════════════════════════════════════════════════════════════════════════════
+
+static bool test_client_commands() {
+  ShmServerOptions options = server_options("cmd");
+  ShmServer server(make_kv(), options);
+  server.Start();
+
+  ShmClient kv(options.path);
+  kv.Set("user:1", "alice");
+  CHECK(kv.Get("user:1") == std::optional<std::string>("alice"), "get");
+  CHECK(!kv.Get("missing").has_value(), "get missing");
+
+  std::string_view view;
+  CHECK(kv.GetView("user:1", view) && view == "alice", "get view");
+  CHECK(!kv.GetView("missing", view), "get view missing");
+
+  CHECK(kv.Del("user:1"), "del existing");
+  CHECK(!kv.Del("user:1"), "del missing");
+
+  kv.Set("tmp", "v", 50);
+  CHECK(kv.Get("tmp").has_value(), "ttl not yet expired");
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  CHECK(!kv.Get("tmp").has_value(), "ttl expired");
+
+  // 大 value：请求和回复都接近环的单条上限
+  std::string big(300 * 1024, 'x');
+  for (size_t i = 0; i < big.size(); i += 97)
+    big[i] = static_cast<char>('a' + i % 26);
+  kv.Set("big", big);
+  CHECK(kv.GetView("big", view) && view == big, "big value");
+
+  CHECK(kv.Execute({"PING"}) == "+PONG\r\n", "raw execute");
+  std::string_view err = kv.Execute({"NOSUCH"});
+  CHECK(!err.empty() && err[0] == '-', "error reply");
+  kv.Set("n", "x");
+  CHECK(kv.Execute({"INCR", "n"}).rfind("-ERR", 0) == 0, "incr error reply");
+  CHECK(kv.Get("n") == std::optional<std::string>("x"), "usable after error");
+
+  // 两个 300 KiB 的 value 拼起来超过 512 KiB 的单条上限
+  std::string_view reply = kv.Execute({"MGET", "big", "big"});
+  CHECK(reply.rfind("-ERR reply too large", 0) == 0, "too large reply");
+  CHECK(kv.Get("big").has_value(), "still usable after error");
+
+  CHECK(server.Stats().clients_accepted == 1, "accepted");
+  CHECK(server.Stats().requests >= 10, "requests counted");
+  server.Stop();
+  PASS("client_commands");
+  return true;
+}
+
+static bool test_concurrent_clients() {
+  ShmServerOptions options = server_options("concurrent");
+  ShmServer server(make_kv(), options);
+  server.Start();
+
+  constexpr int kClients = 4, kIncrs = 2000;
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < kClients; ++t) {
+    threads.emplace_back([&] {
+      try {
+        ShmClient kv(options.path);
+        for (int i = 0; i < kIncrs; ++i)
+          if (kv.Execute({"INCR", "counter"})[0] != ':')
+            ++failures;
+      } catch (const std::exception &) {
+        ++failures;
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  CHECK(failures == 0, "client failures " << failures.load());
+
+  ShmClient kv(options.path);
+  CHECK(kv.Get("counter") == std::to_string(kClients * kIncrs), "total");
+  CHECK(server.Stats().clients_accepted == kClients + 1, "accepted");
+  server.Stop();
+  PASS("concurrent_clients");
+  return true;
+}
+
+static bool test_client_disconnect() {
+  ShmServerOptions options = server_options("disconnect");
+  ShmServer server(make_kv(), options);
+  server.Start();
+
+  {
+    ShmClient a(options.path);
+    ShmClient b(options.path);
+    a.Set("k", "v");
+    CHECK(b.Get("k") == std::optional<std::string>("v"), "shared store");
+    CHECK(server.Stats().clients_active == 2, "two active");
+  }
+  // 服务线程在 poll_ms 内发现控制 socket 已关闭
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (server.Stats().clients_active != 0 &&
+         std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  CHECK(server.Stats().clients_active == 0, "clients reaped");
+
+  ShmClient c(options.path);
+  CHECK(c.Get("k") == std::optional<std::string>("v"), "new client");
+  server.Stop();
+  CHECK(::access(options.path.c_str(), F_OK) != 0, "socket unlinked");
+  PASS("client_disconnect");
+  return true;
+}
+
+static bool test_server_stop() {
+  ShmServerOptions options = server_options("stop");
+  auto server = std::make_unique<ShmServer>(make_kv(), options);
+  server->Start();
+
+  client::ShmClientOptions client_options;
+  client_options.timeout_ms = 2000;
+  ShmClient kv(options.path, client_options);
+  kv.Set("k", "v");
+  server->Stop();
+
+  auto start = std::chrono::steady_clock::now();
+  bool threw = false;
+  try {
+    kv.Get("k");
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  CHECK(threw, "call after stop throws");
+  CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1),
+        "failed fast instead of waiting for timeout");
+
+  threw = false;
+  try {
+    ShmClient late(options.path);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  CHECK(threw, "connect after stop throws");
+  PASS("server_stop");
+  return true;
+}
+
+int main() {
+  std::cout << "=== Shared-Memory Transport Tests ===\n\n";
+
+  int passed = 0, failed = 0;
+
+  auto run = [&](bool (*fn)(), const char *name) {
+    try {
+      if (fn())
+        ++passed;
+      else
+        ++failed;
+    } catch (const std::exception &ex) {
+      std::cerr << "[FAIL] " << name << " threw: " << ex.what() << "\n";
+      ++failed;
+    }
+  };
+
+  run(test_ring_wraparound, "ring_wraparound");
+  run(test_ring_full, "ring_full");
+  run(test_ring_threaded, "ring_threaded");
+  run(test_client_commands, "client_commands");
+  run(test_concurrent_clients, "concurrent_clients");
+  run(test_client_disconnect, "client_disconnect");
+  run(test_server_stop, "server_stop");
+
+  std::cout << "\n=== Unit Test Results: " << passed << " passed, " << failed
+            << " failed ===\n";
+  return failed == 0 ? 0 : 1;
+}
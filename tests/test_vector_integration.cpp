@@ -1,5 +1,9 @@
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "core/sharded_cache.h"
@@ -66,6 +70,141 @@ int main() {
   std::cout << "命中次数: " << stats.hits << std::endl;
   std::cout << "未命中次数: " << stats.misses << std::endl;
 
+  std::cout << "\n[Test 5] 二进制向量传输（fp32 原始字节 / fp16）" << std::endl;
+
+  // fp32：请求体字节即存储格式，写入后与 vectorPut 的结果一致
+  std::string raw(reinterpret_cast<const char *>(vec3.data()),
+                  vec3.size() * sizeof(float));
+  cache.vectorPutRaw("vector:raw", raw);
+  if (cache.vectorGet("vector:raw") != vec3) {
+    std::cout << "✗ vectorPutRaw 读回不一致" << std::endl;
+    return 1;
+  }
+  bool rejected = false;
+  try {
+    cache.vectorPutRaw("vector:bad", std::string(7, 'x'));
+  } catch (const std::invalid_argument &) {
+    rejected = true;
+  }
+  if (!rejected) {
+    std::cout << "✗ 长度不是 4 的倍数时应抛 invalid_argument" << std::endl;
+    return 1;
+  }
+
+  // fp16：可精确表示的值往返不变，其余误差在半精度精度内
+  std::vector<float> exact = {0.0f,     -0.0f, 1.0f, -2.5f,
+                             65504.0f, std::ldexp(1.0f, -14)};
+  std::string half = VectorOps::EncodeHalf(exact.data(), exact.size());
+  std::string decoded = VectorOps::SerializeFromHalf(half.data(), exact.size());
+  if (VectorOps::DeserializeCopy(decoded) != exact ||
+      VectorOps::HalfToFloat(VectorOps::FloatToHalf(1e6f)) != INFINITY ||
+      VectorOps::HalfToFloat(0x0001) != std::ldexp(1.0f, -24)) {
+    std::cout << "✗ fp16 编解码不正确" << std::endl;
+    return 1;
+  }
+  for (float x : vec2) {
+    float back = VectorOps::HalfToFloat(VectorOps::FloatToHalf(x));
+    if (std::fabs(back - x) > std::fabs(x) / 1024) {
+      std::cout << "✗ fp16 舍入误差过大: " << x << " -> " << back << std::endl;
+      return 1;
+    }
+  }
+
+  // 指针形式的查询与 vector 形式结果一致
+  auto by_vector = cache.vectorSearch(vec1, 2);
+  auto by_pointer = cache.vectorSearch(vec1.data(), vec1.size(), 2);
+  if (by_vector != by_pointer || by_pointer.empty() ||
+      (by_pointer[0] != "vector:1" && by_pointer[0] != "embedding:user:1")) {
+    std::cout << "✗ 指针形式的 vectorSearch 结果不一致" << std::endl;
+    return 1;
+  }
+  std::cout << "✓ 二进制写入、fp16 编解码和指针查询均正确" << std::endl;
+
+  std::cout << "\n[Test 6] 批量写入 / 删除 / 搜索" << std::endl;
+
+  std::vector<std::pair<std::string, std::string>> batch;
+  for (int i = 0; i < 100; ++i) {
+    batch.emplace_back("batch:" + std::to_string(i), std::to_string(i));
+  }
+  batch.emplace_back("batch:0", "last"); // 同一个 key 后者生效
+  cache.multi_put(batch);
+  if (cache.get("batch:0") != std::optional<std::string>("last") ||
+      cache.get("batch:99") != std::optional<std::string>("99")) {
+    std::cout << "✗ multi_put 写入不正确" << std::endl;
+    return 1;
+  }
+  auto removed = cache.multi_remove({"batch:1", "batch:missing", "batch:1"});
+  if (removed != std::vector<bool>({true, false, false}) ||
+      cache.get("batch:1").has_value()) {
+    std::cout << "✗ multi_remove 结果不正确" << std::endl;
+    return 1;
+  }
+
+  // 批量搜索与逐个搜索结果一致（含维度不匹配、没有结果的查询）
+  std::vector<std::vector<float>> queries = {vec1, vec2, {1.0f, 2.0f}};
+  auto batched = cache.vectorSearchBatch(queries, 3);
+  if (batched.size() != queries.size() || batched[0].empty()) {
+    std::cout << "✗ vectorSearchBatch 结果个数不正确" << std::endl;
+    return 1;
+  }
+  for (size_t i = 0; i < queries.size(); ++i) {
+    if (batched[i] != cache.vectorSearch(queries[i], 3)) {
+      std::cout << "✗ vectorSearchBatch 第 " << i << " 个查询与逐个搜索不一致"
+                << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "✓ multi_put / multi_remove / vectorSearchBatch 均正确"
+            << std::endl;
+
+  std::cout << "\n[Test 7] 游标遍历" << std::endl;
+
+  // 没有并发写入时每个 key 恰好返回一次
+  ShardedCache<std::string, std::string> scanned(100000, 8);
+  for (int i = 0; i < 1000; ++i) {
+    scanned.put("scan:" + std::to_string(i), std::to_string(i));
+  }
+  std::map<std::string, int> seen;
+  ScanCursor cursor;
+  int pages = 0;
+  do {
+    cursor = scanned.scan(cursor, 50, [&](const std::string &key,
+                                          const std::string &) {
+      ++seen[key];
+    });
+    ++pages;
+  } while (!cursor.done);
+  bool once = seen.size() == 1000 && pages > 1;
+  for (const auto &[key, n] : seen) {
+    once = once && n == 1;
+  }
+  if (!once) {
+    std::cout << "✗ scan 没有恰好返回每个 key 一次" << std::endl;
+    return 1;
+  }
+
+  // 遍历中途持续写入触发 rehash：原有的 key 仍至少返回一次
+  // （容量足够大，不会因 LRU 淘汰而消失）
+  seen.clear();
+  cursor = ScanCursor{};
+  int extra = 0;
+  do {
+    cursor = scanned.scan(cursor, 50, [&](const std::string &key,
+                                          const std::string &) {
+      ++seen[key];
+    });
+    for (int i = 0; i < 100; ++i) {
+      scanned.put("grow:" + std::to_string(extra++), "x");
+    }
+  } while (!cursor.done);
+  for (int i = 0; i < 1000; ++i) {
+    if (!seen.count("scan:" + std::to_string(i))) {
+      std::cout << "✗ rehash 后 scan 漏掉了 scan:" << i << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "✓ scan 分页遍历完整，rehash 后不遗漏" << std::endl;
+
   std::cout << "\n=== 集成测试完成 ===" << std::endl;
   std::cout << "\n✓ MinKV 现在支持：" << std::endl;
   std::cout << "  1. 传统的 String KV 存储 (put/get)" << std::endl;